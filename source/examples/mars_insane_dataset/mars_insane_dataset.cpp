@@ -11,6 +11,7 @@
 #include "include/mars_insane_dataset.h"
 #include <mars/core_logic.h>
 #include <mars/core_state.h>
+#include <mars/data_utils/dataset_loader.h>
 #include <mars/data_utils/filesystem.h>
 #include <mars/data_utils/read_baro_data.h>
 #include <mars/data_utils/read_gps_w_vel_data.h>
@@ -34,6 +35,7 @@
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include "include_local/insane_dataset_settings.h"
 
 int main(int /*argc*/, char** /*argv[]*/)
@@ -323,140 +325,130 @@ int main(int /*argc*/, char** /*argv[]*/)
   }
 
   // Load Sensor Data
-  std::vector<mars::BufferEntryType> measurement_data;
+  // Each sensor file is read on its own thread, the time ordered sensor streams are merged during the processing
+  mars::DatasetLoader loader;
+  mars::Time t_start_global = -std::numeric_limits<double>::max();
+  mars::Time t_stop_global = std::numeric_limits<double>::max();
 
   {  // keep individual measurement data limited to this scope
+    std::cout << "Reading measurement files:" << std::endl;
 
     // IMU
-    {
-      std::cout << "Reading measurement files:" << std::endl;
-      std::cout << " - Reading IMU Measurement Data" << std::endl;
-      std::vector<mars::BufferEntryType> measurement_data_imu;
-      mars::ReadImuData(&measurement_data_imu, imu_sensor_sptr_, m_sett.data_path_ + m_sett.imu_file_name_);
-      measurement_data.insert(measurement_data.end(), measurement_data_imu.begin(), measurement_data_imu.end());
-    }
+    std::cout << " - Reading IMU Measurement Data" << std::endl;
+    loader.AddStream("IMU", [&](std::vector<mars::BufferEntryType>* data) {
+      mars::ReadImuData(data, imu_sensor_sptr_, m_sett.data_path_ + m_sett.imu_file_name_);
+    });
 
     // GPS1
     if (m_sett.enable_gps1_)
     {
       std::cout << " - Reading GPS1 Measurement Data" << std::endl;
-      std::vector<mars::BufferEntryType> measurement_data_gps1;
-      mars::ReadGpsWithVelData(&measurement_data_gps1, gps1_sensor_sptr_, m_sett.data_path_ + m_sett.gps1_file_name_,
-                               m_sett.t_offset_gps1_);
-      measurement_data.insert(measurement_data.end(), measurement_data_gps1.begin(), measurement_data_gps1.end());
+      loader.AddStream("GPS1", [&](std::vector<mars::BufferEntryType>* data) {
+        mars::ReadGpsWithVelData(data, gps1_sensor_sptr_, m_sett.data_path_ + m_sett.gps1_file_name_,
+                                 m_sett.t_offset_gps1_);
+      });
     }
 
     // GPS2
     if (m_sett.enable_gps2_)
     {
       std::cout << " - Reading GPS2 Measurement Data" << std::endl;
-      std::vector<mars::BufferEntryType> measurement_data_gps2;
-      mars::ReadGpsWithVelData(&measurement_data_gps2, gps2_sensor_sptr_, m_sett.data_path_ + m_sett.gps2_file_name_,
-                               m_sett.t_offset_gps2_);
-      measurement_data.insert(measurement_data.end(), measurement_data_gps2.begin(), measurement_data_gps2.end());
+      loader.AddStream("GPS2", [&](std::vector<mars::BufferEntryType>* data) {
+        mars::ReadGpsWithVelData(data, gps2_sensor_sptr_, m_sett.data_path_ + m_sett.gps2_file_name_,
+                                 m_sett.t_offset_gps2_);
+      });
     }
 
     // GPS3
     if (m_sett.enable_gps3_)
     {
       std::cout << " - Reading GPS3 Measurement Data" << std::endl;
-      std::vector<mars::BufferEntryType> measurement_data_gps3;
-      mars::ReadGpsWithVelData(&measurement_data_gps3, gps3_sensor_sptr_, m_sett.data_path_ + m_sett.gps3_file_name_,
-                               m_sett.t_offset_gps3_);
-      measurement_data.insert(measurement_data.end(), measurement_data_gps3.begin(), measurement_data_gps3.end());
+      loader.AddStream("GPS3", [&](std::vector<mars::BufferEntryType>* data) {
+        mars::ReadGpsWithVelData(data, gps3_sensor_sptr_, m_sett.data_path_ + m_sett.gps3_file_name_,
+                                 m_sett.t_offset_gps3_);
+      });
     }
 
     // Mag1
     if (m_sett.enable_mag1_)
     {
       std::cout << " - Reading MAG1 Measurement Data" << std::endl;
-      std::vector<mars::BufferEntryType> measurement_data_mag1;
-      mars::ReadMagData(&measurement_data_mag1, mag1_sensor_sptr_, m_sett.data_path_ + m_sett.mag1_file_name_,
-                        m_sett.t_offset_mag1_);
-      measurement_data.insert(measurement_data.end(), measurement_data_mag1.begin(), measurement_data_mag1.end());
+      loader.AddStream("MAG1", [&](std::vector<mars::BufferEntryType>* data) {
+        mars::ReadMagData(data, mag1_sensor_sptr_, m_sett.data_path_ + m_sett.mag1_file_name_, m_sett.t_offset_mag1_);
+      });
     }
 
     // Mag2
     if (m_sett.enable_mag2_)
     {
       std::cout << " - Reading MAG2 Measurement Data" << std::endl;
-      std::vector<mars::BufferEntryType> measurement_data_mag2;
-      mars::ReadMagData(&measurement_data_mag2, mag2_sensor_sptr_, m_sett.data_path_ + m_sett.mag2_file_name_,
-                        m_sett.t_offset_mag2_);
-      measurement_data.insert(measurement_data.end(), measurement_data_mag2.begin(), measurement_data_mag2.end());
+      loader.AddStream("MAG2", [&](std::vector<mars::BufferEntryType>* data) {
+        mars::ReadMagData(data, mag2_sensor_sptr_, m_sett.data_path_ + m_sett.mag2_file_name_, m_sett.t_offset_mag2_);
+      });
     }
 
     // Pose1
     if (m_sett.enable_pose1_)
     {
       std::cout << " - Reading Pose1 Measurement Data" << std::endl;
-      std::vector<mars::BufferEntryType> measurement_data_pose1;
-      mars::ReadVisionData(&measurement_data_pose1, pose1_sensor_sptr_, m_sett.data_path_ + m_sett.pose1_file_name_,
-                           m_sett.t_offset_pose1_);
-      measurement_data.insert(measurement_data.end(), measurement_data_pose1.begin(), measurement_data_pose1.end());
+      loader.AddStream("Pose1", [&](std::vector<mars::BufferEntryType>* data) {
+        mars::ReadVisionData(data, pose1_sensor_sptr_, m_sett.data_path_ + m_sett.pose1_file_name_,
+                             m_sett.t_offset_pose1_);
+      });
     }
 
     // Pose2
     if (m_sett.enable_pose2_)
     {
       std::cout << " - Reading Pose2 Measurement Data" << std::endl;
-      std::vector<mars::BufferEntryType> measurement_data_pose2;
-      mars::ReadVisionData(&measurement_data_pose2, pose2_sensor_sptr_, m_sett.data_path_ + m_sett.pose2_file_name_,
-                           m_sett.t_offset_pose2_);
-      std::vector<mars::BufferEntryType> measurement_data_pose2_reduced =
-          mars::Utils::VecExtractEveryNthElm(measurement_data_pose2, 6);
-      measurement_data.insert(measurement_data.end(), measurement_data_pose2_reduced.begin(),
-                              measurement_data_pose2_reduced.end());
+      loader.AddStream("Pose2", [&](std::vector<mars::BufferEntryType>* data) {
+        std::vector<mars::BufferEntryType> measurement_data_pose2;
+        mars::ReadVisionData(&measurement_data_pose2, pose2_sensor_sptr_, m_sett.data_path_ + m_sett.pose2_file_name_,
+                             m_sett.t_offset_pose2_);
+        *data = mars::Utils::VecExtractEveryNthElm(measurement_data_pose2, 6);
+      });
     }
 
     // Baro1
     if (m_sett.enable_baro1_)
     {
       std::cout << " - Reading Baro1 Measurement Data" << std::endl;
-      std::vector<mars::BufferEntryType> measurement_data_baro1;
-      mars::ReadBarometerData(&measurement_data_baro1, baro1_sensor_sptr_, m_sett.data_path_ + m_sett.baro1_file_name_,
-                              m_sett.t_offset_baro1_);
-      measurement_data.insert(measurement_data.end(), measurement_data_baro1.begin(), measurement_data_baro1.end());
+      loader.AddStream("Baro1", [&](std::vector<mars::BufferEntryType>* data) {
+        mars::ReadBarometerData(data, baro1_sensor_sptr_, m_sett.data_path_ + m_sett.baro1_file_name_,
+                                m_sett.t_offset_baro1_);
+      });
     }
 
-    std::cout << " - Sort Measurement Data" << std::endl;
-    std::sort(measurement_data.begin(), measurement_data.end());
+    const bool loaded = loader.Load();
+    loader.PrintInfo();
+
+    if (!loaded)
+    {
+      std::cout << "[Warning] Not all measurement files could be read" << std::endl;
+      return EXIT_FAILURE;
+    }
 
-    // Remove entries according to t_start
+    // Remove entries according to t_start and t_stop
+    const mars::Time t_first = loader.get_start_time();
     if (m_sett.t_start_ > 0)
     {
       std::cout << " - Remove entries according to t_start" << std::endl;
-      const double t_start_global = m_sett.t_start_ + measurement_data[0].timestamp_.get_seconds();
-      for (size_t k = 0; k < measurement_data.size(); k++)
-      {
-        if (t_start_global < measurement_data[k].timestamp_.get_seconds())
-        {
-          std::cout << " - Removing: " << measurement_data.size() - k << " entries due to t_start setting" << std::endl;
-          measurement_data.erase(measurement_data.begin(), measurement_data.begin() + k);
-          break;
-        }
-      }
+      t_start_global = t_first + m_sett.t_start_;
     }
 
-    // Remove entries according to t_stop
     if (m_sett.t_stop_ > 0)
     {
       std::cout << " - Remove entries according to t_stop" << std::endl;
-      const double t_stop_global = m_sett.t_stop_ + measurement_data[0].timestamp_.get_seconds();
-      for (size_t k = 0; k < measurement_data.size(); k++)
-      {
-        if (measurement_data[k].timestamp_.get_seconds() > t_stop_global)
-        {
-          std::cout << " - Removing: " << measurement_data.size() - k << " entries due to t_stop setting" << std::endl;
-          measurement_data.erase(measurement_data.begin() + k, measurement_data.end());
-          break;
-        }
-      }
+      t_stop_global = (m_sett.t_start_ > 0 ? t_start_global : t_first) + m_sett.t_stop_;
     }
 
     std::cout << " - DONE" << std::endl;
   }
 
+  mars::DatasetMerger measurement_data = loader.get_merger(t_start_global, t_stop_global);
+  std::cout << " - Removing: " << loader.get_num_entries() - measurement_data.get_num_remaining()
+            << " entries due to t_start and t_stop settings" << std::endl;
+
   // Generate result directory
   std::string result_path(m_sett.data_path_ + m_sett.result_dir_pref_);
   mars::filesystem::MakeDir(result_path);
@@ -541,7 +533,7 @@ int main(int /*argc*/, char** /*argv[]*/)
   ofile_baro1 << mars::WriteCsv::get_cov_header_string(4) << std::endl;
 
   std::cout << "Start Filtering Process..." << std::endl;
-  mars::ProgressIndicator disp_prog(int(measurement_data.size()), 10);
+  mars::ProgressIndicator disp_prog(int(measurement_data.get_num_remaining()), 10);
 
   if (m_sett.use_manual_gps_ref_)
   {
@@ -570,8 +562,74 @@ int main(int /*argc*/, char** /*argv[]*/)
     std::cout << "Manual yaw initialization: " << yaw * (180 / M_PI) << "\n" << std::endl;
   }
 
+  // Store results in csv files once the filter produces them, this does not require any buffer scans. States which
+  // are corrected by a buffer rework are not written again to keep the files in time order.
+  auto write_sensor_state = [](std::ofstream* file, const auto& sensor_data, const mars::Time& timestamp) {
+    // Write Sensor State
+    *file << sensor_data.state_.to_csv_string(timestamp.get_seconds());
+    // Write Sensor State Covariance
+    *file << mars::WriteCsv::cov_mat_to_csv(sensor_data.sensor_cov_);
+    // Terminate line
+    *file << std::endl;
+  };
+
+  core_logic_.AddStateObserver([&](const mars::BufferEntryType& state_entry, const bool& is_correction) {
+    if (is_correction)
+    {
+      return;
+    }
+
+    const std::shared_ptr<mars::SensorAbsClass>& sensor = state_entry.sensor_handle_;
+    const mars::Time& timestamp = state_entry.timestamp_;
+    const std::shared_ptr<void>& sensor_state = state_entry.data_.sensor_state_;
+
+    if (sensor == core_logic_.core_states_->propagation_sensor_)
+    {
+      mars::CoreType core_entry = *static_cast<mars::CoreType*>(state_entry.data_.core_state_.get());
+      // Write Core State
+      ofile_core << core_entry.state_.to_csv_string(timestamp.get_seconds());
+      // Write Core State Covariance
+      ofile_core << mars::WriteCsv::cov_mat_to_csv(core_entry.cov_);
+      // Terminate line
+      ofile_core << std::endl;
+    }
+    else if (sensor == mag1_sensor_sptr_)
+    {
+      write_sensor_state(&ofile_mag1, *static_cast<mars::MagSensorData*>(sensor_state.get()), timestamp);
+    }
+    else if (sensor == mag2_sensor_sptr_)
+    {
+      write_sensor_state(&ofile_mag2, *static_cast<mars::MagSensorData*>(sensor_state.get()), timestamp);
+    }
+    else if (sensor == gps1_sensor_sptr_)
+    {
+      write_sensor_state(&ofile_gps1, *static_cast<mars::GpsVelSensorData*>(sensor_state.get()), timestamp);
+    }
+    else if (sensor == gps2_sensor_sptr_)
+    {
+      write_sensor_state(&ofile_gps2, *static_cast<mars::GpsVelSensorData*>(sensor_state.get()), timestamp);
+    }
+    else if (sensor == gps3_sensor_sptr_)
+    {
+      write_sensor_state(&ofile_gps3, *static_cast<mars::GpsVelSensorData*>(sensor_state.get()), timestamp);
+    }
+    else if (sensor == pose1_sensor_sptr_)
+    {
+      write_sensor_state(&ofile_pose1, *static_cast<mars::VisionSensorData*>(sensor_state.get()), timestamp);
+    }
+    else if (sensor == pose2_sensor_sptr_)
+    {
+      write_sensor_state(&ofile_pose2, *static_cast<mars::VisionSensorData*>(sensor_state.get()), timestamp);
+    }
+    else if (sensor == baro1_sensor_sptr_)
+    {
+      write_sensor_state(&ofile_baro1, *static_cast<mars::PressureSensorData*>(sensor_state.get()), timestamp);
+    }
+  });
+
   // Main processing Loop
-  for (auto k : measurement_data)
+  mars::BufferEntryType k;
+  while (measurement_data.Next(&k))
   {
     // Display progress
     disp_prog.next_step();
@@ -701,81 +759,9 @@ int main(int /*argc*/, char** /*argv[]*/)
       continue;
     }
 
-    // Store results in a csv file
-    if (k.sensor_handle_ == core_logic_.core_states_->propagation_sensor_)
-    {
-      mars::BufferEntryType latest_result;
-      core_logic_.buffer_.get_latest_state(&latest_result);
-      mars::CoreType last_core_entry = *static_cast<mars::CoreType*>(latest_result.data_.core_state_.get());
-      // Write Core State
-      ofile_core << last_core_entry.state_.to_csv_string(latest_result.timestamp_.get_seconds());
-      // Write Core State Covariance
-      ofile_core << mars::WriteCsv::cov_mat_to_csv(last_core_entry.cov_);
-      // Terminate line
-      ofile_core << std::endl;
-    }
-
-    if (k.sensor_handle_ == mag1_sensor_sptr_)
-    {
-      mars::BufferEntryType latest_result;
-      if (!core_logic_.buffer_.get_latest_sensor_handle_state(mag1_sensor_sptr_, &latest_result))
-      {
-        continue;
-      };
-
-      mars::MagSensorData mag_data = *static_cast<mars::MagSensorData*>(latest_result.data_.sensor_state_.get());
-
-      // Write Sensor State
-      ofile_mag1 << mag_data.state_.to_csv_string(latest_result.timestamp_.get_seconds());
-
-      // Write Core State Covariance
-      ofile_mag1 << mars::WriteCsv::cov_mat_to_csv(mag_data.sensor_cov_);
-
-      // Terminate line
-      ofile_mag1 << std::endl;
-    }
-
-    if (k.sensor_handle_ == mag2_sensor_sptr_)
-    {
-      mars::BufferEntryType latest_result;
-      if (!core_logic_.buffer_.get_latest_sensor_handle_state(mag2_sensor_sptr_, &latest_result))
-      {
-        continue;
-      };
-
-      mars::MagSensorData mag_data = *static_cast<mars::MagSensorData*>(latest_result.data_.sensor_state_.get());
-
-      // Write Sensor State
-      ofile_mag2 << mag_data.state_.to_csv_string(latest_result.timestamp_.get_seconds());
-
-      // Write Core State Covariance
-      ofile_mag2 << mars::WriteCsv::cov_mat_to_csv(mag_data.sensor_cov_);
-
-      // Terminate line
-      ofile_mag2 << std::endl;
-    }
-
+    // Write GPS ENU, the states are written by the state observer
     if (k.sensor_handle_ == gps1_sensor_sptr_)
     {
-      mars::BufferEntryType latest_result;
-      if (!core_logic_.buffer_.get_latest_sensor_handle_state(gps1_sensor_sptr_, &latest_result))
-      {
-        continue;
-      };
-
-      // Write GPS State
-      mars::GpsVelSensorData gps_data = *static_cast<mars::GpsVelSensorData*>(latest_result.data_.sensor_state_.get());
-
-      // Write Sensor State
-      ofile_gps1 << gps_data.state_.to_csv_string(latest_result.timestamp_.get_seconds());
-
-      // Write Core State Covariance
-      ofile_gps1 << mars::WriteCsv::cov_mat_to_csv(gps_data.sensor_cov_);
-
-      // Terminate line
-      ofile_gps1 << std::endl;
-
-      // Write GPS ENU
       const Eigen::Vector3d gps_enu(gps1_sensor_sptr_->gps_conversion_.get_enu(
           static_cast<mars::GpsVelMeasurementType*>(k.data_.measurement_.get())->coordinates_));
       ofile_gps1_enu << k.timestamp_ << "," << gps_enu[0] << "," << gps_enu[1] << "," << gps_enu[2] << std::endl;
@@ -783,24 +769,6 @@ int main(int /*argc*/, char** /*argv[]*/)
 
     if (k.sensor_handle_ == gps2_sensor_sptr_)
     {
-      mars::BufferEntryType latest_result;
-      if (!core_logic_.buffer_.get_latest_sensor_handle_state(gps2_sensor_sptr_, &latest_result))
-      {
-        continue;
-      };
-
-      mars::GpsVelSensorData gps_data = *static_cast<mars::GpsVelSensorData*>(latest_result.data_.sensor_state_.get());
-
-      // Write Sensor State
-      ofile_gps2 << gps_data.state_.to_csv_string(latest_result.timestamp_.get_seconds());
-
-      // Write Core State Covariance
-      ofile_gps2 << mars::WriteCsv::cov_mat_to_csv(gps_data.sensor_cov_);
-
-      // Terminate line
-      ofile_gps2 << std::endl;
-
-      // Write GPS ENU
       const Eigen::Vector3d gps_enu(gps2_sensor_sptr_->gps_conversion_.get_enu(
           static_cast<mars::GpsVelMeasurementType*>(k.data_.measurement_.get())->coordinates_));
       ofile_gps2_enu << k.timestamp_ << "," << gps_enu[0] << "," << gps_enu[1] << "," << gps_enu[2] << std::endl;
@@ -808,89 +776,10 @@ int main(int /*argc*/, char** /*argv[]*/)
 
     if (k.sensor_handle_ == gps3_sensor_sptr_)
     {
-      mars::BufferEntryType latest_result;
-      if (!core_logic_.buffer_.get_latest_sensor_handle_state(gps3_sensor_sptr_, &latest_result))
-      {
-        continue;
-      };
-
-      mars::GpsVelSensorData gps_data = *static_cast<mars::GpsVelSensorData*>(latest_result.data_.sensor_state_.get());
-
-      // Write Sensor State
-      ofile_gps3 << gps_data.state_.to_csv_string(latest_result.timestamp_.get_seconds());
-
-      // Write Core State Covariance
-      ofile_gps3 << mars::WriteCsv::cov_mat_to_csv(gps_data.sensor_cov_);
-
-      // Terminate line
-      ofile_gps3 << std::endl;
-
-      // Write GPS ENU
       const Eigen::Vector3d gps_enu(gps3_sensor_sptr_->gps_conversion_.get_enu(
           static_cast<mars::GpsVelMeasurementType*>(k.data_.measurement_.get())->coordinates_));
       ofile_gps3_enu << k.timestamp_ << "," << gps_enu[0] << "," << gps_enu[1] << "," << gps_enu[2] << std::endl;
     }
-
-    if (k.sensor_handle_ == pose1_sensor_sptr_)
-    {
-      mars::BufferEntryType latest_result;
-      if (!core_logic_.buffer_.get_latest_sensor_handle_state(pose1_sensor_sptr_, &latest_result))
-      {
-        continue;
-      };
-
-      mars::VisionSensorData pose_data = *static_cast<mars::VisionSensorData*>(latest_result.data_.sensor_state_.get());
-
-      // Write Sensor State
-      ofile_pose1 << pose_data.state_.to_csv_string(latest_result.timestamp_.get_seconds());
-
-      // Write Core State Covariance
-      ofile_pose1 << mars::WriteCsv::cov_mat_to_csv(pose_data.sensor_cov_);
-
-      // Terminate line
-      ofile_pose1 << std::endl;
-    }
-
-    if (k.sensor_handle_ == pose2_sensor_sptr_)
-    {
-      mars::BufferEntryType latest_result;
-      if (!core_logic_.buffer_.get_latest_sensor_handle_state(pose2_sensor_sptr_, &latest_result))
-      {
-        continue;
-      };
-
-      mars::VisionSensorData pose_data = *static_cast<mars::VisionSensorData*>(latest_result.data_.sensor_state_.get());
-
-      // Write Sensor State
-      ofile_pose2 << pose_data.state_.to_csv_string(latest_result.timestamp_.get_seconds());
-
-      // Write Core State Covariance
-      ofile_pose2 << mars::WriteCsv::cov_mat_to_csv(pose_data.sensor_cov_);
-
-      // Terminate line
-      ofile_pose2 << std::endl;
-    }
-
-    if (k.sensor_handle_ == baro1_sensor_sptr_)
-    {
-      mars::BufferEntryType latest_result;
-      if (!core_logic_.buffer_.get_latest_sensor_handle_state(baro1_sensor_sptr_, &latest_result))
-      {
-        continue;
-      };
-
-      mars::PressureSensorData baro_data =
-          *static_cast<mars::PressureSensorData*>(latest_result.data_.sensor_state_.get());
-
-      // Write Sensor State
-      ofile_baro1 << baro_data.state_.to_csv_string(latest_result.timestamp_.get_seconds());
-
-      // Write Core State Covariance
-      ofile_baro1 << mars::WriteCsv::cov_mat_to_csv(baro_data.sensor_cov_);
-
-      // Terminate line
-      ofile_baro1 << std::endl;
-    }
   }
 
   std::cout << "...Completed Filtering Process" << std::endl;
@@ -0,0 +1,59 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+namespace mars
+{
+///
+/// \brief The AllocationCounter class counts the heap allocations of the calling thread
+///
+/// The library does not intercept the allocator. Counting is opt-in: an executable that needs the count interposes
+/// malloc and its siblings, or replaces the global operator new, and calls Record for each allocation. Without such a
+/// hook, IsHooked returns false and all counts are zero. A hook on operator new alone misses the allocations with
+/// malloc, e.g. of dynamic Eigen matrices.
+///
+class AllocationCounter
+{
+public:
+  ///
+  /// \brief Start Resets the count of the calling thread and starts counting
+  ///
+  static void Start();
+
+  ///
+  /// \brief Stop Stops counting for the calling thread
+  /// \return Number of allocations since Start
+  ///
+  static long Stop();
+
+  ///
+  /// \brief get_count
+  /// \return Number of allocations of the calling thread since the last Start
+  ///
+  static long get_count();
+
+  ///
+  /// \brief Record Allocation hook, counts one allocation if counting was started on the calling thread
+  ///
+  /// \note Called from within the allocation functions, must not allocate
+  ///
+  static void Record() noexcept;
+
+  ///
+  /// \brief IsHooked
+  /// \return true once an allocation hook called Record
+  ///
+  static bool IsHooked();
+};
+}  // namespace mars
+
+#endif  // ALLOCATION_COUNTER_H
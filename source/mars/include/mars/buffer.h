@@ -16,11 +16,12 @@
 #include <mars/sensors/sensor_abs_class.h>
 #include <mars/time.h>
 #include <mars/type_definitions/buffer_entry_type.h>
+#include <boost/circular_buffer.hpp>
 #include <algorithm>
 #include <cmath>
-#include <deque>
 #include <iostream>
 #include <set>
+#include <utility>
 #include <vector>
 
 namespace mars
@@ -29,7 +30,10 @@ namespace mars
 /// \brief BufferClass that holds mars::BufferEntryType elements and provides access methods
 /// \author Christian Brommer <christian.brommer@ieee.org>
 /// \attention Erasing elements that are not located at the end or beginning of the buffer will
-/// invalidate the deque iterator
+/// invalidate the iterators
+///
+/// The entries are stored in ring buffers which are sized with the max buffer size. Adding and removing entries does
+/// not allocate, unless the number of entries exceeds the reserved capacity, see set_max_buffer_size.
 ///
 class Buffer
 {
@@ -48,6 +52,10 @@ public:
 
   ///
   /// \brief set_max_buffer_size
+  ///
+  /// Reserves memory for 'size' entries and a margin for the entries which are added before the overflow is removed.
+  /// The capacity is not reduced if the size decreases.
+  ///
   /// \param size max number of entrys after which the oldest entry is deleted
   ///
   void set_max_buffer_size(const int& size);
@@ -84,6 +92,15 @@ public:
     return static_cast<int>(data_.size());
   }
 
+  ///
+  /// \brief get_capacity
+  /// \return number of entries the buffer holds without an allocation, sized by set_max_buffer_size
+  ///
+  inline int get_capacity() const
+  {
+    return static_cast<int>(data_.capacity());
+  }
+
   ///
   /// \brief PrintBufferEntries prints all buffer entries in a formatted way
   ///
@@ -196,6 +213,46 @@ public:
   ///
   bool RemoveSensorFromBuffer(const std::shared_ptr<SensorAbsClass>& sensor_handle);
 
+  ///
+  /// \brief RemoveSensorEntries Removes the entries of the given sensor handles in the index range [start_idx, end_idx)
+  ///
+  /// The remaining entries of the range are compacted and the gap is erased at once, the cost is a single pass over
+  /// the range plus one range erase.
+  ///
+  /// \return Number of removed entries
+  ///
+  int RemoveSensorEntries(const std::vector<std::shared_ptr<SensorAbsClass>>& sensor_handles, const int& start_idx,
+                          const int& end_idx);
+
+  ///
+  /// \brief get_rework_segment_start_idx Returns the first index of the entries a rework starting at 'idx' reads
+  ///
+  /// The rework propagates from the latest state before 'idx' and updates each update sensor of the range [idx, end)
+  /// from its latest state before 'idx', with the state transitions in between.
+  ///
+  /// \param propagation_sensor Sensor handle of the propagation sensor
+  /// \return Index of the oldest of these states, 'idx' if there is none
+  ///
+  int get_rework_segment_start_idx(const int& idx, const std::shared_ptr<SensorAbsClass>& propagation_sensor) const;
+
+  ///
+  /// \brief CopyEntriesStartingAtIdx Replaces the entries with the entries [idx, end) of 'source'
+  ///
+  void CopyEntriesStartingAtIdx(const Buffer& source, const int& idx);
+
+  ///
+  /// \brief SpliceEntriesStartingAtIdx Replaces the entries [idx, end) with the entries of 'segment'
+  ///
+  /// The entries are moved, 'segment' is empty afterwards.
+  ///
+  void SpliceEntriesStartingAtIdx(const int& idx, Buffer* segment);
+
+  ///
+  /// \brief LowerBoundIdx Binary search for the first entry which is not older than 'timestamp'
+  /// \return Index of the entry, get_length() if all entries are older
+  ///
+  int LowerBoundIdx(const Time& timestamp) const;
+
   ///
   /// \brief AddEntrySorted Adds a new entry to the buffer and ensures the buffer is sorted
   /// \param new_entry new buffer entry to be added
@@ -261,13 +318,72 @@ public:
   ///
   /// \brief RemoveOverflowEntrys Removes the oldest entries if max buffer size is reached
   ///
+  /// All entries above the max buffer size are removed in one call, except the last state of each sensor handle.
+  ///
   int RemoveOverflowEntrys();
 
 private:
   ///
-  /// \brief deque container that holds the buffer entries
+  /// \brief The HotEntry struct holds the fields of a buffer entry that are needed by the search routines
+  ///
+  /// Scanning the full BufferEntryType strides over the state and measurement pointers and the metadata filter sets of
+  /// each entry (several cache lines per entry). The hot entries are kept in a compact container in sync with 'data_'
+  /// such that the scans only touch the hot entries and only access 'data_' for the entry that is returned.
+  ///
+  struct HotEntry
+  {
+    Time timestamp_;                                  ///< Timestamp of the entry
+    const SensorAbsClass* sensor_handle_{ nullptr };  ///< Sensor identity, not owned
+    int metadata_{ BufferMetadataType::invalid };     ///< Metadata of the entry
+    bool has_states_{ false };                        ///< Cached BufferEntryType::HasStates
+    bool is_valid_{ false };                          ///< Cached BufferEntryType::IsValid
+
+    HotEntry() = default;
+    explicit HotEntry(const BufferEntryType& entry)
+      : timestamp_(entry.timestamp_)
+      , sensor_handle_(entry.sensor_handle_.get())
+      , metadata_(entry.metadata_)
+      , has_states_(entry.HasStates())
+      , is_valid_(entry.IsValid())
+    {
+    }
+  };
+
+  ///
+  /// \brief InsertEntry Adds 'new_entry' at position 'index' of the entry and hot entry containers
+  ///
+  void InsertEntry(const int& index, const BufferEntryType& new_entry);
+
+  ///
+  /// \brief EraseEntry Removes the entry at position 'index' of the entry and hot entry containers
+  ///
+  void EraseEntry(const int& index);
+
+  ///
+  /// \brief ReserveEntries Grows the capacity of the entry and hot entry containers to at least 'num_entries'
+  ///
+  void ReserveEntries(const size_t& num_entries);
+
+  ///
+  /// \brief IncrementStateCount Adds 'increment' to the state count of 'sensor_handle' in 'overflow_state_count_'
+  /// \return Updated state count of the sensor handle
+  ///
+  int IncrementStateCount(const SensorAbsClass* sensor_handle, const int& increment);
+
+  ///
+  /// \brief ring buffer that holds the buffer entries, never full since ReserveEntries grows it before an insert
+  ///
+  boost::circular_buffer<BufferEntryType> data_;
+
+  ///
+  /// \brief ring buffer that holds the hot fields of the buffer entries, same order and length as 'data_'
+  ///
+  boost::circular_buffer<HotEntry> hot_;
+
+  ///
+  /// \brief Number of states per sensor handle, scratch space of RemoveOverflowEntrys which keeps its capacity
   ///
-  std::deque<BufferEntryType> data_;
+  std::vector<std::pair<const SensorAbsClass*, int>> overflow_state_count_;
 
   ///
   /// \brief defines the max size at wich the oldest entry is removed
@@ -13,14 +13,38 @@
 
 #include <mars/buffer.h>
 #include <mars/core_state.h>
+#include <mars/flight_recorder.h>
+#include <mars/load_shedder.h>
+#include <mars/measurement_journal.h>
+#include <mars/nearest_cov.h>
+#include <mars/object_pool.h>
 #include <mars/sensor_manager.h>
+#include <mars/shm_state_publisher.h>
+#include <mars/state_observer.h>
+#include <mars/state_transition_tree.h>
 #include <mars/type_definitions/core_state_type.h>
 #include <Eigen/Dense>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 namespace mars
 {
+///
+/// \brief Metrics of the buffer reworks triggered by out of order measurements
+///
+struct ReworkStats
+{
+  int num_ooo_measurements_{ 0 };       ///< Out of order measurements which were added to the buffer
+  int num_reworks_{ 0 };                ///< Number of buffer reworks
+  long num_reworked_entries_{ 0 };      ///< Sum of the buffer entries which were reprocessed by the reworks
+  double rework_time_{ 0 };             ///< Sum of the processing time [s] of the reworks
+  double rework_time_max_{ 0 };         ///< Max processing time [s] of a single rework
+  int num_speculative_reworks_{ 0 };    ///< Reworks which were performed on the worker thread
+  long num_repropagated_entries_{ 0 };  ///< Entries propagated during speculative reworks and propagated again
+};
+
 ///
 /// \brief The CoreLogic class represents the high-level logic for the operation of the filter
 ///
@@ -32,7 +56,7 @@ public:
   std::shared_ptr<CoreState> core_states_{ nullptr };  /// Holds a pointer to the core_states
   Buffer buffer_;                                      /// Main buffer of the filter
   Buffer buffer_prior_core_init_;                      /// Buffer that holds measurements prior initialization
-  SensorManager sensor_manager_;
+  SensorManager sensor_manager_;                       /// Registry of the sensors, changes are applied lazily
   bool core_is_initialized_{ false };  /// core_is_initialized_ = true if the core state was initialized, false
                                        /// otherwise
   bool core_init_warn_once_{ false };
@@ -41,6 +65,24 @@ public:
   bool discard_ooo_prop_meas_{ false };      /// Discard out of order propagation sensor measurements
   bool add_interm_buffer_entries_{ false };  /// Determines if intermediate entries before a sensor update are stored to
                                              /// the buffer
+  std::shared_ptr<ShmStatePublisher> state_publisher_{ nullptr };  /// Optional publisher, fed with each new state
+  std::shared_ptr<StateEventQueue> state_queue_{ nullptr };  /// Optional queue, fed with each new and reworked state
+  std::shared_ptr<MeasurementJournal> journal_{ nullptr };  /// Optional journal, records each ProcessMeasurement call
+  std::shared_ptr<LoadShedder> load_shedder_{ nullptr };    /// Optional CPU budget for update sensors
+  std::shared_ptr<FlightRecorder> flight_recorder_{ nullptr };  /// Optional crash safe record of the latest history
+  bool coalesce_ooo_reworks_{ false };  /// Combine the reworks of consecutive out of order measurements
+  int max_coalesced_ooo_{ 16 };         /// Max number of out of order measurements combined into one rework
+  /// Use a StateTransitionTree for the state transition blocks of reworks. Off by default, the Q_d generation of the
+  /// re-propagation dominates the rework cost and the tree gives no measurable gain (-O3, full reworks with six
+  /// sensors: 0.43s with the tree, 0.45s without)
+  bool use_transition_tree_{ false };
+  bool speculative_rework_{ false };    /// Perform long reworks on a worker thread, see FinishSpeculativeRework
+  int speculative_min_entries_{ 100 };  /// Min number of reworked entries for a rework on the worker thread
+  int prop_decimation_{ 1 };            /// Propagate with one of 'prop_decimation_' propagation measurements
+  bool prop_decimation_avg_{ false };   /// Propagate with the average of the decimated measurements, not the last
+
+  /// Called by ProcessMeasurements with the state entry of each successfully processed measurement
+  using StateCallback = std::function<void(const BufferEntryType& state_entry)>;
 
   ///
   /// \brief CoreLogic
@@ -61,6 +103,9 @@ public:
   /// \brief GenerateStateTransitionBlock Returns the state transition block between 'first_transition_idx' and
   /// 'last_transition_idx'
   ///
+  /// With 'use_transition_tree_' set, blocks requested during a buffer rework are composed from the segment tree
+  /// 'transition_tree_' in O(log n) matrix products. Otherwise all transitions of the range are multiplied.
+  ///
   CoreStateMatrix GenerateStateTransitionBlock(const int& first_transition_idx, const int& last_transition_idx);
 
   ///
@@ -69,6 +114,13 @@ public:
   Eigen::MatrixXd PropagateSensorCrossCov(const Eigen::MatrixXd& sensor_cov, const CoreStateMatrix& core_cov,
                                           const CoreStateMatrix& state_transition);
 
+  ///
+  /// \brief PropagateSensorCrossCov Writes the propagated covariance to 'propagated_cov', which keeps its memory if
+  /// it has the size of 'sensor_cov'. 'propagated_cov' must not be 'sensor_cov'.
+  ///
+  void PropagateSensorCrossCov(const Eigen::MatrixXd& sensor_cov, const CoreStateMatrix& core_cov,
+                               const CoreStateMatrix& state_transition, Eigen::MatrixXd* propagated_cov);
+
   ///
   /// \brief PerformSensorUpdate Returns new state with corrected state and updated covariance
   ///
@@ -125,9 +177,290 @@ public:
   /// measurement was out of order; the buffer is reprocessed
   /// starting at the index of the out of order measurement.
   ///
+  /// If a LoadShedder is set, update measurements which exceed the CPU budget are shed before any processing, and
+  /// deferred measurements are processed after the propagation steps.
+  ///
+  /// If 'coalesce_ooo_reworks_' is set, the rework for out of order measurements is postponed, see FlushPendingRework.
+  ///
+  /// Sensor changes queued at 'sensor_manager_' by other threads are applied before the measurement is processed, and
+  /// buffer entries of removed sensors are cleaned up in steps of 'sensor_manager_.cleanup_step_' entries.
+  ///
+  /// If 'speculative_rework_' is set, reworks of at least 'speculative_min_entries_' entries are performed on a
+  /// worker thread, see FinishSpeculativeRework.
+  ///
+  /// If 'prop_decimation_' is larger than one, in order propagation sensor measurements of the initialized filter are
+  /// accumulated and only every 'prop_decimation_'th measurement is propagated, see FlushDecimatedPropagation. Use the
+  /// closed-form transition of the core state (CoreState::state_transition_type_) for the resulting large time steps.
+  ///
   /// \return True if the processing of the measurement was successful
   ///
   bool ProcessMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp, const BufferDataType& data);
+
+  ///
+  /// \brief ProcessMeasurement Processes the sensor input with a given arrival time, see ProcessMeasurement
+  ///
+  /// The arrival time is stored with the buffer entry of the measurement (BufferEntryType::arrival_ns_) and is
+  /// delivered with each state of the entry, including the states of a rework, e.g. to track the age of the
+  /// estimate with MeasurementAgeTracker. The overload without arrival time uses the time of the call.
+  ///
+  /// \param arrival_ns Wall time at which the measurement arrived [ns since epoch], e.g. the receive time of a driver
+  ///
+  bool ProcessMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp, const BufferDataType& data,
+                          const int64_t& arrival_ns);
+
+  ///
+  /// \brief ProcessMeasurements Processes a batch of measurements, e.g. for the offline replay of a dataset
+  ///
+  /// \param measurements Measurements with timestamp, data and sensor handle
+  /// \param callback Optional, called with the latest state of the buffer after each successfully processed measurement
+  ///
+  /// The result equals calling ProcessMeasurement for each element. If the batch is sorted by time, newer than the
+  /// buffer, the core is initialized, no LoadShedder is set and the propagation is not decimated, the measurements
+  /// take a fast path which skips the out of order classification and the search for the latest state. Overflowing
+  /// buffer entries are removed once at the end of the batch, the buffer holds up to max buffer size plus batch length
+  /// entries during the call. Long recordings are therefore replayed in batches, e.g. of the max buffer size.
+  /// Otherwise, and for measurements before the core initialization, ProcessMeasurement is used.
+  ///
+  /// \return Number of successfully processed measurements
+  ///
+  int ProcessMeasurements(const std::vector<BufferEntryType>& measurements, const StateCallback& callback = nullptr);
+
+  ///
+  /// \brief FlushPendingRework Performs the rework of coalesced out of order measurements
+  ///
+  /// With 'coalesce_ooo_reworks_' set, out of order measurements are only inserted into the buffer. A single rework,
+  /// starting at the oldest of them, is performed before the next in order measurement is processed, once
+  /// 'max_coalesced_ooo_' measurements are pending, or if this method is called. Call it before reading the buffer
+  /// if the latest state needs to include all measurements received so far.
+  ///
+  /// \return true if a rework was performed
+  ///
+  bool FlushPendingRework();
+
+  ///
+  /// \brief FlushDecimatedPropagation Propagates with the measurements accumulated by the decimated propagation
+  ///
+  /// The propagation uses the last accumulated measurement at its timestamp. If 'prop_decimation_avg_' is set, a least
+  /// squares line is fitted to the accumulated measurements and evaluated at the last timestamp instead. This averages
+  /// the measurement noise without the delay of half the decimation interval a plain mean would add. ProcessMeasurement
+  /// flushes before each measurement of an update sensor, such that updates are performed with a state propagated by
+  /// all prior propagation measurements.
+  ///
+  /// \return true if measurements were accumulated
+  ///
+  bool FlushDecimatedPropagation();
+
+  ///
+  /// \brief FinishSpeculativeRework Waits for the rework on the worker thread and splices the result into the buffer
+  ///
+  /// With 'speculative_rework_' set, a long rework is performed on a persistent worker thread with a copy of the
+  /// reworked segment, which starts at the states the rework reads, see Buffer::get_rework_segment_start_idx. The
+  /// entries of the copy share their data with the buffer, the rework only replaces the state pointers of the copy.
+  /// Meanwhile, in order measurements of the propagation sensor are propagated from the outdated states, all other
+  /// measurements are deferred because they would access the reworked part of the buffer or the update sensors.
+  ///
+  /// The worker propagates with its own copy of the core state. The update sensors are not copied, they are owned by
+  /// the worker thread until the rework was spliced. Do not call methods of the update sensors (e.g. CalcUpdate or
+  /// set_initial_calib) from other threads while IsSpeculativeReworkRunning returns true.
+  ///
+  /// Once the worker finished, the next ProcessMeasurement call or this method replaces the reworked segment. The
+  /// entries that were added during the rework and the deferred measurements are processed by a rework starting at the
+  /// reworked states. Deferred measurements which are older than the reworked segment are processed afterwards and can
+  /// start the next speculative rework, call this method until it returns false to include all measurements.
+  ///
+  /// \return true if a speculative rework was finished
+  ///
+  bool FinishSpeculativeRework();
+
+  ///
+  /// \brief IsSpeculativeReworkRunning
+  /// \return true if a rework is performed on the worker thread and was not spliced into the buffer yet
+  ///
+  bool IsSpeculativeReworkRunning() const;
+
+  ///
+  /// \brief get_rework_stats
+  /// \return Metrics of the out of order reworks since the creation of the CoreLogic
+  ///
+  const ReworkStats& get_rework_stats() const;
+
+  ///
+  /// \brief AddStateObserver Registers a function which is called once for each state the filter produces
+  ///
+  /// Observers are called in the filter thread with the initial core state, the state of each processed in order
+  /// measurement, and the states of all entries which are reprocessed by a buffer rework (flagged as correction, in
+  /// time order after the rework). Intermediate propagation entries are not reported, the following sensor state has
+  /// the same timestamp. Consumers do not need to scan the buffer to detect new states.
+  ///
+  /// \param observer Function called with the state entry
+  /// \return Id of the observer for RemoveStateObserver
+  ///
+  int AddStateObserver(StateObserver observer);
+
+  ///
+  /// \brief RemoveStateObserver
+  /// \param id Id returned by AddStateObserver
+  /// \return false if no observer with this id exists
+  ///
+  bool RemoveStateObserver(const int& id);
+
+private:
+  ///
+  /// \brief DispatchMeasurement Applies the LoadShedder if set and processes the measurement, see ProcessMeasurement
+  /// \param arrival_ns Arrival time of the measurement, stored with its buffer entry
+  ///
+  bool DispatchMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp, const BufferDataType& data,
+                           const int64_t& arrival_ns);
+
+  ///
+  /// \brief DecimatePropagation Accumulates an in order measurement of the propagation sensor
+  /// \param prop_data Output for the data of the propagation if one is due, see FlushDecimatedPropagation
+  /// \param prop_timestamp Output for the timestamp of the propagation
+  /// \return true if the propagation is due
+  ///
+  bool DecimatePropagation(const Time& timestamp, const BufferDataType& data, Time* prop_timestamp,
+                           BufferDataType* prop_data);
+
+  ///
+  /// \brief TakeDecimatedPropagation Returns the propagation for the accumulated measurements and resets them
+  ///
+  void TakeDecimatedPropagation(Time* prop_timestamp, BufferDataType* prop_data);
+
+  ///
+  /// \brief ProcessSensorMeasurement Processes an admitted measurement, see ProcessMeasurement
+  ///
+  bool ProcessSensorMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                                const BufferDataType& data, const int64_t& arrival_ns);
+
+  ///
+  /// \brief ProcessInOrderMeasurement Propagates or updates with a measurement which is newer than all buffer entries
+  /// and adds the resulting state to the buffer
+  ///
+  bool ProcessInOrderMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                                 BufferEntryType* new_sensor_entry);
+
+  ///
+  /// \brief ProcessTimedMeasurement Processes an admitted measurement and reports the cost to the LoadShedder
+  ///
+  /// Measurements which are deferred during a speculative rework report no cost. The splice of a finished speculative
+  /// rework is reported as overhead, see LoadShedder::ReportOverhead.
+  ///
+  bool ProcessTimedMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                               const BufferDataType& data, const int64_t& arrival_ns);
+
+  ///
+  /// \brief RecordInput Passes a measurement to the journal and the flight recorder, if they are set
+  ///
+  /// Called once for each measurement that enters ProcessMeasurement or the in order path of ProcessMeasurements.
+  ///
+  void RecordInput(const SensorAbsClass* sensor, const Time& timestamp, const BufferDataType& data,
+                   const int64_t& arrival_ns);
+
+  ///
+  /// \brief UpdateSensorRegistry Applies queued sensor changes of 'sensor_manager_' and performs a cleanup step
+  ///
+  void UpdateSensorRegistry();
+
+  ///
+  /// \brief NotifyBatchCallback Calls the ProcessMeasurements 'callback' with the latest state of the buffer
+  ///
+  void NotifyBatchCallback(const StateCallback& callback) const;
+
+  ///
+  /// \brief PerformRework Reworks the buffer starting at 'index', updates the rework metrics and publishes the result
+  ///
+  void PerformRework(const int& index);
+
+  ///
+  /// \brief DeferDuringSpeculativeRework Defers a measurement which cannot be processed during the speculative rework
+  /// \return false for in order measurements of the propagation sensor, which are processed right away
+  ///
+  bool DeferDuringSpeculativeRework(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                                    const BufferDataType& data, const int64_t& arrival_ns);
+
+  ///
+  /// \brief StartSpeculativeRework Starts the rework of a copy of the reworked segment on the worker thread
+  /// \return false if a speculative rework is already running
+  ///
+  bool StartSpeculativeRework(const int& index);
+
+  ///
+  /// \brief PublishReworkedEntry Passes a state of a rework to the observers and the flight recorder
+  ///
+  void PublishReworkedEntry(const BufferEntryType& state_entry);
+
+  ///
+  /// \brief GenerateStateTransitionBlockFromTree Loads missing leaves of the transition tree from the buffer and
+  /// returns the state transition block
+  ///
+  CoreStateMatrix GenerateStateTransitionBlockFromTree(const int& first_transition_idx, const int& last_transition_idx);
+
+  ///
+  /// \brief InvalidateTransitionTree Removes the leaves starting at buffer index 'idx' from the transition tree
+  ///
+  void InvalidateTransitionTree(const int& idx);
+
+  ///
+  /// \brief NotifyStateObservers Passes a new state to the observers and the state queue
+  ///
+  void NotifyStateObservers(const BufferEntryType& state_entry, const bool& is_correction);
+
+  ///
+  /// \brief HasStateObservers
+  /// \return true if observers or a state queue are registered
+  ///
+  bool HasStateObservers() const;
+
+  ///
+  /// \brief The UpdateWorkspace struct holds the covariances of the updates of one sensor, which keep their memory
+  ///
+  struct UpdateWorkspace
+  {
+    Eigen::MatrixXd sensor_cov_;     ///< Prior covariance of the sensor state
+    Eigen::MatrixXd prior_cov_;      ///< Prior covariance with the propagated cross covariance
+    Eigen::MatrixXd corrected_cov_;  ///< Prior covariance after the NearestCov correction
+  };
+
+  ///
+  /// \brief get_update_workspace
+  /// \return Workspace of 'sensor', added on the first update of the sensor
+  ///
+  UpdateWorkspace* get_update_workspace(const SensorAbsClass* sensor);
+
+  ReworkStats rework_stats_;
+  std::vector<std::pair<const SensorAbsClass*, UpdateWorkspace>> update_workspaces_;  ///< Workspace per sensor
+  NearestCov nearest_cov_;                                                            ///< Prior covariance correction
+  ObjectPool<IMUMeasurementType> imu_measurement_pool_;  ///< Intermediate and decimated propagation measurements
+  StateTransitionTree transition_tree_;
+  bool transition_tree_active_{ false };  ///< True during reworks if 'use_transition_tree_' is set
+  int transition_tree_first_{ 0 };        ///< First buffer index with a valid leaf
+  int transition_tree_end_{ 0 };          ///< Buffer index after the last valid leaf
+  int pending_rework_idx_{ -1 };  ///< Buffer index of the oldest out of order measurement without rework, -1 if none
+  int num_pending_ooo_{ 0 };      ///< Number of out of order measurements without rework
+  std::vector<std::pair<int, StateObserver>> state_observers_;  ///< Registered observers and their id
+  int next_observer_id_{ 0 };
+
+  struct SpeculativeRework;
+  std::shared_ptr<SpeculativeRework> speculative_{ nullptr };  ///< Worker and state of the speculative rework
+
+  ///
+  /// \brief The DecimatedPropagation struct holds the propagation measurements accumulated since the last propagation
+  ///
+  struct DecimatedPropagation
+  {
+    int num_measurements_{ 0 };                          ///< Number of accumulated measurements
+    Time first_timestamp_;                               ///< Time origin of the line fit
+    Time last_timestamp_;                                ///< Timestamp of the last measurement
+    int64_t last_arrival_ns_{ 0 };                       ///< Arrival time of the last measurement
+    BufferDataType last_data_;                           ///< Last measurement
+    double sum_t_{ 0 };                                  ///< Sum of the times t since 'first_timestamp_'
+    double sum_tt_{ 0 };                                 ///< Sum of t^2
+    Eigen::Vector3d sum_a_{ Eigen::Vector3d::Zero() };   ///< Sum of the linear accelerations a
+    Eigen::Vector3d sum_w_{ Eigen::Vector3d::Zero() };   ///< Sum of the angular velocities w
+    Eigen::Vector3d sum_ta_{ Eigen::Vector3d::Zero() };  ///< Sum of t * a
+    Eigen::Vector3d sum_tw_{ Eigen::Vector3d::Zero() };  ///< Sum of t * w
+  };
+  DecimatedPropagation decimated_prop_;
 };
 }  // namespace mars
 
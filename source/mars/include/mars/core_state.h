@@ -11,6 +11,7 @@
 #ifndef CORESTATE_H
 #define CORESTATE_H
 
+#include <mars/object_pool.h>
 #include <mars/sensors/imu/imu_measurement_type.h>
 #include <mars/sensors/sensor_abs_class.h>
 #include <mars/time.h>
@@ -43,9 +44,17 @@ public:
 
   std::shared_ptr<SensorAbsClass> propagation_sensor_{ nullptr };  ///< Reference to the propagation sensor
 
+  /// Core states of the buffer entries, shared by the CoreLogic and the update sensors. Copies of the CoreState share
+  /// the objects. The CoreLogic reserves the capacity of its buffer on initialization.
+  ObjectPool<CoreType> core_type_pool_;
+
   bool test_state_transition_{ false };  ///< If true, the class performs tests on the state-transition properties
   bool verbose_{ false };                ///< increased output of information
 
+  /// State transition and process noise of the covariance prediction. The closed form remains accurate for large
+  /// propagation steps, e.g. for the decimated propagation of CoreLogic.
+  StateTransitionType state_transition_type_{ StateTransitionType::small_angle_approx };
+
   ///
   /// \brief CoreState Default constructor
   ///
@@ -63,6 +72,18 @@ public:
   ///
   void set_fixed_gyro_bias(const bool& value);
 
+  ///
+  /// \brief get_fixed_acc_bias
+  /// \return true if the accelerometer bias is not estimated
+  ///
+  bool get_fixed_acc_bias() const;
+
+  ///
+  /// \brief get_fixed_gyro_bias
+  /// \return true if the gyro bias is not estimated
+  ///
+  bool get_fixed_gyro_bias() const;
+
   ///
   /// \brief set_propagation_sensor Stores a reference to the propagation sensor
   /// \param propagation_sensor
@@ -133,19 +154,46 @@ public:
   CoreType PredictProcessCovariance(const CoreType& prior_core_state, const IMUMeasurementType& system_input,
                                     const double& dt);
 
+  ///
+  /// \brief PropagateStateAndCovariance Fused PropagateState and PredictProcessCovariance
+  /// \param prior_core_state Prior core state and covariance
+  /// \param system_input Measurement for the system input
+  /// \param dt propagation timespan
+  /// \return Propagated core state, covariance and state transition matrix
+  ///
+  /// \note Intermediate terms such as the rotation matrix of the prior orientation are shared between the state,
+  /// the state transition and the covariance prediction.
+  CoreType PropagateStateAndCovariance(const CoreType& prior_core_state, const IMUMeasurementType& system_input,
+                                       const double& dt);
+
   // Static
   ///
   /// \brief GenerateFdTaylor Generates the state-transition matrix with cut-off Taylor series
+  ///
+  /// \param q_wi   orientation of imu in world
+  /// \param a_est  the estimate of the acceleration (a_m - b_a)
+  /// \param w_est  the estimate of the angular velocity (w_m - b_w)
+  /// \param dt     time step
+  /// \param order  highest power of the series of exp(A * dt)
+  ///
   /// \return state-transition matrix
   ///
-  static CoreStateMatrix GenerateFdTaylor();
+  static CoreStateMatrix GenerateFdTaylor(const Eigen::Quaterniond& q_wi, const Eigen::Vector3d& a_est,
+                                          const Eigen::Vector3d& w_est, const double& dt, const int& order);
 
   ///
   /// \brief GenerateFdClosedForm Generates the state-transition matrix in closed-form
+  ///
+  /// \param q_wi   orientation of imu in world
+  /// \param a_est  the estimate of the acceleration (a_m - b_a)
+  /// \param w_est  the estimate of the angular velocity (w_m - b_w)
+  /// \param dt     time step
+  ///
   /// \note Solar - Quaternion Kinematics Section B.3
   /// \return state-transition matrix
   ///
-  static CoreStateMatrix GenerateFdClosedForm();
+  static CoreStateMatrix GenerateFdClosedForm(const Eigen::Quaterniond& q_wi, const Eigen::Vector3d& a_est,
+                                              const Eigen::Vector3d& w_est, const double& dt);
 
   ///
   /// \brief GenerateFdSmallAngleApprox Generates the state-transition matrix with small angle approximation
@@ -166,6 +214,16 @@ public:
                                                const Eigen::Vector3d& b_a, const Eigen::Vector3d& n_ba,
                                                const Eigen::Vector3d& w_m, const Eigen::Vector3d& n_w,
                                                const Eigen::Vector3d& b_w, const Eigen::Vector3d& n_bw);
+
+  ///
+  /// \brief CalcQClosedForm Generates the discrete process noise matching GenerateFdClosedForm
+  /// \note The parameters correspond to CalcQSmallAngleApprox
+  ///
+  static CoreStateMatrix CalcQClosedForm(const double& dt, const Eigen::Quaterniond& q_wi, const Eigen::Vector3d& a_m,
+                                         const Eigen::Vector3d& n_a, const Eigen::Vector3d& b_a,
+                                         const Eigen::Vector3d& n_ba, const Eigen::Vector3d& w_m,
+                                         const Eigen::Vector3d& n_w, const Eigen::Vector3d& b_w,
+                                         const Eigen::Vector3d& n_bw);
 };
 }  // namespace mars
 
@@ -0,0 +1,103 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef CORE_STATE_BATCH_H
+#define CORE_STATE_BATCH_H
+
+#include <mars/core_state.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <memory>
+
+namespace mars
+{
+///
+/// \brief The CoreStateBatch class propagates an ensemble of core states in lockstep
+///
+/// All instances are propagated with the same IMU measurement, e.g. for Monte Carlo evaluations or multi-hypothesis
+/// initialization. The states are stored as structure of arrays, each state or covariance element is one contiguous
+/// row over all instances. The propagation mirrors CoreState::PropagateState and CoreState::PredictProcessCovariance
+/// but operates on full rows such that Eigen vectorizes over the instances with the available SIMD packets
+/// (SSE/AVX/AVX-512 or NEON, depending on the compile flags).
+///
+/// The covariance prediction follows CoreState::state_transition_type_. With the closed-form transition, the
+/// coefficients of the rotation angle are evaluated per instance and the blocks of F_d are vectorized as before.
+///
+/// \note The process noise Q_d is evaluated per instance. All other parts of the propagation are vectorized over the
+/// instances.
+///
+class CoreStateBatch
+{
+public:
+  using Rows = Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  static constexpr int kStateRows = 22;  ///< [p_wi(3) v_wi(3) q_wi(4, w x y z) b_w(3) b_a(3) w_m(3) a_m(3)]
+  static constexpr int kCovRows = CoreStateType::size_error_ * CoreStateType::size_error_;
+
+  ///
+  /// \brief CoreStateBatch
+  /// \param core_states Core state definition which provides noise, gravity and bias settings
+  /// \param size Number of instances
+  ///
+  CoreStateBatch(std::shared_ptr<CoreState> core_states, const int& size);
+
+  ///
+  /// \brief size
+  /// \return Number of instances
+  ///
+  int size() const;
+
+  ///
+  /// \brief set_core Sets state and covariance of one instance
+  ///
+  void set_core(const int& idx, const CoreType& core);
+
+  ///
+  /// \brief set_all Sets state and covariance of all instances
+  ///
+  void set_all(const CoreType& core);
+
+  ///
+  /// \brief get_core Returns state, covariance and the latest state transition matrix of one instance
+  ///
+  CoreType get_core(const int& idx) const;
+
+  ///
+  /// \brief Propagate Propagates state and covariance of all instances with the same system input
+  ///
+  /// Equivalent to calling CoreState::PredictProcessCovariance and CoreState::PropagateState for each instance.
+  ///
+  /// \param system_input IMU measurement
+  /// \param dt Propagation timespan
+  ///
+  void Propagate(const IMUMeasurementType& system_input, const double& dt);
+
+  ///
+  /// \brief PropagateState State propagation of all instances, see CoreState::PropagateState
+  ///
+  void PropagateState(const IMUMeasurementType& measurement, const double& dt);
+
+  ///
+  /// \brief PredictProcessCovariance Covariance prediction of all instances, see CoreState::PredictProcessCovariance
+  ///
+  void PredictProcessCovariance(const IMUMeasurementType& system_input, const double& dt);
+
+  Rows state_;             ///< kStateRows x size, row k holds state element k of all instances
+  Rows cov_;               ///< kCovRows x size, row (i * size_error_ + j) holds P(i, j) of all instances
+  Rows state_transition_;  ///< kCovRows x size, latest state transition matrices in the same layout as 'cov_'
+
+private:
+  std::shared_ptr<CoreState> core_states_;
+  int size_;
+};
+}  // namespace mars
+
+#endif  // CORE_STATE_BATCH_H
@@ -0,0 +1,725 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef CORE_STATE_KERNELS_H
+#define CORE_STATE_KERNELS_H
+
+#include <mars/type_definitions/core_state_type.h>
+#include <Eigen/Dense>
+#include <cmath>
+
+namespace mars
+{
+///
+/// \brief The CoreStateStorage class holds the core state elements with a configurable scalar type
+///
+/// This is the scalar templated equivalent of the CoreStateType and used by the CoreStateKernels.
+///
+template <typename Scalar>
+class CoreStateStorage
+{
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
+  using Quaternion = Eigen::Quaternion<Scalar>;
+
+  Vector3 p_wi_{ Vector3::Zero() };
+  Vector3 v_wi_{ Vector3::Zero() };
+  Quaternion q_wi_{ Quaternion::Identity() };
+  Vector3 b_w_{ Vector3::Zero() };
+  Vector3 b_a_{ Vector3::Zero() };
+
+  // Measurements for propagation
+  Vector3 w_m_{ Vector3::Zero() };
+  Vector3 a_m_{ Vector3::Zero() };
+
+  template <typename NewScalar>
+  CoreStateStorage<NewScalar> cast() const
+  {
+    CoreStateStorage<NewScalar> result;
+    result.p_wi_ = p_wi_.template cast<NewScalar>();
+    result.v_wi_ = v_wi_.template cast<NewScalar>();
+    result.q_wi_ = q_wi_.template cast<NewScalar>();
+    result.b_w_ = b_w_.template cast<NewScalar>();
+    result.b_a_ = b_a_.template cast<NewScalar>();
+    result.w_m_ = w_m_.template cast<NewScalar>();
+    result.a_m_ = a_m_.template cast<NewScalar>();
+    return result;
+  }
+
+  static CoreStateStorage FromCoreState(const CoreStateType& state)
+  {
+    CoreStateStorage result;
+    result.p_wi_ = state.p_wi_.cast<Scalar>();
+    result.v_wi_ = state.v_wi_.cast<Scalar>();
+    result.q_wi_ = state.q_wi_.cast<Scalar>();
+    result.b_w_ = state.b_w_.cast<Scalar>();
+    result.b_a_ = state.b_a_.cast<Scalar>();
+    result.w_m_ = state.w_m_.cast<Scalar>();
+    result.a_m_ = state.a_m_.cast<Scalar>();
+    return result;
+  }
+
+  CoreStateType ToCoreState() const
+  {
+    CoreStateType result;
+    result.p_wi_ = p_wi_.template cast<double>();
+    result.v_wi_ = v_wi_.template cast<double>();
+    result.q_wi_ = q_wi_.template cast<double>();
+    result.b_w_ = b_w_.template cast<double>();
+    result.b_a_ = b_a_.template cast<double>();
+    result.w_m_ = w_m_.template cast<double>();
+    result.a_m_ = a_m_.template cast<double>();
+    return result;
+  }
+};
+
+///
+/// \brief The CoreStateKernels class implements the core state propagation and the EKF update on a template scalar
+///
+/// States and covariances are stored with 'StorageScalar', all arithmetic is performed with 'AccScalar'. The kernels
+/// can be instantiated in the following configurations:
+/// - double: StorageScalar = AccScalar = double, used by the CoreState and Ekf classes
+/// - float: StorageScalar = AccScalar = float, halves the memory traffic and doubles the SIMD width
+/// - mixed: StorageScalar = float, AccScalar = double, float storage with double accumulation
+///
+/// Explicit instantiations for these three configurations are provided by the library (see core_state_calc_q.cpp).
+///
+/// \note Only the kernels are templated. BufferEntryType, CoreType, CoreState, CoreLogic and the sensor classes store
+/// and process double states, a filter can not be run in float or mixed mode. The reduced precision configurations are
+/// meant for code that calls the kernels directly, e.g. the precision study in mars_e2e_imu_prop_precision.
+///
+template <typename StorageScalar, typename AccScalar = StorageScalar>
+class CoreStateKernels
+{
+public:
+  static constexpr int size_error_ = CoreStateType::size_error_;
+
+  using State = CoreStateStorage<StorageScalar>;
+  using Vector3 = Eigen::Matrix<StorageScalar, 3, 1>;
+  using Matrix = Eigen::Matrix<StorageScalar, size_error_, size_error_>;
+  using MatrixX = Eigen::Matrix<StorageScalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+  using AccState = CoreStateStorage<AccScalar>;
+  using AccVector3 = Eigen::Matrix<AccScalar, 3, 1>;
+  using AccVector4 = Eigen::Matrix<AccScalar, 4, 1>;
+  using AccMatrix3 = Eigen::Matrix<AccScalar, 3, 3>;
+  using AccMatrix4 = Eigen::Matrix<AccScalar, 4, 4>;
+  using AccQuaternion = Eigen::Quaternion<AccScalar>;
+  using AccMatrix = Eigen::Matrix<AccScalar, size_error_, size_error_>;
+  using AccVector = Eigen::Matrix<AccScalar, size_error_, 1>;
+  using AccMatrixX = Eigen::Matrix<AccScalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+  ///
+  /// \brief PropagateState Performs the state propagation, see CoreState::PropagateState
+  /// \param prior_state Previous state
+  /// \param w_m Angular velocity measurement
+  /// \param a_m Linear acceleration measurement
+  /// \param dt Non-negative propagation time
+  /// \param g Gravity vector
+  /// \param fixed_gyro_bias Gyro bias is set to zero if true
+  /// \param fixed_acc_bias Accelerometer bias is set to zero if true
+  /// \return Propagated state
+  ///
+  static State PropagateState(const State& prior_state, const Vector3& w_m, const Vector3& a_m, const AccScalar& dt,
+                              const AccVector3& g, const bool& fixed_gyro_bias, const bool& fixed_acc_bias)
+  {
+    const AccState prior = prior_state.template cast<AccScalar>();
+
+    return PropagateStateAcc(prior, prior.q_wi_.toRotationMatrix(), w_m.template cast<AccScalar>(),
+                             a_m.template cast<AccScalar>(), dt, g, fixed_gyro_bias, fixed_acc_bias)
+        .template cast<StorageScalar>();
+  }
+
+  ///
+  /// \brief PropagateStateAcc State propagation in the accumulation type, see PropagateState
+  /// \param R_prior Rotation matrix of the prior orientation, shared with the state transition by the fused propagation
+  ///
+  static AccState PropagateStateAcc(const AccState& prior, const AccMatrix3& R_prior, const AccVector3& w_m,
+                                    const AccVector3& a_m, const AccScalar& dt, const AccVector3& g,
+                                    const bool& fixed_gyro_bias, const bool& fixed_acc_bias)
+  {
+    AccState current;
+
+    // Map System Input
+    current.w_m_ = w_m;
+    current.a_m_ = a_m;
+
+    // Zero propagation
+    if (!fixed_gyro_bias)
+    {
+      current.b_w_ = prior.b_w_;
+    }
+
+    if (!fixed_acc_bias)
+    {
+      current.b_a_ = prior.b_a_;
+    }
+
+    // First order Quaternion integration
+    const AccVector3 ew = current.w_m_ - current.b_w_;
+    const AccVector3 ew_old = prior.w_m_ - prior.b_w_;
+    const AccVector3 median_turn_rate = (ew_old + ew) / 2;
+
+    // Quaternion right side multiplication matrix from angular turn rates
+    const AccMatrix4 omega = OmegaMat(ew);
+    const AccMatrix4 omega_old = OmegaMat(ew_old);
+    const AccMatrix4 omega_med = OmegaMat(median_turn_rate);
+
+    // Matrix exponential approximation
+    // Reference: Solar - Quaternion Kinematics - Equation(224b)
+    const AccMatrix4 omega_n = omega_med * AccScalar(0.5) * dt;
+    const AccMatrix4 matexp = MatExp(omega_n, 4);
+
+    // first order Quaternion integration matrix
+    const AccMatrix4 quat_int = matexp + ((omega * omega_old - omega_old * omega) * (dt * dt)) / AccScalar(48.0);
+
+    const AccVector4 prior_quat_coeffs(prior.q_wi_.w(), prior.q_wi_.x(), prior.q_wi_.y(), prior.q_wi_.z());
+    const AccVector4 current_q_wi_coeffs = (quat_int * prior_quat_coeffs);
+
+    current.q_wi_ = AccQuaternion(current_q_wi_coeffs.x(), current_q_wi_coeffs.y(), current_q_wi_coeffs.z(),
+                                  current_q_wi_coeffs.w());
+    current.q_wi_.normalize();
+
+    // integrate linear acceleration
+    const AccVector3 ea = current.a_m_ - current.b_a_;
+    const AccVector3 ea_old = prior.a_m_ - prior.b_a_;
+
+    const AccVector3 dv = (current.q_wi_.toRotationMatrix() * ea + R_prior * ea_old) / 2;
+    current.v_wi_ = prior.v_wi_ + (dv - g) * dt;
+
+    // integrate velocity
+    current.p_wi_ = prior.p_wi_ + ((current.v_wi_ + prior.v_wi_) / 2) * dt;
+
+    return current;
+  }
+
+  ///
+  /// \brief GenerateFdSmallAngleApprox Generates the state-transition matrix, see CoreState::GenerateFdSmallAngleApprox
+  ///
+  static AccMatrix GenerateFdSmallAngleApprox(const AccQuaternion& q_wi, const AccVector3& a_est,
+                                              const AccVector3& w_est, const AccScalar& dt)
+  {
+    AccMatrix F_d;
+    FillFdSmallAngleApprox(q_wi.toRotationMatrix(), a_est, w_est, dt, &F_d);
+    return F_d;
+  }
+
+  ///
+  /// \brief FillFdSmallAngleApprox Writes the state-transition matrix for the rotation matrix R of q_wi
+  ///
+  /// The rows of the bias states (9 to 14) are identity rows, PredictCovariance relies on this structure.
+  ///
+  static void FillFdSmallAngleApprox(const AccMatrix3& R, const AccVector3& a_est, const AccVector3& w_est,
+                                     const AccScalar& dt, AccMatrix* F_d)
+  {
+    const AccMatrix3 I(AccMatrix3::Identity());
+
+    // Prepare dt powers (dt_p2 = dt power 2)
+    const AccScalar dt_p2 = dt * dt;
+    const AccScalar dt_p3 = dt_p2 * dt;
+    const AccScalar dt_p4 = dt_p2 * dt_p2;
+    const AccScalar dt_p5 = dt_p4 * dt;
+
+    const AccMatrix3 skew_w_est = Skew(w_est);
+    const AccMatrix3 skew_w_est_p2 = skew_w_est * skew_w_est;
+
+    // -R * [a_est]x is shared by the blocks A, B, C and D
+    AccMatrix3 R_skew_a_est;
+    R_skew_a_est.noalias() = -R * Skew(a_est);
+
+    // Map matrix components
+    F_d->setIdentity();
+    F_d->template block<3, 3>(0, 3) = I * dt;
+    F_d->template block<3, 3>(0, 6).noalias() =
+        R_skew_a_est * (I * ((dt_p2) / 2) - ((dt_p3) / 6) * skew_w_est + ((dt_p4) / 24) * skew_w_est_p2);
+    F_d->template block<3, 3>(0, 9).noalias() =
+        R_skew_a_est * (I * ((-dt_p3) / 6) + ((dt_p4) / 24) * skew_w_est - ((dt_p5) / 120) * skew_w_est_p2);
+    F_d->template block<3, 3>(0, 12) = -R * ((dt_p2) / 2);
+
+    F_d->template block<3, 3>(3, 6).noalias() =
+        R_skew_a_est * (I * dt - ((dt_p2) / 2) * skew_w_est + ((dt_p3) / 6) * skew_w_est_p2);
+    F_d->template block<3, 3>(3, 9) = -F_d->template block<3, 3>(0, 6);
+    F_d->template block<3, 3>(3, 12) = -R * dt;
+
+    F_d->template block<3, 3>(6, 6) = I - dt * skew_w_est + ((dt_p2) / 2) * skew_w_est_p2;
+    F_d->template block<3, 3>(6, 9) = -dt * I + ((dt_p2) / 2) * skew_w_est - (dt_p3) / 6 * skew_w_est_p2;
+  }
+
+  ///
+  /// \brief GenerateFdClosedForm Generates the state-transition matrix, see CoreState::GenerateFdClosedForm
+  ///
+  static AccMatrix GenerateFdClosedForm(const AccQuaternion& q_wi, const AccVector3& a_est, const AccVector3& w_est,
+                                        const AccScalar& dt)
+  {
+    AccMatrix F_d;
+    FillFdClosedForm(q_wi.toRotationMatrix(), a_est, w_est, dt, &F_d);
+    return F_d;
+  }
+
+  ///
+  /// \brief FillFdClosedForm Writes the closed-form state-transition matrix for the rotation matrix R of q_wi
+  ///
+  /// The blocks have the structure of FillFdSmallAngleApprox, but the series in [w_est]x are evaluated in closed form
+  /// with the rotation angle theta = |w_est| * dt (Sola - Quaternion Kinematics, Section B.3). The bias rows (9 to 14)
+  /// are identity rows as well.
+  ///
+  static void FillFdClosedForm(const AccMatrix3& R, const AccVector3& a_est, const AccVector3& w_est,
+                               const AccScalar& dt, AccMatrix* F_d)
+  {
+    const AccMatrix3 I(AccMatrix3::Identity());
+
+    const AccScalar dt_p2 = dt * dt;
+    const AccScalar dt_p3 = dt_p2 * dt;
+    const AccScalar dt_p4 = dt_p2 * dt_p2;
+    const AccScalar dt_p5 = dt_p4 * dt;
+
+    AccScalar c[5];
+    ClosedFormCoefficients(w_est.norm() * dt, c);
+
+    const AccMatrix3 skew_w_est = Skew(w_est);
+    const AccMatrix3 skew_w_est_p2 = skew_w_est * skew_w_est;
+
+    // Integrals of the attitude error transition exp(-[w_est]x t), sigma_1 to sigma_3 are integrated once to trice
+    const AccMatrix3 theta_theta = I - (c[0] * dt) * skew_w_est + (c[1] * dt_p2) * skew_w_est_p2;
+    const AccMatrix3 sigma_1 = I * dt - (c[1] * dt_p2) * skew_w_est + (c[2] * dt_p3) * skew_w_est_p2;
+    const AccMatrix3 sigma_2 = I * (dt_p2 / 2) - (c[2] * dt_p3) * skew_w_est + (c[3] * dt_p4) * skew_w_est_p2;
+    const AccMatrix3 sigma_3 = I * (dt_p3 / 6) - (c[3] * dt_p4) * skew_w_est + (c[4] * dt_p5) * skew_w_est_p2;
+
+    AccMatrix3 R_skew_a_est;
+    R_skew_a_est.noalias() = -R * Skew(a_est);
+
+    F_d->setIdentity();
+    F_d->template block<3, 3>(0, 3) = I * dt;
+    F_d->template block<3, 3>(0, 6).noalias() = R_skew_a_est * sigma_2;
+    F_d->template block<3, 3>(0, 9).noalias() = -R_skew_a_est * sigma_3;
+    F_d->template block<3, 3>(0, 12) = -R * (dt_p2 / 2);
+
+    F_d->template block<3, 3>(3, 6).noalias() = R_skew_a_est * sigma_1;
+    F_d->template block<3, 3>(3, 9) = -F_d->template block<3, 3>(0, 6);
+    F_d->template block<3, 3>(3, 12) = -R * dt;
+
+    F_d->template block<3, 3>(6, 6) = theta_theta;
+    F_d->template block<3, 3>(6, 9) = -sigma_1;
+  }
+
+  ///
+  /// \brief ClosedFormCoefficients Coefficients of the closed-form transition for the rotation angle 'theta'
+  ///
+  /// c[0] = sin(theta) / theta, c[1] = (1 - cos(theta)) / theta^2, c[2] = (theta - sin(theta)) / theta^3,
+  /// c[3] = (theta^2 / 2 + cos(theta) - 1) / theta^4, c[4] = (theta^3 / 6 - theta + sin(theta)) / theta^5
+  ///
+  /// The closed forms cancel for small angles, their Taylor series are used below 'theta = 0.25'.
+  ///
+  static void ClosedFormCoefficients(const AccScalar& theta, AccScalar* c)
+  {
+    const AccScalar t2 = theta * theta;
+
+    if (theta < AccScalar(0.25))
+    {
+      const AccScalar t4 = t2 * t2;
+      const AccScalar t6 = t4 * t2;
+      const AccScalar t8 = t4 * t4;
+      c[0] = AccScalar(1) - t2 / 6 + t4 / 120 - t6 / 5040 + t8 / 362880;
+      c[1] = AccScalar(1) / 2 - t2 / 24 + t4 / 720 - t6 / 40320 + t8 / 3628800;
+      c[2] = AccScalar(1) / 6 - t2 / 120 + t4 / 5040 - t6 / 362880 + t8 / 39916800;
+      c[3] = AccScalar(1) / 24 - t2 / 720 + t4 / 40320 - t6 / 3628800 + t8 / 479001600;
+      c[4] = AccScalar(1) / 120 - t2 / 5040 + t4 / 362880 - t6 / 39916800 + t8 / 6227020800;
+      return;
+    }
+
+    const AccScalar sin_theta = std::sin(theta);
+    const AccScalar cos_theta = std::cos(theta);
+    const AccScalar t3 = t2 * theta;
+
+    c[0] = sin_theta / theta;
+    c[1] = (AccScalar(1) - cos_theta) / t2;
+    c[2] = (theta - sin_theta) / t3;
+    c[3] = (t2 / 2 + cos_theta - AccScalar(1)) / (t2 * t2);
+    c[4] = (t3 / 6 - theta + sin_theta) / (t3 * t2);
+  }
+
+  ///
+  /// \brief GenerateFdTaylor Generates the state-transition matrix, see CoreState::GenerateFdTaylor
+  ///
+  static AccMatrix GenerateFdTaylor(const AccQuaternion& q_wi, const AccVector3& a_est, const AccVector3& w_est,
+                                    const AccScalar& dt, const int& order)
+  {
+    const AccMatrix3 R = q_wi.toRotationMatrix();
+
+    // Continuous error state system matrix
+    AccMatrix A_dt(AccMatrix::Zero());
+    A_dt.template block<3, 3>(0, 3) = AccMatrix3::Identity() * dt;
+    A_dt.template block<3, 3>(3, 6) = -R * Skew(a_est) * dt;
+    A_dt.template block<3, 3>(3, 12) = -R * dt;
+    A_dt.template block<3, 3>(6, 6) = -Skew(w_est) * dt;
+    A_dt.template block<3, 3>(6, 9) = -AccMatrix3::Identity() * dt;
+
+    AccMatrix F_d(AccMatrix::Identity());
+    AccMatrix term(AccMatrix::Identity());
+
+    for (int k = 1; k <= order; k++)
+    {
+      term = term * A_dt / AccScalar(k);
+      F_d += term;
+    }
+
+    return F_d;
+  }
+
+  ///
+  /// \brief CalcQClosedForm Generates the discrete process noise for the closed-form transition
+  ///
+  /// Q_d = int_0^dt F_d(t) * G * Q_c * G^T * F_d(t)^T dt with the closed-form F_d(t), the noise input G (-R for n_a,
+  /// -I for n_w and I for the bias random walks) and the noise densities Q_c. The integral is evaluated with a 4-point
+  /// Gauss-Legendre quadrature, which is exact for the polynomial terms of the small angle noise model.
+  ///
+  static AccMatrix CalcQClosedForm(const AccScalar& dt, const AccQuaternion& q_wi, const AccVector3& a_m,
+                                   const AccVector3& n_a, const AccVector3& b_a, const AccVector3& n_ba,
+                                   const AccVector3& w_m, const AccVector3& n_w, const AccVector3& b_w,
+                                   const AccVector3& n_bw)
+  {
+    // Nodes and weights on [0, 1]
+    static const AccScalar nodes[4] = { AccScalar(0.0694318442029737), AccScalar(0.3300094782075719),
+                                        AccScalar(0.6699905217924281), AccScalar(0.9305681557970263) };
+    static const AccScalar weights[4] = { AccScalar(0.1739274225687269), AccScalar(0.3260725774312731),
+                                          AccScalar(0.3260725774312731), AccScalar(0.1739274225687269) };
+
+    const AccMatrix3 R = q_wi.toRotationMatrix();
+    const AccVector3 a_est = a_m - b_a;
+    const AccVector3 w_est = w_m - b_w;
+
+    AccMatrix G_Qc_GT(AccMatrix::Zero());
+    G_Qc_GT.template block<3, 3>(3, 3).noalias() = R * n_a.cwiseProduct(n_a).asDiagonal() * R.transpose();
+    G_Qc_GT.template block<3, 3>(6, 6) = n_w.cwiseProduct(n_w).asDiagonal();
+    G_Qc_GT.template block<3, 3>(9, 9) = n_bw.cwiseProduct(n_bw).asDiagonal();
+    G_Qc_GT.template block<3, 3>(12, 12) = n_ba.cwiseProduct(n_ba).asDiagonal();
+
+    AccMatrix Q_d(AccMatrix::Zero());
+    AccMatrix F_t;
+
+    for (int k = 0; k < 4; k++)
+    {
+      FillFdClosedForm(R, a_est, w_est, nodes[k] * dt, &F_t);
+      Q_d.noalias() += (weights[k] * dt) * (F_t * G_Qc_GT * F_t.transpose());
+    }
+
+    return (Q_d + Q_d.transpose()) / 2;
+  }
+
+  ///
+  /// \brief PredictCovariance Returns the symmetric covariance F_d * P * F_d^T + Q_d
+  ///
+  /// F_d differs from the identity only in the first 9 rows (see FillFdSmallAngleApprox and FillFdClosedForm). Both
+  /// products are therefore restricted to these rows and columns, which removes 40% of the multiplications of the
+  /// dense products.
+  ///
+  static AccMatrix PredictCovariance(const AccMatrix& F_d, const AccMatrix& P, const AccMatrix& Q_d)
+  {
+    constexpr int kRows = 9;
+
+    AccMatrix FP = P;
+    FP.template topRows<kRows>().noalias() = F_d.template topRows<kRows>() * P;
+
+    AccMatrix P_predicted = FP;
+    P_predicted.template leftCols<kRows>().noalias() = FP * F_d.template topRows<kRows>().transpose();
+    P_predicted += Q_d;
+
+    return (P_predicted + P_predicted.transpose()) / 2;
+  }
+
+  ///
+  /// \brief CalcQSmallAngleApprox Generates the discrete process noise, see CoreState::CalcQSmallAngleApprox
+  ///
+  /// \note Defined in core_state_calc_q.cpp
+  ///
+  static AccMatrix CalcQSmallAngleApprox(const AccScalar& dt, const AccQuaternion& q_wi, const AccVector3& a_m,
+                                         const AccVector3& n_a, const AccVector3& b_a, const AccVector3& n_ba,
+                                         const AccVector3& w_m, const AccVector3& n_w, const AccVector3& b_w,
+                                         const AccVector3& n_bw);
+
+  ///
+  /// \brief PredictProcessCovariance Predicts the core state covariance, see CoreState::PredictProcessCovariance
+  /// \param P Prior core state covariance
+  /// \param prior_state Prior core state
+  /// \param w_m Angular velocity measurement
+  /// \param a_m Linear acceleration measurement
+  /// \param dt Propagation time
+  /// \param n_a, n_ba, n_w, n_bw Noise parameter of the propagation sensor
+  /// \param transition Type of the state transition and process noise
+  /// \param state_transition Optional output for the state transition matrix
+  /// \return Predicted and symmetric core state covariance
+  ///
+  static Matrix PredictProcessCovariance(const Matrix& P, const State& prior_state, const Vector3& w_m,
+                                         const Vector3& a_m, const AccScalar& dt, const AccVector3& n_a,
+                                         const AccVector3& n_ba, const AccVector3& n_w, const AccVector3& n_bw,
+                                         StateTransitionType transition = StateTransitionType::small_angle_approx,
+                                         Matrix* state_transition = nullptr)
+  {
+    const AccQuaternion q_wi = prior_state.q_wi_.template cast<AccScalar>();
+    const AccVector3 b_a = prior_state.b_a_.template cast<AccScalar>();
+    const AccVector3 b_w = prior_state.b_w_.template cast<AccScalar>();
+
+    const AccVector3 w_m_acc = w_m.template cast<AccScalar>();
+    const AccVector3 a_m_acc = a_m.template cast<AccScalar>();
+
+    const AccVector3 w_est = w_m_acc - b_w;
+    const AccVector3 a_est = a_m_acc - b_a;
+
+    // State-Transition and Process-Noise
+    AccMatrix F_d;
+    AccMatrix Q_d;
+    if (transition == StateTransitionType::closed_form)
+    {
+      F_d = GenerateFdClosedForm(q_wi, a_est, w_est, dt);
+      Q_d = CalcQClosedForm(dt, q_wi, a_m_acc, n_a, b_a, n_ba, w_m_acc, n_w, b_w, n_bw);
+    }
+    else
+    {
+      F_d = GenerateFdSmallAngleApprox(q_wi, a_est, w_est, dt);
+      Q_d = CalcQSmallAngleApprox(dt, q_wi, a_m_acc, n_a, b_a, n_ba, w_m_acc, n_w, b_w, n_bw);
+    }
+
+    if (state_transition != nullptr)
+    {
+      *state_transition = F_d.template cast<StorageScalar>();
+    }
+
+    return PredictCovariance(F_d, P.template cast<AccScalar>(), Q_d).template cast<StorageScalar>();
+  }
+
+  ///
+  /// \brief PropagateStateAndCovariance Fused state propagation and covariance prediction
+  ///
+  /// Equivalent to PropagateState and PredictProcessCovariance, but the prior rotation matrix, the bias corrected
+  /// inputs and the state transition are computed once and shared by the state integration, F_d and P.
+  ///
+  /// \param transition Type of the state transition and process noise
+  /// \param P_predicted Output for the predicted and symmetric core state covariance
+  /// \param state_transition Optional output for the state transition matrix
+  /// \return Propagated state
+  ///
+  static State PropagateStateAndCovariance(const State& prior_state, const Matrix& P, const Vector3& w_m,
+                                           const Vector3& a_m, const AccScalar& dt, const AccVector3& g,
+                                           const AccVector3& n_a, const AccVector3& n_ba, const AccVector3& n_w,
+                                           const AccVector3& n_bw, const bool& fixed_gyro_bias,
+                                           const bool& fixed_acc_bias, StateTransitionType transition,
+                                           Matrix* P_predicted, Matrix* state_transition = nullptr)
+  {
+    const AccState prior = prior_state.template cast<AccScalar>();
+    const AccVector3 w_m_acc = w_m.template cast<AccScalar>();
+    const AccVector3 a_m_acc = a_m.template cast<AccScalar>();
+    const AccMatrix3 R_prior = prior.q_wi_.toRotationMatrix();
+
+    const AccState current =
+        PropagateStateAcc(prior, R_prior, w_m_acc, a_m_acc, dt, g, fixed_gyro_bias, fixed_acc_bias);
+
+    AccMatrix F_d;
+    AccMatrix Q_d;
+    if (transition == StateTransitionType::closed_form)
+    {
+      FillFdClosedForm(R_prior, a_m_acc - prior.b_a_, w_m_acc - prior.b_w_, dt, &F_d);
+      Q_d = CalcQClosedForm(dt, prior.q_wi_, a_m_acc, n_a, prior.b_a_, n_ba, w_m_acc, n_w, prior.b_w_, n_bw);
+    }
+    else
+    {
+      FillFdSmallAngleApprox(R_prior, a_m_acc - prior.b_a_, w_m_acc - prior.b_w_, dt, &F_d);
+      Q_d = CalcQSmallAngleApprox(dt, prior.q_wi_, a_m_acc, n_a, prior.b_a_, n_ba, w_m_acc, n_w, prior.b_w_, n_bw);
+    }
+
+    *P_predicted = PredictCovariance(F_d, P.template cast<AccScalar>(), Q_d).template cast<StorageScalar>();
+
+    if (state_transition != nullptr)
+    {
+      *state_transition = F_d.template cast<StorageScalar>();
+    }
+
+    return current.template cast<StorageScalar>();
+  }
+
+  ///
+  /// \brief The UpdateWorkspace struct holds the intermediate matrices of the EKF update kernels
+  ///
+  /// The matrices keep their memory, the kernels do not allocate once the workspace was used for an update of the
+  /// same size.
+  ///
+  struct UpdateWorkspace
+  {
+    AccMatrixX HP_;                       ///< H * P
+    AccMatrixX S_raw_;                    ///< Innovation before the symmetrization
+    AccMatrixX S_inv_;                    ///< Inverse of the innovation
+    AccMatrixX identity_;                 ///< Right hand side of the inversion
+    AccMatrixX PHt_;                      ///< P * H^T
+    AccMatrixX KH_;                       ///< I - K * H
+    AccMatrixX KHP_;                      ///< (I - K * H) * P
+    AccMatrixX KR_;                       ///< K * R
+    Eigen::PartialPivLU<AccMatrixX> lu_;  ///< Decomposition of the innovation
+  };
+
+  ///
+  /// \brief CalculateCorrection EKF state correction, see Ekf::CalculateCorrection
+  /// \param H Jacobian
+  /// \param R Measurement noise
+  /// \param res Residual
+  /// \param P State covariance
+  /// \param K Output for the Kalman gain
+  /// \param S Output for the innovation
+  /// \return State correction
+  ///
+  static AccMatrixX CalculateCorrection(const AccMatrixX& H, const AccMatrixX& R, const AccMatrixX& res,
+                                        const AccMatrixX& P, AccMatrixX* K, AccMatrixX* S)
+  {
+    UpdateWorkspace workspace;
+    AccMatrixX correction;
+    CalculateCorrection(H, R, res, P, &workspace, K, S, &correction);
+    return correction;
+  }
+
+  ///
+  /// \brief CalculateCorrection EKF state correction with the intermediate results in 'workspace'
+  /// \param correction Output for the state correction
+  ///
+  static void CalculateCorrection(const AccMatrixX& H, const AccMatrixX& R, const AccMatrixX& res,
+                                  const AccMatrixX& P, UpdateWorkspace* workspace, AccMatrixX* K, AccMatrixX* S,
+                                  AccMatrixX* correction)
+  {
+    // Calculate innovation
+    workspace->HP_.noalias() = H * P;
+    workspace->S_raw_.noalias() = workspace->HP_ * H.transpose();
+    workspace->S_raw_ += R;
+    *S = (workspace->S_raw_ + workspace->S_raw_.transpose()) / 2;
+
+    // Calculate Klamen Gain
+    workspace->lu_.compute(*S);
+    // Solving for the identity equals lu_.inverse(), without the temporary of the inverse expression
+    workspace->identity_.setIdentity(S->rows(), S->cols());
+    workspace->S_inv_ = workspace->lu_.solve(workspace->identity_);
+    workspace->PHt_.noalias() = P * H.transpose();
+    K->noalias() = workspace->PHt_ * workspace->S_inv_;
+
+    // Calculate Correction
+    correction->noalias() = *K * res;
+  }
+
+  ///
+  /// \brief CalculateCovUpdate Joseph form covariance update, see Ekf::CalculateCovUpdate
+  ///
+  static AccMatrixX CalculateCovUpdate(const AccMatrixX& H, const AccMatrixX& R, const AccMatrixX& P,
+                                       const AccMatrixX& K)
+  {
+    UpdateWorkspace workspace;
+    AccMatrixX cov;
+    CalculateCovUpdate(H, R, P, K, &workspace, &cov);
+    return cov;
+  }
+
+  ///
+  /// \brief CalculateCovUpdate Joseph form covariance update with the intermediate results in 'workspace'
+  /// \param cov Output for the updated covariance
+  ///
+  static void CalculateCovUpdate(const AccMatrixX& H, const AccMatrixX& R, const AccMatrixX& P, const AccMatrixX& K,
+                                 UpdateWorkspace* workspace, AccMatrixX* cov)
+  {
+    const int64_t state_size = H.cols();
+
+    workspace->KH_.setIdentity(state_size, state_size);
+    workspace->KH_.noalias() -= K * H;
+    workspace->KHP_.noalias() = workspace->KH_ * P;
+    cov->noalias() = workspace->KHP_ * workspace->KH_.transpose();
+    workspace->KR_.noalias() = K * R;
+    cov->noalias() += workspace->KR_ * K.transpose();
+  }
+
+  ///
+  /// \brief ApplyCorrection Applies an error state correction, see CoreStateType::ApplyCorrection
+  ///
+  static State ApplyCorrection(const State& state_prior, const AccVector& correction)
+  {
+    const AccState prior = state_prior.template cast<AccScalar>();
+    AccState corrected;
+
+    corrected.p_wi_ = prior.p_wi_ + correction.template segment<3>(0);
+    corrected.v_wi_ = prior.v_wi_ + correction.template segment<3>(3);
+    corrected.q_wi_ = (prior.q_wi_ * QuatFromSmallAngle(correction.template segment<3>(6))).normalized();
+    corrected.b_w_ = prior.b_w_ + correction.template segment<3>(9);
+    corrected.b_a_ = prior.b_a_ + correction.template segment<3>(12);
+
+    // Pass through IMU measurements
+    corrected.a_m_ = prior.a_m_;
+    corrected.w_m_ = prior.w_m_;
+
+    return corrected.template cast<StorageScalar>();
+  }
+
+  static AccMatrix3 Skew(const AccVector3& v)
+  {
+    AccMatrix3 res;
+    res << AccScalar(0), -v(2), v(1), v(2), AccScalar(0), -v(0), -v(1), v(0), AccScalar(0);
+    return res;
+  }
+
+  static AccMatrix4 OmegaMat(const AccVector3& v)
+  {
+    AccMatrix4 res;
+    res.setZero();
+
+    res.template block<1, 3>(0, 1) = -v.transpose();
+    res.template block<3, 1>(1, 0) = v;
+    res.template block<3, 3>(1, 1) = -Skew(v);
+
+    return res;
+  }
+
+  static AccMatrix4 MatExp(const AccMatrix4& A, const int& order)
+  {
+    AccMatrix4 matexp(AccMatrix4::Identity());  // initial condition with k=0
+
+    int div = 1;
+    AccMatrix4 a_loop = A;
+
+    for (int k = 1; k <= order; k++)
+    {
+      div = div * k;  // factorial(k)
+      matexp = matexp + a_loop / AccScalar(div);
+      a_loop = a_loop * A;  // adding one exponent each iteration
+    }
+
+    return matexp;
+  }
+
+  static AccQuaternion QuatFromSmallAngle(const AccVector3& d_theta_vec)
+  {
+    const AccScalar d_theta_squared = d_theta_vec.squaredNorm();
+
+    if (d_theta_squared / AccScalar(4.0) < AccScalar(1.0))
+    {
+      return AccQuaternion(std::sqrt(AccScalar(1) - d_theta_squared / AccScalar(4.0)), d_theta_vec[0] * AccScalar(0.5),
+                           d_theta_vec[1] * AccScalar(0.5), d_theta_vec[2] * AccScalar(0.5));
+    }
+
+    const AccScalar w = AccScalar(1.0) / std::sqrt(AccScalar(1) + d_theta_squared / AccScalar(4.0));
+    const AccScalar f = w * AccScalar(0.5);
+    return AccQuaternion(w, d_theta_vec[0] * f, d_theta_vec[1] * f, d_theta_vec[2] * f);
+  }
+};
+
+using CoreStateKernelsDouble = CoreStateKernels<double, double>;
+
+// Reduced precision kernels, not used by CoreState or CoreLogic
+using CoreStateKernelsFloat = CoreStateKernels<float, float>;
+using CoreStateKernelsMixed = CoreStateKernels<float, double>;
+
+extern template class CoreStateKernels<double, double>;
+extern template class CoreStateKernels<float, float>;
+extern template class CoreStateKernels<float, double>;
+}  // namespace mars
+
+#endif  // CORE_STATE_KERNELS_H
@@ -0,0 +1,222 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include "dataset_loader.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <utility>
+
+namespace mars
+{
+DatasetMerger::DatasetMerger(const std::vector<const std::vector<BufferEntryType>*>& streams, const Time& t_begin,
+                             const Time& t_end)
+{
+  const auto is_before = [](const BufferEntryType& entry, const Time& t) { return entry.timestamp_ < t; };
+  const auto is_after = [](const Time& t, const BufferEntryType& entry) { return t < entry.timestamp_; };
+
+  for (size_t k = 0; k < streams.size(); k++)
+  {
+    const std::vector<BufferEntryType>& stream = *streams[k];
+    const size_t begin = std::lower_bound(stream.begin(), stream.end(), t_begin, is_before) - stream.begin();
+    const size_t end = std::upper_bound(stream.begin(), stream.end(), t_end, is_after) - stream.begin();
+
+    if (begin < end)
+    {
+      heap_.push({ &stream, begin, end, k });
+      num_remaining_ += end - begin;
+    }
+  }
+}
+
+bool DatasetMerger::Next(BufferEntryType* entry)
+{
+  if (heap_.empty())
+  {
+    return false;
+  }
+
+  Cursor cursor = heap_.top();
+  heap_.pop();
+  *entry = (*cursor.stream)[cursor.pos];
+  num_remaining_--;
+
+  if (++cursor.pos < cursor.end)
+  {
+    heap_.push(cursor);
+  }
+
+  return true;
+}
+
+size_t DatasetMerger::get_num_remaining() const
+{
+  return num_remaining_;
+}
+
+DatasetLoader::DatasetLoader(const int& num_threads)
+  : num_threads_(num_threads > 0 ? num_threads : std::max(1, static_cast<int>(std::thread::hardware_concurrency())))
+{
+}
+
+int DatasetLoader::AddStream(const std::string& name, StreamReader reader)
+{
+  readers_.push_back(std::move(reader));
+  streams_.emplace_back();
+
+  DatasetStreamInfo info;
+  info.name_ = name;
+  stream_info_.push_back(info);
+
+  return static_cast<int>(readers_.size()) - 1;
+}
+
+bool DatasetLoader::Load()
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  // Streams are handed out in the order they were added, each worker takes the next stream which is not loaded
+  std::atomic<size_t> next_stream{ 0 };
+  const auto worker = [this, &next_stream]() {
+    for (size_t k = next_stream++; k < readers_.size(); k = next_stream++)
+    {
+      const auto stream_start = std::chrono::steady_clock::now();
+      std::vector<BufferEntryType>& stream = streams_[k];
+      stream.clear();
+
+      // A failure is reported after all workers were joined, the process is not terminated from a worker
+      DatasetStreamInfo& info = stream_info_[k];
+      info.error_.clear();
+      try
+      {
+        readers_[k](&stream);
+      }
+      catch (const std::exception& e)
+      {
+        info.error_ = e.what();
+        stream.clear();
+      }
+
+      info.was_sorted_ = std::is_sorted(stream.begin(), stream.end());
+      if (!info.was_sorted_)
+      {
+        std::stable_sort(stream.begin(), stream.end());
+      }
+
+      info.num_entries_ = stream.size();
+      info.load_time_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - stream_start).count();
+    }
+  };
+
+  const int num_workers = std::min(num_threads_, static_cast<int>(readers_.size()));
+  std::vector<std::thread> workers;
+  for (int k = 1; k < num_workers; k++)
+  {
+    workers.emplace_back(worker);
+  }
+  worker();
+
+  for (auto& k : workers)
+  {
+    k.join();
+  }
+
+  load_time_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  bool success = true;
+  for (const auto& k : stream_info_)
+  {
+    if (!k.error_.empty())
+    {
+      std::cout << "Warning: [DatasetLoader] Stream " << k.name_ << " could not be loaded: " << k.error_ << std::endl;
+      success = false;
+    }
+  }
+
+  return success;
+}
+
+double DatasetLoader::get_load_time() const
+{
+  return load_time_;
+}
+
+DatasetMerger DatasetLoader::get_merger(const Time& t_begin, const Time& t_end) const
+{
+  std::vector<const std::vector<BufferEntryType>*> streams;
+  for (const auto& k : streams_)
+  {
+    streams.push_back(&k);
+  }
+
+  return DatasetMerger(streams, t_begin, t_end);
+}
+
+Time DatasetLoader::get_start_time() const
+{
+  bool found = false;
+  Time start_time(0);
+
+  for (const auto& k : streams_)
+  {
+    if (!k.empty() && (!found || k.front().timestamp_ < start_time))
+    {
+      start_time = k.front().timestamp_;
+      found = true;
+    }
+  }
+
+  return start_time;
+}
+
+const std::vector<BufferEntryType>& DatasetLoader::get_stream(const int& stream_idx) const
+{
+  return streams_.at(stream_idx);
+}
+
+const std::vector<DatasetStreamInfo>& DatasetLoader::get_stream_info() const
+{
+  return stream_info_;
+}
+
+size_t DatasetLoader::get_num_entries() const
+{
+  size_t num_entries = 0;
+  for (const auto& k : streams_)
+  {
+    num_entries += k.size();
+  }
+  return num_entries;
+}
+
+void DatasetLoader::PrintInfo() const
+{
+  // The format of std::cout is changed for the table and restored afterwards
+  const std::ios::fmtflags flags = std::cout.flags();
+  const std::streamsize precision = std::cout.precision();
+
+  std::cout << "Dataset loaded in " << std::fixed << std::setprecision(3) << load_time_ << "s with " << num_threads_
+            << " threads" << std::endl;
+
+  for (const auto& k : stream_info_)
+  {
+    std::cout << " - " << std::left << std::setw(10) << k.name_ << std::right << std::setw(10) << k.num_entries_
+              << " entries " << std::setw(8) << k.load_time_ << "s" << (k.was_sorted_ ? "" : " (sorted)")
+              << (k.error_.empty() ? "" : " (failed: " + k.error_ + ")") << std::endl;
+  }
+
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+}
+}  // namespace mars
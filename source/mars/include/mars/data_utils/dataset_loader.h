@@ -0,0 +1,173 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef DATASET_LOADER_H
+#define DATASET_LOADER_H
+
+#include <mars/time.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief StreamReader Reads the measurements of one sensor, e.g. a wrapper of ReadImuData
+///
+/// A reader reports a failure by throwing an exception derived from std::exception, e.g. ReadCsv for a missing file.
+///
+using StreamReader = std::function<void(std::vector<BufferEntryType>* data_out)>;
+
+///
+/// \brief Load result of one sensor stream
+///
+struct DatasetStreamInfo
+{
+  std::string name_;         ///< Name given with AddStream
+  size_t num_entries_{ 0 };  ///< Number of measurements
+  double load_time_{ 0 };    ///< Duration of reading and sorting the stream [s]
+  bool was_sorted_{ true };  ///< False if the file was not in time order and the stream was sorted
+  std::string error_;        ///< Reason of a failed read, empty if the stream was loaded
+};
+
+///
+/// \brief The DatasetMerger class iterates over sorted sensor streams in time order without copying them
+///
+/// The streams are merged lazily with a min-heap over the next entry of each stream, a step costs O(log k) for k
+/// streams. Entries with equal timestamps are returned in stream order. The streams must outlive the merger.
+///
+class DatasetMerger
+{
+public:
+  ///
+  /// \brief DatasetMerger
+  /// \param streams Streams sorted by timestamp
+  /// \param t_begin Entries before this time are skipped
+  /// \param t_end Entries after this time are skipped
+  ///
+  DatasetMerger(const std::vector<const std::vector<BufferEntryType>*>& streams,
+                const Time& t_begin = -std::numeric_limits<double>::max(),
+                const Time& t_end = std::numeric_limits<double>::max());
+
+  ///
+  /// \brief Next Returns the next entry in time order
+  /// \param entry Output for the entry
+  /// \return false if all entries have been returned
+  ///
+  bool Next(BufferEntryType* entry);
+
+  ///
+  /// \brief get_num_remaining
+  /// \return Number of entries which have not been returned yet
+  ///
+  size_t get_num_remaining() const;
+
+private:
+  struct Cursor
+  {
+    const std::vector<BufferEntryType>* stream;
+    size_t pos;
+    size_t end;
+    size_t stream_idx;
+
+    bool operator>(const Cursor& rhs) const
+    {
+      const Time& t = (*stream)[pos].timestamp_;
+      const Time& t_rhs = (*rhs.stream)[rhs.pos].timestamp_;
+      return t == t_rhs ? stream_idx > rhs.stream_idx : t > t_rhs;
+    }
+  };
+
+  std::priority_queue<Cursor, std::vector<Cursor>, std::greater<Cursor>> heap_;
+  size_t num_remaining_{ 0 };
+};
+
+///
+/// \brief The DatasetLoader class reads the measurement files of a dataset in parallel
+///
+/// Each sensor file is read by a StreamReader on a worker thread and kept as its own stream. Sensor files are usually
+/// in time order, a stream is only sorted if it is not. The streams are combined with DatasetMerger, which replaces
+/// the concatenation and sort of all measurements.
+///
+class DatasetLoader
+{
+public:
+  ///
+  /// \brief DatasetLoader
+  /// \param num_threads Number of worker threads, 0 for the number of hardware threads
+  ///
+  DatasetLoader(const int& num_threads = 0);
+
+  ///
+  /// \brief AddStream Adds a sensor stream, streams which are added first win ties in the merge
+  /// \param name Name for the load report
+  /// \param reader Function reading the measurements of the stream
+  /// \return Index of the stream
+  ///
+  int AddStream(const std::string& name, StreamReader reader);
+
+  ///
+  /// \brief Load Reads all streams which have been added, the call blocks until all streams are loaded
+  ///
+  /// A failed reader does not stop the other readers. Its stream is left empty and the reason is reported in
+  /// DatasetStreamInfo::error_.
+  ///
+  /// \return true if all streams were loaded, false if at least one reader failed
+  ///
+  bool Load();
+
+  ///
+  /// \brief get_load_time
+  /// \return Duration of the last Load [s]
+  ///
+  double get_load_time() const;
+
+  ///
+  /// \brief get_merger Merges the loaded streams in time order
+  /// \param t_begin Entries before this time are skipped
+  /// \param t_end Entries after this time are skipped
+  ///
+  DatasetMerger get_merger(const Time& t_begin = -std::numeric_limits<double>::max(),
+                           const Time& t_end = std::numeric_limits<double>::max()) const;
+
+  ///
+  /// \brief get_start_time
+  /// \return Earliest timestamp of all streams, 0 if all streams are empty
+  ///
+  Time get_start_time() const;
+
+  const std::vector<BufferEntryType>& get_stream(const int& stream_idx) const;
+  const std::vector<DatasetStreamInfo>& get_stream_info() const;
+
+  ///
+  /// \brief get_num_entries
+  /// \return Number of measurements of all streams
+  ///
+  size_t get_num_entries() const;
+
+  ///
+  /// \brief PrintInfo Prints the load time and the number of measurements per stream
+  ///
+  void PrintInfo() const;
+
+private:
+  int num_threads_;
+  std::vector<StreamReader> readers_;
+  std::vector<std::vector<BufferEntryType>> streams_;
+  std::vector<DatasetStreamInfo> stream_info_;
+  double load_time_{ 0 };  ///< Duration of the last Load [s]
+};
+}  // namespace mars
+
+#endif  // DATASET_LOADER_H
@@ -0,0 +1,344 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef JOURNAL_CODECS_H
+#define JOURNAL_CODECS_H
+
+#include <mars/journal_replayer.h>
+#include <mars/measurement_journal.h>
+#include <mars/sensors/attitude/attitude_measurement_type.h>
+#include <mars/sensors/bodyvel/bodyvel_measurement_type.h>
+#include <mars/sensors/empty/empty_measurement_type.h>
+#include <mars/sensors/gps/gps_measurement_type.h>
+#include <mars/sensors/gps_w_vel/gps_w_vel_measurement_type.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/mag/mag_measurement_type.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/position/position_measurement_type.h>
+#include <mars/sensors/pressure/pressure_measurement_type.h>
+#include <mars/sensors/velocity/velocity_measurement_type.h>
+#include <mars/sensors/vision/vision_measurement_type.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <memory>
+
+namespace mars
+{
+///
+/// \brief The JournalCodec struct defines the journal payload of a measurement type
+///
+/// Each specialization provides the number of payload values 'kSize', 'Pack' to flatten the measurement and 'Unpack'
+/// to restore it. The optional measurement noise of BaseMeas is handled by MakeJournalEncoder and MakeJournalDecoder.
+///
+template <typename MeasType>
+struct JournalCodec;
+
+template <>
+struct JournalCodec<IMUMeasurementType>
+{
+  static constexpr int kSize = 6;
+  static void Pack(const IMUMeasurementType& meas, double* values)
+  {
+    Eigen::Vector3d::Map(values) = meas.linear_acceleration_;
+    Eigen::Vector3d::Map(values + 3) = meas.angular_velocity_;
+  }
+  static std::shared_ptr<IMUMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<IMUMeasurementType>(Eigen::Vector3d(values), Eigen::Vector3d(values + 3));
+  }
+};
+
+template <>
+struct JournalCodec<PoseMeasurementType>
+{
+  static constexpr int kSize = 7;
+  static void Pack(const PoseMeasurementType& meas, double* values)
+  {
+    Eigen::Vector3d::Map(values) = meas.position_;
+    Eigen::Vector4d::Map(values + 3) = meas.orientation_.coeffs();
+  }
+  static std::shared_ptr<PoseMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<PoseMeasurementType>(Eigen::Vector3d(values), Eigen::Quaterniond(values + 3));
+  }
+};
+
+template <>
+struct JournalCodec<VisionMeasurementType>
+{
+  static constexpr int kSize = 7;
+  static void Pack(const VisionMeasurementType& meas, double* values)
+  {
+    Eigen::Vector3d::Map(values) = meas.position_;
+    Eigen::Vector4d::Map(values + 3) = meas.orientation_.coeffs();
+  }
+  static std::shared_ptr<VisionMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<VisionMeasurementType>(Eigen::Vector3d(values), Eigen::Quaterniond(values + 3));
+  }
+};
+
+template <>
+struct JournalCodec<PositionMeasurementType>
+{
+  static constexpr int kSize = 3;
+  static void Pack(const PositionMeasurementType& meas, double* values)
+  {
+    Eigen::Vector3d::Map(values) = meas.position_;
+  }
+  static std::shared_ptr<PositionMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<PositionMeasurementType>(Eigen::Vector3d(values));
+  }
+};
+
+template <>
+struct JournalCodec<VelocityMeasurementType>
+{
+  static constexpr int kSize = 3;
+  static void Pack(const VelocityMeasurementType& meas, double* values)
+  {
+    Eigen::Vector3d::Map(values) = meas.velocity_;
+  }
+  static std::shared_ptr<VelocityMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<VelocityMeasurementType>(Eigen::Vector3d(values));
+  }
+};
+
+template <>
+struct JournalCodec<BodyvelMeasurementType>
+{
+  static constexpr int kSize = 3;
+  static void Pack(const BodyvelMeasurementType& meas, double* values)
+  {
+    Eigen::Vector3d::Map(values) = meas.velocity_;
+  }
+  static std::shared_ptr<BodyvelMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<BodyvelMeasurementType>(Eigen::Vector3d(values));
+  }
+};
+
+template <>
+struct JournalCodec<MagMeasurementType>
+{
+  static constexpr int kSize = 3;
+  static void Pack(const MagMeasurementType& meas, double* values)
+  {
+    Eigen::Vector3d::Map(values) = meas.mag_vector_;
+  }
+  static std::shared_ptr<MagMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<MagMeasurementType>(Eigen::Vector3d(values));
+  }
+};
+
+template <>
+struct JournalCodec<GpsMeasurementType>
+{
+  static constexpr int kSize = 3;
+  static void Pack(const GpsMeasurementType& meas, double* values)
+  {
+    values[0] = meas.coordinates_.latitude_;
+    values[1] = meas.coordinates_.longitude_;
+    values[2] = meas.coordinates_.altitude_;
+  }
+  static std::shared_ptr<GpsMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<GpsMeasurementType>(values[0], values[1], values[2]);
+  }
+};
+
+template <>
+struct JournalCodec<GpsVelMeasurementType>
+{
+  static constexpr int kSize = 6;
+  static void Pack(const GpsVelMeasurementType& meas, double* values)
+  {
+    values[0] = meas.coordinates_.latitude_;
+    values[1] = meas.coordinates_.longitude_;
+    values[2] = meas.coordinates_.altitude_;
+    Eigen::Vector3d::Map(values + 3) = meas.velocity_;
+  }
+  static std::shared_ptr<GpsVelMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<GpsVelMeasurementType>(values[0], values[1], values[2], values[3], values[4], values[5]);
+  }
+};
+
+template <>
+struct JournalCodec<PressureMeasurementType>
+{
+  static constexpr int kSize = 3;
+  static void Pack(const PressureMeasurementType& meas, double* values)
+  {
+    values[0] = meas.pressure_.data_;
+    values[1] = meas.pressure_.temperature_K_;
+    values[2] = static_cast<double>(meas.pressure_.type_);
+  }
+  static std::shared_ptr<PressureMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<PressureMeasurementType>(values[0], values[1], static_cast<Pressure::Type>(values[2]));
+  }
+};
+
+template <>
+struct JournalCodec<AttitudeMeasurementType>
+{
+  static constexpr int kSize = 4;
+  static void Pack(const AttitudeMeasurementType& meas, double* values)
+  {
+    Eigen::Vector4d::Map(values) = meas.attitude_.quaternion_.coeffs();
+  }
+  static std::shared_ptr<AttitudeMeasurementType> Unpack(const double* values)
+  {
+    std::shared_ptr<AttitudeMeasurementType> meas = std::make_shared<AttitudeMeasurementType>();
+    meas->attitude_ = Attitude(Eigen::Quaterniond(values));
+    return meas;
+  }
+};
+
+template <>
+struct JournalCodec<EmptyMeasurementType>
+{
+  static constexpr int kSize = 1;
+  static void Pack(const EmptyMeasurementType& meas, double* values)
+  {
+    values[0] = meas.value_;
+  }
+  static std::shared_ptr<EmptyMeasurementType> Unpack(const double* values)
+  {
+    return std::make_shared<EmptyMeasurementType>(values[0]);
+  }
+};
+
+///
+/// \brief MakeJournalEncoder Generates the journal encoder for a measurement type
+///
+/// Payload: [JournalCodec<MeasType> values, (rows, cols, column major measurement noise)]. The noise block is only
+/// written if the measurement has a dynamic noise.
+///
+template <typename MeasType>
+JournalEncoder MakeJournalEncoder()
+{
+  return [](const std::shared_ptr<void>& measurement, double* values, int max_size) -> int {
+    const MeasType& meas = *static_cast<const MeasType*>(measurement.get());
+    constexpr int kSize = JournalCodec<MeasType>::kSize;
+
+    if (max_size < kSize)
+    {
+      return -1;
+    }
+    JournalCodec<MeasType>::Pack(meas, values);
+
+    if (!meas.has_meas_noise)
+    {
+      return kSize;
+    }
+
+    const int noise_size = static_cast<int>(meas.meas_noise_.size());
+    if (max_size < kSize + 2 + noise_size)
+    {
+      return -1;
+    }
+
+    values[kSize] = static_cast<double>(meas.meas_noise_.rows());
+    values[kSize + 1] = static_cast<double>(meas.meas_noise_.cols());
+    Eigen::Map<Eigen::MatrixXd>(values + kSize + 2, meas.meas_noise_.rows(), meas.meas_noise_.cols()) =
+        meas.meas_noise_;
+    return kSize + 2 + noise_size;
+  };
+}
+
+///
+/// \brief MakeJournalDecoder Generates the journal decoder for a measurement type, see MakeJournalEncoder
+///
+template <typename MeasType>
+JournalDecoder MakeJournalDecoder()
+{
+  return [](const double* values, int size) -> std::shared_ptr<void> {
+    constexpr int kSize = JournalCodec<MeasType>::kSize;
+    if (size < kSize)
+    {
+      return nullptr;
+    }
+
+    std::shared_ptr<MeasType> meas = JournalCodec<MeasType>::Unpack(values);
+
+    if (size >= kSize + 2)
+    {
+      const int rows = static_cast<int>(values[kSize]);
+      const int cols = static_cast<int>(values[kSize + 1]);
+      if (size != kSize + 2 + rows * cols)
+      {
+        return nullptr;
+      }
+
+      meas->set_meas_noise(Eigen::Map<const Eigen::MatrixXd>(values + kSize + 2, rows, cols));
+      meas->has_meas_noise = true;
+    }
+
+    return meas;
+  };
+}
+
+///
+/// \brief MakeCoreStateEncoder Generates the encoder for filter outputs (BufferDataType::core_state_)
+///
+/// Payload: [p_wi, v_wi, q_wi (x, y, z, w), b_w, b_a, diagonal of the error state covariance]
+///
+inline JournalEncoder MakeCoreStateEncoder()
+{
+  return [](const std::shared_ptr<void>& core_state, double* values, int max_size) -> int {
+    constexpr int kSize = CoreStateType::size_true_ + CoreStateType::size_error_;
+    if (max_size < kSize)
+    {
+      return -1;
+    }
+
+    const CoreType& core = *static_cast<const CoreType*>(core_state.get());
+    Eigen::Vector3d::Map(values) = core.state_.p_wi_;
+    Eigen::Vector3d::Map(values + 3) = core.state_.v_wi_;
+    Eigen::Vector4d::Map(values + 6) = core.state_.q_wi_.coeffs();
+    Eigen::Vector3d::Map(values + 10) = core.state_.b_w_;
+    Eigen::Vector3d::Map(values + 13) = core.state_.b_a_;
+    Eigen::Matrix<double, CoreStateType::size_error_, 1>::Map(values + CoreStateType::size_true_) =
+        core.cov_.diagonal();
+    return kSize;
+  };
+}
+
+///
+/// \brief MakeCoreStateDecoder Generates the decoder for filter outputs, see MakeCoreStateEncoder
+///
+/// The off-diagonal covariance elements are zero.
+///
+inline JournalDecoder MakeCoreStateDecoder()
+{
+  return [](const double* values, int size) -> std::shared_ptr<void> {
+    if (size != CoreStateType::size_true_ + CoreStateType::size_error_)
+    {
+      return nullptr;
+    }
+
+    std::shared_ptr<CoreType> core = std::make_shared<CoreType>();
+    core->state_.p_wi_ = Eigen::Vector3d(values);
+    core->state_.v_wi_ = Eigen::Vector3d(values + 3);
+    core->state_.q_wi_ = Eigen::Quaterniond(values + 6);
+    core->state_.b_w_ = Eigen::Vector3d(values + 10);
+    core->state_.b_a_ = Eigen::Vector3d(values + 13);
+    core->cov_ = Eigen::Matrix<double, CoreStateType::size_error_, 1>(values + CoreStateType::size_true_).asDiagonal();
+    return core;
+  };
+}
+}  // namespace mars
+
+#endif  // JOURNAL_CODECS_H
@@ -17,6 +17,7 @@
 #include <iostream>
 #include <map>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include "mars/data_utils/filesystem.h"
@@ -37,7 +38,7 @@ public:
     if (!mars::filesystem::IsFile(file_path))
     {
       std::cout << "ReadCsv(): [Warning] File " << file_path << " does not exist." << std::endl;
-      exit(EXIT_FAILURE);
+      throw std::runtime_error("ReadCsv(): File " + file_path + " does not exist");
     }
 
     file_.open(file_path);
@@ -51,7 +52,7 @@ public:
     if (first_value_row < 1)
     {
       std::cout << "ReadCsv():Error: No header in CSV file" << std::endl;
-      exit(EXIT_FAILURE);
+      throw std::runtime_error("ReadCsv(): No header in CSV file " + file_path);
     }
 
     header_map = get_header(first_value_row - 1);
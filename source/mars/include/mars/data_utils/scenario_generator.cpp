@@ -0,0 +1,509 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include "scenario_generator.h"
+#include <mars/data_utils/journal_codecs.h>
+#include <mars/general_functions/utils.h>
+#include <mars/sensors/pressure/pressure_conversion.h>
+#include <mars/type_definitions/journal_record.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace mars
+{
+namespace
+{
+JournalEncoder get_journal_encoder(const ScenarioSensorType& type)
+{
+  switch (type)
+  {
+    case ScenarioSensorType::imu:
+      return MakeJournalEncoder<IMUMeasurementType>();
+    case ScenarioSensorType::pose:
+      return MakeJournalEncoder<PoseMeasurementType>();
+    case ScenarioSensorType::position:
+      return MakeJournalEncoder<PositionMeasurementType>();
+    case ScenarioSensorType::gps_w_vel:
+      return MakeJournalEncoder<GpsVelMeasurementType>();
+    case ScenarioSensorType::mag:
+      return MakeJournalEncoder<MagMeasurementType>();
+    case ScenarioSensorType::pressure:
+      return MakeJournalEncoder<PressureMeasurementType>();
+    case ScenarioSensorType::attitude:
+      return MakeJournalEncoder<AttitudeMeasurementType>();
+    case ScenarioSensorType::vision:
+      return MakeJournalEncoder<VisionMeasurementType>();
+    case ScenarioSensorType::bodyvel:
+      return MakeJournalEncoder<BodyvelMeasurementType>();
+    case ScenarioSensorType::velocity:
+      return MakeJournalEncoder<VelocityMeasurementType>();
+    default:
+      return nullptr;
+  }
+}
+
+///
+/// \brief get_gas_scale Scale height of the barometric formula used by PressureConversion::get_height_gas [m]
+///
+double get_gas_scale(const double& temperature)
+{
+  const MediumPressureOptions medium;
+  return medium.r / (medium.M * medium.g) * temperature;
+}
+
+void write_csv_line(std::ofstream* file, const double& t, const std::vector<double>& values)
+{
+  *file << t;
+  for (const auto& k : values)
+  {
+    *file << ", " << k;
+  }
+  *file << "\n";
+}
+}  // namespace
+
+ScenarioGenerator::ScenarioGenerator(ScenarioConfig config)
+  : config_(std::move(config)), gps_conversion_(config_.gps_reference_)
+{
+  std::cout << "Created: ScenarioGenerator (Duration=" << config_.duration_ << "s Seed=" << config_.seed_ << ")"
+            << std::endl;
+}
+
+int ScenarioGenerator::AddSensor(const ScenarioSensorConfig& sensor)
+{
+  sensors_.push_back(sensor);
+  samples_.emplace_back();
+  return static_cast<int>(sensors_.size()) - 1;
+}
+
+void ScenarioGenerator::Generate()
+{
+  for (size_t s = 0; s < sensors_.size(); s++)
+  {
+    const ScenarioSensorConfig& sensor = sensors_[s];
+    std::vector<ScenarioSample>& samples = samples_[s];
+    samples.clear();
+
+    if (sensor.rate_ <= 0)
+    {
+      std::cout << "ScenarioGenerator: Warning: Sensor " << sensor.name_ << " has no valid rate" << std::endl;
+      continue;
+    }
+
+    std::mt19937_64 generator(config_.seed_ + s);
+    std::normal_distribution<double> normal(0, 1);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    const int num_samples = static_cast<int>(std::floor(config_.duration_ * sensor.rate_ + 1e-9)) + 1;
+    samples.reserve(static_cast<size_t>(num_samples));
+
+    for (int k = 0; k < num_samples; k++)
+    {
+      if (sensor.dropout_probability_ > 0 && uniform(generator) < sensor.dropout_probability_)
+      {
+        continue;
+      }
+
+      const double t = k / sensor.rate_;
+      CoreStateType state = get_true_state(t);
+
+      const Eigen::Vector3d noise(normal(generator), normal(generator), normal(generator));
+      const Eigen::Vector3d noise_secondary(normal(generator), normal(generator), normal(generator));
+      const Eigen::Vector3d n = sensor.noise_std_ * noise;
+      const Eigen::Vector3d n2 = sensor.noise_std_secondary_ * noise_secondary;
+
+      // Perturb the true state, or the measurement for sensors without a direct state relation
+      switch (sensor.type_)
+      {
+        case ScenarioSensorType::imu:
+          state.b_a_ += n;
+          state.b_w_ += n2;
+          break;
+        case ScenarioSensorType::pose:
+        case ScenarioSensorType::position:
+        case ScenarioSensorType::vision:
+          state.p_wi_ += n;
+          state.q_wi_ = Utils::ApplySmallAngleQuatCorr(state.q_wi_, n2);
+          break;
+        case ScenarioSensorType::gps_w_vel:
+          state.p_wi_ += n;
+          state.v_wi_ += n2;
+          break;
+        case ScenarioSensorType::pressure:
+          state.p_wi_.z() += n.z();
+          break;
+        case ScenarioSensorType::attitude:
+          state.q_wi_ = Utils::ApplySmallAngleQuatCorr(state.q_wi_, n2);
+          break;
+        case ScenarioSensorType::velocity:
+          state.v_wi_ += n;
+          break;
+        default:
+          break;
+      }
+
+      std::vector<double> values = Measure(sensor.type_, state);
+
+      if (sensor.type_ == ScenarioSensorType::mag || sensor.type_ == ScenarioSensorType::bodyvel)
+      {
+        for (int i = 0; i < 3; i++)
+        {
+          values[static_cast<size_t>(i)] += n(i);
+        }
+      }
+
+      double arrival = t + sensor.delay_;
+      if (sensor.delay_jitter_ > 0)
+      {
+        arrival += -sensor.delay_jitter_ * std::log(1 - uniform(generator));
+      }
+
+      samples.push_back({ t, arrival, values });
+    }
+  }
+}
+
+CoreStateType ScenarioGenerator::get_true_state(const double& t) const
+{
+  const Eigen::Vector3d w = 2 * M_PI * config_.frequency_;
+  const Eigen::Vector3d wt = w * t;
+  const Eigen::Vector3d sin_wt(std::sin(wt.x()), std::sin(wt.y()), std::sin(wt.z()));
+  const Eigen::Vector3d cos_wt(std::cos(wt.x()), std::cos(wt.y()), std::cos(wt.z()));
+
+  CoreStateType state;
+  state.p_wi_ = config_.amplitude_.cwiseProduct(sin_wt);
+  state.v_wi_ = config_.amplitude_.cwiseProduct(w).cwiseProduct(cos_wt);
+  const Eigen::Vector3d a_w = -config_.amplitude_.cwiseProduct(w).cwiseProduct(w).cwiseProduct(sin_wt);
+
+  // Roll, pitch and yaw and their derivatives
+  const Eigen::Vector3d w_rpy = 2 * M_PI * config_.rpy_frequency_;
+  Eigen::Vector3d rpy;
+  Eigen::Vector3d d_rpy;
+  for (int k = 0; k < 3; k++)
+  {
+    rpy(k) = config_.rpy_amplitude_(k) * std::sin(w_rpy(k) * t);
+    d_rpy(k) = config_.rpy_amplitude_(k) * w_rpy(k) * std::cos(w_rpy(k) * t);
+  }
+
+  const double& roll = rpy.x();
+  const double& pitch = rpy.y();
+  state.q_wi_ = Eigen::AngleAxisd(rpy.z(), Eigen::Vector3d::UnitZ()) *
+                Eigen::AngleAxisd(pitch, Eigen::Vector3d::UnitY()) * Eigen::AngleAxisd(roll, Eigen::Vector3d::UnitX());
+
+  // Body rates of the ZYX Euler angles
+  const Eigen::Vector3d w_i(d_rpy.x() - d_rpy.z() * std::sin(pitch),
+                            d_rpy.y() * std::cos(roll) + d_rpy.z() * std::cos(pitch) * std::sin(roll),
+                            -d_rpy.y() * std::sin(roll) + d_rpy.z() * std::cos(pitch) * std::cos(roll));
+
+  state.b_w_ = config_.b_w_;
+  state.b_a_ = config_.b_a_;
+  state.w_m_ = w_i + config_.b_w_;
+  state.a_m_ = state.q_wi_.toRotationMatrix().transpose() * (a_w + Eigen::Vector3d(0, 0, 9.81)) + config_.b_a_;
+  return state;
+}
+
+const ScenarioConfig& ScenarioGenerator::get_config() const
+{
+  return config_;
+}
+
+const std::vector<ScenarioSensorConfig>& ScenarioGenerator::get_sensors() const
+{
+  return sensors_;
+}
+
+const std::vector<ScenarioSample>& ScenarioGenerator::get_samples(const int& sensor_idx) const
+{
+  return samples_.at(static_cast<size_t>(sensor_idx));
+}
+
+std::vector<BufferEntryType> ScenarioGenerator::get_entries(const std::vector<std::shared_ptr<SensorAbsClass>>& sensors,
+                                                            const bool& arrival_order) const
+{
+  std::vector<BufferEntryType> entries;
+  if (sensors.size() != sensors_.size())
+  {
+    std::cout << "ScenarioGenerator: Warning: Expected " << sensors_.size() << " sensor handles, got "
+              << sensors.size() << std::endl;
+    return entries;
+  }
+
+  const std::vector<Event> events = get_events(arrival_order);
+  entries.reserve(events.size());
+
+  for (const auto& k : events)
+  {
+    const ScenarioSample& sample = samples_[static_cast<size_t>(k.sensor_idx)][k.sample_idx];
+    const ScenarioSensorType& type = sensors_[static_cast<size_t>(k.sensor_idx)].type_;
+
+    BufferDataType data;
+    data.set_measurement(MakeMeasurement(type, sample.values_, config_.temperature_));
+    entries.emplace_back(Time(sample.timestamp_), data, sensors[static_cast<size_t>(k.sensor_idx)]);
+  }
+
+  return entries;
+}
+
+std::vector<double> ScenarioGenerator::get_arrival_times(const bool& arrival_order) const
+{
+  const std::vector<Event> events = get_events(arrival_order);
+  std::vector<double> arrival_times;
+  arrival_times.reserve(events.size());
+
+  for (const auto& k : events)
+  {
+    arrival_times.push_back(samples_[static_cast<size_t>(k.sensor_idx)][k.sample_idx].arrival_);
+  }
+
+  return arrival_times;
+}
+
+bool ScenarioGenerator::WriteCsv(const std::string& directory) const
+{
+  const std::string path = directory.empty() || directory.back() == '/' ? directory : directory + "/";
+
+  std::ofstream traj_file(path + "traj.csv");
+  if (!traj_file.is_open())
+  {
+    std::cout << "ScenarioGenerator: Warning: Could not open " << path << "traj.csv" << std::endl;
+    return false;
+  }
+
+  traj_file << std::setprecision(17);
+  traj_file << "t, w_x, w_y, w_z, a_x, a_y, a_z, p_x, p_y, p_z, v_x, v_y, v_z, q_w, q_x, q_y, q_z, bw_x, bw_y, bw_z, "
+               "ba_x, ba_y, ba_z\n";
+
+  const int num_truth = static_cast<int>(std::floor(config_.duration_ * config_.truth_rate_ + 1e-9)) + 1;
+  for (int k = 0; k < num_truth; k++)
+  {
+    const double t = k / config_.truth_rate_;
+    const CoreStateType s = get_true_state(t);
+    write_csv_line(&traj_file, t,
+                   { s.w_m_.x(), s.w_m_.y(), s.w_m_.z(), s.a_m_.x(), s.a_m_.y(), s.a_m_.z(), s.p_wi_.x(), s.p_wi_.y(),
+                     s.p_wi_.z(), s.v_wi_.x(), s.v_wi_.y(), s.v_wi_.z(), s.q_wi_.w(), s.q_wi_.x(), s.q_wi_.y(),
+                     s.q_wi_.z(), s.b_w_.x(), s.b_w_.y(), s.b_w_.z(), s.b_a_.x(), s.b_a_.y(), s.b_a_.z() });
+  }
+
+  for (size_t s = 0; s < sensors_.size(); s++)
+  {
+    const std::string file_name = path + sensors_[s].name_ + ".csv";
+    std::ofstream file(file_name);
+    if (!file.is_open())
+    {
+      std::cout << "ScenarioGenerator: Warning: Could not open " << file_name << std::endl;
+      return false;
+    }
+
+    const std::vector<std::string> header = get_csv_header(sensors_[s].type_);
+    for (size_t k = 0; k < header.size(); k++)
+    {
+      file << (k == 0 ? "" : ", ") << header[k];
+    }
+    file << "\n" << std::setprecision(17);
+
+    for (const auto& k : samples_[s])
+    {
+      write_csv_line(&file, k.timestamp_, k.values_);
+    }
+  }
+
+  return true;
+}
+
+bool ScenarioGenerator::WriteJournal(const std::string& file_name) const
+{
+  std::ofstream file(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+  {
+    std::cout << "ScenarioGenerator: Warning: Could not open file " << file_name << std::endl;
+    return false;
+  }
+
+  journal::JournalFileHeader header{};
+  header.magic = journal::kJournalMagic;
+  header.version = journal::kJournalVersion;
+  header.num_sensors = static_cast<uint32_t>(sensors_.size());
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  std::vector<JournalEncoder> encoders;
+  for (const auto& k : sensors_)
+  {
+    const uint32_t name_length = static_cast<uint32_t>(k.name_.size());
+    file.write(reinterpret_cast<const char*>(&name_length), sizeof(name_length));
+    file.write(k.name_.data(), name_length);
+    encoders.push_back(get_journal_encoder(k.type_));
+  }
+
+  journal::JournalRecord record{};
+  for (const auto& k : get_events(true))
+  {
+    const ScenarioSample& sample = samples_[static_cast<size_t>(k.sensor_idx)][k.sample_idx];
+    const std::shared_ptr<void> measurement =
+        MakeMeasurement(sensors_[static_cast<size_t>(k.sensor_idx)].type_, sample.values_, config_.temperature_);
+
+    const int num_values = encoders[static_cast<size_t>(k.sensor_idx)](measurement, record.values, journal::kMaxValues);
+    if (num_values < 0)
+    {
+      std::cout << "ScenarioGenerator: Warning: Could not encode a measurement of sensor "
+                << sensors_[static_cast<size_t>(k.sensor_idx)].name_ << std::endl;
+      return false;
+    }
+
+    record.header.sensor_id = static_cast<uint32_t>(k.sensor_idx);
+    record.header.num_values = static_cast<uint32_t>(num_values);
+    record.header.timestamp = sample.timestamp_;
+    record.header.arrival_ns = static_cast<int64_t>(std::llround(sample.arrival_ * 1e9));
+
+    file.write(reinterpret_cast<const char*>(&record.header), sizeof(record.header));
+    file.write(reinterpret_cast<const char*>(record.values),
+               static_cast<std::streamsize>(record.header.num_values * sizeof(double)));
+  }
+
+  return file.good();
+}
+
+std::vector<std::string> ScenarioGenerator::get_csv_header(const ScenarioSensorType& type)
+{
+  switch (type)
+  {
+    case ScenarioSensorType::imu:
+      return { "t", "a_x", "a_y", "a_z", "w_x", "w_y", "w_z" };
+    case ScenarioSensorType::pose:
+    case ScenarioSensorType::vision:
+      return { "t", "p_x", "p_y", "p_z", "q_w", "q_x", "q_y", "q_z" };
+    case ScenarioSensorType::position:
+      return { "t", "p_x", "p_y", "p_z" };
+    case ScenarioSensorType::gps_w_vel:
+      return { "t", "lat", "long", "alt", "v_x", "v_y", "v_z" };
+    case ScenarioSensorType::mag:
+      return { "t", "cart_x", "cart_y", "cart_z" };
+    case ScenarioSensorType::pressure:
+      return { "t", "p" };
+    case ScenarioSensorType::attitude:
+      return { "t", "q_w", "q_x", "q_y", "q_z" };
+    case ScenarioSensorType::bodyvel:
+    case ScenarioSensorType::velocity:
+      return { "t", "v_x", "v_y", "v_z" };
+    default:
+      return {};
+  }
+}
+
+std::shared_ptr<void> ScenarioGenerator::MakeMeasurement(const ScenarioSensorType& type,
+                                                         const std::vector<double>& values, const double& temperature)
+{
+  const double* v = values.data();
+
+  switch (type)
+  {
+    case ScenarioSensorType::imu:
+      return std::make_shared<IMUMeasurementType>(Eigen::Vector3d(v), Eigen::Vector3d(v + 3));
+    case ScenarioSensorType::pose:
+      return std::make_shared<PoseMeasurementType>(Eigen::Vector3d(v),
+                                                   Eigen::Quaterniond(v[3], v[4], v[5], v[6]).normalized());
+    case ScenarioSensorType::vision:
+      return std::make_shared<VisionMeasurementType>(Eigen::Vector3d(v),
+                                                     Eigen::Quaterniond(v[3], v[4], v[5], v[6]).normalized());
+    case ScenarioSensorType::position:
+      return std::make_shared<PositionMeasurementType>(Eigen::Vector3d(v));
+    case ScenarioSensorType::gps_w_vel:
+      return std::make_shared<GpsVelMeasurementType>(v[0], v[1], v[2], v[3], v[4], v[5]);
+    case ScenarioSensorType::mag:
+      return std::make_shared<MagMeasurementType>(Eigen::Vector3d(v));
+    case ScenarioSensorType::pressure:
+      return std::make_shared<PressureMeasurementType>(v[0], temperature);
+    case ScenarioSensorType::attitude:
+    {
+      std::shared_ptr<AttitudeMeasurementType> meas = std::make_shared<AttitudeMeasurementType>();
+      meas->attitude_ = Attitude(Eigen::Quaterniond(v[0], v[1], v[2], v[3]).normalized());
+      return meas;
+    }
+    case ScenarioSensorType::bodyvel:
+      return std::make_shared<BodyvelMeasurementType>(Eigen::Vector3d(v));
+    case ScenarioSensorType::velocity:
+      return std::make_shared<VelocityMeasurementType>(Eigen::Vector3d(v));
+    default:
+      return nullptr;
+  }
+}
+
+std::vector<double> ScenarioGenerator::Measure(const ScenarioSensorType& type, const CoreStateType& state) const
+{
+  const Eigen::Matrix3d R_iw = state.q_wi_.toRotationMatrix().transpose();
+  const Eigen::Vector3d& p = state.p_wi_;
+  const Eigen::Quaterniond& q = state.q_wi_;
+
+  switch (type)
+  {
+    case ScenarioSensorType::imu:
+    {
+      // The biases of the state hold the biases and the white noise of this measurement
+      const Eigen::Vector3d a_m = state.a_m_ - config_.b_a_ + state.b_a_;
+      const Eigen::Vector3d w_m = state.w_m_ - config_.b_w_ + state.b_w_;
+      return { a_m.x(), a_m.y(), a_m.z(), w_m.x(), w_m.y(), w_m.z() };
+    }
+    case ScenarioSensorType::pose:
+    case ScenarioSensorType::vision:
+      return { p.x(), p.y(), p.z(), q.w(), q.x(), q.y(), q.z() };
+    case ScenarioSensorType::position:
+      return { p.x(), p.y(), p.z() };
+    case ScenarioSensorType::gps_w_vel:
+    {
+      const GpsCoordinates gps = gps_conversion_.get_gps(p);
+      return { gps.latitude_, gps.longitude_, gps.altitude_, state.v_wi_.x(), state.v_wi_.y(), state.v_wi_.z() };
+    }
+    case ScenarioSensorType::mag:
+    {
+      const Eigen::Vector3d mag = R_iw * config_.mag_w_;
+      return { mag.x(), mag.y(), mag.z() };
+    }
+    case ScenarioSensorType::pressure:
+      return { config_.pressure_reference_ * std::exp(-p.z() / get_gas_scale(config_.temperature_)) };
+    case ScenarioSensorType::attitude:
+      return { q.w(), q.x(), q.y(), q.z() };
+    case ScenarioSensorType::bodyvel:
+    {
+      const Eigen::Vector3d v_i = R_iw * state.v_wi_;
+      return { v_i.x(), v_i.y(), v_i.z() };
+    }
+    case ScenarioSensorType::velocity:
+      return { state.v_wi_.x(), state.v_wi_.y(), state.v_wi_.z() };
+    default:
+      return {};
+  }
+}
+
+std::vector<ScenarioGenerator::Event> ScenarioGenerator::get_events(const bool& arrival_order) const
+{
+  std::vector<Event> events;
+  for (size_t s = 0; s < samples_.size(); s++)
+  {
+    for (size_t k = 0; k < samples_[s].size(); k++)
+    {
+      const ScenarioSample& sample = samples_[s][k];
+      events.push_back({ arrival_order ? sample.arrival_ : sample.timestamp_, static_cast<int>(s), k });
+    }
+  }
+
+  std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+    if (a.time != b.time)
+    {
+      return a.time < b.time;
+    }
+    return a.sensor_idx < b.sensor_idx;
+  });
+
+  return events;
+}
+}  // namespace mars
@@ -0,0 +1,184 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef SCENARIO_GENERATOR_H
+#define SCENARIO_GENERATOR_H
+
+#include <mars/sensors/gps/gps_conversion.h>
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <mars/type_definitions/core_state_type.h>
+#include <Eigen/Dense>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mars
+{
+enum class ScenarioSensorType
+{
+  imu,
+  pose,
+  position,
+  gps_w_vel,
+  mag,
+  pressure,
+  attitude,
+  vision,
+  bodyvel,
+  velocity
+};
+
+///
+/// \brief Rate, noise and arrival model of one synthesized sensor
+///
+/// Measurements are generated with identity calibrations, i.e. the sensor frames coincide with the IMU frame, the
+/// vision scale is one and the vision, GPS and attitude reference frames coincide with the world frame.
+///
+struct ScenarioSensorConfig
+{
+  ScenarioSensorType type_{ ScenarioSensorType::pose };
+  std::string name_;                 ///< Used as CSV file name and journal sensor name
+  double rate_{ 10 };                ///< Measurement rate [Hz]
+  double noise_std_{ 0 };            ///< Std. of the position, velocity, acceleration, field or height noise
+  double noise_std_secondary_{ 0 };  ///< Std. of the orientation, angular velocity or GPS velocity noise
+  double dropout_probability_{ 0 };  ///< Probability that a measurement is lost
+  double delay_{ 0 };                ///< Constant arrival delay [s]
+  double delay_jitter_{ 0 };         ///< Mean of the exponentially distributed additional arrival delay [s]
+};
+
+///
+/// \brief Trajectory and environment of a scenario
+///
+/// The trajectory is a smooth Lissajous figure with oscillating roll, pitch and yaw that starts at the origin.
+///
+struct ScenarioConfig
+{
+  double duration_{ 60 };                              ///< [s]
+  uint64_t seed_{ 1 };                                 ///< Seed of the noise, dropout and delay generators
+  Eigen::Vector3d amplitude_{ 5, 4, 1 };               ///< Position amplitude [m]
+  Eigen::Vector3d frequency_{ 0.05, 0.08, 0.03 };      ///< Position frequency [Hz]
+  Eigen::Vector3d rpy_amplitude_{ 0.1, 0.1, 0.8 };     ///< Roll, pitch and yaw amplitude [rad]
+  Eigen::Vector3d rpy_frequency_{ 0.11, 0.07, 0.04 };  ///< Roll, pitch and yaw frequency [Hz]
+  Eigen::Vector3d b_w_{ 0.001, -0.002, 0.0015 };       ///< Constant gyro bias [rad/s]
+  Eigen::Vector3d b_a_{ 0.02, -0.01, 0.03 };           ///< Constant accelerometer bias [m/s^2]
+  Eigen::Vector3d mag_w_{ 0.2, 0.0, -0.45 };           ///< Magnetic field in the world frame
+  GpsCoordinates gps_reference_{ 46.6, 14.26, 450 };   ///< GPS coordinates of the world origin
+  double pressure_reference_{ 101325 };                ///< Pressure at the world origin [Pa]
+  double temperature_{ 293.15 };                       ///< Ambient temperature [K], as used by ReadBarometerData
+  double truth_rate_{ 200 };                           ///< Rate of the ground truth samples [Hz]
+};
+
+///
+/// \brief One synthesized measurement
+///
+struct ScenarioSample
+{
+  double timestamp_;            ///< Measurement time [s]
+  double arrival_;              ///< Arrival time at the filter [s]
+  std::vector<double> values_;  ///< Values in the order of the CSV columns, see get_csv_header
+};
+
+///
+/// \brief The ScenarioGenerator class synthesizes a trajectory and the matching measurements of all sensor types
+///
+/// The generation is deterministic for a given configuration. Each sensor draws from its own random generator, adding
+/// a sensor does not change the measurements of the other sensors.
+///
+class ScenarioGenerator
+{
+public:
+  ScenarioGenerator(ScenarioConfig config);
+
+  ///
+  /// \brief AddSensor
+  /// \return Index of the sensor
+  ///
+  int AddSensor(const ScenarioSensorConfig& sensor);
+
+  ///
+  /// \brief Generate Synthesizes the ground truth and the measurements of all added sensors
+  ///
+  void Generate();
+
+  ///
+  /// \brief get_true_state True state at the given time, 'a_m_' and 'w_m_' hold the noise free IMU measurement
+  ///
+  CoreStateType get_true_state(const double& t) const;
+
+  const ScenarioConfig& get_config() const;
+  const std::vector<ScenarioSensorConfig>& get_sensors() const;
+  const std::vector<ScenarioSample>& get_samples(const int& sensor_idx) const;
+
+  ///
+  /// \brief get_entries Measurements of all sensors as buffer entries
+  /// \param sensors Sensor handles, in the order the sensors were added
+  /// \param arrival_order Sort by arrival time instead of the measurement time
+  /// \return Measurements, ties are ordered by the sensor index
+  ///
+  std::vector<BufferEntryType> get_entries(const std::vector<std::shared_ptr<SensorAbsClass>>& sensors,
+                                           const bool& arrival_order) const;
+
+  ///
+  /// \brief get_arrival_times Arrival times matching the entries of get_entries
+  ///
+  std::vector<double> get_arrival_times(const bool& arrival_order) const;
+
+  ///
+  /// \brief WriteCsv Writes 'traj.csv' with the ground truth and '<name>.csv' for each sensor
+  /// \param directory Existing output directory
+  /// \return true if all files were written
+  ///
+  bool WriteCsv(const std::string& directory) const;
+
+  ///
+  /// \brief WriteJournal Writes all measurements in arrival order as a MeasurementJournal file
+  ///
+  /// The arrival time of the measurements is stored as arrival time of the records.
+  ///
+  /// \return true if the file was written
+  ///
+  bool WriteJournal(const std::string& file_name) const;
+
+  ///
+  /// \brief get_csv_header Column names of the measurement CSV files, compatible with the data_utils readers
+  ///
+  static std::vector<std::string> get_csv_header(const ScenarioSensorType& type);
+
+  ///
+  /// \brief MakeMeasurement Generates the measurement object from the CSV values
+  ///
+  static std::shared_ptr<void> MakeMeasurement(const ScenarioSensorType& type, const std::vector<double>& values,
+                                               const double& temperature);
+
+private:
+  struct Event
+  {
+    double time;
+    int sensor_idx;
+    size_t sample_idx;
+  };
+
+  ///
+  /// \brief Measure Measurement of a sensor for the given (perturbed) state, see get_true_state
+  ///
+  std::vector<double> Measure(const ScenarioSensorType& type, const CoreStateType& state) const;
+
+  std::vector<Event> get_events(const bool& arrival_order) const;
+
+  ScenarioConfig config_;
+  std::vector<ScenarioSensorConfig> sensors_;
+  std::vector<std::vector<ScenarioSample>> samples_;
+  mutable GpsConversion gps_conversion_;
+};
+}  // namespace mars
+
+#endif  // SCENARIO_GENERATOR_H
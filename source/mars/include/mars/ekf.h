@@ -11,6 +11,7 @@
 #ifndef EKF_HPP
 #define EKF_HPP
 
+#include <mars/core_state_kernels.h>
 #include <Eigen/Dense>
 #include <boost/math/distributions/chi_squared.hpp>
 #include <iostream>
@@ -51,6 +52,11 @@ public:
   ///
   void get_result(Eigen::MatrixXd* const last_res, double* const last_X2) const;
 
+  ///
+  /// \brief get_last_X2 Returns the last X2 value without copying the residual
+  ///
+  double get_last_X2() const;
+
   ///
   /// \brief CalculateUcv Perform the calculation of the upper critical value
   ///
@@ -70,6 +76,17 @@ public:
   ///
   bool CalculateChi2(const Eigen::MatrixXd& res, const Eigen::MatrixXd& S);
 
+  ///
+  /// \brief CalculateChi2WithInverse Calculate the X2 value with the inverse of the innovation, see CalculateChi2
+  ///
+  /// Does not allocate once the residual had the same size in a previous call.
+  ///
+  /// \param res Residual
+  /// \param S_inv Inverse of the innovation
+  /// \return True if the test passed, false if it did not pass
+  ///
+  bool CalculateChi2WithInverse(const Eigen::MatrixXd& res, const Eigen::MatrixXd& S_inv);
+
   ///
   /// \brief PrintReport Print a formated report e.g. if the test did not pass
   /// \param name Name of the sensor, used in the print
@@ -84,8 +101,9 @@ public:
   bool passed_{ false };           /// Shows if the test passed or not (true=passed)
 
 private:
-  Eigen::MatrixXd last_res_;  /// Last residual, for the report
-  double last_X2_;            /// Last X2 value, for the report
+  Eigen::MatrixXd last_res_;      /// Last residual, for the report
+  Eigen::MatrixXd weighted_res_;  /// res^T * S^-1 of the last test
+  double last_X2_{ 0 };           /// Last X2 value, for the report
 };
 
 class Ekf
@@ -102,6 +120,23 @@ public:
   ///
   Ekf(const Eigen::Ref<const Eigen::MatrixXd>& H, const Eigen::Ref<const Eigen::MatrixXd>& R,
       const Eigen::Ref<const Eigen::MatrixXd>& res, const Eigen::Ref<const Eigen::MatrixXd>& P)
+  {
+    set_inputs(H, R, res, P);
+  }
+
+  ///
+  /// \brief Ekf Constructor for an update component which is reused for each update, see set_inputs
+  ///
+  Ekf() = default;
+
+  ///
+  /// \brief set_inputs Sets the components of the next update
+  ///
+  /// The members and intermediate results keep their memory. A reused Ekf does not allocate for updates of the same
+  /// size, if the results are written to outputs of the same size as well.
+  ///
+  void set_inputs(const Eigen::Ref<const Eigen::MatrixXd>& H, const Eigen::Ref<const Eigen::MatrixXd>& R,
+                  const Eigen::Ref<const Eigen::MatrixXd>& res, const Eigen::Ref<const Eigen::MatrixXd>& P)
   {
     this->H_ = H;
     this->R_ = R;
@@ -133,7 +168,22 @@ public:
   ///
   Eigen::MatrixXd CalculateCovUpdate();
 
+  ///
+  /// \brief CalculateCorrection Calculating the state correction with a post Chi2 test
+  /// \param chi2 'Chi2' class based on the sensor measurement
+  /// \param correction Output for the state correction
+  ///
+  void CalculateCorrection(Chi2* chi2, Eigen::MatrixXd* correction);
+
+  ///
+  /// \brief CalculateCovUpdate Updating the state covariance after the state update
+  /// \param cov Output for the updated state covariance matrix
+  ///
+  void CalculateCovUpdate(Eigen::MatrixXd* cov);
+
 private:
+  CoreStateKernelsDouble::UpdateWorkspace workspace_;  ///< Intermediate results of the update
+
   ///
   /// \brief CalculateStateCorrection Calculation of EKF components, correction, innovation etc.
   /// \return State correction vector
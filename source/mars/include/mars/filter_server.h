@@ -0,0 +1,180 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef FILTER_SERVER_H
+#define FILTER_SERVER_H
+
+#include <mars/core_logic.h>
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/time.h>
+#include <mars/type_definitions/buffer_data_type.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief Statistics of one filter stream
+///
+struct FilterStreamStats
+{
+  size_t backlog_{ 0 };          ///< Number of measurements that are queued but not processed yet
+  uint64_t num_processed_{ 0 };  ///< Number of processed measurements
+  uint64_t num_rejected_{ 0 };   ///< Number of measurements for which ProcessMeasurement returned false
+  uint64_t num_batches_{ 0 };    ///< Number of batches in which the measurements were processed
+  double latency_mean_{ 0 };     ///< Mean time from submission until the measurement was processed [s]
+  double latency_max_{ 0 };      ///< Max time from submission until the measurement was processed [s]
+  double latency_last_{ 0 };     ///< Latency of the latest processed measurement [s]
+};
+
+///
+/// \brief The FilterServer class hosts many independent CoreLogic instances on a fixed pool of worker threads
+///
+/// Measurements are routed to the CoreLogic of a stream by the stream ID and queued per stream. A stream with pending
+/// measurements is scheduled as one task, the worker that executes the task processes all queued measurements of this
+/// stream in one batch (up to 'max_batch_size_') such that the filter data stays in the cache of this worker.
+///
+/// Each worker has its own task queue, idle workers steal tasks from the queues of other workers. A stream is only
+/// scheduled once at a time, measurements of one stream are therefore always processed in submission order and a
+/// CoreLogic instance is never accessed by two workers at the same time.
+///
+/// \note The CoreLogic instances and their sensors must not be accessed by the user while measurements of the stream
+/// are pending. Use WaitIdle() before the filter states are read.
+///
+class FilterServer
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ///
+  /// \brief FilterServer Starts the worker pool
+  /// \param num_threads Number of worker threads, 0 uses the number of hardware threads
+  ///
+  FilterServer(const unsigned int& num_threads = 0);
+  ~FilterServer();
+
+  FilterServer(const FilterServer&) = delete;
+  FilterServer& operator=(const FilterServer&) = delete;
+
+  ///
+  /// \brief AddStream Registers a CoreLogic instance for the given stream ID
+  /// \param stream_id Unique ID of the stream
+  /// \param core_logic Filter that processes the measurements of this stream
+  /// \return true if the stream was added, false if the ID is already in use
+  ///
+  bool AddStream(const int& stream_id, std::shared_ptr<CoreLogic> core_logic);
+
+  ///
+  /// \brief get_core_logic
+  /// \return CoreLogic of the stream, nullptr if the stream does not exist
+  ///
+  std::shared_ptr<CoreLogic> get_core_logic(const int& stream_id);
+
+  ///
+  /// \brief Submit Queues a measurement for the given stream
+  ///
+  /// The arguments are passed to CoreLogic::ProcessMeasurement by one of the workers.
+  ///
+  /// \return true if the measurement was queued, false if the stream does not exist or the server is stopped. Queued
+  /// measurements are processed, also if Stop() is called concurrently.
+  ///
+  bool Submit(const int& stream_id, std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+              const BufferDataType& data);
+
+  ///
+  /// \brief WaitIdle Blocks until all submitted measurements are processed
+  ///
+  void WaitIdle();
+
+  ///
+  /// \brief Stop Processes the pending measurements and stops the workers
+  ///
+  /// Submit() rejects measurements once Stop() was called. Measurements that were accepted before are processed before
+  /// the workers exit.
+  ///
+  void Stop();
+
+  ///
+  /// \brief get_stream_stats Returns backlog and latency statistics of a stream
+  /// \param stream_id ID of the stream
+  /// \param stats Output parameter for the statistics
+  /// \return true if the stream exists
+  ///
+  bool get_stream_stats(const int& stream_id, FilterStreamStats* stats);
+
+  ///
+  /// \brief get_num_threads
+  /// \return Number of worker threads
+  ///
+  unsigned int get_num_threads() const;
+
+  ///
+  /// \brief get_num_steals
+  /// \return Number of tasks that were executed by a worker other than the one it was scheduled on
+  ///
+  uint64_t get_num_steals() const;
+
+  size_t max_batch_size_{ 64 };  ///< Max number of measurements processed per task before the stream is rescheduled
+
+private:
+  struct PendingMeasurement
+  {
+    std::shared_ptr<SensorAbsClass> sensor_;
+    Time timestamp_;
+    BufferDataType data_;
+    Clock::time_point submit_time_;
+  };
+
+  struct Stream
+  {
+    std::shared_ptr<CoreLogic> core_logic_;
+    std::mutex mutex_;  ///< Guards 'queue_', 'scheduled_' and 'stats_'
+    std::deque<PendingMeasurement> queue_;
+    bool scheduled_{ false };  ///< true while the stream is in a task queue or executed
+    FilterStreamStats stats_;
+  };
+
+  struct Worker
+  {
+    std::mutex mutex_;
+    std::deque<Stream*> tasks_;
+  };
+
+  void Schedule(Stream* stream, const size_t& worker_idx);
+  bool PopTask(const size_t& worker_idx, Stream** stream);
+  void RunStream(Stream* stream, const size_t& worker_idx);
+  void WorkerLoop(const size_t& worker_idx);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+
+  std::mutex streams_mutex_;
+  std::map<int, std::unique_ptr<Stream>> streams_;
+
+  std::mutex wake_mutex_;
+  std::condition_variable wake_cv_;  ///< Signals new tasks to idle workers
+  std::condition_variable idle_cv_;  ///< Signals that all measurements were processed
+  size_t num_queued_tasks_{ 0 };     ///< Guarded by 'wake_mutex_'
+  size_t num_pending_meas_{ 0 };     ///< Guarded by 'wake_mutex_'
+  bool stop_{ false };               ///< Guarded by 'wake_mutex_'
+
+  std::atomic<size_t> next_worker_{ 0 };
+  std::atomic<uint64_t> num_steals_{ 0 };
+};
+}  // namespace mars
+
+#endif  // FILTER_SERVER_H
@@ -0,0 +1,148 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef FIXED_LAG_SMOOTHER_H
+#define FIXED_LAG_SMOOTHER_H
+
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/state_observer.h>
+#include <mars/time.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <mars/type_definitions/core_state_type.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace mars
+{
+/// Called by the smoother thread with a copy of the buffer entry whose core state was replaced by the smoothed state
+using SmoothedStateCallback = std::function<void(const BufferEntryType& smoothed_entry)>;
+
+///
+/// \brief The FixedLagSmoother class runs a Rauch-Tung-Striebel backward pass over the core states on its own thread
+///
+/// The filter thread only hands the produced states to a lock-free queue, see get_observer. The smoother thread keeps
+/// a window of the received states, replaces states that were reworked and publishes the smoothed core state of each
+/// entry once the newest state is at least 'lag_' seconds ahead of it.
+///
+/// The backward pass uses the states, covariances and 'state_transition_' of the buffer entries. Entries of the
+/// propagation sensor carry the predicted covariance and the transition from the previous entry, entries of update
+/// sensors are corrections of the previous state without a transition. Sensor states are passed through.
+///
+/// \note Intermediate propagation entries (CoreLogic::add_interm_buffer_entries_) are not published to observers and
+/// are therefore not part of the smoothed chain.
+///
+class FixedLagSmoother
+{
+public:
+  ///
+  /// \brief FixedLagSmoother
+  /// \param lag Time [s] between the newest state and the published smoothed state
+  /// \param queue_capacity Capacity of the queue between the filter and the smoother thread
+  ///
+  FixedLagSmoother(const double& lag, const size_t& queue_capacity = 4096);
+  ~FixedLagSmoother();
+
+  FixedLagSmoother(const FixedLagSmoother&) = delete;
+  FixedLagSmoother& operator=(const FixedLagSmoother&) = delete;
+
+  ///
+  /// \brief get_observer Observer for CoreLogic::AddStateObserver, forwards the states to the smoother thread
+  ///
+  StateObserver get_observer();
+
+  ///
+  /// \brief Push Hands a state to the smoother, called by the filter thread
+  /// \return false if the queue is full and the state was dropped
+  ///
+  bool Push(const BufferEntryType& entry, const bool& is_correction);
+
+  ///
+  /// \brief Start Starts the smoother thread
+  /// \return false if the thread is already running
+  ///
+  bool Start();
+
+  ///
+  /// \brief Stop Stops the smoother thread, queued states are processed before the thread ends
+  ///
+  void Stop();
+
+  bool IsRunning() const;
+
+  ///
+  /// \brief ProcessPending Moves the queued states into the window and publishes the states which reached the lag
+  ///
+  /// Called by the smoother thread. Can be called directly for offline use if the thread was not started.
+  ///
+  /// \return Number of published smoothed states
+  ///
+  int ProcessPending();
+
+  ///
+  /// \brief Flush Smooths and publishes all states of the window, independent of the lag
+  /// \return Number of published smoothed states
+  ///
+  int Flush();
+
+  uint64_t get_num_smoothed() const;
+
+  ///
+  /// \brief get_num_dropped
+  /// \return Number of states which were dropped because the queue was full
+  ///
+  uint64_t get_num_dropped() const;
+
+  ///
+  /// \brief get_num_late_corrections
+  /// \return Number of reworked states older than the last published state, these can not be smoothed again
+  ///
+  uint64_t get_num_late_corrections() const;
+
+  std::shared_ptr<SensorAbsClass> propagation_sensor_{ nullptr };  ///< Entries of this sensor carry a transition
+  double lag_;                                                      ///< Smoothing lag [s]
+  int cpu_{ -1 };                                                  ///< Core for the smoother thread, -1 to not pin
+  std::chrono::microseconds idle_period_{ 1000 };  ///< Sleep time of the smoother thread if the queue is empty
+  SmoothedStateCallback callback_{ nullptr };      ///< Optional, called for each smoothed state
+  std::shared_ptr<StateEventQueue> output_queue_{ nullptr };  ///< Optional, fed with each smoothed state
+
+private:
+  ///
+  /// \brief AddToWindow Appends a state, states at and after the timestamp of a reworked state are replaced
+  ///
+  void AddToWindow(const BufferEntryType& entry, const bool& is_correction);
+
+  ///
+  /// \brief SmoothAndPublish Runs the backward pass over the window and publishes the first 'num_publish' entries
+  ///
+  int SmoothAndPublish(const int& num_publish);
+
+  bool IsPropagationEntry(const BufferEntryType& entry) const;
+
+  void Loop();
+
+  StateEventQueue input_queue_;
+  std::deque<BufferEntryType> window_;  ///< Received states in time order, only used by the smoother thread
+  Time last_published_{ -1 };
+  bool has_published_{ false };
+
+  std::thread thread_;
+  std::atomic<bool> running_{ false };
+  std::atomic<bool> stop_{ false };
+  std::atomic<uint64_t> num_smoothed_{ 0 };
+  std::atomic<uint64_t> num_late_corrections_{ 0 };
+};
+}  // namespace mars
+
+#endif  // FIXED_LAG_SMOOTHER_H
@@ -0,0 +1,160 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <mars/ekf.h>
+#include <mars/measurement_journal.h>
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/time.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <mars/type_definitions/flight_recorder_layout.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief Post mortem view of a flight recorder file
+///
+struct FlightRecording
+{
+  std::vector<std::string> sensor_names_;      ///< Names of the registered sensors, indexed by the sensor id
+  std::vector<flight::FlightRecord> records_;  ///< Consistent records, ordered from the oldest to the newest
+  uint64_t write_count_{ 0 };                  ///< Number of records written over the lifetime of the file
+  int num_torn_{ 0 };                          ///< Number of slots which were interrupted during the write
+};
+
+///
+/// \brief The FlightRecorder class mirrors the latest measurements, states and update decisions into a file backed ring
+///
+/// The ring is a MAP_SHARED mapping of a regular file. Records are plain stores into the page cache, the kernel writes
+/// the dirty pages back on its own. The content therefore survives a crash of the process without any flush or system
+/// call in the filter thread. A crash of the operating system or a power loss can still lose the pages which were not
+/// written back yet.
+///
+class FlightRecorder
+{
+public:
+  ///
+  /// \brief FlightRecorder
+  /// \param file_name Path of the recorder file
+  /// \param num_slots Number of ring slots, see get_num_slots_for_duration
+  ///
+  FlightRecorder(std::string file_name, const uint32_t& num_slots = 8192);
+  ~FlightRecorder();
+
+  FlightRecorder(const FlightRecorder&) = delete;
+  FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+  ///
+  /// \brief get_num_slots_for_duration Ring size that keeps at least the given history
+  ///
+  /// Each propagation step writes a measurement and a state record, each update writes a measurement, an update and a
+  /// state record.
+  ///
+  /// \param duration History to keep [s]
+  /// \param propagation_rate Rate of the propagation sensor [Hz]
+  /// \param update_rate Sum of the rates of all update sensors [Hz]
+  /// \return Number of ring slots
+  ///
+  static uint32_t get_num_slots_for_duration(const double& duration, const double& propagation_rate,
+                                             const double& update_rate);
+
+  ///
+  /// \brief RegisterSensor Adds a sensor with a readable name to the file header
+  /// \param sensor Sensor handle
+  /// \param encoder Optional function to flatten the measurements of the sensor, only timestamps are recorded without
+  /// \return Sensor id used in the records, -1 if the max number of sensors is reached
+  ///
+  int RegisterSensor(const std::shared_ptr<SensorAbsClass>& sensor, JournalEncoder encoder = nullptr);
+
+  ///
+  /// \brief Open Creates the recorder file and maps it to memory
+  /// \return true if the recorder is ready for recording, false otherwise
+  ///
+  bool Open();
+
+  ///
+  /// \brief Close Unmaps the file, the file itself is kept for the analysis
+  ///
+  void Close();
+
+  bool IsOpen() const;
+
+  ///
+  /// \brief RecordMeasurement Records one ProcessMeasurement call
+  ///
+  void RecordMeasurement(const SensorAbsClass* sensor, const Time& timestamp, const BufferDataType& data);
+
+  ///
+  /// \brief RecordState Records the core state and covariance diagonal of a buffer entry
+  /// \param entry Buffer entry, ignored if it has no core state
+  /// \param is_correction True if the state was generated by a buffer rework
+  ///
+  void RecordState(const BufferEntryType& entry, const bool& is_correction);
+
+  ///
+  /// \brief RecordUpdate Records the decision of a sensor update
+  /// \param sensor Sensor handle
+  /// \param timestamp Measurement timestamp
+  /// \param chi2 Chi2 test of the sensor, nullptr if the sensor has no test
+  /// \param nearest_cov_corrected True if the prior covariance was corrected by NearestCov
+  /// \param successful True if the update was successful
+  ///
+  void RecordUpdate(const SensorAbsClass* sensor, const Time& timestamp, const Chi2* chi2,
+                    const bool& nearest_cov_corrected, const bool& successful);
+
+  ///
+  /// \brief get_write_count
+  /// \return Number of records, 0 if the recorder is not open
+  ///
+  uint64_t get_write_count() const;
+
+  ///
+  /// \brief Load Reads a recorder file, e.g. after a crash of the recording process
+  /// \param file_name Path of the recorder file
+  /// \param recording Output parameter
+  /// \return true if the file exists and the layout version matches
+  ///
+  static bool Load(const std::string& file_name, FlightRecording* recording);
+
+private:
+  struct RegisteredSensor
+  {
+    const SensorAbsClass* sensor;
+    JournalEncoder encoder;
+  };
+
+  int FindSensorId(const SensorAbsClass* sensor) const;
+
+  ///
+  /// \brief BeginRecord Marks the next slot as being written
+  /// \return Record of the slot, the record is published with EndRecord
+  ///
+  flight::FlightRecord* BeginRecord(const double& timestamp, const int& sensor_id, const flight::RecordType& type);
+  void EndRecord();
+
+  std::string file_name_;
+  uint32_t num_slots_;
+  size_t file_size_{ 0 };
+  std::vector<RegisteredSensor> sensors_;
+
+  void* mapping_{ nullptr };
+  flight::FlightRecorderHeader* header_{ nullptr };
+  flight::FlightRecordSlot* slots_{ nullptr };
+  uint64_t count_{ 0 };  ///< Count of the record that is currently written
+};
+}  // namespace mars
+
+#endif  // FLIGHT_RECORDER_H
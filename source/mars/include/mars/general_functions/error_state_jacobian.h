@@ -0,0 +1,247 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef ERROR_STATE_JACOBIAN_H
+#define ERROR_STATE_JACOBIAN_H
+
+#include <mars/core_state_kernels.h>
+#include <mars/general_functions/jet.h>
+#include <mars/type_definitions/core_state_type.h>
+#include <Eigen/Dense>
+
+namespace mars
+{
+///
+/// \brief JetValue Returns the value of a scalar without derivatives
+///
+inline double JetValue(const double& x)
+{
+  return x;
+}
+
+template <int N>
+inline double JetValue(const Jet<N>& x)
+{
+  return x.a;
+}
+
+///
+/// \brief QuaternionProduct Product q_a * q_b of a constant quaternion and a quaternion of scalar type T
+///
+/// Multiplies the coefficients of q_a as doubles instead of promoting them to T, for Jets this skips the products with
+/// their zero derivatives.
+///
+template <typename T>
+inline Eigen::Quaternion<T> QuaternionProduct(const Eigen::Quaterniond& q_a, const Eigen::Quaternion<T>& q_b)
+{
+  return Eigen::Quaternion<T>(q_a.w() * q_b.w() - q_a.x() * q_b.x() - q_a.y() * q_b.y() - q_a.z() * q_b.z(),
+                              q_a.w() * q_b.x() + q_a.x() * q_b.w() + q_a.y() * q_b.z() - q_a.z() * q_b.y(),
+                              q_a.w() * q_b.y() - q_a.x() * q_b.z() + q_a.y() * q_b.w() + q_a.z() * q_b.x(),
+                              q_a.w() * q_b.z() + q_a.x() * q_b.y() - q_a.y() * q_b.x() + q_a.z() * q_b.w());
+}
+
+///
+/// \brief BoxPlusQuaternion Applies a small angle error state to a quaternion, q * [1, d_theta / 2]
+///
+/// Matches Utils::ApplySmallAngleQuatCorr to first order, which is sufficient for the Jacobians.
+///
+template <typename T>
+inline Eigen::Quaternion<T> BoxPlusQuaternion(const Eigen::Quaterniond& q, const Eigen::Matrix<T, 3, 1>& d_theta)
+{
+  const Eigen::Quaternion<T> dq(T(1), T(0.5) * d_theta(0), T(0.5) * d_theta(1), T(0.5) * d_theta(2));
+  return QuaternionProduct<T>(q, dq);
+}
+
+///
+/// \brief QuaternionLocalError Returns the small angle error 2 * vec(q_0^-1 * q) / w(q_0^-1 * q) of q w.r.t. its own
+/// value q_0
+///
+/// The result is zero and its derivatives are the derivatives of the rotation in the local frame of q_0. This is the
+/// parameterization of the orientation residuals of the sensor models.
+///
+template <typename T>
+inline Eigen::Matrix<T, 3, 1> QuaternionLocalError(const Eigen::Quaternion<T>& q)
+{
+  const Eigen::Quaterniond q_0(JetValue(q.w()), JetValue(q.x()), JetValue(q.y()), JetValue(q.z()));
+  const Eigen::Quaternion<T> q_err = QuaternionProduct<T>(q_0.conjugate(), q);
+  return T(2) * q_err.vec() / q_err.w();
+}
+
+///
+/// \brief CoreErrorBlock Flags for the blocks of three core error states a sensor model depends on
+///
+enum CoreErrorBlock : unsigned
+{
+  kCoreErrorPosition = 1 << 0,     ///< p_wi, error states 0:2
+  kCoreErrorVelocity = 1 << 1,     ///< v_wi, error states 3:5
+  kCoreErrorOrientation = 1 << 2,  ///< q_wi, error states 6:8
+  kCoreErrorBiasGyro = 1 << 3,     ///< b_w, error states 9:11
+  kCoreErrorBiasAcc = 1 << 4,      ///< b_a, error states 12:14
+  kCoreErrorAll = 0x1f
+};
+
+///
+/// \brief CoreErrorBlockCount Number of blocks set in 'blocks'
+///
+constexpr int CoreErrorBlockCount(const unsigned blocks)
+{
+  return blocks == 0 ? 0 : static_cast<int>(blocks & 1u) + CoreErrorBlockCount(blocks >> 1);
+}
+
+///
+/// \brief The ErrorStateJacobian class generates the measurement Jacobian of a sensor model w.r.t. the error states
+///
+/// The sensor model only implements its measurement function for a generic scalar type:
+///
+///   struct Model
+///   {
+///     static constexpr int kMeasurementSize;   // Rows of the Jacobian
+///     static constexpr int kSensorErrorSize;   // Sensor error states
+///     static constexpr unsigned kCoreErrorBlocks;  // CoreErrorBlock flags of the core states used by Predict
+///     using SensorState = ...;                 // Sensor state type of the filter
+///     template <typename T> struct SensorStorage;
+///     // Sensor state with the error state 'delta' applied
+///     template <typename T> static SensorStorage<T> BoxPlus(const SensorState&,
+///                                                           const Eigen::Matrix<T, kSensorErrorSize, 1>&);
+///     // Predicted measurement, orientations are expressed with QuaternionLocalError
+///     template <typename T> static Eigen::Matrix<T, kMeasurementSize, 1> Predict(const CoreStateStorage<T>&,
+///                                                                             const SensorStorage<T>&);
+///   };
+///
+/// Evaluate applies a zero error state with one Jet derivative per used core error state and per sensor error state
+/// and evaluates the measurement function once. The derivative part of the result is scattered into the Jacobian
+/// H = [dh/d_core, dh/d_sensor], the columns of the unused core blocks are zero. Seeding only the used states keeps
+/// the Jets small, e.g. 12 instead of 21 derivatives for the pose model. All sizes are compile time constants, no
+/// dynamic memory is used.
+///
+template <typename Model>
+class ErrorStateJacobian
+{
+public:
+  static constexpr int kCoreSize = CoreStateType::size_error_;
+  static constexpr int kSensorSize = Model::kSensorErrorSize;
+  static constexpr int kSize = kCoreSize + kSensorSize;
+  static constexpr int kMeasurementSize = Model::kMeasurementSize;
+  static constexpr unsigned kCoreBlocks = Model::kCoreErrorBlocks;
+  static constexpr int kSeededCoreSize = 3 * CoreErrorBlockCount(kCoreBlocks);
+  static constexpr int kSeededSize = kSeededCoreSize + kSensorSize;
+
+  using JetType = Jet<kSeededSize>;
+  using Jacobian = Eigen::Matrix<double, kMeasurementSize, kSize>;
+  using Measurement = Eigen::Matrix<double, kMeasurementSize, 1>;
+
+  ///
+  /// \brief Evaluate
+  /// \param core_state Core state at which the Jacobian is evaluated
+  /// \param sensor_state Sensor state at which the Jacobian is evaluated
+  /// \param prediction Output for the predicted measurement, can be nullptr
+  /// \param jacobian Output for the Jacobian, column order [core error states, sensor error states]
+  ///
+  static void Evaluate(const CoreStateType& core_state, const typename Model::SensorState& sensor_state,
+                       Measurement* prediction, Jacobian* jacobian)
+  {
+    // Zero error state, derivatives only for the used core blocks and the sensor states
+    Eigen::Matrix<JetType, kCoreSize, 1> core_delta;
+    int seeded = 0;
+    for (int block = 0; block < kCoreSize / 3; block++)
+    {
+      for (int k = 0; k < 3; k++)
+      {
+        core_delta(3 * block + k) = UsesCoreBlock(block) ? JetType(0, seeded++) : JetType(0);
+      }
+    }
+
+    Eigen::Matrix<JetType, kSensorSize, 1> sensor_delta;
+    for (int k = 0; k < kSensorSize; k++)
+    {
+      sensor_delta(k) = JetType(0, kSeededCoreSize + k);
+    }
+
+    const Eigen::Matrix<JetType, kMeasurementSize, 1> result = Model::template Predict<JetType>(
+        BoxPlusCore(core_state, core_delta), Model::template BoxPlus<JetType>(sensor_state, sensor_delta));
+
+    Eigen::Matrix<double, kMeasurementSize, kSeededSize> seeded_jacobian;
+    for (int k = 0; k < kMeasurementSize; k++)
+    {
+      if (prediction != nullptr)
+      {
+        (*prediction)(k) = result(k).a;
+      }
+      seeded_jacobian.row(k) = result(k).v.transpose();
+    }
+
+    // Scatter the seeded columns into the full Jacobian
+    seeded = 0;
+    for (int block = 0; block < kCoreSize / 3; block++)
+    {
+      if (UsesCoreBlock(block))
+      {
+        jacobian->template middleCols<3>(3 * block) = seeded_jacobian.template middleCols<3>(seeded);
+        seeded += 3;
+      }
+      else
+      {
+        jacobian->template middleCols<3>(3 * block).setZero();
+      }
+    }
+    jacobian->template rightCols<kSensorSize>() = seeded_jacobian.template rightCols<kSensorSize>();
+  }
+
+  ///
+  /// \brief UsesCoreBlock True if the model depends on the core error state block 'block' (0 = p_wi, ..., 4 = b_a)
+  ///
+  static constexpr bool UsesCoreBlock(const int block)
+  {
+    return ((kCoreBlocks >> block) & 1u) != 0;
+  }
+
+  ///
+  /// \brief BoxPlusCore Applies the error state 'delta' to the core state
+  /// \param delta order [p_wi(0:2), v_wi(3:5), q_wi(6:8), b_w(9:11), b_a(12:14)]
+  ///
+  template <typename T>
+  static CoreStateStorage<T> BoxPlusCore(const CoreStateType& state, const Eigen::Matrix<T, kCoreSize, 1>& delta)
+  {
+    CoreStateStorage<T> result;
+    result.p_wi_ = state.p_wi_.cast<T>();
+    result.v_wi_ = state.v_wi_.cast<T>();
+    result.q_wi_ = state.q_wi_.cast<T>();
+    result.b_w_ = state.b_w_.cast<T>();
+    result.b_a_ = state.b_a_.cast<T>();
+
+    // The unused blocks of the error state are zero, only the used ones are applied
+    if (UsesCoreBlock(0))
+    {
+      result.p_wi_ += delta.template segment<3>(0);
+    }
+    if (UsesCoreBlock(1))
+    {
+      result.v_wi_ += delta.template segment<3>(3);
+    }
+    if (UsesCoreBlock(2))
+    {
+      result.q_wi_ = BoxPlusQuaternion<T>(state.q_wi_, delta.template segment<3>(6));
+    }
+    if (UsesCoreBlock(3))
+    {
+      result.b_w_ += delta.template segment<3>(9);
+    }
+    if (UsesCoreBlock(4))
+    {
+      result.b_a_ += delta.template segment<3>(12);
+    }
+    result.w_m_ = state.w_m_.cast<T>();
+    result.a_m_ = state.a_m_.cast<T>();
+    return result;
+  }
+};
+}  // namespace mars
+
+#endif  // ERROR_STATE_JACOBIAN_H
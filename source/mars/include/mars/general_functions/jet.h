@@ -0,0 +1,365 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef JET_H
+#define JET_H
+
+#include <Eigen/Core>
+#include <cmath>
+#include <limits>
+
+namespace mars
+{
+///
+/// \brief The Jet struct is a dual number for forward mode automatic differentiation
+///
+/// A Jet holds the value 'a' and the partial derivatives 'v' w.r.t. N input variables. All arithmetic operations and
+/// the supported functions apply the chain rule to 'v'. The number of derivatives is a template parameter, all
+/// operations are therefore fixed size and inlined, and Jets can be used as scalar type of Eigen matrices and
+/// quaternions.
+///
+template <int N>
+struct Jet
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  using Derivatives = Eigen::Matrix<double, N, 1>;
+
+  double a;       ///< Value
+  Derivatives v;  ///< Partial derivatives
+
+  Jet() : a(0)
+  {
+    v.setZero();
+  }
+
+  ///
+  /// \brief Jet Constant value without derivatives
+  ///
+  Jet(const double& value) : a(value)
+  {
+    v.setZero();
+  }
+
+  ///
+  /// \brief Jet Input variable 'k' with derivative 1 w.r.t. itself
+  ///
+  Jet(const double& value, const int& k) : a(value)
+  {
+    v.setZero();
+    v[k] = 1;
+  }
+
+  Jet(const double& value, const Derivatives& derivatives) : a(value), v(derivatives)
+  {
+  }
+
+  Jet& operator+=(const Jet& rhs)
+  {
+    a += rhs.a;
+    v += rhs.v;
+    return *this;
+  }
+
+  Jet& operator-=(const Jet& rhs)
+  {
+    a -= rhs.a;
+    v -= rhs.v;
+    return *this;
+  }
+
+  Jet& operator*=(const Jet& rhs)
+  {
+    v = a * rhs.v + rhs.a * v;
+    a *= rhs.a;
+    return *this;
+  }
+
+  Jet& operator/=(const Jet& rhs)
+  {
+    const double inv = 1 / rhs.a;
+    a *= inv;
+    v = (v - a * rhs.v) * inv;
+    return *this;
+  }
+};
+
+// Arithmetic operators
+
+template <int N>
+inline Jet<N> operator+(const Jet<N>& f)
+{
+  return f;
+}
+
+template <int N>
+inline Jet<N> operator-(const Jet<N>& f)
+{
+  return Jet<N>(-f.a, -f.v);
+}
+
+template <int N>
+inline Jet<N> operator+(const Jet<N>& f, const Jet<N>& g)
+{
+  return Jet<N>(f.a + g.a, f.v + g.v);
+}
+
+template <int N>
+inline Jet<N> operator+(const Jet<N>& f, const double& s)
+{
+  return Jet<N>(f.a + s, f.v);
+}
+
+template <int N>
+inline Jet<N> operator+(const double& s, const Jet<N>& f)
+{
+  return Jet<N>(f.a + s, f.v);
+}
+
+template <int N>
+inline Jet<N> operator-(const Jet<N>& f, const Jet<N>& g)
+{
+  return Jet<N>(f.a - g.a, f.v - g.v);
+}
+
+template <int N>
+inline Jet<N> operator-(const Jet<N>& f, const double& s)
+{
+  return Jet<N>(f.a - s, f.v);
+}
+
+template <int N>
+inline Jet<N> operator-(const double& s, const Jet<N>& f)
+{
+  return Jet<N>(s - f.a, -f.v);
+}
+
+template <int N>
+inline Jet<N> operator*(const Jet<N>& f, const Jet<N>& g)
+{
+  return Jet<N>(f.a * g.a, f.a * g.v + g.a * f.v);
+}
+
+template <int N>
+inline Jet<N> operator*(const Jet<N>& f, const double& s)
+{
+  return Jet<N>(f.a * s, f.v * s);
+}
+
+template <int N>
+inline Jet<N> operator*(const double& s, const Jet<N>& f)
+{
+  return Jet<N>(f.a * s, f.v * s);
+}
+
+template <int N>
+inline Jet<N> operator/(const Jet<N>& f, const Jet<N>& g)
+{
+  // d(f/g) = (df - f/g dg) / g
+  const double g_inv = 1 / g.a;
+  const double f_div_g = f.a * g_inv;
+  return Jet<N>(f_div_g, (f.v - f_div_g * g.v) * g_inv);
+}
+
+template <int N>
+inline Jet<N> operator/(const Jet<N>& f, const double& s)
+{
+  const double s_inv = 1 / s;
+  return Jet<N>(f.a * s_inv, f.v * s_inv);
+}
+
+template <int N>
+inline Jet<N> operator/(const double& s, const Jet<N>& g)
+{
+  const double g_inv = 1 / g.a;
+  return Jet<N>(s * g_inv, -s * g_inv * g_inv * g.v);
+}
+
+// Comparisons only consider the value
+
+#define MARS_JET_COMPARISON_OPERATOR(op)                                                                               \
+  template <int N>                                                                                                     \
+  inline bool operator op(const Jet<N>& f, const Jet<N>& g)                                                            \
+  {                                                                                                                    \
+    return f.a op g.a;                                                                                                 \
+  }                                                                                                                    \
+  template <int N>                                                                                                     \
+  inline bool operator op(const Jet<N>& f, const double& s)                                                            \
+  {                                                                                                                    \
+    return f.a op s;                                                                                                   \
+  }                                                                                                                    \
+  template <int N>                                                                                                     \
+  inline bool operator op(const double& s, const Jet<N>& g)                                                            \
+  {                                                                                                                    \
+    return s op g.a;                                                                                                   \
+  }
+
+MARS_JET_COMPARISON_OPERATOR(<)
+MARS_JET_COMPARISON_OPERATOR(<=)
+MARS_JET_COMPARISON_OPERATOR(>)
+MARS_JET_COMPARISON_OPERATOR(>=)
+MARS_JET_COMPARISON_OPERATOR(==)
+MARS_JET_COMPARISON_OPERATOR(!=)
+
+#undef MARS_JET_COMPARISON_OPERATOR
+
+// Functions, found by argument dependent lookup from generic and Eigen code
+
+template <int N>
+inline Jet<N> abs(const Jet<N>& f)
+{
+  return f.a < 0 ? -f : f;
+}
+
+template <int N>
+inline Jet<N> sqrt(const Jet<N>& f)
+{
+  const double tmp = std::sqrt(f.a);
+  return Jet<N>(tmp, f.v * (0.5 / tmp));
+}
+
+template <int N>
+inline Jet<N> exp(const Jet<N>& f)
+{
+  const double tmp = std::exp(f.a);
+  return Jet<N>(tmp, tmp * f.v);
+}
+
+template <int N>
+inline Jet<N> log(const Jet<N>& f)
+{
+  return Jet<N>(std::log(f.a), f.v / f.a);
+}
+
+template <int N>
+inline Jet<N> sin(const Jet<N>& f)
+{
+  return Jet<N>(std::sin(f.a), std::cos(f.a) * f.v);
+}
+
+template <int N>
+inline Jet<N> cos(const Jet<N>& f)
+{
+  return Jet<N>(std::cos(f.a), -std::sin(f.a) * f.v);
+}
+
+template <int N>
+inline Jet<N> tan(const Jet<N>& f)
+{
+  const double tmp = std::tan(f.a);
+  return Jet<N>(tmp, (1 + tmp * tmp) * f.v);
+}
+
+template <int N>
+inline Jet<N> asin(const Jet<N>& f)
+{
+  return Jet<N>(std::asin(f.a), f.v / std::sqrt(1 - f.a * f.a));
+}
+
+template <int N>
+inline Jet<N> acos(const Jet<N>& f)
+{
+  return Jet<N>(std::acos(f.a), -f.v / std::sqrt(1 - f.a * f.a));
+}
+
+template <int N>
+inline Jet<N> atan2(const Jet<N>& y, const Jet<N>& x)
+{
+  // d atan2(y, x) = (x dy - y dx) / (x^2 + y^2)
+  const double tmp = 1 / (x.a * x.a + y.a * y.a);
+  return Jet<N>(std::atan2(y.a, x.a), tmp * (x.a * y.v - y.a * x.v));
+}
+
+template <int N>
+inline Jet<N> pow(const Jet<N>& f, const double& g)
+{
+  const double tmp = g * std::pow(f.a, g - 1);
+  return Jet<N>(std::pow(f.a, g), tmp * f.v);
+}
+
+template <int N>
+inline bool isfinite(const Jet<N>& f)
+{
+  return std::isfinite(f.a) && f.v.allFinite();
+}
+}  // namespace mars
+
+namespace Eigen
+{
+template <int N>
+struct NumTraits<mars::Jet<N>>
+{
+  using Real = mars::Jet<N>;
+  using NonInteger = mars::Jet<N>;
+  using Nested = mars::Jet<N>;
+  using Literal = mars::Jet<N>;
+
+  static inline Real dummy_precision()
+  {
+    return Real(1e-12);
+  }
+
+  static inline Real epsilon()
+  {
+    return Real(std::numeric_limits<double>::epsilon());
+  }
+
+  static inline Real highest()
+  {
+    return Real(std::numeric_limits<double>::max());
+  }
+
+  static inline Real lowest()
+  {
+    return Real(-std::numeric_limits<double>::max());
+  }
+
+  static inline int digits10()
+  {
+    return NumTraits<double>::digits10();
+  }
+
+  enum
+  {
+    IsComplex = 0,
+    IsInteger = 0,
+    IsSigned = 1,
+    ReadCost = 1,
+    AddCost = 1,
+    MulCost = 3,
+    HasFloatingPoint = 1,
+    RequireInitialization = 1
+  };
+
+  template <bool Vectorized>
+  struct Div
+  {
+    enum
+    {
+      AVX = false,
+      Cost = 3
+    };
+  };
+};
+
+template <int N, typename BinaryOp>
+struct ScalarBinaryOpTraits<mars::Jet<N>, double, BinaryOp>
+{
+  using ReturnType = mars::Jet<N>;
+};
+
+template <int N, typename BinaryOp>
+struct ScalarBinaryOpTraits<double, mars::Jet<N>, BinaryOp>
+{
+  using ReturnType = mars::Jet<N>;
+};
+}  // namespace Eigen
+
+#endif  // JET_H
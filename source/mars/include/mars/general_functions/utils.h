@@ -13,6 +13,7 @@
 
 #include <mars/sensors/imu/imu_measurement_type.h>
 #include <Eigen/Dense>
+#include <iostream>
 #include <string>
 #include <vector>
 
@@ -115,12 +116,46 @@ public:
 
   ///
   /// \brief check_cov Performs tests for the properties of a given covariance matrix
+  ///
+  /// The decompositions use the matrix type of 'cov_mat', fixed size covariances are checked without an allocation.
+  ///
   /// \param cov_mat
   /// \param description Used to associate the warning with the given covariance
   /// \param check_cond Check the condition number of the covariance matrix
   /// \return true if the covariance matrix is valid, false otherwise
   ///
-  static bool CheckCov(const Eigen::MatrixXd& cov_mat, const std::string& description, const bool& check_cond = false);
+  template <typename Derived>
+  static bool CheckCov(const Eigen::MatrixBase<Derived>& cov_mat, const std::string& description,
+                       const bool& /*check_cond*/ = false)
+  {
+    using MatrixType = typename Derived::PlainObject;
+    bool result = true;
+
+    bool is_symmetric = MatrixType::Zero(cov_mat.rows(), cov_mat.cols()).isApprox(cov_mat - cov_mat.transpose());
+    if (!is_symmetric)
+    {
+      std::cout << "Warning: [" << description << "]: The covariance matrix is not symmetric" << std::endl;
+      result = false;
+    }
+
+    double det = cov_mat.determinant();
+    if (det <= 0)
+    {
+      std::cout << "Warning: [" << description << "]: The determinant of the covariance matrix is not positive ("
+                << det << ")" << std::endl;
+      result = false;
+    }
+
+    double min_eigenvalue = Eigen::EigenSolver<MatrixType>(cov_mat).eigenvalues().real().minCoeff();
+    if (min_eigenvalue < 0)
+    {
+      std::cout << "Warning: [" << description << "]: The covariance matrix is not positive semidefinite min: "
+                << min_eigenvalue << std::endl;
+      result = false;
+    }
+
+    return result;
+  }
 
   ///
   /// \brief EnforceMatrixSymmetry
@@ -129,6 +164,11 @@ public:
   ///
   static Eigen::MatrixXd EnforceMatrixSymmetry(const Eigen::Ref<const Eigen::MatrixXd>& mat_in);
 
+  ///
+  /// \brief EnforceMatrixSymmetry Replaces 'mat' with (mat + mat^T) / 2 in place, without a temporary matrix
+  ///
+  static void EnforceMatrixSymmetry(Eigen::MatrixXd* mat);
+
   ///
   /// \brief quaternionAverage without weights
   /// \param quats vector of quaternion being averaged
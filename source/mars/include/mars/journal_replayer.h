@@ -0,0 +1,119 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef JOURNAL_REPLAYER_H
+#define JOURNAL_REPLAYER_H
+
+#include <mars/core_logic.h>
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/type_definitions/buffer_data_type.h>
+#include <mars/type_definitions/journal_record.h>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief Function to restore a measurement from the journal payload
+///
+/// \param values Payload values
+/// \param size Number of payload values
+/// \return Measurement for ProcessMeasurement, nullptr if the payload is invalid
+///
+using JournalDecoder = std::function<std::shared_ptr<void>(const double* values, int size)>;
+
+///
+/// \brief One journaled ProcessMeasurement call
+///
+struct JournalEntry
+{
+  int sensor_id{ -1 };                                ///< Sensor id in the journal
+  std::string sensor_name;                            ///< Name of the sensor at the time of recording
+  std::shared_ptr<SensorAbsClass> sensor{ nullptr };  ///< Sensor bound with RegisterSensor, nullptr if not bound
+  double timestamp{ 0 };                              ///< Measurement timestamp
+  int64_t arrival_ns{ 0 };                            ///< Arrival time of the original call [ns since epoch]
+  BufferDataType data;                                ///< Decoded measurement, empty if the sensor is not bound
+};
+
+///
+/// \brief The JournalReplayer class reads a measurement journal and reproduces the recorded ProcessMeasurement calls
+///
+/// The sensors of the journal are bound by name to the sensor instances of the replay setup. The calls are reproduced
+/// in the recorded order with the recorded timestamps and payloads. Since all payload values are stored with full
+/// precision, the replayed filter produces the same results as the recorded one.
+///
+class JournalReplayer
+{
+public:
+  ///
+  /// \brief JournalReplayer
+  /// \param file_name Path of the journal file
+  ///
+  JournalReplayer(std::string file_name);
+
+  ///
+  /// \brief Open Opens the journal and reads the sensor table
+  /// \return true if the file is a valid journal, false otherwise
+  ///
+  bool Open();
+
+  ///
+  /// \brief get_sensor_names
+  /// \return Names of the journaled sensors, the index corresponds to the sensor id
+  ///
+  std::vector<std::string> get_sensor_names() const;
+
+  ///
+  /// \brief RegisterSensor Binds a journaled sensor to a sensor instance
+  /// \param name Name of the journaled sensor
+  /// \param sensor Sensor instance used for the replay
+  /// \param decoder Function to restore the measurements of the sensor
+  /// \return true if a sensor with this name exists in the journal
+  ///
+  bool RegisterSensor(const std::string& name, const std::shared_ptr<SensorAbsClass>& sensor,
+                      JournalDecoder decoder);
+
+  ///
+  /// \brief ReadNext Reads the next journaled call
+  /// \param entry Output for the call
+  /// \return false if the end of the journal is reached or the record is incomplete
+  ///
+  bool ReadNext(JournalEntry* entry);
+
+  ///
+  /// \brief Replay Reproduces all remaining journaled calls with the given filter
+  ///
+  /// The calls keep their recorded arrival time. Calls of sensors which are not bound are skipped.
+  ///
+  /// \param core_logic Filter instance
+  /// \return Number of replayed calls
+  ///
+  int Replay(CoreLogic* core_logic);
+
+private:
+  struct JournaledSensor
+  {
+    std::string name;
+    std::shared_ptr<SensorAbsClass> sensor{ nullptr };
+    JournalDecoder decoder;
+  };
+
+  std::string file_name_;
+  std::ifstream file_;
+  std::vector<JournaledSensor> sensors_;
+  std::vector<double> values_;
+};
+}  // namespace mars
+
+#endif  // JOURNAL_REPLAYER_H
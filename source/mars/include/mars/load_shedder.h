@@ -0,0 +1,183 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef LOAD_SHEDDER_H
+#define LOAD_SHEDDER_H
+
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/time.h>
+#include <mars/type_definitions/buffer_data_type.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief Action for measurements which exceed the CPU budget
+///
+enum class ShedMode
+{
+  decimate,  ///< The measurement is dropped
+  defer      ///< The measurement is kept and processed once the budget allows it, or dropped once it expired
+};
+
+///
+/// \brief Load shedding policy of one sensor
+///
+struct LoadSheddingPolicy
+{
+  int priority_{ 0 };                    ///< 0 is never shed, higher values are shed first
+  ShedMode mode_{ ShedMode::decimate };  ///< Action if the budget is exceeded
+  int max_skip_{ 0 };                    ///< Max number of consecutive shed measurements, 0 for no limit
+  double max_defer_age_{ 0.1 };          ///< Max age [s] of deferred measurements w.r.t. the newest measurement
+  double nominal_cost_{ 0 };             ///< Cost [s] for the deterministic mode and prior to the first update
+};
+
+///
+/// \brief Load shedding metrics of one sensor
+///
+struct LoadShedderStats
+{
+  int num_admitted_{ 0 };            ///< Measurements which passed the admission
+  int num_decimated_{ 0 };           ///< Dropped measurements
+  int num_deferred_{ 0 };            ///< Deferred measurements
+  int num_deferred_processed_{ 0 };  ///< Deferred measurements which were processed later
+  int num_expired_{ 0 };             ///< Deferred measurements which expired
+  int num_costs_{ 0 };               ///< Number of cost samples
+  double cost_ema_{ 0 };             ///< Exponential moving average of the processing cost [s]
+  double cost_max_{ 0 };             ///< Max processing cost [s]
+};
+
+///
+/// \brief The LoadShedder class limits the CPU time spent on sensor updates to a configured budget
+///
+/// The CPU budget is modeled as a token bucket in measurement time. Tokens are added with 'cpu_budget_' CPU seconds per
+/// second of measurement time, up to 'burst_window_' seconds of budget. The processing cost of every measurement is
+/// reported by the CoreLogic and removed from the bucket. An update measurement is admitted if the bucket holds its
+/// expected cost plus a reserve for each priority level above 1. Otherwise it is decimated or deferred, depending on
+/// the sensor policy. Measurements of sensors with priority 0 and of the propagation sensor are never shed.
+///
+/// In the deterministic mode the nominal costs of the policies are used instead of the measured costs. All decisions
+/// then only depend on the measurement timestamps and are reproduced exactly on replay, e.g. with the
+/// MeasurementJournal. The measured costs are still reported in the metrics.
+///
+class LoadShedder
+{
+public:
+  LoadShedder();
+
+  ///
+  /// \brief set_policy Sets the load shedding policy of a sensor, sensors without policy are never shed
+  ///
+  void set_policy(const std::shared_ptr<SensorAbsClass>& sensor, const LoadSheddingPolicy& policy);
+
+  ///
+  /// \brief Admit Decides if a measurement is processed now
+  ///
+  /// Measurements which are not admitted are either dropped or stored as deferred, depending on the sensor policy.
+  ///
+  /// \param arrival_ns Arrival time of the measurement, kept with a deferred measurement
+  /// \return true if the measurement should be processed now
+  ///
+  bool Admit(const std::shared_ptr<SensorAbsClass>& sensor, const Time& timestamp, const BufferDataType& data,
+             const int64_t& arrival_ns = 0);
+
+  ///
+  /// \brief ReportCost Reports the processing cost of a measurement
+  /// \param sensor Sensor handle
+  /// \param timestamp Measurement timestamp
+  /// \param cost Measured processing time [s]
+  ///
+  void ReportCost(const std::shared_ptr<SensorAbsClass>& sensor, const Time& timestamp, const double& cost);
+
+  ///
+  /// \brief ReportOverhead Reports processing time which is not caused by a single measurement
+  ///
+  /// The time is removed from the budget, but does not change the cost average of any sensor, e.g. the splice of a
+  /// speculative rework. In the deterministic mode, the overhead is only added to get_overhead.
+  ///
+  /// \param timestamp Timestamp of the newest measurement
+  /// \param cost Measured processing time [s]
+  ///
+  void ReportOverhead(const Time& timestamp, const double& cost);
+
+  ///
+  /// \brief PopDeferred Returns the oldest deferred measurement if the budget allows to process it
+  ///
+  /// Expired measurements are dropped.
+  ///
+  /// \param now Timestamp of the newest measurement
+  /// \param entry Output for the deferred measurement
+  /// \return true if a measurement was returned
+  ///
+  bool PopDeferred(const Time& now, BufferEntryType* entry);
+
+  ///
+  /// \brief get_stats
+  /// \param sensor Sensor handle
+  /// \param stats Output for the sensor metrics
+  /// \return false if no measurement of the sensor was seen
+  ///
+  bool get_stats(const std::shared_ptr<SensorAbsClass>& sensor, LoadShedderStats* stats) const;
+
+  ///
+  /// \brief get_tokens
+  /// \return Current CPU budget in the bucket [s], can be negative after expensive updates
+  ///
+  double get_tokens() const;
+
+  ///
+  /// \brief get_num_pending
+  /// \return Number of deferred measurements
+  ///
+  int get_num_pending() const;
+
+  ///
+  /// \brief get_overhead
+  /// \return Sum of the reported overhead [s], see ReportOverhead
+  ///
+  double get_overhead() const;
+
+  double cpu_budget_{ 0.8 };          ///< CPU seconds available per second of measurement time
+  double burst_window_{ 0.1 };        ///< Max accumulated budget in seconds of measurement time
+  double priority_reserve_{ 0.002 };  ///< Additional budget [s] required per priority level above 1
+  double cost_ema_alpha_{ 0.1 };      ///< Smoothing factor of the cost average
+  int max_pending_{ 32 };             ///< Max number of deferred measurements
+  bool deterministic_{ false };       ///< Use the nominal costs for all decisions
+
+private:
+  struct SensorEntry
+  {
+    std::shared_ptr<SensorAbsClass> sensor;
+    LoadSheddingPolicy policy;
+    LoadShedderStats stats;
+    int num_consecutive_shed{ 0 };
+  };
+
+  SensorEntry* FindSensor(const SensorAbsClass* sensor);
+  const SensorEntry* FindSensor(const SensorAbsClass* sensor) const;
+  SensorEntry* AddSensor(const std::shared_ptr<SensorAbsClass>& sensor);
+
+  void AdvanceTime(const Time& timestamp);
+  bool HasBudget(const SensorEntry& entry) const;
+  double ExpectedCost(const SensorEntry& entry) const;
+
+  std::vector<SensorEntry> sensors_;
+  std::deque<BufferEntryType> pending_;
+  double tokens_{ 0 };
+  double overhead_{ 0 };
+  Time last_time_{ 0 };
+  bool has_time_{ false };
+};
+}  // namespace mars
+
+#endif  // LOAD_SHEDDER_H
@@ -0,0 +1,191 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef MCAP_READER_H
+#define MCAP_READER_H
+
+#include <mars/core_logic.h>
+#include <mars/journal_replayer.h>
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/type_definitions/buffer_data_type.h>
+#include <mars/type_definitions/mcap_record.h>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief One message of an MCAP file
+///
+struct McapMessage
+{
+  int channel_id{ -1 };                               ///< Channel id in the file
+  std::string topic;                                  ///< Topic of the channel
+  std::shared_ptr<SensorAbsClass> sensor{ nullptr };  ///< Sensor bound with RegisterTopic, nullptr if not bound
+  double timestamp{ 0 };                              ///< Log time [s]
+  uint64_t log_time_ns{ 0 };                          ///< Log time [ns]
+  BufferDataType data;                                ///< Decoded message, empty if the topic is not bound
+};
+
+///
+/// \brief The McapReader class streams the messages of an MCAP file in log time order
+///
+/// The file is read chunk by chunk, only the messages of chunks with overlapping time ranges are held in memory. A
+/// message is released once no chunk which has not been read yet can contain an earlier message. The time ranges of
+/// the remaining chunks are taken from the chunk index of the summary section. Without summary section the chunks are
+/// assumed to start in non-decreasing order. Messages with equal log time are released in file order.
+///
+/// Payloads with the message encoding mcap::kMessageEncoding are decoded with the JournalDecoder of the topic (see
+/// data_utils/journal_codecs.h). Other message encodings (e.g. ros1msg or cdr) are not decoded, and compressed chunks
+/// cannot be read since no compression library is linked. Such data is not dropped silently: RegisterTopic rejects
+/// topics with an unsupported encoding, a warning is printed for the first compressed chunk of each compression and
+/// the first undecodable message of each channel, and get_num_skipped_chunks and get_num_undecoded_messages count
+/// all of them. Chunks with a CRC mismatch are skipped and counted as well.
+///
+class McapReader
+{
+public:
+  ///
+  /// \brief McapReader
+  /// \param file_name Path of the MCAP file
+  ///
+  McapReader(std::string file_name);
+
+  ///
+  /// \brief Open Opens the file, reads the header and the summary section
+  /// \return true if the file is a valid MCAP file, false otherwise
+  ///
+  bool Open();
+
+  ///
+  /// \brief get_topics
+  /// \return Topics of the channels known so far, all channels if the file has a summary section
+  ///
+  std::vector<std::string> get_topics() const;
+
+  ///
+  /// \brief RegisterTopic Binds the messages of a topic to a sensor instance
+  /// \param topic Topic name
+  /// \param sensor Sensor instance used for the replay
+  /// \param decoder Function to restore the messages of the topic
+  /// \return false if the channel of the topic is known and has a message encoding which can not be decoded
+  ///
+  bool RegisterTopic(const std::string& topic, const std::shared_ptr<SensorAbsClass>& sensor, JournalDecoder decoder);
+
+  ///
+  /// \brief ReadNext Reads the next message in log time order
+  /// \param message Output for the message
+  /// \return false if all messages have been read
+  ///
+  bool ReadNext(McapMessage* message);
+
+  ///
+  /// \brief Replay Processes all remaining messages of bound topics in log time order
+  /// \param core_logic Filter instance
+  /// \return Number of processed messages
+  ///
+  int Replay(CoreLogic* core_logic);
+
+  ///
+  /// \brief get_num_skipped_chunks
+  /// \return Number of compressed or corrupted chunks which were skipped
+  ///
+  int get_num_skipped_chunks() const;
+
+  ///
+  /// \brief get_num_undecoded_messages
+  /// \return Number of messages of registered topics which were not decoded, due to an unsupported message encoding or
+  /// a malformed payload
+  ///
+  int get_num_undecoded_messages() const;
+
+private:
+  struct Topic
+  {
+    std::shared_ptr<SensorAbsClass> sensor{ nullptr };
+    JournalDecoder decoder;
+  };
+
+  struct Channel
+  {
+    std::string topic;
+    std::string message_encoding;
+  };
+
+  struct PendingMessage
+  {
+    uint64_t log_time;
+    uint64_t order;  ///< Read order, keeps messages with equal log time in file order
+    uint16_t channel_id;
+    std::vector<uint8_t> payload;
+
+    bool operator>(const PendingMessage& rhs) const
+    {
+      return log_time != rhs.log_time ? log_time > rhs.log_time : order > rhs.order;
+    }
+  };
+
+  ///
+  /// \brief ReadRecord Reads the record at the current file position
+  /// \return false at the end of the file or if the record is incomplete
+  ///
+  bool ReadRecord(uint8_t* opcode, std::vector<uint8_t>* content);
+
+  ///
+  /// \brief ReadSummary Reads channels and chunk indices of the summary section, restores the file position
+  ///
+  void ReadSummary();
+
+  ///
+  /// \brief HandleRecord Handles one record of the data section or of a chunk
+  ///
+  void HandleRecord(const uint8_t& opcode, const uint8_t* content, const uint64_t& size);
+
+  void HandleChunk(const uint64_t& offset, const std::vector<uint8_t>& content);
+
+  ///
+  /// \brief ReadUntilReleasable Reads records until the earliest pending message can be released
+  /// \return false if no message is pending
+  ///
+  bool ReadUntilReleasable();
+
+  uint64_t Watermark() const;
+
+  std::string file_name_;
+  std::ifstream file_;
+  uint64_t file_size_{ 0 };
+  bool end_of_data_{ false };
+
+  std::map<std::string, Topic> topics_;
+  std::map<uint16_t, Channel> channels_;
+
+  bool has_chunk_index_{ false };
+  std::multimap<uint64_t, uint64_t> unread_chunks_;  ///< Start time and offset of the chunks which have not been read
+  uint64_t latest_start_time_{ 0 };                  ///< Latest chunk start or message log time, without chunk index
+
+  std::priority_queue<PendingMessage, std::vector<PendingMessage>, std::greater<PendingMessage>> pending_;
+  uint64_t num_read_messages_{ 0 };
+  int num_skipped_chunks_{ 0 };
+  int num_undecoded_messages_{ 0 };
+  std::set<std::string> reported_compressions_;  ///< Compressions for which a warning was printed
+  std::set<uint16_t> reported_channels_;         ///< Channels for which an undecodable message was reported
+
+  std::vector<uint8_t> content_;
+  std::vector<double> values_;
+};
+}  // namespace mars
+
+#endif  // MCAP_READER_H
@@ -0,0 +1,147 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef MCAP_WRITER_H
+#define MCAP_WRITER_H
+
+#include <mars/measurement_journal.h>
+#include <mars/time.h>
+#include <mars/type_definitions/mcap_record.h>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief The McapWriter class writes measurements or filter outputs to an MCAP file
+///
+/// Each channel serializes its messages with a JournalEncoder (see data_utils/journal_codecs.h), the payload values are
+/// stored as little endian doubles with the message encoding mcap::kMessageEncoding. Messages are collected in
+/// uncompressed chunks of 'chunk_size' bytes. Schemas, channels, statistics and the chunk index are repeated in the
+/// summary section, such that the file can be read by any MCAP tooling. The log time of a message is the timestamp in
+/// nanoseconds.
+///
+class McapWriter
+{
+public:
+  ///
+  /// \brief McapWriter
+  /// \param file_name Path of the MCAP file
+  /// \param chunk_size Size of the message records [byte] after which a chunk is written
+  ///
+  McapWriter(std::string file_name, const uint64_t& chunk_size = 1 << 20);
+  ~McapWriter();
+
+  McapWriter(const McapWriter&) = delete;
+  McapWriter& operator=(const McapWriter&) = delete;
+
+  ///
+  /// \brief Open Creates the file and writes the magic and the header record
+  /// \return true if the file is ready for writing, false otherwise
+  ///
+  bool Open();
+
+  ///
+  /// \brief Close Writes the pending chunk, the summary section and the footer
+  ///
+  void Close();
+
+  ///
+  /// \brief AddChannel Adds a topic, the schema and the channel record are written immediately
+  /// \param topic Name of the topic
+  /// \param schema_name Name of the payload layout, e.g. the measurement type. Channels with the same schema name share
+  /// the schema record.
+  /// \param encoder Function to flatten the messages of the channel
+  /// \return Channel id, -1 if the file is not open
+  ///
+  int AddChannel(const std::string& topic, const std::string& schema_name, JournalEncoder encoder);
+
+  ///
+  /// \brief Write Serializes one message into the current chunk
+  /// \param channel_id Channel id returned by AddChannel
+  /// \param timestamp Message timestamp, stored as log and publish time
+  /// \param data Message as expected by the encoder of the channel (BufferDataType::measurement_ or ::core_state_)
+  /// \return true if the message was written, false if the channel is unknown or the message can not be encoded
+  ///
+  bool Write(const int& channel_id, const Time& timestamp, const std::shared_ptr<void>& data);
+
+  ///
+  /// \brief get_num_messages
+  /// \return Number of written messages
+  ///
+  uint64_t get_num_messages() const;
+
+  ///
+  /// \brief get_num_chunks
+  /// \return Number of written chunks
+  ///
+  uint64_t get_num_chunks() const;
+
+private:
+  struct Channel
+  {
+    uint16_t id;
+    uint16_t schema_id;
+    std::string topic;
+    JournalEncoder encoder;
+    uint32_t sequence{ 0 };
+    uint64_t num_messages{ 0 };
+  };
+
+  struct Schema
+  {
+    uint16_t id;
+    std::string name;
+  };
+
+  struct ChunkIndex
+  {
+    uint64_t message_start_time;
+    uint64_t message_end_time;
+    uint64_t offset;
+    uint64_t length;
+    uint64_t uncompressed_size;
+  };
+
+  ///
+  /// \brief WriteRecord Writes opcode, content length and content at the current position of the file
+  ///
+  void WriteRecord(const mcap::Opcode& opcode, const std::vector<uint8_t>& content);
+
+  void FlushChunk();
+
+  static std::vector<uint8_t> SchemaRecord(const Schema& schema);
+  static std::vector<uint8_t> ChannelRecord(const Channel& channel);
+
+  std::string file_name_;
+  uint64_t chunk_size_;
+  std::ofstream file_;
+
+  std::vector<Schema> schemas_;
+  std::vector<Channel> channels_;
+  std::vector<ChunkIndex> chunk_indices_;
+
+  std::vector<uint8_t> chunk_records_;  ///< Message records of the current chunk
+  uint64_t chunk_start_time_{ 0 };
+  uint64_t chunk_end_time_{ 0 };
+
+  uint64_t num_messages_{ 0 };
+  uint64_t message_start_time_{ UINT64_MAX };
+  uint64_t message_end_time_{ 0 };
+
+  std::vector<double> values_;
+  std::vector<uint8_t> record_;
+};
+}  // namespace mars
+
+#endif  // MCAP_WRITER_H
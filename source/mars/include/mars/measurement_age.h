@@ -0,0 +1,118 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef MEASUREMENT_AGE_H
+#define MEASUREMENT_AGE_H
+
+#include <mars/paced_replayer.h>
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief Latency distributions of one sensor, see MeasurementAgeTracker
+///
+struct MeasurementAgeStats
+{
+  LatencyStats processing_;  ///< Arrival of a measurement until its first state was produced
+  LatencyStats age_;         ///< Time since the arrival of the newest measurement, sampled at each new state
+  LatencyStats rework_;      ///< Arrival of a measurement until its state was corrected by a later buffer rework
+};
+
+///
+/// \brief The MeasurementAgeTracker class measures how old the information in the estimate is, per sensor
+///
+/// The tracker is registered as state observer of the filter (CoreLogic::AddStateObserver) and uses the arrival time
+/// which is stored with each buffer entry (BufferEntryType::arrival_ns_). Three distributions are kept per sensor:
+/// - Processing latency: Wall time from the arrival of a measurement until its first state was produced. For out of
+///   order measurements this includes the buffer rework.
+/// - Age: Wall time since the arrival of the newest measurement of the sensor, sampled for each new (non correction)
+///   state of any sensor. This is the staleness of the sensor information in the published estimate.
+/// - Rework delay: Wall time from the arrival of a measurement until its state was recomputed by a rework, i.e. how
+///   long a corrected state was outdated.
+///
+/// Only the latest 'window' samples of each distribution are kept. Entries without arrival time are ignored.
+/// Observe can be called from the filter thread while the statistics are read from another thread.
+///
+class MeasurementAgeTracker
+{
+public:
+  ///
+  /// \brief MeasurementAgeTracker
+  /// \param window Number of samples per sensor and distribution
+  ///
+  MeasurementAgeTracker(const size_t& window = 2048);
+
+  ///
+  /// \brief Observe Adds the samples of a produced state, signature of a StateObserver
+  /// \param state_entry Buffer entry of the state
+  /// \param is_correction True if the state was produced by a buffer rework
+  ///
+  void Observe(const BufferEntryType& state_entry, const bool& is_correction);
+
+  ///
+  /// \brief Observe Adds the samples of a state which was produced at 'output_ns'
+  /// \param output_ns Wall time at which the state was produced [ns since epoch]
+  ///
+  void Observe(const BufferEntryType& state_entry, const bool& is_correction, const int64_t& output_ns);
+
+  ///
+  /// \brief get_stats
+  /// \param sensor Sensor instance
+  /// \param deadline Samples above this latency [s] are counted as misses
+  /// \return Latency distributions of the sensor, empty if the sensor was not observed
+  ///
+  MeasurementAgeStats get_stats(const std::shared_ptr<SensorAbsClass>& sensor, const double& deadline = 0.05) const;
+
+  ///
+  /// \brief get_sensors
+  /// \return All sensors which have been observed
+  ///
+  std::vector<std::shared_ptr<SensorAbsClass>> get_sensors() const;
+
+  ///
+  /// \brief Reset Removes all samples and sensors
+  ///
+  void Reset();
+
+private:
+  ///
+  /// \brief The Samples struct is a ring of the latest latency samples
+  ///
+  struct Samples
+  {
+    std::vector<double> values_;  ///< [s]
+    size_t next_{ 0 };            ///< Slot of the next sample once the ring is full
+
+    void Add(const double& value, const size_t& window);
+  };
+
+  struct SensorSamples
+  {
+    int64_t newest_arrival_ns_{ 0 };  ///< Arrival of the newest measurement with a state
+    Samples processing_;
+    Samples age_;
+    Samples rework_;
+  };
+
+  size_t window_;
+  mutable std::mutex mutex_;  ///< Guards 'sensors_'
+  std::map<std::shared_ptr<SensorAbsClass>, SensorSamples> sensors_;
+};
+}  // namespace mars
+
+#endif  // MEASUREMENT_AGE_H
@@ -0,0 +1,157 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef MEASUREMENT_JOURNAL_H
+#define MEASUREMENT_JOURNAL_H
+
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/time.h>
+#include <mars/type_definitions/buffer_data_type.h>
+#include <mars/type_definitions/journal_record.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief Function to flatten a measurement into the journal payload
+///
+/// \param measurement Measurement as passed to ProcessMeasurement (BufferDataType::measurement_)
+/// \param values Output for the payload values
+/// \param max_size Max number of values that can be written to 'values'
+/// \return Number of written values, -1 if the measurement can not be encoded
+///
+using JournalEncoder = std::function<int(const std::shared_ptr<void>& measurement, double* values, int max_size)>;
+
+///
+/// \brief The MeasurementJournal class records every ProcessMeasurement call for an exact replay
+///
+/// Each call is written into a preallocated single producer single consumer ring by the filter thread. A background
+/// thread flushes the ring to a compact binary file (see journal_record.h). The filter thread never blocks on the
+/// journal, if the ring is full the record is dropped and counted.
+///
+/// Only measurements of registered sensors are journaled, since the measurement types are not known to the journal.
+/// Encoders for the measurement types of the library are provided in data_utils/journal_codecs.h. All sensors need to
+/// be registered before the journal is opened.
+///
+class MeasurementJournal
+{
+public:
+  ///
+  /// \brief MeasurementJournal
+  /// \param file_name Path of the journal file
+  /// \param capacity Number of ring slots
+  ///
+  MeasurementJournal(std::string file_name, const uint32_t& capacity = 4096);
+  ~MeasurementJournal();
+
+  MeasurementJournal(const MeasurementJournal&) = delete;
+  MeasurementJournal& operator=(const MeasurementJournal&) = delete;
+
+  ///
+  /// \brief RegisterSensor Adds a sensor for which measurements are journaled
+  /// \param sensor Sensor handle
+  /// \param encoder Function to flatten the measurements of the sensor
+  /// \return Sensor id used in the journal, -1 if the journal is already open
+  ///
+  int RegisterSensor(const std::shared_ptr<SensorAbsClass>& sensor, JournalEncoder encoder);
+
+  ///
+  /// \brief Open Creates the journal file, writes the sensor table and starts the flush thread
+  /// \return true if the journal is ready for recording, false otherwise
+  ///
+  bool Open();
+
+  ///
+  /// \brief Close Stops the flush thread, writes all pending records and closes the file
+  ///
+  void Close();
+
+  ///
+  /// \brief IsOpen
+  /// \return true if the journal file is open
+  ///
+  bool IsOpen() const;
+
+  ///
+  /// \brief Record Journals one ProcessMeasurement call, called by the filter thread
+  /// \param sensor Sensor handle
+  /// \param timestamp Measurement timestamp
+  /// \param data Measurement data
+  /// \param arrival_ns Wall time at which the measurement arrived [ns since epoch], see CoreLogic::ProcessMeasurement
+  /// \return true if the record was queued, false if the journal is closed, the sensor is unknown or the ring is full
+  ///
+  bool Record(const SensorAbsClass* sensor, const Time& timestamp, const BufferDataType& data,
+              const int64_t& arrival_ns);
+
+  ///
+  /// \brief get_num_recorded
+  /// \return Number of queued records
+  ///
+  uint64_t get_num_recorded() const;
+
+  ///
+  /// \brief get_num_dropped
+  /// \return Number of calls which could not be journaled
+  ///
+  uint64_t get_num_dropped() const;
+
+  ///
+  /// \brief get_num_written
+  /// \return Number of records written to the file
+  ///
+  uint64_t get_num_written() const;
+
+  std::chrono::microseconds flush_period_{ 2000 };  ///< Sleep time of the flush thread if the ring is empty
+
+private:
+  struct RegisteredSensor
+  {
+    std::shared_ptr<SensorAbsClass> sensor;
+    JournalEncoder encoder;
+  };
+
+  int FindSensorId(const SensorAbsClass* sensor) const;
+
+  ///
+  /// \brief FlushPending Writes all queued records to the file, called by the flush thread
+  /// \return Number of written records
+  ///
+  uint64_t FlushPending();
+
+  void FlushLoop();
+
+  std::string file_name_;
+  uint32_t capacity_;
+  std::vector<journal::JournalRecord> ring_;
+  std::vector<RegisteredSensor> sensors_;
+
+  std::ofstream file_;
+  std::thread flush_thread_;
+  std::atomic<bool> is_open_{ false };
+  std::atomic<bool> stop_{ false };
+
+  // Producer and consumer counters are padded to separate cache lines
+  std::atomic<uint64_t> head_{ 0 };  ///< Number of queued records, written by the filter thread
+  char head_padding_[64]{};
+  std::atomic<uint64_t> tail_{ 0 };  ///< Number of written records, written by the flush thread
+  char tail_padding_[64]{};
+  std::atomic<uint64_t> num_dropped_{ 0 };
+};
+}  // namespace mars
+
+#endif  // MEASUREMENT_JOURNAL_H
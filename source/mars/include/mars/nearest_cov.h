@@ -44,6 +44,12 @@ public:
 
   Eigen::MatrixXd cov_mat_;  ///< Input pseudo covariance
   double delta_{ 0.005 };    ///< default correction for the delta method
+  bool corrected_{ false };  ///< True if the last correction found negative eigenvalues
+
+  ///
+  /// \brief NearestCov Constructor without an input, see EigenCorrectionUsingCovariance(covariance, method, corrected)
+  ///
+  NearestCov() = default;
 
   ///
   /// \brief NearestCov Constructor
@@ -58,12 +64,29 @@ public:
   ///
   Eigen::MatrixXd EigenCorrectionUsingCovariance(NearestCovMethod method);
 
+  ///
+  /// \brief EigenCorrectionUsingCovariance Corrects 'covariance' and writes the result to 'corrected'
+  ///
+  /// A positive definite covariance is detected with a Cholesky decomposition and copied without the eigen
+  /// decomposition. The decomposition keeps its memory, such that repeated calls with covariances of the same size do
+  /// not allocate unless negative eigenvalues need to be corrected. 'cov_mat_' is not used.
+  ///
+  /// \param covariance Input pseudo covariance
+  /// \param method Determines methode for the eigen covariance correction
+  /// \param corrected Output for the corrected covariance, must not be 'covariance'
+  ///
+  void EigenCorrectionUsingCovariance(const Eigen::MatrixXd& covariance, NearestCovMethod method,
+                                      Eigen::MatrixXd* corrected);
+
   ///
   /// \brief EigenCorrectionUsingCorrelation
   /// \param method Determines methode for the eigen covariance correction
   /// \return Corrected covariance
   ///
   Eigen::MatrixXd EigenCorrectionUsingCorrelation(NearestCovMethod method);
+
+private:
+  Eigen::LLT<Eigen::MatrixXd> llt_;  ///< Cholesky decomposition of the last covariance
 };
 }  // namespace mars
 
@@ -0,0 +1,246 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <Eigen/Core>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief The ObjectPool class hands out shared pointers to recycled objects of type T
+///
+/// The pool holds constructed objects and the control blocks of their shared pointers. An object returns to the pool
+/// once its last shared pointer is released and keeps its members, e.g. the memory of dynamic Eigen matrices. Copying
+/// a value of the same size into a recycled object therefore does not allocate, unlike std::make_shared.
+///
+/// The pool grows by one chunk if it is empty, Reserve sizes it upfront from the configuration, e.g. the buffer size.
+/// Copies of a pool share the objects. Make and the release of objects are thread safe, objects may outlive the pool.
+///
+template <typename T>
+class ObjectPool
+{
+public:
+  ObjectPool() : storage_(std::make_shared<Storage>())
+  {
+  }
+
+  ///
+  /// \brief Make Copies 'value' into a recycled object
+  /// \return Shared pointer to the object, the object returns to the pool once the pointer is released
+  ///
+  std::shared_ptr<T> Make(const T& value)
+  {
+    std::shared_ptr<T> object = Acquire();
+    *object = value;
+    return object;
+  }
+
+  ///
+  /// \brief Acquire Hands out a recycled object without setting it, see Make
+  /// \return Shared pointer to the object, which holds the values of its last use or is default constructed
+  ///
+  std::shared_ptr<T> Acquire()
+  {
+    T* object = storage_->AcquireObject();
+    return std::shared_ptr<T>(object, Recycler{ storage_ }, BlockAllocator<T>(storage_));
+  }
+
+  ///
+  /// \brief Reserve Grows the pool such that 'capacity' objects can be handed out without an allocation
+  ///
+  void Reserve(const size_t& capacity)
+  {
+    storage_->Reserve(capacity);
+  }
+
+  ///
+  /// \brief get_capacity
+  /// \return Number of objects of the pool, handed out and free
+  ///
+  size_t get_capacity() const
+  {
+    std::lock_guard<std::mutex> lock(storage_->mutex_);
+    return storage_->capacity_;
+  }
+
+  ///
+  /// \brief get_num_free
+  /// \return Number of objects which can be handed out without an allocation
+  ///
+  size_t get_num_free() const
+  {
+    std::lock_guard<std::mutex> lock(storage_->mutex_);
+    return storage_->free_objects_.size();
+  }
+
+private:
+  /// Size of the blocks for the shared pointer control blocks, the pool holds the deleter and allocator which hold a
+  /// shared pointer each, see BlockAllocator::allocate
+  static constexpr size_t kBlockSize = 128;
+
+  struct alignas(std::max_align_t) Block
+  {
+    unsigned char bytes_[kBlockSize];
+  };
+
+  struct Storage
+  {
+    mutable std::mutex mutex_;
+    size_t capacity_{ 0 };
+    std::vector<std::vector<T, Eigen::aligned_allocator<T>>> object_chunks_;
+    std::vector<std::vector<Block>> block_chunks_;
+    std::vector<T*> free_objects_;
+    std::vector<void*> free_blocks_;
+
+    void Reserve(const size_t& capacity)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (capacity > capacity_)
+      {
+        Grow(capacity - capacity_);
+      }
+    }
+
+    // Requires the lock
+    void Grow(const size_t& num)
+    {
+      object_chunks_.emplace_back(num);
+      block_chunks_.emplace_back(num);
+      capacity_ += num;
+
+      // Released objects and blocks are pushed back without an allocation
+      free_objects_.reserve(capacity_);
+      free_blocks_.reserve(capacity_);
+      for (size_t k = 0; k < num; k++)
+      {
+        free_objects_.push_back(&object_chunks_.back()[k]);
+        free_blocks_.push_back(&block_chunks_.back()[k]);
+      }
+    }
+
+    // Requires the lock, doubles the capacity
+    void GrowChunk()
+    {
+      // Grow modifies 'capacity_', the size is passed as copy
+      const size_t num = std::max(capacity_, size_t(16));
+      Grow(num);
+    }
+
+    T* AcquireObject()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (free_objects_.empty())
+      {
+        GrowChunk();
+      }
+      T* object = free_objects_.back();
+      free_objects_.pop_back();
+      return object;
+    }
+
+    void ReleaseObject(T* object)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_objects_.push_back(object);
+    }
+
+    void* AcquireBlock()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // Empty if a released object was acquired again before the control block of its last pointer was released
+      if (free_blocks_.empty())
+      {
+        GrowChunk();
+      }
+      void* block = free_blocks_.back();
+      free_blocks_.pop_back();
+      return block;
+    }
+
+    void ReleaseBlock(void* block)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      free_blocks_.push_back(block);
+    }
+  };
+
+  struct Recycler
+  {
+    std::shared_ptr<Storage> storage_;
+
+    void operator()(T* object) const
+    {
+      storage_->ReleaseObject(object);
+    }
+  };
+
+  template <typename U>
+  struct BlockAllocator
+  {
+    using value_type = U;
+
+    template <typename V>
+    struct rebind
+    {
+      using other = BlockAllocator<V>;
+    };
+
+    std::shared_ptr<Storage> storage_;
+
+    explicit BlockAllocator(std::shared_ptr<Storage> storage) : storage_(std::move(storage))
+    {
+    }
+
+    template <typename V>
+    BlockAllocator(const BlockAllocator<V>& other) : storage_(other.storage_)
+    {
+    }
+
+    U* allocate(const size_t& n)
+    {
+      static_assert(sizeof(U) <= kBlockSize, "The control block does not fit into a block of the pool");
+      static_assert(alignof(U) <= alignof(Block), "The control block exceeds the alignment of the pool blocks");
+      assert(n == 1);
+      (void)n;
+      return static_cast<U*>(storage_->AcquireBlock());
+    }
+
+    void deallocate(U* ptr, const size_t& /*n*/)
+    {
+      storage_->ReleaseBlock(ptr);
+    }
+
+    template <typename V>
+    bool operator==(const BlockAllocator<V>& other) const
+    {
+      return storage_ == other.storage_;
+    }
+
+    template <typename V>
+    bool operator!=(const BlockAllocator<V>& other) const
+    {
+      return storage_ != other.storage_;
+    }
+  };
+
+  std::shared_ptr<Storage> storage_;
+};
+}  // namespace mars
+
+#endif  // OBJECT_POOL_H
@@ -0,0 +1,144 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef PACED_REPLAYER_H
+#define PACED_REPLAYER_H
+
+#include <mars/core_logic.h>
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief Arrival model of a sensor, the arrival delay is 'delay_' plus an exponentially distributed jitter
+///
+struct ArrivalModel
+{
+  double delay_{ 0 };   ///< Constant delay between the measurement time and the arrival at the filter [s]
+  double jitter_{ 0 };  ///< Mean of the additional exponentially distributed delay [s]
+};
+
+///
+/// \brief Distribution of latency samples
+///
+struct LatencyStats
+{
+  int num_samples_{ 0 };
+  int num_deadline_misses_{ 0 };  ///< Samples above the deadline
+  double mean_{ 0 };              ///< [s]
+  double p50_{ 0 };               ///< [s]
+  double p90_{ 0 };               ///< [s]
+  double p99_{ 0 };               ///< [s]
+  double max_{ 0 };               ///< [s]
+};
+
+///
+/// \brief Result of a paced replay
+///
+struct PacedReplayResult
+{
+  int num_processed_{ 0 };     ///< Number of ProcessMeasurement calls
+  int num_out_of_order_{ 0 };  ///< Measurements older than the newest measurement at their arrival
+  int num_reworks_{ 0 };       ///< Buffer reworks of the filter during the replay
+  double wall_time_{ 0 };      ///< Duration of the replay [s]
+  LatencyStats processing_;    ///< Time from the scheduled arrival until ProcessMeasurement returned
+  LatencyStats latency_;       ///< Measurement to estimate latency, arrival delay plus processing latency
+  std::map<std::shared_ptr<SensorAbsClass>, LatencyStats> sensor_latency_;  ///< 'latency_' per sensor
+};
+
+///
+/// \brief The PacedReplayer class replays measurements against the wall clock with synthetic arrival delays
+///
+/// Each measurement arrives at its timestamp plus the arrival delay of its sensor model. The measurements are handed
+/// to ProcessMeasurement in arrival order, at the wall time of their arrival scaled by 'speed_'. Delayed measurements
+/// therefore arrive out of order, as on the target system, and trigger the rework of the filter buffer.
+///
+/// The processing latency is measured from the scheduled arrival until ProcessMeasurement returned, it includes the
+/// time a measurement waits while the filter is still busy with an earlier one. The measurement to estimate latency
+/// adds the arrival delay. Latencies above 'deadline_' are counted as deadline misses.
+///
+/// \note The processing time is not scaled with 'speed_', accelerated replays compress the idle time between the
+/// measurements but not the filter load.
+///
+class PacedReplayer
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ///
+  /// \brief PacedReplayer
+  /// \param measurements Measurements with their measurement timestamps, in any order
+  /// \param seed Seed of the arrival jitter
+  ///
+  PacedReplayer(std::vector<BufferEntryType> measurements, const uint64_t& seed = 1);
+
+  ///
+  /// \brief set_arrival_model Sets the arrival model of a sensor, sensors without model arrive without delay
+  ///
+  void set_arrival_model(const std::shared_ptr<SensorAbsClass>& sensor, const ArrivalModel& model);
+
+  ///
+  /// \brief set_arrival_times Uses the given arrival times instead of the arrival models
+  /// \param arrival_times Arrival time [s] of each measurement in the order of the constructor argument
+  /// \return false if the number of arrival times does not match the number of measurements
+  ///
+  bool set_arrival_times(const std::vector<double>& arrival_times);
+
+  ///
+  /// \brief Run Replays all measurements with the given filter
+  ///
+  /// If the core is not initialized after a measurement of the propagation sensor, 'initializer_' is called.
+  ///
+  /// \param core_logic Filter instance
+  /// \return Replay statistics
+  ///
+  PacedReplayResult Run(CoreLogic* core_logic);
+
+  ///
+  /// \brief ComputeStats Latency distribution, the percentiles use the nearest rank
+  /// \param samples Latency samples [s]
+  /// \param deadline Samples above this latency [s] are counted as misses
+  ///
+  static LatencyStats ComputeStats(std::vector<double> samples, const double& deadline);
+
+  double speed_{ 1 };                            ///< Replay speed, 1 for real time, <= 0 as fast as possible
+  double deadline_{ 0.05 };                      ///< Deadline of the measurement to estimate latency [s]
+  std::chrono::microseconds spin_period_{ 200 };  ///< The replay busy waits for the last part of each pacing period
+  std::function<void(CoreLogic* core_logic)> initializer_{ nullptr };  ///< Called to initialize the core
+
+private:
+  struct Arrival
+  {
+    double time;
+    size_t idx;
+  };
+
+  ///
+  /// \brief get_arrivals Arrival times of all measurements, sorted by arrival
+  ///
+  std::vector<Arrival> get_arrivals() const;
+
+  void WaitUntil(const Clock::time_point& time) const;
+
+  std::vector<BufferEntryType> measurements_;
+  std::vector<double> arrival_times_;
+  std::map<std::shared_ptr<SensorAbsClass>, ArrivalModel> arrival_models_;
+  uint64_t seed_;
+};
+}  // namespace mars
+
+#endif  // PACED_REPLAYER_H
@@ -0,0 +1,180 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef REALTIME_PROFILE_H
+#define REALTIME_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief The RealtimeConfig struct defines the real-time execution profile of the filter process
+///
+struct RealtimeConfig
+{
+  bool lock_memory_{ true };                 ///< Lock all current and future pages of the process (mlockall)
+  bool keep_heap_{ true };                   ///< Disable heap trimming and mmap allocations, freed memory stays mapped
+  size_t heap_reserve_bytes_{ 64 << 20 };    ///< Heap memory touched once at startup, see EstimateHeapBytes
+  size_t stack_reserve_bytes_{ 512 << 10 };  ///< Stack memory of the calling thread touched once at startup
+  int cpu_{ -1 };                            ///< CPU the calling thread is pinned to, -1 to disable pinning
+  int fifo_priority_{ 0 };                   ///< SCHED_FIFO priority of the calling thread, 0 to keep the policy
+};
+
+///
+/// \brief The RealtimeState struct holds the settings changed by RealtimeProfile::Apply, see RealtimeProfile::Restore
+///
+struct RealtimeState
+{
+  bool memory_locked_{ false };  ///< The memory of the process was locked
+  bool heap_kept_{ false };      ///< The heap settings were changed
+  std::vector<int> cpus_;        ///< CPUs of the calling thread before pinning, empty if the thread was not pinned
+  bool sched_changed_{ false };  ///< The scheduling policy of the calling thread was changed
+  int sched_policy_{ 0 };        ///< Scheduling policy of the calling thread before Apply
+  int sched_priority_{ 0 };      ///< Scheduling priority of the calling thread before Apply
+};
+
+///
+/// \brief The RealtimeStats struct holds the resource usage counters of the calling thread
+///
+struct RealtimeStats
+{
+  long minor_faults_{ 0 };          ///< Page faults served without I/O
+  long major_faults_{ 0 };          ///< Page faults that required I/O
+  long voluntary_switches_{ 0 };    ///< Context switches due to blocking calls
+  long involuntary_switches_{ 0 };  ///< Context switches due to preemption
+};
+
+///
+/// \brief The MemoryStats struct holds the memory usage of the process
+///
+/// The heap counters are only available with glibc, otherwise they are zero.
+///
+struct MemoryStats
+{
+  size_t rss_bytes_{ 0 };          ///< Resident set size
+  size_t heap_in_use_bytes_{ 0 };  ///< Allocated heap memory
+  size_t heap_free_bytes_{ 0 };    ///< Free heap memory which is still mapped (fragmentation and trim threshold)
+  size_t heap_mapped_bytes_{ 0 };  ///< Heap memory served with mmap
+};
+
+///
+/// \brief The RealtimeProfile class prepares the process and the filter thread for deterministic execution
+///
+/// Page faults and the growth of the heap are the main sources of unbounded latency on PREEMPT_RT systems. Apply
+/// touches the heap and stack reserves once, keeps them mapped and locks them into memory. Afterwards, allocations of
+/// the filter are served from the locked heap without system calls, as long as the reserve is not exceeded.
+///
+/// \note The buffer, the pools of the core and sensor states and the update workspaces are sized from the buffer size
+/// during the first measurements. Afterwards, the IMU propagation and the pose update do not allocate. The updates of
+/// the other sensor models still allocate their dynamic Eigen matrices, the profile makes these allocations fault free.
+///
+/// The settings apply to the whole process and stay active until Restore is called with the state returned by Apply.
+///
+class RealtimeProfile
+{
+public:
+  ///
+  /// \brief Apply Applies all settings of 'config' to the process and the calling thread
+  ///
+  /// All steps are performed, even if one of them fails, e.g. due to missing privileges.
+  ///
+  /// \param previous Optional output for the changed settings, see Restore
+  /// \return true if all steps were successful
+  ///
+  static bool Apply(const RealtimeConfig& config, RealtimeState* previous = nullptr);
+
+  ///
+  /// \brief Restore Reverts the settings which were changed by Apply
+  ///
+  /// The memory is unlocked, the heap settings are reset to the glibc defaults and the CPU affinity and scheduling
+  /// policy of the calling thread are restored. Call it from the thread which called Apply.
+  ///
+  /// \return true if all steps were successful
+  ///
+  static bool Restore(const RealtimeState& previous);
+
+  ///
+  /// \brief EstimateHeapBytes Returns a heap reserve for a buffer with 'max_buffer_size' entries
+  /// \param max_buffer_size Max number of buffer entries
+  /// \param max_state_size Largest error state (core and sensor) of the filter
+  ///
+  static size_t EstimateHeapBytes(const int& max_buffer_size, const int& max_state_size);
+
+  ///
+  /// \brief LockMemory Locks all current and future pages of the process
+  ///
+  static bool LockMemory();
+
+  ///
+  /// \brief UnlockMemory Unlocks all pages of the process
+  ///
+  static bool UnlockMemory();
+
+  ///
+  /// \brief KeepHeap Disables the trimming of the heap and the use of mmap for large allocations
+  ///
+  static bool KeepHeap();
+
+  ///
+  /// \brief ReleaseHeap Resets the heap trimming and mmap settings to the glibc defaults
+  ///
+  /// glibc has no getter for these settings. The defaults are M_TRIM_THRESHOLD 128 kB and M_MMAP_MAX 65536.
+  ///
+  static bool ReleaseHeap();
+
+  ///
+  /// \brief PrefaultHeap Allocates and touches 'bytes' of heap memory and returns it to the allocator
+  ///
+  static bool PrefaultHeap(const size_t& bytes);
+
+  ///
+  /// \brief PrefaultStack Touches 'bytes' of the stack of the calling thread
+  ///
+  static void PrefaultStack(const size_t& bytes);
+
+  ///
+  /// \brief PinCurrentThread Restricts the calling thread to 'cpu'
+  ///
+  static bool PinCurrentThread(const int& cpu);
+
+  ///
+  /// \brief get_current_thread_cpus
+  /// \return CPUs the calling thread may run on, empty if the affinity is not supported
+  ///
+  static std::vector<int> get_current_thread_cpus();
+
+  ///
+  /// \brief SetCurrentThreadCpus Restricts the calling thread to 'cpus'
+  ///
+  static bool SetCurrentThreadCpus(const std::vector<int>& cpus);
+
+  ///
+  /// \brief SetFifoPriority Sets the SCHED_FIFO policy with 'priority' for the calling thread
+  ///
+  static bool SetFifoPriority(const int& priority);
+
+  ///
+  /// \brief get_thread_stats
+  /// \return Resource usage counters of the calling thread
+  ///
+  static RealtimeStats get_thread_stats();
+
+  ///
+  /// \brief get_memory_stats
+  /// \return Memory usage of the process
+  ///
+  static MemoryStats get_memory_stats();
+};
+}  // namespace mars
+
+#endif  // REALTIME_PROFILE_H
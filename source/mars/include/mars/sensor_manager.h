@@ -12,133 +12,194 @@
 #ifndef SENSORMANAGER_HPP
 #define SENSORMANAGER_HPP
 
+#include <mars/buffer.h>
 #include <mars/sensors/sensor_abs_class.h>
+#include <mars/time.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace mars
 {
+///
+/// \brief The SensorManager class is a registry of the sensors of a filter which can be changed from any thread
+///
+/// The registered sensors are published as an immutable snapshot (read-copy-update). Readers load the current snapshot
+/// without locking and keep it valid for as long as they hold it. Writers copy the list, modify the copy and publish
+/// it, writers are serialized by a mutex.
+///
+/// remove_sensor, deactivate_sensor and activate_sensor apply the change immediately and must only be called from the
+/// filter thread. QueueRemoveSensor, QueueDeactivateSensor and QueueActivateSensor can be called from any thread, they
+/// do not touch the sensor or the buffer, they only queue the change and return. The filter thread applies queued
+/// changes with ApplyPendingChanges and removes the buffer entries of deactivated sensors in steps of at most
+/// 'cleanup_step_' entries with CollectGarbage, such that a hot swap of a sensor does not stall the filter. CoreLogic
+/// calls both for each measurement, a standalone SensorManager must call them itself.
+///
 class SensorManager
 {
 public:
-  std::vector<std::shared_ptr<SensorAbsClass>> sensor_list_;  ///< Vector containing all registered sensors
-  SensorManager() = default;
+  using SensorList = std::vector<std::shared_ptr<SensorAbsClass>>;
+
+  int cleanup_step_{ 256 };  ///< Max number of buffer entries CollectGarbage inspects per call
+
+  ///
+  /// \brief Copy of the registered sensors, updated by each change of the registry
+  /// \deprecated Use get_sensor_list, this copy is not safe to read while another thread changes the registry, and
+  /// changes of the copy are not applied to the registry
+  ///
+  SensorList sensor_list_;
+
+  SensorManager();
+  SensorManager(const SensorManager& other);
+  SensorManager& operator=(const SensorManager& other);
 
   ///
   /// \brief register_sensor Register a sensor with the sensor manager
   /// \param sensor Sensor to be registered
   /// \return True if the sensor was registered, false if the sensor is already registered
   ///
-  bool register_sensor(std::shared_ptr<SensorAbsClass> sensor)
-  {
-    // Check if sensor already exists
-    if (std::find(sensor_list_.begin(), sensor_list_.end(), sensor) != sensor_list_.end())
-    {
-      // Sensor is already registered
-      return false;
-    }
+  bool register_sensor(std::shared_ptr<SensorAbsClass> sensor);
 
-    sensor_list_.push_back(sensor);
-    std::cout << "Registered sensor [" << sensor->name_ << "] with Sensor Manager" << std::endl;
-    return true;
-  }
+  ///
+  /// \brief QueueRemoveSensor Removes a sensor from the registry and queues its deactivation, does not block
+  /// \param sensor Sensor to be removed
+  /// \return True if the sensor was removed, false if the sensor is not registered
+  ///
+  bool QueueRemoveSensor(std::shared_ptr<SensorAbsClass> sensor);
 
   ///
-  /// \brief remove_sensor Remove a sensor from the sensor manager
+  /// \brief remove_sensor Remove a sensor from the sensor manager and all its entries from the buffer immediately
+  /// \note Only call from the filter thread, the removal blocks until the full buffer was scanned
   /// \param buffer Buffer to remove the sensor from
   /// \param sensor Sensor to be removed
   /// \return True if the sensor was removed, false if the sensor is not registered
   ///
-  bool remove_sensor(Buffer& buffer, std::shared_ptr<SensorAbsClass> sensor)
-  {
-    if (!does_sensor_exist(sensor))
-    {
-      // Sensor is not registered
-      return false;
-    }
-    // Deactive the sensor
-    this->deactivate_sensor(buffer, sensor);
-    // Remove the sensor from the list
-    sensor_list_.erase(std::remove(sensor_list_.begin(), sensor_list_.end(), sensor), sensor_list_.end());
-    std::cout << "Removed sensor [" << sensor->name_ << "] from Sensor Manager" << std::endl;
-    return true;
-  }
+  bool remove_sensor(Buffer& buffer, std::shared_ptr<SensorAbsClass> sensor);
 
   ///
   /// \brief list_sensors Print the information of all registered sensors
   ///
-  void list_sensors()
-  {
-    std::cout << "Sensor Manager contains " << sensor_list_.size() << " sensors" << std::endl;
-    for (auto& sensor : sensor_list_)
-    {
-      std::cout << *sensor << std::endl;
-    }
-  }
+  void list_sensors() const;
 
   ///
   /// \brief does_sensor_exist Check if a sensor is registered
   /// \param sensor Sensor to be checked
   /// \return True if the sensor is registered, otherwise false
   ///
-  bool does_sensor_exist(std::shared_ptr<SensorAbsClass> sensor)
-  {
-    if (std::find(sensor_list_.begin(), sensor_list_.end(), sensor) != sensor_list_.end())
-    {
-      return true;
-    }
-    return false;
-  }
+  bool does_sensor_exist(const std::shared_ptr<SensorAbsClass>& sensor) const;
 
   ///
-  /// \brief deactivate_sensor Deactivate a sensor
-  /// \param buffer Buffer to remove the sensor from
+  /// \brief QueueDeactivateSensor Queues the deactivation of a sensor, does not block
   /// \param sensor Sensor to be deactivated
   /// \return False if the sensor is not registered, otherwise true
   ///
-  bool deactivate_sensor(Buffer& buffer, std::shared_ptr<SensorAbsClass> sensor)
-  {
-    if (!does_sensor_exist(sensor))
-    {
-      // Sensor is not registered
-      return false;
-    }
-
-    // Reset the sensor
-    sensor->do_update_ = false;
-    sensor->is_initialized_ = false;
-    sensor->ref_to_nav_given_ = false;
-
-    // Call buffer to clear all entries of the sensor
-    if (buffer.RemoveSensorFromBuffer(sensor))
-    {
-      std::cout << "Removed sensor [" << sensor->name_ << "] from buffer" << std::endl;
-    }
-    else
-    {
-      std::cout << "Could not remove sensor [" << sensor->name_ << "] from buffer as buffer is empty" << std::endl;
-      return false;
-    }
-    return true;
-  }
+  bool QueueDeactivateSensor(std::shared_ptr<SensorAbsClass> sensor);
+
+  ///
+  /// \brief deactivate_sensor Deactivate a sensor and remove its entries from the buffer immediately
+  /// \note Only call from the filter thread, the removal blocks until the full buffer was scanned
+  /// \param buffer Buffer to remove the sensor from
+  /// \param sensor Sensor to be deactivated
+  /// \return False if the sensor is not registered or the buffer is empty, otherwise true
+  ///
+  bool deactivate_sensor(Buffer& buffer, std::shared_ptr<SensorAbsClass> sensor);
 
   ///
   /// \brief activate_sensor Activate a sensor
+  /// \note Only call from the filter thread. Buffer entries of a queued deactivation which are still in the buffer are
+  /// kept, use the overload with a buffer or QueueActivateSensor after QueueDeactivateSensor.
+  /// \param sensor Sensor to be activated
+  /// \return False if the sensor is not registered, otherwise true
+  ///
+  bool activate_sensor(std::shared_ptr<SensorAbsClass> sensor);
+
+  ///
+  /// \brief activate_sensor Remove the remaining entries of a queued deactivation from the buffer and activate a sensor
+  /// \note Only call from the filter thread, while no buffer index is held
+  /// \param buffer Buffer with the entries of the sensor
+  /// \param sensor Sensor to be activated
+  /// \return False if the sensor is not registered, otherwise true
+  ///
+  bool activate_sensor(Buffer& buffer, std::shared_ptr<SensorAbsClass> sensor);
+
+  ///
+  /// \brief QueueActivateSensor Queues the activation of a sensor, does not block
   /// \param sensor Sensor to be activated
   /// \return False if the sensor is not registered, otherwise true
   ///
-  bool activate_sensor(std::shared_ptr<SensorAbsClass> sensor)
+  bool QueueActivateSensor(std::shared_ptr<SensorAbsClass> sensor);
+
+  ///
+  /// \brief get_sensor_list Snapshot of the registered sensors, later changes of the registry do not alter it
+  ///
+  std::shared_ptr<const SensorList> get_sensor_list() const;
+
+  ///
+  /// \brief ApplyPendingChanges Applies the queued activations and deactivations to the sensors
+  ///
+  /// Deactivated sensors are reset and their buffer entries are scheduled for CollectGarbage. If a sensor is activated
+  /// while entries of an earlier deactivation are left, these entries are removed from 'buffer' first. If entries
+  /// must not be removed, e.g. while a buffer index is held for a pending rework, this activation and all changes
+  /// queued after it stay queued for a later call.
+  ///
+  /// \note Only call from the filter thread, returns immediately if no change is queued
+  /// \param buffer Buffer with the entries of the sensors
+  /// \param can_remove_entries False if no buffer entry must be removed by this call
+  /// \return Number of applied changes
+  ///
+  int ApplyPendingChanges(Buffer* buffer, const bool& can_remove_entries = true);
+
+  ///
+  /// \brief CollectGarbage Removes buffer entries of deactivated sensors, inspects at most 'cleanup_step_' entries
+  ///
+  /// The scan resumes at the timestamp where the previous call stopped, removing old entries at the front of the
+  /// buffer in between does not skip entries.
+  ///
+  /// \note Only call from the filter thread, while no buffer index is held
+  /// \return Number of removed entries
+  ///
+  int CollectGarbage(Buffer* buffer);
+
+  ///
+  /// \brief IsCleanupPending
+  /// \return true if changes are queued or buffer entries of deactivated sensors may be left
+  ///
+  bool IsCleanupPending() const;
+
+private:
+  struct SensorChange
   {
-    if (!does_sensor_exist(sensor))
-    {
-      // Sensor is not registered
-      return false;
-    }
-
-    sensor->do_update_ = true;
-    std::cout << "Activated sensor [" << sensor->name_ << "]" << std::endl;
-    return true;
-  }
+    std::shared_ptr<SensorAbsClass> sensor_;
+    bool activate_{ false };
+  };
+
+  ///
+  /// \brief ResetSensor Disables the updates of the sensor and requires a new initialization
+  ///
+  static void ResetSensor(const std::shared_ptr<SensorAbsClass>& sensor);
+
+  ///
+  /// \brief QueueChange Adds a change for ApplyPendingChanges, requires 'mutex_'
+  ///
+  void QueueChange(const std::shared_ptr<SensorAbsClass>& sensor, const bool& activate);
+
+  ///
+  /// \brief PublishSensors Publishes 'sensors' as the new snapshot, requires 'mutex_'
+  ///
+  void PublishSensors(SensorList sensors);
+
+  static bool Contains(const SensorList& list, const std::shared_ptr<SensorAbsClass>& sensor);
+
+  mutable std::mutex mutex_;                   ///< Serializes the writers and guards 'pending_changes_'
+  std::shared_ptr<const SensorList> sensors_;  ///< Published snapshot, accessed with atomic_load and atomic_store
+  std::vector<SensorChange> pending_changes_;  ///< Changes which are not yet applied by the filter thread
+  std::atomic<int> num_pending_changes_{ 0 };  ///< Size of 'pending_changes_', read without the lock
+
+  // Filter thread only
+  SensorList retired_sensors_;       ///< Deactivated sensors with entries which may still be in the buffer
+  Time cleanup_cursor_;              ///< Timestamp at which the next CollectGarbage call resumes
+  bool cleanup_from_start_{ true };  ///< The next CollectGarbage call starts at the oldest entry
 };
 }  // namespace mars
 
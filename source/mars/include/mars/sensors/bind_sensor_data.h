@@ -82,6 +82,23 @@ public:
 
     return full_cov;
   }
+
+  ///
+  /// \brief get_full_cov Writes the full covariance matrix to 'full_cov', see get_full_cov()
+  ///
+  /// 'full_cov' keeps its memory if it has the size of the full covariance.
+  ///
+  void get_full_cov(Eigen::MatrixXd* full_cov) const
+  {
+    full_cov->resize(full_cov_size_, full_cov_size_);
+    full_cov->block(0, 0, CoreStateType::size_error_, CoreStateType::size_error_).setZero();
+    full_cov->block(CoreStateType::size_error_, CoreStateType::size_error_, state_.cov_size_, state_.cov_size_) =
+        sensor_cov_;
+    full_cov->block(0, CoreStateType::size_error_, CoreStateType::size_error_, state_.cov_size_) =
+        core_sensor_cross_cov_;
+    full_cov->block(CoreStateType::size_error_, 0, state_.cov_size_, CoreStateType::size_error_) =
+        core_sensor_cross_cov_.transpose();
+  }
 };
 }  // namespace mars
 
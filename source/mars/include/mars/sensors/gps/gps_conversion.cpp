@@ -30,6 +30,11 @@ Eigen::Matrix<double, 3, 1> mars::GpsConversion::get_enu(mars::GpsCoordinates co
   return WGS84ToENU(coordinates);
 }
 
+GpsCoordinates GpsConversion::get_gps(const Eigen::Matrix<double, 3, 1>& enu)
+{
+  return ECEFToWGS84(ecef_ref_orientation_.transpose() * enu + ecef_ref_point_);
+}
+
 GpsConversion::GpsConversion(mars::GpsCoordinates coordinates)
 {
   ecef_ref_orientation_.setIdentity();
@@ -116,4 +121,28 @@ Eigen::Matrix<double, 3, 1> GpsConversion::WGS84ToECEF(const mars::GpsCoordinate
 
   return ecef;
 }
+
+GpsCoordinates GpsConversion::ECEFToWGS84(const Eigen::Matrix<double, 3, 1>& ecef)
+{
+  // WGS84 ellipsoid constants
+  constexpr double a = 6378137.0;             // semi-major axis
+  constexpr double ecc = 8.1819190842622e-2;  // eccentricity of this ellipsoid
+  constexpr double ecc_sq = ecc * ecc;
+
+  const double rad_long = atan2(ecef(1), ecef(0));
+  const double p = sqrt(ecef(0) * ecef(0) + ecef(1) * ecef(1));
+
+  // Fixed point iteration of the latitude, converges to sub millimeter accuracy within a few steps
+  double rad_lat = atan2(ecef(2), p * (1 - ecc_sq));
+  double h = 0;
+  for (int k = 0; k < 5; k++)
+  {
+    const double s_lat = sin(rad_lat);
+    const double N = a / sqrt(1 - ecc_sq * s_lat * s_lat);
+    h = p / cos(rad_lat) - N;
+    rad_lat = atan2(ecef(2), p * (1 - ecc_sq * N / (N + h)));
+  }
+
+  return GpsCoordinates(rad_lat * 180 / M_PI, rad_long * 180 / M_PI, h);
+}
 }  // namespace mars
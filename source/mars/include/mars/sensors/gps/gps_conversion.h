@@ -75,6 +75,13 @@ public:
   ///
   Eigen::Matrix<double, 3, 1> get_enu(mars::GpsCoordinates coordinates);
 
+  ///
+  /// \brief get_gps Inverse of get_enu
+  /// \param enu ENU local position
+  /// \return GPS coordinates
+  ///
+  mars::GpsCoordinates get_gps(const Eigen::Matrix<double, 3, 1>& enu);
+
   ///
   /// \brief get_gps_reference
   /// \return GPS reference coordinates
@@ -106,6 +113,13 @@ private:
   ///
   Eigen::Matrix<double, 3, 1> WGS84ToECEF(const mars::GpsCoordinates& coordinates);
 
+  ///
+  /// \brief ECEFToWGS84 Earth-Centered-Earth-Fixed (ECEF) to World Geodetic System 1984 model (WGS-84)
+  /// \param ecef ecef position
+  /// \return GPS coordinates
+  ///
+  mars::GpsCoordinates ECEFToWGS84(const Eigen::Matrix<double, 3, 1>& ecef);
+
   ///
   /// \brief ECEFToENU Earth-Centered-Earth-Fixed (ECEF) to East-North-Up (ENU)
   /// \param ecef ecef reference
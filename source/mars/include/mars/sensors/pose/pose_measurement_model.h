@@ -0,0 +1,63 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef POSE_MEASUREMENT_MODEL_H
+#define POSE_MEASUREMENT_MODEL_H
+
+#include <mars/core_state_kernels.h>
+#include <mars/general_functions/error_state_jacobian.h>
+#include <mars/sensors/pose/pose_sensor_state_type.h>
+#include <Eigen/Dense>
+
+namespace mars
+{
+///
+/// \brief The PoseMeasurementModel struct is the measurement function of the pose sensor for the ErrorStateJacobian
+///
+/// Measurement: [p_wp(3), small angle orientation error(3)]
+/// Sensor error states: [p_ip(3), q_ip(3)]
+///
+struct PoseMeasurementModel
+{
+  static constexpr int kMeasurementSize = 6;
+  static constexpr int kSensorErrorSize = 6;
+  static constexpr unsigned kCoreErrorBlocks = kCoreErrorPosition | kCoreErrorOrientation;
+  using SensorState = PoseSensorStateType;
+
+  template <typename T>
+  struct SensorStorage
+  {
+    Eigen::Matrix<T, 3, 1> p_ip_;
+    Eigen::Quaternion<T> q_ip_;
+  };
+
+  template <typename T>
+  static SensorStorage<T> BoxPlus(const PoseSensorStateType& state, const Eigen::Matrix<T, kSensorErrorSize, 1>& delta)
+  {
+    SensorStorage<T> result;
+    result.p_ip_ = state.p_ip_.cast<T>() + delta.template head<3>();
+    result.q_ip_ = BoxPlusQuaternion<T>(state.q_ip_, delta.template tail<3>());
+    return result;
+  }
+
+  template <typename T>
+  static Eigen::Matrix<T, kMeasurementSize, 1> Predict(const CoreStateStorage<T>& core, const SensorStorage<T>& sensor)
+  {
+    Eigen::Matrix<T, kMeasurementSize, 1> result;
+    result.template head<3>() = core.p_wi_ + core.q_wi_.toRotationMatrix() * sensor.p_ip_;
+    result.template tail<3>() = QuaternionLocalError<T>(core.q_wi_ * sensor.q_ip_);
+    return result;
+  }
+};
+
+using PoseMeasurementJacobian = ErrorStateJacobian<PoseMeasurementModel>;
+}  // namespace mars
+
+#endif  // POSE_MEASUREMENT_MODEL_H
@@ -14,7 +14,9 @@
 #include <mars/core_state.h>
 #include <mars/ekf.h>
 #include <mars/general_functions/utils.h>
+#include <mars/object_pool.h>
 #include <mars/sensors/bind_sensor_data.h>
+#include <mars/sensors/pose/pose_measurement_model.h>
 #include <mars/sensors/pose/pose_measurement_type.h>
 #include <mars/sensors/pose/pose_sensor_state_type.h>
 #include <mars/sensors/update_sensor_abs_class.h>
@@ -36,6 +38,13 @@ class PoseSensorClass : public UpdateSensorAbsClass
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
+  /// Generate H from the PoseMeasurementModel with automatic differentiation. The hand written CalcJacobian is faster
+  /// and stays the default, the autodiff path is the reference for tests.
+  bool use_autodiff_jacobian_{ false };
+
+  /// Measurement jacobian w.r.t. the core and sensor error states
+  using Jacobian = PoseMeasurementJacobian::Jacobian;
+
   PoseSensorClass(const std::string& name, std::shared_ptr<CoreState> core_states)
   {
     name_ = name;
@@ -59,8 +68,17 @@ public:
 
   Eigen::MatrixXd get_covariance(const std::shared_ptr<void>& sensor_data)
   {
-    PoseSensorData data = *static_cast<PoseSensorData*>(sensor_data.get());
-    return data.get_full_cov();
+    return static_cast<PoseSensorData*>(sensor_data.get())->get_full_cov();
+  }
+
+  void FillCovariance(const std::shared_ptr<void>& sensor_data, Eigen::MatrixXd* cov)
+  {
+    static_cast<PoseSensorData*>(sensor_data.get())->get_full_cov(cov);
+  }
+
+  void ReserveStates(const size_t& num_states)
+  {
+    sensor_data_pool_.Reserve(num_states);
   }
 
   void set_initial_calib(std::shared_ptr<void> calibration)
@@ -131,63 +149,31 @@ public:
 
     // Generate measurement noise matrix and check
     // if noisevalues from the measurement object should be used
-    Eigen::MatrixXd R_meas_dyn;
+    Eigen::Matrix<double, 6, 6> R_meas;
     if (meas->has_meas_noise && use_dynamic_meas_noise_)
     {
+      Eigen::MatrixXd R_meas_dyn;
       meas->get_meas_noise(&R_meas_dyn);
+      R_meas = R_meas_dyn;
     }
     else
     {
-      R_meas_dyn = this->R_.asDiagonal();
+      R_meas = this->R_.asDiagonal();
     }
-    const Eigen::Matrix<double, 6, 6> R_meas = R_meas_dyn;
 
     const int size_of_core_state = CoreStateType::size_error_;
     const int size_of_sensor_state = prior_sensor_state.cov_size_;
     const int size_of_full_error_state = size_of_core_state + size_of_sensor_state;
-    const Eigen::MatrixXd P = prior_cov;
-    assert(P.size() == size_of_full_error_state * size_of_full_error_state);
+    assert(prior_cov.size() == size_of_full_error_state * size_of_full_error_state);
+    (void)size_of_full_error_state;
 
     // Calculate the measurement jacobian H
-    const Eigen::Matrix3d I_3 = Eigen::Matrix3d::Identity();
+    const Jacobian H = use_autodiff_jacobian_ ? CalcJacobianAutodiff(prior_core_state, prior_sensor_state) :
+                                                CalcJacobian(prior_core_state, prior_sensor_state);
+
     const Eigen::Vector3d P_wi = prior_core_state.p_wi_;
     const Eigen::Matrix3d R_wi = prior_core_state.q_wi_.toRotationMatrix();
     const Eigen::Vector3d P_ip = prior_sensor_state.p_ip_;
-    const Eigen::Matrix3d R_ip = prior_sensor_state.q_ip_.toRotationMatrix();
-
-    // Position
-    const Eigen::Matrix3d Hp_pwi = I_3;
-    const Eigen::Matrix3d Hp_vwi = Eigen::Matrix3d::Zero();
-    const Eigen::Matrix3d Hp_rwi = -R_wi * Utils::Skew(P_ip);
-    const Eigen::Matrix3d Hp_bw = Eigen::Matrix3d::Zero();
-    const Eigen::Matrix3d Hp_ba = Eigen::Matrix3d::Zero();
-    const Eigen::Matrix3d Hp_ip = R_wi;
-    const Eigen::Matrix3d Hp_rip = Eigen::Matrix3d::Zero();
-
-    // Assemble the jacobian for the position (horizontal)
-    // H_p = [Hp_pwi Hp_vwi Hp_rwi Hp_bw Hp_ba Hp_ip Hp_rip];
-    Eigen::MatrixXd H_p(3, Hp_pwi.cols() + Hp_vwi.cols() + Hp_rwi.cols() + Hp_bw.cols() + Hp_ba.cols() + Hp_ip.cols() +
-                               Hp_rip.cols());
-    H_p << Hp_pwi, Hp_vwi, Hp_rwi, Hp_bw, Hp_ba, Hp_ip, Hp_rip;
-
-    // Orientation
-    const Eigen::Matrix3d Hr_pwi = Eigen::Matrix3d::Zero();
-    const Eigen::Matrix3d Hr_vwi = Eigen::Matrix3d::Zero();
-    const Eigen::Matrix3d Hr_rwi = R_ip.transpose();
-    const Eigen::Matrix3d Hr_bw = Eigen::Matrix3d::Zero();
-    const Eigen::Matrix3d Hr_ba = Eigen::Matrix3d::Zero();
-    const Eigen::Matrix3d Hr_pip = Eigen::Matrix3d::Zero();
-    const Eigen::Matrix3d Hr_rip = I_3;
-
-    // Assemble the jacobian for the orientation (horizontal)
-    // H_r = [Hr_pwi Hr_vwi Hr_rwi Hr_bw Hr_ba Hr_pip Hr_rip];
-    Eigen::MatrixXd H_r(3, Hr_pwi.cols() + Hr_vwi.cols() + Hr_rwi.cols() + Hr_bw.cols() + Hr_ba.cols() + Hr_pip.cols() +
-                               Hr_rip.cols());
-    H_r << Hr_pwi, Hr_vwi, Hr_rwi, Hr_bw, Hr_ba, Hr_pip, Hr_rip;
-
-    // Combine all jacobians (vertical)
-    Eigen::MatrixXd H(H_p.rows() + H_r.rows(), H_r.cols());
-    H << H_p, H_r;
 
     // Calculate the residual z = z~ - (estimate)
     // Position
@@ -199,13 +185,13 @@ public:
     const Eigen::Vector3d res_r = 2 * res_q.vec() / res_q.w();
 
     // Combine residuals (vertical)
-    residual_ = Eigen::MatrixXd(res_p.rows() + res_r.rows(), 1);
+    residual_.resize(res_p.rows() + res_r.rows(), 1);
     residual_ << res_p, res_r;
 
-    // Perform EKF calculations
-    mars::Ekf ekf(H, R_meas, residual_, P);
-    const Eigen::MatrixXd correction = ekf.CalculateCorrection(&chi2_);
-    assert(correction.size() == size_of_full_error_state * 1);
+    // Perform EKF calculations, the member 'ekf_' and its outputs keep their memory between updates
+    ekf_.set_inputs(H, R_meas, residual_, prior_cov);
+    ekf_.CalculateCorrection(&chi2_, &correction_);
+    assert(correction_.size() == size_of_full_error_state * 1);
 
     // Perform Chi2 test
     if (!chi2_.passed_ && chi2_.do_test_)
@@ -214,30 +200,30 @@ public:
       return false;
     }
 
-    Eigen::MatrixXd P_updated = ekf.CalculateCovUpdate();
-    assert(P_updated.size() == size_of_full_error_state * size_of_full_error_state);
-    P_updated = Utils::EnforceMatrixSymmetry(P_updated);
+    ekf_.CalculateCovUpdate(&P_updated_);
+    assert(P_updated_.size() == size_of_full_error_state * size_of_full_error_state);
+    Utils::EnforceMatrixSymmetry(&P_updated_);
 
     // Apply Core Correction
-    CoreStateVector core_correction = correction.block(0, 0, CoreStateType::size_error_, 1);
+    CoreStateVector core_correction = correction_.block(0, 0, CoreStateType::size_error_, 1);
     CoreStateType corrected_core_state = CoreStateType::ApplyCorrection(prior_core_state, core_correction);
 
     // Apply Sensor Correction
-    const Eigen::MatrixXd sensor_correction = correction.block(size_of_core_state, 0, size_of_sensor_state, 1);
-    const PoseSensorStateType corrected_sensor_state = ApplyCorrection(prior_sensor_state, sensor_correction);
+    const PoseSensorStateType corrected_sensor_state =
+        ApplyCorrection(prior_sensor_state, correction_.block(size_of_core_state, 0, size_of_sensor_state, 1));
 
     // Return Results
     // CoreState data
     CoreType core_data;
-    core_data.cov_ = P_updated.block(0, 0, CoreStateType::size_error_, CoreStateType::size_error_);
+    core_data.cov_ = P_updated_.block(0, 0, CoreStateType::size_error_, CoreStateType::size_error_);
     core_data.state_ = corrected_core_state;
 
-    // SensorState data
-    std::shared_ptr<PoseSensorData> sensor_data(std::make_shared<PoseSensorData>());
-    sensor_data->set_cov(P_updated);
+    // SensorState data, set in a recycled object of the pool
+    std::shared_ptr<PoseSensorData> sensor_data = sensor_data_pool_.Acquire();
+    sensor_data->set_cov(P_updated_);
     sensor_data->state_ = corrected_sensor_state;
 
-    BufferDataType state_entry(std::make_shared<CoreType>(core_data), sensor_data);
+    BufferDataType state_entry(core_states_->core_type_pool_.Make(core_data), sensor_data);
 
     if (const_ref_to_nav_)
     {
@@ -253,7 +239,66 @@ public:
     return true;
   }
 
-  PoseSensorStateType ApplyCorrection(const PoseSensorStateType& prior_sensor_state, const Eigen::MatrixXd& correction)
+  ///
+  /// \brief CalcJacobian Hand written measurement jacobian H w.r.t. the core and sensor error states
+  ///
+  Jacobian CalcJacobian(const CoreStateType& core_state, const PoseSensorStateType& sensor_state) const
+  {
+    const Eigen::Matrix3d I_3 = Eigen::Matrix3d::Identity();
+    const Eigen::Matrix3d R_wi = core_state.q_wi_.toRotationMatrix();
+    const Eigen::Vector3d P_ip = sensor_state.p_ip_;
+    const Eigen::Matrix3d R_ip = sensor_state.q_ip_.toRotationMatrix();
+
+    // Position
+    const Eigen::Matrix3d Hp_pwi = I_3;
+    const Eigen::Matrix3d Hp_vwi = Eigen::Matrix3d::Zero();
+    const Eigen::Matrix3d Hp_rwi = -R_wi * Utils::Skew(P_ip);
+    const Eigen::Matrix3d Hp_bw = Eigen::Matrix3d::Zero();
+    const Eigen::Matrix3d Hp_ba = Eigen::Matrix3d::Zero();
+    const Eigen::Matrix3d Hp_ip = R_wi;
+    const Eigen::Matrix3d Hp_rip = Eigen::Matrix3d::Zero();
+
+    // Assemble the jacobian for the position (horizontal)
+    // H_p = [Hp_pwi Hp_vwi Hp_rwi Hp_bw Hp_ba Hp_ip Hp_rip];
+    Eigen::Matrix<double, 3, Jacobian::ColsAtCompileTime> H_p;
+    H_p << Hp_pwi, Hp_vwi, Hp_rwi, Hp_bw, Hp_ba, Hp_ip, Hp_rip;
+
+    // Orientation
+    const Eigen::Matrix3d Hr_pwi = Eigen::Matrix3d::Zero();
+    const Eigen::Matrix3d Hr_vwi = Eigen::Matrix3d::Zero();
+    const Eigen::Matrix3d Hr_rwi = R_ip.transpose();
+    const Eigen::Matrix3d Hr_bw = Eigen::Matrix3d::Zero();
+    const Eigen::Matrix3d Hr_ba = Eigen::Matrix3d::Zero();
+    const Eigen::Matrix3d Hr_pip = Eigen::Matrix3d::Zero();
+    const Eigen::Matrix3d Hr_rip = I_3;
+
+    // Assemble the jacobian for the orientation (horizontal)
+    // H_r = [Hr_pwi Hr_vwi Hr_rwi Hr_bw Hr_ba Hr_pip Hr_rip];
+    Eigen::Matrix<double, 3, Jacobian::ColsAtCompileTime> H_r;
+    H_r << Hr_pwi, Hr_vwi, Hr_rwi, Hr_bw, Hr_ba, Hr_pip, Hr_rip;
+
+    // Combine all jacobians (vertical)
+    Jacobian H;
+    H << H_p, H_r;
+
+    return H;
+  }
+
+  ///
+  /// \brief CalcJacobianAutodiff Measurement jacobian H generated from the templated PoseMeasurementModel
+  ///
+  /// Matches CalcJacobian up to round off and serves as test oracle for it. Only the p_wi and q_wi core error states
+  /// are seeded, the remaining core columns are zero.
+  ///
+  Jacobian CalcJacobianAutodiff(const CoreStateType& core_state, const PoseSensorStateType& sensor_state) const
+  {
+    Jacobian H;
+    PoseMeasurementJacobian::Evaluate(core_state, sensor_state, nullptr, &H);
+    return H;
+  }
+
+  PoseSensorStateType ApplyCorrection(const PoseSensorStateType& prior_sensor_state,
+                                      const Eigen::Ref<const Eigen::MatrixXd>& correction)
   {
     // state + error state correction
     // with quaternion from small angle approx -> new state
@@ -264,6 +309,12 @@ public:
         Utils::ApplySmallAngleQuatCorr(prior_sensor_state.q_ip_, correction.block(3, 0, 3, 1));
     return corrected_sensor_state;
   }
+
+private:
+  ObjectPool<PoseSensorData> sensor_data_pool_;  ///< Sensor states of the updates, sized by ReserveStates
+  Ekf ekf_;                                       ///< EKF update component, reused for each update
+  Eigen::MatrixXd correction_;                    ///< State correction of the last update
+  Eigen::MatrixXd P_updated_;                     ///< Updated covariance of the last update
 };
 }  // namespace mars
 
@@ -63,6 +63,27 @@ public:
   ///
   virtual Eigen::MatrixXd get_covariance(const std::shared_ptr<void>& sensor_data) = 0;
 
+  ///
+  /// \brief FillCovariance Writes the covariance matrix of 'sensor_data' to 'cov', see get_covariance
+  ///
+  /// The default copies the result of get_covariance. Sensors override it to fill 'cov' in place, such that 'cov'
+  /// keeps its memory between updates.
+  ///
+  virtual void FillCovariance(const std::shared_ptr<void>& sensor_data, Eigen::MatrixXd* cov)
+  {
+    *cov = get_covariance(sensor_data);
+  }
+
+  ///
+  /// \brief ReserveStates Prepares the sensor to hold 'num_states' sensor states without an allocation
+  ///
+  /// Called by the CoreLogic with the capacity of its buffer before the sensor is initialized. The default does
+  /// nothing, sensors which recycle their sensor states override it.
+  ///
+  virtual void ReserveStates(const size_t& /*num_states*/)
+  {
+  }
+
 protected:
   // SensorInterface(); // construction for child classes only
 };
@@ -0,0 +1,125 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef SHM_STATE_PUBLISHER_H
+#define SHM_STATE_PUBLISHER_H
+
+#include <mars/sensors/sensor_abs_class.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <mars/type_definitions/shm_state_layout.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief Function to flatten a sensor state into the fixed shared memory layout
+///
+/// \param sensor_state Sensor state as stored in the buffer (BindSensorData<T>)
+/// \param state Output for the sensor state elements
+/// \param cov_diag Output for the diagonal of the sensor covariance
+/// \param max_size Max number of elements that can be written to 'state' and 'cov_diag'
+/// \return Number of written elements
+///
+using ShmSensorPacker =
+    std::function<int(const std::shared_ptr<void>& sensor_state, double* state, double* cov_diag, int max_size)>;
+
+///
+/// \brief The ShmStatePublisher class writes the newest filter states into a POSIX shared memory ring
+///
+/// Each state is written into the next ring slot, guarded by a per slot sequence lock. Readers in other processes
+/// (see ShmStateReader) map the same segment and retrieve the newest state without any interaction with the filter
+/// process. The publisher is fed by the CoreLogic after each propagation and sensor update.
+///
+/// Sensor calibration states are only published for registered sensors since the sensor state types are not known to
+/// the publisher. The latest state of every registered sensor is kept and written with each slot.
+///
+class ShmStatePublisher
+{
+public:
+  ///
+  /// \brief ShmStatePublisher
+  /// \param name Name of the shared memory object, e.g. "/mars_states"
+  /// \param num_slots Number of ring slots
+  /// \param cov_mode Publish the full core covariance or only its diagonal
+  ///
+  ShmStatePublisher(std::string name, const uint32_t& num_slots = 16,
+                    const shm::CovMode& cov_mode = shm::CovMode::diagonal);
+  ~ShmStatePublisher();
+
+  ShmStatePublisher(const ShmStatePublisher&) = delete;
+  ShmStatePublisher& operator=(const ShmStatePublisher&) = delete;
+
+  ///
+  /// \brief Open Creates and maps the shared memory segment
+  /// \return true if the segment is ready for publishing, false otherwise
+  ///
+  bool Open();
+
+  ///
+  /// \brief Close Unmaps the segment and removes the shared memory object
+  ///
+  void Close();
+
+  ///
+  /// \brief IsOpen
+  /// \return true if the segment is mapped
+  ///
+  bool IsOpen() const;
+
+  ///
+  /// \brief RegisterSensor Adds a sensor for which the calibration states are published
+  /// \param sensor Sensor handle
+  /// \param packer Function to flatten the sensor state
+  /// \return Sensor id used in the shared memory blocks, -1 if the max number of sensors is reached
+  ///
+  int RegisterSensor(const std::shared_ptr<SensorAbsClass>& sensor, ShmSensorPacker packer);
+
+  ///
+  /// \brief Publish Writes the states of a buffer entry into the next ring slot
+  /// \param entry Buffer entry with core state, and optionally a sensor state
+  /// \return true if the state was published
+  ///
+  bool Publish(const BufferEntryType& entry);
+
+  ///
+  /// \brief get_write_count
+  /// \return Number of published states
+  ///
+  uint64_t get_write_count() const;
+
+  std::shared_ptr<SensorAbsClass> propagation_sensor_{ nullptr };  ///< Entries of this sensor get source id -1
+
+private:
+  struct RegisteredSensor
+  {
+    std::shared_ptr<SensorAbsClass> sensor;
+    ShmSensorPacker packer;
+  };
+
+  int FindSensorId(const SensorAbsClass* sensor) const;
+
+  std::string name_;
+  uint32_t num_slots_;
+  shm::CovMode cov_mode_;
+
+  void* segment_{ nullptr };
+  size_t segment_size_{ 0 };
+  shm::ShmStateHeader* header_{ nullptr };
+  shm::ShmStateSlot* slots_{ nullptr };
+
+  std::vector<RegisteredSensor> sensors_;
+  std::vector<shm::ShmSensorBlock> sensor_blocks_;  ///< Latest state of each registered sensor
+};
+}  // namespace mars
+
+#endif  // SHM_STATE_PUBLISHER_H
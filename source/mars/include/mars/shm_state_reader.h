@@ -0,0 +1,80 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef SHM_STATE_READER_H
+#define SHM_STATE_READER_H
+
+#include <mars/type_definitions/shm_state_layout.h>
+#include <string>
+
+namespace mars
+{
+///
+/// \brief The ShmStateReader class reads states from a segment written by the ShmStatePublisher
+///
+/// The reader maps the segment read-only and never blocks the publisher. A slot that is modified while it is copied
+/// is detected by its sequence lock and the copy is repeated.
+///
+class ShmStateReader
+{
+public:
+  ShmStateReader(std::string name);
+  ~ShmStateReader();
+
+  ShmStateReader(const ShmStateReader&) = delete;
+  ShmStateReader& operator=(const ShmStateReader&) = delete;
+
+  ///
+  /// \brief Open Maps an existing shared memory segment
+  /// \return true if the segment exists and the layout version matches
+  ///
+  bool Open();
+
+  ///
+  /// \brief Close Unmaps the segment
+  ///
+  void Close();
+
+  bool IsOpen() const;
+
+  ///
+  /// \brief get_write_count
+  /// \return Number of states that were published, 0 if the segment is not open
+  ///
+  uint64_t get_write_count() const;
+
+  ///
+  /// \brief get_latest Copies the newest consistent state
+  /// \param payload Output parameter for the state
+  /// \param write_count Optional output for the write count that belongs to the returned state
+  /// \return true if a state was available
+  ///
+  bool get_latest(shm::ShmStatePayload* payload, uint64_t* write_count = nullptr) const;
+
+  ///
+  /// \brief get_by_count Copies the state with the given write count if it was not overwritten yet
+  /// \param count Write count of the state, starting at 1 for the first published state
+  /// \param payload Output parameter for the state
+  /// \return true if the state is still available in the ring
+  ///
+  bool get_by_count(const uint64_t& count, shm::ShmStatePayload* payload) const;
+
+  int max_retries_{ 64 };  ///< Max number of copy attempts before a slot is reported as unavailable
+
+private:
+  std::string name_;
+  void* segment_{ nullptr };
+  size_t segment_size_{ 0 };
+  const shm::ShmStateHeader* header_{ nullptr };
+  const shm::ShmStateSlot* slots_{ nullptr };
+};
+}  // namespace mars
+
+#endif  // SHM_STATE_READER_H
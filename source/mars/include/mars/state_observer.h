@@ -0,0 +1,89 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef STATE_OBSERVER_H
+#define STATE_OBSERVER_H
+
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief StateObserver Called once for each state the filter produces
+///
+/// \param state_entry Buffer entry with the core state, and the sensor state for sensor updates
+/// \param is_correction True if the state replaces a previously delivered state of the same entry after a buffer
+/// rework, or if it was produced by a rework for an out of order measurement
+///
+using StateObserver = std::function<void(const BufferEntryType& state_entry, const bool& is_correction)>;
+
+///
+/// \brief The StateEvent struct is an element of the StateEventQueue
+///
+struct StateEvent
+{
+  BufferEntryType entry_;        ///< Buffer entry with the produced state
+  bool is_correction_{ false };  ///< True if the state was produced by a buffer rework
+};
+
+///
+/// \brief The StateEventQueue class is a lock-free single producer, single consumer ring of state events
+///
+/// The filter thread pushes the events, one consumer thread pops them. No locks are taken and, after the construction,
+/// no memory is allocated by the queue itself. If the queue is full, new events are dropped and counted.
+///
+class StateEventQueue
+{
+public:
+  ///
+  /// \brief StateEventQueue
+  /// \param capacity Max number of queued events
+  ///
+  StateEventQueue(const size_t& capacity = 1024);
+
+  ///
+  /// \brief Push Adds an event, only called by the producer
+  /// \return false if the queue is full and the event was dropped
+  ///
+  bool Push(const BufferEntryType& entry, const bool& is_correction);
+
+  ///
+  /// \brief Pop Removes the oldest event, only called by the consumer
+  /// \param event Output for the event
+  /// \return false if the queue is empty
+  ///
+  bool Pop(StateEvent* event);
+
+  ///
+  /// \brief get_size
+  /// \return Number of queued events
+  ///
+  size_t get_size() const;
+
+  ///
+  /// \brief get_num_dropped
+  /// \return Number of events which were dropped because the queue was full
+  ///
+  uint64_t get_num_dropped() const;
+
+private:
+  std::vector<StateEvent> slots_;           ///< Ring storage, one slot more than the capacity
+  std::atomic<size_t> head_{ 0 };           ///< Next slot to pop, written by the consumer
+  std::atomic<size_t> tail_{ 0 };           ///< Next slot to push, written by the producer
+  std::atomic<uint64_t> num_dropped_{ 0 };  ///< Events dropped because the queue was full
+};
+}  // namespace mars
+
+#endif  // STATE_OBSERVER_H
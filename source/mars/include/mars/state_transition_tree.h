@@ -0,0 +1,74 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef STATE_TRANSITION_TREE_H
+#define STATE_TRANSITION_TREE_H
+
+#include <mars/type_definitions/core_state_type.h>
+#include <Eigen/Dense>
+#include <Eigen/StdVector>
+#include <vector>
+
+namespace mars
+{
+///
+/// \brief The StateTransitionTree class answers products of consecutive state transition matrices in O(log n)
+///
+/// The tree is a segment tree over 'size' leaves, leaf k holds the state transition F_k of buffer entry k. Each inner
+/// node holds the product of its two children, such that the product F_last * ... * F_first of any range is composed
+/// of at most 2 log(n) nodes. Leaves which are not set are the identity.
+///
+/// Leaves are set lazily, inner nodes are only recomputed by the next Query.
+///
+class StateTransitionTree
+{
+public:
+  ///
+  /// \brief Resize Sets the number of leaves, all leaves are reset to the identity
+  ///
+  void Resize(const int& size);
+
+  ///
+  /// \brief size
+  /// \return Number of leaves
+  ///
+  int size() const;
+
+  ///
+  /// \brief SetLeaf Sets the state transition of leaf 'idx', inner nodes are updated by the next Query
+  ///
+  void SetLeaf(const int& idx, const CoreStateMatrix& transition);
+
+  ///
+  /// \brief Query Returns the state transition F_last * ... * F_first
+  /// \param first Index of the oldest transition
+  /// \param last Index of the newest transition, the identity is returned if 'last' < 'first'
+  ///
+  CoreStateMatrix Query(const int& first, const int& last);
+
+private:
+  ///
+  /// \brief UpdateInnerNodes Recomputes the inner nodes above all leaves which were set since the last update
+  ///
+  void UpdateInnerNodes();
+
+  ///
+  /// \brief ComputeNodes Computes the inner nodes [first, last] of one tree level from their children
+  ///
+  void ComputeNodes(const int& first, const int& last);
+
+  std::vector<CoreStateMatrix, Eigen::aligned_allocator<CoreStateMatrix>> nodes_;  ///< [unused, inner nodes, leaves]
+  int size_{ 0 };
+  int dirty_first_{ -1 };  ///< First leaf which was set since the last update, -1 if none
+  int dirty_last_{ -1 };   ///< Last leaf which was set since the last update
+};
+}  // namespace mars
+
+#endif  // STATE_TRANSITION_TREE_H
@@ -12,6 +12,7 @@
 #define TIME_H
 
 #include <ctime>
+#include <cstdint>
 #include <iostream>
 
 namespace mars
@@ -24,6 +25,12 @@ public:
 
   static Time get_time_now();
 
+  ///
+  /// \brief get_wall_time_ns
+  /// \return Nanoseconds since epoch of the system clock
+  ///
+  static int64_t get_wall_time_ns();
+
   double get_seconds() const;
   Time abs() const;
 
@@ -14,6 +14,7 @@
 #include <mars/sensors/sensor_abs_class.h>
 #include <mars/time.h>
 #include <mars/type_definitions/buffer_data_type.h>
+#include <cstdint>
 #include <iostream>
 #include <set>
 
@@ -44,6 +45,7 @@ public:
   BufferDataType data_{};
   std::shared_ptr<SensorAbsClass> sensor_handle_{ nullptr };
   int metadata_{ BufferMetadataType::invalid };
+  int64_t arrival_ns_{ 0 };  ///< Wall time the measurement arrived at the filter [ns since epoch], 0 if unknown
 
   BufferEntryType() = default;
 
@@ -97,8 +99,9 @@ public:
   void ClearStates();
 
 private:
-  std::set<int> metadata_valid_filter_;
-  std::set<int> metadata_auto_filter_;
+  // Shared by all entries, copies of an entry do not allocate filter sets
+  static const std::set<int> metadata_valid_filter_;
+  static const std::set<int> metadata_auto_filter_;
 };
 }  // namespace mars
 #endif  // BUFFERENTRYTYPE_H
@@ -17,6 +17,15 @@
 
 namespace mars
 {
+///
+/// \brief The StateTransitionType enum selects the state transition and process noise of the covariance prediction
+///
+enum class StateTransitionType
+{
+  small_angle_approx,  ///< Truncated series in w_est * dt, accurate for small rotations within one propagation step
+  closed_form          ///< Closed-form integration of the rotation, accurate for large propagation steps
+};
+
 class CoreStateType
 {
 public:
@@ -0,0 +1,109 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef FLIGHT_RECORDER_LAYOUT_H
+#define FLIGHT_RECORDER_LAYOUT_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace mars
+{
+///
+/// \brief Fixed file layout of the flight recorder ring
+///
+/// The file starts with a FlightRecorderHeader, followed by 'num_slots' FlightRecordSlot elements. All members are
+/// plain data such that a recording can be read after a crash without linking against the filter.
+///
+/// \note The layout is versioned with 'kFlightRecorderVersion'. Any change of the structures below must increase the
+/// version.
+///
+namespace flight
+{
+constexpr uint64_t kFlightRecorderMagic = 0x3143455246535261ULL;  ///< "aRSFREC1"
+constexpr uint32_t kFlightRecorderVersion = 1;
+constexpr int kMaxSensors = 16;           ///< Max number of sensor names in the file header
+constexpr int kMaxSensorNameLength = 32;  ///< Max length of the sensor name including the terminating zero
+constexpr int kMaxValues = 48;            ///< Max number of payload values per record
+
+///
+/// \brief Content of a record
+///
+enum class RecordType : uint32_t
+{
+  measurement = 0,  ///< 'values' holds the encoded measurement, empty if the sensor has no encoder
+  state = 1,        ///< 'values' holds the core state [p v q(w x y z) b_w b_a w_m a_m] followed by the cov diagonal
+  update = 2        ///< Update decision, see 'chi2', 'ucv' and the record flags
+};
+
+///
+/// \brief Bit flags of a record
+///
+constexpr uint32_t kFlagCorrection = 1u << 0;           ///< State was generated by a buffer rework
+constexpr uint32_t kFlagChi2Tested = 1u << 1;           ///< Chi2 test was performed for the update
+constexpr uint32_t kFlagChi2Passed = 1u << 2;           ///< Chi2 test passed
+constexpr uint32_t kFlagNearestCovCorrected = 1u << 3;  ///< Prior covariance had negative eigenvalues, see NearestCov
+constexpr uint32_t kFlagUpdateSuccessful = 1u << 4;     ///< Sensor update returned successfully
+
+///
+/// \brief Payload of one ring slot
+///
+struct FlightRecord
+{
+  double timestamp;    ///< Filter timestamp of the measurement or state
+  int64_t wall_ns;     ///< Wall time of the record [ns since epoch]
+  int32_t sensor_id;   ///< Index at which the sensor was registered with the recorder, -1 if not registered
+  uint32_t type;       ///< RecordType
+  uint32_t flags;      ///< Combination of the kFlag bits
+  int32_t num_values;  ///< Number of valid elements in 'values'
+  double chi2;         ///< Chi2 value of the update, 0 if not tested
+  double ucv;          ///< Upper critical value of the Chi2 test
+  double values[kMaxValues];
+};
+
+///
+/// \brief One ring slot, guarded by a sequence lock
+///
+/// For the n-th record (starting at n=1) the sequence is 2n-1 during the write and 2n afterwards. Slots with an odd
+/// sequence were interrupted by a crash and are skipped by the reader.
+///
+struct alignas(64) FlightRecordSlot
+{
+  std::atomic<uint64_t> seq;
+  FlightRecord record;
+};
+
+///
+/// \brief Header of the recorder file
+///
+struct alignas(64) FlightRecorderHeader
+{
+  uint64_t magic;
+  uint32_t version;
+  uint32_t num_slots;
+  uint32_t slot_size;
+  uint32_t num_sensors;
+  std::atomic<uint64_t> write_count;  ///< Number of records, the newest slot is (write_count - 1) % num_slots
+  char sensor_names[kMaxSensors][kMaxSensorNameLength];
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "The flight recorder ring requires lock free 64 bit atomics");
+
+///
+/// \brief get_file_size Size in bytes of a recorder file with 'num_slots' ring slots
+///
+inline size_t get_file_size(const uint32_t& num_slots)
+{
+  return sizeof(FlightRecorderHeader) + static_cast<size_t>(num_slots) * sizeof(FlightRecordSlot);
+}
+}  // namespace flight
+}  // namespace mars
+
+#endif  // FLIGHT_RECORDER_LAYOUT_H
@@ -0,0 +1,65 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef JOURNAL_RECORD_H
+#define JOURNAL_RECORD_H
+
+#include <cstdint>
+
+namespace mars
+{
+///
+/// \brief Binary layout of the measurement journal
+///
+/// The file starts with a JournalFileHeader, followed by the sensor table with 'num_sensors' entries of
+/// [uint32_t name_length, char name[name_length]]. The remaining file is a sequence of records, each a
+/// JournalRecordHeader followed by 'num_values' doubles. All values are written in the native byte order.
+///
+/// \note The layout is versioned with 'kJournalVersion'. Any change of the structures below must increase the version.
+///
+namespace journal
+{
+constexpr uint64_t kJournalMagic = 0x314e524a5352614dULL;  ///< "MaRSJRN1"
+constexpr uint32_t kJournalVersion = 1;
+constexpr int kMaxValues = 64;  ///< Max number of payload values per record
+
+///
+/// \brief Header at the beginning of the journal file
+///
+struct JournalFileHeader
+{
+  uint64_t magic;
+  uint32_t version;
+  uint32_t num_sensors;
+};
+
+///
+/// \brief Header of one journaled ProcessMeasurement call
+///
+struct JournalRecordHeader
+{
+  uint32_t sensor_id;   ///< Index at which the sensor was registered with the journal
+  uint32_t num_values;  ///< Number of payload values following the header
+  double timestamp;     ///< Measurement timestamp as passed to ProcessMeasurement
+  int64_t arrival_ns;   ///< Arrival time as passed to ProcessMeasurement [ns since epoch]
+};
+
+///
+/// \brief One ring slot of the journal, only the first 'num_values' payload values are written to the file
+///
+struct JournalRecord
+{
+  JournalRecordHeader header;
+  double values[kMaxValues];
+};
+}  // namespace journal
+}  // namespace mars
+
+#endif  // JOURNAL_RECORD_H
@@ -0,0 +1,120 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef MCAP_RECORD_H
+#define MCAP_RECORD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace mars
+{
+namespace mcap
+{
+///
+/// Record layout of the MCAP container (https://mcap.dev/spec), version 0. Each record is an opcode (uint8), the
+/// content length (uint64) and the content. Integers are little endian, strings and byte arrays are prefixed with their
+/// length (uint32, byte arrays of chunks uint64).
+///
+constexpr uint8_t kMagic[8] = { 0x89, 'M', 'C', 'A', 'P', '0', '\r', '\n' };
+constexpr int kMagicSize = 8;
+constexpr int kRecordPrefixSize = 9;  ///< Opcode and content length
+
+constexpr const char* kMessageEncoding = "mars-f64";  ///< Payload of little endian doubles, see mcap_codecs.h
+constexpr const char* kLibrary = "mars";
+
+enum Opcode : uint8_t
+{
+  kHeader = 0x01,
+  kFooter = 0x02,
+  kSchema = 0x03,
+  kChannel = 0x04,
+  kMessage = 0x05,
+  kChunk = 0x06,
+  kMessageIndex = 0x07,
+  kChunkIndex = 0x08,
+  kAttachment = 0x09,
+  kAttachmentIndex = 0x0A,
+  kStatistics = 0x0B,
+  kMetadata = 0x0C,
+  kMetadataIndex = 0x0D,
+  kSummaryOffset = 0x0E,
+  kDataEnd = 0x0F
+};
+
+///
+/// \brief Crc32 CRC-32 (ISO-HDLC) as used for the chunk records
+/// \param crc CRC of the preceding data for a continued computation
+///
+inline uint32_t Crc32(const uint8_t* data, const size_t& size, uint32_t crc = 0)
+{
+  crc = ~crc;
+  for (size_t k = 0; k < size; k++)
+  {
+    crc ^= data[k];
+    for (int bit = 0; bit < 8; bit++)
+    {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+///
+/// \brief AppendLE Appends the 'num_bytes' lower bytes of 'value' in little endian order
+///
+inline void AppendLE(std::vector<uint8_t>* bytes, const uint64_t& value, const int& num_bytes)
+{
+  for (int k = 0; k < num_bytes; k++)
+  {
+    bytes->push_back(static_cast<uint8_t>(value >> (8 * k)));
+  }
+}
+
+///
+/// \brief ReadLE Reads a little endian integer of 'num_bytes' bytes
+///
+inline uint64_t ReadLE(const uint8_t* bytes, const int& num_bytes)
+{
+  uint64_t value = 0;
+  for (int k = 0; k < num_bytes; k++)
+  {
+    value |= static_cast<uint64_t>(bytes[k]) << (8 * k);
+  }
+  return value;
+}
+
+inline void AppendString(std::vector<uint8_t>* bytes, const std::string& value)
+{
+  AppendLE(bytes, value.size(), 4);
+  bytes->insert(bytes->end(), value.begin(), value.end());
+}
+
+inline void AppendDouble(std::vector<uint8_t>* bytes, const double& value)
+{
+  uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  AppendLE(bytes, bits, 8);
+}
+
+inline double ReadDouble(const uint8_t* bytes)
+{
+  const uint64_t bits = ReadLE(bytes, 8);
+  double value = 0;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+}  // namespace mcap
+}  // namespace mars
+
+#endif  // MCAP_RECORD_H
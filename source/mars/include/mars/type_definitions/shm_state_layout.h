@@ -0,0 +1,113 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef SHM_STATE_LAYOUT_H
+#define SHM_STATE_LAYOUT_H
+
+#include <mars/type_definitions/core_state_type.h>
+#include <atomic>
+#include <cstdint>
+
+namespace mars
+{
+///
+/// \brief Fixed memory layout of the shared memory state ring
+///
+/// The segment starts with a ShmStateHeader, followed by 'num_slots_' ShmStateSlot elements. All members are plain
+/// data such that readers in other processes can map the segment without linking against the filter.
+///
+/// \note The layout is versioned with 'kShmStateLayoutVersion'. Any change of the structures below must increase the
+/// version.
+///
+namespace shm
+{
+constexpr uint64_t kShmStateMagic = 0x4d6152535f53484dULL;  ///< "MaRS_SHM"
+constexpr uint32_t kShmStateLayoutVersion = 1;
+constexpr int kMaxSensors = 16;          ///< Max number of sensor calibration blocks per slot
+constexpr int kMaxSensorStates = 32;     ///< Max number of sensor state elements per sensor block
+constexpr int kMaxSensorNameLength = 32;  ///< Max length of the sensor name including the terminating zero
+constexpr int kCoreStateSize = 22;  ///< [p_wi(3) v_wi(3) q_wi(4, w x y z) b_w(3) b_a(3) w_m(3) a_m(3)]
+constexpr int kCoreCovSize = CoreStateType::size_error_ * CoreStateType::size_error_;
+
+///
+/// \brief Determines if the full core covariance or only the diagonal is written to the slots
+///
+enum class CovMode : uint32_t
+{
+  diagonal = 0,
+  full = 1
+};
+
+///
+/// \brief Calibration state of one registered sensor
+///
+struct ShmSensorBlock
+{
+  int32_t sensor_id;  ///< Index at which the sensor was registered with the publisher
+  int32_t size;       ///< Number of valid elements in 'state' and 'cov_diag'
+  char name[kMaxSensorNameLength];
+  double timestamp;  ///< Timestamp of the latest sensor state
+  double state[kMaxSensorStates];
+  double cov_diag[kMaxSensorStates];
+};
+
+///
+/// \brief Payload of one ring slot, copied by the reader as a whole
+///
+struct ShmStatePayload
+{
+  double timestamp;         ///< Timestamp of the core state
+  int32_t source_sensor_id;  ///< Sensor id of the entry that generated the state, -1 for the propagation sensor
+  uint32_t cov_mode;         ///< CovMode used for 'core_cov'
+  double core_state[kCoreStateSize];
+  double core_cov[kCoreCovSize];  ///< Row major full covariance or the first 'size_error_' elements as diagonal
+  int32_t num_sensors;
+  int32_t reserved;
+  ShmSensorBlock sensors[kMaxSensors];
+};
+
+///
+/// \brief One ring slot, guarded by a sequence lock
+///
+/// The sequence is odd while the writer modifies the payload and even once the payload is consistent. For the n-th
+/// published state (starting at n=1) the sequence is 2n-1 during the write and 2n afterwards.
+///
+struct alignas(64) ShmStateSlot
+{
+  std::atomic<uint64_t> seq;
+  ShmStatePayload payload;
+};
+
+///
+/// \brief Header of the shared memory segment
+///
+struct alignas(64) ShmStateHeader
+{
+  uint64_t magic;
+  uint32_t version;
+  uint32_t num_slots;
+  uint32_t slot_size;
+  uint32_t cov_mode;
+  std::atomic<uint64_t> write_count;  ///< Number of published states, the newest slot is (write_count - 1) % num_slots
+};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "The shared memory ring requires lock free 64 bit atomics");
+
+///
+/// \brief get_segment_size Size in bytes of a segment with 'num_slots' ring slots
+///
+inline size_t get_segment_size(const uint32_t& num_slots)
+{
+  return sizeof(ShmStateHeader) + static_cast<size_t>(num_slots) * sizeof(ShmStateSlot);
+}
+}  // namespace shm
+}  // namespace mars
+
+#endif  // SHM_STATE_LAYOUT_H
@@ -0,0 +1,54 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/allocation_counter.h>
+#include <atomic>
+
+namespace mars
+{
+namespace
+{
+thread_local bool is_counting = false;
+thread_local long num_allocations = 0;
+std::atomic<bool> is_hooked{ false };
+}  // namespace
+
+void AllocationCounter::Start()
+{
+  num_allocations = 0;
+  is_counting = true;
+}
+
+long AllocationCounter::Stop()
+{
+  is_counting = false;
+  return num_allocations;
+}
+
+long AllocationCounter::get_count()
+{
+  return num_allocations;
+}
+
+void AllocationCounter::Record() noexcept
+{
+  if (!is_hooked.load(std::memory_order_relaxed))
+  {
+    is_hooked.store(true, std::memory_order_relaxed);
+  }
+
+  num_allocations += is_counting;
+}
+
+bool AllocationCounter::IsHooked()
+{
+  return is_hooked.load(std::memory_order_relaxed);
+}
+}  // namespace mars
@@ -11,6 +11,7 @@
 // and <martin.scheiber@ieee.org>
 
 #include <mars/buffer.h>
+#include <iterator>
 #include <utility>
 
 namespace mars
@@ -30,6 +31,9 @@ Buffer::Buffer(const int& size)
 void Buffer::set_max_buffer_size(const int& size)
 {
   max_buffer_size_ = std::abs(size);
+
+  // Entries are added before the overflow is removed, e.g. intermediate states and coalesced out of order measurements
+  ReserveEntries(max_buffer_size_ + max_buffer_size_ / 4 + 16);
 }
 
 void Buffer::set_keep_last_sensor_handle(const bool& value)
@@ -45,6 +49,7 @@ int Buffer::get_max_buffer_size() const
 void Buffer::ResetBufferData()
 {
   data_.erase(data_.begin(), data_.end());
+  hot_.erase(hot_.begin(), hot_.end());
 }
 
 bool Buffer::IsEmpty() const
@@ -86,11 +91,11 @@ bool Buffer::get_latest_state(BufferEntryType* entry) const
   }
 
   // iterate backwards
-  for (auto k = data_.rbegin(); k != data_.rend(); ++k)
+  for (int k = get_length() - 1; k >= 0; --k)
   {
-    if (k->HasStates())
+    if (hot_[k].has_states_)
     {
-      *entry = *k;
+      *entry = data_[k];
       return true;
     }
   }
@@ -106,11 +111,11 @@ bool Buffer::get_oldest_state(BufferEntryType* entry) const
   }
 
   // iterate forwards
-  for (const auto& k : data_)
+  for (int k = 0; k < get_length(); ++k)
   {
-    if (k.HasStates())
+    if (hot_[k].has_states_)
     {
-      *entry = k;
+      *entry = data_[k];
       return true;
     }
   }
@@ -126,11 +131,11 @@ bool Buffer::get_oldest_core_state(BufferEntryType* entry) const
   }
 
   // iterate forwards (oldest to newest)
-  for (const auto& k : data_)
+  for (int k = 0; k < get_length(); ++k)
   {
-    if (k.HasStates() && k.IsValid())
+    if (hot_[k].has_states_ && hot_[k].is_valid_)
     {
-      *entry = k;
+      *entry = data_[k];
       return true;
     }
   }
@@ -146,13 +151,13 @@ bool Buffer::get_latest_init_state(BufferEntryType* entry) const
   }
 
   // iterate backwards (newest to oldest)
-  for (auto k = data_.rbegin(); k != data_.rend(); ++k)
+  for (int k = get_length() - 1; k >= 0; --k)
   {
-    if (k->HasStates())
+    if (hot_[k].has_states_)
     {
-      if (k->metadata_ == BufferMetadataType::init)
+      if (hot_[k].metadata_ == BufferMetadataType::init)
       {
-        *entry = *k;
+        *entry = data_[k];
         return true;
       }
     }
@@ -178,11 +183,11 @@ bool Buffer::get_latest_sensor_handle_state(const std::shared_ptr<SensorAbsClass
   }
 
   // iterate backwards
-  for (int k = data_.size() - 1; k >= 0; --k)
+  for (int k = get_length() - 1; k >= 0; --k)
   {
-    if (data_[k].HasStates())
+    if (hot_[k].has_states_)
     {
-      if (data_[k].sensor_handle_.get() == sensor_handle.get())
+      if (hot_[k].sensor_handle_ == sensor_handle.get())
       {
         *entry = data_[k];
         *index = k;
@@ -204,13 +209,13 @@ bool Buffer::get_oldest_sensor_handle_state(const std::shared_ptr<SensorAbsClass
   }
 
   // iterate forwards (oldest to newest)
-  for (const auto& k : data_)
+  for (int k = 0; k < get_length(); ++k)
   {
-    if (k.HasStates())
+    if (hot_[k].has_states_)
     {
-      if (k.sensor_handle_.get() == sensor_handle.get())
+      if (hot_[k].sensor_handle_ == sensor_handle.get())
       {
-        *entry = k;
+        *entry = data_[k];
         return true;
       }
     }
@@ -229,11 +234,11 @@ bool Buffer::get_latest_sensor_handle_measurement(const std::shared_ptr<SensorAb
 
   // Iterate backwards (newest to oldest)
   // Every entry does have a measurement
-  for (auto k = data_.rbegin(); k != data_.rend(); ++k)
+  for (int k = get_length() - 1; k >= 0; --k)
   {
-    if (k->sensor_handle_.get() == sensor_handle.get())
+    if (hot_[k].sensor_handle_ == sensor_handle.get())
     {
-      *entry = *k;
+      *entry = data_[k];
       return true;
     }
   }
@@ -253,11 +258,11 @@ bool Buffer::get_sensor_handle_measurements(const std::shared_ptr<SensorAbsClass
   entries->clear();
 
   // iterate forwards (oldest to newest)
-  for (const auto& k : data_)
+  for (int k = 0; k < get_length(); ++k)
   {
-    if (k.sensor_handle_.get() == sensor_handle.get())
+    if (hot_[k].sensor_handle_ == sensor_handle.get())
     {
-      entries->push_back(&k);
+      entries->push_back(&data_[k]);
     }
   }
 
@@ -285,13 +290,13 @@ bool Buffer::get_closest_state(const Time& timestamp, BufferEntryType* entry, in
   bool found_state = false;
 
   // iterate backwards / start with latest entry
-  for (int k = data_.size() - 1; k >= 0; --k)
+  for (int k = get_length() - 1; k >= 0; --k)
   {
-    if (data_[k].HasStates())
+    if (hot_[k].has_states_)
     {
       found_state = true;
 
-      Time current_distance = (timestamp - data_[k].timestamp_).abs();
+      Time current_distance = (timestamp - hot_[k].timestamp_).abs();
 
       if (current_distance < time_distance)
       {
@@ -346,39 +351,141 @@ bool Buffer::RemoveSensorFromBuffer(const std::shared_ptr<SensorAbsClass>& senso
     return false;
   }
 
-  for (auto it = data_.begin(); it != data_.end();)
+  RemoveSensorEntries({ sensor_handle }, 0, get_length());
+  return true;
+}
+
+int Buffer::RemoveSensorEntries(const std::vector<std::shared_ptr<SensorAbsClass>>& sensor_handles,
+                                const int& start_idx, const int& end_idx)
+{
+  const int first = std::max(start_idx, 0);
+  const int last = std::min(end_idx, get_length());
+
+  auto is_removed = [&sensor_handles](const HotEntry& hot_entry) {
+    for (const auto& k : sensor_handles)
+    {
+      if (hot_entry.sensor_handle_ == k.get())
+      {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // Move the remaining entries of the range to the front of the range
+  int write_idx = first;
+  for (int k = first; k < last; k++)
   {
-    if (it->sensor_handle_ == sensor_handle)
+    if (is_removed(hot_[k]))
     {
-      // Erase returns the next iterator
-      it = data_.erase(it);
+      continue;
     }
-    else
+
+    if (write_idx != k)
     {
-      // Only increment if we didn't delete
-      it++;
+      data_[write_idx] = std::move(data_[k]);
+      hot_[write_idx] = hot_[k];
     }
+    write_idx++;
   }
 
-  return true;
+  if (write_idx < last)
+  {
+    data_.erase(data_.begin() + write_idx, data_.begin() + last);
+    hot_.erase(hot_.begin() + write_idx, hot_.begin() + last);
+  }
+
+  return last - write_idx;
+}
+
+int Buffer::get_rework_segment_start_idx(const int& idx,
+                                         const std::shared_ptr<SensorAbsClass>& propagation_sensor) const
+{
+  std::vector<const SensorAbsClass*> update_sensors;
+  for (int k = std::max(idx, 0); k < get_length(); k++)
+  {
+    const SensorAbsClass* sensor = hot_[k].sensor_handle_;
+    if (sensor != propagation_sensor.get() &&
+        std::find(update_sensors.begin(), update_sensors.end(), sensor) == update_sensors.end())
+    {
+      update_sensors.push_back(sensor);
+    }
+  }
+
+  // Iterate backwards until the latest state and the latest state of each update sensor were found
+  int start_idx = std::min(idx, get_length());
+  bool found_latest_state = false;
+
+  for (int k = start_idx - 1; k >= 0 && (!found_latest_state || !update_sensors.empty()); --k)
+  {
+    if (!hot_[k].has_states_)
+    {
+      continue;
+    }
+
+    const auto it = std::find(update_sensors.begin(), update_sensors.end(), hot_[k].sensor_handle_);
+    if (!found_latest_state || it != update_sensors.end())
+    {
+      start_idx = k;
+      found_latest_state = true;
+    }
+
+    if (it != update_sensors.end())
+    {
+      update_sensors.erase(it);
+    }
+  }
+
+  return start_idx;
+}
+
+void Buffer::CopyEntriesStartingAtIdx(const Buffer& source, const int& idx)
+{
+  const int first = std::min(std::max(idx, 0), source.get_length());
+
+  // circular_buffer::assign would shrink the capacity to the number of entries
+  data_.clear();
+  hot_.clear();
+  ReserveEntries(std::max(source.data_.capacity(), data_.capacity()));
+  data_.insert(data_.end(), source.data_.begin() + first, source.data_.end());
+  hot_.insert(hot_.end(), source.hot_.begin() + first, source.hot_.end());
+  max_buffer_size_ = source.max_buffer_size_;
+  keep_last_sensor_handle_ = source.keep_last_sensor_handle_;
+  verbose_ = source.verbose_;
+}
+
+void Buffer::SpliceEntriesStartingAtIdx(const int& idx, Buffer* segment)
+{
+  const int first = std::min(std::max(idx, 0), get_length());
+
+  data_.erase(data_.begin() + first, data_.end());
+  hot_.erase(hot_.begin() + first, hot_.end());
+  ReserveEntries(data_.size() + segment->data_.size());
+  std::move(segment->data_.begin(), segment->data_.end(), std::back_inserter(data_));
+  hot_.insert(hot_.end(), segment->hot_.begin(), segment->hot_.end());
+  segment->ResetBufferData();
+}
+
+int Buffer::LowerBoundIdx(const Time& timestamp) const
+{
+  const auto it = std::lower_bound(hot_.begin(), hot_.end(), timestamp,
+                                   [](const HotEntry& hot_entry, const Time& t) { return hot_entry.timestamp_ < t; });
+  return static_cast<int>(it - hot_.begin());
 }
 
 int Buffer::AddEntrySorted(const BufferEntryType& new_entry, const bool& after)
 {
   if (this->IsEmpty())
   {
-    data_.push_back(new_entry);
+    InsertEntry(0, new_entry);
     // entry is added at idx 0, buffer was empty
     return 0;
   }
 
-  BufferEntryType latest_entry;
-  this->get_latest_entry(&latest_entry);
-  if (latest_entry <= new_entry)
+  if (hot_.back().timestamp_ <= new_entry.timestamp_)
   {
-    data_.push_back(new_entry);
-    // get index based on iterator
-    return static_cast<int>(data_.end() - data_.begin()) - 1;
+    InsertEntry(get_length(), new_entry);
+    return get_length() - 1;
   }
 
   Time previous_time_distance(1e100);
@@ -387,9 +494,9 @@ int Buffer::AddEntrySorted(const BufferEntryType& new_entry, const bool& after)
   // iterate backwards and start with latest entry
   // find the first entry at which (state_entry_stamp - new_stamp) is >=0
   // the new entry is entered after this index (idx+1)
-  for (int k = data_.size() - 1; k >= 0; --k)
+  for (int k = get_length() - 1; k >= 0; --k)
   {
-    Time current_time_distance = timestamp - data_[k].timestamp_;
+    Time current_time_distance = timestamp - hot_[k].timestamp_;
 
     if (current_time_distance.get_seconds() >= 0)
     {
@@ -400,13 +507,13 @@ int Buffer::AddEntrySorted(const BufferEntryType& new_entry, const bool& after)
         insert_idx += 1;
       }
 
-      data_.insert(data_.begin() + insert_idx, new_entry);
+      InsertEntry(insert_idx, new_entry);
       return insert_idx;  // return entry index
     }
   }
 
   // If the buffer has only one element and the new entry is older then the existing entry
-  data_.push_front(new_entry);
+  InsertEntry(0, new_entry);
   return 0;  // push front adds element at index 0
 }
 
@@ -425,21 +532,22 @@ bool Buffer::ClearStatesStartingAtIdx(const int& idx)
 
   if (idx < this->get_length())
   {
-    for (auto it = data_.begin() + idx; it != data_.end();)
+    for (int k = idx; k < get_length();)
     {
-      if (it->IsAutoGenerated())
+      if (data_[k].IsAutoGenerated())
       {
-        // erase returns the next iterator
-        it = data_.erase(it);
+        // The next entry moves to index k
+        EraseEntry(k);
         continue;
       }
-      else if (it->HasStates())
+      else if (hot_[k].has_states_)
       {
-        it->ClearStates();
+        data_[k].ClearStates();
+        hot_[k].has_states_ = false;
       }
 
       // Only increment if we didn't delete or if the entry was only a measurement
-      it++;
+      k++;
     }
     return true;
   }
@@ -462,6 +570,7 @@ bool Buffer::OverwriteDataAtIndex(const BufferEntryType& new_entry, const int& i
   if (index < (this->get_length()))
   {
     data_[index] = new_entry;
+    hot_[index] = HotEntry(new_entry);
     return true;
   }
 
@@ -487,7 +596,7 @@ bool Buffer::get_intermediate_entry_pair(const std::shared_ptr<SensorAbsClass>&
   size_t interm_core_idx = size_t(found_sensor_state_idx - entry_offset);
 
   // Ensure that the entrie is a state entry, as expected, and has the same timestamp as the sensor state
-  if (data_[interm_core_idx].HasStates() && data_[interm_core_idx].timestamp_ == found_sensor_state.timestamp_)
+  if (hot_[interm_core_idx].has_states_ && hot_[interm_core_idx].timestamp_ == found_sensor_state.timestamp_)
   {
     *sensor_state = found_sensor_state;
     *imu_state = data_[interm_core_idx];
@@ -505,38 +614,115 @@ int Buffer::RemoveOverflowEntrys()
     return -1;
   }
 
+  // Number of states per sensor handle, counted once such that a large overflow is removed in a single pass
+  overflow_state_count_.clear();
+  for (const auto& hot_entry : hot_)
+  {
+    if (hot_entry.has_states_)
+    {
+      IncrementStateCount(hot_entry.sensor_handle_, 1);
+    }
+  }
+
   // Starting with the oldest at zero
 
-  auto it = data_.begin();
+  int k = 0;
 
-  for (; it != data_.end(); it++)
+  while (k < get_length())
   {
-    if (CheckForLastSensorHandleWithState(it->sensor_handle_))
+    const HotEntry& hot_entry = hot_[k];
+
+    // The last state of a sensor handle is kept
+    if (hot_entry.has_states_ && IncrementStateCount(hot_entry.sensor_handle_, 0) == 1)
     {
+      k++;
       continue;
     }
-    else
+
+    if (hot_entry.has_states_)
     {
-      it = data_.erase(it);
+      IncrementStateCount(hot_entry.sensor_handle_, -1);
+    }
 
-      if (this->get_length() <= this->max_buffer_size_)
-      {
-        break;
-      }
+    // The next entry moves to index k and is checked in the next iteration
+    EraseEntry(k);
+
+    if (this->get_length() <= this->max_buffer_size_)
+    {
+      break;
     }
   }
 
   // return deleted index
-  return int(distance(data_.begin(), it));
+  return k;
+}
+
+int Buffer::IncrementStateCount(const SensorAbsClass* sensor_handle, const int& increment)
+{
+  for (auto& k : overflow_state_count_)
+  {
+    if (k.first == sensor_handle)
+    {
+      k.second += increment;
+      return k.second;
+    }
+  }
+
+  overflow_state_count_.emplace_back(sensor_handle, increment);
+  return increment;
+}
+
+void Buffer::InsertEntry(const int& index, const BufferEntryType& new_entry)
+{
+  // A full ring buffer would drop an entry on insert
+  if (data_.full())
+  {
+    ReserveEntries(2 * data_.capacity());
+  }
+
+  // Shift the shorter side of the ring buffer
+  if (2 * index < get_length())
+  {
+    data_.rinsert(data_.begin() + index, new_entry);
+    hot_.rinsert(hot_.begin() + index, HotEntry(new_entry));
+  }
+  else
+  {
+    data_.insert(data_.begin() + index, new_entry);
+    hot_.insert(hot_.begin() + index, HotEntry(new_entry));
+  }
+}
+
+void Buffer::EraseEntry(const int& index)
+{
+  if (2 * index < get_length())
+  {
+    data_.rerase(data_.begin() + index);
+    hot_.rerase(hot_.begin() + index);
+  }
+  else
+  {
+    data_.erase(data_.begin() + index);
+    hot_.erase(hot_.begin() + index);
+  }
+}
+
+void Buffer::ReserveEntries(const size_t& num_entries)
+{
+  if (num_entries > data_.capacity())
+  {
+    data_.set_capacity(num_entries);
+    hot_.set_capacity(num_entries);
+  }
 }
 
 bool Buffer::CheckForLastSensorHandleWithState(const std::shared_ptr<SensorAbsClass>& sensor_handle) const
 {
   int num_found_instances = 0;
 
-  for (auto current_it = data_.begin(); current_it != data_.end(); ++current_it)
+  for (const auto& hot_entry : hot_)
   {
-    if ((current_it->sensor_handle_ == sensor_handle) && current_it->HasStates())
+    if ((hot_entry.sensor_handle_ == sensor_handle.get()) && hot_entry.has_states_)
     {
       num_found_instances++;
 
@@ -15,14 +15,15 @@
 
 namespace mars
 {
+const std::set<int> BufferEntryType::metadata_valid_filter_ = { BufferMetadataType::none,
+                                                                BufferMetadataType::out_of_order,
+                                                                BufferMetadataType::auto_add };
+const std::set<int> BufferEntryType::metadata_auto_filter_ = { BufferMetadataType::auto_add };
+
 BufferEntryType::BufferEntryType(const Time& timestamp, BufferDataType data, std::shared_ptr<SensorAbsClass> sensor,
                                  const int& metadata)
   : timestamp_(timestamp), data_(std::move(data)), sensor_handle_(move(sensor)), metadata_(metadata)
 {
-  metadata_valid_filter_ =
-      std::set<int>({ BufferMetadataType::none, BufferMetadataType::out_of_order, BufferMetadataType::auto_add });
-
-  metadata_auto_filter_ = std::set<int>({ BufferMetadataType::auto_add });
 }
 
 std::string BufferEntryType::get_metadata_label(int label)
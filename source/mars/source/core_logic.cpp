@@ -13,10 +13,131 @@
 #include <mars/nearest_cov.h>
 #include <mars/sensors/imu/imu_measurement_type.h>
 #include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/sensors/update_sensor_abs_class.h>
 #include <mars/type_definitions/core_type.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 namespace mars
 {
+///
+/// \brief State of a rework which is performed on the worker thread, see CoreLogic::FinishSpeculativeRework
+///
+struct CoreLogic::SpeculativeRework
+{
+  std::shared_ptr<CoreLogic> worker_{ nullptr };  ///< Reworks its own copies of the segment and core state
+  bool running_{ false };                         ///< True until the result was spliced into the buffer
+  int segment_start_idx_{ 0 };                    ///< Buffer index of the first entry of the copied segment
+  int start_idx_{ 0 };                            ///< Buffer index at which the rework started
+  int snapshot_length_{ 0 };                      ///< Buffer length at the start of the rework
+  std::vector<BufferEntryType> deferred_;         ///< Measurements received during the rework
+
+  ~SpeculativeRework();
+
+  ///
+  /// \brief Start Hands the rework of the worker buffer starting at 'index' to the worker thread
+  ///
+  /// The thread is started with the first rework and is reused by all following reworks.
+  ///
+  void Start(const int& index);
+
+  ///
+  /// \brief IsDone
+  /// \return true once the worker thread finished the rework
+  ///
+  bool IsDone();
+
+  ///
+  /// \brief Wait Waits until the worker thread finished the rework
+  /// \return Processing time [s] of the rework
+  ///
+  double Wait();
+
+private:
+  void ThreadLoop();
+
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable cv_;  ///< Signals a new rework to the thread and its completion to the filter thread
+  int task_idx_{ -1 };          ///< Worker buffer index of the requested rework, -1 if none
+  bool done_{ false };          ///< True once the requested rework was performed
+  bool stop_{ false };          ///< Ends the thread
+  double cost_{ 0 };            ///< Processing time [s] of the last rework
+};
+
+CoreLogic::SpeculativeRework::~SpeculativeRework()
+{
+  if (!thread_.joinable())
+  {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+}
+
+void CoreLogic::SpeculativeRework::Start(const int& index)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_idx_ = index;
+    done_ = false;
+  }
+
+  if (!thread_.joinable())
+  {
+    thread_ = std::thread(&SpeculativeRework::ThreadLoop, this);
+  }
+  cv_.notify_all();
+}
+
+bool CoreLogic::SpeculativeRework::IsDone()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return done_;
+}
+
+double CoreLogic::SpeculativeRework::Wait()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this]() { return done_; });
+  return cost_;
+}
+
+void CoreLogic::SpeculativeRework::ThreadLoop()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  while (true)
+  {
+    cv_.wait(lock, [this]() { return stop_ || task_idx_ >= 0; });
+    if (stop_)
+    {
+      return;
+    }
+
+    const int index = task_idx_;
+    task_idx_ = -1;
+    lock.unlock();
+
+    const auto start = std::chrono::steady_clock::now();
+    worker_->ReworkBufferStartingAtIndex(index);
+    const double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    lock.lock();
+    cost_ = cost;
+    done_ = true;
+    cv_.notify_all();
+  }
+}
+
 CoreLogic::CoreLogic(std::shared_ptr<CoreState> core_states) : core_states_(move(core_states))
 {
   std::cout << "Created: CoreLogic - Using MaRS Version: " << mars::Utils::get_mars_version_string() << std::endl;
@@ -59,10 +180,26 @@ int CoreLogic::Initialize(const Eigen::Vector3d& p_wi_init, const Eigen::Quatern
   initial_core_state.cov_ = core_states_->InitializeCovariance();
 
   // Generate data element for initial state entry and add it to the existing entry
-  init_main_buffer_entry.data_.set_core_state(std::make_shared<CoreType>(initial_core_state));
+  // The buffer holds at most its capacity of states and intermediate measurements, size the pools accordingly
+  core_states_->core_type_pool_.Reserve(buffer_.get_capacity());
+  imu_measurement_pool_.Reserve(buffer_.get_capacity());
+
+  init_main_buffer_entry.data_.set_core_state(core_states_->core_type_pool_.Make(initial_core_state));
 
   buffer_.AddEntrySorted(init_main_buffer_entry);
 
+  if (state_publisher_ != nullptr)
+  {
+    state_publisher_->Publish(init_main_buffer_entry);
+  }
+
+  if (flight_recorder_ != nullptr)
+  {
+    flight_recorder_->RecordState(init_main_buffer_entry, false);
+  }
+
+  NotifyStateObservers(init_main_buffer_entry, false);
+
   core_is_initialized_ = true;
   std::cout << "Info: Filter was initialized" << std::endl;
 
@@ -74,6 +211,11 @@ CoreStateMatrix CoreLogic::GenerateStateTransitionBlock(const int& first_transit
   assert(first_transition_idx >= 0);
   assert(last_transition_idx >= 0);
 
+  if (transition_tree_active_)
+  {
+    return GenerateStateTransitionBlockFromTree(first_transition_idx, last_transition_idx);
+  }
+
   CoreStateMatrix state_transition(CoreStateMatrix::Identity());
 
   for (int k = first_transition_idx; k <= last_transition_idx; k++)
@@ -95,9 +237,85 @@ CoreStateMatrix CoreLogic::GenerateStateTransitionBlock(const int& first_transit
   return state_transition;
 }
 
+CoreStateMatrix CoreLogic::GenerateStateTransitionBlockFromTree(const int& first_transition_idx,
+                                                                const int& last_transition_idx)
+{
+  if (last_transition_idx < first_transition_idx)
+  {
+    return CoreStateMatrix::Identity();
+  }
+
+  if (last_transition_idx >= transition_tree_.size())
+  {
+    // Leave room for the entries which are added during the rework
+    transition_tree_.Resize(std::max(buffer_.get_length(), last_transition_idx + 1) * 5 / 4 + 16);
+    transition_tree_first_ = 0;
+    transition_tree_end_ = 0;
+  }
+
+  auto load_leaves = [this](const int& first, const int& last) {
+    for (int k = first; k <= last; k++)
+    {
+      BufferEntryType entry;
+      buffer_.get_entry_at_idx(k, &entry);
+
+      if (entry.HasStates() && (entry.sensor_handle_ == core_states_->propagation_sensor_) &&
+          (entry.metadata_ != BufferMetadataType::init))
+      {
+        transition_tree_.SetLeaf(k, static_cast<CoreType*>(entry.data_.core_state_.get())->state_transition_);
+      }
+      else
+      {
+        transition_tree_.SetLeaf(k, CoreStateMatrix::Identity());
+      }
+    }
+  };
+
+  // Extend the range of valid leaves such that it covers the requested block
+  if (transition_tree_end_ <= transition_tree_first_)
+  {
+    load_leaves(first_transition_idx, last_transition_idx);
+    transition_tree_first_ = first_transition_idx;
+    transition_tree_end_ = last_transition_idx + 1;
+  }
+  else
+  {
+    if (first_transition_idx < transition_tree_first_)
+    {
+      load_leaves(first_transition_idx, transition_tree_first_ - 1);
+      transition_tree_first_ = first_transition_idx;
+    }
+    if (last_transition_idx >= transition_tree_end_)
+    {
+      load_leaves(transition_tree_end_, last_transition_idx);
+      transition_tree_end_ = last_transition_idx + 1;
+    }
+  }
+
+  return transition_tree_.Query(first_transition_idx, last_transition_idx);
+}
+
+void CoreLogic::InvalidateTransitionTree(const int& idx)
+{
+  if (transition_tree_active_ && idx < transition_tree_end_)
+  {
+    transition_tree_end_ = std::max(idx, transition_tree_first_);
+  }
+}
+
 Eigen::MatrixXd CoreLogic::PropagateSensorCrossCov(const Eigen::MatrixXd& sensor_cov, const CoreStateMatrix& core_cov,
                                                    const CoreStateMatrix& state_transition)
 {
+  Eigen::MatrixXd propagated_cov;
+  PropagateSensorCrossCov(sensor_cov, core_cov, state_transition, &propagated_cov);
+  return propagated_cov;
+}
+
+void CoreLogic::PropagateSensorCrossCov(const Eigen::MatrixXd& sensor_cov, const CoreStateMatrix& core_cov,
+                                        const CoreStateMatrix& state_transition, Eigen::MatrixXd* propagated_cov)
+{
+  assert(propagated_cov != &sensor_cov);
+
   // isolate the right sensor-core cross-covariance entrys
   const int full_cov_size = static_cast<int>(sensor_cov.rows());
   const int core_cov_size = core_states_->state.size_error_;
@@ -105,22 +323,29 @@ Eigen::MatrixXd CoreLogic::PropagateSensorCrossCov(const Eigen::MatrixXd& sensor
   const int sensor_cov_dim_col = full_cov_size - core_cov_size;
   const int sensor_cov_dim_row = core_cov_size;
 
-  Eigen::MatrixXd old_sensor_cross_cov =
-      sensor_cov.block(0, sensor_cov_start_idx, sensor_cov_dim_row, sensor_cov_dim_col);
-
-  // Propagate right sensor-core cross-covariance entrys
-  Eigen::MatrixXd new_sensor_cross_cov = state_transition * old_sensor_cross_cov;
-
   // Fill core states
-  Eigen::MatrixXd propagated_cov(sensor_cov);
-  propagated_cov.block(0, 0, core_cov_size, core_cov_size) = core_cov;
+  *propagated_cov = sensor_cov;
+  propagated_cov->block(0, 0, core_cov_size, core_cov_size) = core_cov;
+
+  // Propagate right sensor-core cross-covariance entrys and mirror them
+  propagated_cov->block(0, sensor_cov_start_idx, sensor_cov_dim_row, sensor_cov_dim_col).noalias() =
+      state_transition * sensor_cov.block(0, sensor_cov_start_idx, sensor_cov_dim_row, sensor_cov_dim_col);
+  propagated_cov->block(sensor_cov_start_idx, 0, sensor_cov_dim_col, sensor_cov_dim_row) =
+      propagated_cov->block(0, sensor_cov_start_idx, sensor_cov_dim_row, sensor_cov_dim_col).transpose();
+}
 
-  // Replace sensor cross-covariance with updated values
-  propagated_cov.block(0, sensor_cov_start_idx, sensor_cov_dim_row, sensor_cov_dim_col) = new_sensor_cross_cov;
-  propagated_cov.block(sensor_cov_start_idx, 0, sensor_cov_dim_col, sensor_cov_dim_row) =
-      new_sensor_cross_cov.transpose();
+CoreLogic::UpdateWorkspace* CoreLogic::get_update_workspace(const SensorAbsClass* sensor)
+{
+  for (auto& workspace : update_workspaces_)
+  {
+    if (workspace.first == sensor)
+    {
+      return &workspace.second;
+    }
+  }
 
-  return propagated_cov;
+  update_workspaces_.emplace_back(sensor, UpdateWorkspace());
+  return &update_workspaces_.back().second;
 }
 
 bool CoreLogic::PerformSensorUpdate(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
@@ -152,6 +377,9 @@ bool CoreLogic::PerformSensorUpdate(std::shared_ptr<SensorAbsClass> sensor, cons
 
     CoreType latest_core_data = *static_cast<CoreType*>(closest_state_entry.data_.core_state_.get());
 
+    // Sensor states of the sensor, e.g. updates, are held by the buffer entries
+    sensor->ReserveStates(static_cast<size_t>(buffer_.get_capacity()));
+
     BufferDataType init_data =
         sensor->Initialize(timestamp, sensor_data->data_.measurement_, std::make_shared<CoreType>(latest_core_data));
 
@@ -186,7 +414,7 @@ bool CoreLogic::PerformSensorUpdate(std::shared_ptr<SensorAbsClass> sensor, cons
   CoreType core_prev = *static_cast<CoreType*>(latest_state_buffer_entry.data_.core_state_.get());
   IMUMeasurementType imu_meas_curr(core_prev.state_.a_m_, core_prev.state_.w_m_);
   BufferDataType interm_prop;
-  interm_prop.set_measurement(std::make_shared<IMUMeasurementType>(imu_meas_curr));
+  interm_prop.set_measurement(imu_measurement_pool_.Make(imu_meas_curr));
 
   // Copy IMU measurement for zero order hold interpolation
   mars::BufferEntryType interm_buffer_entry(timestamp, interm_prop, core_states_->propagation_sensor_,
@@ -197,14 +425,17 @@ bool CoreLogic::PerformSensorUpdate(std::shared_ptr<SensorAbsClass> sensor, cons
 
   // Extract prior information from buffer entries
   CoreType prior_core_data = *static_cast<CoreType*>(interm_buffer_entry.data_.core_state_.get());
-  Utils::CheckCov(prior_core_data.cov_, "CoreLogic: Core cov prior");
-  Eigen::MatrixXd prior_sensor_covariance = sensor->get_covariance(prior_sensor_state_entry.data_.sensor_state_);
+  static const std::string core_cov_description("CoreLogic: Core cov prior");
+  Utils::CheckCov(prior_core_data.cov_, core_cov_description);
+  UpdateWorkspace* workspace = get_update_workspace(sensor.get());
+  sensor->FillCovariance(prior_sensor_state_entry.data_.sensor_state_, &workspace->sensor_cov_);
   CoreStateMatrix state_transition;
 
   if (add_interm_buffer_entries_)
   {
     // Intermediate IMU Measurement and propergated state
-    buffer_.AddEntrySorted(interm_buffer_entry, false);
+    const int interm_idx = buffer_.AddEntrySorted(interm_buffer_entry, false);
+    InvalidateTransitionTree(interm_idx);
     *added_interm_state = true;
 
     if (verbose_)
@@ -227,17 +458,23 @@ bool CoreLogic::PerformSensorUpdate(std::shared_ptr<SensorAbsClass> sensor, cons
     state_transition = prior_core_data.state_transition_ * state_transition;
   }
 
-  Eigen::MatrixXd prior_cov = PropagateSensorCrossCov(prior_sensor_covariance, prior_core_data.cov_, state_transition);
-
-  NearestCov correct_cov(prior_cov);
-  Eigen::MatrixXd corrected_cov = correct_cov.EigenCorrectionUsingCovariance(NearestCovMethod::abs);
+  PropagateSensorCrossCov(workspace->sensor_cov_, prior_core_data.cov_, state_transition, &workspace->prior_cov_);
+  nearest_cov_.EigenCorrectionUsingCovariance(workspace->prior_cov_, NearestCovMethod::abs,
+                                              &workspace->corrected_cov_);
 
   // Perform the sensor update
   BufferDataType corrected_state_data;
   bool successful_update;
-  successful_update =
-      sensor->CalcUpdate(timestamp, sensor_data->data_.measurement_, prior_core_data.state_,
-                         prior_sensor_state_entry.data_.sensor_state_, corrected_cov, &corrected_state_data);
+  successful_update = sensor->CalcUpdate(timestamp, sensor_data->data_.measurement_, prior_core_data.state_,
+                                         prior_sensor_state_entry.data_.sensor_state_, workspace->corrected_cov_,
+                                         &corrected_state_data);
+
+  if (flight_recorder_ != nullptr)
+  {
+    const auto* update_sensor = dynamic_cast<const UpdateSensorAbsClass*>(sensor.get());
+    flight_recorder_->RecordUpdate(sensor.get(), timestamp, update_sensor != nullptr ? &update_sensor->chi2_ : nullptr,
+                                   nearest_cov_.corrected_, successful_update);
+  }
 
   // TODO(CHB): This should also happen inside the update class or a preset object should be given that already has the
   // measurement
@@ -285,12 +522,10 @@ void CoreLogic::PerformCoreStatePropagation(std::shared_ptr<SensorAbsClass> sens
     std::cout << "Warning: dt for propagation is zero" << std::endl;
   }
 
-  CoreType propagated_core_state;
-  propagated_core_state = core_states_->PredictProcessCovariance(prior_core_data, meas_system_input, dt.get_seconds());
-  propagated_core_state.state_ =
-      core_states_->PropagateState(prior_core_data.state_, meas_system_input, dt.get_seconds());
+  const CoreType propagated_core_state =
+      core_states_->PropagateStateAndCovariance(prior_core_data, meas_system_input, dt.get_seconds());
 
-  sensor_entry->data_.set_core_state(std::make_shared<CoreType>(propagated_core_state));
+  sensor_entry->data_.set_core_state(core_states_->core_type_pool_.Make(propagated_core_state));
 
   if (verbose_)
   {
@@ -309,8 +544,14 @@ void CoreLogic::ReworkBufferStartingAtIndex(const int& index)
 
   buffer_.ClearStatesStartingAtIdx(index);
 
+  // Leaves are loaded on demand, only transitions of entries before the rework index are final at this point
+  transition_tree_active_ = use_transition_tree_;
+  transition_tree_first_ = 0;
+  transition_tree_end_ = 0;
+
   // get running current index
   int current_state_entry_idx = index;
+  const bool notify_observers = HasStateObservers();
 
   // The buffer size can change during the reiteration.
   // Thats why we need to compare for each iteration
@@ -336,9 +577,26 @@ void CoreLogic::ReworkBufferStartingAtIndex(const int& index)
 
       buffer_.OverwriteDataAtIndex(current_measurement_buffer_entry, current_state_entry_idx);
       current_state_entry_idx++;
+
+      if (notify_observers)
+      {
+        NotifyStateObservers(current_measurement_buffer_entry, true);
+      }
+
+      if (flight_recorder_ != nullptr)
+      {
+        flight_recorder_->RecordState(current_measurement_buffer_entry, true);
+      }
     }
     else
     {
+      if (!sensor_handle->do_update_)
+      {
+        // Entry of a deactivated sensor which was not yet removed by the sensor manager
+        current_state_entry_idx++;
+        continue;
+      }
+
       //  Processing update sensors
       bool added_interm_state = false;
       PerformSensorUpdate(sensor_handle, timestamp, &current_measurement_buffer_entry, &added_interm_state);
@@ -350,19 +608,655 @@ void CoreLogic::ReworkBufferStartingAtIndex(const int& index)
 
       buffer_.OverwriteDataAtIndex(current_measurement_buffer_entry, current_state_entry_idx);
       current_state_entry_idx++;
+
+      if (notify_observers && current_measurement_buffer_entry.HasStates())
+      {
+        NotifyStateObservers(current_measurement_buffer_entry, true);
+      }
+
+      if (flight_recorder_ != nullptr)
+      {
+        flight_recorder_->RecordState(current_measurement_buffer_entry, true);
+      }
     }
   }
 
+  transition_tree_active_ = false;
+
   if (verbose_)
   {
     std::cout << "[CoreLogic]: Rework Buffer Starting At Index - DONE" << std::endl;
   }
 }
 
+void CoreLogic::PerformRework(const int& index)
+{
+  const int num_entries = buffer_.get_length() - index;
+
+  if (speculative_rework_ && num_entries >= speculative_min_entries_ && StartSpeculativeRework(index))
+  {
+    return;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  ReworkBufferStartingAtIndex(index);
+  const double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  rework_stats_.num_reworks_++;
+  rework_stats_.num_reworked_entries_ += num_entries;
+  rework_stats_.rework_time_ += cost;
+  rework_stats_.rework_time_max_ = std::max(rework_stats_.rework_time_max_, cost);
+
+  if (state_publisher_ != nullptr)
+  {
+    mars::BufferEntryType latest_state_buffer_entry;
+    if (buffer_.get_latest_state(&latest_state_buffer_entry))
+    {
+      state_publisher_->Publish(latest_state_buffer_entry);
+    }
+  }
+}
+
+bool CoreLogic::FlushPendingRework()
+{
+  if (pending_rework_idx_ < 0)
+  {
+    return false;
+  }
+
+  if (verbose_ || verbose_out_of_order_)
+  {
+    std::cout << "[CoreLogic]: Rework of " << num_pending_ooo_ << " coalesced out of order measurements" << std::endl;
+  }
+
+  const int index = pending_rework_idx_;
+  pending_rework_idx_ = -1;
+  num_pending_ooo_ = 0;
+
+  if (index >= buffer_.get_length())
+  {
+    // The buffer was reset externally
+    return false;
+  }
+
+  PerformRework(index);
+  return true;
+}
+
+bool CoreLogic::StartSpeculativeRework(const int& index)
+{
+  if (speculative_ == nullptr)
+  {
+    speculative_ = std::make_shared<SpeculativeRework>();
+  }
+
+  if (speculative_->running_)
+  {
+    return false;
+  }
+
+  if (speculative_->worker_ == nullptr)
+  {
+    // Internal instance, the default constructor does not print the creation banner
+    speculative_->worker_ = std::make_shared<CoreLogic>();
+  }
+
+  // The worker has no outputs, the states are published once the result was spliced into the buffer. It propagates
+  // with its own copy of the core state, while the filter thread keeps propagating with 'core_states_'.
+  std::shared_ptr<CoreLogic> worker = speculative_->worker_;
+  worker->core_states_ = std::make_shared<CoreState>(*core_states_);
+  worker->core_is_initialized_ = true;
+  worker->verbose_ = verbose_;
+  worker->add_interm_buffer_entries_ = add_interm_buffer_entries_;
+  worker->use_transition_tree_ = use_transition_tree_;
+
+  // Only the reworked entries and the states they start from are copied. The copy shares the entry data with the
+  // buffer, the rework only replaces the state pointers of the copy.
+  const int segment_start_idx = buffer_.get_rework_segment_start_idx(index, core_states_->propagation_sensor_);
+  worker->buffer_.CopyEntriesStartingAtIdx(buffer_, segment_start_idx);
+
+  if (verbose_ || verbose_out_of_order_)
+  {
+    std::cout << "[CoreLogic]: Speculative rework of " << buffer_.get_length() - index << " entries, "
+              << buffer_.get_length() - segment_start_idx << " entries copied" << std::endl;
+  }
+
+  speculative_->segment_start_idx_ = segment_start_idx;
+  speculative_->start_idx_ = index;
+  speculative_->snapshot_length_ = buffer_.get_length();
+  speculative_->running_ = true;
+  speculative_->Start(index - segment_start_idx);
+
+  return true;
+}
+
+bool CoreLogic::FinishSpeculativeRework()
+{
+  if (!IsSpeculativeReworkRunning())
+  {
+    return false;
+  }
+
+  const double cost = speculative_->Wait();
+  speculative_->running_ = false;
+
+  // Only in order propagation entries were added at the end of the buffer during the rework
+  std::vector<BufferEntryType> added_entries;
+  for (int k = speculative_->snapshot_length_; k < buffer_.get_length(); k++)
+  {
+    BufferEntryType entry;
+    buffer_.get_entry_at_idx(k, &entry);
+    added_entries.push_back(entry);
+  }
+
+  // No entries were removed from the buffer during the rework, the reworked copy replaces the segment
+  buffer_.SpliceEntriesStartingAtIdx(speculative_->segment_start_idx_, &speculative_->worker_->buffer_);
+
+  if (HasStateObservers() || flight_recorder_ != nullptr)
+  {
+    for (int k = speculative_->start_idx_; k < buffer_.get_length(); k++)
+    {
+      BufferEntryType entry;
+      buffer_.get_entry_at_idx(k, &entry);
+      if (entry.HasStates() && entry.metadata_ != BufferMetadataType::auto_add)
+      {
+        PublishReworkedEntry(entry);
+      }
+    }
+  }
+
+  // The added entries and the deferred measurements which are newer than the reworked segment are processed by one
+  // rework starting at the reworked states
+  const int repropagation_idx = buffer_.get_length();
+  BufferEntryType latest_reworked_entry;
+  buffer_.get_latest_entry(&latest_reworked_entry);
+
+  for (auto& entry : added_entries)
+  {
+    entry.ClearStates();
+    buffer_.AddEntrySorted(entry);
+  }
+
+  std::vector<BufferEntryType> deferred;
+  for (const auto& entry : speculative_->deferred_)
+  {
+    if (entry.timestamp_ < latest_reworked_entry.timestamp_)
+    {
+      deferred.push_back(entry);
+    }
+    else if (entry.sensor_handle_->do_update_)
+    {
+      buffer_.AddEntrySorted(entry);
+    }
+  }
+  speculative_->deferred_.clear();
+
+  if (buffer_.get_length() > repropagation_idx)
+  {
+    ReworkBufferStartingAtIndex(repropagation_idx);
+  }
+
+  const long num_entries = speculative_->snapshot_length_ - speculative_->start_idx_;
+  rework_stats_.num_reworks_++;
+  rework_stats_.num_speculative_reworks_++;
+  rework_stats_.num_reworked_entries_ += num_entries;
+  rework_stats_.num_repropagated_entries_ += static_cast<long>(added_entries.size());
+  rework_stats_.rework_time_ += cost;
+  rework_stats_.rework_time_max_ = std::max(rework_stats_.rework_time_max_, cost);
+
+  if (state_publisher_ != nullptr)
+  {
+    mars::BufferEntryType latest_state_buffer_entry;
+    if (buffer_.get_latest_state(&latest_state_buffer_entry))
+    {
+      state_publisher_->Publish(latest_state_buffer_entry);
+    }
+  }
+
+  // Older deferred measurements are out of order, they can start the next speculative rework
+  for (const auto& entry : deferred)
+  {
+    ProcessSensorMeasurement(entry.sensor_handle_, entry.timestamp_, entry.data_, entry.arrival_ns_);
+  }
+
+  return true;
+}
+
+bool CoreLogic::DeferDuringSpeculativeRework(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                                             const BufferDataType& data, const int64_t& arrival_ns)
+{
+  // Only in order propagation continues, the buffer must not shrink until the rework was spliced. The update sensors
+  // are used by the worker until then, measurements which would access them are deferred.
+  BufferEntryType latest_buffer_entry;
+  buffer_.get_latest_entry(&latest_buffer_entry);
+
+  if (sensor == core_states_->propagation_sensor_ && timestamp >= latest_buffer_entry.timestamp_)
+  {
+    return false;
+  }
+
+  speculative_->deferred_.emplace_back(timestamp, data, sensor);
+  speculative_->deferred_.back().arrival_ns_ = arrival_ns;
+  return true;
+}
+
+bool CoreLogic::IsSpeculativeReworkRunning() const
+{
+  return speculative_ != nullptr && speculative_->running_;
+}
+
+void CoreLogic::PublishReworkedEntry(const BufferEntryType& state_entry)
+{
+  NotifyStateObservers(state_entry, true);
+
+  if (flight_recorder_ != nullptr)
+  {
+    flight_recorder_->RecordState(state_entry, true);
+  }
+}
+
+const ReworkStats& CoreLogic::get_rework_stats() const
+{
+  return rework_stats_;
+}
+
+int CoreLogic::AddStateObserver(StateObserver observer)
+{
+  state_observers_.emplace_back(next_observer_id_, std::move(observer));
+  return next_observer_id_++;
+}
+
+bool CoreLogic::RemoveStateObserver(const int& id)
+{
+  for (auto it = state_observers_.begin(); it != state_observers_.end(); ++it)
+  {
+    if (it->first == id)
+    {
+      state_observers_.erase(it);
+      return true;
+    }
+  }
+
+  return false;
+}
+
 bool CoreLogic::ProcessMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
                                    const BufferDataType& data)
 {
-  buffer_.RemoveOverflowEntrys();
+  return ProcessMeasurement(sensor, timestamp, data, Time::get_wall_time_ns());
+}
+
+bool CoreLogic::ProcessMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                                   const BufferDataType& data, const int64_t& arrival_ns)
+{
+  RecordInput(sensor.get(), timestamp, data, arrival_ns);
+
+  if (prop_decimation_ > 1 && core_is_initialized_)
+  {
+    if (sensor == core_states_->propagation_sensor_)
+    {
+      Time prop_timestamp;
+      BufferDataType prop_data;
+      decimated_prop_.last_arrival_ns_ = arrival_ns;
+      if (!DecimatePropagation(timestamp, data, &prop_timestamp, &prop_data))
+      {
+        return true;
+      }
+      return DispatchMeasurement(sensor, prop_timestamp, prop_data, arrival_ns);
+    }
+
+    FlushDecimatedPropagation();
+  }
+
+  return DispatchMeasurement(sensor, timestamp, data, arrival_ns);
+}
+
+bool CoreLogic::DispatchMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                                    const BufferDataType& data, const int64_t& arrival_ns)
+{
+  if (load_shedder_ == nullptr)
+  {
+    return ProcessSensorMeasurement(sensor, timestamp, data, arrival_ns);
+  }
+
+  // Load shedding only applies to update sensors of an initialized filter, propagation is never dropped
+  const bool is_propagation_sensor = sensor == core_states_->propagation_sensor_;
+  if (!is_propagation_sensor && core_is_initialized_ && sensor->do_update_ &&
+      !load_shedder_->Admit(sensor, timestamp, data, arrival_ns))
+  {
+    if (verbose_)
+    {
+      std::cout << "[CoreLogic]: Measurement (" << sensor->name_ << ") was shed" << std::endl;
+    }
+    return false;
+  }
+
+  const bool result = ProcessTimedMeasurement(sensor, timestamp, data, arrival_ns);
+
+  if (is_propagation_sensor)
+  {
+    // Process deferred measurements if the budget allows it
+    BufferEntryType deferred_entry;
+    while (load_shedder_->PopDeferred(timestamp, &deferred_entry))
+    {
+      ProcessTimedMeasurement(deferred_entry.sensor_handle_, deferred_entry.timestamp_, deferred_entry.data_,
+                              deferred_entry.arrival_ns_);
+    }
+  }
+
+  return result;
+}
+
+bool CoreLogic::DecimatePropagation(const Time& timestamp, const BufferDataType& data, Time* prop_timestamp,
+                                    BufferDataType* prop_data)
+{
+  DecimatedPropagation& acc = decimated_prop_;
+
+  if (acc.num_measurements_ > 0 && timestamp < acc.last_timestamp_)
+  {
+    // Out of order measurements are not decimated
+    *prop_timestamp = timestamp;
+    *prop_data = data;
+    return true;
+  }
+
+  if (acc.num_measurements_ == 0)
+  {
+    acc.first_timestamp_ = timestamp;
+  }
+
+  const IMUMeasurementType* meas = static_cast<IMUMeasurementType*>(data.measurement_.get());
+  const double t = (timestamp - acc.first_timestamp_).get_seconds();
+
+  acc.num_measurements_++;
+  acc.last_timestamp_ = timestamp;
+  acc.last_data_ = data;
+  acc.sum_t_ += t;
+  acc.sum_tt_ += t * t;
+  acc.sum_a_ += meas->linear_acceleration_;
+  acc.sum_w_ += meas->angular_velocity_;
+  acc.sum_ta_ += t * meas->linear_acceleration_;
+  acc.sum_tw_ += t * meas->angular_velocity_;
+
+  if (acc.num_measurements_ < prop_decimation_)
+  {
+    return false;
+  }
+
+  TakeDecimatedPropagation(prop_timestamp, prop_data);
+  return true;
+}
+
+void CoreLogic::TakeDecimatedPropagation(Time* prop_timestamp, BufferDataType* prop_data)
+{
+  DecimatedPropagation& acc = decimated_prop_;
+  *prop_timestamp = acc.last_timestamp_;
+  *prop_data = acc.last_data_;
+
+  const double n = acc.num_measurements_;
+  const double var_t = acc.sum_tt_ - acc.sum_t_ * acc.sum_t_ / n;
+
+  if (prop_decimation_avg_ && acc.num_measurements_ > 2 && var_t > 0)
+  {
+    // Least squares line y = mean_y + slope * (t - mean_t), evaluated at the last timestamp
+    const double mean_t = acc.sum_t_ / n;
+    const double dt_last = (acc.last_timestamp_ - acc.first_timestamp_).get_seconds() - mean_t;
+    const Eigen::Vector3d slope_a = (acc.sum_ta_ - acc.sum_a_ * mean_t) / var_t;
+    const Eigen::Vector3d slope_w = (acc.sum_tw_ - acc.sum_w_ * mean_t) / var_t;
+
+    const IMUMeasurementType average(acc.sum_a_ / n + slope_a * dt_last, acc.sum_w_ / n + slope_w * dt_last);
+    *prop_data = BufferDataType(imu_measurement_pool_.Make(average));
+  }
+
+  acc = DecimatedPropagation();
+}
+
+bool CoreLogic::FlushDecimatedPropagation()
+{
+  if (decimated_prop_.num_measurements_ == 0)
+  {
+    return false;
+  }
+
+  Time prop_timestamp;
+  BufferDataType prop_data;
+  const int64_t arrival_ns = decimated_prop_.last_arrival_ns_;
+  TakeDecimatedPropagation(&prop_timestamp, &prop_data);
+  DispatchMeasurement(core_states_->propagation_sensor_, prop_timestamp, prop_data, arrival_ns);
+  return true;
+}
+
+int CoreLogic::ProcessMeasurements(const std::vector<BufferEntryType>& measurements, const StateCallback& callback)
+{
+  const bool is_sorted = std::is_sorted(
+      measurements.begin(), measurements.end(),
+      [](const BufferEntryType& lhs, const BufferEntryType& rhs) { return lhs.timestamp_ < rhs.timestamp_; });
+
+  if (!is_sorted && verbose_)
+  {
+    std::cout << "[CoreLogic]: ProcessMeasurements input is not sorted, measurements are processed individually"
+              << std::endl;
+  }
+
+  int num_processed = 0;
+  bool in_order = false;  // True once the remaining measurements are known to be newer than the buffer
+
+  for (const auto& measurement : measurements)
+  {
+    const std::shared_ptr<SensorAbsClass>& sensor = measurement.sensor_handle_;
+    const int64_t arrival_ns = measurement.arrival_ns_ != 0 ? measurement.arrival_ns_ : Time::get_wall_time_ns();
+
+    if (!in_order && is_sorted && core_is_initialized_ && load_shedder_ == nullptr && pending_rework_idx_ < 0 &&
+        prop_decimation_ <= 1 && !IsSpeculativeReworkRunning())
+    {
+      // Sorted input only needs to be compared with the buffer once
+      BufferEntryType latest_buffer_entry;
+      in_order = !buffer_.get_latest_entry(&latest_buffer_entry) ||
+                 measurement.timestamp_ >= latest_buffer_entry.timestamp_;
+    }
+
+    if (!in_order)
+    {
+      if (ProcessMeasurement(sensor, measurement.timestamp_, measurement.data_, arrival_ns))
+      {
+        num_processed++;
+        NotifyBatchCallback(callback);
+      }
+      continue;
+    }
+
+    RecordInput(sensor.get(), measurement.timestamp_, measurement.data_, arrival_ns);
+
+    UpdateSensorRegistry();
+
+    if (!sensor->do_update_)
+    {
+      continue;
+    }
+
+    BufferEntryType new_sensor_entry(measurement.timestamp_, measurement.data_, sensor);
+    new_sensor_entry.arrival_ns_ = arrival_ns;
+    if (ProcessInOrderMeasurement(sensor, measurement.timestamp_, &new_sensor_entry))
+    {
+      num_processed++;
+
+      // The in order entry is the latest state of the buffer, the buffer does not need to be searched
+      if (callback)
+      {
+        callback(new_sensor_entry);
+      }
+    }
+  }
+
+  // Overflowing entries of the whole batch are removed at once
+  if (pending_rework_idx_ < 0 && !IsSpeculativeReworkRunning())
+  {
+    buffer_.RemoveOverflowEntrys();
+  }
+
+  return num_processed;
+}
+
+void CoreLogic::NotifyBatchCallback(const StateCallback& callback) const
+{
+  BufferEntryType state_entry;
+  if (callback && buffer_.get_latest_state(&state_entry))
+  {
+    callback(state_entry);
+  }
+}
+
+void CoreLogic::RecordInput(const SensorAbsClass* sensor, const Time& timestamp, const BufferDataType& data,
+                            const int64_t& arrival_ns)
+{
+  if (journal_ != nullptr)
+  {
+    journal_->Record(sensor, timestamp, data, arrival_ns);
+  }
+
+  if (flight_recorder_ != nullptr)
+  {
+    flight_recorder_->RecordMeasurement(sensor, timestamp, data);
+  }
+}
+
+void CoreLogic::UpdateSensorRegistry()
+{
+  // Removing entries shifts the buffer indexes, the removal waits while a rework is pending
+  const bool can_remove_entries = pending_rework_idx_ < 0;
+  if (sensor_manager_.ApplyPendingChanges(&buffer_, can_remove_entries) > 0)
+  {
+    // Drop the update workspaces of removed sensors
+    const std::shared_ptr<const SensorManager::SensorList> sensors = sensor_manager_.get_sensor_list();
+    update_workspaces_.erase(
+        std::remove_if(update_workspaces_.begin(), update_workspaces_.end(),
+                       [&sensors](const std::pair<const SensorAbsClass*, UpdateWorkspace>& workspace) {
+                         return std::none_of(sensors->begin(), sensors->end(),
+                                             [&workspace](const std::shared_ptr<SensorAbsClass>& sensor) {
+                                               return sensor.get() == workspace.first;
+                                             });
+                       }),
+        update_workspaces_.end());
+  }
+
+  if (can_remove_entries)
+  {
+    sensor_manager_.CollectGarbage(&buffer_);
+  }
+}
+
+bool CoreLogic::ProcessTimedMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                                        const BufferDataType& data, const int64_t& arrival_ns)
+{
+  if (IsSpeculativeReworkRunning() && speculative_->IsDone())
+  {
+    // The splice and the processing of the deferred measurements are not caused by this measurement
+    const auto splice_start = std::chrono::steady_clock::now();
+    FinishSpeculativeRework();
+    const double splice_cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - splice_start).count();
+    load_shedder_->ReportOverhead(timestamp, splice_cost);
+  }
+
+  if (IsSpeculativeReworkRunning() && DeferDuringSpeculativeRework(sensor, timestamp, data, arrival_ns))
+  {
+    // The cost is part of the splice overhead
+    return true;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  const bool result = ProcessSensorMeasurement(sensor, timestamp, data, arrival_ns);
+  const double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  load_shedder_->ReportCost(sensor, timestamp, cost);
+  return result;
+}
+
+bool CoreLogic::ProcessInOrderMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                                          BufferEntryType* new_sensor_entry)
+{
+  // Main part to process the measurement
+  if (sensor == core_states_->propagation_sensor_)
+  {
+    // Propagate State with System Input from Propagation Sensor
+
+    // Since the measurement was not out of order, get latest state is valid
+    mars::BufferEntryType latest_state_buffer_entry;
+    buffer_.get_latest_state(&latest_state_buffer_entry);
+
+    PerformCoreStatePropagation(sensor, timestamp, latest_state_buffer_entry, new_sensor_entry);
+
+    buffer_.AddEntrySorted(*new_sensor_entry);
+  }
+  else
+  {
+    if (!PerformSensorUpdate(sensor, timestamp, new_sensor_entry))
+    {
+      return false;
+    }
+
+    buffer_.AddEntrySorted(*new_sensor_entry);
+  }
+
+  if (state_publisher_ != nullptr)
+  {
+    state_publisher_->Publish(*new_sensor_entry);
+  }
+
+  if (flight_recorder_ != nullptr)
+  {
+    flight_recorder_->RecordState(*new_sensor_entry, false);
+  }
+
+  NotifyStateObservers(*new_sensor_entry, false);
+
+  return true;
+}
+
+bool CoreLogic::ProcessSensorMeasurement(std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                                         const BufferDataType& data, const int64_t& arrival_ns)
+{
+  if (IsSpeculativeReworkRunning())
+  {
+    if (speculative_->IsDone())
+    {
+      FinishSpeculativeRework();
+    }
+    else
+    {
+      if (DeferDuringSpeculativeRework(sensor, timestamp, data, arrival_ns))
+      {
+        return true;
+      }
+
+      if (!sensor->do_update_)
+      {
+        return false;
+      }
+
+      mars::BufferEntryType new_sensor_entry(timestamp, data, sensor);
+      new_sensor_entry.arrival_ns_ = arrival_ns;
+      return ProcessInOrderMeasurement(sensor, timestamp, &new_sensor_entry);
+    }
+  }
+
+  if (pending_rework_idx_ >= 0)
+  {
+    // The coalescing of out of order measurements ends with the next in order measurement
+    BufferEntryType latest_buffer_entry;
+    buffer_.get_latest_entry(&latest_buffer_entry);
+    if (timestamp >= latest_buffer_entry.timestamp_)
+    {
+      FlushPendingRework();
+    }
+  }
+
+  // Overflow entries are only removed if no rework is pending, this keeps the pending rework index valid
+  if (pending_rework_idx_ < 0)
+  {
+    buffer_.RemoveOverflowEntrys();
+  }
+
+  UpdateSensorRegistry();
 
   if (verbose_)
   {
@@ -382,6 +1276,7 @@ bool CoreLogic::ProcessMeasurement(std::shared_ptr<SensorAbsClass> sensor, const
 
   // Generate buffer entry element for the measurement
   mars::BufferEntryType new_sensor_entry(timestamp, data, sensor);
+  new_sensor_entry.arrival_ns_ = arrival_ns;
 
   // Store measurements prior to the core initialization in the Prior-Buffer
   if (!this->core_is_initialized_)
@@ -403,30 +1298,7 @@ bool CoreLogic::ProcessMeasurement(std::shared_ptr<SensorAbsClass> sensor, const
   if (timestamp >= latest_buffer_entry.timestamp_)
   {
     // Measurement is newer than the latest entry - proceed normally
-    // Main part to process the measurement
-    if (sensor == core_states_->propagation_sensor_)
-    {
-      // Propagate State with System Input from Propagation Sensor
-
-      // Since the measurement was not out of order, get latest state is valid
-      mars::BufferEntryType latest_state_buffer_entry;
-      buffer_.get_latest_state(&latest_state_buffer_entry);
-
-      PerformCoreStatePropagation(sensor, timestamp, latest_state_buffer_entry, &new_sensor_entry);
-
-      buffer_.AddEntrySorted(new_sensor_entry);
-    }
-    else
-    {
-      if (!PerformSensorUpdate(sensor, timestamp, &new_sensor_entry))
-      {
-        return false;
-      }
-
-      buffer_.AddEntrySorted(new_sensor_entry);
-    }
-
-    return true;
+    return ProcessInOrderMeasurement(sensor, timestamp, &new_sensor_entry);
   }
   else
   {
@@ -503,11 +1375,30 @@ bool CoreLogic::ProcessMeasurement(std::shared_ptr<SensorAbsClass> sensor, const
     // Store Measurement as out of order
     mars::BufferEntryType new_ooo_measurement_buffer_entry(timestamp, data, sensor,
                                                            mars::BufferMetadataType::out_of_order);
+    new_ooo_measurement_buffer_entry.arrival_ns_ = arrival_ns;
 
     int out_of_order_buffer_idx = buffer_.AddEntrySorted(new_ooo_measurement_buffer_entry);
+    rework_stats_.num_ooo_measurements_++;
 
-    // Reworking the buffer starting at out of order buffer index
-    ReworkBufferStartingAtIndex(out_of_order_buffer_idx);
+    if (coalesce_ooo_reworks_)
+    {
+      // Entries inserted at or before the pending index shift it, the rework starts at the oldest entry
+      if (pending_rework_idx_ < 0 || out_of_order_buffer_idx <= pending_rework_idx_)
+      {
+        pending_rework_idx_ = out_of_order_buffer_idx;
+      }
+      num_pending_ooo_++;
+
+      if (num_pending_ooo_ >= max_coalesced_ooo_)
+      {
+        FlushPendingRework();
+      }
+    }
+    else
+    {
+      // Reworking the buffer starting at out of order buffer index
+      PerformRework(out_of_order_buffer_idx);
+    }
 
     if (verbose_)
     {
@@ -517,4 +1408,22 @@ bool CoreLogic::ProcessMeasurement(std::shared_ptr<SensorAbsClass> sensor, const
     return true;
   }
 }
+
+bool CoreLogic::HasStateObservers() const
+{
+  return !state_observers_.empty() || state_queue_ != nullptr;
+}
+
+void CoreLogic::NotifyStateObservers(const BufferEntryType& state_entry, const bool& is_correction)
+{
+  for (const auto& observer : state_observers_)
+  {
+    observer.second(state_entry, is_correction);
+  }
+
+  if (state_queue_ != nullptr)
+  {
+    state_queue_->Push(state_entry, is_correction);
+  }
+}
 }  // namespace mars
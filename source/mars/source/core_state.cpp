@@ -9,6 +9,7 @@
 // You can contact the author at <christian.brommer@ieee.org>
 
 #include <mars/core_state.h>
+#include <mars/core_state_kernels.h>
 #include <mars/general_functions/utils.h>
 #include <mars/time.h>
 #include <mars/type_definitions/core_state_type.h>
@@ -43,6 +44,16 @@ void CoreState::set_fixed_gyro_bias(const bool& value)
   fixed_gyro_bias_ = value;
 }
 
+bool CoreState::get_fixed_acc_bias() const
+{
+  return fixed_acc_bias_;
+}
+
+bool CoreState::get_fixed_gyro_bias() const
+{
+  return fixed_gyro_bias_;
+}
+
 void CoreState::set_propagation_sensor(std::shared_ptr<SensorAbsClass> propagation_sensor)
 {
   propagation_sensor_ = std::move(propagation_sensor);
@@ -94,8 +105,6 @@ CoreStateMatrix CoreState::InitializeCovariance()
 CoreStateType CoreState::PropagateState(const CoreStateType& prior_state, const IMUMeasurementType& measurement,
                                         const double& dt)
 {
-  CoreStateType current_state;
-
   double delta_t = dt;
 
   if (delta_t < 0)
@@ -104,145 +113,81 @@ CoreStateType CoreState::PropagateState(const CoreStateType& prior_state, const
     delta_t = std::abs(delta_t);
   }
 
-  // Map System Input
-  current_state.w_m_ = measurement.angular_velocity_;
-  current_state.a_m_ = measurement.linear_acceleration_;
-
   // Sanity check that IMU ACC data is non-zero
-  if (current_state.a_m_.isZero())
+  if (measurement.linear_acceleration_.isZero())
   {
     std::cout << "[Warning] Core State Propagation: The acceleration measurement is zero" << std::endl;
   }
 
-  // Zero propagation
-  if (fixed_gyro_bias_)
-  {
-    current_state.b_w_.setZero();
-  }
-  else
-  {
-    current_state.b_w_ = prior_state.b_w_;
-  }
-
-  if (fixed_acc_bias_)
-  {
-    current_state.b_a_.setZero();
-  }
-  else
-  {
-    current_state.b_a_ = prior_state.b_a_;
-  }
-
-  // First order Quaternion integration
-  const Eigen::Vector3d ew = current_state.w_m_ - current_state.b_w_;
-  const Eigen::Vector3d ew_old = prior_state.w_m_ - prior_state.b_w_;
-  const Eigen::Vector3d median_turn_rate = (ew_old + ew) / 2;
-
-  // Quaternion right side multiplication matrix from angular turn rates
-  const Eigen::Matrix4d omega = Utils::OmegaMat(ew);
-  const Eigen::Matrix4d omega_old = Utils::OmegaMat(ew_old);
-  const Eigen::Matrix4d omega_med = Utils::OmegaMat(median_turn_rate);
-
-  // Matrix exponential approximation
-  // Reference: Solar - Quaternion Kinematics - Equation(224b)
-  const Eigen::Matrix4d omega_n = omega_med * 0.5 * delta_t;
-  const Eigen::Matrix4d matexp = Utils::MatExp(omega_n, 4);
-
-  // first order Quaternion integration matrix
-  const Eigen::Matrix4d quat_int = matexp + ((omega * omega_old - omega_old * omega) * (delta_t * delta_t)) / 48.0;
-
-  const Eigen::Vector4d prior_quat_coeffs(prior_state.q_wi_.w(), prior_state.q_wi_.x(), prior_state.q_wi_.y(),
-                                          prior_state.q_wi_.z());
-
-  const Eigen::Vector4d current_q_wi_coeffs = (quat_int * prior_quat_coeffs);
-
-  current_state.q_wi_ = Eigen::Quaterniond(current_q_wi_coeffs.x(), current_q_wi_coeffs.y(), current_q_wi_coeffs.z(),
-                                           current_q_wi_coeffs.w());
-  current_state.q_wi_.normalize();
-
-  // integrate linear acceleration
-  const Eigen::Vector3d ea = current_state.a_m_ - current_state.b_a_;
-  const Eigen::Vector3d ea_old = prior_state.a_m_ - prior_state.b_a_;
-
-  const Eigen::Vector3d dv =
-      (current_state.q_wi_.toRotationMatrix() * ea + prior_state.q_wi_.toRotationMatrix() * ea_old) / 2;
-  current_state.v_wi_ = prior_state.v_wi_ + (dv - g_) * delta_t;
+  const CoreStateKernelsDouble::State prior = CoreStateKernelsDouble::State::FromCoreState(prior_state);
 
-  // integrate velocity
-  current_state.p_wi_ = prior_state.p_wi_ + ((current_state.v_wi_ + prior_state.v_wi_) / 2) * delta_t;
-
-  return current_state;
+  return CoreStateKernelsDouble::PropagateState(prior, measurement.angular_velocity_, measurement.linear_acceleration_,
+                                                delta_t, g_, fixed_gyro_bias_, fixed_acc_bias_)
+      .ToCoreState();
 }
 
 CoreType CoreState::PredictProcessCovariance(const CoreType& prior_core_state, const IMUMeasurementType& system_input,
                                              const double& dt)
 {
-  const CoreStateMatrix P = prior_core_state.cov_;
-  const Eigen::Quaterniond q_wi(prior_core_state.state_.q_wi_);
-  const Eigen::Vector3d b_a = prior_core_state.state_.b_a_;
-  const Eigen::Vector3d b_w = prior_core_state.state_.b_w_;
-
-  const Eigen::Vector3d w_m = system_input.angular_velocity_;
-  const Eigen::Vector3d a_m = system_input.linear_acceleration_;
-
-  const Eigen::Vector3d w_est = w_m - b_w;
-  const Eigen::Vector3d a_est = a_m - b_a;
+  CoreType result;
+  result.cov_ = CoreStateKernelsDouble::PredictProcessCovariance(
+      prior_core_state.cov_, CoreStateKernelsDouble::State::FromCoreState(prior_core_state.state_),
+      system_input.angular_velocity_, system_input.linear_acceleration_, dt, n_a_, n_ba_, n_w_, n_bw_,
+      state_transition_type_, &result.state_transition_);
+  return result;
+}
 
-  // State-Transition and Process-Noise
-  CoreStateMatrix F_d = GenerateFdSmallAngleApprox(q_wi, a_est, w_est, dt);
-  CoreStateMatrix Q_d =
-      CalcQSmallAngleApprox(dt, q_wi, a_m, this->n_a_, b_a, this->n_ba_, w_m, this->n_w_, b_w, this->n_bw_);
+CoreType CoreState::PropagateStateAndCovariance(const CoreType& prior_core_state,
+                                                const IMUMeasurementType& system_input, const double& dt)
+{
+  double delta_t = dt;
 
-  CoreStateMatrix P_predicted_raw = F_d * P * F_d.transpose() + Q_d;
+  if (delta_t < 0)
+  {
+    std::cout << "[Warning] Core State Propagation: delta t is negativ" << std::endl;
+    delta_t = std::abs(delta_t);
+  }
 
-  CoreStateMatrix propagated_state_covariance = Utils::EnforceMatrixSymmetry(P_predicted_raw);
-  CoreStateMatrix state_transition = F_d;
+  // Sanity check that IMU ACC data is non-zero
+  if (system_input.linear_acceleration_.isZero())
+  {
+    std::cout << "[Warning] Core State Propagation: The acceleration measurement is zero" << std::endl;
+  }
 
   CoreType result;
-  result.cov_ = propagated_state_covariance;
-  result.state_transition_ = state_transition;
+  result.state_ = CoreStateKernelsDouble::PropagateStateAndCovariance(
+                      CoreStateKernelsDouble::State::FromCoreState(prior_core_state.state_), prior_core_state.cov_,
+                      system_input.angular_velocity_, system_input.linear_acceleration_, delta_t, g_, n_a_, n_ba_,
+                      n_w_, n_bw_, fixed_gyro_bias_, fixed_acc_bias_, state_transition_type_, &result.cov_,
+                      &result.state_transition_)
+                      .ToCoreState();
   return result;
 }
 
 CoreStateMatrix CoreState::GenerateFdSmallAngleApprox(const Eigen::Quaterniond& q_wi, const Eigen::Vector3d& a_est,
                                                       const Eigen::Vector3d& w_est, const double& dt)
 {
-  const Eigen::Matrix3d R = q_wi.toRotationMatrix();
-
-  const Eigen::Matrix3d I(Eigen::Matrix3d::Identity());
-
-  // Prepare dt powers (dt_p2 = dt power 2)
-  const double dt_p2 = dt * dt;
-  const double dt_p3 = dt_p2 * dt;
-  const double dt_p4 = dt_p2 * dt_p2;
-  const double dt_p5 = dt_p4 * dt;
-
-  const Eigen::Matrix3d skew_w_est = Utils::Skew(w_est);
-  const Eigen::Matrix3d skew_a_est = Utils::Skew(a_est);
-  const Eigen::Matrix3d skew_w_est_p2 = skew_w_est * skew_w_est;
-
-  const Eigen::Matrix3d A =
-      -R * skew_a_est * (I * ((dt_p2) / 2) - ((dt_p3) / 6) * skew_w_est + ((dt_p4) / 24) * skew_w_est_p2);
-  const Eigen::Matrix3d B =
-      -R * skew_a_est * (I * ((-dt_p3) / 6) + ((dt_p4) / 24) * skew_w_est - ((dt_p5) / 120) * skew_w_est_p2);
-  const Eigen::Matrix3d C = -R * skew_a_est * (I * dt - ((dt_p2) / 2) * skew_w_est + ((dt_p3) / 6) * skew_w_est_p2);
-  const Eigen::Matrix3d D = -A;
-  const Eigen::Matrix3d E = I - dt * skew_w_est + ((dt_p2) / 2) * skew_w_est_p2;
-  const Eigen::Matrix3d F = -dt * I + ((dt_p2) / 2) * skew_w_est - (dt_p3) / 6 * skew_w_est_p2;
-
-  // Map matrix components
-  CoreStateMatrix F_d(CoreStateMatrix::Identity());
-  F_d.block(0, 3, 3, 3) = I * dt;
-  F_d.block(0, 6, 3, 3) = A;
-  F_d.block(0, 9, 3, 3) = B;
-  F_d.block(0, 12, 3, 3) = -R * ((dt_p2) / 2);
-
-  F_d.block(3, 6, 3, 3) = C;
-  F_d.block(3, 9, 3, 3) = D;
-  F_d.block(3, 12, 3, 3) = -R * dt;
-
-  F_d.block(6, 6, 3, 3) = E;
-  F_d.block(6, 9, 3, 3) = F;
-  return F_d;
+  return CoreStateKernelsDouble::GenerateFdSmallAngleApprox(q_wi, a_est, w_est, dt);
+}
+
+CoreStateMatrix CoreState::GenerateFdTaylor(const Eigen::Quaterniond& q_wi, const Eigen::Vector3d& a_est,
+                                            const Eigen::Vector3d& w_est, const double& dt, const int& order)
+{
+  return CoreStateKernelsDouble::GenerateFdTaylor(q_wi, a_est, w_est, dt, order);
+}
+
+CoreStateMatrix CoreState::GenerateFdClosedForm(const Eigen::Quaterniond& q_wi, const Eigen::Vector3d& a_est,
+                                                const Eigen::Vector3d& w_est, const double& dt)
+{
+  return CoreStateKernelsDouble::GenerateFdClosedForm(q_wi, a_est, w_est, dt);
+}
+
+CoreStateMatrix CoreState::CalcQClosedForm(const double& dt, const Eigen::Quaterniond& q_wi, const Eigen::Vector3d& a_m,
+                                           const Eigen::Vector3d& n_a, const Eigen::Vector3d& b_a,
+                                           const Eigen::Vector3d& n_ba, const Eigen::Vector3d& w_m,
+                                           const Eigen::Vector3d& n_w, const Eigen::Vector3d& b_w,
+                                           const Eigen::Vector3d& n_bw)
+{
+  return CoreStateKernelsDouble::CalcQClosedForm(dt, q_wi, a_m, n_a, b_a, n_ba, w_m, n_w, b_w, n_bw);
 }
 }  // namespace mars
@@ -0,0 +1,639 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/core_state_batch.h>
+#include <mars/core_state_kernels.h>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+namespace mars
+{
+namespace
+{
+constexpr int kN = CoreStateType::size_error_;
+
+// Number of instances per tile of the covariance propagation
+constexpr int kTile = 16;
+
+// Row offsets of the state elements in CoreStateBatch::state_
+constexpr int kRowP = 0;
+constexpr int kRowV = 3;
+constexpr int kRowQ = 6;
+constexpr int kRowBw = 10;
+constexpr int kRowBa = 13;
+constexpr int kRowWm = 16;
+constexpr int kRowAm = 19;
+
+// One value per instance
+using Lane = Eigen::Array<double, 1, Eigen::Dynamic>;
+
+struct Vec3L
+{
+  Lane v[3];
+};
+
+struct Mat3L
+{
+  Lane m[9];
+
+  Lane& operator()(const int& r, const int& c)
+  {
+    return m[r * 3 + c];
+  }
+  const Lane& operator()(const int& r, const int& c) const
+  {
+    return m[r * 3 + c];
+  }
+};
+
+Vec3L GetVec3(const CoreStateBatch::Rows& rows, const int& first_row)
+{
+  Vec3L result;
+  for (int k = 0; k < 3; k++)
+  {
+    result.v[k] = rows.row(first_row + k);
+  }
+  return result;
+}
+
+Mat3L Multiply(const Mat3L& a, const Mat3L& b)
+{
+  Mat3L result;
+  for (int r = 0; r < 3; r++)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      result(r, c) = a(r, 0) * b(0, c) + a(r, 1) * b(1, c) + a(r, 2) * b(2, c);
+    }
+  }
+  return result;
+}
+
+Vec3L Multiply(const Mat3L& a, const Vec3L& b)
+{
+  Vec3L result;
+  for (int r = 0; r < 3; r++)
+  {
+    result.v[r] = a(r, 0) * b.v[0] + a(r, 1) * b.v[1] + a(r, 2) * b.v[2];
+  }
+  return result;
+}
+
+Mat3L Scale(const Mat3L& a, const double& s)
+{
+  Mat3L result;
+  for (int k = 0; k < 9; k++)
+  {
+    result.m[k] = a.m[k] * s;
+  }
+  return result;
+}
+
+Mat3L Skew(const Vec3L& v, const int& size)
+{
+  Mat3L result;
+  result(0, 0) = Lane::Zero(size);
+  result(0, 1) = -v.v[2];
+  result(0, 2) = v.v[1];
+  result(1, 0) = v.v[2];
+  result(1, 1) = Lane::Zero(size);
+  result(1, 2) = -v.v[0];
+  result(2, 0) = -v.v[1];
+  result(2, 1) = v.v[0];
+  result(2, 2) = Lane::Zero(size);
+  return result;
+}
+
+// c0 * I + c1 * a + c2 * b
+Mat3L Polynomial(const double& c0, const double& c1, const Mat3L& a, const double& c2, const Mat3L& b)
+{
+  Mat3L result;
+  for (int r = 0; r < 3; r++)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      result(r, c) = c1 * a(r, c) + c2 * b(r, c);
+      if (r == c)
+      {
+        result(r, c) += c0;
+      }
+    }
+  }
+  return result;
+}
+
+// c0 * I + c1 * a + c2 * b with one coefficient c1 and c2 per instance
+Mat3L Polynomial(const double& c0, const Lane& c1, const Mat3L& a, const Lane& c2, const Mat3L& b)
+{
+  Mat3L result;
+  for (int r = 0; r < 3; r++)
+  {
+    for (int c = 0; c < 3; c++)
+    {
+      result(r, c) = c1 * a(r, c) + c2 * b(r, c);
+      if (r == c)
+      {
+        result(r, c) += c0;
+      }
+    }
+  }
+  return result;
+}
+
+// Same element order as Eigen::QuaternionBase::toRotationMatrix
+Mat3L RotationMatrix(const Lane& w, const Lane& x, const Lane& y, const Lane& z)
+{
+  const Lane tx = 2 * x;
+  const Lane ty = 2 * y;
+  const Lane tz = 2 * z;
+  const Lane twx = tx * w;
+  const Lane twy = ty * w;
+  const Lane twz = tz * w;
+  const Lane txx = tx * x;
+  const Lane txy = ty * x;
+  const Lane txz = tz * x;
+  const Lane tyy = ty * y;
+  const Lane tyz = tz * y;
+  const Lane tzz = tz * z;
+
+  Mat3L R;
+  R(0, 0) = 1 - (tyy + tzz);
+  R(0, 1) = txy - twz;
+  R(0, 2) = txz + twy;
+  R(1, 0) = txy + twz;
+  R(1, 1) = 1 - (txx + tzz);
+  R(1, 2) = tyz - twx;
+  R(2, 0) = txz - twy;
+  R(2, 1) = tyz + twx;
+  R(2, 2) = 1 - (txx + tyy);
+  return R;
+}
+
+// Quaternion coefficients [w x y z], one lane each
+struct QuatL
+{
+  Lane c[4];
+};
+
+// Applies Utils::OmegaMat(v) to the quaternion coefficients without forming the 4x4 matrix
+QuatL OmegaApply(const Vec3L& v, const QuatL& q)
+{
+  QuatL result;
+  result.c[0] = -(v.v[0] * q.c[1] + v.v[1] * q.c[2] + v.v[2] * q.c[3]);
+  result.c[1] = v.v[0] * q.c[0] - (v.v[1] * q.c[3] - v.v[2] * q.c[2]);
+  result.c[2] = v.v[1] * q.c[0] - (v.v[2] * q.c[1] - v.v[0] * q.c[3]);
+  result.c[3] = v.v[2] * q.c[0] - (v.v[0] * q.c[2] - v.v[1] * q.c[1]);
+  return result;
+}
+
+// Element of the state transition matrix, either a constant for all instances or one value per instance
+struct FdElement
+{
+  bool is_zero{ true };
+  bool is_lane{ false };
+  double value{ 0 };
+  Lane lane;
+
+  void set(const double& v)
+  {
+    is_zero = (v == 0);
+    is_lane = false;
+    value = v;
+  }
+
+  void set(const Lane& v)
+  {
+    is_zero = false;
+    is_lane = true;
+    lane = v;
+  }
+};
+///
+/// \brief PropagateCovTile P = F_d * P * F_d^T + Q_d for the instances [c0, c0 + w)
+///
+/// Only the non-zero elements of F_d are evaluated. The process noise Q_d of the selected state transition is evaluated
+/// per instance.
+///
+template <int Width>
+void PropagateCovTile(const CoreState& core_states, const IMUMeasurementType& system_input, const double& dt,
+                      const CoreStateBatch::Rows& state, const FdElement (&F_d)[kN][kN], const int& c0, const int& w,
+                      CoreStateBatch::Rows* T, CoreStateBatch::Rows* P_raw, CoreStateBatch::Rows* cov)
+{
+  // Process noise
+  for (int n = 0; n < w; n++)
+  {
+    const int idx = c0 + n;
+    const Eigen::Quaterniond q_wi(state(kRowQ, idx), state(kRowQ + 1, idx), state(kRowQ + 2, idx),
+                                  state(kRowQ + 3, idx));
+    const Eigen::Vector3d b_a = state.col(idx).segment<3>(kRowBa).matrix();
+    const Eigen::Vector3d b_w = state.col(idx).segment<3>(kRowBw).matrix();
+
+    Eigen::Matrix<double, kN, kN, Eigen::RowMajor> Q_n;
+    if (core_states.state_transition_type_ == StateTransitionType::closed_form)
+    {
+      Q_n = CoreStateKernelsDouble::CalcQClosedForm(dt, q_wi, system_input.linear_acceleration_, core_states.n_a_, b_a,
+                                                    core_states.n_ba_, system_input.angular_velocity_,
+                                                    core_states.n_w_, b_w, core_states.n_bw_);
+    }
+    else
+    {
+      Q_n = CoreStateKernelsDouble::CalcQSmallAngleApprox(dt, q_wi, system_input.linear_acceleration_,
+                                                          core_states.n_a_, b_a, core_states.n_ba_,
+                                                          system_input.angular_velocity_, core_states.n_w_, b_w,
+                                                          core_states.n_bw_);
+    }
+
+    P_raw->col(n) = Eigen::Map<const Eigen::Array<double, CoreStateBatch::kCovRows, 1>>(Q_n.data());
+  }
+
+  // T = F_d * P
+  T->leftCols(w).setZero();
+  for (int i = 0; i < kN; i++)
+  {
+    for (int k = 0; k < kN; k++)
+    {
+      const FdElement& f = F_d[i][k];
+      if (f.is_zero)
+      {
+        continue;
+      }
+
+      for (int j = 0; j < kN; j++)
+      {
+        auto t_row = T->row(i * kN + j).template segment<Width>(0, w);
+        const auto p_row = cov->row(k * kN + j).template segment<Width>(c0, w);
+        if (f.is_lane)
+        {
+          t_row += f.lane.template segment<Width>(c0, w) * p_row;
+        }
+        else
+        {
+          t_row += f.value * p_row;
+        }
+      }
+    }
+  }
+
+  // P_raw = T * F_d^T + Q_d
+  for (int j = 0; j < kN; j++)
+  {
+    for (int l = 0; l < kN; l++)
+    {
+      const FdElement& f = F_d[j][l];
+      if (f.is_zero)
+      {
+        continue;
+      }
+
+      for (int i = 0; i < kN; i++)
+      {
+        auto p_row = P_raw->row(i * kN + j).template segment<Width>(0, w);
+        const auto t_row = T->row(i * kN + l).template segment<Width>(0, w);
+        if (f.is_lane)
+        {
+          p_row += t_row * f.lane.template segment<Width>(c0, w);
+        }
+        else
+        {
+          p_row += t_row * f.value;
+        }
+      }
+    }
+  }
+
+  // Enforce symmetry
+  for (int i = 0; i < kN; i++)
+  {
+    for (int j = 0; j < kN; j++)
+    {
+      const auto p_ij = P_raw->row(i * kN + j).template segment<Width>(0, w);
+      const auto p_ji = P_raw->row(j * kN + i).template segment<Width>(0, w);
+      cov->row(i * kN + j).template segment<Width>(c0, w) = (p_ij + p_ji) / 2;
+    }
+  }
+}
+}  // namespace
+
+CoreStateBatch::CoreStateBatch(std::shared_ptr<CoreState> core_states, const int& size)
+  : core_states_(std::move(core_states)), size_(size > 0 ? size : 1)
+{
+  state_ = Rows::Zero(kStateRows, size_);
+  state_.row(kRowQ).setOnes();  // Identity orientation
+  cov_ = Rows::Zero(kCovRows, size_);
+  state_transition_ = Rows::Zero(kCovRows, size_);
+
+  std::cout << "Created: CoreStateBatch (Size=" << size_ << ")" << std::endl;
+}
+
+int CoreStateBatch::size() const
+{
+  return size_;
+}
+
+void CoreStateBatch::set_core(const int& idx, const CoreType& core)
+{
+  const CoreStateType& s = core.state_;
+  state_.col(idx).segment<3>(kRowP).matrix() = s.p_wi_;
+  state_.col(idx).segment<3>(kRowV).matrix() = s.v_wi_;
+  state_(kRowQ, idx) = s.q_wi_.w();
+  state_.col(idx).segment<3>(kRowQ + 1).matrix() = s.q_wi_.vec();
+  state_.col(idx).segment<3>(kRowBw).matrix() = s.b_w_;
+  state_.col(idx).segment<3>(kRowBa).matrix() = s.b_a_;
+  state_.col(idx).segment<3>(kRowWm).matrix() = s.w_m_;
+  state_.col(idx).segment<3>(kRowAm).matrix() = s.a_m_;
+
+  for (int r = 0; r < kN; r++)
+  {
+    for (int c = 0; c < kN; c++)
+    {
+      cov_(r * kN + c, idx) = core.cov_(r, c);
+      state_transition_(r * kN + c, idx) = core.state_transition_(r, c);
+    }
+  }
+}
+
+void CoreStateBatch::set_all(const CoreType& core)
+{
+  for (int k = 0; k < size_; k++)
+  {
+    set_core(k, core);
+  }
+}
+
+CoreType CoreStateBatch::get_core(const int& idx) const
+{
+  CoreType core;
+  CoreStateType& s = core.state_;
+  s.p_wi_ = state_.col(idx).segment<3>(kRowP).matrix();
+  s.v_wi_ = state_.col(idx).segment<3>(kRowV).matrix();
+  s.q_wi_ = Eigen::Quaterniond(state_(kRowQ, idx), state_(kRowQ + 1, idx), state_(kRowQ + 2, idx),
+                               state_(kRowQ + 3, idx));
+  s.b_w_ = state_.col(idx).segment<3>(kRowBw).matrix();
+  s.b_a_ = state_.col(idx).segment<3>(kRowBa).matrix();
+  s.w_m_ = state_.col(idx).segment<3>(kRowWm).matrix();
+  s.a_m_ = state_.col(idx).segment<3>(kRowAm).matrix();
+
+  for (int r = 0; r < kN; r++)
+  {
+    for (int c = 0; c < kN; c++)
+    {
+      core.cov_(r, c) = cov_(r * kN + c, idx);
+      core.state_transition_(r, c) = state_transition_(r * kN + c, idx);
+    }
+  }
+
+  return core;
+}
+
+void CoreStateBatch::Propagate(const IMUMeasurementType& system_input, const double& dt)
+{
+  // Same order as in CoreLogic::PerformCoreStatePropagation, the covariance uses the prior state
+  PredictProcessCovariance(system_input, dt);
+  PropagateState(system_input, dt);
+}
+
+void CoreStateBatch::PropagateState(const IMUMeasurementType& measurement, const double& dt)
+{
+  const double delta_t = std::abs(dt);
+
+  // Prior state
+  const Vec3L p_prior = GetVec3(state_, kRowP);
+  const Vec3L v_prior = GetVec3(state_, kRowV);
+  QuatL q_prior;
+  for (int k = 0; k < 4; k++)
+  {
+    q_prior.c[k] = state_.row(kRowQ + k);
+  }
+
+  // Biases of the prior state and zero propagation
+  const Vec3L b_w_prior = GetVec3(state_, kRowBw);
+  const Vec3L b_a_prior = GetVec3(state_, kRowBa);
+
+  if (core_states_->get_fixed_gyro_bias())
+  {
+    state_.middleRows<3>(kRowBw).setZero();
+  }
+  if (core_states_->get_fixed_acc_bias())
+  {
+    state_.middleRows<3>(kRowBa).setZero();
+  }
+
+  // First order Quaternion integration
+  Vec3L ew;
+  Vec3L ew_old;
+  Vec3L median_turn_rate;
+  for (int k = 0; k < 3; k++)
+  {
+    ew.v[k] = measurement.angular_velocity_(k) - state_.row(kRowBw + k);
+    ew_old.v[k] = state_.row(kRowWm + k) - b_w_prior.v[k];
+    median_turn_rate.v[k] = (ew_old.v[k] + ew.v[k]) / 2;
+  }
+
+  // Matrix exponential approximation with order 4, applied to the prior quaternion
+  // Reference: Solar - Quaternion Kinematics - Equation(224b)
+  QuatL q_new = q_prior;
+  QuatL term = q_prior;
+  for (int k = 1; k <= 4; k++)
+  {
+    term = OmegaApply(median_turn_rate, term);
+    for (int c = 0; c < 4; c++)
+    {
+      term.c[c] *= (0.5 * delta_t) / k;
+      q_new.c[c] += term.c[c];
+    }
+  }
+
+  // First order correction term (omega * omega_old - omega_old * omega) * dt^2 / 48
+  const QuatL q_a = OmegaApply(ew, OmegaApply(ew_old, q_prior));
+  const QuatL q_b = OmegaApply(ew_old, OmegaApply(ew, q_prior));
+  for (int c = 0; c < 4; c++)
+  {
+    q_new.c[c] += (q_a.c[c] - q_b.c[c]) * (delta_t * delta_t) / 48.0;
+  }
+
+  const Lane q_norm =
+      (q_new.c[0].square() + q_new.c[1].square() + q_new.c[2].square() + q_new.c[3].square()).sqrt();
+  for (int c = 0; c < 4; c++)
+  {
+    q_new.c[c] /= q_norm;
+  }
+
+  // Integrate linear acceleration
+  Vec3L ea;
+  Vec3L ea_old;
+  for (int k = 0; k < 3; k++)
+  {
+    ea.v[k] = measurement.linear_acceleration_(k) - state_.row(kRowBa + k);
+    ea_old.v[k] = state_.row(kRowAm + k) - b_a_prior.v[k];
+  }
+
+  const Vec3L r_ea = Multiply(RotationMatrix(q_new.c[0], q_new.c[1], q_new.c[2], q_new.c[3]), ea);
+  const Vec3L r_ea_old = Multiply(RotationMatrix(q_prior.c[0], q_prior.c[1], q_prior.c[2], q_prior.c[3]), ea_old);
+
+  const Eigen::Vector3d& g = core_states_->g_;
+  for (int k = 0; k < 3; k++)
+  {
+    const Lane dv = (r_ea.v[k] + r_ea_old.v[k]) / 2;
+    state_.row(kRowV + k) = v_prior.v[k] + (dv - g(k)) * delta_t;
+
+    // Integrate velocity
+    state_.row(kRowP + k) = p_prior.v[k] + ((state_.row(kRowV + k) + v_prior.v[k]) / 2) * delta_t;
+  }
+
+  for (int c = 0; c < 4; c++)
+  {
+    state_.row(kRowQ + c) = q_new.c[c];
+  }
+
+  // Map system input
+  for (int k = 0; k < 3; k++)
+  {
+    state_.row(kRowWm + k).setConstant(measurement.angular_velocity_(k));
+    state_.row(kRowAm + k).setConstant(measurement.linear_acceleration_(k));
+  }
+}
+
+void CoreStateBatch::PredictProcessCovariance(const IMUMeasurementType& system_input, const double& dt)
+{
+  const Mat3L R = RotationMatrix(state_.row(kRowQ), state_.row(kRowQ + 1), state_.row(kRowQ + 2),
+                                 state_.row(kRowQ + 3));
+
+  Vec3L w_est;
+  Vec3L a_est;
+  for (int k = 0; k < 3; k++)
+  {
+    w_est.v[k] = system_input.angular_velocity_(k) - state_.row(kRowBw + k);
+    a_est.v[k] = system_input.linear_acceleration_(k) - state_.row(kRowBa + k);
+  }
+
+  // State transition, see CoreStateKernels::FillFdSmallAngleApprox and CoreStateKernels::FillFdClosedForm
+  const double dt_p2 = dt * dt;
+  const double dt_p3 = dt_p2 * dt;
+  const double dt_p4 = dt_p2 * dt_p2;
+  const double dt_p5 = dt_p4 * dt;
+
+  const Mat3L skew_w_est = Skew(w_est, size_);
+  const Mat3L skew_a_est = Skew(a_est, size_);
+  const Mat3L skew_w_est_p2 = Multiply(skew_w_est, skew_w_est);
+  const Mat3L neg_r_skew_a = Scale(Multiply(R, skew_a_est), -1);
+
+  // Attitude error transition and its integrals sigma_1 to sigma_3
+  Mat3L theta_theta;
+  Mat3L sigma_1;
+  Mat3L sigma_2;
+  Mat3L sigma_3;
+  if (core_states_->state_transition_type_ == StateTransitionType::closed_form)
+  {
+    // The coefficients depend on the rotation angle of each instance
+    Lane c[5];
+    for (int k = 0; k < 5; k++)
+    {
+      c[k].resize(size_);
+    }
+    for (int n = 0; n < size_; n++)
+    {
+      const double theta =
+          std::sqrt(w_est.v[0](n) * w_est.v[0](n) + w_est.v[1](n) * w_est.v[1](n) + w_est.v[2](n) * w_est.v[2](n)) *
+          dt;
+      double c_n[5];
+      CoreStateKernelsDouble::ClosedFormCoefficients(theta, c_n);
+      for (int k = 0; k < 5; k++)
+      {
+        c[k](n) = c_n[k];
+      }
+    }
+
+    theta_theta = Polynomial(1, -dt * c[0], skew_w_est, dt_p2 * c[1], skew_w_est_p2);
+    sigma_1 = Polynomial(dt, -dt_p2 * c[1], skew_w_est, dt_p3 * c[2], skew_w_est_p2);
+    sigma_2 = Polynomial(dt_p2 / 2, -dt_p3 * c[2], skew_w_est, dt_p4 * c[3], skew_w_est_p2);
+    sigma_3 = Polynomial(dt_p3 / 6, -dt_p4 * c[3], skew_w_est, dt_p5 * c[4], skew_w_est_p2);
+  }
+  else
+  {
+    theta_theta = Polynomial(1, -dt, skew_w_est, dt_p2 / 2, skew_w_est_p2);
+    sigma_1 = Polynomial(dt, -dt_p2 / 2, skew_w_est, dt_p3 / 6, skew_w_est_p2);
+    sigma_2 = Polynomial(dt_p2 / 2, -dt_p3 / 6, skew_w_est, dt_p4 / 24, skew_w_est_p2);
+    sigma_3 = Polynomial(dt_p3 / 6, -dt_p4 / 24, skew_w_est, dt_p5 / 120, skew_w_est_p2);
+  }
+
+  const Mat3L A = Multiply(neg_r_skew_a, sigma_2);
+  const Mat3L B = Scale(Multiply(neg_r_skew_a, sigma_3), -1);
+  const Mat3L C = Multiply(neg_r_skew_a, sigma_1);
+  const Mat3L D = Scale(A, -1);
+  const Mat3L& E = theta_theta;
+  const Mat3L F = Scale(sigma_1, -1);
+  const Mat3L R_p2 = Scale(R, -dt_p2 / 2);
+  const Mat3L R_p1 = Scale(R, -dt);
+
+  FdElement F_d[kN][kN];
+  for (int k = 0; k < kN; k++)
+  {
+    F_d[k][k].set(1.0);
+  }
+
+  auto set_block = [&F_d](const int& row, const int& col, const Mat3L& block) {
+    for (int r = 0; r < 3; r++)
+    {
+      for (int c = 0; c < 3; c++)
+      {
+        F_d[row + r][col + c].set(block(r, c));
+      }
+    }
+  };
+
+  for (int k = 0; k < 3; k++)
+  {
+    F_d[k][3 + k].set(dt);
+  }
+  set_block(0, 6, A);
+  set_block(0, 9, B);
+  set_block(0, 12, R_p2);
+  set_block(3, 6, C);
+  set_block(3, 9, D);
+  set_block(3, 12, R_p1);
+  set_block(6, 6, E);
+  set_block(6, 9, F);
+
+  // The instances are processed in tiles such that the covariance rows of one tile remain in the cache. Full tiles
+  // have a compile time width which allows Eigen to unroll the lane operations.
+  Rows T(kCovRows, kTile);
+  Rows P_raw(kCovRows, kTile);
+  for (int c0 = 0; c0 < size_; c0 += kTile)
+  {
+    if (c0 + kTile <= size_)
+    {
+      PropagateCovTile<kTile>(*core_states_, system_input, dt, state_, F_d, c0, kTile, &T, &P_raw, &cov_);
+    }
+    else
+    {
+      PropagateCovTile<Eigen::Dynamic>(*core_states_, system_input, dt, state_, F_d, c0, size_ - c0, &T, &P_raw,
+                                       &cov_);
+    }
+  }
+
+  for (int i = 0; i < kN; i++)
+  {
+    for (int j = 0; j < kN; j++)
+    {
+      const FdElement& f = F_d[i][j];
+      if (f.is_lane)
+      {
+        state_transition_.row(i * kN + j) = f.lane;
+      }
+      else
+      {
+        state_transition_.row(i * kN + j).setConstant(f.value);
+      }
+    }
+  }
+}
+}  // namespace mars
@@ -9,413 +9,437 @@
 // You can contact the author at <christian.brommer@ieee.org>
 
 #include <mars/core_state.h>
+#include <mars/core_state_kernels.h>
 #include <mars/type_definitions/core_state_type.h>
 #include <Eigen/Dense>
 #include <cmath>
 
 namespace mars
 {
-CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eigen::Quaterniond& q_wi,
-                                                 const Eigen::Vector3d& a_m, const Eigen::Vector3d& n_a,
-                                                 const Eigen::Vector3d& b_a, const Eigen::Vector3d& n_ba,
-                                                 const Eigen::Vector3d& w_m, const Eigen::Vector3d& n_w,
-                                                 const Eigen::Vector3d& b_w, const Eigen::Vector3d& n_bw)
+template <typename StorageScalar, typename AccScalar>
+typename CoreStateKernels<StorageScalar, AccScalar>::AccMatrix
+CoreStateKernels<StorageScalar, AccScalar>::CalcQSmallAngleApprox(const AccScalar& dt_lim, const AccQuaternion& q_wi,
+                                                                  const AccVector3& a_m, const AccVector3& n_a,
+                                                                  const AccVector3& b_a, const AccVector3& n_ba,
+                                                                  const AccVector3& w_m, const AccVector3& n_w,
+                                                                  const AccVector3& b_w, const AccVector3& n_bw)
 {
-  Eigen::Vector4d q_wi_vect;
+  // Divisions by constants are replaced by multiplications with their reciprocals rN = 1 / N
+  constexpr AccScalar r3 = AccScalar(1) / AccScalar(3);
+  constexpr AccScalar r5 = AccScalar(1) / AccScalar(5);
+  constexpr AccScalar r6 = AccScalar(1) / AccScalar(6);
+  constexpr AccScalar r7 = AccScalar(1) / AccScalar(7);
+  constexpr AccScalar r9 = AccScalar(1) / AccScalar(9);
+  constexpr AccScalar r10 = AccScalar(1) / AccScalar(10);
+  constexpr AccScalar r11 = AccScalar(1) / AccScalar(11);
+  constexpr AccScalar r12 = AccScalar(1) / AccScalar(12);
+  constexpr AccScalar r14 = AccScalar(1) / AccScalar(14);
+  constexpr AccScalar r18 = AccScalar(1) / AccScalar(18);
+  constexpr AccScalar r20 = AccScalar(1) / AccScalar(20);
+  constexpr AccScalar r24 = AccScalar(1) / AccScalar(24);
+  constexpr AccScalar r30 = AccScalar(1) / AccScalar(30);
+  constexpr AccScalar r36 = AccScalar(1) / AccScalar(36);
+  constexpr AccScalar r42 = AccScalar(1) / AccScalar(42);
+  constexpr AccScalar r48 = AccScalar(1) / AccScalar(48);
+  constexpr AccScalar r54 = AccScalar(1) / AccScalar(54);
+  constexpr AccScalar r120 = AccScalar(1) / AccScalar(120);
+  constexpr AccScalar r252 = AccScalar(1) / AccScalar(252);
+
+  AccVector4 q_wi_vect;
   q_wi_vect << q_wi.w(), q_wi.x(), q_wi.y(), q_wi.z();
 
-  Eigen::Matrix<double, 15, 15> Q_d(Eigen::Matrix<double, 15, 15>::Zero());
+  AccMatrix Q_d(AccMatrix::Zero());
 
-  double t2;
-  double t3;
-  double t4;
-  double t5;
-  double t6;
-  double t7;
-  double t8;
-  double t9;
-  double t11;
-  double t13;
-  double t14;
-  double t15;
-  double t16;
-  double t17;
-  double t18;
-  double t19;
-  double t20;
-  double t21;
-  double t22;
-  double t23;
-  double t24;
-  double t25;
-  double t26;
-  double t27;
-  double t28;
-  double t29;
-  double t42;
-  double t10;
-  double t12;
-  double t30;
-  double t31;
-  double t32;
-  double t33;
-  double t34;
-  double t35;
-  double t40;
-  double t41;
-  double t67;
-  double t68;
-  double t69;
-  double t70;
-  double t71;
-  double t72;
-  double t88;
-  double t89;
-  double t90;
-  double t39;
-  double t91;
-  double t92;
-  double t93;
-  double t94;
-  double t95;
-  double t96;
-  double t97;
-  double t98;
-  double t99;
-  double t124;
-  double t125;
-  double t126;
-  double t127;
-  double t128;
-  double t129;
-  double t151;
-  double t152;
-  double t153;
-  double t201;
-  double t202;
-  double t203;
-  double t315_tmp;
-  double b_t315_tmp;
-  double t315;
-  double t316_tmp;
-  double b_t316_tmp;
-  double t316;
-  double t100;
-  double t101;
-  double t102;
-  double t106;
-  double t107;
-  double t108;
-  double t116;
-  double t118;
-  double t121;
-  double t139;
-  double t140;
-  double t141;
-  double t154;
-  double t155;
-  double t156;
-  double t157;
-  double t158;
-  double t159;
-  double t160;
-  double t161;
-  double t162_tmp;
-  double t162;
-  double t163;
-  double t3532;
-  double t164;
-  double t165;
-  double t183_tmp;
-  double t183;
-  double t184;
-  double t185;
-  double t225;
-  double t226;
-  double t227;
-  double t264;
-  double t265;
-  double t266;
-  double t318;
-  double t319;
-  double t320;
-  double t321;
-  double t322;
-  double t323;
-  double t340_tmp;
-  double b_t340_tmp;
-  double t340;
-  double t419;
-  double t420;
-  double t421;
-  double t469_tmp_tmp;
-  double t469_tmp;
-  double t469;
-  double t473_tmp_tmp;
-  double t473_tmp;
-  double t473;
-  double t112;
-  double t113;
-  double t114;
-  double t166;
-  double t167;
-  double t168;
-  double t211;
-  double t214;
-  double t297;
-  double t298;
-  double t299;
-  double t306;
-  double t307;
-  double t308;
-  double t309;
-  double t310;
-  double t311;
-  double t341;
-  double t342;
-  double t343;
-  double t362;
-  double t363;
-  double t364;
-  double t368;
-  double t398;
-  double t399;
-  double t400;
-  double t401;
-  double t402;
-  double t403;
-  double t425;
-  double t426;
-  double t427;
-  double t481_tmp;
-  double b_t481_tmp;
-  double t481;
-  double t538_tmp_tmp;
-  double t538;
-  double t539_tmp;
-  double t539;
-  double t540_tmp;
-  double t540;
-  double t242;
-  double t394;
-  double t541;
-  double t542;
-  double t543;
-  double t269;
-  double t535;
-  double t536;
-  double t537;
-  double t3525;
-  double t552_tmp;
-  double t555_tmp;
-  double t626_tmp;
-  double t627_tmp;
-  double t630_tmp;
-  double t892;
-  double a_tmp;
-  double t914;
-  double b_a_tmp;
-  double c_a_tmp;
-  double t915;
-  double d_a_tmp;
-  double t1136;
-  double e_a_tmp;
-  double t1137;
-  double f_a_tmp;
-  double t1139;
-  double g_a_tmp;
-  double t1140;
-  double t721;
-  double t722;
-  double t723;
-  double t733;
-  double t734;
-  double t735;
-  double t736;
-  double t737;
-  double t738;
-  double t742;
-  double t743;
-  double t744;
-  double t745;
-  double t746;
-  double t747;
-  double t748;
-  double t749;
-  double t750;
-  double t755;
-  double t756;
-  double t757;
-  double t784;
-  double t785;
-  double t786;
-  double t787;
-  double t788;
-  double t789;
-  double t823;
-  double t824;
-  double t825;
-  double t916;
-  double a_tmp_tmp;
-  double t1138;
-  double b_a_tmp_tmp;
-  double t1141;
-  double t1474;
-  double t1475;
-  double t1476;
-  double t1477;
-  double t1478;
-  double t1479;
-  double t1483;
-  double t1484;
-  double t1485;
-  double t1486;
-  double t1487;
-  double t1488;
-  double h_a_tmp;
-  double t1498;
-  double i_a_tmp;
-  double t1499;
-  double j_a_tmp;
-  double t1500;
-  double t1504;
-  double t1505;
-  double t1506;
-  double t1515;
-  double t1516;
-  double t1517;
-  double t762_tmp;
-  double t762;
-  double t763_tmp;
-  double t763;
-  double t765_tmp;
-  double t765;
-  double t766_tmp;
-  double t766;
-  double t776_tmp;
-  double t776;
-  double t779_tmp;
-  double t779;
-  double t854_tmp;
-  double t854;
-  double t855_tmp;
-  double t855;
-  double t857_tmp;
-  double t857;
-  double t858_tmp;
-  double t858;
-  double t1492;
-  double t1493;
-  double t1494;
-  double t1495;
-  double t1496;
-  double t1497;
-  double t2974;
-  double t2975;
-  double t2976;
-  double t2980;
-  double t2981;
-  double t2983;
-  double t2984;
-  double t2985;
-  double t2989_tmp;
-  double t2989;
-  double t2990_tmp;
-  double t2990;
-  double t2991_tmp;
-  double t2991;
-  double t3043_tmp;
-  double b_t3043_tmp;
-  double c_t3043_tmp;
-  double d_t3043_tmp;
-  double t3043;
-  double t3044_tmp;
-  double b_t3044_tmp;
-  double t3044;
-  double t2986;
-  double t2987;
-  double t2988;
-  double t2992;
-  double t2993;
-  double t2994;
-  double t2995;
-  double t2996;
-  double t2997;
-  double t2998;
-  double t2999;
-  double t3000;
-  double t3045;
-  double t3531_tmp;
-  double b_t3531_tmp;
-  double c_t3531_tmp;
-  double d_t3531_tmp;
-  double e_t3531_tmp;
-  double f_t3531_tmp;
-  double g_t3531_tmp;
-  double h_t3531_tmp;
-  double i_t3531_tmp;
-  double j_t3531_tmp;
-  double k_t3531_tmp;
-  double l_t3531_tmp;
-  double m_t3531_tmp;
-  double n_t3531_tmp;
-  double o_t3531_tmp;
-  double p_t3531_tmp;
-  double q_t3531_tmp;
-  double r_t3531_tmp;
-  double s_t3531_tmp;
-  double t_t3531_tmp;
-  double u_t3531_tmp;
-  double v_t3531_tmp;
-  double w_t3531_tmp;
-  double x_t3531_tmp;
-  double y_t3531_tmp;
-  double ab_t3531_tmp;
-  double bb_t3531_tmp;
-  double cb_t3531_tmp;
-  double db_t3531_tmp;
-  double eb_t3531_tmp;
-  double fb_t3531_tmp;
-  double gb_t3531_tmp;
-  double hb_t3531_tmp;
-  double t3531;
-  double t3510;
-  double t3511_tmp;
-  double b_t3511_tmp;
-  double c_t3511_tmp;
-  double d_t3511_tmp;
-  double e_t3511_tmp;
-  double f_t3511_tmp;
-  double t3511;
-  double t3519_tmp;
-  double t3519;
-  double t3520_tmp;
-  double b_t3520_tmp;
-  double c_t3520_tmp;
-  double d_t3520_tmp;
-  double e_t3520_tmp;
-  double t3520;
-  double t3512_tmp;
-  double b_t3512_tmp;
-  double t3512;
-  double t3513;
-  double t3514;
-  double t3515_tmp;
-  double b_t3515_tmp;
-  double t3515;
-  double t3516_tmp;
-  double t3516;
-  double t3517_tmp;
-  double t3517;
-  double t3518_tmp;
-  double b_t3518_tmp;
-  double t3518;
-  double t3521_tmp;
-  double t3521;
-  double t3522;
-  double t3523;
-  double t3524_tmp;
-  double b_t3524_tmp;
+  AccScalar t2;
+  AccScalar t3;
+  AccScalar t4;
+  AccScalar t5;
+  AccScalar t6;
+  AccScalar t7;
+  AccScalar t8;
+  AccScalar t9;
+  AccScalar t11;
+  AccScalar t13;
+  AccScalar t14;
+  AccScalar t15;
+  AccScalar t16;
+  AccScalar t17;
+  AccScalar t18;
+  AccScalar t19;
+  AccScalar t20;
+  AccScalar t21;
+  AccScalar t22;
+  AccScalar t23;
+  AccScalar t24;
+  AccScalar t25;
+  AccScalar t26;
+  AccScalar t27;
+  AccScalar t28;
+  AccScalar t29;
+  AccScalar t42;
+  AccScalar t10;
+  AccScalar t12;
+  AccScalar t30;
+  AccScalar t31;
+  AccScalar t32;
+  AccScalar t33;
+  AccScalar t34;
+  AccScalar t35;
+  AccScalar t40;
+  AccScalar t41;
+  AccScalar t67;
+  AccScalar t68;
+  AccScalar t69;
+  AccScalar t70;
+  AccScalar t71;
+  AccScalar t72;
+  AccScalar t88;
+  AccScalar t89;
+  AccScalar t90;
+  AccScalar t39;
+  AccScalar t91;
+  AccScalar t92;
+  AccScalar t93;
+  AccScalar t94;
+  AccScalar t95;
+  AccScalar t96;
+  AccScalar t97;
+  AccScalar t98;
+  AccScalar t99;
+  AccScalar t124;
+  AccScalar t125;
+  AccScalar t126;
+  AccScalar t127;
+  AccScalar t128;
+  AccScalar t129;
+  AccScalar t151;
+  AccScalar t152;
+  AccScalar t153;
+  AccScalar t201;
+  AccScalar t202;
+  AccScalar t203;
+  AccScalar t315_tmp;
+  AccScalar b_t315_tmp;
+  AccScalar t315;
+  AccScalar t316_tmp;
+  AccScalar b_t316_tmp;
+  AccScalar t316;
+  AccScalar t100;
+  AccScalar t101;
+  AccScalar t102;
+  AccScalar t106;
+  AccScalar t107;
+  AccScalar t108;
+  AccScalar t116;
+  AccScalar t118;
+  AccScalar t121;
+  AccScalar t139;
+  AccScalar t140;
+  AccScalar t141;
+  AccScalar t154;
+  AccScalar t155;
+  AccScalar t156;
+  AccScalar t157;
+  AccScalar t158;
+  AccScalar t159;
+  AccScalar t160;
+  AccScalar t161;
+  AccScalar t162_tmp;
+  AccScalar t162;
+  AccScalar t163;
+  AccScalar t3532;
+  AccScalar t164;
+  AccScalar t165;
+  AccScalar t183_tmp;
+  AccScalar t183;
+  AccScalar t184;
+  AccScalar t185;
+  AccScalar t225;
+  AccScalar t226;
+  AccScalar t227;
+  AccScalar t264;
+  AccScalar t265;
+  AccScalar t266;
+  AccScalar t318;
+  AccScalar t319;
+  AccScalar t320;
+  AccScalar t321;
+  AccScalar t322;
+  AccScalar t323;
+  AccScalar t340_tmp;
+  AccScalar b_t340_tmp;
+  AccScalar t340;
+  AccScalar t419;
+  AccScalar t420;
+  AccScalar t421;
+  AccScalar t469_tmp_tmp;
+  AccScalar t469_tmp;
+  AccScalar t469;
+  AccScalar t473_tmp_tmp;
+  AccScalar t473_tmp;
+  AccScalar t473;
+  AccScalar t112;
+  AccScalar t113;
+  AccScalar t114;
+  AccScalar t166;
+  AccScalar t167;
+  AccScalar t168;
+  AccScalar t211;
+  AccScalar t214;
+  AccScalar t297;
+  AccScalar t298;
+  AccScalar t299;
+  AccScalar t306;
+  AccScalar t307;
+  AccScalar t308;
+  AccScalar t309;
+  AccScalar t310;
+  AccScalar t311;
+  AccScalar t341;
+  AccScalar t342;
+  AccScalar t343;
+  AccScalar t362;
+  AccScalar t363;
+  AccScalar t364;
+  AccScalar t368;
+  AccScalar t398;
+  AccScalar t399;
+  AccScalar t400;
+  AccScalar t401;
+  AccScalar t402;
+  AccScalar t403;
+  AccScalar t425;
+  AccScalar t426;
+  AccScalar t427;
+  AccScalar t481_tmp;
+  AccScalar b_t481_tmp;
+  AccScalar t481;
+  AccScalar t538_tmp_tmp;
+  AccScalar t538;
+  AccScalar t539_tmp;
+  AccScalar t539;
+  AccScalar t540_tmp;
+  AccScalar t540;
+  AccScalar t242;
+  AccScalar t394;
+  AccScalar t541;
+  AccScalar t542;
+  AccScalar t543;
+  AccScalar t269;
+  AccScalar t535;
+  AccScalar t536;
+  AccScalar t537;
+  AccScalar t3525;
+  AccScalar t552_tmp;
+  AccScalar t555_tmp;
+  AccScalar t626_tmp;
+  AccScalar t627_tmp;
+  AccScalar t630_tmp;
+  AccScalar t892;
+  AccScalar a_tmp;
+  AccScalar t914;
+  AccScalar b_a_tmp;
+  AccScalar c_a_tmp;
+  AccScalar t915;
+  AccScalar d_a_tmp;
+  AccScalar t1136;
+  AccScalar e_a_tmp;
+  AccScalar t1137;
+  AccScalar f_a_tmp;
+  AccScalar t1139;
+  AccScalar g_a_tmp;
+  AccScalar t1140;
+  AccScalar t721;
+  AccScalar t722;
+  AccScalar t723;
+  AccScalar t733;
+  AccScalar t734;
+  AccScalar t735;
+  AccScalar t736;
+  AccScalar t737;
+  AccScalar t738;
+  AccScalar t742;
+  AccScalar t743;
+  AccScalar t744;
+  AccScalar t745;
+  AccScalar t746;
+  AccScalar t747;
+  AccScalar t748;
+  AccScalar t749;
+  AccScalar t750;
+  AccScalar t755;
+  AccScalar t756;
+  AccScalar t757;
+  AccScalar t784;
+  AccScalar t785;
+  AccScalar t786;
+  AccScalar t787;
+  AccScalar t788;
+  AccScalar t789;
+  AccScalar t823;
+  AccScalar t824;
+  AccScalar t825;
+  AccScalar t916;
+  AccScalar a_tmp_tmp;
+  AccScalar t1138;
+  AccScalar b_a_tmp_tmp;
+  AccScalar t1141;
+  AccScalar t1474;
+  AccScalar t1475;
+  AccScalar t1476;
+  AccScalar t1477;
+  AccScalar t1478;
+  AccScalar t1479;
+  AccScalar t1483;
+  AccScalar t1484;
+  AccScalar t1485;
+  AccScalar t1486;
+  AccScalar t1487;
+  AccScalar t1488;
+  AccScalar h_a_tmp;
+  AccScalar t1498;
+  AccScalar i_a_tmp;
+  AccScalar t1499;
+  AccScalar j_a_tmp;
+  AccScalar t1500;
+  AccScalar t1504;
+  AccScalar t1505;
+  AccScalar t1506;
+  AccScalar t1515;
+  AccScalar t1516;
+  AccScalar t1517;
+  AccScalar t762_tmp;
+  AccScalar t762;
+  AccScalar t763_tmp;
+  AccScalar t763;
+  AccScalar t765_tmp;
+  AccScalar t765;
+  AccScalar t766_tmp;
+  AccScalar t766;
+  AccScalar t776_tmp;
+  AccScalar t776;
+  AccScalar t779_tmp;
+  AccScalar t779;
+  AccScalar t854_tmp;
+  AccScalar t854;
+  AccScalar t855_tmp;
+  AccScalar t855;
+  AccScalar t857_tmp;
+  AccScalar t857;
+  AccScalar t858_tmp;
+  AccScalar t858;
+  AccScalar t1492;
+  AccScalar t1493;
+  AccScalar t1494;
+  AccScalar t1495;
+  AccScalar t1496;
+  AccScalar t1497;
+  AccScalar t2974;
+  AccScalar t2975;
+  AccScalar t2976;
+  AccScalar t2980;
+  AccScalar t2981;
+  AccScalar t2983;
+  AccScalar t2984;
+  AccScalar t2985;
+  AccScalar t2989_tmp;
+  AccScalar t2989;
+  AccScalar t2990_tmp;
+  AccScalar t2990;
+  AccScalar t2991_tmp;
+  AccScalar t2991;
+  AccScalar t3043_tmp;
+  AccScalar b_t3043_tmp;
+  AccScalar c_t3043_tmp;
+  AccScalar d_t3043_tmp;
+  AccScalar t3043;
+  AccScalar t3044_tmp;
+  AccScalar b_t3044_tmp;
+  AccScalar t3044;
+  AccScalar t2986;
+  AccScalar t2987;
+  AccScalar t2988;
+  AccScalar t2992;
+  AccScalar t2993;
+  AccScalar t2994;
+  AccScalar t2995;
+  AccScalar t2996;
+  AccScalar t2997;
+  AccScalar t2998;
+  AccScalar t2999;
+  AccScalar t3000;
+  AccScalar t3045;
+  AccScalar t3531_tmp;
+  AccScalar b_t3531_tmp;
+  AccScalar c_t3531_tmp;
+  AccScalar d_t3531_tmp;
+  AccScalar e_t3531_tmp;
+  AccScalar f_t3531_tmp;
+  AccScalar g_t3531_tmp;
+  AccScalar h_t3531_tmp;
+  AccScalar i_t3531_tmp;
+  AccScalar j_t3531_tmp;
+  AccScalar k_t3531_tmp;
+  AccScalar l_t3531_tmp;
+  AccScalar m_t3531_tmp;
+  AccScalar n_t3531_tmp;
+  AccScalar o_t3531_tmp;
+  AccScalar p_t3531_tmp;
+  AccScalar q_t3531_tmp;
+  AccScalar r_t3531_tmp;
+  AccScalar s_t3531_tmp;
+  AccScalar t_t3531_tmp;
+  AccScalar u_t3531_tmp;
+  AccScalar v_t3531_tmp;
+  AccScalar w_t3531_tmp;
+  AccScalar x_t3531_tmp;
+  AccScalar y_t3531_tmp;
+  AccScalar ab_t3531_tmp;
+  AccScalar bb_t3531_tmp;
+  AccScalar cb_t3531_tmp;
+  AccScalar db_t3531_tmp;
+  AccScalar eb_t3531_tmp;
+  AccScalar fb_t3531_tmp;
+  AccScalar gb_t3531_tmp;
+  AccScalar hb_t3531_tmp;
+  AccScalar t3531;
+  AccScalar t3510;
+  AccScalar t3511_tmp;
+  AccScalar b_t3511_tmp;
+  AccScalar c_t3511_tmp;
+  AccScalar d_t3511_tmp;
+  AccScalar e_t3511_tmp;
+  AccScalar f_t3511_tmp;
+  AccScalar t3511;
+  AccScalar t3519_tmp;
+  AccScalar t3519;
+  AccScalar t3520_tmp;
+  AccScalar b_t3520_tmp;
+  AccScalar c_t3520_tmp;
+  AccScalar d_t3520_tmp;
+  AccScalar e_t3520_tmp;
+  AccScalar t3520;
+  AccScalar t3512_tmp;
+  AccScalar b_t3512_tmp;
+  AccScalar t3512;
+  AccScalar t3513;
+  AccScalar t3514;
+  AccScalar t3515_tmp;
+  AccScalar b_t3515_tmp;
+  AccScalar t3515;
+  AccScalar t3516_tmp;
+  AccScalar t3516;
+  AccScalar t3517_tmp;
+  AccScalar t3517;
+  AccScalar t3518_tmp;
+  AccScalar b_t3518_tmp;
+  AccScalar t3518;
+  AccScalar t3521_tmp;
+  AccScalar t3521;
+  AccScalar t3522;
+  AccScalar t3523;
+  AccScalar t3524_tmp;
+  AccScalar b_t3524_tmp;
   t2 = q_wi_vect[0] * q_wi_vect[1];
   t3 = q_wi_vect[0] * q_wi_vect[2];
   t4 = q_wi_vect[0] * q_wi_vect[3];
@@ -423,9 +447,10 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t6 = q_wi_vect[1] * q_wi_vect[3];
   t7 = q_wi_vect[2] * q_wi_vect[3];
   t8 = dt_lim * dt_lim;
-  t9 = pow(dt_lim, 3.0);
-  t11 = pow(dt_lim, 5.0);
-  t13 = pow(dt_lim, 7.0);
+  // Powers of dt are formed from products instead of pow()
+  t9 = t8 * dt_lim;
+  t11 = t9 * t8;
+  t13 = t11 * t8;
   t14 = n_a[0] * n_a[0];
   t15 = n_a[1] * n_a[1];
   t16 = n_a[2] * n_a[2];
@@ -442,17 +467,17 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t27 = q_wi_vect[1] * q_wi_vect[1];
   t28 = q_wi_vect[2] * q_wi_vect[2];
   t29 = q_wi_vect[3] * q_wi_vect[3];
-  t42 = pow(dt_lim, 11.0);
+  t42 = t13 * t8 * t8;
   t10 = t8 * t8;
-  t12 = pow(t8, 3.0);
-  t30 = t2 * 2.0;
-  t31 = t3 * 2.0;
-  t32 = t4 * 2.0;
-  t33 = t5 * 2.0;
-  t34 = t6 * 2.0;
-  t35 = t7 * 2.0;
-  t40 = pow(t9, 3.0);
-  t41 = pow(t8, 5.0);
+  t12 = t10 * t8;
+  t30 = t2 * AccScalar(2.0);
+  t31 = t3 * AccScalar(2.0);
+  t32 = t4 * AccScalar(2.0);
+  t33 = t5 * AccScalar(2.0);
+  t34 = t6 * AccScalar(2.0);
+  t35 = t7 * AccScalar(2.0);
+  t40 = t9 * t9 * t9;
+  t41 = t10 * t10 * t8;
   t67 = a_m[0] + -b_a[0];
   t68 = a_m[1] + -b_a[1];
   t69 = a_m[2] + -b_a[2];
@@ -472,48 +497,48 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t97 = t30 + t35;
   t98 = t31 + t34;
   t99 = t32 + t33;
-  t124 = b_w[0] / 2.0 + -(w_m[0] / 2.0);
-  t125 = b_w[1] / 2.0 + -(w_m[1] / 2.0);
-  t126 = b_w[2] / 2.0 + -(w_m[2] / 2.0);
-  t127 = b_w[0] / 6.0 + -(w_m[0] / 6.0);
-  t128 = b_w[1] / 6.0 + -(w_m[1] / 6.0);
-  t129 = b_w[2] / 6.0 + -(w_m[2] / 6.0);
-  t151 = b_w[0] / 24.0 + -(w_m[0] / 24.0);
-  t152 = b_w[1] / 24.0 + -(w_m[1] / 24.0);
-  t153 = b_w[2] / 24.0 + -(w_m[2] / 24.0);
+  t124 = b_w[0] / AccScalar(2.0) + -(w_m[0] / AccScalar(2.0));
+  t125 = b_w[1] / AccScalar(2.0) + -(w_m[1] / AccScalar(2.0));
+  t126 = b_w[2] / AccScalar(2.0) + -(w_m[2] / AccScalar(2.0));
+  t127 = b_w[0] * r6 + -(w_m[0] * r6);
+  t128 = b_w[1] * r6 + -(w_m[1] * r6);
+  t129 = b_w[2] * r6 + -(w_m[2] * r6);
+  t151 = b_w[0] * r24 + -(w_m[0] * r24);
+  t152 = b_w[1] * r24 + -(w_m[1] * r24);
+  t153 = b_w[2] * r24 + -(w_m[2] * r24);
   t201 = ((t26 + t29) + -t27) + -t28;
   t202 = ((t26 + t28) + -t27) + -t29;
   t203 = ((t26 + t27) + -t28) + -t29;
   t315_tmp = t23 * t70;
   b_t315_tmp = t315_tmp * t71;
-  t315 = b_t315_tmp * t72 / 4.0;
+  t315 = b_t315_tmp * t72 / AccScalar(4.0);
   t316_tmp = t24 * t70;
   b_t316_tmp = t316_tmp * t71;
-  t316 = b_t316_tmp * t72 / 4.0;
+  t316 = b_t316_tmp * t72 / AccScalar(4.0);
   t100 = t30 + -t35;
   t101 = t31 + -t34;
   t102 = t32 + -t33;
   t106 = t97 * t97;
   t107 = t98 * t98;
   t108 = t99 * t99;
-  t6 = t91 / 2.0;
-  t116 = t91 / 3.0;
-  t4 = t92 / 2.0;
-  t118 = t92 / 3.0;
-  t26 = t91 / 6.0;
-  t5 = t93 / 2.0;
-  t121 = t93 / 3.0;
-  t27 = t92 / 6.0;
-  t28 = t93 / 6.0;
-  t29 = t91 / 24.0;
-  t30 = t92 / 24.0;
-  t35 = t93 / 24.0;
+  t6 = t91 / AccScalar(2.0);
+  t116 = t91 * r3;
+  t4 = t92 / AccScalar(2.0);
+  t118 = t92 * r3;
+  t26 = t91 * r6;
+  t5 = t93 / AccScalar(2.0);
+  t121 = t93 * r3;
+  t27 = t92 * r6;
+  t28 = t93 * r6;
+  t29 = t91 * r24;
+  t30 = t92 * r24;
+  t35 = t93 * r24;
   t139 = t124 * t124;
   t140 = t125 * t125;
   t141 = t126 * t126;
-  t31 = t91 / 120.0;
-  t34 = t92 / 120.0;
-  t32 = t93 / 120.0;
+  t31 = t91 * r120;
+  t34 = t92 * r120;
+  t32 = t93 * r120;
   t154 = t67 * t97;
   t155 = t67 * t98;
   t156 = t68 * t98;
@@ -530,14 +555,14 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t164 = t3532 * t94;
   t165 = -(t3532 * t89);
   t183_tmp = t9 * t17;
-  t183 = -(t183_tmp * t90 / 3.0);
+  t183 = -(t183_tmp * t90 * r3);
   t90 = t9 * t18;
-  t184 = -(t90 * t88 / 3.0);
+  t184 = -(t90 * t88 * r3);
   t88 = t9 * t19;
-  t185 = -(t88 * t89 / 3.0);
-  t225 = t183_tmp * t95 / 3.0;
-  t226 = t90 * t96 / 3.0;
-  t227 = t88 * t94 / 3.0;
+  t185 = -(t88 * t89 * r3);
+  t225 = t183_tmp * t95 * r3;
+  t226 = t90 * t96 * r3;
+  t227 = t88 * t94 * r3;
   t264 = t201 * t201;
   t265 = t202 * t202;
   t266 = t203 * t203;
@@ -549,7 +574,7 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t323 = t69 * t203;
   t340_tmp = t25 * t70;
   b_t340_tmp = t340_tmp * t71;
-  t340 = -(b_t340_tmp * t72 / 4.0);
+  t340 = -(b_t340_tmp * t72 / AccScalar(4.0));
   t2 = t14 * t99;
   t419 = t2 * t203;
   t7 = t15 * t97;
@@ -558,10 +583,10 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t421 = t3 * t201;
   t469_tmp_tmp = t17 * t99;
   t469_tmp = t469_tmp_tmp * t203;
-  t469 = t469_tmp / 8.0;
+  t469 = t469_tmp / AccScalar(8.0);
   t473_tmp_tmp = t19 * t98;
   t473_tmp = t473_tmp_tmp * t201;
-  t473 = t473_tmp / 8.0;
+  t473 = t473_tmp / AccScalar(8.0);
   t112 = t100 * t100;
   t113 = t101 * t101;
   t114 = t102 * t102;
@@ -571,8 +596,8 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t89 = t68 * t101;
   t67 = t69 * t101;
   t68 = t69 * t102;
-  t211 = t155 / 2.0;
-  t214 = t156 / 2.0;
+  t211 = t155 / AccScalar(2.0);
+  t214 = t156 / AccScalar(2.0);
   t297 = t2 * t101;
   t298 = t7 * t102;
   t299 = t3 * t100;
@@ -588,44 +613,44 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t362 = t31 + t34;
   t363 = t31 + t32;
   t364 = t34 + t32;
-  t368 = t321 / 2.0;
-  t398 = -(t33 * t203 / 2.0);
-  t399 = -(t162_tmp * t202 / 2.0);
-  t400 = -(t3532 * t201 / 2.0);
-  t401 = -(t183_tmp * t203 / 6.0);
-  t402 = -(t90 * t202 / 6.0);
-  t403 = -(t88 * t201 / 6.0);
+  t368 = t321 / AccScalar(2.0);
+  t398 = -(t33 * t203 / AccScalar(2.0));
+  t399 = -(t162_tmp * t202 / AccScalar(2.0));
+  t400 = -(t3532 * t201 / AccScalar(2.0));
+  t401 = -(t183_tmp * t203 * r6);
+  t402 = -(t90 * t202 * r6);
+  t403 = -(t88 * t201 * r6);
   t425 = t14 * t101 * t203;
   t426 = t15 * t102 * t202;
   t427 = t16 * t100 * t201;
   t481_tmp = t18 * t97;
   b_t481_tmp = t481_tmp * t202;
-  t481 = -(b_t481_tmp / 8.0);
+  t481 = -(b_t481_tmp / AccScalar(8.0));
   t162_tmp = t9 * t20;
   t538_tmp_tmp = t10 * t20;
   t2 = t538_tmp_tmp * t70;
-  t538 = t162_tmp * t125 / 3.0 + -(t2 * t72 / 24.0);
+  t538 = t162_tmp * t125 * r3 + -(t2 * t72 * r24);
   t183_tmp = t9 * t21;
   t539_tmp = t10 * t21;
-  t539 = t183_tmp * t126 / 3.0 + -(t539_tmp * t70 * t71 / 24.0);
+  t539 = t183_tmp * t126 * r3 + -(t539_tmp * t70 * t71 * r24);
   t3532 = t9 * t22;
   t540_tmp = t10 * t22;
-  t540 = t3532 * t124 / 3.0 + -(t540_tmp * t71 * t72 / 24.0);
-  t242 = t167 / 2.0;
-  t394 = -(t323 / 2.0);
+  t540 = t3532 * t124 * r3 + -(t540_tmp * t71 * t72 * r24);
+  t242 = t167 / AccScalar(2.0);
+  t394 = -(t323 / AccScalar(2.0));
   t90 = t154 + t89;
   t88 = t159 + t166;
   t69 = t156 + t68;
   t34 = t167 + t321;
   t32 = t67 + t318;
   t33 = t168 + t322;
-  t541 = -(t162_tmp * t126 / 3.0) + -(t2 * t71 / 24.0);
-  t542 = -(t183_tmp * t124 / 3.0) + -(t539_tmp * t71 * t72 / 24.0);
-  t543 = -(t3532 * t125 / 3.0) + -(t540_tmp * t70 * t72 / 24.0);
-  t269 = -(t68 / 2.0);
-  t535 = -(t8 * t20 / 2.0) + t538_tmp_tmp * t311 / 4.0;
-  t536 = -(t8 * t21 / 2.0) + t539_tmp * t310 / 4.0;
-  t537 = -(t8 * t22 / 2.0) + t540_tmp * t309 / 4.0;
+  t541 = -(t162_tmp * t126 * r3) + -(t2 * t71 * r24);
+  t542 = -(t183_tmp * t124 * r3) + -(t539_tmp * t71 * t72 * r24);
+  t543 = -(t3532 * t125 * r3) + -(t540_tmp * t70 * t72 * r24);
+  t269 = -(t68 / AccScalar(2.0));
+  t535 = -(t8 * t20 / AccScalar(2.0)) + t538_tmp_tmp * t311 / AccScalar(4.0);
+  t536 = -(t8 * t21 / AccScalar(2.0)) + t539_tmp * t310 / AccScalar(4.0);
+  t537 = -(t8 * t22 / AccScalar(2.0)) + t540_tmp * t309 / AccScalar(4.0);
   t30 = t70 * t72;
   t3525 = t30 * t90;
   t31 = t70 * t71;
@@ -641,17 +666,17 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   b_a_tmp = t157 - t319;
   c_a_tmp = (b_a_tmp - t88) + t33;
   t915 = c_a_tmp * c_a_tmp;
-  d_a_tmp = ((((t154 / 2.0 - t158 / 2.0) + t89 / 2.0) - t67 / 2.0) - t318 / 2.0) + t320 / 2.0;
+  d_a_tmp = ((((t154 / AccScalar(2.0) - t158 / AccScalar(2.0)) + t89 / AccScalar(2.0)) - t67 / AccScalar(2.0)) - t318 / AccScalar(2.0)) + t320 / AccScalar(2.0);
   t1136 = d_a_tmp * d_a_tmp;
-  e_a_tmp = ((((t157 / 2.0 - t159 / 2.0) - t166 / 2.0) + t168 / 2.0) - t319 / 2.0) + t322 / 2.0;
+  e_a_tmp = ((((t157 / AccScalar(2.0) - t159 / AccScalar(2.0)) - t166 / AccScalar(2.0)) + t168 / AccScalar(2.0)) - t319 / AccScalar(2.0)) + t322 / AccScalar(2.0);
   t1137 = e_a_tmp * e_a_tmp;
-  f_a_tmp = ((((t154 / 6.0 - t158 / 6.0) + t89 / 6.0) - t67 / 6.0) - t318 / 6.0) + t320 / 6.0;
+  f_a_tmp = ((((t154 * r6 - t158 * r6) + t89 * r6) - t67 * r6) - t318 * r6) + t320 * r6;
   t1139 = f_a_tmp * f_a_tmp;
-  g_a_tmp = ((((t157 / 6.0 - t159 / 6.0) - t166 / 6.0) + t168 / 6.0) - t319 / 6.0) + t322 / 6.0;
+  g_a_tmp = ((((t157 * r6 - t159 * r6) - t166 * r6) + t168 * r6) - t319 * r6) + t322 * r6;
   t1140 = g_a_tmp * g_a_tmp;
-  t721 = t8 * ((t298 / 2.0 + t425 / 2.0) + -(t421 / 2.0));
-  t722 = t8 * ((t299 / 2.0 + -(t419 / 2.0)) + t426 / 2.0);
-  t723 = t8 * ((t297 / 2.0 + -(t420 / 2.0)) + t427 / 2.0);
+  t721 = t8 * ((t298 / AccScalar(2.0) + t425 / AccScalar(2.0)) + -(t421 / AccScalar(2.0)));
+  t722 = t8 * ((t299 / AccScalar(2.0) + -(t419 / AccScalar(2.0))) + t426 / AccScalar(2.0));
+  t723 = t8 * ((t297 / AccScalar(2.0) + -(t420 / AccScalar(2.0))) + t427 / AccScalar(2.0));
   t733 = t125 * t90 + t126 * t32;
   t734 = t124 * t88 + t125 * t33;
   t735 = t126 * t69 + t124 * t34;
@@ -682,92 +707,92 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t824 = t152 * t34 + -t153 * t67;
   t825 = t151 * t32 + -t152 * t89;
   t916 = t892 * t892;
-  a_tmp_tmp = ((((t211 - t214) + t242) + -(t68 / 2.0)) + t368) + -(t323 / 2.0);
+  a_tmp_tmp = ((((t211 - t214) + t242) + -(t68 / AccScalar(2.0))) + t368) + -(t323 / AccScalar(2.0));
   t1138 = a_tmp_tmp * a_tmp_tmp;
-  b_a_tmp_tmp = ((((t155 / 6.0 - t156 / 6.0) + t167 / 6.0) + -(t68 / 6.0)) + t321 / 6.0) + -(t323 / 6.0);
+  b_a_tmp_tmp = ((((t155 * r6 - t156 * r6) + t167 * r6) + -(t68 * r6)) + t321 * r6) + -(t323 * r6);
   t1141 = b_a_tmp_tmp * b_a_tmp_tmp;
   t2 = t30 * t69;
   t7 = t26 * t67;
-  t1474 = (t2 / 6.0 + t7 * -0.16666666666666666) + t309 * t34;
+  t1474 = (t2 * r6 + t7 * -AccScalar(0.16666666666666666)) + t309 * t34;
   t3 = t26 * t90;
   t6 = t31 * t89;
-  t1475 = (t3 / 6.0 + t6 * -0.16666666666666666) + t310 * t32;
+  t1475 = (t3 * r6 + t6 * -AccScalar(0.16666666666666666)) + t310 * t32;
   t4 = t31 * t88;
   t5 = t30 * b_a_tmp;
-  t1476 = (t4 / 6.0 + t5 * -0.16666666666666666) + t311 * t33;
+  t1476 = (t4 * r6 + t5 * -AccScalar(0.16666666666666666)) + t311 * t33;
   t27 = t26 * t32;
   t28 = t30 * t89;
-  t1477 = (t309 * t90 + t27 / 6.0) + t28 / 6.0;
+  t1477 = (t309 * t90 + t27 * r6) + t28 * r6;
   t35 = t31 * t33;
   t29 = t26 * b_a_tmp;
-  t1478 = (t310 * t88 + t35 / 6.0) + t29 / 6.0;
+  t1478 = (t310 * t88 + t35 * r6) + t29 * r6;
   t30 *= t34;
   t26 = t31 * t67;
-  t1479 = (t311 * t69 + t30 / 6.0) + t26 / 6.0;
-  t1483 = (t2 / 24.0 + t7 * -0.041666666666666664) + t341 * t34;
-  t1484 = (t3 / 24.0 + t6 * -0.041666666666666664) + t342 * t32;
-  t1485 = (t4 / 24.0 + t5 * -0.041666666666666664) + t343 * t33;
-  t1486 = (t27 / 24.0 + t341 * t90) + t28 / 24.0;
-  t1487 = (t35 / 24.0 + t342 * t88) + t29 / 24.0;
-  t1488 = (t30 / 24.0 + t343 * t69) + t26 / 24.0;
-  h_a_tmp = (t555_tmp / 24.0 - t630_tmp / 24.0) + t341 * b_a_tmp;
+  t1479 = (t311 * t69 + t30 * r6) + t26 * r6;
+  t1483 = (t2 * r24 + t7 * -AccScalar(0.041666666666666664)) + t341 * t34;
+  t1484 = (t3 * r24 + t6 * -AccScalar(0.041666666666666664)) + t342 * t32;
+  t1485 = (t4 * r24 + t5 * -AccScalar(0.041666666666666664)) + t343 * t33;
+  t1486 = (t27 * r24 + t341 * t90) + t28 * r24;
+  t1487 = (t35 * r24 + t342 * t88) + t29 * r24;
+  t1488 = (t30 * r24 + t343 * t69) + t26 * r24;
+  h_a_tmp = (t555_tmp * r24 - t630_tmp * r24) + t341 * b_a_tmp;
   t1498 = h_a_tmp * h_a_tmp;
-  i_a_tmp = (t552_tmp / 24.0 - t627_tmp / 24.0) + t342 * t67;
+  i_a_tmp = (t552_tmp * r24 - t627_tmp * r24) + t342 * t67;
   t1499 = i_a_tmp * i_a_tmp;
-  j_a_tmp = (t3525 / 24.0 - t626_tmp / 24.0) + t343 * t89;
+  j_a_tmp = (t3525 * r24 - t626_tmp * r24) + t343 * t89;
   t1500 = j_a_tmp * j_a_tmp;
-  t1504 = (t2 / 120.0 + t7 * -0.0083333333333333332) + t362 * t34;
-  t1505 = (t3 / 120.0 + t6 * -0.0083333333333333332) + t363 * t32;
-  t1506 = (t4 / 120.0 + t5 * -0.0083333333333333332) + t364 * t33;
-  t1515 = (t27 / 120.0 + t362 * t90) + t28 / 120.0;
-  t1516 = (t35 / 120.0 + t363 * t88) + t29 / 120.0;
-  t1517 = (t30 / 120.0 + t364 * t69) + t26 / 120.0;
+  t1504 = (t2 * r120 + t7 * -AccScalar(0.0083333333333333332)) + t362 * t34;
+  t1505 = (t3 * r120 + t6 * -AccScalar(0.0083333333333333332)) + t363 * t32;
+  t1506 = (t4 * r120 + t5 * -AccScalar(0.0083333333333333332)) + t364 * t33;
+  t1515 = (t27 * r120 + t362 * t90) + t28 * r120;
+  t1516 = (t35 * r120 + t363 * t88) + t29 * r120;
+  t1517 = (t30 * r120 + t364 * t69) + t26 * r120;
   t762_tmp = t24 * t735;
-  t762 = t762_tmp / 3.0;
+  t762 = t762_tmp * r3;
   t763_tmp = t25 * t734;
-  t763 = t763_tmp / 3.0;
+  t763 = t763_tmp * r3;
   t765_tmp = t24 * t738;
-  t765 = t765_tmp / 4.0;
+  t765 = t765_tmp / AccScalar(4.0);
   t766_tmp = t25 * t737;
-  t766 = t766_tmp / 4.0;
+  t766 = t766_tmp / AccScalar(4.0);
   t776_tmp = t24 * t742;
-  t776 = t776_tmp / 3.0;
+  t776 = t776_tmp * r3;
   t779_tmp = t24 * t745;
-  t779 = t779_tmp / 4.0;
+  t779 = t779_tmp / AccScalar(4.0);
   t854_tmp = t23 * t785;
-  t854 = t854_tmp / 3.0;
+  t854 = t854_tmp * r3;
   t855_tmp = t24 * t784;
-  t855 = t855_tmp / 3.0;
+  t855 = t855_tmp * r3;
   t857_tmp = t23 * t788;
-  t857 = t857_tmp / 4.0;
+  t857 = t857_tmp / AccScalar(4.0);
   t858_tmp = t24 * t787;
-  t858 = t858_tmp / 4.0;
+  t858 = t858_tmp / AccScalar(4.0);
   t1492 = t1483 * t1483;
   t1493 = t1484 * t1484;
   t1494 = t1485 * t1485;
   t1495 = t1486 * t1486;
   t1496 = t1487 * t1487;
   t1497 = t1488 * t1488;
-  t2974 = t738 * t738 + i_a_tmp * a_tmp_tmp * -2.0;
-  t2975 = t736 * t736 + j_a_tmp * d_a_tmp * 2.0;
-  t2976 = t746 * t746 + t1485 * e_a_tmp * -2.0;
-  t2980 = t789 * t789 + t1486 * d_a_tmp * -2.0;
-  t2981 = t788 * t788 + t1488 * a_tmp_tmp * 2.0;
+  t2974 = t738 * t738 + i_a_tmp * a_tmp_tmp * -AccScalar(2.0);
+  t2975 = t736 * t736 + j_a_tmp * d_a_tmp * AccScalar(2.0);
+  t2976 = t746 * t746 + t1485 * e_a_tmp * -AccScalar(2.0);
+  t2980 = t789 * t789 + t1486 * d_a_tmp * -AccScalar(2.0);
+  t2981 = t788 * t788 + t1488 * a_tmp_tmp * AccScalar(2.0);
   t6 = t11 * t20;
-  t2983 = (t538_tmp_tmp * t736 / 4.0 + t162_tmp * d_a_tmp * -0.33333333333333331) + t6 * j_a_tmp * -0.2;
+  t2983 = (t538_tmp_tmp * t736 / AccScalar(4.0) + t162_tmp * d_a_tmp * -AccScalar(0.33333333333333331)) + t6 * j_a_tmp * -AccScalar(0.2);
   t27 = t11 * t21;
-  t2984 = (t539_tmp * t738 / 4.0 + t183_tmp * a_tmp_tmp / 3.0) + t27 * i_a_tmp * -0.2;
+  t2984 = (t539_tmp * t738 / AccScalar(4.0) + t183_tmp * a_tmp_tmp * r3) + t27 * i_a_tmp * -AccScalar(0.2);
   t5 = t11 * t22;
-  t2985 = (t540_tmp * t737 / 4.0 + t3532 * e_a_tmp / 3.0) + t5 * h_a_tmp * -0.2;
+  t2985 = (t540_tmp * t737 / AccScalar(4.0) + t3532 * e_a_tmp * r3) + t5 * h_a_tmp * -AccScalar(0.2);
   t4 = t12 * t20;
-  t2989_tmp = (t3525 / 120.0 - t626_tmp / 120.0) + t364 * t89;
-  t2989 = (t6 * t748 / 5.0 + t538_tmp_tmp * f_a_tmp * -0.25) + t4 * t2989_tmp * -0.16666666666666666;
+  t2989_tmp = (t3525 * r120 - t626_tmp * r120) + t364 * t89;
+  t2989 = (t6 * t748 * r5 + t538_tmp_tmp * f_a_tmp * -AccScalar(0.25)) + t4 * t2989_tmp * -AccScalar(0.16666666666666666);
   t26 = t12 * t21;
-  t2990_tmp = (t552_tmp / 120.0 - t627_tmp / 120.0) + t363 * t67;
-  t2990 = (t27 * t750 / 5.0 + t539_tmp * b_a_tmp_tmp / 4.0) + t26 * t2990_tmp * -0.16666666666666666;
+  t2990_tmp = (t552_tmp * r120 - t627_tmp * r120) + t363 * t67;
+  t2990 = (t27 * t750 * r5 + t539_tmp * b_a_tmp_tmp / AccScalar(4.0)) + t26 * t2990_tmp * -AccScalar(0.16666666666666666);
   t3 = t12 * t22;
-  t2991_tmp = (t555_tmp / 120.0 - t630_tmp / 120.0) + t362 * b_a_tmp;
-  t2991 = (t5 * t749 / 5.0 + t540_tmp * g_a_tmp / 4.0) + t3 * t2991_tmp * -0.16666666666666666;
+  t2991_tmp = (t555_tmp * r120 - t630_tmp * r120) + t362 * b_a_tmp;
+  t2991 = (t5 * t749 * r5 + t540_tmp * g_a_tmp / AccScalar(4.0)) + t3 * t2991_tmp * -AccScalar(0.16666666666666666);
   t3043_tmp = t20 * t70;
   t32 = t21 * t124;
   t318 = t22 * t124;
@@ -783,14 +808,14 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t3043_tmp *= t72;
   t88 = t20 * t125;
   t3043 =
-      ((((t8 * (t316_tmp / 2.0 + -(t340_tmp / 2.0)) + t9 * ((t90 / 6.0 + t168 / 6.0) + -(t2 / 3.0))) +
-         -(t13 * ((-(t20 * t71 * t72 * t91 / 252.0) + c_t3043_tmp * t309 / 42.0) + b_t3043_tmp * t310 / 42.0))) +
-        -t12 * (((d_t3043_tmp * t125 / 36.0 - t3043_tmp * t126 / 36.0) - t318 * t309 / 6.0) + t32 * t310 / 6.0)) +
+      ((((t8 * (t316_tmp / AccScalar(2.0) + -(t340_tmp / AccScalar(2.0))) + t9 * ((t90 * r6 + t168 * r6) + -(t2 * r3))) +
+         -(t13 * ((-(t20 * t71 * t72 * t91 * r252) + c_t3043_tmp * t309 * r42) + b_t3043_tmp * t310 * r42))) +
+        -t12 * (((d_t3043_tmp * t125 * r36 - t3043_tmp * t126 * r36) - t318 * t309 * r6) + t32 * t310 * r6)) +
        t10 *
-           (((((t32 / 4.0 + -(t318 / 4.0)) + t315_tmp * t93 / 8.0) + -(t315_tmp * t92 / 8.0)) + t340_tmp * t306 / 4.0) +
-            -(t316_tmp * t307 / 4.0))) +
-      t11 * (((((b_t3043_tmp / 30.0 + c_t3043_tmp / 30.0) + t2 * t91 / 20.0) - t88 * t126 / 5.0) - t168 * t306 / 10.0) -
-             t90 * t307 / 10.0);
+           (((((t32 / AccScalar(4.0) + -(t318 / AccScalar(4.0))) + t315_tmp * t93 / AccScalar(8.0)) + -(t315_tmp * t92 / AccScalar(8.0))) + t340_tmp * t306 / AccScalar(4.0)) +
+            -(t316_tmp * t307 / AccScalar(4.0)))) +
+      t11 * (((((b_t3043_tmp * r30 + c_t3043_tmp * r30) + t2 * t91 * r20) - t88 * t126 * r5) - t168 * t306 * r10) -
+             t90 * t307 * r10);
   t2 = t22 * t70;
   t68 = t20 * t126;
   t319 = t21 * t126;
@@ -800,38 +825,38 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t28 = t21 * t70;
   t3044_tmp = t28 * t71;
   b_t3044_tmp = t2 * t72;
-  t3044 = ((((t8 * (t69 / 2.0 + -(t322 / 2.0)) + t9 * ((b_t315_tmp / 6.0 + b_t316_tmp / 6.0) + -(b_t340_tmp / 3.0))) +
-             -(t13 * ((-(t2 * t71 * t93 / 252.0) + t3044_tmp * t310 / 42.0) + d_t3043_tmp * t311 / 42.0))) +
-            -t12 * (((b_t3044_tmp * t124 / 36.0 - c_t3043_tmp * t125 / 36.0) - t319 * t310 / 6.0) + t68 * t311 / 6.0)) +
-           t10 * (((((t68 / 4.0 + -(t319 / 4.0)) + t7 * t92 / 8.0) + -(t7 * t91 / 8.0)) + t322 * t307 / 4.0) +
-                  -(t69 * t308 / 4.0))) +
-          t11 * (((((d_t3043_tmp / 30.0 + t3044_tmp / 30.0) + b_t340_tmp * t93 / 20.0) - t318 * t125 / 5.0) -
-                  b_t316_tmp * t307 / 10.0) -
-                 b_t315_tmp * t308 / 10.0);
-  t2986 = (-(t539_tmp * t745 / 4.0) + t183_tmp * d_a_tmp * -0.33333333333333331) + -(t27 * t1484 / 5.0);
-  t2987 = (-(t540_tmp * t747 / 4.0) + t3532 * a_tmp_tmp / 3.0) + -(t5 * t1483 / 5.0);
-  t2988 = (-(t538_tmp_tmp * t746 / 4.0) + t162_tmp * e_a_tmp / 3.0) + -(t6 * t1485 / 5.0);
-  t2992 = (-(t27 * t755 / 5.0) + t539_tmp * f_a_tmp * -0.25) + -(t26 * t1505 / 6.0);
-  t2993 = (-(t5 * t757 / 5.0) + t540_tmp * b_a_tmp_tmp / 4.0) + -(t3 * t1504 / 6.0);
-  t2994 = (-(t538_tmp_tmp * t788 / 4.0) + t162_tmp * a_tmp_tmp / 3.0) + t6 * t1488 / 5.0;
-  t2995 = (-(t540_tmp * t789 / 4.0) + t3532 * d_a_tmp * -0.33333333333333331) + t5 * t1486 / 5.0;
-  t2996 = (-(t6 * t756 / 5.0) + t538_tmp_tmp * g_a_tmp / 4.0) + -(t4 * t1506 / 6.0);
-  t2997 = (-(t539_tmp * t787 / 4.0) + t183_tmp * e_a_tmp / 3.0) + t27 * t1487 / 5.0;
-  t2998 = (-(t6 * t824 / 5.0) + t538_tmp_tmp * b_a_tmp_tmp / 4.0) + t4 * t1517 / 6.0;
-  t2999 = (-(t5 * t825 / 5.0) + t540_tmp * f_a_tmp * -0.25) + t3 * t1515 / 6.0;
-  t3000 = (-(t27 * t823 / 5.0) + t539_tmp * g_a_tmp / 4.0) + t26 * t1516 / 6.0;
+  t3044 = ((((t8 * (t69 / AccScalar(2.0) + -(t322 / AccScalar(2.0))) + t9 * ((b_t315_tmp * r6 + b_t316_tmp * r6) + -(b_t340_tmp * r3))) +
+             -(t13 * ((-(t2 * t71 * t93 * r252) + t3044_tmp * t310 * r42) + d_t3043_tmp * t311 * r42))) +
+            -t12 * (((b_t3044_tmp * t124 * r36 - c_t3043_tmp * t125 * r36) - t319 * t310 * r6) + t68 * t311 * r6)) +
+           t10 * (((((t68 / AccScalar(4.0) + -(t319 / AccScalar(4.0))) + t7 * t92 / AccScalar(8.0)) + -(t7 * t91 / AccScalar(8.0))) + t322 * t307 / AccScalar(4.0)) +
+                  -(t69 * t308 / AccScalar(4.0)))) +
+          t11 * (((((d_t3043_tmp * r30 + t3044_tmp * r30) + b_t340_tmp * t93 * r20) - t318 * t125 * r5) -
+                  b_t316_tmp * t307 * r10) -
+                 b_t315_tmp * t308 * r10);
+  t2986 = (-(t539_tmp * t745 / AccScalar(4.0)) + t183_tmp * d_a_tmp * -AccScalar(0.33333333333333331)) + -(t27 * t1484 * r5);
+  t2987 = (-(t540_tmp * t747 / AccScalar(4.0)) + t3532 * a_tmp_tmp * r3) + -(t5 * t1483 * r5);
+  t2988 = (-(t538_tmp_tmp * t746 / AccScalar(4.0)) + t162_tmp * e_a_tmp * r3) + -(t6 * t1485 * r5);
+  t2992 = (-(t27 * t755 * r5) + t539_tmp * f_a_tmp * -AccScalar(0.25)) + -(t26 * t1505 * r6);
+  t2993 = (-(t5 * t757 * r5) + t540_tmp * b_a_tmp_tmp / AccScalar(4.0)) + -(t3 * t1504 * r6);
+  t2994 = (-(t538_tmp_tmp * t788 / AccScalar(4.0)) + t162_tmp * a_tmp_tmp * r3) + t6 * t1488 * r5;
+  t2995 = (-(t540_tmp * t789 / AccScalar(4.0)) + t3532 * d_a_tmp * -AccScalar(0.33333333333333331)) + t5 * t1486 * r5;
+  t2996 = (-(t6 * t756 * r5) + t538_tmp_tmp * g_a_tmp / AccScalar(4.0)) + -(t4 * t1506 * r6);
+  t2997 = (-(t539_tmp * t787 / AccScalar(4.0)) + t183_tmp * e_a_tmp * r3) + t27 * t1487 * r5;
+  t2998 = (-(t6 * t824 * r5) + t538_tmp_tmp * b_a_tmp_tmp / AccScalar(4.0)) + t4 * t1517 * r6;
+  t2999 = (-(t5 * t825 * r5) + t540_tmp * f_a_tmp * -AccScalar(0.25)) + t3 * t1515 * r6;
+  t3000 = (-(t27 * t823 * r5) + t539_tmp * g_a_tmp / AccScalar(4.0)) + t26 * t1516 * r6;
   t31 = t22 * t125;
   t2 = t316_tmp * t72;
   t34 = t340_tmp * t72;
   t27 = t315_tmp * t72;
   t3045 =
-      ((((-(t8 * (t33 / 2.0 + -(t166 / 2.0))) + t9 * ((t27 / 6.0 + t34 / 6.0) + -(t2 / 3.0))) +
-         -(t13 * ((-(t28 * t72 * t92 / 252.0) + b_t3044_tmp * t309 / 42.0) + t3043_tmp * t311 / 42.0))) +
-        t12 * (((t3044_tmp * t124 / 36.0 - b_t3043_tmp * t126 / 36.0) - t31 * t309 / 6.0) + t88 * t311 / 6.0)) +
-       -(t10 * (((((t88 / 4.0 + -(t31 / 4.0)) + t29 * t93 / 8.0) + -(t29 * t91 / 8.0)) + t166 * t306 / 4.0) +
-                -(t33 * t308 / 4.0)))) +
-      t11 * (((((t3043_tmp / 30.0 + b_t3044_tmp / 30.0) + t2 * t92 / 20.0) - t32 * t126 / 5.0) - t34 * t306 / 10.0) -
-             t27 * t308 / 10.0);
+      ((((-(t8 * (t33 / AccScalar(2.0) + -(t166 / AccScalar(2.0)))) + t9 * ((t27 * r6 + t34 * r6) + -(t2 * r3))) +
+         -(t13 * ((-(t28 * t72 * t92 * r252) + b_t3044_tmp * t309 * r42) + t3043_tmp * t311 * r42))) +
+        t12 * (((t3044_tmp * t124 * r36 - b_t3043_tmp * t126 * r36) - t31 * t309 * r6) + t88 * t311 * r6)) +
+       -(t10 * (((((t88 / AccScalar(4.0) + -(t31 / AccScalar(4.0))) + t29 * t93 / AccScalar(8.0)) + -(t29 * t91 / AccScalar(8.0))) + t166 * t306 / AccScalar(4.0)) +
+                -(t33 * t308 / AccScalar(4.0))))) +
+      t11 * (((((t3043_tmp * r30 + b_t3044_tmp * r30) + t2 * t92 * r20) - t32 * t126 * r5) - t34 * t306 * r10) -
+             t27 * t308 * r10);
   t3531_tmp = t22 * t737;
   b_t3531_tmp = t22 * t749;
   c_t3531_tmp = t23 * t746;
@@ -840,7 +865,7 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   f_t3531_tmp = t20 * t746;
   g_t3531_tmp = t21 * t787;
   h_t3531_tmp = t21 * t823;
-  i_t3531_tmp = (t555_tmp / 6.0 - t630_tmp / 6.0) + t309 * b_a_tmp;
+  i_t3531_tmp = (t555_tmp * r6 - t630_tmp * r6) + t309 * b_a_tmp;
   j_t3531_tmp = t20 * t1485;
   k_t3531_tmp = t21 * t1487;
   l_t3531_tmp = t22 * h_a_tmp;
@@ -866,78 +891,78 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   gb_t3531_tmp = t17 * t108;
   hb_t3531_tmp = t18 * t265;
   t3531 =
-      ((((((t8 * ((db_t3531_tmp / 2.0 + eb_t3531_tmp / 2.0) + fb_t3531_tmp / 2.0) +
-            t10 * (((((gb_t3531_tmp / 8.0 + y_t3531_tmp * t100 / 4.0) + hb_t3531_tmp / 8.0) +
-                     ab_t3531_tmp * e_a_tmp / 4.0) +
-                    bb_t3531_tmp * e_a_tmp / 4.0) +
-                   cb_t3531_tmp * e_a_tmp / 4.0)) +
-           t41 * ((j_t3531_tmp * t1506 / 10.0 + k_t3531_tmp * t1516 / 10.0) + l_t3531_tmp * t2991_tmp / 10.0)) +
-          -t11 * (((((t766_tmp * c_a_tmp * -0.2 + t763_tmp * e_a_tmp * -0.2) + c_t3531_tmp * c_a_tmp / 5.0) +
-                    t858_tmp * c_a_tmp / 5.0) +
-                   d_t3531_tmp * e_a_tmp / 5.0) +
-                  t855_tmp * e_a_tmp / 5.0)) +
-         -t40 * (((((-(e_t3531_tmp * t1485 / 9.0) - f_t3531_tmp * t1506 / 9.0) + h_t3531_tmp * t1487 / 9.0) +
-                   g_t3531_tmp * t1516 / 9.0) +
-                  b_t3531_tmp * h_a_tmp / 9.0) +
-                 t3531_tmp * t2991_tmp / 9.0)) +
-        -t13 * (((((((((((t3531_tmp * g_a_tmp * -0.14285714285714285 + b_t3531_tmp * e_a_tmp * -0.14285714285714285) -
-                         c_t3531_tmp * t1476 / 7.0) -
-                        d_t3531_tmp * t1485 / 7.0) +
-                       t858_tmp * t1478 / 7.0) +
-                      t855_tmp * t1487 / 7.0) +
-                     t766_tmp * i_t3531_tmp / 7.0) +
-                    t763_tmp * h_a_tmp / 7.0) +
-                   e_t3531_tmp * e_a_tmp / 7.0) +
-                  f_t3531_tmp * g_a_tmp / 7.0) +
-                 g_t3531_tmp * g_a_tmp / 7.0) +
-                h_t3531_tmp * e_a_tmp / 7.0)) +
-       t12 * (((((((((((t763_tmp * t737 / 6.0 + d_t3531_tmp * t746 / 6.0) + t855_tmp * t787 / 6.0) +
-                      t_t3531_tmp * g_a_tmp / 6.0) +
-                     p_t3531_tmp * g_a_tmp / 6.0) +
-                    s_t3531_tmp * g_a_tmp / 6.0) +
-                   w_t3531_tmp * c_a_tmp * -0.16666666666666666) +
-                  q_t3531_tmp * c_a_tmp / 6.0) +
-                 -(u_t3531_tmp * c_a_tmp / 6.0)) +
-                m_t3531_tmp * e_a_tmp * -0.16666666666666666) +
-               n_t3531_tmp * e_a_tmp / 6.0) +
-              -(o_t3531_tmp * e_a_tmp / 6.0))) +
-      t39 * (((((((((((t3531_tmp * t749 / 8.0 + f_t3531_tmp * t756 / 8.0) + g_t3531_tmp * t823 / 8.0) +
-                     j_t3531_tmp * g_a_tmp * -0.125) +
-                    k_t3531_tmp * g_a_tmp / 8.0) +
-                   -(l_t3531_tmp * g_a_tmp / 8.0)) +
-                  x_t3531_tmp * e_a_tmp * -0.125) +
-                 r_t3531_tmp * e_a_tmp / 8.0) +
-                -(v_t3531_tmp * e_a_tmp / 8.0)) +
-               m_t3531_tmp * t1485 / 8.0) +
-              n_t3531_tmp * t1487 / 8.0) +
-             o_t3531_tmp * h_a_tmp / 8.0);
+      ((((((t8 * ((db_t3531_tmp / AccScalar(2.0) + eb_t3531_tmp / AccScalar(2.0)) + fb_t3531_tmp / AccScalar(2.0)) +
+            t10 * (((((gb_t3531_tmp / AccScalar(8.0) + y_t3531_tmp * t100 / AccScalar(4.0)) + hb_t3531_tmp / AccScalar(8.0)) +
+                     ab_t3531_tmp * e_a_tmp / AccScalar(4.0)) +
+                    bb_t3531_tmp * e_a_tmp / AccScalar(4.0)) +
+                   cb_t3531_tmp * e_a_tmp / AccScalar(4.0))) +
+           t41 * ((j_t3531_tmp * t1506 * r10 + k_t3531_tmp * t1516 * r10) + l_t3531_tmp * t2991_tmp * r10)) +
+          -t11 * (((((t766_tmp * c_a_tmp * -AccScalar(0.2) + t763_tmp * e_a_tmp * -AccScalar(0.2)) + c_t3531_tmp * c_a_tmp * r5) +
+                    t858_tmp * c_a_tmp * r5) +
+                   d_t3531_tmp * e_a_tmp * r5) +
+                  t855_tmp * e_a_tmp * r5)) +
+         -t40 * (((((-(e_t3531_tmp * t1485 * r9) - f_t3531_tmp * t1506 * r9) + h_t3531_tmp * t1487 * r9) +
+                   g_t3531_tmp * t1516 * r9) +
+                  b_t3531_tmp * h_a_tmp * r9) +
+                 t3531_tmp * t2991_tmp * r9)) +
+        -t13 * (((((((((((t3531_tmp * g_a_tmp * -AccScalar(0.14285714285714285) + b_t3531_tmp * e_a_tmp * -AccScalar(0.14285714285714285)) -
+                         c_t3531_tmp * t1476 * r7) -
+                        d_t3531_tmp * t1485 * r7) +
+                       t858_tmp * t1478 * r7) +
+                      t855_tmp * t1487 * r7) +
+                     t766_tmp * i_t3531_tmp * r7) +
+                    t763_tmp * h_a_tmp * r7) +
+                   e_t3531_tmp * e_a_tmp * r7) +
+                  f_t3531_tmp * g_a_tmp * r7) +
+                 g_t3531_tmp * g_a_tmp * r7) +
+                h_t3531_tmp * e_a_tmp * r7)) +
+       t12 * (((((((((((t763_tmp * t737 * r6 + d_t3531_tmp * t746 * r6) + t855_tmp * t787 * r6) +
+                      t_t3531_tmp * g_a_tmp * r6) +
+                     p_t3531_tmp * g_a_tmp * r6) +
+                    s_t3531_tmp * g_a_tmp * r6) +
+                   w_t3531_tmp * c_a_tmp * -AccScalar(0.16666666666666666)) +
+                  q_t3531_tmp * c_a_tmp * r6) +
+                 -(u_t3531_tmp * c_a_tmp * r6)) +
+                m_t3531_tmp * e_a_tmp * -AccScalar(0.16666666666666666)) +
+               n_t3531_tmp * e_a_tmp * r6) +
+              -(o_t3531_tmp * e_a_tmp * r6))) +
+      t39 * (((((((((((t3531_tmp * t749 / AccScalar(8.0) + f_t3531_tmp * t756 / AccScalar(8.0)) + g_t3531_tmp * t823 / AccScalar(8.0)) +
+                     j_t3531_tmp * g_a_tmp * -AccScalar(0.125)) +
+                    k_t3531_tmp * g_a_tmp / AccScalar(8.0)) +
+                   -(l_t3531_tmp * g_a_tmp / AccScalar(8.0))) +
+                  x_t3531_tmp * e_a_tmp * -AccScalar(0.125)) +
+                 r_t3531_tmp * e_a_tmp / AccScalar(8.0)) +
+                -(v_t3531_tmp * e_a_tmp / AccScalar(8.0))) +
+               m_t3531_tmp * t1485 / AccScalar(8.0)) +
+              n_t3531_tmp * t1487 / AccScalar(8.0)) +
+             o_t3531_tmp * h_a_tmp / AccScalar(8.0));
   t28 = t21 * t310;
   t29 = t24 * t307;
   t7 = t8 * t24;
   t3510 =
-      (((((t7 * c_a_tmp * -0.5 + t9 * ((t855 + t69 * c_a_tmp * -0.33333333333333331) + t340_tmp * c_a_tmp / 3.0)) +
-          t39 * ((d_t3043_tmp * t1485 / 48.0 + c_t3043_tmp * h_a_tmp / 48.0) + t28 * t1487 / 8.0)) +
-         -t13 * ((((c_t3043_tmp * t737 / 42.0 - d_t3043_tmp * t746 / 42.0) + t28 * t787 / 7.0) - t68 * t1485 / 7.0) +
-                 t318 * h_a_tmp / 7.0)) +
-        -t10 * ((((((-(t340_tmp * t734 / 4.0) - t69 * t743 / 4.0) + t29 * c_a_tmp * -0.25) + n_t3531_tmp / 4.0) +
-                  p_t3531_tmp / 4.0) +
-                 b_t315_tmp * c_a_tmp / 8.0) +
-                t168 * c_a_tmp / 8.0)) +
-       t11 * (((((((g_t3531_tmp / 5.0 + -(t168 * t734 / 10.0)) + b_t315_tmp * t743 / 10.0) + -(t29 * t784 / 5.0)) +
-                 t68 * e_a_tmp * -0.2) +
-                t318 * e_a_tmp / 5.0) +
-               t69 * t1476 / 5.0) +
-              t340_tmp * i_t3531_tmp * -0.2)) +
-      t12 * ((((((((t318 * t737 / 6.0 + t68 * t746 / 6.0) + d_t3043_tmp * e_a_tmp * -0.027777777777777776) +
-                  c_t3043_tmp * e_a_tmp * -0.027777777777777776) +
-                 t28 * e_a_tmp / 6.0) +
-                -(k_t3531_tmp / 6.0)) +
-               b_t315_tmp * t1476 / 12.0) +
-              t168 * i_t3531_tmp / 12.0) +
-             t29 * t1478 / 6.0);
+      (((((t7 * c_a_tmp * -AccScalar(0.5) + t9 * ((t855 + t69 * c_a_tmp * -AccScalar(0.33333333333333331)) + t340_tmp * c_a_tmp * r3)) +
+          t39 * ((d_t3043_tmp * t1485 * r48 + c_t3043_tmp * h_a_tmp * r48) + t28 * t1487 / AccScalar(8.0))) +
+         -t13 * ((((c_t3043_tmp * t737 * r42 - d_t3043_tmp * t746 * r42) + t28 * t787 * r7) - t68 * t1485 * r7) +
+                 t318 * h_a_tmp * r7)) +
+        -t10 * ((((((-(t340_tmp * t734 / AccScalar(4.0)) - t69 * t743 / AccScalar(4.0)) + t29 * c_a_tmp * -AccScalar(0.25)) + n_t3531_tmp / AccScalar(4.0)) +
+                  p_t3531_tmp / AccScalar(4.0)) +
+                 b_t315_tmp * c_a_tmp / AccScalar(8.0)) +
+                t168 * c_a_tmp / AccScalar(8.0))) +
+       t11 * (((((((g_t3531_tmp * r5 + -(t168 * t734 * r10)) + b_t315_tmp * t743 * r10) + -(t29 * t784 * r5)) +
+                 t68 * e_a_tmp * -AccScalar(0.2)) +
+                t318 * e_a_tmp * r5) +
+               t69 * t1476 * r5) +
+              t340_tmp * i_t3531_tmp * -AccScalar(0.2))) +
+      t12 * ((((((((t318 * t737 * r6 + t68 * t746 * r6) + d_t3043_tmp * e_a_tmp * -AccScalar(0.027777777777777776)) +
+                  c_t3043_tmp * e_a_tmp * -AccScalar(0.027777777777777776)) +
+                 t28 * e_a_tmp * r6) +
+                -(k_t3531_tmp * r6)) +
+               b_t315_tmp * t1476 * r12) +
+              t168 * i_t3531_tmp * r12) +
+             t29 * t1478 * r6);
   t4 = t22 * t309;
   t5 = t25 * t306;
-  t3511_tmp = (t3525 / 6.0 - t626_tmp / 6.0) + t311 * t89;
+  t3511_tmp = (t3525 * r6 - t626_tmp * r6) + t311 * t89;
   t2 = t8 * t25;
   b_t3511_tmp = t25 * t786;
   c_t3511_tmp = t22 * t789;
@@ -945,49 +970,49 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   e_t3511_tmp = t22 * t1486;
   f_t3511_tmp = t25 * t1477;
   t3511 =
-      (((((t2 * a_tmp / 2.0 +
-           t9 * ((b_t3511_tmp / 3.0 + t33 * a_tmp * -0.33333333333333331) + t316_tmp * a_tmp / 3.0)) +
-          t39 * ((b_t3043_tmp * t1484 / 48.0 + t3043_tmp * j_a_tmp / 48.0) + t4 * t1486 / 8.0)) +
-         -t13 * ((((t3043_tmp * t736 / 42.0 - b_t3043_tmp * t745 / 42.0) + t4 * t789 / 7.0) - t32 * t1484 / 7.0) +
-                 t88 * j_a_tmp / 7.0)) +
-        t10 * ((((((t33 * t733 / 4.0 + t316_tmp * t742 / 4.0) + t5 * a_tmp * -0.25) - f_t3511_tmp / 4.0) +
-                 d_t3511_tmp / 4.0) +
-                t27 * a_tmp / 8.0) +
-               t90 * a_tmp / 8.0)) +
-       t11 * (((((((c_t3511_tmp / 5.0 + -(t27 * t733 / 10.0)) + t90 * t742 / 10.0) + -(t5 * t786 / 5.0)) +
-                 t88 * d_a_tmp * -0.2) +
-                t32 * d_a_tmp / 5.0) +
-               t316_tmp * t1475 / 5.0) +
-              t33 * t3511_tmp * -0.2)) +
-      t12 * ((((((((t88 * t736 / 6.0 + t32 * t745 / 6.0) + t3043_tmp * d_a_tmp / 36.0) + b_t3043_tmp * d_a_tmp / 36.0) +
-                 t4 * d_a_tmp * -0.16666666666666666) +
-                -(e_t3511_tmp / 6.0)) +
-               t90 * t1475 / 12.0) +
-              t27 * t3511_tmp / 12.0) +
-             t5 * t1477 / 6.0);
+      (((((t2 * a_tmp / AccScalar(2.0) +
+           t9 * ((b_t3511_tmp * r3 + t33 * a_tmp * -AccScalar(0.33333333333333331)) + t316_tmp * a_tmp * r3)) +
+          t39 * ((b_t3043_tmp * t1484 * r48 + t3043_tmp * j_a_tmp * r48) + t4 * t1486 / AccScalar(8.0))) +
+         -t13 * ((((t3043_tmp * t736 * r42 - b_t3043_tmp * t745 * r42) + t4 * t789 * r7) - t32 * t1484 * r7) +
+                 t88 * j_a_tmp * r7)) +
+        t10 * ((((((t33 * t733 / AccScalar(4.0) + t316_tmp * t742 / AccScalar(4.0)) + t5 * a_tmp * -AccScalar(0.25)) - f_t3511_tmp / AccScalar(4.0)) +
+                 d_t3511_tmp / AccScalar(4.0)) +
+                t27 * a_tmp / AccScalar(8.0)) +
+               t90 * a_tmp / AccScalar(8.0))) +
+       t11 * (((((((c_t3511_tmp * r5 + -(t27 * t733 * r10)) + t90 * t742 * r10) + -(t5 * t786 * r5)) +
+                 t88 * d_a_tmp * -AccScalar(0.2)) +
+                t32 * d_a_tmp * r5) +
+               t316_tmp * t1475 * r5) +
+              t33 * t3511_tmp * -AccScalar(0.2))) +
+      t12 * ((((((((t88 * t736 * r6 + t32 * t745 * r6) + t3043_tmp * d_a_tmp * r36) + b_t3043_tmp * d_a_tmp * r36) +
+                 t4 * d_a_tmp * -AccScalar(0.16666666666666666)) +
+                -(e_t3511_tmp * r6)) +
+               t90 * t1475 * r12) +
+              t27 * t3511_tmp * r12) +
+             t5 * t1477 * r6);
   t26 = t9 * t24;
   t3519_tmp = t21 * g_a_tmp;
   t3519 =
-      (((((t26 * e_a_tmp * -0.33333333333333331 + t10 * ((t858 + t69 * e_a_tmp * -0.25) + t340_tmp * e_a_tmp / 4.0)) +
-          t40 * ((d_t3043_tmp * t1506 / 54.0 + c_t3043_tmp * t2991_tmp / 54.0) + t28 * t1516 / 9.0)) +
-         -t39 * ((((c_t3043_tmp * t749 / 48.0 - d_t3043_tmp * t756 / 48.0) + t28 * t823 / 8.0) - t68 * t1506 / 8.0) +
-                 t318 * t2991_tmp / 8.0)) +
-        -t11 * ((((((-(t340_tmp * t737 / 5.0) - t69 * t746 / 5.0) + t29 * e_a_tmp * -0.2) + q_t3531_tmp / 5.0) +
-                  t3519_tmp / 5.0) +
-                 b_t315_tmp * e_a_tmp / 10.0) +
-                t168 * e_a_tmp / 10.0)) +
-       -t12 * (((((((t168 * t737 / 12.0 - h_t3531_tmp / 6.0) - b_t315_tmp * t746 / 12.0) + t29 * t787 / 6.0) +
-                  t318 * g_a_tmp * -0.16666666666666666) -
-                 t69 * t1485 / 6.0) +
-                t340_tmp * h_a_tmp / 6.0) +
-               t68 * g_a_tmp / 6.0)) +
-      t13 * ((((((((t318 * t749 / 7.0 + t68 * t756 / 7.0) + d_t3043_tmp * g_a_tmp * -0.023809523809523808) +
-                  c_t3043_tmp * g_a_tmp * -0.023809523809523808) +
-                 t28 * g_a_tmp / 7.0) +
-                -(r_t3531_tmp / 7.0)) +
-               b_t315_tmp * t1485 / 14.0) +
-              t168 * h_a_tmp / 14.0) +
-             t29 * t1487 / 7.0);
+      (((((t26 * e_a_tmp * -AccScalar(0.33333333333333331) + t10 * ((t858 + t69 * e_a_tmp * -AccScalar(0.25)) + t340_tmp * e_a_tmp / AccScalar(4.0))) +
+          t40 * ((d_t3043_tmp * t1506 * r54 + c_t3043_tmp * t2991_tmp * r54) + t28 * t1516 * r9)) +
+         -t39 * ((((c_t3043_tmp * t749 * r48 - d_t3043_tmp * t756 * r48) + t28 * t823 / AccScalar(8.0)) - t68 * t1506 / AccScalar(8.0)) +
+                 t318 * t2991_tmp / AccScalar(8.0))) +
+        -t11 * ((((((-(t340_tmp * t737 * r5) - t69 * t746 * r5) + t29 * e_a_tmp * -AccScalar(0.2)) + q_t3531_tmp * r5) +
+                  t3519_tmp * r5) +
+                 b_t315_tmp * e_a_tmp * r10) +
+                t168 * e_a_tmp * r10)) +
+       -t12 * (((((((t168 * t737 * r12 - h_t3531_tmp * r6) - b_t315_tmp * t746 * r12) + t29 * t787 * r6) +
+                  t318 * g_a_tmp * -AccScalar(0.16666666666666666)) -
+                 t69 * t1485 * r6) +
+                t340_tmp * h_a_tmp * r6) +
+               t68 * g_a_tmp * r6)) +
+      t13 * ((((((((t318 * t749 * r7 + t68 * t756 * r7) + d_t3043_tmp * g_a_tmp * -AccScalar(0.023809523809523808)) +
+                  c_t3043_tmp * g_a_tmp * -AccScalar(0.023809523809523808)) +
+                 t28 * g_a_tmp * r7) +
+                -(r_t3531_tmp * r7)) +
+               b_t315_tmp * t1485 * r14) +
+              t168 * h_a_tmp * r14) +
+             t29 * t1487 * r7);
   t6 = t9 * t25;
   t3520_tmp = t25 * t789;
   b_t3520_tmp = t22 * t825;
@@ -995,365 +1020,365 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   d_t3520_tmp = t22 * t1515;
   e_t3520_tmp = t22 * f_a_tmp;
   t3520 =
-      (((((t6 * d_a_tmp / 3.0 + t10 * ((t3520_tmp / 4.0 + t33 * d_a_tmp * -0.25) + t316_tmp * d_a_tmp / 4.0)) +
-          t40 * ((b_t3043_tmp * t1505 / 54.0 + t3043_tmp * t2989_tmp / 54.0) + t4 * t1515 / 9.0)) +
-         -t39 * ((((t3043_tmp * t748 / 48.0 - b_t3043_tmp * t755 / 48.0) + t4 * t825 / 8.0) - t32 * t1505 / 8.0) +
-                 t88 * t2989_tmp / 8.0)) +
-        t11 * ((((((t33 * t736 / 5.0 + t316_tmp * t745 / 5.0) + t5 * d_a_tmp * -0.2) - c_t3520_tmp / 5.0) +
-                 e_t3520_tmp / 5.0) +
-                t27 * d_a_tmp / 10.0) +
-               t90 * d_a_tmp / 10.0)) +
-       -t12 * (((((((t27 * t736 / 12.0 - b_t3520_tmp / 6.0) - t90 * t745 / 12.0) + t5 * t789 / 6.0) +
-                  t32 * f_a_tmp * -0.16666666666666666) -
-                 t316_tmp * t1484 / 6.0) +
-                t33 * j_a_tmp / 6.0) +
-               t88 * f_a_tmp / 6.0)) +
-      t13 * ((((((((t88 * t748 / 7.0 + t32 * t755 / 7.0) + t3043_tmp * f_a_tmp / 42.0) + b_t3043_tmp * f_a_tmp / 42.0) +
-                 t4 * f_a_tmp * -0.14285714285714285) +
-                -(d_t3520_tmp / 7.0)) +
-               t90 * t1484 / 14.0) +
-              t27 * j_a_tmp / 14.0) +
-             t5 * t1486 / 7.0);
+      (((((t6 * d_a_tmp * r3 + t10 * ((t3520_tmp / AccScalar(4.0) + t33 * d_a_tmp * -AccScalar(0.25)) + t316_tmp * d_a_tmp / AccScalar(4.0))) +
+          t40 * ((b_t3043_tmp * t1505 * r54 + t3043_tmp * t2989_tmp * r54) + t4 * t1515 * r9)) +
+         -t39 * ((((t3043_tmp * t748 * r48 - b_t3043_tmp * t755 * r48) + t4 * t825 / AccScalar(8.0)) - t32 * t1505 / AccScalar(8.0)) +
+                 t88 * t2989_tmp / AccScalar(8.0))) +
+        t11 * ((((((t33 * t736 * r5 + t316_tmp * t745 * r5) + t5 * d_a_tmp * -AccScalar(0.2)) - c_t3520_tmp * r5) +
+                 e_t3520_tmp * r5) +
+                t27 * d_a_tmp * r10) +
+               t90 * d_a_tmp * r10)) +
+       -t12 * (((((((t27 * t736 * r12 - b_t3520_tmp * r6) - t90 * t745 * r12) + t5 * t789 * r6) +
+                  t32 * f_a_tmp * -AccScalar(0.16666666666666666)) -
+                 t316_tmp * t1484 * r6) +
+                t33 * j_a_tmp * r6) +
+               t88 * f_a_tmp * r6)) +
+      t13 * ((((((((t88 * t748 * r7 + t32 * t755 * r7) + t3043_tmp * f_a_tmp * r42) + b_t3043_tmp * f_a_tmp * r42) +
+                 t4 * f_a_tmp * -AccScalar(0.14285714285714285)) +
+                -(d_t3520_tmp * r7)) +
+               t90 * t1484 * r14) +
+              t27 * j_a_tmp * r14) +
+             t5 * t1486 * r7);
   t30 = t20 * t311;
   t35 = t23 * t308;
-  t3512_tmp = (t552_tmp / 6.0 - t627_tmp / 6.0) + t310 * t67;
+  t3512_tmp = (t552_tmp * r6 - t627_tmp * r6) + t310 * t67;
   t3 = t8 * t23;
   t342 = t20 * t1488;
   b_t3512_tmp = t20 * t788;
   t343 = t23 * t1479;
-  t3512 = (((((-(t3 * t892 / 2.0) + t9 * ((t854 + t322 * t892 / 3.0) + -(t166 * t892 / 3.0))) +
-              t39 * ((b_t3044_tmp * t1483 / 48.0 + t3044_tmp * i_a_tmp / 48.0) + t30 * t1488 / 8.0)) +
-             -t13 * ((((t3044_tmp * t738 / 42.0 - b_t3044_tmp * t747 / 42.0) + t30 * t788 / 7.0) - t31 * t1483 / 7.0) +
-                     t319 * i_a_tmp / 7.0)) +
-            -(t10 * ((((((-(t322 * t735 / 4.0) + -(t166 * t744 / 4.0)) + b_t316_tmp * t892 / 8.0) + t34 * t892 / 8.0) +
-                       t20 * a_tmp_tmp / 4.0) +
-                      -(t35 * t892 / 4.0)) +
-                     t343 / 4.0))) +
-           t11 * (((((((b_t3512_tmp / 5.0 + -(b_t316_tmp * t735 / 10.0)) + t34 * t744 / 10.0) + -(t35 * t785 / 5.0)) +
-                     t319 * a_tmp_tmp / 5.0) +
-                    -(t31 * a_tmp_tmp / 5.0)) +
-                   t166 * t1474 / 5.0) +
-                  t322 * t3512_tmp * -0.2)) +
-          t12 * ((((((((t319 * t738 / 6.0 + t31 * t747 / 6.0) + -(t3044_tmp * a_tmp_tmp / 36.0)) +
-                      -(b_t3044_tmp * a_tmp_tmp / 36.0)) +
-                     t30 * a_tmp_tmp / 6.0) +
-                    -(t342 / 6.0)) +
-                   t34 * t1474 / 12.0) +
-                  b_t316_tmp * t3512_tmp / 12.0) +
-                 t35 * t1479 / 6.0);
+  t3512 = (((((-(t3 * t892 / AccScalar(2.0)) + t9 * ((t854 + t322 * t892 * r3) + -(t166 * t892 * r3))) +
+              t39 * ((b_t3044_tmp * t1483 * r48 + t3044_tmp * i_a_tmp * r48) + t30 * t1488 / AccScalar(8.0))) +
+             -t13 * ((((t3044_tmp * t738 * r42 - b_t3044_tmp * t747 * r42) + t30 * t788 * r7) - t31 * t1483 * r7) +
+                     t319 * i_a_tmp * r7)) +
+            -(t10 * ((((((-(t322 * t735 / AccScalar(4.0)) + -(t166 * t744 / AccScalar(4.0))) + b_t316_tmp * t892 / AccScalar(8.0)) + t34 * t892 / AccScalar(8.0)) +
+                       t20 * a_tmp_tmp / AccScalar(4.0)) +
+                      -(t35 * t892 / AccScalar(4.0))) +
+                     t343 / AccScalar(4.0)))) +
+           t11 * (((((((b_t3512_tmp * r5 + -(b_t316_tmp * t735 * r10)) + t34 * t744 * r10) + -(t35 * t785 * r5)) +
+                     t319 * a_tmp_tmp * r5) +
+                    -(t31 * a_tmp_tmp * r5)) +
+                   t166 * t1474 * r5) +
+                  t322 * t3512_tmp * -AccScalar(0.2))) +
+          t12 * ((((((((t319 * t738 * r6 + t31 * t747 * r6) + -(t3044_tmp * a_tmp_tmp * r36)) +
+                      -(b_t3044_tmp * a_tmp_tmp * r36)) +
+                     t30 * a_tmp_tmp * r6) +
+                    -(t342 * r6)) +
+                   t34 * t1474 * r12) +
+                  b_t316_tmp * t3512_tmp * r12) +
+                 t35 * t1479 * r6);
   t3513 =
-      (((((t2 * c_a_tmp * -0.5 + -(t9 * ((t763 + t33 * c_a_tmp * -0.33333333333333331) + t316_tmp * c_a_tmp / 3.0))) +
-          -t39 * ((-(t3043_tmp * t1485 / 48.0) + b_t3043_tmp * t1487 / 48.0) + t4 * h_a_tmp / 8.0)) +
-         t13 * ((((t3043_tmp * t746 / 42.0 + b_t3043_tmp * t787 / 42.0) + t4 * t737 / 7.0) + -(t88 * t1485 / 7.0)) +
-                -(t32 * t1487 / 7.0))) +
-        -t10 * ((((((t33 * t743 / 4.0 - t316_tmp * t784 / 4.0) + t5 * c_a_tmp * -0.25) + o_t3531_tmp * -0.25) +
-                  s_t3531_tmp / 4.0) +
-                 t27 * c_a_tmp / 8.0) +
-                t90 * c_a_tmp / 8.0)) +
-       -(t11 * (((((((t3531_tmp / 5.0 + -(t27 * t743 / 10.0)) + -(t90 * t784 / 10.0)) + -(t5 * t734 / 5.0)) +
-                   t88 * e_a_tmp * -0.2) +
-                  t32 * e_a_tmp / 5.0) +
-                 t33 * t1476 / 5.0) +
-                t316_tmp * t1478 / 5.0))) +
-      -t12 * ((((((((t88 * t746 / 6.0 - t32 * t787 / 6.0) + t4 * e_a_tmp * -0.16666666666666666) +
-                   l_t3531_tmp * -0.16666666666666666) -
-                  t27 * t1476 / 12.0) +
-                 t90 * t1478 / 12.0) +
-                t5 * i_t3531_tmp / 6.0) +
-               t3043_tmp * e_a_tmp / 36.0) +
-              b_t3043_tmp * e_a_tmp / 36.0);
+      (((((t2 * c_a_tmp * -AccScalar(0.5) + -(t9 * ((t763 + t33 * c_a_tmp * -AccScalar(0.33333333333333331)) + t316_tmp * c_a_tmp * r3))) +
+          -t39 * ((-(t3043_tmp * t1485 * r48) + b_t3043_tmp * t1487 * r48) + t4 * h_a_tmp / AccScalar(8.0))) +
+         t13 * ((((t3043_tmp * t746 * r42 + b_t3043_tmp * t787 * r42) + t4 * t737 * r7) + -(t88 * t1485 * r7)) +
+                -(t32 * t1487 * r7))) +
+        -t10 * ((((((t33 * t743 / AccScalar(4.0) - t316_tmp * t784 / AccScalar(4.0)) + t5 * c_a_tmp * -AccScalar(0.25)) + o_t3531_tmp * -AccScalar(0.25)) +
+                  s_t3531_tmp / AccScalar(4.0)) +
+                 t27 * c_a_tmp / AccScalar(8.0)) +
+                t90 * c_a_tmp / AccScalar(8.0))) +
+       -(t11 * (((((((t3531_tmp * r5 + -(t27 * t743 * r10)) + -(t90 * t784 * r10)) + -(t5 * t734 * r5)) +
+                   t88 * e_a_tmp * -AccScalar(0.2)) +
+                  t32 * e_a_tmp * r5) +
+                 t33 * t1476 * r5) +
+                t316_tmp * t1478 * r5))) +
+      -t12 * ((((((((t88 * t746 * r6 - t32 * t787 * r6) + t4 * e_a_tmp * -AccScalar(0.16666666666666666)) +
+                   l_t3531_tmp * -AccScalar(0.16666666666666666)) -
+                  t27 * t1476 * r12) +
+                 t90 * t1478 * r12) +
+                t5 * i_t3531_tmp * r6) +
+               t3043_tmp * e_a_tmp * r36) +
+              b_t3043_tmp * e_a_tmp * r36);
   t3514 =
-      (((((t3 * c_a_tmp * -0.5 +
-           t9 * ((d_t3531_tmp / 3.0 + t166 * c_a_tmp * -0.33333333333333331) + t322 * c_a_tmp / 3.0)) +
-          -(t39 * ((t3044_tmp * t1487 / 48.0 + b_t3044_tmp * h_a_tmp * -0.020833333333333332) + t30 * t1485 / 8.0))) +
-         t13 * ((((-(b_t3044_tmp * t737 / 42.0) + t3044_tmp * t787 / 42.0) - t30 * t746 / 7.0) + t319 * t1487 / 7.0) +
-                t31 * h_a_tmp / 7.0)) +
-        -t10 * ((((((t166 * t734 / 4.0 + t322 * t784 / 4.0) + t35 * c_a_tmp * -0.25) - m_t3531_tmp / 4.0) +
-                  t_t3531_tmp / 4.0) +
-                 b_t316_tmp * c_a_tmp / 8.0) +
-                t34 * c_a_tmp / 8.0)) +
-       t11 * (((((((f_t3531_tmp / 5.0 + -(t34 * t734 / 10.0)) + b_t316_tmp * t784 / 10.0) + -(t35 * t743 / 5.0)) +
-                 t31 * e_a_tmp * -0.2) +
-                t319 * e_a_tmp / 5.0) +
-               t322 * t1478 / 5.0) +
-              t166 * i_t3531_tmp / 5.0)) +
+      (((((t3 * c_a_tmp * -AccScalar(0.5) +
+           t9 * ((d_t3531_tmp * r3 + t166 * c_a_tmp * -AccScalar(0.33333333333333331)) + t322 * c_a_tmp * r3)) +
+          -(t39 * ((t3044_tmp * t1487 * r48 + b_t3044_tmp * h_a_tmp * -AccScalar(0.020833333333333332)) + t30 * t1485 / AccScalar(8.0)))) +
+         t13 * ((((-(b_t3044_tmp * t737 * r42) + t3044_tmp * t787 * r42) - t30 * t746 * r7) + t319 * t1487 * r7) +
+                t31 * h_a_tmp * r7)) +
+        -t10 * ((((((t166 * t734 / AccScalar(4.0) + t322 * t784 / AccScalar(4.0)) + t35 * c_a_tmp * -AccScalar(0.25)) - m_t3531_tmp / AccScalar(4.0)) +
+                  t_t3531_tmp / AccScalar(4.0)) +
+                 b_t316_tmp * c_a_tmp / AccScalar(8.0)) +
+                t34 * c_a_tmp / AccScalar(8.0))) +
+       t11 * (((((((f_t3531_tmp * r5 + -(t34 * t734 * r10)) + b_t316_tmp * t784 * r10) + -(t35 * t743 * r5)) +
+                 t31 * e_a_tmp * -AccScalar(0.2)) +
+                t319 * e_a_tmp * r5) +
+               t322 * t1478 * r5) +
+              t166 * i_t3531_tmp * r5)) +
       -(t12 *
-        ((((((((t31 * t737 / 6.0 + t319 * t787 / 6.0) + t3044_tmp * e_a_tmp / 36.0) + b_t3044_tmp * e_a_tmp / 36.0) +
-             t30 * e_a_tmp * -0.16666666666666666) +
-            -(j_t3531_tmp / 6.0)) +
-           b_t316_tmp * t1478 / 12.0) +
-          t34 * i_t3531_tmp * -0.083333333333333329) +
-         t35 * t1476 / 6.0));
+        ((((((((t31 * t737 * r6 + t319 * t787 * r6) + t3044_tmp * e_a_tmp * r36) + b_t3044_tmp * e_a_tmp * r36) +
+             t30 * e_a_tmp * -AccScalar(0.16666666666666666)) +
+            -(j_t3531_tmp * r6)) +
+           b_t316_tmp * t1478 * r12) +
+          t34 * i_t3531_tmp * -AccScalar(0.083333333333333329)) +
+         t35 * t1476 * r6));
   t364 = t22 * t1483;
   t3515_tmp = t25 * t744;
   b_t3515_tmp = t22 * t747;
   t363 = t25 * t1474;
   t3515 =
-      (((((-(t2 * t892 / 2.0) + t9 * ((t3515_tmp / 3.0 + t33 * t892 / 3.0) + -(t316_tmp * t892 / 3.0))) +
-          -(t39 * ((t3043_tmp * t1488 / 48.0 + b_t3043_tmp * i_a_tmp * -0.020833333333333332) + t4 * t1483 / 8.0))) +
-         t13 * ((((-(b_t3043_tmp * t738 / 42.0) + t3043_tmp * t788 / 42.0) - t4 * t747 / 7.0) + t88 * t1488 / 7.0) +
-                t32 * i_a_tmp / 7.0)) +
-        -(t10 * ((((((t316_tmp * t735 / 4.0 + t33 * t785 / 4.0) + t27 * t892 / 8.0) + t90 * t892 / 8.0) +
-                   t22 * a_tmp_tmp / 4.0) +
-                  -(t5 * t892 / 4.0)) +
-                 -(t363 / 4.0)))) +
-       t11 * (((((((b_t3515_tmp / 5.0 + -(t90 * t735 / 10.0)) + t27 * t785 / 10.0) + -(t5 * t744 / 5.0)) +
-                 t88 * a_tmp_tmp / 5.0) +
-                -(t32 * a_tmp_tmp / 5.0)) +
-               t33 * t1479 / 5.0) +
-              t316_tmp * t3512_tmp / 5.0)) +
+      (((((-(t2 * t892 / AccScalar(2.0)) + t9 * ((t3515_tmp * r3 + t33 * t892 * r3) + -(t316_tmp * t892 * r3))) +
+          -(t39 * ((t3043_tmp * t1488 * r48 + b_t3043_tmp * i_a_tmp * -AccScalar(0.020833333333333332)) + t4 * t1483 / AccScalar(8.0)))) +
+         t13 * ((((-(b_t3043_tmp * t738 * r42) + t3043_tmp * t788 * r42) - t4 * t747 * r7) + t88 * t1488 * r7) +
+                t32 * i_a_tmp * r7)) +
+        -(t10 * ((((((t316_tmp * t735 / AccScalar(4.0) + t33 * t785 / AccScalar(4.0)) + t27 * t892 / AccScalar(8.0)) + t90 * t892 / AccScalar(8.0)) +
+                   t22 * a_tmp_tmp / AccScalar(4.0)) +
+                  -(t5 * t892 / AccScalar(4.0))) +
+                 -(t363 / AccScalar(4.0))))) +
+       t11 * (((((((b_t3515_tmp * r5 + -(t90 * t735 * r10)) + t27 * t785 * r10) + -(t5 * t744 * r5)) +
+                 t88 * a_tmp_tmp * r5) +
+                -(t32 * a_tmp_tmp * r5)) +
+               t33 * t1479 * r5) +
+              t316_tmp * t3512_tmp * r5)) +
       -(t12 *
-        ((((((((t32 * t738 / 6.0 + t88 * t788 / 6.0) + t3043_tmp * a_tmp_tmp / 36.0) + b_t3043_tmp * a_tmp_tmp / 36.0) +
-             -(t4 * a_tmp_tmp / 6.0)) +
-            -(t364 / 6.0)) +
-           t27 * t1479 / 12.0) +
-          t90 * t3512_tmp * -0.083333333333333329) +
-         t5 * t1474 / 6.0));
+        ((((((((t32 * t738 * r6 + t88 * t788 * r6) + t3043_tmp * a_tmp_tmp * r36) + b_t3043_tmp * a_tmp_tmp * r36) +
+             -(t4 * a_tmp_tmp * r6)) +
+            -(t364 * r6)) +
+           t27 * t1479 * r12) +
+          t90 * t3512_tmp * -AccScalar(0.083333333333333329)) +
+         t5 * t1474 * r6));
   t630_tmp = t21 * t1484;
   t3516_tmp = t21 * t745;
   b_a_tmp = t21 * d_a_tmp;
   t70 = t24 * t1475;
   t3516 =
-      (((((t7 * a_tmp / 2.0 + t9 * ((t776 + t340_tmp * a_tmp * -0.33333333333333331) + t69 * a_tmp / 3.0)) +
-          -(t39 * ((d_t3043_tmp * j_a_tmp * -0.020833333333333332 + c_t3043_tmp * t1486 / 48.0) + t28 * t1484 / 8.0))) +
-         t13 * ((((-(d_t3043_tmp * t736 / 42.0) + c_t3043_tmp * t789 / 42.0) - t28 * t745 / 7.0) + t318 * t1486 / 7.0) +
-                t68 * j_a_tmp / 7.0)) +
-        t10 * ((((((-(t69 * t733 / 4.0) - t340_tmp * t786 / 4.0) + t29 * a_tmp * -0.25) + t70 / 4.0) + b_a_tmp / 4.0) +
-                b_t315_tmp * a_tmp / 8.0) +
-               t168 * a_tmp / 8.0)) +
-       t11 * (((((((t3516_tmp / 5.0 + -(b_t315_tmp * t733 / 10.0)) + t168 * t786 / 10.0) + -(t29 * t742 / 5.0)) +
-                 t318 * d_a_tmp * -0.2) +
-                t68 * d_a_tmp / 5.0) +
-               t340_tmp * t1477 / 5.0) +
-              t69 * t3511_tmp / 5.0)) +
-      -(t12 * ((((((((t68 * t736 / 6.0 + t318 * t789 / 6.0) + d_t3043_tmp * d_a_tmp * -0.027777777777777776) +
-                    c_t3043_tmp * d_a_tmp * -0.027777777777777776) +
-                   t28 * d_a_tmp / 6.0) +
-                  -(t630_tmp / 6.0)) +
-                 b_t315_tmp * t3511_tmp * -0.083333333333333329) +
-                t168 * t1477 / 12.0) +
-               t29 * t1475 / 6.0));
+      (((((t7 * a_tmp / AccScalar(2.0) + t9 * ((t776 + t340_tmp * a_tmp * -AccScalar(0.33333333333333331)) + t69 * a_tmp * r3)) +
+          -(t39 * ((d_t3043_tmp * j_a_tmp * -AccScalar(0.020833333333333332) + c_t3043_tmp * t1486 * r48) + t28 * t1484 / AccScalar(8.0)))) +
+         t13 * ((((-(d_t3043_tmp * t736 * r42) + c_t3043_tmp * t789 * r42) - t28 * t745 * r7) + t318 * t1486 * r7) +
+                t68 * j_a_tmp * r7)) +
+        t10 * ((((((-(t69 * t733 / AccScalar(4.0)) - t340_tmp * t786 / AccScalar(4.0)) + t29 * a_tmp * -AccScalar(0.25)) + t70 / AccScalar(4.0)) + b_a_tmp / AccScalar(4.0)) +
+                b_t315_tmp * a_tmp / AccScalar(8.0)) +
+               t168 * a_tmp / AccScalar(8.0))) +
+       t11 * (((((((t3516_tmp * r5 + -(b_t315_tmp * t733 * r10)) + t168 * t786 * r10) + -(t29 * t742 * r5)) +
+                 t318 * d_a_tmp * -AccScalar(0.2)) +
+                t68 * d_a_tmp * r5) +
+               t340_tmp * t1477 * r5) +
+              t69 * t3511_tmp * r5)) +
+      -(t12 * ((((((((t68 * t736 * r6 + t318 * t789 * r6) + d_t3043_tmp * d_a_tmp * -AccScalar(0.027777777777777776)) +
+                    c_t3043_tmp * d_a_tmp * -AccScalar(0.027777777777777776)) +
+                   t28 * d_a_tmp * r6) +
+                  -(t630_tmp * r6)) +
+                 b_t315_tmp * t3511_tmp * -AccScalar(0.083333333333333329)) +
+                t168 * t1477 * r12) +
+               t29 * t1475 * r6));
   t3517_tmp = t21 * t738;
   t153 = t21 * i_a_tmp;
   t151 = t24 * t3512_tmp;
   t3517 =
-      (((((-(t7 * t892 / 2.0) + -(t9 * ((t762 + t69 * t892 / 3.0) + -(t340_tmp * t892 / 3.0)))) +
-          -t39 * ((-(c_t3043_tmp * t1483 / 48.0) + d_t3043_tmp * t1488 / 48.0) + t28 * i_a_tmp / 8.0)) +
-         t13 * ((((c_t3043_tmp * t747 / 42.0 + d_t3043_tmp * t788 / 42.0) + t28 * t738 / 7.0) + -(t318 * t1483 / 7.0)) +
-                -(t68 * t1488 / 7.0))) +
-        -(t10 * ((((((t340_tmp * t744 / 4.0 + -(t69 * t785 / 4.0)) + b_t315_tmp * t892 / 8.0) + t168 * t892 / 8.0) +
-                   t21 * a_tmp_tmp / 4.0) +
-                  -(t29 * t892 / 4.0)) +
-                 t151 * -0.25))) +
-       -(t11 * (((((((t3517_tmp / 5.0 + -(t168 * t744 / 10.0)) + -(b_t315_tmp * t785 / 10.0)) + -(t29 * t735 / 5.0)) +
-                   t68 * a_tmp_tmp / 5.0) +
-                  -(t318 * a_tmp_tmp / 5.0)) +
-                 t340_tmp * t1474 / 5.0) +
-                t69 * t1479 / 5.0))) +
-      -(t12 * ((((((((t318 * t747 / 6.0 + -(t68 * t788 / 6.0)) + d_t3043_tmp * a_tmp_tmp / 36.0) +
-                    c_t3043_tmp * a_tmp_tmp / 36.0) +
-                   -(t28 * a_tmp_tmp / 6.0)) +
-                  t153 * -0.16666666666666666) +
-                 b_t315_tmp * t1479 / 12.0) +
-                -(t168 * t1474 / 12.0)) +
-               t29 * t3512_tmp / 6.0));
+      (((((-(t7 * t892 / AccScalar(2.0)) + -(t9 * ((t762 + t69 * t892 * r3) + -(t340_tmp * t892 * r3)))) +
+          -t39 * ((-(c_t3043_tmp * t1483 * r48) + d_t3043_tmp * t1488 * r48) + t28 * i_a_tmp / AccScalar(8.0))) +
+         t13 * ((((c_t3043_tmp * t747 * r42 + d_t3043_tmp * t788 * r42) + t28 * t738 * r7) + -(t318 * t1483 * r7)) +
+                -(t68 * t1488 * r7))) +
+        -(t10 * ((((((t340_tmp * t744 / AccScalar(4.0) + -(t69 * t785 / AccScalar(4.0))) + b_t315_tmp * t892 / AccScalar(8.0)) + t168 * t892 / AccScalar(8.0)) +
+                   t21 * a_tmp_tmp / AccScalar(4.0)) +
+                  -(t29 * t892 / AccScalar(4.0))) +
+                 t151 * -AccScalar(0.25)))) +
+       -(t11 * (((((((t3517_tmp * r5 + -(t168 * t744 * r10)) + -(b_t315_tmp * t785 * r10)) + -(t29 * t735 * r5)) +
+                   t68 * a_tmp_tmp * r5) +
+                  -(t318 * a_tmp_tmp * r5)) +
+                 t340_tmp * t1474 * r5) +
+                t69 * t1479 * r5))) +
+      -(t12 * ((((((((t318 * t747 * r6 + -(t68 * t788 * r6)) + d_t3043_tmp * a_tmp_tmp * r36) +
+                    c_t3043_tmp * a_tmp_tmp * r36) +
+                   -(t28 * a_tmp_tmp * r6)) +
+                  t153 * -AccScalar(0.16666666666666666)) +
+                 b_t315_tmp * t1479 * r12) +
+                -(t168 * t1474 * r12)) +
+               t29 * t3512_tmp * r6));
   t3518_tmp = t23 * t733;
   b_t3518_tmp = t20 * t736;
   t539_tmp = t20 * d_a_tmp;
   b_t340_tmp = t20 * j_a_tmp;
   t555_tmp = t23 * t3511_tmp;
   t3518 =
-      (((((t3 * a_tmp / 2.0 + -(t9 * ((t3518_tmp / 3.0 + t166 * a_tmp * -0.33333333333333331) + t322 * a_tmp / 3.0))) +
-          -t39 * ((-(t3044_tmp * t1484 / 48.0) + b_t3044_tmp * t1486 / 48.0) + t30 * j_a_tmp / 8.0)) +
-         t13 * ((((t3044_tmp * t745 / 42.0 + b_t3044_tmp * t789 / 42.0) + t30 * t736 / 7.0) + -(t319 * t1484 / 7.0)) +
-                -(t31 * t1486 / 7.0))) +
+      (((((t3 * a_tmp / AccScalar(2.0) + -(t9 * ((t3518_tmp * r3 + t166 * a_tmp * -AccScalar(0.33333333333333331)) + t322 * a_tmp * r3))) +
+          -t39 * ((-(t3044_tmp * t1484 * r48) + b_t3044_tmp * t1486 * r48) + t30 * j_a_tmp / AccScalar(8.0))) +
+         t13 * ((((t3044_tmp * t745 * r42 + b_t3044_tmp * t789 * r42) + t30 * t736 * r7) + -(t319 * t1484 * r7)) +
+                -(t31 * t1486 * r7))) +
         t10 *
-            ((((((-(t322 * t742 / 4.0) + t166 * t786 / 4.0) + t35 * a_tmp * -0.25) + t539_tmp / 4.0) + t555_tmp / 4.0) +
-              b_t316_tmp * a_tmp / 8.0) +
-             t34 * a_tmp / 8.0)) +
-       -(t11 * (((((((b_t3518_tmp / 5.0 + -(b_t316_tmp * t742 / 10.0)) + -(t34 * t786 / 10.0)) + -(t35 * t733 / 5.0)) +
-                   t31 * d_a_tmp * -0.2) +
-                  t319 * d_a_tmp / 5.0) +
-                 t322 * t1475 / 5.0) +
-                t166 * t1477 / 5.0))) +
-      t12 * ((((((((-(t319 * t745 / 6.0) + t31 * t789 / 6.0) + t30 * d_a_tmp * -0.16666666666666666) +
-                  b_t316_tmp * t1475 / 12.0) -
-                 t34 * t1477 / 12.0) +
-                t35 * t3511_tmp * -0.16666666666666666) +
-               b_t340_tmp / 6.0) +
-              t3044_tmp * d_a_tmp / 36.0) +
-             b_t3044_tmp * d_a_tmp / 36.0);
+            ((((((-(t322 * t742 / AccScalar(4.0)) + t166 * t786 / AccScalar(4.0)) + t35 * a_tmp * -AccScalar(0.25)) + t539_tmp / AccScalar(4.0)) + t555_tmp / AccScalar(4.0)) +
+              b_t316_tmp * a_tmp / AccScalar(8.0)) +
+             t34 * a_tmp / AccScalar(8.0))) +
+       -(t11 * (((((((b_t3518_tmp * r5 + -(b_t316_tmp * t742 * r10)) + -(t34 * t786 * r10)) + -(t35 * t733 * r5)) +
+                   t31 * d_a_tmp * -AccScalar(0.2)) +
+                  t319 * d_a_tmp * r5) +
+                 t322 * t1475 * r5) +
+                t166 * t1477 * r5))) +
+      t12 * ((((((((-(t319 * t745 * r6) + t31 * t789 * r6) + t30 * d_a_tmp * -AccScalar(0.16666666666666666)) +
+                  b_t316_tmp * t1475 * r12) -
+                 t34 * t1477 * r12) +
+                t35 * t3511_tmp * -AccScalar(0.16666666666666666)) +
+               b_t340_tmp * r6) +
+              t3044_tmp * d_a_tmp * r36) +
+             b_t3044_tmp * d_a_tmp * r36);
   t2 = t9 * t23;
   t3521_tmp = t20 * t824;
   t626_tmp = t20 * t1517;
   t72 = t23 * t1488;
-  t3521 = (((((-(t2 * a_tmp_tmp / 3.0) + t10 * ((t857 + t322 * a_tmp_tmp / 4.0) + -(t166 * a_tmp_tmp / 4.0))) +
-              t40 * ((b_t3044_tmp * t1504 / 54.0 + t3044_tmp * t2990_tmp / 54.0) + t30 * t1517 / 9.0)) +
-             -t39 * ((((t3044_tmp * t750 / 48.0 - b_t3044_tmp * t757 / 48.0) + t30 * t824 / 8.0) - t31 * t1504 / 8.0) +
-                     t319 * t2990_tmp / 8.0)) +
-            -(t11 * ((((((-(t322 * t738 / 5.0) + -(t166 * t747 / 5.0)) + t20 * b_a_tmp_tmp / 5.0) +
-                        b_t316_tmp * a_tmp_tmp / 10.0) +
-                       t34 * a_tmp_tmp / 10.0) +
-                      -(t35 * a_tmp_tmp / 5.0)) +
-                     t72 / 5.0))) +
-           -t12 * (((((((b_t316_tmp * t738 / 12.0 - t3521_tmp / 6.0) - t34 * t747 / 12.0) + t35 * t788 / 6.0) +
-                      t31 * b_a_tmp_tmp / 6.0) -
-                     t319 * b_a_tmp_tmp / 6.0) -
-                    t166 * t1483 / 6.0) +
-                   t322 * i_a_tmp / 6.0)) +
-          t13 * ((((((((t319 * t750 / 7.0 + t31 * t757 / 7.0) + -(t3044_tmp * b_a_tmp_tmp / 42.0)) +
-                      -(b_t3044_tmp * b_a_tmp_tmp / 42.0)) +
-                     t30 * b_a_tmp_tmp / 7.0) +
-                    -(t626_tmp / 7.0)) +
-                   t34 * t1483 / 14.0) +
-                  b_t316_tmp * i_a_tmp / 14.0) +
-                 t35 * t1488 / 7.0);
+  t3521 = (((((-(t2 * a_tmp_tmp * r3) + t10 * ((t857 + t322 * a_tmp_tmp / AccScalar(4.0)) + -(t166 * a_tmp_tmp / AccScalar(4.0)))) +
+              t40 * ((b_t3044_tmp * t1504 * r54 + t3044_tmp * t2990_tmp * r54) + t30 * t1517 * r9)) +
+             -t39 * ((((t3044_tmp * t750 * r48 - b_t3044_tmp * t757 * r48) + t30 * t824 / AccScalar(8.0)) - t31 * t1504 / AccScalar(8.0)) +
+                     t319 * t2990_tmp / AccScalar(8.0))) +
+            -(t11 * ((((((-(t322 * t738 * r5) + -(t166 * t747 * r5)) + t20 * b_a_tmp_tmp * r5) +
+                        b_t316_tmp * a_tmp_tmp * r10) +
+                       t34 * a_tmp_tmp * r10) +
+                      -(t35 * a_tmp_tmp * r5)) +
+                     t72 * r5))) +
+           -t12 * (((((((b_t316_tmp * t738 * r12 - t3521_tmp * r6) - t34 * t747 * r12) + t35 * t788 * r6) +
+                      t31 * b_a_tmp_tmp * r6) -
+                     t319 * b_a_tmp_tmp * r6) -
+                    t166 * t1483 * r6) +
+                   t322 * i_a_tmp * r6)) +
+          t13 * ((((((((t319 * t750 * r7 + t31 * t757 * r7) + -(t3044_tmp * b_a_tmp_tmp * r42)) +
+                      -(b_t3044_tmp * b_a_tmp_tmp * r42)) +
+                     t30 * b_a_tmp_tmp * r7) +
+                    -(t626_tmp * r7)) +
+                   t34 * t1483 * r14) +
+                  b_t316_tmp * i_a_tmp * r14) +
+                 t35 * t1488 * r7);
   t552_tmp = t22 * g_a_tmp;
   t3522 =
-      (((((t6 * e_a_tmp * -0.33333333333333331 + -(t10 * ((t766 + t33 * e_a_tmp * -0.25) + t316_tmp * e_a_tmp / 4.0))) +
-          -t40 * ((-(t3043_tmp * t1506 / 54.0) + b_t3043_tmp * t1516 / 54.0) + t4 * t2991_tmp / 9.0)) +
-         t39 * ((((t3043_tmp * t756 / 48.0 + b_t3043_tmp * t823 / 48.0) + t4 * t749 / 8.0) + -(t88 * t1506 / 8.0)) +
-                -(t32 * t1516 / 8.0))) +
-        -t11 * ((((((t33 * t746 / 5.0 - t316_tmp * t787 / 5.0) + t5 * e_a_tmp * -0.2) + u_t3531_tmp * -0.2) +
-                  t552_tmp / 5.0) +
-                 t27 * e_a_tmp / 10.0) +
-                t90 * e_a_tmp / 10.0)) +
-       -(t12 * (((((((b_t3531_tmp / 6.0 + -(t27 * t746 / 12.0)) + -(t90 * t787 / 12.0)) + -(t5 * t737 / 6.0)) +
-                   t88 * g_a_tmp * -0.16666666666666666) +
-                  t32 * g_a_tmp / 6.0) +
-                 t33 * t1485 / 6.0) +
-                t316_tmp * t1487 / 6.0))) +
-      -t13 * ((((((((t88 * t756 / 7.0 - t32 * t823 / 7.0) + t4 * g_a_tmp * -0.14285714285714285) +
-                   v_t3531_tmp * -0.14285714285714285) -
-                  t27 * t1485 / 14.0) +
-                 t90 * t1487 / 14.0) +
-                t5 * h_a_tmp / 7.0) +
-               t3043_tmp * g_a_tmp / 42.0) +
-              b_t3043_tmp * g_a_tmp / 42.0);
+      (((((t6 * e_a_tmp * -AccScalar(0.33333333333333331) + -(t10 * ((t766 + t33 * e_a_tmp * -AccScalar(0.25)) + t316_tmp * e_a_tmp / AccScalar(4.0)))) +
+          -t40 * ((-(t3043_tmp * t1506 * r54) + b_t3043_tmp * t1516 * r54) + t4 * t2991_tmp * r9)) +
+         t39 * ((((t3043_tmp * t756 * r48 + b_t3043_tmp * t823 * r48) + t4 * t749 / AccScalar(8.0)) + -(t88 * t1506 / AccScalar(8.0))) +
+                -(t32 * t1516 / AccScalar(8.0)))) +
+        -t11 * ((((((t33 * t746 * r5 - t316_tmp * t787 * r5) + t5 * e_a_tmp * -AccScalar(0.2)) + u_t3531_tmp * -AccScalar(0.2)) +
+                  t552_tmp * r5) +
+                 t27 * e_a_tmp * r10) +
+                t90 * e_a_tmp * r10)) +
+       -(t12 * (((((((b_t3531_tmp * r6 + -(t27 * t746 * r12)) + -(t90 * t787 * r12)) + -(t5 * t737 * r6)) +
+                   t88 * g_a_tmp * -AccScalar(0.16666666666666666)) +
+                  t32 * g_a_tmp * r6) +
+                 t33 * t1485 * r6) +
+                t316_tmp * t1487 * r6))) +
+      -t13 * ((((((((t88 * t756 * r7 - t32 * t823 * r7) + t4 * g_a_tmp * -AccScalar(0.14285714285714285)) +
+                   v_t3531_tmp * -AccScalar(0.14285714285714285)) -
+                  t27 * t1485 * r14) +
+                 t90 * t1487 * r14) +
+                t5 * h_a_tmp * r7) +
+               t3043_tmp * g_a_tmp * r42) +
+              b_t3043_tmp * g_a_tmp * r42);
   t627_tmp = t20 * g_a_tmp;
   t3523 =
-      (((((t2 * e_a_tmp * -0.33333333333333331 +
-           t10 * ((c_t3531_tmp / 4.0 + t166 * e_a_tmp * -0.25) + t322 * e_a_tmp / 4.0)) +
-          -(t40 * ((t3044_tmp * t1516 / 54.0 + b_t3044_tmp * t2991_tmp * -0.018518518518518517) + t30 * t1506 / 9.0))) +
-         t39 * ((((-(b_t3044_tmp * t749 / 48.0) + t3044_tmp * t823 / 48.0) - t30 * t756 / 8.0) + t319 * t1516 / 8.0) +
-                t31 * t2991_tmp / 8.0)) +
-        -t11 * ((((((t166 * t737 / 5.0 + t322 * t787 / 5.0) + t35 * e_a_tmp * -0.2) - w_t3531_tmp / 5.0) +
-                  t627_tmp / 5.0) +
-                 b_t316_tmp * e_a_tmp / 10.0) +
-                t34 * e_a_tmp / 10.0)) +
-       t12 * (((((((e_t3531_tmp / 6.0 + -(t34 * t737 / 12.0)) + b_t316_tmp * t787 / 12.0) + -(t35 * t746 / 6.0)) +
-                 t31 * g_a_tmp * -0.16666666666666666) +
-                t319 * g_a_tmp / 6.0) +
-               t322 * t1487 / 6.0) +
-              t166 * h_a_tmp / 6.0)) +
+      (((((t2 * e_a_tmp * -AccScalar(0.33333333333333331) +
+           t10 * ((c_t3531_tmp / AccScalar(4.0) + t166 * e_a_tmp * -AccScalar(0.25)) + t322 * e_a_tmp / AccScalar(4.0))) +
+          -(t40 * ((t3044_tmp * t1516 * r54 + b_t3044_tmp * t2991_tmp * -AccScalar(0.018518518518518517)) + t30 * t1506 * r9))) +
+         t39 * ((((-(b_t3044_tmp * t749 * r48) + t3044_tmp * t823 * r48) - t30 * t756 / AccScalar(8.0)) + t319 * t1516 / AccScalar(8.0)) +
+                t31 * t2991_tmp / AccScalar(8.0))) +
+        -t11 * ((((((t166 * t737 * r5 + t322 * t787 * r5) + t35 * e_a_tmp * -AccScalar(0.2)) - w_t3531_tmp * r5) +
+                  t627_tmp * r5) +
+                 b_t316_tmp * e_a_tmp * r10) +
+                t34 * e_a_tmp * r10)) +
+       t12 * (((((((e_t3531_tmp * r6 + -(t34 * t737 * r12)) + b_t316_tmp * t787 * r12) + -(t35 * t746 * r6)) +
+                 t31 * g_a_tmp * -AccScalar(0.16666666666666666)) +
+                t319 * g_a_tmp * r6) +
+               t322 * t1487 * r6) +
+              t166 * h_a_tmp * r6)) +
       -(t13 *
-        ((((((((t31 * t749 / 7.0 + t319 * t823 / 7.0) + t3044_tmp * g_a_tmp / 42.0) + b_t3044_tmp * g_a_tmp / 42.0) +
-             t30 * g_a_tmp * -0.14285714285714285) +
-            -(x_t3531_tmp / 7.0)) +
-           b_t316_tmp * t1487 / 14.0) +
-          t34 * h_a_tmp * -0.071428571428571425) +
-         t35 * t1485 / 7.0));
+        ((((((((t31 * t749 * r7 + t319 * t823 * r7) + t3044_tmp * g_a_tmp * r42) + b_t3044_tmp * g_a_tmp * r42) +
+             t30 * g_a_tmp * -AccScalar(0.14285714285714285)) +
+            -(x_t3531_tmp * r7)) +
+           b_t316_tmp * t1487 * r14) +
+          t34 * h_a_tmp * -AccScalar(0.071428571428571425)) +
+         t35 * t1485 * r7));
   t3524_tmp = t25 * t747;
   b_t3524_tmp = t22 * t757;
   t265 = t22 * t1504;
   t108 = t25 * t1483;
   t71 =
-      (((((-(t6 * a_tmp_tmp / 3.0) +
-           t10 * ((t3524_tmp / 4.0 + t33 * a_tmp_tmp / 4.0) + -(t316_tmp * a_tmp_tmp / 4.0))) +
-          -(t40 * ((t3043_tmp * t1517 / 54.0 + b_t3043_tmp * t2990_tmp * -0.018518518518518517) + t4 * t1504 / 9.0))) +
-         t39 * ((((-(b_t3043_tmp * t750 / 48.0) + t3043_tmp * t824 / 48.0) - t4 * t757 / 8.0) + t88 * t1517 / 8.0) +
-                t32 * t2990_tmp / 8.0)) +
-        -(t11 * ((((((t316_tmp * t738 / 5.0 + t33 * t788 / 5.0) + t22 * b_a_tmp_tmp / 5.0) + t27 * a_tmp_tmp / 10.0) +
-                   t90 * a_tmp_tmp / 10.0) +
-                  -(t5 * a_tmp_tmp / 5.0)) +
-                 -(t108 / 5.0)))) +
-       t12 * (((((((b_t3524_tmp / 6.0 + -(t90 * t738 / 12.0)) + t27 * t788 / 12.0) + -(t5 * t747 / 6.0)) +
-                 t88 * b_a_tmp_tmp / 6.0) +
-                -(t32 * b_a_tmp_tmp / 6.0)) +
-               t33 * t1488 / 6.0) +
-              t316_tmp * i_a_tmp / 6.0)) +
-      -(t13 * ((((((((t32 * t750 / 7.0 + t88 * t824 / 7.0) + t3043_tmp * b_a_tmp_tmp / 42.0) +
-                    b_t3043_tmp * b_a_tmp_tmp / 42.0) +
-                   -(t4 * b_a_tmp_tmp / 7.0)) +
-                  -(t265 / 7.0)) +
-                 t27 * t1488 / 14.0) +
-                t90 * i_a_tmp * -0.071428571428571425) +
-               t5 * t1483 / 7.0));
+      (((((-(t6 * a_tmp_tmp * r3) +
+           t10 * ((t3524_tmp / AccScalar(4.0) + t33 * a_tmp_tmp / AccScalar(4.0)) + -(t316_tmp * a_tmp_tmp / AccScalar(4.0)))) +
+          -(t40 * ((t3043_tmp * t1517 * r54 + b_t3043_tmp * t2990_tmp * -AccScalar(0.018518518518518517)) + t4 * t1504 * r9))) +
+         t39 * ((((-(b_t3043_tmp * t750 * r48) + t3043_tmp * t824 * r48) - t4 * t757 / AccScalar(8.0)) + t88 * t1517 / AccScalar(8.0)) +
+                t32 * t2990_tmp / AccScalar(8.0))) +
+        -(t11 * ((((((t316_tmp * t738 * r5 + t33 * t788 * r5) + t22 * b_a_tmp_tmp * r5) + t27 * a_tmp_tmp * r10) +
+                   t90 * a_tmp_tmp * r10) +
+                  -(t5 * a_tmp_tmp * r5)) +
+                 -(t108 * r5)))) +
+       t12 * (((((((b_t3524_tmp * r6 + -(t90 * t738 * r12)) + t27 * t788 * r12) + -(t5 * t747 * r6)) +
+                 t88 * b_a_tmp_tmp * r6) +
+                -(t32 * b_a_tmp_tmp * r6)) +
+               t33 * t1488 * r6) +
+              t316_tmp * i_a_tmp * r6)) +
+      -(t13 * ((((((((t32 * t750 * r7 + t88 * t824 * r7) + t3043_tmp * b_a_tmp_tmp * r42) +
+                    b_t3043_tmp * b_a_tmp_tmp * r42) +
+                   -(t4 * b_a_tmp_tmp * r7)) +
+                  -(t265 * r7)) +
+                 t27 * t1488 * r14) +
+                t90 * i_a_tmp * -AccScalar(0.071428571428571425)) +
+               t5 * t1483 * r7));
   t315_tmp = t21 * t755;
   t362 = t24 * t1484;
   t538_tmp_tmp = t21 * t1505;
   t128 = t21 * f_a_tmp;
   t3525 =
-      (((((t26 * d_a_tmp / 3.0 + t10 * ((t779 + t340_tmp * d_a_tmp * -0.25) + t69 * d_a_tmp / 4.0)) +
+      (((((t26 * d_a_tmp * r3 + t10 * ((t779 + t340_tmp * d_a_tmp * -AccScalar(0.25)) + t69 * d_a_tmp / AccScalar(4.0))) +
           -(t40 *
-            ((d_t3043_tmp * t2989_tmp * -0.018518518518518517 + c_t3043_tmp * t1515 / 54.0) + t28 * t1505 / 9.0))) +
-         t39 * ((((-(d_t3043_tmp * t748 / 48.0) + c_t3043_tmp * t825 / 48.0) - t28 * t755 / 8.0) + t318 * t1515 / 8.0) +
-                t68 * t2989_tmp / 8.0)) +
-        t11 * ((((((-(t69 * t736 / 5.0) - t340_tmp * t789 / 5.0) + t29 * d_a_tmp * -0.2) + t362 / 5.0) + t128 / 5.0) +
-                b_t315_tmp * d_a_tmp / 10.0) +
-               t168 * d_a_tmp / 10.0)) +
-       t12 * (((((((t315_tmp / 6.0 + -(b_t315_tmp * t736 / 12.0)) + t168 * t789 / 12.0) + -(t29 * t745 / 6.0)) +
-                 t318 * f_a_tmp * -0.16666666666666666) +
-                t68 * f_a_tmp / 6.0) +
-               t340_tmp * t1486 / 6.0) +
-              t69 * j_a_tmp / 6.0)) +
-      -(t13 * ((((((((t68 * t748 / 7.0 + t318 * t825 / 7.0) + d_t3043_tmp * f_a_tmp * -0.023809523809523808) +
-                    c_t3043_tmp * f_a_tmp * -0.023809523809523808) +
-                   t28 * f_a_tmp / 7.0) +
-                  -(t538_tmp_tmp / 7.0)) +
-                 b_t315_tmp * j_a_tmp * -0.071428571428571425) +
-                t168 * t1486 / 14.0) +
-               t29 * t1484 / 7.0));
+            ((d_t3043_tmp * t2989_tmp * -AccScalar(0.018518518518518517) + c_t3043_tmp * t1515 * r54) + t28 * t1505 * r9))) +
+         t39 * ((((-(d_t3043_tmp * t748 * r48) + c_t3043_tmp * t825 * r48) - t28 * t755 / AccScalar(8.0)) + t318 * t1515 / AccScalar(8.0)) +
+                t68 * t2989_tmp / AccScalar(8.0))) +
+        t11 * ((((((-(t69 * t736 * r5) - t340_tmp * t789 * r5) + t29 * d_a_tmp * -AccScalar(0.2)) + t362 * r5) + t128 * r5) +
+                b_t315_tmp * d_a_tmp * r10) +
+               t168 * d_a_tmp * r10)) +
+       t12 * (((((((t315_tmp * r6 + -(b_t315_tmp * t736 * r12)) + t168 * t789 * r12) + -(t29 * t745 * r6)) +
+                 t318 * f_a_tmp * -AccScalar(0.16666666666666666)) +
+                t68 * f_a_tmp * r6) +
+               t340_tmp * t1486 * r6) +
+              t69 * j_a_tmp * r6)) +
+      -(t13 * ((((((((t68 * t748 * r7 + t318 * t825 * r7) + d_t3043_tmp * f_a_tmp * -AccScalar(0.023809523809523808)) +
+                    c_t3043_tmp * f_a_tmp * -AccScalar(0.023809523809523808)) +
+                   t28 * f_a_tmp * r7) +
+                  -(t538_tmp_tmp * r7)) +
+                 b_t315_tmp * j_a_tmp * -AccScalar(0.071428571428571425)) +
+                t168 * t1486 * r14) +
+               t29 * t1484 * r7));
   t540_tmp = t21 * t750;
   t152 = t21 * t2990_tmp;
   t341 = t24 * i_a_tmp;
   t156 =
-      (((((-(t26 * a_tmp_tmp / 3.0) + -(t10 * ((t765 + t69 * a_tmp_tmp / 4.0) + -(t340_tmp * a_tmp_tmp / 4.0)))) +
-          -t40 * ((-(c_t3043_tmp * t1504 / 54.0) + d_t3043_tmp * t1517 / 54.0) + t28 * t2990_tmp / 9.0)) +
-         t39 * ((((c_t3043_tmp * t757 / 48.0 + d_t3043_tmp * t824 / 48.0) + t28 * t750 / 8.0) + -(t318 * t1504 / 8.0)) +
-                -(t68 * t1517 / 8.0))) +
-        -(t11 * ((((((t340_tmp * t747 / 5.0 + -(t69 * t788 / 5.0)) + t21 * b_a_tmp_tmp / 5.0) +
-                    b_t315_tmp * a_tmp_tmp / 10.0) +
-                   t168 * a_tmp_tmp / 10.0) +
-                  -(t29 * a_tmp_tmp / 5.0)) +
-                 t341 * -0.2))) +
-       -(t12 * (((((((t540_tmp / 6.0 + -(t168 * t747 / 12.0)) + -(b_t315_tmp * t788 / 12.0)) + -(t29 * t738 / 6.0)) +
-                   t68 * b_a_tmp_tmp / 6.0) +
-                  -(t318 * b_a_tmp_tmp / 6.0)) +
-                 t340_tmp * t1483 / 6.0) +
-                t69 * t1488 / 6.0))) +
-      -(t13 * ((((((((t318 * t757 / 7.0 + -(t68 * t824 / 7.0)) + d_t3043_tmp * b_a_tmp_tmp / 42.0) +
-                    c_t3043_tmp * b_a_tmp_tmp / 42.0) +
-                   -(t28 * b_a_tmp_tmp / 7.0)) +
-                  t152 * -0.14285714285714285) +
-                 b_t315_tmp * t1488 / 14.0) +
-                -(t168 * t1483 / 14.0)) +
-               t29 * i_a_tmp / 7.0));
+      (((((-(t26 * a_tmp_tmp * r3) + -(t10 * ((t765 + t69 * a_tmp_tmp / AccScalar(4.0)) + -(t340_tmp * a_tmp_tmp / AccScalar(4.0))))) +
+          -t40 * ((-(c_t3043_tmp * t1504 * r54) + d_t3043_tmp * t1517 * r54) + t28 * t2990_tmp * r9)) +
+         t39 * ((((c_t3043_tmp * t757 * r48 + d_t3043_tmp * t824 * r48) + t28 * t750 / AccScalar(8.0)) + -(t318 * t1504 / AccScalar(8.0))) +
+                -(t68 * t1517 / AccScalar(8.0)))) +
+        -(t11 * ((((((t340_tmp * t747 * r5 + -(t69 * t788 * r5)) + t21 * b_a_tmp_tmp * r5) +
+                    b_t315_tmp * a_tmp_tmp * r10) +
+                   t168 * a_tmp_tmp * r10) +
+                  -(t29 * a_tmp_tmp * r5)) +
+                 t341 * -AccScalar(0.2)))) +
+       -(t12 * (((((((t540_tmp * r6 + -(t168 * t747 * r12)) + -(b_t315_tmp * t788 * r12)) + -(t29 * t738 * r6)) +
+                   t68 * b_a_tmp_tmp * r6) +
+                  -(t318 * b_a_tmp_tmp * r6)) +
+                 t340_tmp * t1483 * r6) +
+                t69 * t1488 * r6))) +
+      -(t13 * ((((((((t318 * t757 * r7 + -(t68 * t824 * r7)) + d_t3043_tmp * b_a_tmp_tmp * r42) +
+                    c_t3043_tmp * b_a_tmp_tmp * r42) +
+                   -(t28 * b_a_tmp_tmp * r7)) +
+                  t152 * -AccScalar(0.14285714285714285)) +
+                 b_t315_tmp * t1488 * r14) +
+                -(t168 * t1483 * r14)) +
+               t29 * i_a_tmp * r7));
   t129 = t23 * t736;
   t127 = t20 * t748;
   t323 = t20 * t2989_tmp;
   t321 = t20 * f_a_tmp;
   t155 = t23 * j_a_tmp;
   t167 =
-      (((((t2 * d_a_tmp / 3.0 + -(t10 * ((t129 / 4.0 + t166 * d_a_tmp * -0.25) + t322 * d_a_tmp / 4.0))) +
-          -t40 * ((-(t3044_tmp * t1505 / 54.0) + b_t3044_tmp * t1515 / 54.0) + t30 * t2989_tmp / 9.0)) +
-         t39 * ((((t3044_tmp * t755 / 48.0 + b_t3044_tmp * t825 / 48.0) + t30 * t748 / 8.0) + -(t319 * t1505 / 8.0)) +
-                -(t31 * t1515 / 8.0))) +
-        t11 * ((((((-(t322 * t745 / 5.0) + t166 * t789 / 5.0) + t35 * d_a_tmp * -0.2) + t321 / 5.0) + t155 / 5.0) +
-                b_t316_tmp * d_a_tmp / 10.0) +
-               t34 * d_a_tmp / 10.0)) +
-       -(t12 * (((((((t127 / 6.0 + -(b_t316_tmp * t745 / 12.0)) + -(t34 * t789 / 12.0)) + -(t35 * t736 / 6.0)) +
-                   t31 * f_a_tmp * -0.16666666666666666) +
-                  t319 * f_a_tmp / 6.0) +
-                 t322 * t1484 / 6.0) +
-                t166 * t1486 / 6.0))) +
-      t13 * ((((((((-(t319 * t755 / 7.0) + t31 * t825 / 7.0) + t30 * f_a_tmp * -0.14285714285714285) +
-                  b_t316_tmp * t1484 / 14.0) -
-                 t34 * t1486 / 14.0) +
-                t35 * j_a_tmp * -0.14285714285714285) +
-               t323 / 7.0) +
-              t3044_tmp * f_a_tmp / 42.0) +
-             b_t3044_tmp * f_a_tmp / 42.0);
+      (((((t2 * d_a_tmp * r3 + -(t10 * ((t129 / AccScalar(4.0) + t166 * d_a_tmp * -AccScalar(0.25)) + t322 * d_a_tmp / AccScalar(4.0)))) +
+          -t40 * ((-(t3044_tmp * t1505 * r54) + b_t3044_tmp * t1515 * r54) + t30 * t2989_tmp * r9)) +
+         t39 * ((((t3044_tmp * t755 * r48 + b_t3044_tmp * t825 * r48) + t30 * t748 / AccScalar(8.0)) + -(t319 * t1505 / AccScalar(8.0))) +
+                -(t31 * t1515 / AccScalar(8.0)))) +
+        t11 * ((((((-(t322 * t745 * r5) + t166 * t789 * r5) + t35 * d_a_tmp * -AccScalar(0.2)) + t321 * r5) + t155 * r5) +
+                b_t316_tmp * d_a_tmp * r10) +
+               t34 * d_a_tmp * r10)) +
+       -(t12 * (((((((t127 * r6 + -(b_t316_tmp * t745 * r12)) + -(t34 * t789 * r12)) + -(t35 * t736 * r6)) +
+                   t31 * f_a_tmp * -AccScalar(0.16666666666666666)) +
+                  t319 * f_a_tmp * r6) +
+                 t322 * t1484 * r6) +
+                t166 * t1486 * r6))) +
+      t13 * ((((((((-(t319 * t755 * r7) + t31 * t825 * r7) + t30 * f_a_tmp * -AccScalar(0.14285714285714285)) +
+                  b_t316_tmp * t1484 * r14) -
+                 t34 * t1486 * r14) +
+                t35 * j_a_tmp * -AccScalar(0.14285714285714285)) +
+               t323 * r7) +
+              t3044_tmp * f_a_tmp * r42) +
+             b_t3044_tmp * f_a_tmp * r42);
   t26 = t24 * t892;
   t27 = t25 * t892;
   t28 = t23 * t892;
@@ -1362,143 +1387,143 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t3 = t17 * t101 * t203;
   t158 =
       ((((((-(dt_lim * ((t298 + t425) + -t421)) +
-            -t9 * (((((t7 / 3.0 - t473_tmp / 3.0) + t3 / 3.0) + t28 * a_tmp / 3.0) + t26 * a_tmp / 3.0) +
-                   t27 * a_tmp / 3.0)) +
-           -(t40 * ((t630_tmp * i_a_tmp * -0.1111111111111111 + t364 * t1486 / 9.0) + t342 * j_a_tmp / 9.0))) +
-          t10 * (((((t3518_tmp * t892 / 4.0 + t762_tmp * a_tmp * -0.25) - t776_tmp * t892 / 4.0) -
-                   b_t3511_tmp * t892 / 4.0) +
-                  t3515_tmp * a_tmp / 4.0) +
-                 t854_tmp * a_tmp / 4.0)) +
-         t39 * (((((-(t3517_tmp * t1484 / 8.0) + b_t3518_tmp * t1488 / 8.0) - b_t3515_tmp * t1486 / 8.0) +
-                  c_t3511_tmp * t1483 / 8.0) +
-                 t3516_tmp * i_a_tmp / 8.0) +
-                b_t3512_tmp * j_a_tmp / 8.0)) +
-        t12 * (((((((((((b_t3518_tmp * a_tmp_tmp / 6.0 + t3517_tmp * d_a_tmp * -0.16666666666666666) -
-                        t3516_tmp * a_tmp_tmp / 6.0) -
-                       c_t3511_tmp * a_tmp_tmp / 6.0) -
-                      t762_tmp * t1475 / 6.0) +
-                     t3518_tmp * t1479 / 6.0) -
-                    t3515_tmp * t1477 / 6.0) +
-                   b_t3511_tmp * t1474 / 6.0) +
-                  t776_tmp * t3512_tmp / 6.0) +
-                 t854_tmp * t3511_tmp / 6.0) +
-                b_t3515_tmp * d_a_tmp / 6.0) +
-               b_t3512_tmp * d_a_tmp / 6.0)) +
+            -t9 * (((((t7 * r3 - t473_tmp * r3) + t3 * r3) + t28 * a_tmp * r3) + t26 * a_tmp * r3) +
+                   t27 * a_tmp * r3)) +
+           -(t40 * ((t630_tmp * i_a_tmp * -AccScalar(0.1111111111111111) + t364 * t1486 * r9) + t342 * j_a_tmp * r9))) +
+          t10 * (((((t3518_tmp * t892 / AccScalar(4.0) + t762_tmp * a_tmp * -AccScalar(0.25)) - t776_tmp * t892 / AccScalar(4.0)) -
+                   b_t3511_tmp * t892 / AccScalar(4.0)) +
+                  t3515_tmp * a_tmp / AccScalar(4.0)) +
+                 t854_tmp * a_tmp / AccScalar(4.0))) +
+         t39 * (((((-(t3517_tmp * t1484 / AccScalar(8.0)) + b_t3518_tmp * t1488 / AccScalar(8.0)) - b_t3515_tmp * t1486 / AccScalar(8.0)) +
+                  c_t3511_tmp * t1483 / AccScalar(8.0)) +
+                 t3516_tmp * i_a_tmp / AccScalar(8.0)) +
+                b_t3512_tmp * j_a_tmp / AccScalar(8.0))) +
+        t12 * (((((((((((b_t3518_tmp * a_tmp_tmp * r6 + t3517_tmp * d_a_tmp * -AccScalar(0.16666666666666666)) -
+                        t3516_tmp * a_tmp_tmp * r6) -
+                       c_t3511_tmp * a_tmp_tmp * r6) -
+                      t762_tmp * t1475 * r6) +
+                     t3518_tmp * t1479 * r6) -
+                    t3515_tmp * t1477 * r6) +
+                   b_t3511_tmp * t1474 * r6) +
+                  t776_tmp * t3512_tmp * r6) +
+                 t854_tmp * t3511_tmp * r6) +
+                b_t3515_tmp * d_a_tmp * r6) +
+               b_t3512_tmp * d_a_tmp * r6)) +
        -t11 *
-           (((((((((((t762_tmp * t742 / 5.0 + t3518_tmp * t785 / 5.0) - t3515_tmp * t786 / 5.0) + t26 * t1475 / 5.0) +
-                   t363 * a_tmp * -0.2) -
-                  t168 * t3512_tmp / 5.0) -
-                 t27 * t1477 / 5.0) +
-                t28 * t3511_tmp / 5.0) +
-               t343 * a_tmp / 5.0) +
-              t539_tmp * a_tmp_tmp / 5.0) +
-             b_a_tmp * a_tmp_tmp / 5.0) +
-            d_t3511_tmp * a_tmp_tmp / 5.0)) +
-      -(t13 * (((((((((((t3517_tmp * t745 / 7.0 + b_t3518_tmp * t788 / 7.0) + -(b_t3515_tmp * t789 / 7.0)) +
-                       t630_tmp * a_tmp_tmp / 7.0) +
-                      t364 * d_a_tmp * -0.14285714285714285) +
-                     t342 * d_a_tmp / 7.0) +
-                    b_t340_tmp * a_tmp_tmp / 7.0) +
-                   -(t153 * d_a_tmp / 7.0)) +
-                  -(e_t3511_tmp * a_tmp_tmp / 7.0)) +
-                 t70 * t3512_tmp * -0.14285714285714285) +
-                t363 * t1477 / 7.0) +
-               t343 * t3511_tmp / 7.0));
+           (((((((((((t762_tmp * t742 * r5 + t3518_tmp * t785 * r5) - t3515_tmp * t786 * r5) + t26 * t1475 * r5) +
+                   t363 * a_tmp * -AccScalar(0.2)) -
+                  t168 * t3512_tmp * r5) -
+                 t27 * t1477 * r5) +
+                t28 * t3511_tmp * r5) +
+               t343 * a_tmp * r5) +
+              t539_tmp * a_tmp_tmp * r5) +
+             b_a_tmp * a_tmp_tmp * r5) +
+            d_t3511_tmp * a_tmp_tmp * r5)) +
+      -(t13 * (((((((((((t3517_tmp * t745 * r7 + b_t3518_tmp * t788 * r7) + -(b_t3515_tmp * t789 * r7)) +
+                       t630_tmp * a_tmp_tmp * r7) +
+                      t364 * d_a_tmp * -AccScalar(0.14285714285714285)) +
+                     t342 * d_a_tmp * r7) +
+                    b_t340_tmp * a_tmp_tmp * r7) +
+                   -(t153 * d_a_tmp * r7)) +
+                  -(e_t3511_tmp * a_tmp_tmp * r7)) +
+                 t70 * t3512_tmp * -AccScalar(0.14285714285714285)) +
+                t363 * t1477 * r7) +
+               t343 * t3511_tmp * r7));
   t5 = t18 * t102 * t202;
   t29 = t473_tmp_tmp * t100;
   t320 = ((((((-(dt_lim * ((t299 + t426) + -t419)) +
-               t9 * (((((-(t29 / 3.0) + t469_tmp / 3.0) - t5 / 3.0) + t28 * c_a_tmp / 3.0) + t26 * c_a_tmp / 3.0) +
-                     t27 * c_a_tmp / 3.0)) +
+               t9 * (((((-(t29 * r3) + t469_tmp * r3) - t5 * r3) + t28 * c_a_tmp * r3) + t26 * c_a_tmp * r3) +
+                     t27 * c_a_tmp * r3)) +
               -(t40 *
-                ((j_t3531_tmp * t1488 / 9.0 + t364 * h_a_tmp * -0.1111111111111111) + k_t3531_tmp * i_a_tmp / 9.0))) +
-             -t10 * (((((t762_tmp * c_a_tmp * -0.25 - t763_tmp * t892 / 4.0) + d_t3531_tmp * t892 / 4.0) +
-                       t855_tmp * t892 / 4.0) +
-                      t3515_tmp * c_a_tmp / 4.0) +
-                     t854_tmp * c_a_tmp / 4.0)) +
-            t39 * (((((-(t3531_tmp * t1483 / 8.0) + t3517_tmp * t1487 / 8.0) - f_t3531_tmp * t1488 / 8.0) +
-                     b_t3512_tmp * t1485 / 8.0) +
-                    g_t3531_tmp * i_a_tmp / 8.0) +
-                   b_t3515_tmp * h_a_tmp / 8.0)) +
-           t12 * (((((((((((t3531_tmp * a_tmp_tmp / 6.0 - f_t3531_tmp * a_tmp_tmp / 6.0) +
-                           b_t3515_tmp * e_a_tmp * -0.16666666666666666) +
-                          b_t3512_tmp * e_a_tmp * -0.16666666666666666) -
-                         g_t3531_tmp * a_tmp_tmp / 6.0) -
-                        t763_tmp * t1474 / 6.0) +
-                       t762_tmp * t1478 / 6.0) -
-                      d_t3531_tmp * t1479 / 6.0) +
-                     t854_tmp * t1476 / 6.0) +
-                    t855_tmp * t3512_tmp / 6.0) +
-                   t3515_tmp * i_t3531_tmp / 6.0) +
-                  t3517_tmp * e_a_tmp / 6.0)) +
-          -(t11 * (((((((((((t763_tmp * t744 / 5.0 + t762_tmp * t784 / 5.0) + -(d_t3531_tmp * t785 / 5.0)) +
-                           t_t3531_tmp * a_tmp_tmp * -0.2) +
-                          p_t3531_tmp * a_tmp_tmp * -0.2) +
-                         s_t3531_tmp * a_tmp_tmp * -0.2) +
-                        t28 * t1476 / 5.0) +
-                       t343 * c_a_tmp * -0.2) +
-                      t151 * c_a_tmp / 5.0) +
-                     t363 * c_a_tmp / 5.0) +
-                    -(t26 * t1478 / 5.0)) +
-                   t27 * i_t3531_tmp / 5.0))) +
-         -(t13 * (((((((((((t3531_tmp * t747 / 7.0 + t3517_tmp * t787 / 7.0) + -(f_t3531_tmp * t788 / 7.0)) +
-                          j_t3531_tmp * a_tmp_tmp / 7.0) +
-                         t342 * e_a_tmp * -0.14285714285714285) +
-                        t153 * e_a_tmp / 7.0) +
-                       t364 * e_a_tmp / 7.0) +
-                      -(k_t3531_tmp * a_tmp_tmp / 7.0)) +
-                     l_t3531_tmp * a_tmp_tmp / 7.0) +
-                    m_t3531_tmp * t1479 / 7.0) +
-                   t363 * i_t3531_tmp * -0.14285714285714285) +
-                  n_t3531_tmp * t3512_tmp / 7.0));
+                ((j_t3531_tmp * t1488 * r9 + t364 * h_a_tmp * -AccScalar(0.1111111111111111)) + k_t3531_tmp * i_a_tmp * r9))) +
+             -t10 * (((((t762_tmp * c_a_tmp * -AccScalar(0.25) - t763_tmp * t892 / AccScalar(4.0)) + d_t3531_tmp * t892 / AccScalar(4.0)) +
+                       t855_tmp * t892 / AccScalar(4.0)) +
+                      t3515_tmp * c_a_tmp / AccScalar(4.0)) +
+                     t854_tmp * c_a_tmp / AccScalar(4.0))) +
+            t39 * (((((-(t3531_tmp * t1483 / AccScalar(8.0)) + t3517_tmp * t1487 / AccScalar(8.0)) - f_t3531_tmp * t1488 / AccScalar(8.0)) +
+                     b_t3512_tmp * t1485 / AccScalar(8.0)) +
+                    g_t3531_tmp * i_a_tmp / AccScalar(8.0)) +
+                   b_t3515_tmp * h_a_tmp / AccScalar(8.0))) +
+           t12 * (((((((((((t3531_tmp * a_tmp_tmp * r6 - f_t3531_tmp * a_tmp_tmp * r6) +
+                           b_t3515_tmp * e_a_tmp * -AccScalar(0.16666666666666666)) +
+                          b_t3512_tmp * e_a_tmp * -AccScalar(0.16666666666666666)) -
+                         g_t3531_tmp * a_tmp_tmp * r6) -
+                        t763_tmp * t1474 * r6) +
+                       t762_tmp * t1478 * r6) -
+                      d_t3531_tmp * t1479 * r6) +
+                     t854_tmp * t1476 * r6) +
+                    t855_tmp * t3512_tmp * r6) +
+                   t3515_tmp * i_t3531_tmp * r6) +
+                  t3517_tmp * e_a_tmp * r6)) +
+          -(t11 * (((((((((((t763_tmp * t744 * r5 + t762_tmp * t784 * r5) + -(d_t3531_tmp * t785 * r5)) +
+                           t_t3531_tmp * a_tmp_tmp * -AccScalar(0.2)) +
+                          p_t3531_tmp * a_tmp_tmp * -AccScalar(0.2)) +
+                         s_t3531_tmp * a_tmp_tmp * -AccScalar(0.2)) +
+                        t28 * t1476 * r5) +
+                       t343 * c_a_tmp * -AccScalar(0.2)) +
+                      t151 * c_a_tmp * r5) +
+                     t363 * c_a_tmp * r5) +
+                    -(t26 * t1478 * r5)) +
+                   t27 * i_t3531_tmp * r5))) +
+         -(t13 * (((((((((((t3531_tmp * t747 * r7 + t3517_tmp * t787 * r7) + -(f_t3531_tmp * t788 * r7)) +
+                          j_t3531_tmp * a_tmp_tmp * r7) +
+                         t342 * e_a_tmp * -AccScalar(0.14285714285714285)) +
+                        t153 * e_a_tmp * r7) +
+                       t364 * e_a_tmp * r7) +
+                      -(k_t3531_tmp * a_tmp_tmp * r7)) +
+                     l_t3531_tmp * a_tmp_tmp * r7) +
+                    m_t3531_tmp * t1479 * r7) +
+                   t363 * i_t3531_tmp * -AccScalar(0.14285714285714285)) +
+                  n_t3531_tmp * t3512_tmp * r7));
   t183_tmp = t25 * a_tmp;
   t318 = t23 * a_tmp;
   t67 = t19 * t100 * t201;
   t69 = t469_tmp_tmp * t101;
   t166 =
       ((((((-(dt_lim * ((t297 + t427) + -t420)) +
-            -(t9 * (((((t69 / 3.0 + -(b_t481_tmp / 3.0)) + t67 / 3.0) + t318 * c_a_tmp / 3.0) + t168 * c_a_tmp / 3.0) +
-                    t183_tmp * c_a_tmp / 3.0))) +
+            -(t9 * (((((t69 * r3 + -(b_t481_tmp * r3)) + t67 * r3) + t318 * c_a_tmp * r3) + t168 * c_a_tmp * r3) +
+                    t183_tmp * c_a_tmp * r3))) +
            -(t40 *
-             ((j_t3531_tmp * j_a_tmp * -0.1111111111111111 + t630_tmp * t1487 / 9.0) + e_t3511_tmp * h_a_tmp / 9.0))) +
-          t10 * (((((t763_tmp * a_tmp * -0.25 + t776_tmp * c_a_tmp * -0.25) + b_t3511_tmp * c_a_tmp * -0.25) +
-                   t3518_tmp * c_a_tmp / 4.0) +
-                  d_t3531_tmp * a_tmp / 4.0) +
-                 t855_tmp * a_tmp / 4.0)) +
-         t39 * (((((-(b_t3518_tmp * t1485 / 8.0) + t3531_tmp * t1486 / 8.0) - t3516_tmp * t1487 / 8.0) +
-                  g_t3531_tmp * t1484 / 8.0) +
-                 f_t3531_tmp * j_a_tmp / 8.0) +
-                c_t3511_tmp * h_a_tmp / 8.0)) +
-        t12 * (((((((((((t3531_tmp * d_a_tmp * -0.16666666666666666 + t3516_tmp * e_a_tmp * -0.16666666666666666) +
-                        c_t3511_tmp * e_a_tmp * -0.16666666666666666) -
-                       t3518_tmp * t1476 / 6.0) +
-                      t763_tmp * t1477 / 6.0) -
-                     t776_tmp * t1478 / 6.0) +
-                    t855_tmp * t1475 / 6.0) +
-                   d_t3531_tmp * t3511_tmp / 6.0) +
-                  b_t3511_tmp * i_t3531_tmp / 6.0) +
-                 b_t3518_tmp * e_a_tmp / 6.0) +
-                f_t3531_tmp * d_a_tmp / 6.0) +
-               g_t3531_tmp * d_a_tmp / 6.0)) +
-       -(t11 * (((((((((((t3518_tmp * t743 / 5.0 + t763_tmp * t786 / 5.0) + -(t776_tmp * t784 / 5.0)) +
-                        t539_tmp * e_a_tmp / 5.0) +
-                       b_a_tmp * e_a_tmp / 5.0) +
-                      d_t3511_tmp * e_a_tmp / 5.0) +
-                     m_t3531_tmp * a_tmp * -0.2) +
-                    t555_tmp * c_a_tmp / 5.0) +
-                   t70 * c_a_tmp / 5.0) +
-                  f_t3511_tmp * c_a_tmp * -0.2) +
-                 n_t3531_tmp * a_tmp / 5.0) +
-                -(t183_tmp * i_t3531_tmp / 5.0)))) +
-      -(t13 * (((((((((((b_t3518_tmp * t746 / 7.0 + t3531_tmp * t789 / 7.0) + -(t3516_tmp * t787 / 7.0)) +
-                       j_t3531_tmp * d_a_tmp * -0.14285714285714285) +
-                      b_t340_tmp * e_a_tmp / 7.0) +
-                     t630_tmp * e_a_tmp / 7.0) +
-                    e_t3511_tmp * e_a_tmp * -0.14285714285714285) +
-                   k_t3531_tmp * d_a_tmp / 7.0) +
-                  -(l_t3531_tmp * d_a_tmp / 7.0)) +
-                 m_t3531_tmp * t3511_tmp * -0.14285714285714285) +
-                t70 * t1478 / 7.0) +
-               f_t3511_tmp * i_t3531_tmp / 7.0));
+             ((j_t3531_tmp * j_a_tmp * -AccScalar(0.1111111111111111) + t630_tmp * t1487 * r9) + e_t3511_tmp * h_a_tmp * r9))) +
+          t10 * (((((t763_tmp * a_tmp * -AccScalar(0.25) + t776_tmp * c_a_tmp * -AccScalar(0.25)) + b_t3511_tmp * c_a_tmp * -AccScalar(0.25)) +
+                   t3518_tmp * c_a_tmp / AccScalar(4.0)) +
+                  d_t3531_tmp * a_tmp / AccScalar(4.0)) +
+                 t855_tmp * a_tmp / AccScalar(4.0))) +
+         t39 * (((((-(b_t3518_tmp * t1485 / AccScalar(8.0)) + t3531_tmp * t1486 / AccScalar(8.0)) - t3516_tmp * t1487 / AccScalar(8.0)) +
+                  g_t3531_tmp * t1484 / AccScalar(8.0)) +
+                 f_t3531_tmp * j_a_tmp / AccScalar(8.0)) +
+                c_t3511_tmp * h_a_tmp / AccScalar(8.0))) +
+        t12 * (((((((((((t3531_tmp * d_a_tmp * -AccScalar(0.16666666666666666) + t3516_tmp * e_a_tmp * -AccScalar(0.16666666666666666)) +
+                        c_t3511_tmp * e_a_tmp * -AccScalar(0.16666666666666666)) -
+                       t3518_tmp * t1476 * r6) +
+                      t763_tmp * t1477 * r6) -
+                     t776_tmp * t1478 * r6) +
+                    t855_tmp * t1475 * r6) +
+                   d_t3531_tmp * t3511_tmp * r6) +
+                  b_t3511_tmp * i_t3531_tmp * r6) +
+                 b_t3518_tmp * e_a_tmp * r6) +
+                f_t3531_tmp * d_a_tmp * r6) +
+               g_t3531_tmp * d_a_tmp * r6)) +
+       -(t11 * (((((((((((t3518_tmp * t743 * r5 + t763_tmp * t786 * r5) + -(t776_tmp * t784 * r5)) +
+                        t539_tmp * e_a_tmp * r5) +
+                       b_a_tmp * e_a_tmp * r5) +
+                      d_t3511_tmp * e_a_tmp * r5) +
+                     m_t3531_tmp * a_tmp * -AccScalar(0.2)) +
+                    t555_tmp * c_a_tmp * r5) +
+                   t70 * c_a_tmp * r5) +
+                  f_t3511_tmp * c_a_tmp * -AccScalar(0.2)) +
+                 n_t3531_tmp * a_tmp * r5) +
+                -(t183_tmp * i_t3531_tmp * r5)))) +
+      -(t13 * (((((((((((b_t3518_tmp * t746 * r7 + t3531_tmp * t789 * r7) + -(t3516_tmp * t787 * r7)) +
+                       j_t3531_tmp * d_a_tmp * -AccScalar(0.14285714285714285)) +
+                      b_t340_tmp * e_a_tmp * r7) +
+                     t630_tmp * e_a_tmp * r7) +
+                    e_t3511_tmp * e_a_tmp * -AccScalar(0.14285714285714285)) +
+                   k_t3531_tmp * d_a_tmp * r7) +
+                  -(l_t3531_tmp * d_a_tmp * r7)) +
+                 m_t3531_tmp * t3511_tmp * -AccScalar(0.14285714285714285)) +
+                t70 * t1478 * r7) +
+               f_t3511_tmp * i_t3531_tmp * r7));
   t6 = t18 * t96;
   t154 = t16 * t107;
   t157 = t15 * t114;
@@ -1506,49 +1531,49 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t322 = t19 * t107;
   t319 = t17 * t266;
   t3532 =
-      ((((((t8 * ((t154 / 2.0 + t157 / 2.0) + t159 / 2.0) +
-            t10 * (((((t322 / 8.0 + t6 * t102 / 4.0) + t319 / 8.0) + t28 * a_tmp_tmp / 4.0) + t26 * a_tmp_tmp / 4.0) +
-                   t27 * a_tmp_tmp / 4.0)) +
-           t41 * ((t364 * t1504 / 10.0 + t342 * t1517 / 10.0) + t153 * t2990_tmp / 10.0)) +
-          -(t11 * (((((-(t765_tmp * t892 / 5.0) + t3524_tmp * t892 / 5.0) + t857_tmp * t892 / 5.0) +
-                     -(t762_tmp * a_tmp_tmp / 5.0)) +
-                    t3515_tmp * a_tmp_tmp / 5.0) +
-                   t854_tmp * a_tmp_tmp / 5.0))) +
-         -t40 * (((((-(b_t3524_tmp * t1483 / 9.0) - b_t3515_tmp * t1504 / 9.0) + t3521_tmp * t1488 / 9.0) +
-                   b_t3512_tmp * t1517 / 9.0) +
-                  t540_tmp * i_a_tmp / 9.0) +
-                 t3517_tmp * t2990_tmp / 9.0)) +
-        -(t13 * (((((((((((-(t3517_tmp * b_a_tmp_tmp / 7.0) + b_t3515_tmp * b_a_tmp_tmp / 7.0) +
-                          -(t540_tmp * a_tmp_tmp / 7.0)) +
-                         b_t3524_tmp * a_tmp_tmp / 7.0) +
-                        b_t3512_tmp * b_a_tmp_tmp / 7.0) +
-                       t3521_tmp * a_tmp_tmp / 7.0) +
-                      t765_tmp * t3512_tmp / 7.0) +
-                     -(t3524_tmp * t1474 / 7.0)) +
-                    t762_tmp * i_a_tmp / 7.0) +
-                   -(t3515_tmp * t1483 / 7.0)) +
-                  t857_tmp * t1479 / 7.0) +
-                 t854_tmp * t1488 / 7.0))) +
-       t12 * (((((((((((t762_tmp * t738 / 6.0 + t3515_tmp * t747 / 6.0) + t854_tmp * t788 / 6.0) +
-                      t20 * (((((t211 - t214) + t242) + t269) + t368) + t394) * b_a_tmp_tmp / 6.0) +
-                     t21 * (((((t211 - t214) + t242) + t269) + t368) + t394) * b_a_tmp_tmp / 6.0) +
-                    t22 * (((((t211 - t214) + t242) + t269) + t368) + t394) * b_a_tmp_tmp / 6.0) +
-                   t28 * t1488 / 6.0) +
-                  t26 * i_a_tmp * -0.16666666666666666) +
-                 -(t27 * t1483 / 6.0)) +
-                t343 * a_tmp_tmp / 6.0) +
-               t151 * a_tmp_tmp * -0.16666666666666666) +
-              -(t363 * a_tmp_tmp / 6.0))) +
-      t39 * (((((((((((t3517_tmp * t750 / 8.0 + b_t3515_tmp * t757 / 8.0) + b_t3512_tmp * t824 / 8.0) +
-                     t342 * b_a_tmp_tmp / 8.0) +
-                    t153 * b_a_tmp_tmp * -0.125) +
-                   -(t364 * b_a_tmp_tmp / 8.0)) +
-                  t626_tmp * a_tmp_tmp / 8.0) +
-                 t152 * a_tmp_tmp * -0.125) +
-                -(t265 * a_tmp_tmp / 8.0)) +
-               t363 * t1483 / 8.0) +
-              t343 * t1488 / 8.0) +
-             t151 * i_a_tmp / 8.0);
+      ((((((t8 * ((t154 / AccScalar(2.0) + t157 / AccScalar(2.0)) + t159 / AccScalar(2.0)) +
+            t10 * (((((t322 / AccScalar(8.0) + t6 * t102 / AccScalar(4.0)) + t319 / AccScalar(8.0)) + t28 * a_tmp_tmp / AccScalar(4.0)) + t26 * a_tmp_tmp / AccScalar(4.0)) +
+                   t27 * a_tmp_tmp / AccScalar(4.0))) +
+           t41 * ((t364 * t1504 * r10 + t342 * t1517 * r10) + t153 * t2990_tmp * r10)) +
+          -(t11 * (((((-(t765_tmp * t892 * r5) + t3524_tmp * t892 * r5) + t857_tmp * t892 * r5) +
+                     -(t762_tmp * a_tmp_tmp * r5)) +
+                    t3515_tmp * a_tmp_tmp * r5) +
+                   t854_tmp * a_tmp_tmp * r5))) +
+         -t40 * (((((-(b_t3524_tmp * t1483 * r9) - b_t3515_tmp * t1504 * r9) + t3521_tmp * t1488 * r9) +
+                   b_t3512_tmp * t1517 * r9) +
+                  t540_tmp * i_a_tmp * r9) +
+                 t3517_tmp * t2990_tmp * r9)) +
+        -(t13 * (((((((((((-(t3517_tmp * b_a_tmp_tmp * r7) + b_t3515_tmp * b_a_tmp_tmp * r7) +
+                          -(t540_tmp * a_tmp_tmp * r7)) +
+                         b_t3524_tmp * a_tmp_tmp * r7) +
+                        b_t3512_tmp * b_a_tmp_tmp * r7) +
+                       t3521_tmp * a_tmp_tmp * r7) +
+                      t765_tmp * t3512_tmp * r7) +
+                     -(t3524_tmp * t1474 * r7)) +
+                    t762_tmp * i_a_tmp * r7) +
+                   -(t3515_tmp * t1483 * r7)) +
+                  t857_tmp * t1479 * r7) +
+                 t854_tmp * t1488 * r7))) +
+       t12 * (((((((((((t762_tmp * t738 * r6 + t3515_tmp * t747 * r6) + t854_tmp * t788 * r6) +
+                      t20 * (((((t211 - t214) + t242) + t269) + t368) + t394) * b_a_tmp_tmp * r6) +
+                     t21 * (((((t211 - t214) + t242) + t269) + t368) + t394) * b_a_tmp_tmp * r6) +
+                    t22 * (((((t211 - t214) + t242) + t269) + t368) + t394) * b_a_tmp_tmp * r6) +
+                   t28 * t1488 * r6) +
+                  t26 * i_a_tmp * -AccScalar(0.16666666666666666)) +
+                 -(t27 * t1483 * r6)) +
+                t343 * a_tmp_tmp * r6) +
+               t151 * a_tmp_tmp * -AccScalar(0.16666666666666666)) +
+              -(t363 * a_tmp_tmp * r6))) +
+      t39 * (((((((((((t3517_tmp * t750 / AccScalar(8.0) + b_t3515_tmp * t757 / AccScalar(8.0)) + b_t3512_tmp * t824 / AccScalar(8.0)) +
+                     t342 * b_a_tmp_tmp / AccScalar(8.0)) +
+                    t153 * b_a_tmp_tmp * -AccScalar(0.125)) +
+                   -(t364 * b_a_tmp_tmp / AccScalar(8.0))) +
+                  t626_tmp * a_tmp_tmp / AccScalar(8.0)) +
+                 t152 * a_tmp_tmp * -AccScalar(0.125)) +
+                -(t265 * a_tmp_tmp / AccScalar(8.0))) +
+               t363 * t1483 / AccScalar(8.0)) +
+              t343 * t1488 / AccScalar(8.0)) +
+             t151 * i_a_tmp / AccScalar(8.0));
   t2 = t17 * t95;
   t162_tmp = t15 * t106;
   t68 = t14 * t113;
@@ -1556,472 +1581,472 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t88 = t18 * t106;
   t90 = t19 * t264;
   t33 =
-      ((((((t8 * ((t162_tmp / 2.0 + t68 / 2.0) + t89 / 2.0) +
-            t10 * (((((t88 / 8.0 + t2 * t101 / 4.0) + t90 / 8.0) + t318 * d_a_tmp / 4.0) + t168 * d_a_tmp / 4.0) +
-                   t183_tmp * d_a_tmp / 4.0)) +
-           t41 * ((t630_tmp * t1505 / 10.0 + b_t340_tmp * t2989_tmp / 10.0) + e_t3511_tmp * t1515 / 10.0)) +
-          t11 * (((((t129 * a_tmp * -0.2 + t3518_tmp * d_a_tmp * -0.2) + t779_tmp * a_tmp / 5.0) +
-                   t3520_tmp * a_tmp / 5.0) +
-                  t776_tmp * d_a_tmp / 5.0) +
-                 b_t3511_tmp * d_a_tmp / 5.0)) +
-         -t40 * (((((-(t315_tmp * t1484 / 9.0) - t3516_tmp * t1505 / 9.0) + b_t3520_tmp * t1486 / 9.0) +
-                   c_t3511_tmp * t1515 / 9.0) +
-                  t127 * j_a_tmp / 9.0) +
-                 b_t3518_tmp * t2989_tmp / 9.0)) +
+      ((((((t8 * ((t162_tmp / AccScalar(2.0) + t68 / AccScalar(2.0)) + t89 / AccScalar(2.0)) +
+            t10 * (((((t88 / AccScalar(8.0) + t2 * t101 / AccScalar(4.0)) + t90 / AccScalar(8.0)) + t318 * d_a_tmp / AccScalar(4.0)) + t168 * d_a_tmp / AccScalar(4.0)) +
+                   t183_tmp * d_a_tmp / AccScalar(4.0))) +
+           t41 * ((t630_tmp * t1505 * r10 + b_t340_tmp * t2989_tmp * r10) + e_t3511_tmp * t1515 * r10)) +
+          t11 * (((((t129 * a_tmp * -AccScalar(0.2) + t3518_tmp * d_a_tmp * -AccScalar(0.2)) + t779_tmp * a_tmp * r5) +
+                   t3520_tmp * a_tmp * r5) +
+                  t776_tmp * d_a_tmp * r5) +
+                 b_t3511_tmp * d_a_tmp * r5)) +
+         -t40 * (((((-(t315_tmp * t1484 * r9) - t3516_tmp * t1505 * r9) + b_t3520_tmp * t1486 * r9) +
+                   c_t3511_tmp * t1515 * r9) +
+                  t127 * j_a_tmp * r9) +
+                 b_t3518_tmp * t2989_tmp * r9)) +
         -(t13 *
-          (((((((((((b_t3518_tmp * f_a_tmp / 7.0 + t3516_tmp * f_a_tmp * -0.14285714285714285) + t127 * d_a_tmp / 7.0) +
-                   t315_tmp * d_a_tmp * -0.14285714285714285) +
-                  c_t3511_tmp * f_a_tmp * -0.14285714285714285) +
-                 b_t3520_tmp * d_a_tmp * -0.14285714285714285) +
-                t129 * t3511_tmp / 7.0) +
-               -(t779_tmp * t1475 / 7.0)) +
-              t3518_tmp * j_a_tmp / 7.0) +
-             -(t776_tmp * t1484 / 7.0)) +
-            t3520_tmp * t1477 / 7.0) +
-           b_t3511_tmp * t1486 / 7.0))) +
-       t12 * (((((((((((t3518_tmp * t736 / 6.0 + t776_tmp * t745 / 6.0) + b_t3511_tmp * t789 / 6.0) +
-                      t539_tmp * f_a_tmp / 6.0) +
-                     b_a_tmp * f_a_tmp / 6.0) +
-                    d_t3511_tmp * f_a_tmp / 6.0) +
-                   t318 * j_a_tmp / 6.0) +
-                  t362 * a_tmp / 6.0) +
-                 c_t3520_tmp * a_tmp * -0.16666666666666666) +
-                t555_tmp * d_a_tmp / 6.0) +
-               t70 * d_a_tmp / 6.0) +
-              f_t3511_tmp * d_a_tmp * -0.16666666666666666)) +
-      t39 * (((((((((((b_t3518_tmp * t748 / 8.0 + t3516_tmp * t755 / 8.0) + c_t3511_tmp * t825 / 8.0) +
-                     b_t340_tmp * f_a_tmp / 8.0) +
-                    t630_tmp * f_a_tmp / 8.0) +
-                   e_t3511_tmp * f_a_tmp * -0.125) +
-                  t323 * d_a_tmp / 8.0) +
-                 t538_tmp_tmp * d_a_tmp / 8.0) +
-                d_t3520_tmp * d_a_tmp * -0.125) +
-               t70 * t1484 / 8.0) +
-              t555_tmp * j_a_tmp / 8.0) +
-             f_t3511_tmp * t1486 / 8.0);
+          (((((((((((b_t3518_tmp * f_a_tmp * r7 + t3516_tmp * f_a_tmp * -AccScalar(0.14285714285714285)) + t127 * d_a_tmp * r7) +
+                   t315_tmp * d_a_tmp * -AccScalar(0.14285714285714285)) +
+                  c_t3511_tmp * f_a_tmp * -AccScalar(0.14285714285714285)) +
+                 b_t3520_tmp * d_a_tmp * -AccScalar(0.14285714285714285)) +
+                t129 * t3511_tmp * r7) +
+               -(t779_tmp * t1475 * r7)) +
+              t3518_tmp * j_a_tmp * r7) +
+             -(t776_tmp * t1484 * r7)) +
+            t3520_tmp * t1477 * r7) +
+           b_t3511_tmp * t1486 * r7))) +
+       t12 * (((((((((((t3518_tmp * t736 * r6 + t776_tmp * t745 * r6) + b_t3511_tmp * t789 * r6) +
+                      t539_tmp * f_a_tmp * r6) +
+                     b_a_tmp * f_a_tmp * r6) +
+                    d_t3511_tmp * f_a_tmp * r6) +
+                   t318 * j_a_tmp * r6) +
+                  t362 * a_tmp * r6) +
+                 c_t3520_tmp * a_tmp * -AccScalar(0.16666666666666666)) +
+                t555_tmp * d_a_tmp * r6) +
+               t70 * d_a_tmp * r6) +
+              f_t3511_tmp * d_a_tmp * -AccScalar(0.16666666666666666))) +
+      t39 * (((((((((((b_t3518_tmp * t748 / AccScalar(8.0) + t3516_tmp * t755 / AccScalar(8.0)) + c_t3511_tmp * t825 / AccScalar(8.0)) +
+                     b_t340_tmp * f_a_tmp / AccScalar(8.0)) +
+                    t630_tmp * f_a_tmp / AccScalar(8.0)) +
+                   e_t3511_tmp * f_a_tmp * -AccScalar(0.125)) +
+                  t323 * d_a_tmp / AccScalar(8.0)) +
+                 t538_tmp_tmp * d_a_tmp / AccScalar(8.0)) +
+                d_t3520_tmp * d_a_tmp * -AccScalar(0.125)) +
+               t70 * t1484 / AccScalar(8.0)) +
+              t555_tmp * j_a_tmp / AccScalar(8.0)) +
+             f_t3511_tmp * t1486 / AccScalar(8.0));
   t31 = t2 * t203;
   t32 =
       ((((((-t721 +
-            -t10 * (((((t7 / 8.0 + t31 / 4.0) - t473) + t28 * d_a_tmp / 4.0) + t26 * d_a_tmp / 4.0) +
-                    t27 * d_a_tmp / 4.0)) +
-           -(t41 * ((t538_tmp_tmp * i_a_tmp * -0.1 + t364 * t1515 / 10.0) + t342 * t2989_tmp / 10.0))) +
-          t11 * (((((t129 * t892 / 5.0 - t779_tmp * t892 / 5.0) - t3520_tmp * t892 / 5.0) + t762_tmp * d_a_tmp * -0.2) +
-                  t3515_tmp * d_a_tmp / 5.0) +
-                 t854_tmp * d_a_tmp / 5.0)) +
-         t40 * (((((-(t3517_tmp * t1505 / 9.0) + t127 * t1488 / 9.0) - b_t3515_tmp * t1515 / 9.0) +
-                  b_t3520_tmp * t1483 / 9.0) +
-                 t315_tmp * i_a_tmp / 9.0) +
-                b_t3512_tmp * t2989_tmp / 9.0)) +
-        t13 * (((((((((((t3517_tmp * f_a_tmp * -0.14285714285714285 + t127 * a_tmp_tmp / 7.0) -
-                        t315_tmp * a_tmp_tmp / 7.0) -
-                       b_t3520_tmp * a_tmp_tmp / 7.0) +
-                      t129 * t1479 / 7.0) -
-                     t762_tmp * t1484 / 7.0) -
-                    t3515_tmp * t1486 / 7.0) +
-                   t3520_tmp * t1474 / 7.0) +
-                  t779_tmp * t3512_tmp / 7.0) +
-                 t854_tmp * j_a_tmp / 7.0) +
-                b_t3515_tmp * f_a_tmp / 7.0) +
-               b_t3512_tmp * f_a_tmp / 7.0)) +
-       -t12 * (((((((((((t762_tmp * t745 / 6.0 + t129 * t785 / 6.0) - t3515_tmp * t789 / 6.0) + t26 * t1484 / 6.0) -
-                      t27 * t1486 / 6.0) +
-                     t363 * d_a_tmp * -0.16666666666666666) -
-                    t151 * d_a_tmp / 6.0) +
-                   t28 * j_a_tmp / 6.0) +
-                  t343 * d_a_tmp / 6.0) +
-                 t321 * a_tmp_tmp / 6.0) +
-                t128 * a_tmp_tmp / 6.0) +
-               e_t3520_tmp * a_tmp_tmp / 6.0)) +
-      -(t39 * (((((((((((t3517_tmp * t755 / 8.0 + t127 * t788 / 8.0) + -(b_t3515_tmp * t825 / 8.0)) +
-                       t364 * f_a_tmp * -0.125) +
-                      t342 * f_a_tmp / 8.0) +
-                     -(t153 * f_a_tmp / 8.0)) +
-                    t538_tmp_tmp * a_tmp_tmp / 8.0) +
-                   t323 * a_tmp_tmp / 8.0) +
-                  -(d_t3520_tmp * a_tmp_tmp / 8.0)) +
-                 t362 * t3512_tmp * -0.125) +
-                t363 * t1486 / 8.0) +
-               t343 * j_a_tmp / 8.0));
+            -t10 * (((((t7 / AccScalar(8.0) + t31 / AccScalar(4.0)) - t473) + t28 * d_a_tmp / AccScalar(4.0)) + t26 * d_a_tmp / AccScalar(4.0)) +
+                    t27 * d_a_tmp / AccScalar(4.0))) +
+           -(t41 * ((t538_tmp_tmp * i_a_tmp * -AccScalar(0.1) + t364 * t1515 * r10) + t342 * t2989_tmp * r10))) +
+          t11 * (((((t129 * t892 * r5 - t779_tmp * t892 * r5) - t3520_tmp * t892 * r5) + t762_tmp * d_a_tmp * -AccScalar(0.2)) +
+                  t3515_tmp * d_a_tmp * r5) +
+                 t854_tmp * d_a_tmp * r5)) +
+         t40 * (((((-(t3517_tmp * t1505 * r9) + t127 * t1488 * r9) - b_t3515_tmp * t1515 * r9) +
+                  b_t3520_tmp * t1483 * r9) +
+                 t315_tmp * i_a_tmp * r9) +
+                b_t3512_tmp * t2989_tmp * r9)) +
+        t13 * (((((((((((t3517_tmp * f_a_tmp * -AccScalar(0.14285714285714285) + t127 * a_tmp_tmp * r7) -
+                        t315_tmp * a_tmp_tmp * r7) -
+                       b_t3520_tmp * a_tmp_tmp * r7) +
+                      t129 * t1479 * r7) -
+                     t762_tmp * t1484 * r7) -
+                    t3515_tmp * t1486 * r7) +
+                   t3520_tmp * t1474 * r7) +
+                  t779_tmp * t3512_tmp * r7) +
+                 t854_tmp * j_a_tmp * r7) +
+                b_t3515_tmp * f_a_tmp * r7) +
+               b_t3512_tmp * f_a_tmp * r7)) +
+       -t12 * (((((((((((t762_tmp * t745 * r6 + t129 * t785 * r6) - t3515_tmp * t789 * r6) + t26 * t1484 * r6) -
+                      t27 * t1486 * r6) +
+                     t363 * d_a_tmp * -AccScalar(0.16666666666666666)) -
+                    t151 * d_a_tmp * r6) +
+                   t28 * j_a_tmp * r6) +
+                  t343 * d_a_tmp * r6) +
+                 t321 * a_tmp_tmp * r6) +
+                t128 * a_tmp_tmp * r6) +
+               e_t3520_tmp * a_tmp_tmp * r6)) +
+      -(t39 * (((((((((((t3517_tmp * t755 / AccScalar(8.0) + t127 * t788 / AccScalar(8.0)) + -(b_t3515_tmp * t825 / AccScalar(8.0))) +
+                       t364 * f_a_tmp * -AccScalar(0.125)) +
+                      t342 * f_a_tmp / AccScalar(8.0)) +
+                     -(t153 * f_a_tmp / AccScalar(8.0))) +
+                    t538_tmp_tmp * a_tmp_tmp / AccScalar(8.0)) +
+                   t323 * a_tmp_tmp / AccScalar(8.0)) +
+                  -(d_t3520_tmp * a_tmp_tmp / AccScalar(8.0))) +
+                 t362 * t3512_tmp * -AccScalar(0.125)) +
+                t363 * t1486 / AccScalar(8.0)) +
+               t343 * j_a_tmp / AccScalar(8.0)));
   t4 = t6 * t97;
   t34 = ((((((-t721 +
-              -t10 * (((((t4 / 4.0 - t473) + t3 / 8.0) + t318 * a_tmp_tmp / 4.0) + t168 * a_tmp_tmp / 4.0) +
-                      t183_tmp * a_tmp_tmp / 4.0)) +
-             -(t41 * ((t630_tmp * t2990_tmp * -0.1 + e_t3511_tmp * t1504 / 10.0) + t626_tmp * j_a_tmp / 10.0))) +
-            -(t11 * (((((t765_tmp * a_tmp / 5.0 + t3524_tmp * a_tmp * -0.2) + t857_tmp * a_tmp * -0.2) +
-                       -(t3518_tmp * a_tmp_tmp / 5.0)) +
-                      t776_tmp * a_tmp_tmp / 5.0) +
-                     b_t3511_tmp * a_tmp_tmp / 5.0))) +
-           t40 * (((((-(t540_tmp * t1484 / 9.0) + b_t3518_tmp * t1517 / 9.0) - b_t3524_tmp * t1486 / 9.0) +
-                    c_t3511_tmp * t1504 / 9.0) +
-                   t3516_tmp * t2990_tmp / 9.0) +
-                  t3521_tmp * j_a_tmp / 9.0)) +
-          t13 * (((((((((((b_t3518_tmp * b_a_tmp_tmp / 7.0 - t3516_tmp * b_a_tmp_tmp / 7.0) +
-                          t540_tmp * d_a_tmp * -0.14285714285714285) -
-                         c_t3511_tmp * b_a_tmp_tmp / 7.0) -
-                        t765_tmp * t1475 / 7.0) -
-                       t3524_tmp * t1477 / 7.0) +
-                      t3518_tmp * t1488 / 7.0) +
-                     b_t3511_tmp * t1483 / 7.0) +
-                    t857_tmp * t3511_tmp / 7.0) +
-                   t776_tmp * i_a_tmp / 7.0) +
-                  b_t3524_tmp * d_a_tmp / 7.0) +
-                 t3521_tmp * d_a_tmp / 7.0)) +
-         -t12 * (((((((((((t765_tmp * t742 / 6.0 + t3518_tmp * t788 / 6.0) - t3524_tmp * t786 / 6.0) +
-                         t108 * a_tmp * -0.16666666666666666) -
-                        t168 * i_a_tmp / 6.0) +
-                       t70 * a_tmp_tmp / 6.0) -
-                      f_t3511_tmp * a_tmp_tmp / 6.0) +
-                     t555_tmp * a_tmp_tmp / 6.0) +
-                    t72 * a_tmp / 6.0) +
-                   t539_tmp * b_a_tmp_tmp / 6.0) +
-                  b_a_tmp * b_a_tmp_tmp / 6.0) +
-                 d_t3511_tmp * b_a_tmp_tmp / 6.0)) +
-        -(t39 * (((((((((((t3516_tmp * t750 / 8.0 + b_t3518_tmp * t824 / 8.0) + -(b_t3524_tmp * t789 / 8.0)) +
-                         t630_tmp * b_a_tmp_tmp / 8.0) +
-                        b_t340_tmp * b_a_tmp_tmp / 8.0) +
-                       -(e_t3511_tmp * b_a_tmp_tmp / 8.0)) +
-                      t265 * d_a_tmp * -0.125) +
-                     t626_tmp * d_a_tmp / 8.0) +
-                    -(t152 * d_a_tmp / 8.0)) +
-                   t70 * i_a_tmp * -0.125) +
-                  f_t3511_tmp * t1483 / 8.0) +
-                 t72 * t3511_tmp / 8.0));
+              -t10 * (((((t4 / AccScalar(4.0) - t473) + t3 / AccScalar(8.0)) + t318 * a_tmp_tmp / AccScalar(4.0)) + t168 * a_tmp_tmp / AccScalar(4.0)) +
+                      t183_tmp * a_tmp_tmp / AccScalar(4.0))) +
+             -(t41 * ((t630_tmp * t2990_tmp * -AccScalar(0.1) + e_t3511_tmp * t1504 * r10) + t626_tmp * j_a_tmp * r10))) +
+            -(t11 * (((((t765_tmp * a_tmp * r5 + t3524_tmp * a_tmp * -AccScalar(0.2)) + t857_tmp * a_tmp * -AccScalar(0.2)) +
+                       -(t3518_tmp * a_tmp_tmp * r5)) +
+                      t776_tmp * a_tmp_tmp * r5) +
+                     b_t3511_tmp * a_tmp_tmp * r5))) +
+           t40 * (((((-(t540_tmp * t1484 * r9) + b_t3518_tmp * t1517 * r9) - b_t3524_tmp * t1486 * r9) +
+                    c_t3511_tmp * t1504 * r9) +
+                   t3516_tmp * t2990_tmp * r9) +
+                  t3521_tmp * j_a_tmp * r9)) +
+          t13 * (((((((((((b_t3518_tmp * b_a_tmp_tmp * r7 - t3516_tmp * b_a_tmp_tmp * r7) +
+                          t540_tmp * d_a_tmp * -AccScalar(0.14285714285714285)) -
+                         c_t3511_tmp * b_a_tmp_tmp * r7) -
+                        t765_tmp * t1475 * r7) -
+                       t3524_tmp * t1477 * r7) +
+                      t3518_tmp * t1488 * r7) +
+                     b_t3511_tmp * t1483 * r7) +
+                    t857_tmp * t3511_tmp * r7) +
+                   t776_tmp * i_a_tmp * r7) +
+                  b_t3524_tmp * d_a_tmp * r7) +
+                 t3521_tmp * d_a_tmp * r7)) +
+         -t12 * (((((((((((t765_tmp * t742 * r6 + t3518_tmp * t788 * r6) - t3524_tmp * t786 * r6) +
+                         t108 * a_tmp * -AccScalar(0.16666666666666666)) -
+                        t168 * i_a_tmp * r6) +
+                       t70 * a_tmp_tmp * r6) -
+                      f_t3511_tmp * a_tmp_tmp * r6) +
+                     t555_tmp * a_tmp_tmp * r6) +
+                    t72 * a_tmp * r6) +
+                   t539_tmp * b_a_tmp_tmp * r6) +
+                  b_a_tmp * b_a_tmp_tmp * r6) +
+                 d_t3511_tmp * b_a_tmp_tmp * r6)) +
+        -(t39 * (((((((((((t3516_tmp * t750 / AccScalar(8.0) + b_t3518_tmp * t824 / AccScalar(8.0)) + -(b_t3524_tmp * t789 / AccScalar(8.0))) +
+                         t630_tmp * b_a_tmp_tmp / AccScalar(8.0)) +
+                        b_t340_tmp * b_a_tmp_tmp / AccScalar(8.0)) +
+                       -(e_t3511_tmp * b_a_tmp_tmp / AccScalar(8.0))) +
+                      t265 * d_a_tmp * -AccScalar(0.125)) +
+                     t626_tmp * d_a_tmp / AccScalar(8.0)) +
+                    -(t152 * d_a_tmp / AccScalar(8.0))) +
+                   t70 * i_a_tmp * -AccScalar(0.125)) +
+                  f_t3511_tmp * t1483 / AccScalar(8.0)) +
+                 t72 * t3511_tmp / AccScalar(8.0)));
   t35 = y_t3531_tmp * t98;
   t30 = ((((((-t722 +
-              t10 * (((((-(t35 / 4.0) + t469) - t5 / 8.0) + t28 * e_a_tmp / 4.0) + t26 * e_a_tmp / 4.0) +
-                     t27 * e_a_tmp / 4.0)) +
-             -(t41 * ((t342 * t1506 / 10.0 + t364 * t2991_tmp * -0.1) + r_t3531_tmp * i_a_tmp / 10.0))) +
-            -t11 * (((((-(t766_tmp * t892 / 5.0) + c_t3531_tmp * t892 / 5.0) + t858_tmp * t892 / 5.0) +
-                      t762_tmp * e_a_tmp * -0.2) +
-                     t3515_tmp * e_a_tmp / 5.0) +
-                    t854_tmp * e_a_tmp / 5.0)) +
-           t40 * (((((-(b_t3531_tmp * t1483 / 9.0) + t3517_tmp * t1516 / 9.0) - e_t3531_tmp * t1488 / 9.0) +
-                    b_t3512_tmp * t1506 / 9.0) +
-                   h_t3531_tmp * i_a_tmp / 9.0) +
-                  b_t3515_tmp * t2991_tmp / 9.0)) +
-          t13 * (((((((((((b_t3515_tmp * g_a_tmp * -0.14285714285714285 + b_t3531_tmp * a_tmp_tmp / 7.0) -
-                          e_t3531_tmp * a_tmp_tmp / 7.0) +
-                         b_t3512_tmp * g_a_tmp * -0.14285714285714285) -
-                        h_t3531_tmp * a_tmp_tmp / 7.0) -
-                       t766_tmp * t1474 / 7.0) -
-                      c_t3531_tmp * t1479 / 7.0) +
-                     t762_tmp * t1487 / 7.0) +
-                    t854_tmp * t1485 / 7.0) +
-                   t858_tmp * t3512_tmp / 7.0) +
-                  t3515_tmp * h_a_tmp / 7.0) +
-                 t3517_tmp * g_a_tmp / 7.0)) +
-         -(t12 * (((((((((((t766_tmp * t744 / 6.0 + t762_tmp * t787 / 6.0) + -(c_t3531_tmp * t785 / 6.0)) +
-                          t627_tmp * a_tmp_tmp * -0.16666666666666666) +
-                         t3519_tmp * a_tmp_tmp * -0.16666666666666666) +
-                        t552_tmp * a_tmp_tmp * -0.16666666666666666) +
-                       t28 * t1485 / 6.0) +
-                      -(t26 * t1487 / 6.0)) +
-                     t27 * h_a_tmp / 6.0) +
-                    t343 * e_a_tmp * -0.16666666666666666) +
-                   t151 * e_a_tmp / 6.0) +
-                  t363 * e_a_tmp / 6.0))) +
-        -(t39 * (((((((((((b_t3515_tmp * t749 / 8.0 + t3517_tmp * t823 / 8.0) + -(e_t3531_tmp * t788 / 8.0)) +
-                         t342 * g_a_tmp * -0.125) +
-                        t153 * g_a_tmp / 8.0) +
-                       t364 * g_a_tmp / 8.0) +
-                      x_t3531_tmp * a_tmp_tmp / 8.0) +
-                     -(r_t3531_tmp * a_tmp_tmp / 8.0)) +
-                    v_t3531_tmp * a_tmp_tmp / 8.0) +
-                   t343 * t1485 / 8.0) +
-                  t363 * h_a_tmp * -0.125) +
-                 q_t3531_tmp * t3512_tmp / 8.0));
+              t10 * (((((-(t35 / AccScalar(4.0)) + t469) - t5 / AccScalar(8.0)) + t28 * e_a_tmp / AccScalar(4.0)) + t26 * e_a_tmp / AccScalar(4.0)) +
+                     t27 * e_a_tmp / AccScalar(4.0))) +
+             -(t41 * ((t342 * t1506 * r10 + t364 * t2991_tmp * -AccScalar(0.1)) + r_t3531_tmp * i_a_tmp * r10))) +
+            -t11 * (((((-(t766_tmp * t892 * r5) + c_t3531_tmp * t892 * r5) + t858_tmp * t892 * r5) +
+                      t762_tmp * e_a_tmp * -AccScalar(0.2)) +
+                     t3515_tmp * e_a_tmp * r5) +
+                    t854_tmp * e_a_tmp * r5)) +
+           t40 * (((((-(b_t3531_tmp * t1483 * r9) + t3517_tmp * t1516 * r9) - e_t3531_tmp * t1488 * r9) +
+                    b_t3512_tmp * t1506 * r9) +
+                   h_t3531_tmp * i_a_tmp * r9) +
+                  b_t3515_tmp * t2991_tmp * r9)) +
+          t13 * (((((((((((b_t3515_tmp * g_a_tmp * -AccScalar(0.14285714285714285) + b_t3531_tmp * a_tmp_tmp * r7) -
+                          e_t3531_tmp * a_tmp_tmp * r7) +
+                         b_t3512_tmp * g_a_tmp * -AccScalar(0.14285714285714285)) -
+                        h_t3531_tmp * a_tmp_tmp * r7) -
+                       t766_tmp * t1474 * r7) -
+                      c_t3531_tmp * t1479 * r7) +
+                     t762_tmp * t1487 * r7) +
+                    t854_tmp * t1485 * r7) +
+                   t858_tmp * t3512_tmp * r7) +
+                  t3515_tmp * h_a_tmp * r7) +
+                 t3517_tmp * g_a_tmp * r7)) +
+         -(t12 * (((((((((((t766_tmp * t744 * r6 + t762_tmp * t787 * r6) + -(c_t3531_tmp * t785 * r6)) +
+                          t627_tmp * a_tmp_tmp * -AccScalar(0.16666666666666666)) +
+                         t3519_tmp * a_tmp_tmp * -AccScalar(0.16666666666666666)) +
+                        t552_tmp * a_tmp_tmp * -AccScalar(0.16666666666666666)) +
+                       t28 * t1485 * r6) +
+                      -(t26 * t1487 * r6)) +
+                     t27 * h_a_tmp * r6) +
+                    t343 * e_a_tmp * -AccScalar(0.16666666666666666)) +
+                   t151 * e_a_tmp * r6) +
+                  t363 * e_a_tmp * r6))) +
+        -(t39 * (((((((((((b_t3515_tmp * t749 / AccScalar(8.0) + t3517_tmp * t823 / AccScalar(8.0)) + -(e_t3531_tmp * t788 / AccScalar(8.0))) +
+                         t342 * g_a_tmp * -AccScalar(0.125)) +
+                        t153 * g_a_tmp / AccScalar(8.0)) +
+                       t364 * g_a_tmp / AccScalar(8.0)) +
+                      x_t3531_tmp * a_tmp_tmp / AccScalar(8.0)) +
+                     -(r_t3531_tmp * a_tmp_tmp / AccScalar(8.0))) +
+                    v_t3531_tmp * a_tmp_tmp / AccScalar(8.0)) +
+                   t343 * t1485 / AccScalar(8.0)) +
+                  t363 * h_a_tmp * -AccScalar(0.125)) +
+                 q_t3531_tmp * t3512_tmp / AccScalar(8.0)));
   t7 = t6 * t202;
   t29 = ((((((-t722 +
-              t10 * (((((-(t29 / 8.0) - t7 / 4.0) + t469) + ab_t3531_tmp * a_tmp_tmp / 4.0) +
-                      bb_t3531_tmp * a_tmp_tmp / 4.0) +
-                     cb_t3531_tmp * a_tmp_tmp / 4.0)) +
-             -(t41 * ((j_t3531_tmp * t1517 / 10.0 + t265 * h_a_tmp * -0.1) + k_t3531_tmp * t2990_tmp / 10.0))) +
-            -t11 * (((((t765_tmp * c_a_tmp * -0.2 - t763_tmp * a_tmp_tmp / 5.0) + d_t3531_tmp * a_tmp_tmp / 5.0) +
-                      t855_tmp * a_tmp_tmp / 5.0) +
-                     t3524_tmp * c_a_tmp / 5.0) +
-                    t857_tmp * c_a_tmp / 5.0)) +
-           t40 * (((((-(t3531_tmp * t1504 / 9.0) + t540_tmp * t1487 / 9.0) - f_t3531_tmp * t1517 / 9.0) +
-                    t3521_tmp * t1485 / 9.0) +
-                   g_t3531_tmp * t2990_tmp / 9.0) +
-                  b_t3524_tmp * h_a_tmp / 9.0)) +
-          t13 * (((((((((((t3531_tmp * b_a_tmp_tmp / 7.0 - f_t3531_tmp * b_a_tmp_tmp / 7.0) +
-                          b_t3524_tmp * e_a_tmp * -0.14285714285714285) -
-                         g_t3531_tmp * b_a_tmp_tmp / 7.0) +
-                        t3521_tmp * e_a_tmp * -0.14285714285714285) +
-                       t765_tmp * t1478 / 7.0) -
-                      t763_tmp * t1483 / 7.0) -
-                     d_t3531_tmp * t1488 / 7.0) +
-                    t857_tmp * t1476 / 7.0) +
-                   t855_tmp * i_a_tmp / 7.0) +
-                  t3524_tmp * i_t3531_tmp / 7.0) +
-                 t540_tmp * e_a_tmp / 7.0)) +
-         -(t12 * (((((((((((t763_tmp * t747 / 6.0 + t765_tmp * t784 / 6.0) + -(d_t3531_tmp * t788 / 6.0)) +
-                          t_t3531_tmp * b_a_tmp_tmp * -0.16666666666666666) +
-                         p_t3531_tmp * b_a_tmp_tmp * -0.16666666666666666) +
-                        s_t3531_tmp * b_a_tmp_tmp * -0.16666666666666666) +
-                       t72 * c_a_tmp * -0.16666666666666666) +
-                      t341 * c_a_tmp / 6.0) +
-                     t108 * c_a_tmp / 6.0) +
-                    m_t3531_tmp * a_tmp_tmp / 6.0) +
-                   -(n_t3531_tmp * a_tmp_tmp / 6.0)) +
-                  o_t3531_tmp * a_tmp_tmp / 6.0))) +
-        -(t39 * (((((((((((t3531_tmp * t757 / 8.0 + t540_tmp * t787 / 8.0) + -(f_t3531_tmp * t824 / 8.0)) +
-                         j_t3531_tmp * b_a_tmp_tmp / 8.0) +
-                        -(k_t3531_tmp * b_a_tmp_tmp / 8.0)) +
-                       l_t3531_tmp * b_a_tmp_tmp / 8.0) +
-                      t626_tmp * e_a_tmp * -0.125) +
-                     t152 * e_a_tmp / 8.0) +
-                    t265 * e_a_tmp / 8.0) +
-                   m_t3531_tmp * t1488 / 8.0) +
-                  t108 * i_t3531_tmp * -0.125) +
-                 n_t3531_tmp * i_a_tmp / 8.0));
+              t10 * (((((-(t29 / AccScalar(8.0)) - t7 / AccScalar(4.0)) + t469) + ab_t3531_tmp * a_tmp_tmp / AccScalar(4.0)) +
+                      bb_t3531_tmp * a_tmp_tmp / AccScalar(4.0)) +
+                     cb_t3531_tmp * a_tmp_tmp / AccScalar(4.0))) +
+             -(t41 * ((j_t3531_tmp * t1517 * r10 + t265 * h_a_tmp * -AccScalar(0.1)) + k_t3531_tmp * t2990_tmp * r10))) +
+            -t11 * (((((t765_tmp * c_a_tmp * -AccScalar(0.2) - t763_tmp * a_tmp_tmp * r5) + d_t3531_tmp * a_tmp_tmp * r5) +
+                      t855_tmp * a_tmp_tmp * r5) +
+                     t3524_tmp * c_a_tmp * r5) +
+                    t857_tmp * c_a_tmp * r5)) +
+           t40 * (((((-(t3531_tmp * t1504 * r9) + t540_tmp * t1487 * r9) - f_t3531_tmp * t1517 * r9) +
+                    t3521_tmp * t1485 * r9) +
+                   g_t3531_tmp * t2990_tmp * r9) +
+                  b_t3524_tmp * h_a_tmp * r9)) +
+          t13 * (((((((((((t3531_tmp * b_a_tmp_tmp * r7 - f_t3531_tmp * b_a_tmp_tmp * r7) +
+                          b_t3524_tmp * e_a_tmp * -AccScalar(0.14285714285714285)) -
+                         g_t3531_tmp * b_a_tmp_tmp * r7) +
+                        t3521_tmp * e_a_tmp * -AccScalar(0.14285714285714285)) +
+                       t765_tmp * t1478 * r7) -
+                      t763_tmp * t1483 * r7) -
+                     d_t3531_tmp * t1488 * r7) +
+                    t857_tmp * t1476 * r7) +
+                   t855_tmp * i_a_tmp * r7) +
+                  t3524_tmp * i_t3531_tmp * r7) +
+                 t540_tmp * e_a_tmp * r7)) +
+         -(t12 * (((((((((((t763_tmp * t747 * r6 + t765_tmp * t784 * r6) + -(d_t3531_tmp * t788 * r6)) +
+                          t_t3531_tmp * b_a_tmp_tmp * -AccScalar(0.16666666666666666)) +
+                         p_t3531_tmp * b_a_tmp_tmp * -AccScalar(0.16666666666666666)) +
+                        s_t3531_tmp * b_a_tmp_tmp * -AccScalar(0.16666666666666666)) +
+                       t72 * c_a_tmp * -AccScalar(0.16666666666666666)) +
+                      t341 * c_a_tmp * r6) +
+                     t108 * c_a_tmp * r6) +
+                    m_t3531_tmp * a_tmp_tmp * r6) +
+                   -(n_t3531_tmp * a_tmp_tmp * r6)) +
+                  o_t3531_tmp * a_tmp_tmp * r6))) +
+        -(t39 * (((((((((((t3531_tmp * t757 / AccScalar(8.0) + t540_tmp * t787 / AccScalar(8.0)) + -(f_t3531_tmp * t824 / AccScalar(8.0))) +
+                         j_t3531_tmp * b_a_tmp_tmp / AccScalar(8.0)) +
+                        -(k_t3531_tmp * b_a_tmp_tmp / AccScalar(8.0))) +
+                       l_t3531_tmp * b_a_tmp_tmp / AccScalar(8.0)) +
+                      t626_tmp * e_a_tmp * -AccScalar(0.125)) +
+                     t152 * e_a_tmp / AccScalar(8.0)) +
+                    t265 * e_a_tmp / AccScalar(8.0)) +
+                   m_t3531_tmp * t1488 / AccScalar(8.0)) +
+                  t108 * i_t3531_tmp * -AccScalar(0.125)) +
+                 n_t3531_tmp * i_a_tmp / AccScalar(8.0)));
   t28 = t2 * t99;
   t27 = ((((((-t723 +
               -(t10 *
-                (((((t28 / 4.0 + t481) + t67 / 8.0) + ab_t3531_tmp * d_a_tmp / 4.0) + bb_t3531_tmp * d_a_tmp / 4.0) +
-                 cb_t3531_tmp * d_a_tmp / 4.0))) +
-             -(t41 * ((j_t3531_tmp * t2989_tmp * -0.1 + k_t3531_tmp * t1505 / 10.0) + d_t3520_tmp * h_a_tmp / 10.0))) +
-            t11 * (((((t779_tmp * c_a_tmp * -0.2 + t3520_tmp * c_a_tmp * -0.2) + t763_tmp * d_a_tmp * -0.2) +
-                     t129 * c_a_tmp / 5.0) +
-                    d_t3531_tmp * d_a_tmp / 5.0) +
-                   t855_tmp * d_a_tmp / 5.0)) +
-           t40 * (((((-(t127 * t1485 / 9.0) + t3531_tmp * t1515 / 9.0) - t315_tmp * t1487 / 9.0) +
-                    g_t3531_tmp * t1505 / 9.0) +
-                   f_t3531_tmp * t2989_tmp / 9.0) +
-                  b_t3520_tmp * h_a_tmp / 9.0)) +
-          t13 * (((((((((((t3531_tmp * f_a_tmp * -0.14285714285714285 + t315_tmp * e_a_tmp * -0.14285714285714285) +
-                          b_t3520_tmp * e_a_tmp * -0.14285714285714285) -
-                         t129 * t1476 / 7.0) -
-                        t779_tmp * t1478 / 7.0) +
-                       t763_tmp * t1486 / 7.0) +
-                      t855_tmp * t1484 / 7.0) +
-                     d_t3531_tmp * j_a_tmp / 7.0) +
-                    t3520_tmp * i_t3531_tmp / 7.0) +
-                   t127 * e_a_tmp / 7.0) +
-                  f_t3531_tmp * f_a_tmp / 7.0) +
-                 g_t3531_tmp * f_a_tmp / 7.0)) +
-         -(t12 * (((((((((((t129 * t743 / 6.0 + t763_tmp * t789 / 6.0) + -(t779_tmp * t784 / 6.0)) +
-                          t_t3531_tmp * f_a_tmp / 6.0) +
-                         p_t3531_tmp * f_a_tmp / 6.0) +
-                        s_t3531_tmp * f_a_tmp / 6.0) +
-                       t155 * c_a_tmp / 6.0) +
-                      t362 * c_a_tmp / 6.0) +
-                     c_t3520_tmp * c_a_tmp * -0.16666666666666666) +
-                    m_t3531_tmp * d_a_tmp * -0.16666666666666666) +
-                   n_t3531_tmp * d_a_tmp / 6.0) +
-                  -(o_t3531_tmp * d_a_tmp / 6.0)))) +
-        -(t39 * (((((((((((f_t3531_tmp * t748 / 8.0 + t3531_tmp * t825 / 8.0) + -(t315_tmp * t787 / 8.0)) +
-                         j_t3531_tmp * f_a_tmp * -0.125) +
-                        k_t3531_tmp * f_a_tmp / 8.0) +
-                       -(l_t3531_tmp * f_a_tmp / 8.0)) +
-                      t323 * e_a_tmp / 8.0) +
-                     t538_tmp_tmp * e_a_tmp / 8.0) +
-                    d_t3520_tmp * e_a_tmp * -0.125) +
-                   m_t3531_tmp * j_a_tmp * -0.125) +
-                  n_t3531_tmp * t1484 / 8.0) +
-                 c_t3520_tmp * i_t3531_tmp / 8.0));
+                (((((t28 / AccScalar(4.0) + t481) + t67 / AccScalar(8.0)) + ab_t3531_tmp * d_a_tmp / AccScalar(4.0)) + bb_t3531_tmp * d_a_tmp / AccScalar(4.0)) +
+                 cb_t3531_tmp * d_a_tmp / AccScalar(4.0)))) +
+             -(t41 * ((j_t3531_tmp * t2989_tmp * -AccScalar(0.1) + k_t3531_tmp * t1505 * r10) + d_t3520_tmp * h_a_tmp * r10))) +
+            t11 * (((((t779_tmp * c_a_tmp * -AccScalar(0.2) + t3520_tmp * c_a_tmp * -AccScalar(0.2)) + t763_tmp * d_a_tmp * -AccScalar(0.2)) +
+                     t129 * c_a_tmp * r5) +
+                    d_t3531_tmp * d_a_tmp * r5) +
+                   t855_tmp * d_a_tmp * r5)) +
+           t40 * (((((-(t127 * t1485 * r9) + t3531_tmp * t1515 * r9) - t315_tmp * t1487 * r9) +
+                    g_t3531_tmp * t1505 * r9) +
+                   f_t3531_tmp * t2989_tmp * r9) +
+                  b_t3520_tmp * h_a_tmp * r9)) +
+          t13 * (((((((((((t3531_tmp * f_a_tmp * -AccScalar(0.14285714285714285) + t315_tmp * e_a_tmp * -AccScalar(0.14285714285714285)) +
+                          b_t3520_tmp * e_a_tmp * -AccScalar(0.14285714285714285)) -
+                         t129 * t1476 * r7) -
+                        t779_tmp * t1478 * r7) +
+                       t763_tmp * t1486 * r7) +
+                      t855_tmp * t1484 * r7) +
+                     d_t3531_tmp * j_a_tmp * r7) +
+                    t3520_tmp * i_t3531_tmp * r7) +
+                   t127 * e_a_tmp * r7) +
+                  f_t3531_tmp * f_a_tmp * r7) +
+                 g_t3531_tmp * f_a_tmp * r7)) +
+         -(t12 * (((((((((((t129 * t743 * r6 + t763_tmp * t789 * r6) + -(t779_tmp * t784 * r6)) +
+                          t_t3531_tmp * f_a_tmp * r6) +
+                         p_t3531_tmp * f_a_tmp * r6) +
+                        s_t3531_tmp * f_a_tmp * r6) +
+                       t155 * c_a_tmp * r6) +
+                      t362 * c_a_tmp * r6) +
+                     c_t3520_tmp * c_a_tmp * -AccScalar(0.16666666666666666)) +
+                    m_t3531_tmp * d_a_tmp * -AccScalar(0.16666666666666666)) +
+                   n_t3531_tmp * d_a_tmp * r6) +
+                  -(o_t3531_tmp * d_a_tmp * r6)))) +
+        -(t39 * (((((((((((f_t3531_tmp * t748 / AccScalar(8.0) + t3531_tmp * t825 / AccScalar(8.0)) + -(t315_tmp * t787 / AccScalar(8.0))) +
+                         j_t3531_tmp * f_a_tmp * -AccScalar(0.125)) +
+                        k_t3531_tmp * f_a_tmp / AccScalar(8.0)) +
+                       -(l_t3531_tmp * f_a_tmp / AccScalar(8.0))) +
+                      t323 * e_a_tmp / AccScalar(8.0)) +
+                     t538_tmp_tmp * e_a_tmp / AccScalar(8.0)) +
+                    d_t3520_tmp * e_a_tmp * -AccScalar(0.125)) +
+                   m_t3531_tmp * j_a_tmp * -AccScalar(0.125)) +
+                  n_t3531_tmp * t1484 / AccScalar(8.0)) +
+                 c_t3520_tmp * i_t3531_tmp / AccScalar(8.0)));
   t26 = y_t3531_tmp * t201;
   t5 = ((((((-t723 +
-             -(t10 * (((((t69 / 8.0 + t26 / 4.0) + t481) + t318 * e_a_tmp / 4.0) + t168 * e_a_tmp / 4.0) +
-                      t183_tmp * e_a_tmp / 4.0))) +
-            -(t41 * ((x_t3531_tmp * j_a_tmp * -0.1 + t630_tmp * t1516 / 10.0) + e_t3511_tmp * t2991_tmp / 10.0))) +
-           -(t11 * (((((t766_tmp * a_tmp / 5.0 + c_t3531_tmp * a_tmp * -0.2) + t858_tmp * a_tmp * -0.2) +
-                      t3518_tmp * e_a_tmp * -0.2) +
-                     t776_tmp * e_a_tmp / 5.0) +
-                    b_t3511_tmp * e_a_tmp / 5.0))) +
-          t40 * (((((-(b_t3518_tmp * t1506 / 9.0) + b_t3531_tmp * t1486 / 9.0) - t3516_tmp * t1516 / 9.0) +
-                   h_t3531_tmp * t1484 / 9.0) +
-                  e_t3531_tmp * j_a_tmp / 9.0) +
-                 c_t3511_tmp * t2991_tmp / 9.0)) +
-         t13 * (((((((((((t3516_tmp * g_a_tmp * -0.14285714285714285 + b_t3531_tmp * d_a_tmp * -0.14285714285714285) +
-                         c_t3511_tmp * g_a_tmp * -0.14285714285714285) +
-                        t766_tmp * t1477 / 7.0) -
-                       t3518_tmp * t1485 / 7.0) -
-                      t776_tmp * t1487 / 7.0) +
-                     t858_tmp * t1475 / 7.0) +
-                    c_t3531_tmp * t3511_tmp / 7.0) +
-                   b_t3511_tmp * h_a_tmp / 7.0) +
-                  e_t3531_tmp * d_a_tmp / 7.0) +
-                 b_t3518_tmp * g_a_tmp / 7.0) +
-                h_t3531_tmp * d_a_tmp / 7.0)) +
-        -(t12 * (((((((((((t3518_tmp * t746 / 6.0 + t766_tmp * t786 / 6.0) + -(t776_tmp * t787 / 6.0)) +
-                         t539_tmp * g_a_tmp / 6.0) +
-                        b_a_tmp * g_a_tmp / 6.0) +
-                       d_t3511_tmp * g_a_tmp / 6.0) +
-                      w_t3531_tmp * a_tmp * -0.16666666666666666) +
-                     q_t3531_tmp * a_tmp / 6.0) +
-                    -(t183_tmp * h_a_tmp / 6.0)) +
-                   t555_tmp * e_a_tmp / 6.0) +
-                  t70 * e_a_tmp / 6.0) +
-                 f_t3511_tmp * e_a_tmp * -0.16666666666666666))) +
-       -(t39 * (((((((((((b_t3518_tmp * t756 / 8.0 + b_t3531_tmp * t789 / 8.0) + -(t3516_tmp * t823 / 8.0)) +
-                        b_t340_tmp * g_a_tmp / 8.0) +
-                       t630_tmp * g_a_tmp / 8.0) +
-                      e_t3511_tmp * g_a_tmp * -0.125) +
-                     x_t3531_tmp * d_a_tmp * -0.125) +
-                    r_t3531_tmp * d_a_tmp / 8.0) +
-                   -(v_t3531_tmp * d_a_tmp / 8.0)) +
-                  w_t3531_tmp * t3511_tmp * -0.125) +
-                 t70 * t1487 / 8.0) +
-                f_t3511_tmp * h_a_tmp / 8.0));
+             -(t10 * (((((t69 / AccScalar(8.0) + t26 / AccScalar(4.0)) + t481) + t318 * e_a_tmp / AccScalar(4.0)) + t168 * e_a_tmp / AccScalar(4.0)) +
+                      t183_tmp * e_a_tmp / AccScalar(4.0)))) +
+            -(t41 * ((x_t3531_tmp * j_a_tmp * -AccScalar(0.1) + t630_tmp * t1516 * r10) + e_t3511_tmp * t2991_tmp * r10))) +
+           -(t11 * (((((t766_tmp * a_tmp * r5 + c_t3531_tmp * a_tmp * -AccScalar(0.2)) + t858_tmp * a_tmp * -AccScalar(0.2)) +
+                      t3518_tmp * e_a_tmp * -AccScalar(0.2)) +
+                     t776_tmp * e_a_tmp * r5) +
+                    b_t3511_tmp * e_a_tmp * r5))) +
+          t40 * (((((-(b_t3518_tmp * t1506 * r9) + b_t3531_tmp * t1486 * r9) - t3516_tmp * t1516 * r9) +
+                   h_t3531_tmp * t1484 * r9) +
+                  e_t3531_tmp * j_a_tmp * r9) +
+                 c_t3511_tmp * t2991_tmp * r9)) +
+         t13 * (((((((((((t3516_tmp * g_a_tmp * -AccScalar(0.14285714285714285) + b_t3531_tmp * d_a_tmp * -AccScalar(0.14285714285714285)) +
+                         c_t3511_tmp * g_a_tmp * -AccScalar(0.14285714285714285)) +
+                        t766_tmp * t1477 * r7) -
+                       t3518_tmp * t1485 * r7) -
+                      t776_tmp * t1487 * r7) +
+                     t858_tmp * t1475 * r7) +
+                    c_t3531_tmp * t3511_tmp * r7) +
+                   b_t3511_tmp * h_a_tmp * r7) +
+                  e_t3531_tmp * d_a_tmp * r7) +
+                 b_t3518_tmp * g_a_tmp * r7) +
+                h_t3531_tmp * d_a_tmp * r7)) +
+        -(t12 * (((((((((((t3518_tmp * t746 * r6 + t766_tmp * t786 * r6) + -(t776_tmp * t787 * r6)) +
+                         t539_tmp * g_a_tmp * r6) +
+                        b_a_tmp * g_a_tmp * r6) +
+                       d_t3511_tmp * g_a_tmp * r6) +
+                      w_t3531_tmp * a_tmp * -AccScalar(0.16666666666666666)) +
+                     q_t3531_tmp * a_tmp * r6) +
+                    -(t183_tmp * h_a_tmp * r6)) +
+                   t555_tmp * e_a_tmp * r6) +
+                  t70 * e_a_tmp * r6) +
+                 f_t3511_tmp * e_a_tmp * -AccScalar(0.16666666666666666)))) +
+       -(t39 * (((((((((((b_t3518_tmp * t756 / AccScalar(8.0) + b_t3531_tmp * t789 / AccScalar(8.0)) + -(t3516_tmp * t823 / AccScalar(8.0))) +
+                        b_t340_tmp * g_a_tmp / AccScalar(8.0)) +
+                       t630_tmp * g_a_tmp / AccScalar(8.0)) +
+                      e_t3511_tmp * g_a_tmp * -AccScalar(0.125)) +
+                     x_t3531_tmp * d_a_tmp * -AccScalar(0.125)) +
+                    r_t3531_tmp * d_a_tmp / AccScalar(8.0)) +
+                   -(v_t3531_tmp * d_a_tmp / AccScalar(8.0))) +
+                  w_t3531_tmp * t3511_tmp * -AccScalar(0.125)) +
+                 t70 * t1487 / AccScalar(8.0)) +
+                f_t3511_tmp * h_a_tmp / AccScalar(8.0)));
   t2 = t23 * d_a_tmp;
   t3 = t24 * d_a_tmp;
   t6 = t25 * d_a_tmp;
   t4 =
-      ((((((-(t9 * ((t298 / 3.0 + t425 / 3.0) + -(t421 / 3.0))) +
-            -t11 * (((((t4 / 10.0 + t31 / 10.0) - t473_tmp / 20.0) + t2 * a_tmp_tmp / 5.0) + t3 * a_tmp_tmp / 5.0) +
-                    t6 * a_tmp_tmp / 5.0)) +
-           -(t42 * ((t538_tmp_tmp * t2990_tmp * -0.090909090909090912 + t265 * t1515 / 11.0) +
-                    t626_tmp * t2989_tmp / 11.0))) +
-          t12 * (((((t129 * a_tmp_tmp / 6.0 + t765_tmp * d_a_tmp * -0.16666666666666666) - t779_tmp * a_tmp_tmp / 6.0) -
-                   t3520_tmp * a_tmp_tmp / 6.0) +
-                  t3524_tmp * d_a_tmp / 6.0) +
-                 t857_tmp * d_a_tmp / 6.0)) +
-         t41 * (((((-(t540_tmp * t1505 / 10.0) + t127 * t1517 / 10.0) - b_t3524_tmp * t1515 / 10.0) +
-                  b_t3520_tmp * t1504 / 10.0) +
-                 t315_tmp * t2990_tmp / 10.0) +
-                t3521_tmp * t2989_tmp / 10.0)) +
-        t39 * (((((((((((t127 * b_a_tmp_tmp / 8.0 + t540_tmp * f_a_tmp * -0.125) - t315_tmp * b_a_tmp_tmp / 8.0) -
-                       b_t3520_tmp * b_a_tmp_tmp / 8.0) -
-                      t765_tmp * t1484 / 8.0) +
-                     t129 * t1488 / 8.0) -
-                    t3524_tmp * t1486 / 8.0) +
-                   t3520_tmp * t1483 / 8.0) +
-                  t779_tmp * i_a_tmp / 8.0) +
-                 t857_tmp * j_a_tmp / 8.0) +
-                b_t3524_tmp * f_a_tmp / 8.0) +
-               t3521_tmp * f_a_tmp / 8.0)) +
+      ((((((-(t9 * ((t298 * r3 + t425 * r3) + -(t421 * r3))) +
+            -t11 * (((((t4 * r10 + t31 * r10) - t473_tmp * r20) + t2 * a_tmp_tmp * r5) + t3 * a_tmp_tmp * r5) +
+                    t6 * a_tmp_tmp * r5)) +
+           -(t42 * ((t538_tmp_tmp * t2990_tmp * -AccScalar(0.090909090909090912) + t265 * t1515 * r11) +
+                    t626_tmp * t2989_tmp * r11))) +
+          t12 * (((((t129 * a_tmp_tmp * r6 + t765_tmp * d_a_tmp * -AccScalar(0.16666666666666666)) - t779_tmp * a_tmp_tmp * r6) -
+                   t3520_tmp * a_tmp_tmp * r6) +
+                  t3524_tmp * d_a_tmp * r6) +
+                 t857_tmp * d_a_tmp * r6)) +
+         t41 * (((((-(t540_tmp * t1505 * r10) + t127 * t1517 * r10) - b_t3524_tmp * t1515 * r10) +
+                  b_t3520_tmp * t1504 * r10) +
+                 t315_tmp * t2990_tmp * r10) +
+                t3521_tmp * t2989_tmp * r10)) +
+        t39 * (((((((((((t127 * b_a_tmp_tmp / AccScalar(8.0) + t540_tmp * f_a_tmp * -AccScalar(0.125)) - t315_tmp * b_a_tmp_tmp / AccScalar(8.0)) -
+                       b_t3520_tmp * b_a_tmp_tmp / AccScalar(8.0)) -
+                      t765_tmp * t1484 / AccScalar(8.0)) +
+                     t129 * t1488 / AccScalar(8.0)) -
+                    t3524_tmp * t1486 / AccScalar(8.0)) +
+                   t3520_tmp * t1483 / AccScalar(8.0)) +
+                  t779_tmp * i_a_tmp / AccScalar(8.0)) +
+                 t857_tmp * j_a_tmp / AccScalar(8.0)) +
+                b_t3524_tmp * f_a_tmp / AccScalar(8.0)) +
+               t3521_tmp * f_a_tmp / AccScalar(8.0))) +
        -t13 *
-           (((((((((((t765_tmp * t745 / 7.0 + t129 * t788 / 7.0) - t3524_tmp * t789 / 7.0) + t362 * a_tmp_tmp / 7.0) +
-                   t108 * d_a_tmp * -0.14285714285714285) -
-                  t341 * d_a_tmp / 7.0) -
-                 c_t3520_tmp * a_tmp_tmp / 7.0) +
-                t155 * a_tmp_tmp / 7.0) +
-               t72 * d_a_tmp / 7.0) +
-              t321 * b_a_tmp_tmp / 7.0) +
-             t128 * b_a_tmp_tmp / 7.0) +
-            e_t3520_tmp * b_a_tmp_tmp / 7.0)) +
-      -(t40 * (((((((((((t540_tmp * t755 / 9.0 + t127 * t824 / 9.0) + -(b_t3524_tmp * t825 / 9.0)) +
-                       t538_tmp_tmp * b_a_tmp_tmp / 9.0) +
-                      t265 * f_a_tmp * -0.1111111111111111) +
-                     t626_tmp * f_a_tmp / 9.0) +
-                    t323 * b_a_tmp_tmp / 9.0) +
-                   -(t152 * f_a_tmp / 9.0)) +
-                  -(d_t3520_tmp * b_a_tmp_tmp / 9.0)) +
-                 t362 * i_a_tmp * -0.1111111111111111) +
-                t108 * t1486 / 9.0) +
-               t72 * j_a_tmp / 9.0));
-  t7 = ((((((-(t9 * ((t299 / 3.0 + -(t419 / 3.0)) + t426 / 3.0)) +
-             t11 * (((((-(t35 / 10.0) - t7 / 10.0) + t469_tmp / 20.0) + t23 * e_a_tmp * a_tmp_tmp / 5.0) +
-                     t24 * e_a_tmp * a_tmp_tmp / 5.0) +
-                    t25 * e_a_tmp * a_tmp_tmp / 5.0)) +
-            -(t42 * ((x_t3531_tmp * t1517 / 11.0 + t265 * t2991_tmp * -0.090909090909090912) +
-                     r_t3531_tmp * t2990_tmp / 11.0))) +
-           -t12 * (((((t765_tmp * e_a_tmp * -0.16666666666666666 - t766_tmp * a_tmp_tmp / 6.0) +
-                      c_t3531_tmp * a_tmp_tmp / 6.0) +
-                     t858_tmp * a_tmp_tmp / 6.0) +
-                    t3524_tmp * e_a_tmp / 6.0) +
-                   t857_tmp * e_a_tmp / 6.0)) +
-          t41 * (((((-(b_t3531_tmp * t1504 / 10.0) + t540_tmp * t1516 / 10.0) - e_t3531_tmp * t1517 / 10.0) +
-                   t3521_tmp * t1506 / 10.0) +
-                  h_t3531_tmp * t2990_tmp / 10.0) +
-                 b_t3524_tmp * t2991_tmp / 10.0)) +
-         t39 * (((((((((((b_t3531_tmp * b_a_tmp_tmp / 8.0 - e_t3531_tmp * b_a_tmp_tmp / 8.0) +
-                         b_t3524_tmp * g_a_tmp * -0.125) +
-                        t3521_tmp * g_a_tmp * -0.125) -
-                       h_t3531_tmp * b_a_tmp_tmp / 8.0) -
-                      t766_tmp * t1483 / 8.0) +
-                     t765_tmp * t1487 / 8.0) -
-                    c_t3531_tmp * t1488 / 8.0) +
-                   t857_tmp * t1485 / 8.0) +
-                  t858_tmp * i_a_tmp / 8.0) +
-                 t3524_tmp * h_a_tmp / 8.0) +
-                t540_tmp * g_a_tmp / 8.0)) +
-        -(t13 * (((((((((((t766_tmp * t747 / 7.0 + t765_tmp * t787 / 7.0) + -(c_t3531_tmp * t788 / 7.0)) +
-                         t627_tmp * b_a_tmp_tmp * -0.14285714285714285) +
-                        t3519_tmp * b_a_tmp_tmp * -0.14285714285714285) +
-                       t552_tmp * b_a_tmp_tmp * -0.14285714285714285) +
-                      w_t3531_tmp * a_tmp_tmp / 7.0) +
-                     t72 * e_a_tmp * -0.14285714285714285) +
-                    t341 * e_a_tmp / 7.0) +
-                   t108 * e_a_tmp / 7.0) +
-                  -(q_t3531_tmp * a_tmp_tmp / 7.0)) +
-                 u_t3531_tmp * a_tmp_tmp / 7.0))) +
-       -(t40 * (((((((((((b_t3531_tmp * t757 / 9.0 + t540_tmp * t823 / 9.0) + -(e_t3531_tmp * t824 / 9.0)) +
-                        x_t3531_tmp * b_a_tmp_tmp / 9.0) +
-                       t626_tmp * g_a_tmp * -0.1111111111111111) +
-                      t152 * g_a_tmp / 9.0) +
-                     t265 * g_a_tmp / 9.0) +
-                    -(r_t3531_tmp * b_a_tmp_tmp / 9.0)) +
-                   v_t3531_tmp * b_a_tmp_tmp / 9.0) +
-                  w_t3531_tmp * t1488 / 9.0) +
-                 t108 * h_a_tmp * -0.1111111111111111) +
-                q_t3531_tmp * i_a_tmp / 9.0));
+           (((((((((((t765_tmp * t745 * r7 + t129 * t788 * r7) - t3524_tmp * t789 * r7) + t362 * a_tmp_tmp * r7) +
+                   t108 * d_a_tmp * -AccScalar(0.14285714285714285)) -
+                  t341 * d_a_tmp * r7) -
+                 c_t3520_tmp * a_tmp_tmp * r7) +
+                t155 * a_tmp_tmp * r7) +
+               t72 * d_a_tmp * r7) +
+              t321 * b_a_tmp_tmp * r7) +
+             t128 * b_a_tmp_tmp * r7) +
+            e_t3520_tmp * b_a_tmp_tmp * r7)) +
+      -(t40 * (((((((((((t540_tmp * t755 * r9 + t127 * t824 * r9) + -(b_t3524_tmp * t825 * r9)) +
+                       t538_tmp_tmp * b_a_tmp_tmp * r9) +
+                      t265 * f_a_tmp * -AccScalar(0.1111111111111111)) +
+                     t626_tmp * f_a_tmp * r9) +
+                    t323 * b_a_tmp_tmp * r9) +
+                   -(t152 * f_a_tmp * r9)) +
+                  -(d_t3520_tmp * b_a_tmp_tmp * r9)) +
+                 t362 * i_a_tmp * -AccScalar(0.1111111111111111)) +
+                t108 * t1486 * r9) +
+               t72 * j_a_tmp * r9));
+  t7 = ((((((-(t9 * ((t299 * r3 + -(t419 * r3)) + t426 * r3)) +
+             t11 * (((((-(t35 * r10) - t7 * r10) + t469_tmp * r20) + t23 * e_a_tmp * a_tmp_tmp * r5) +
+                     t24 * e_a_tmp * a_tmp_tmp * r5) +
+                    t25 * e_a_tmp * a_tmp_tmp * r5)) +
+            -(t42 * ((x_t3531_tmp * t1517 * r11 + t265 * t2991_tmp * -AccScalar(0.090909090909090912)) +
+                     r_t3531_tmp * t2990_tmp * r11))) +
+           -t12 * (((((t765_tmp * e_a_tmp * -AccScalar(0.16666666666666666) - t766_tmp * a_tmp_tmp * r6) +
+                      c_t3531_tmp * a_tmp_tmp * r6) +
+                     t858_tmp * a_tmp_tmp * r6) +
+                    t3524_tmp * e_a_tmp * r6) +
+                   t857_tmp * e_a_tmp * r6)) +
+          t41 * (((((-(b_t3531_tmp * t1504 * r10) + t540_tmp * t1516 * r10) - e_t3531_tmp * t1517 * r10) +
+                   t3521_tmp * t1506 * r10) +
+                  h_t3531_tmp * t2990_tmp * r10) +
+                 b_t3524_tmp * t2991_tmp * r10)) +
+         t39 * (((((((((((b_t3531_tmp * b_a_tmp_tmp / AccScalar(8.0) - e_t3531_tmp * b_a_tmp_tmp / AccScalar(8.0)) +
+                         b_t3524_tmp * g_a_tmp * -AccScalar(0.125)) +
+                        t3521_tmp * g_a_tmp * -AccScalar(0.125)) -
+                       h_t3531_tmp * b_a_tmp_tmp / AccScalar(8.0)) -
+                      t766_tmp * t1483 / AccScalar(8.0)) +
+                     t765_tmp * t1487 / AccScalar(8.0)) -
+                    c_t3531_tmp * t1488 / AccScalar(8.0)) +
+                   t857_tmp * t1485 / AccScalar(8.0)) +
+                  t858_tmp * i_a_tmp / AccScalar(8.0)) +
+                 t3524_tmp * h_a_tmp / AccScalar(8.0)) +
+                t540_tmp * g_a_tmp / AccScalar(8.0))) +
+        -(t13 * (((((((((((t766_tmp * t747 * r7 + t765_tmp * t787 * r7) + -(c_t3531_tmp * t788 * r7)) +
+                         t627_tmp * b_a_tmp_tmp * -AccScalar(0.14285714285714285)) +
+                        t3519_tmp * b_a_tmp_tmp * -AccScalar(0.14285714285714285)) +
+                       t552_tmp * b_a_tmp_tmp * -AccScalar(0.14285714285714285)) +
+                      w_t3531_tmp * a_tmp_tmp * r7) +
+                     t72 * e_a_tmp * -AccScalar(0.14285714285714285)) +
+                    t341 * e_a_tmp * r7) +
+                   t108 * e_a_tmp * r7) +
+                  -(q_t3531_tmp * a_tmp_tmp * r7)) +
+                 u_t3531_tmp * a_tmp_tmp * r7))) +
+       -(t40 * (((((((((((b_t3531_tmp * t757 * r9 + t540_tmp * t823 * r9) + -(e_t3531_tmp * t824 * r9)) +
+                        x_t3531_tmp * b_a_tmp_tmp * r9) +
+                       t626_tmp * g_a_tmp * -AccScalar(0.1111111111111111)) +
+                      t152 * g_a_tmp * r9) +
+                     t265 * g_a_tmp * r9) +
+                    -(r_t3531_tmp * b_a_tmp_tmp * r9)) +
+                   v_t3531_tmp * b_a_tmp_tmp * r9) +
+                  w_t3531_tmp * t1488 * r9) +
+                 t108 * h_a_tmp * -AccScalar(0.1111111111111111)) +
+                q_t3531_tmp * i_a_tmp * r9));
   t2 =
-      ((((((-(t9 * ((t297 / 3.0 + -(t420 / 3.0)) + t427 / 3.0)) +
-            -(t11 * (((((t28 / 10.0 + t26 / 10.0) + -(b_t481_tmp / 20.0)) + t2 * e_a_tmp / 5.0) + t3 * e_a_tmp / 5.0) +
-                     t6 * e_a_tmp / 5.0))) +
-           -(t42 * ((x_t3531_tmp * t2989_tmp * -0.090909090909090912 + t538_tmp_tmp * t1516 / 11.0) +
-                    d_t3520_tmp * t2991_tmp / 11.0))) +
-          t12 * (((((t766_tmp * d_a_tmp * -0.16666666666666666 + t779_tmp * e_a_tmp * -0.16666666666666666) +
-                    t3520_tmp * e_a_tmp * -0.16666666666666666) +
-                   t129 * e_a_tmp / 6.0) +
-                  c_t3531_tmp * d_a_tmp / 6.0) +
-                 t858_tmp * d_a_tmp / 6.0)) +
-         t41 * (((((-(t127 * t1506 / 10.0) + b_t3531_tmp * t1515 / 10.0) - t315_tmp * t1516 / 10.0) +
-                  h_t3531_tmp * t1505 / 10.0) +
-                 e_t3531_tmp * t2989_tmp / 10.0) +
-                b_t3520_tmp * t2991_tmp / 10.0)) +
+      ((((((-(t9 * ((t297 * r3 + -(t420 * r3)) + t427 * r3)) +
+            -(t11 * (((((t28 * r10 + t26 * r10) + -(b_t481_tmp * r20)) + t2 * e_a_tmp * r5) + t3 * e_a_tmp * r5) +
+                     t6 * e_a_tmp * r5))) +
+           -(t42 * ((x_t3531_tmp * t2989_tmp * -AccScalar(0.090909090909090912) + t538_tmp_tmp * t1516 * r11) +
+                    d_t3520_tmp * t2991_tmp * r11))) +
+          t12 * (((((t766_tmp * d_a_tmp * -AccScalar(0.16666666666666666) + t779_tmp * e_a_tmp * -AccScalar(0.16666666666666666)) +
+                    t3520_tmp * e_a_tmp * -AccScalar(0.16666666666666666)) +
+                   t129 * e_a_tmp * r6) +
+                  c_t3531_tmp * d_a_tmp * r6) +
+                 t858_tmp * d_a_tmp * r6)) +
+         t41 * (((((-(t127 * t1506 * r10) + b_t3531_tmp * t1515 * r10) - t315_tmp * t1516 * r10) +
+                  h_t3531_tmp * t1505 * r10) +
+                 e_t3531_tmp * t2989_tmp * r10) +
+                b_t3520_tmp * t2991_tmp * r10)) +
         t39 *
-            (((((((((((b_t3531_tmp * f_a_tmp * -0.125 + t315_tmp * g_a_tmp * -0.125) + b_t3520_tmp * g_a_tmp * -0.125) -
-                     t129 * t1485 / 8.0) +
-                    t766_tmp * t1486 / 8.0) -
-                   t779_tmp * t1487 / 8.0) +
-                  t858_tmp * t1484 / 8.0) +
-                 c_t3531_tmp * j_a_tmp / 8.0) +
-                t3520_tmp * h_a_tmp / 8.0) +
-               t127 * g_a_tmp / 8.0) +
-              e_t3531_tmp * f_a_tmp / 8.0) +
-             h_t3531_tmp * f_a_tmp / 8.0)) +
+            (((((((((((b_t3531_tmp * f_a_tmp * -AccScalar(0.125) + t315_tmp * g_a_tmp * -AccScalar(0.125)) + b_t3520_tmp * g_a_tmp * -AccScalar(0.125)) -
+                     t129 * t1485 / AccScalar(8.0)) +
+                    t766_tmp * t1486 / AccScalar(8.0)) -
+                   t779_tmp * t1487 / AccScalar(8.0)) +
+                  t858_tmp * t1484 / AccScalar(8.0)) +
+                 c_t3531_tmp * j_a_tmp / AccScalar(8.0)) +
+                t3520_tmp * h_a_tmp / AccScalar(8.0)) +
+               t127 * g_a_tmp / AccScalar(8.0)) +
+              e_t3531_tmp * f_a_tmp / AccScalar(8.0)) +
+             h_t3531_tmp * f_a_tmp / AccScalar(8.0))) +
        -(t13 *
-         (((((((((((t129 * t746 / 7.0 + t766_tmp * t789 / 7.0) + -(t779_tmp * t787 / 7.0)) + t627_tmp * f_a_tmp / 7.0) +
-                 t3519_tmp * f_a_tmp / 7.0) +
-                t552_tmp * f_a_tmp / 7.0) +
-               w_t3531_tmp * d_a_tmp * -0.14285714285714285) +
-              t155 * e_a_tmp / 7.0) +
-             t362 * e_a_tmp / 7.0) +
-            c_t3520_tmp * e_a_tmp * -0.14285714285714285) +
-           q_t3531_tmp * d_a_tmp / 7.0) +
-          -(u_t3531_tmp * d_a_tmp / 7.0)))) +
-      -(t40 * (((((((((((t127 * t756 / 9.0 + b_t3531_tmp * t825 / 9.0) + -(t315_tmp * t823 / 9.0)) +
-                       x_t3531_tmp * f_a_tmp * -0.1111111111111111) +
-                      t323 * g_a_tmp / 9.0) +
-                     t538_tmp_tmp * g_a_tmp / 9.0) +
-                    d_t3520_tmp * g_a_tmp * -0.1111111111111111) +
-                   r_t3531_tmp * f_a_tmp / 9.0) +
-                  -(v_t3531_tmp * f_a_tmp / 9.0)) +
-                 w_t3531_tmp * j_a_tmp * -0.1111111111111111) +
-                t362 * t1487 / 9.0) +
-               c_t3520_tmp * h_a_tmp / 9.0));
-  t6 = t747 * t747 - t1483 * a_tmp_tmp * 2.0;
+         (((((((((((t129 * t746 * r7 + t766_tmp * t789 * r7) + -(t779_tmp * t787 * r7)) + t627_tmp * f_a_tmp * r7) +
+                 t3519_tmp * f_a_tmp * r7) +
+                t552_tmp * f_a_tmp * r7) +
+               w_t3531_tmp * d_a_tmp * -AccScalar(0.14285714285714285)) +
+              t155 * e_a_tmp * r7) +
+             t362 * e_a_tmp * r7) +
+            c_t3520_tmp * e_a_tmp * -AccScalar(0.14285714285714285)) +
+           q_t3531_tmp * d_a_tmp * r7) +
+          -(u_t3531_tmp * d_a_tmp * r7)))) +
+      -(t40 * (((((((((((t127 * t756 * r9 + b_t3531_tmp * t825 * r9) + -(t315_tmp * t823 * r9)) +
+                       x_t3531_tmp * f_a_tmp * -AccScalar(0.1111111111111111)) +
+                      t323 * g_a_tmp * r9) +
+                     t538_tmp_tmp * g_a_tmp * r9) +
+                    d_t3520_tmp * g_a_tmp * -AccScalar(0.1111111111111111)) +
+                   r_t3531_tmp * f_a_tmp * r9) +
+                  -(v_t3531_tmp * f_a_tmp * r9)) +
+                 w_t3531_tmp * j_a_tmp * -AccScalar(0.1111111111111111)) +
+                t362 * t1487 * r9) +
+               c_t3520_tmp * h_a_tmp * r9));
+  t6 = t747 * t747 - t1483 * a_tmp_tmp * AccScalar(2.0);
   Q_d(0, 0) =
-      ((((((-t39 * (((((t857 * t1488 + t765 * i_a_tmp) - t3524_tmp * t1483 / 4.0) - t540_tmp * b_a_tmp_tmp / 4.0) +
-                     b_t3524_tmp * b_a_tmp_tmp / 4.0) +
-                    t3521_tmp * b_a_tmp_tmp / 4.0) +
-            t40 * (((((t25 * t1492 / 9.0 + t23 * t1497 / 9.0) + t24 * t1499 / 9.0) +
-                     t20 * (t1517 * b_a_tmp_tmp * 2.0 + t824 * t824) / 9.0) -
-                    t22 * (t1504 * b_a_tmp_tmp * 2.0 - t757 * t757) / 9.0) -
-                   t21 * (t2990_tmp * b_a_tmp_tmp * 2.0 - t750 * t750) / 9.0)) +
-           t9 * ((t154 / 3.0 + t157 / 3.0) + t159 / 3.0)) +
-          t13 * (((((t20 * t1141 / 7.0 + t21 * t1141 / 7.0) + t22 * t1141 / 7.0) + t24 * t2974 / 7.0) +
-                  t23 * t2981 / 7.0) +
-                 t25 * t6 / 7.0)) +
-         t11 * (((((t322 / 20.0 + t319 / 20.0) + t23 * t1138 / 5.0) + t24 * t1138 / 5.0) + t25 * t1138 / 5.0) +
-                t18 * (t96 * t96) / 5.0)) -
-        t12 * ((t765_tmp * a_tmp_tmp * -0.33333333333333331 + t3524_tmp * a_tmp_tmp / 3.0) +
-               t857_tmp * a_tmp_tmp / 3.0)) +
-       t42 * ((t22 * (t1504 * t1504) / 11.0 + t20 * (t1517 * t1517) / 11.0) + t21 * (t2990_tmp * t2990_tmp) / 11.0)) -
-      t41 * ((t540_tmp * t2990_tmp / 5.0 - b_t3524_tmp * t1504 / 5.0) + t3521_tmp * t1517 / 5.0);
+      ((((((-t39 * (((((t857 * t1488 + t765 * i_a_tmp) - t3524_tmp * t1483 / AccScalar(4.0)) - t540_tmp * b_a_tmp_tmp / AccScalar(4.0)) +
+                     b_t3524_tmp * b_a_tmp_tmp / AccScalar(4.0)) +
+                    t3521_tmp * b_a_tmp_tmp / AccScalar(4.0)) +
+            t40 * (((((t25 * t1492 * r9 + t23 * t1497 * r9) + t24 * t1499 * r9) +
+                     t20 * (t1517 * b_a_tmp_tmp * AccScalar(2.0) + t824 * t824) * r9) -
+                    t22 * (t1504 * b_a_tmp_tmp * AccScalar(2.0) - t757 * t757) * r9) -
+                   t21 * (t2990_tmp * b_a_tmp_tmp * AccScalar(2.0) - t750 * t750) * r9)) +
+           t9 * ((t154 * r3 + t157 * r3) + t159 * r3)) +
+          t13 * (((((t20 * t1141 * r7 + t21 * t1141 * r7) + t22 * t1141 * r7) + t24 * t2974 * r7) +
+                  t23 * t2981 * r7) +
+                 t25 * t6 * r7)) +
+         t11 * (((((t322 * r20 + t319 * r20) + t23 * t1138 * r5) + t24 * t1138 * r5) + t25 * t1138 * r5) +
+                t18 * (t96 * t96) * r5)) -
+        t12 * ((t765_tmp * a_tmp_tmp * -AccScalar(0.33333333333333331) + t3524_tmp * a_tmp_tmp * r3) +
+               t857_tmp * a_tmp_tmp * r3)) +
+       t42 * ((t22 * (t1504 * t1504) * r11 + t20 * (t1517 * t1517) * r11) + t21 * (t2990_tmp * t2990_tmp) * r11)) -
+      t41 * ((t540_tmp * t2990_tmp * r5 - b_t3524_tmp * t1504 * r5) + t3521_tmp * t1517 * r5);
   Q_d(0, 1) = t7;
   Q_d(0, 2) = t4;
   Q_d(0, 3) = t3532;
@@ -2037,28 +2062,28 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   Q_d(0, 13) = t226;
   Q_d(0, 14) = t185;
   Q_d(1, 0) = t7;
-  t3 = t737 * t737 - h_a_tmp * e_a_tmp * 2.0;
-  t7 = t787 * t787 + t1487 * e_a_tmp * 2.0;
+  t3 = t737 * t737 - h_a_tmp * e_a_tmp * AccScalar(2.0);
+  t7 = t787 * t787 + t1487 * e_a_tmp * AccScalar(2.0);
   Q_d(1, 1) =
-      ((((((t9 * ((db_t3531_tmp / 3.0 + eb_t3531_tmp / 3.0) + fb_t3531_tmp / 3.0) -
-            t41 * ((b_t3531_tmp * t2991_tmp / 5.0 - e_t3531_tmp * t1506 / 5.0) + h_t3531_tmp * t1516 / 5.0)) +
-           t11 * (((((gb_t3531_tmp / 20.0 + hb_t3531_tmp / 20.0) + t23 * t1137 / 5.0) + t24 * t1137 / 5.0) +
-                   t25 * t1137 / 5.0) +
-                  t19 * (t94 * t94) / 5.0)) +
+      ((((((t9 * ((db_t3531_tmp * r3 + eb_t3531_tmp * r3) + fb_t3531_tmp * r3) -
+            t41 * ((b_t3531_tmp * t2991_tmp * r5 - e_t3531_tmp * t1506 * r5) + h_t3531_tmp * t1516 * r5)) +
+           t11 * (((((gb_t3531_tmp * r20 + hb_t3531_tmp * r20) + t23 * t1137 * r5) + t24 * t1137 * r5) +
+                   t25 * t1137 * r5) +
+                  t19 * (t94 * t94) * r5)) +
           t13 *
-              (((((t20 * t1140 / 7.0 + t21 * t1140 / 7.0) + t22 * t1140 / 7.0) + t23 * t2976 / 7.0) + t25 * t3 / 7.0) +
-               t24 * t7 / 7.0)) -
-         t39 * (((((t858 * t1487 + t766 * h_a_tmp) - b_t3531_tmp * g_a_tmp / 4.0) + e_t3531_tmp * g_a_tmp / 4.0) +
-                 h_t3531_tmp * g_a_tmp / 4.0) -
-                c_t3531_tmp * t1485 / 4.0)) +
-        t40 * (((((t21 * (t1516 * g_a_tmp * 2.0 + t823 * t823) / 9.0 -
-                   t22 * (t2991_tmp * g_a_tmp * 2.0 - t749 * t749) / 9.0) +
-                  t23 * t1494 / 9.0) +
-                 t24 * t1496 / 9.0) +
-                t25 * t1498 / 9.0) -
-               t20 * (t1506 * g_a_tmp * 2.0 - t756 * t756) / 9.0)) -
-       t12 * ((t766_tmp * e_a_tmp * -0.33333333333333331 + c_t3531_tmp * e_a_tmp / 3.0) + t858_tmp * e_a_tmp / 3.0)) +
-      t42 * ((t22 * (t2991_tmp * t2991_tmp) / 11.0 + t20 * (t1506 * t1506) / 11.0) + t21 * (t1516 * t1516) / 11.0);
+              (((((t20 * t1140 * r7 + t21 * t1140 * r7) + t22 * t1140 * r7) + t23 * t2976 * r7) + t25 * t3 * r7) +
+               t24 * t7 * r7)) -
+         t39 * (((((t858 * t1487 + t766 * h_a_tmp) - b_t3531_tmp * g_a_tmp / AccScalar(4.0)) + e_t3531_tmp * g_a_tmp / AccScalar(4.0)) +
+                 h_t3531_tmp * g_a_tmp / AccScalar(4.0)) -
+                c_t3531_tmp * t1485 / AccScalar(4.0))) +
+        t40 * (((((t21 * (t1516 * g_a_tmp * AccScalar(2.0) + t823 * t823) * r9 -
+                   t22 * (t2991_tmp * g_a_tmp * AccScalar(2.0) - t749 * t749) * r9) +
+                  t23 * t1494 * r9) +
+                 t24 * t1496 * r9) +
+                t25 * t1498 * r9) -
+               t20 * (t1506 * g_a_tmp * AccScalar(2.0) - t756 * t756) * r9)) -
+       t12 * ((t766_tmp * e_a_tmp * -AccScalar(0.33333333333333331) + c_t3531_tmp * e_a_tmp * r3) + t858_tmp * e_a_tmp * r3)) +
+      t42 * ((t22 * (t2991_tmp * t2991_tmp) * r11 + t20 * (t1506 * t1506) * r11) + t21 * (t1516 * t1516) * r11);
   Q_d(1, 2) = t2;
   Q_d(1, 3) = t30;
   Q_d(1, 4) = t3531;
@@ -2074,25 +2099,25 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   Q_d(1, 14) = t227;
   Q_d(2, 0) = t4;
   Q_d(2, 1) = t2;
-  t2 = t745 * t745 + t1484 * d_a_tmp * 2.0;
+  t2 = t745 * t745 + t1484 * d_a_tmp * AccScalar(2.0);
   Q_d(2, 2) =
-      ((((((t9 * ((t162_tmp / 3.0 + t68 / 3.0) + t89 / 3.0) +
-            t11 * (((((t88 / 20.0 + t90 / 20.0) + t23 * t1136 / 5.0) + t24 * t1136 / 5.0) + t25 * t1136 / 5.0) +
-                   t17 * (t95 * t95) / 5.0)) +
-           t13 * (((((t20 * t1139 / 7.0 + t21 * t1139 / 7.0) + t22 * t1139 / 7.0) + t23 * t2975 / 7.0) +
-                   t25 * t2980 / 7.0) +
-                  t24 * t2 / 7.0)) +
+      ((((((t9 * ((t162_tmp * r3 + t68 * r3) + t89 * r3) +
+            t11 * (((((t88 * r20 + t90 * r20) + t23 * t1136 * r5) + t24 * t1136 * r5) + t25 * t1136 * r5) +
+                   t17 * (t95 * t95) * r5)) +
+           t13 * (((((t20 * t1139 * r7 + t21 * t1139 * r7) + t22 * t1139 * r7) + t23 * t2975 * r7) +
+                   t25 * t2980 * r7) +
+                  t24 * t2 * r7)) +
           t42 *
-              ((t21 * (t1505 * t1505) / 11.0 + t22 * (t1515 * t1515) / 11.0) + t20 * (t2989_tmp * t2989_tmp) / 11.0)) +
-         t12 * ((t129 * d_a_tmp * -0.33333333333333331 + t779_tmp * d_a_tmp / 3.0) + t3520_tmp * d_a_tmp / 3.0)) -
-        t41 * ((t127 * t2989_tmp / 5.0 - t315_tmp * t1505 / 5.0) + b_t3520_tmp * t1515 / 5.0)) +
-       t39 * (((((t779 * t1484 - t129 * j_a_tmp / 4.0) - t127 * f_a_tmp / 4.0) + t315_tmp * f_a_tmp / 4.0) +
-               b_t3520_tmp * f_a_tmp / 4.0) -
-              t3520_tmp * t1486 / 4.0)) +
-      t40 * (((((t21 * (t1505 * f_a_tmp * 2.0 + t755 * t755) / 9.0 + t24 * t1493 / 9.0) + t25 * t1495 / 9.0) +
-               t23 * t1500 / 9.0) +
-              t20 * (t2989_tmp * f_a_tmp * 2.0 + t748 * t748) / 9.0) -
-             t22 * (t1515 * f_a_tmp * 2.0 - t825 * t825) / 9.0);
+              ((t21 * (t1505 * t1505) * r11 + t22 * (t1515 * t1515) * r11) + t20 * (t2989_tmp * t2989_tmp) * r11)) +
+         t12 * ((t129 * d_a_tmp * -AccScalar(0.33333333333333331) + t779_tmp * d_a_tmp * r3) + t3520_tmp * d_a_tmp * r3)) -
+        t41 * ((t127 * t2989_tmp * r5 - t315_tmp * t1505 * r5) + b_t3520_tmp * t1515 * r5)) +
+       t39 * (((((t779 * t1484 - t129 * j_a_tmp / AccScalar(4.0)) - t127 * f_a_tmp / AccScalar(4.0)) + t315_tmp * f_a_tmp / AccScalar(4.0)) +
+               b_t3520_tmp * f_a_tmp / AccScalar(4.0)) -
+              t3520_tmp * t1486 / AccScalar(4.0))) +
+      t40 * (((((t21 * (t1505 * f_a_tmp * AccScalar(2.0) + t755 * t755) * r9 + t24 * t1493 * r9) + t25 * t1495 * r9) +
+               t23 * t1500 * r9) +
+              t20 * (t2989_tmp * f_a_tmp * AccScalar(2.0) + t748 * t748) * r9) -
+             t22 * (t1515 * f_a_tmp * AccScalar(2.0) - t825 * t825) * r9);
   Q_d(2, 3) = t32;
   Q_d(2, 4) = t27;
   Q_d(2, 5) = t33;
@@ -2109,22 +2134,22 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   Q_d(3, 1) = t30;
   Q_d(3, 2) = t32;
   Q_d(3, 3) =
-      ((((((-t12 * (((((t854 * t1479 + t762 * t3512_tmp) - t3515_tmp * t1474 / 3.0) - t3517_tmp * a_tmp_tmp / 3.0) +
-                     b_t3515_tmp * a_tmp_tmp / 3.0) +
-                    b_t3512_tmp * a_tmp_tmp / 3.0) +
-            t40 * ((t22 * t1492 / 9.0 + t20 * t1497 / 9.0) + t21 * t1499 / 9.0)) -
-           t10 * ((t762_tmp * t892 * -0.5 + t3515_tmp * t892 / 2.0) + t854_tmp * t892 / 2.0)) +
-          t13 * (((((t21 * t2974 / 7.0 + t20 * t2981 / 7.0) + t22 * t6 / 7.0) + t25 * (t1474 * t1474) / 7.0) +
-                  t23 * (t1479 * t1479) / 7.0) +
-                 t24 * (t3512_tmp * t3512_tmp) / 7.0)) -
-         t39 * ((t3517_tmp * i_a_tmp / 4.0 - b_t3515_tmp * t1483 / 4.0) + b_t3512_tmp * t1488 / 4.0)) +
-        t9 * (((((t322 / 3.0 + t18 * t114 / 3.0) + t319 / 3.0) + t23 * t916 / 3.0) + t24 * t916 / 3.0) +
-              t25 * t916 / 3.0)) +
+      ((((((-t12 * (((((t854 * t1479 + t762 * t3512_tmp) - t3515_tmp * t1474 * r3) - t3517_tmp * a_tmp_tmp * r3) +
+                     b_t3515_tmp * a_tmp_tmp * r3) +
+                    b_t3512_tmp * a_tmp_tmp * r3) +
+            t40 * ((t22 * t1492 * r9 + t20 * t1497 * r9) + t21 * t1499 * r9)) -
+           t10 * ((t762_tmp * t892 * -AccScalar(0.5) + t3515_tmp * t892 / AccScalar(2.0)) + t854_tmp * t892 / AccScalar(2.0))) +
+          t13 * (((((t21 * t2974 * r7 + t20 * t2981 * r7) + t22 * t6 * r7) + t25 * (t1474 * t1474) * r7) +
+                  t23 * (t1479 * t1479) * r7) +
+                 t24 * (t3512_tmp * t3512_tmp) * r7)) -
+         t39 * ((t3517_tmp * i_a_tmp / AccScalar(4.0) - b_t3515_tmp * t1483 / AccScalar(4.0)) + b_t3512_tmp * t1488 / AccScalar(4.0))) +
+        t9 * (((((t322 * r3 + t18 * t114 * r3) + t319 * r3) + t23 * t916 * r3) + t24 * t916 * r3) +
+              t25 * t916 * r3)) +
        dt_lim * ((t154 + t157) + t159)) +
-      t11 * (((((t20 * t1138 / 5.0 + t21 * t1138 / 5.0) + t22 * t1138 / 5.0) +
-               t23 * (t892 * t1479 * 2.0 + t785 * t785) / 5.0) -
-              t25 * (t892 * t1474 * 2.0 - t744 * t744) / 5.0) -
-             t24 * (t892 * t3512_tmp * 2.0 - t735 * t735) / 5.0);
+      t11 * (((((t20 * t1138 * r5 + t21 * t1138 * r5) + t22 * t1138 * r5) +
+               t23 * (t892 * t1479 * AccScalar(2.0) + t785 * t785) * r5) -
+              t25 * (t892 * t1474 * AccScalar(2.0) - t744 * t744) * r5) -
+             t24 * (t892 * t3512_tmp * AccScalar(2.0) - t735 * t735) * r5);
   Q_d(3, 4) = t320;
   Q_d(3, 5) = t158;
   Q_d(3, 6) = t3512;
@@ -2141,22 +2166,22 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   Q_d(4, 2) = t27;
   Q_d(4, 3) = t320;
   Q_d(4, 4) =
-      ((((((t40 * ((t20 * t1494 / 9.0 + t21 * t1496 / 9.0) + t22 * t1498 / 9.0) -
-            t39 * ((t3531_tmp * h_a_tmp / 4.0 - f_t3531_tmp * t1485 / 4.0) + g_t3531_tmp * t1487 / 4.0)) +
-           t13 * (((((t20 * t2976 / 7.0 + t25 * (i_t3531_tmp * i_t3531_tmp) / 7.0) + t22 * t3 / 7.0) +
-                    t23 * (t1476 * t1476) / 7.0) +
-                   t24 * (t1478 * t1478) / 7.0) +
-                  t21 * t7 / 7.0)) -
-          t12 * (((((t855 * t1478 + t763 * i_t3531_tmp) - t3531_tmp * e_a_tmp / 3.0) + f_t3531_tmp * e_a_tmp / 3.0) +
-                  g_t3531_tmp * e_a_tmp / 3.0) -
-                 d_t3531_tmp * t1476 / 3.0)) +
-         t11 * (((((t23 * (t1476 * c_a_tmp * 2.0 - t743 * t743) * -0.2 + t20 * t1137 / 5.0) + t21 * t1137 / 5.0) +
-                  t22 * t1137 / 5.0) +
-                 t24 * (t1478 * c_a_tmp * 2.0 + t784 * t784) / 5.0) -
-                t25 * (i_t3531_tmp * c_a_tmp * 2.0 - t734 * t734) / 5.0)) -
-        t10 * ((t763_tmp * c_a_tmp * -0.5 + d_t3531_tmp * c_a_tmp / 2.0) + t855_tmp * c_a_tmp / 2.0)) +
-       t9 * (((((gb_t3531_tmp / 3.0 + t19 * t112 / 3.0) + hb_t3531_tmp / 3.0) + t23 * t915 / 3.0) + t24 * t915 / 3.0) +
-             t25 * t915 / 3.0)) +
+      ((((((t40 * ((t20 * t1494 * r9 + t21 * t1496 * r9) + t22 * t1498 * r9) -
+            t39 * ((t3531_tmp * h_a_tmp / AccScalar(4.0) - f_t3531_tmp * t1485 / AccScalar(4.0)) + g_t3531_tmp * t1487 / AccScalar(4.0))) +
+           t13 * (((((t20 * t2976 * r7 + t25 * (i_t3531_tmp * i_t3531_tmp) * r7) + t22 * t3 * r7) +
+                    t23 * (t1476 * t1476) * r7) +
+                   t24 * (t1478 * t1478) * r7) +
+                  t21 * t7 * r7)) -
+          t12 * (((((t855 * t1478 + t763 * i_t3531_tmp) - t3531_tmp * e_a_tmp * r3) + f_t3531_tmp * e_a_tmp * r3) +
+                  g_t3531_tmp * e_a_tmp * r3) -
+                 d_t3531_tmp * t1476 * r3)) +
+         t11 * (((((t23 * (t1476 * c_a_tmp * AccScalar(2.0) - t743 * t743) * -AccScalar(0.2) + t20 * t1137 * r5) + t21 * t1137 * r5) +
+                  t22 * t1137 * r5) +
+                 t24 * (t1478 * c_a_tmp * AccScalar(2.0) + t784 * t784) * r5) -
+                t25 * (i_t3531_tmp * c_a_tmp * AccScalar(2.0) - t734 * t734) * r5)) -
+        t10 * ((t763_tmp * c_a_tmp * -AccScalar(0.5) + d_t3531_tmp * c_a_tmp / AccScalar(2.0)) + t855_tmp * c_a_tmp / AccScalar(2.0))) +
+       t9 * (((((gb_t3531_tmp * r3 + t19 * t112 * r3) + hb_t3531_tmp * r3) + t23 * t915 * r3) + t24 * t915 * r3) +
+             t25 * t915 * r3)) +
       dt_lim * ((db_t3531_tmp + eb_t3531_tmp) + fb_t3531_tmp);
   Q_d(4, 5) = t166;
   Q_d(4, 6) = t3514;
@@ -2174,23 +2199,23 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   Q_d(5, 3) = t158;
   Q_d(5, 4) = t166;
   Q_d(5, 5) =
-      ((((((t40 * ((t21 * t1493 / 9.0 + t22 * t1495 / 9.0) + t20 * t1500 / 9.0) +
-            t11 * (((((t23 * (a_tmp * t3511_tmp * 2.0 + t733 * t733) / 5.0 + t20 * t1136 / 5.0) + t21 * t1136 / 5.0) +
-                     t22 * t1136 / 5.0) +
-                    t24 * (t742 * t742 + t1475 * a_tmp * 2.0) / 5.0) +
-                   t25 * (t786 * t786 - t1477 * a_tmp * 2.0) / 5.0)) +
-           t10 * ((t3518_tmp * a_tmp * -0.5 + t776_tmp * a_tmp / 2.0) + b_t3511_tmp * a_tmp / 2.0)) -
-          t39 * ((b_t3518_tmp * j_a_tmp / 4.0 - t3516_tmp * t1484 / 4.0) + c_t3511_tmp * t1486 / 4.0)) +
+      ((((((t40 * ((t21 * t1493 * r9 + t22 * t1495 * r9) + t20 * t1500 * r9) +
+            t11 * (((((t23 * (a_tmp * t3511_tmp * AccScalar(2.0) + t733 * t733) * r5 + t20 * t1136 * r5) + t21 * t1136 * r5) +
+                     t22 * t1136 * r5) +
+                    t24 * (t742 * t742 + t1475 * a_tmp * AccScalar(2.0)) * r5) +
+                   t25 * (t786 * t786 - t1477 * a_tmp * AccScalar(2.0)) * r5)) +
+           t10 * ((t3518_tmp * a_tmp * -AccScalar(0.5) + t776_tmp * a_tmp / AccScalar(2.0)) + b_t3511_tmp * a_tmp / AccScalar(2.0))) -
+          t39 * ((b_t3518_tmp * j_a_tmp / AccScalar(4.0) - t3516_tmp * t1484 / AccScalar(4.0)) + c_t3511_tmp * t1486 / AccScalar(4.0))) +
          t13 *
-             (((((t20 * t2975 / 7.0 + t22 * t2980 / 7.0) + t24 * (t1475 * t1475) / 7.0) + t25 * (t1477 * t1477) / 7.0) +
-               t21 * t2 / 7.0) +
-              t23 * (t3511_tmp * t3511_tmp) / 7.0)) +
-        t12 * (((((t776 * t1475 - t3518_tmp * t3511_tmp / 3.0) - b_t3518_tmp * d_a_tmp / 3.0) +
-                 t3516_tmp * d_a_tmp / 3.0) +
-                c_t3511_tmp * d_a_tmp / 3.0) -
-               b_t3511_tmp * t1477 / 3.0)) +
-       t9 * (((((t88 / 3.0 + t17 * t113 / 3.0) + t90 / 3.0) + t23 * t914 / 3.0) + t24 * t914 / 3.0) +
-             t25 * t914 / 3.0)) +
+             (((((t20 * t2975 * r7 + t22 * t2980 * r7) + t24 * (t1475 * t1475) * r7) + t25 * (t1477 * t1477) * r7) +
+               t21 * t2 * r7) +
+              t23 * (t3511_tmp * t3511_tmp) * r7)) +
+        t12 * (((((t776 * t1475 - t3518_tmp * t3511_tmp * r3) - b_t3518_tmp * d_a_tmp * r3) +
+                 t3516_tmp * d_a_tmp * r3) +
+                c_t3511_tmp * d_a_tmp * r3) -
+               b_t3511_tmp * t1477 * r3)) +
+       t9 * (((((t88 * r3 + t17 * t113 * r3) + t90 * r3) + t23 * t914 * r3) + t24 * t914 * r3) +
+             t25 * t914 * r3)) +
       dt_lim * ((t162_tmp + t68) + t89);
   Q_d(5, 6) = t3518;
   Q_d(5, 7) = t3516;
@@ -2209,20 +2234,20 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   Q_d(6, 5) = t3518;
   Q_d(6, 6) =
       ((((-t10 * (t316 + t340) + dt_lim * t23) +
-         t13 * ((t20 * (t311 * t311) / 7.0 + t21 * t91 * t92 / 252.0) + t22 * t91 * t93 / 252.0)) -
-        t12 * (t3044_tmp * t126 / 18.0 - b_t3044_tmp * t125 / 18.0)) +
-       t9 * (((t20 / 3.0 - t23 * (t92 + t93) / 3.0) + t25 * t118) + t24 * t121)) +
-      t11 * (((((t20 * (t118 + t121) * -0.2 + t21 * t141 / 5.0) + t22 * t140 / 5.0) + t23 * (t308 * t308) / 5.0) +
-              t24 * t91 * t92 / 20.0) +
-             t25 * t91 * t93 / 20.0);
+         t13 * ((t20 * (t311 * t311) * r7 + t21 * t91 * t92 * r252) + t22 * t91 * t93 * r252)) -
+        t12 * (t3044_tmp * t126 * r18 - b_t3044_tmp * t125 * r18)) +
+       t9 * (((t20 * r3 - t23 * (t92 + t93) * r3) + t25 * t118) + t24 * t121)) +
+      t11 * (((((t20 * (t118 + t121) * -AccScalar(0.2) + t21 * t141 * r5) + t22 * t140 * r5) + t23 * (t308 * t308) * r5) +
+              t24 * t91 * t92 * r20) +
+             t25 * t91 * t93 * r20);
   Q_d(6, 7) = t3044;
   Q_d(6, 8) = t3045;
   Q_d(6, 9) = t535;
   Q_d(6, 10) = t539;
   Q_d(6, 11) = t543;
-  Q_d(6, 12) = 0.0;
-  Q_d(6, 13) = 0.0;
-  Q_d(6, 14) = 0.0;
+  Q_d(6, 12) = AccScalar(0.0);
+  Q_d(6, 13) = AccScalar(0.0);
+  Q_d(6, 14) = AccScalar(0.0);
   Q_d(7, 0) = t156;
   Q_d(7, 1) = t3519;
   Q_d(7, 2) = t3525;
@@ -2234,19 +2259,19 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   t3 = t23 * t91;
   Q_d(7, 7) =
       ((((t10 * (t315 + t340) + dt_lim * t24) +
-         t13 * ((t21 * (t310 * t310) / 7.0 + t6 * t92 / 252.0) + t22 * t92 * t93 / 252.0)) +
-        t12 * (d_t3043_tmp * t126 / 18.0 - c_t3043_tmp * t124 / 18.0)) +
-       t9 * (((t21 / 3.0 - t24 * (t91 + t93) / 3.0) + t25 * t116) + t23 * t121)) +
-      t11 * (((((t21 * (t116 + t121) * -0.2 + t20 * t141 / 5.0) + t22 * t139 / 5.0) + t24 * (t307 * t307) / 5.0) +
-              t3 * t92 / 20.0) +
-             t25 * t92 * t93 / 20.0);
+         t13 * ((t21 * (t310 * t310) * r7 + t6 * t92 * r252) + t22 * t92 * t93 * r252)) +
+        t12 * (d_t3043_tmp * t126 * r18 - c_t3043_tmp * t124 * r18)) +
+       t9 * (((t21 * r3 - t24 * (t91 + t93) * r3) + t25 * t116) + t23 * t121)) +
+      t11 * (((((t21 * (t116 + t121) * -AccScalar(0.2) + t20 * t141 * r5) + t22 * t139 * r5) + t24 * (t307 * t307) * r5) +
+              t3 * t92 * r20) +
+             t25 * t92 * t93 * r20);
   Q_d(7, 8) = t3043;
   Q_d(7, 9) = t541;
   Q_d(7, 10) = t536;
   Q_d(7, 11) = t540;
-  Q_d(7, 12) = 0.0;
-  Q_d(7, 13) = 0.0;
-  Q_d(7, 14) = 0.0;
+  Q_d(7, 12) = AccScalar(0.0);
+  Q_d(7, 13) = AccScalar(0.0);
+  Q_d(7, 14) = AccScalar(0.0);
   Q_d(8, 0) = t71;
   Q_d(8, 1) = t3522;
   Q_d(8, 2) = t3520;
@@ -2256,19 +2281,19 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   Q_d(8, 6) = t3045;
   Q_d(8, 7) = t3043;
   Q_d(8, 8) =
-      ((((dt_lim * t25 + t13 * ((t22 * (t309 * t309) / 7.0 + t6 * t93 / 252.0) + t21 * t92 * t93 / 252.0)) -
+      ((((dt_lim * t25 + t13 * ((t22 * (t309 * t309) * r7 + t6 * t93 * r252) + t21 * t92 * t93 * r252)) -
          t10 * (t315 - t316)) -
-        t12 * (t3043_tmp * t125 / 18.0 - b_t3043_tmp * t124 / 18.0)) +
-       t9 * (((t22 / 3.0 - t25 * (t91 + t92) / 3.0) + t24 * t116) + t23 * t118)) +
-      t11 * (((((t22 * (t116 + t118) * -0.2 + t20 * t140 / 5.0) + t21 * t139 / 5.0) + t25 * (t306 * t306) / 5.0) +
-              t3 * t93 / 20.0) +
-             t24 * t92 * t93 / 20.0);
+        t12 * (t3043_tmp * t125 * r18 - b_t3043_tmp * t124 * r18)) +
+       t9 * (((t22 * r3 - t25 * (t91 + t92) * r3) + t24 * t116) + t23 * t118)) +
+      t11 * (((((t22 * (t116 + t118) * -AccScalar(0.2) + t20 * t140 * r5) + t21 * t139 * r5) + t25 * (t306 * t306) * r5) +
+              t3 * t93 * r20) +
+             t24 * t92 * t93 * r20);
   Q_d(8, 9) = t538;
   Q_d(8, 10) = t542;
   Q_d(8, 11) = t537;
-  Q_d(8, 12) = 0.0;
-  Q_d(8, 13) = 0.0;
-  Q_d(8, 14) = 0.0;
+  Q_d(8, 12) = AccScalar(0.0);
+  Q_d(8, 13) = AccScalar(0.0);
+  Q_d(8, 14) = AccScalar(0.0);
   Q_d(9, 0) = t2998;
   Q_d(9, 1) = t2996;
   Q_d(9, 2) = t2989;
@@ -2279,11 +2304,11 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   Q_d(9, 7) = t541;
   Q_d(9, 8) = t538;
   Q_d(9, 9) = dt_lim * t20;
-  Q_d(9, 10) = 0.0;
-  Q_d(9, 11) = 0.0;
-  Q_d(9, 12) = 0.0;
-  Q_d(9, 13) = 0.0;
-  Q_d(9, 14) = 0.0;
+  Q_d(9, 10) = AccScalar(0.0);
+  Q_d(9, 11) = AccScalar(0.0);
+  Q_d(9, 12) = AccScalar(0.0);
+  Q_d(9, 13) = AccScalar(0.0);
+  Q_d(9, 14) = AccScalar(0.0);
   Q_d(10, 0) = t2990;
   Q_d(10, 1) = t3000;
   Q_d(10, 2) = t2992;
@@ -2293,12 +2318,12 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   Q_d(10, 6) = t539;
   Q_d(10, 7) = t536;
   Q_d(10, 8) = t542;
-  Q_d(10, 9) = 0.0;
+  Q_d(10, 9) = AccScalar(0.0);
   Q_d(10, 10) = dt_lim * t21;
-  Q_d(10, 11) = 0.0;
-  Q_d(10, 12) = 0.0;
-  Q_d(10, 13) = 0.0;
-  Q_d(10, 14) = 0.0;
+  Q_d(10, 11) = AccScalar(0.0);
+  Q_d(10, 12) = AccScalar(0.0);
+  Q_d(10, 13) = AccScalar(0.0);
+  Q_d(10, 14) = AccScalar(0.0);
   Q_d(11, 0) = t2993;
   Q_d(11, 1) = t2991;
   Q_d(11, 2) = t2999;
@@ -2308,58 +2333,71 @@ CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eig
   Q_d(11, 6) = t543;
   Q_d(11, 7) = t540;
   Q_d(11, 8) = t537;
-  Q_d(11, 9) = 0.0;
-  Q_d(11, 10) = 0.0;
+  Q_d(11, 9) = AccScalar(0.0);
+  Q_d(11, 10) = AccScalar(0.0);
   Q_d(11, 11) = dt_lim * t22;
-  Q_d(11, 12) = 0.0;
-  Q_d(11, 13) = 0.0;
-  Q_d(11, 14) = 0.0;
+  Q_d(11, 12) = AccScalar(0.0);
+  Q_d(11, 13) = AccScalar(0.0);
+  Q_d(11, 14) = AccScalar(0.0);
   Q_d(12, 0) = t401;
   Q_d(12, 1) = t183;
   Q_d(12, 2) = t225;
   Q_d(12, 3) = t398;
   Q_d(12, 4) = t161;
   Q_d(12, 5) = t160;
-  Q_d(12, 6) = 0.0;
-  Q_d(12, 7) = 0.0;
-  Q_d(12, 8) = 0.0;
-  Q_d(12, 9) = 0.0;
-  Q_d(12, 10) = 0.0;
-  Q_d(12, 11) = 0.0;
+  Q_d(12, 6) = AccScalar(0.0);
+  Q_d(12, 7) = AccScalar(0.0);
+  Q_d(12, 8) = AccScalar(0.0);
+  Q_d(12, 9) = AccScalar(0.0);
+  Q_d(12, 10) = AccScalar(0.0);
+  Q_d(12, 11) = AccScalar(0.0);
   Q_d(12, 12) = dt_lim * t17;
-  Q_d(12, 13) = 0.0;
-  Q_d(12, 14) = 0.0;
+  Q_d(12, 13) = AccScalar(0.0);
+  Q_d(12, 14) = AccScalar(0.0);
   Q_d(13, 0) = t226;
   Q_d(13, 1) = t402;
   Q_d(13, 2) = t184;
   Q_d(13, 3) = t162;
   Q_d(13, 4) = t399;
   Q_d(13, 5) = t163;
-  Q_d(13, 6) = 0.0;
-  Q_d(13, 7) = 0.0;
-  Q_d(13, 8) = 0.0;
-  Q_d(13, 9) = 0.0;
-  Q_d(13, 10) = 0.0;
-  Q_d(13, 11) = 0.0;
-  Q_d(13, 12) = 0.0;
+  Q_d(13, 6) = AccScalar(0.0);
+  Q_d(13, 7) = AccScalar(0.0);
+  Q_d(13, 8) = AccScalar(0.0);
+  Q_d(13, 9) = AccScalar(0.0);
+  Q_d(13, 10) = AccScalar(0.0);
+  Q_d(13, 11) = AccScalar(0.0);
+  Q_d(13, 12) = AccScalar(0.0);
   Q_d(13, 13) = dt_lim * t18;
-  Q_d(13, 14) = 0.0;
+  Q_d(13, 14) = AccScalar(0.0);
   Q_d(14, 0) = t185;
   Q_d(14, 1) = t227;
   Q_d(14, 2) = t403;
   Q_d(14, 3) = t165;
   Q_d(14, 4) = t164;
   Q_d(14, 5) = t400;
-  Q_d(14, 6) = 0.0;
-  Q_d(14, 7) = 0.0;
-  Q_d(14, 8) = 0.0;
-  Q_d(14, 9) = 0.0;
-  Q_d(14, 10) = 0.0;
-  Q_d(14, 11) = 0.0;
-  Q_d(14, 12) = 0.0;
-  Q_d(14, 13) = 0.0;
+  Q_d(14, 6) = AccScalar(0.0);
+  Q_d(14, 7) = AccScalar(0.0);
+  Q_d(14, 8) = AccScalar(0.0);
+  Q_d(14, 9) = AccScalar(0.0);
+  Q_d(14, 10) = AccScalar(0.0);
+  Q_d(14, 11) = AccScalar(0.0);
+  Q_d(14, 12) = AccScalar(0.0);
+  Q_d(14, 13) = AccScalar(0.0);
   Q_d(14, 14) = dt_lim * t19;
 
   return Q_d;
 }
+
+CoreStateMatrix CoreState::CalcQSmallAngleApprox(const double& dt_lim, const Eigen::Quaterniond& q_wi,
+                                                 const Eigen::Vector3d& a_m, const Eigen::Vector3d& n_a,
+                                                 const Eigen::Vector3d& b_a, const Eigen::Vector3d& n_ba,
+                                                 const Eigen::Vector3d& w_m, const Eigen::Vector3d& n_w,
+                                                 const Eigen::Vector3d& b_w, const Eigen::Vector3d& n_bw)
+{
+  return CoreStateKernelsDouble::CalcQSmallAngleApprox(dt_lim, q_wi, a_m, n_a, b_a, n_ba, w_m, n_w, b_w, n_bw);
+}
+
+template class CoreStateKernels<double, double>;
+template class CoreStateKernels<float, float>;
+template class CoreStateKernels<float, double>;
 }  // namespace mars
@@ -8,6 +8,7 @@
 //
 // You can contact the author at <christian.brommer@ieee.org>
 
+#include <mars/core_state_kernels.h>
 #include <mars/ekf.h>
 #include <mars/general_functions/utils.h>
 #include <Eigen/Dense>
@@ -16,16 +17,8 @@ namespace mars
 {
 Eigen::MatrixXd Ekf::CalculateStateCorrection()
 {
-  // Calculate innovation
-  S_ = H_ * P_ * H_.transpose() + R_;
-  S_ = Utils::EnforceMatrixSymmetry(S_);
-
-  // Calculate Klamen Gain
-  K_ = P_ * H_.transpose() * S_.inverse();
-
-  // Calculate Correction
-  Eigen::MatrixXd correction = K_ * res_;
-
+  Eigen::MatrixXd correction;
+  CoreStateKernelsDouble::CalculateCorrection(H_, R_, res_, P_, &workspace_, &K_, &S_, &correction);
   return correction;
 }
 
@@ -36,27 +29,33 @@ Eigen::MatrixXd Ekf::CalculateCorrection()
 
 Eigen::MatrixXd Ekf::CalculateCorrection(Chi2* chi2)
 {
-  Eigen::MatrixXd corr = CalculateStateCorrection();
+  Eigen::MatrixXd corr;
+  CalculateCorrection(chi2, &corr);
+  return corr;
+}
+
+void Ekf::CalculateCorrection(Chi2* chi2, Eigen::MatrixXd* correction)
+{
+  CoreStateKernelsDouble::CalculateCorrection(H_, R_, res_, P_, &workspace_, &K_, &S_, correction);
 
   if (chi2->do_test_)
   {
-    chi2->CalculateChi2(res_, S_);
+    chi2->CalculateChi2WithInverse(res_, workspace_.S_inv_);
   }
-
-  return corr;
 }
 
 Eigen::MatrixXd Ekf::CalculateCovUpdate()
 {
   // Calculate ErrorState Covariance
-  int64_t state_size = H_.cols();
-
-  Eigen::MatrixXd I_state = Eigen::MatrixXd::Identity(state_size, state_size);
-
-  Eigen::MatrixXd KH = I_state - K_ * H_;
-  Eigen::MatrixXd updated_P = KH * P_ * KH.transpose() + K_ * R_ * K_.transpose();
+  Eigen::MatrixXd cov;
+  CalculateCovUpdate(&cov);
+  return cov;
+}
 
-  return updated_P;
+void Ekf::CalculateCovUpdate(Eigen::MatrixXd* cov)
+{
+  // Calculate ErrorState Covariance
+  CoreStateKernelsDouble::CalculateCovUpdate(H_, R_, P_, K_, &workspace_, cov);
 }
 
 Chi2::Chi2() : dist_(3)  // Using 3 as a dummy value
@@ -104,12 +103,28 @@ bool Chi2::CalculateChi2(const Eigen::MatrixXd& res, const Eigen::MatrixXd& S)
   return passed_;
 }
 
+bool Chi2::CalculateChi2WithInverse(const Eigen::MatrixXd& res, const Eigen::MatrixXd& S_inv)
+{
+  weighted_res_.noalias() = res.transpose() * S_inv;
+  double X2 = weighted_res_.row(0).dot(res.col(0));
+  passed_ = X2 < ucv_;  // boolean expression
+
+  last_res_ = res;
+  last_X2_ = X2;
+  return passed_;
+}
+
 void Chi2::get_result(Eigen::MatrixXd* const last_res, double* const last_X2) const
 {
   *last_res = last_res_;
   *last_X2 = last_X2_;
 }
 
+double Chi2::get_last_X2() const
+{
+  return last_X2_;
+}
+
 void Chi2::PrintReport(const std::string& name)
 {
   if (do_test_)
@@ -0,0 +1,334 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/filter_server.h>
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+namespace mars
+{
+FilterServer::FilterServer(const unsigned int& num_threads)
+{
+  unsigned int num_workers = num_threads;
+  if (num_workers == 0)
+  {
+    num_workers = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  for (unsigned int k = 0; k < num_workers; k++)
+  {
+    workers_.emplace_back(new Worker());
+  }
+
+  for (unsigned int k = 0; k < num_workers; k++)
+  {
+    threads_.emplace_back(&FilterServer::WorkerLoop, this, static_cast<size_t>(k));
+  }
+
+  std::cout << "Created: FilterServer (Threads=" << num_workers << ")" << std::endl;
+}
+
+FilterServer::~FilterServer()
+{
+  Stop();
+}
+
+bool FilterServer::AddStream(const int& stream_id, std::shared_ptr<CoreLogic> core_logic)
+{
+  if (core_logic == nullptr)
+  {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(streams_mutex_);
+
+  if (streams_.count(stream_id))
+  {
+    std::cout << "FilterServer: Warning: Stream " << stream_id << " already exists" << std::endl;
+    return false;
+  }
+
+  std::unique_ptr<Stream> stream(new Stream());
+  stream->core_logic_ = std::move(core_logic);
+  streams_[stream_id] = std::move(stream);
+
+  return true;
+}
+
+std::shared_ptr<CoreLogic> FilterServer::get_core_logic(const int& stream_id)
+{
+  std::lock_guard<std::mutex> lock(streams_mutex_);
+
+  auto it = streams_.find(stream_id);
+  if (it == streams_.end())
+  {
+    return nullptr;
+  }
+
+  return it->second->core_logic_;
+}
+
+bool FilterServer::Submit(const int& stream_id, std::shared_ptr<SensorAbsClass> sensor, const Time& timestamp,
+                          const BufferDataType& data)
+{
+  Stream* stream = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+
+    auto it = streams_.find(stream_id);
+    if (it == streams_.end())
+    {
+      std::cout << "FilterServer: Warning: Stream " << stream_id << " does not exist" << std::endl;
+      return false;
+    }
+
+    stream = it->second.get();
+  }
+
+  // The measurement is counted with the stop check, Stop() processes all measurements counted before the stop
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    if (stop_)
+    {
+      return false;
+    }
+
+    num_pending_meas_++;
+  }
+
+  bool schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(stream->mutex_);
+    stream->queue_.push_back({ std::move(sensor), timestamp, data, Clock::now() });
+    stream->stats_.backlog_ = stream->queue_.size();
+
+    if (!stream->scheduled_)
+    {
+      stream->scheduled_ = true;
+      schedule = true;
+    }
+  }
+
+  if (schedule)
+  {
+    Schedule(stream, next_worker_++ % workers_.size());
+  }
+
+  return true;
+}
+
+void FilterServer::WaitIdle()
+{
+  std::unique_lock<std::mutex> lock(wake_mutex_);
+  idle_cv_.wait(lock, [this] { return num_pending_meas_ == 0; });
+}
+
+void FilterServer::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    stop_ = true;
+  }
+  wake_cv_.notify_all();
+
+  for (auto& thread : threads_)
+  {
+    if (thread.joinable())
+    {
+      thread.join();
+    }
+  }
+}
+
+bool FilterServer::get_stream_stats(const int& stream_id, FilterStreamStats* stats)
+{
+  Stream* stream = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+
+    auto it = streams_.find(stream_id);
+    if (it == streams_.end())
+    {
+      return false;
+    }
+
+    stream = it->second.get();
+  }
+
+  std::lock_guard<std::mutex> lock(stream->mutex_);
+  *stats = stream->stats_;
+  return true;
+}
+
+unsigned int FilterServer::get_num_threads() const
+{
+  return static_cast<unsigned int>(workers_.size());
+}
+
+uint64_t FilterServer::get_num_steals() const
+{
+  return num_steals_;
+}
+
+void FilterServer::Schedule(Stream* stream, const size_t& worker_idx)
+{
+  // The task counter is increased first, workers that wake up before the task is queued retry
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    num_queued_tasks_++;
+  }
+
+  {
+    Worker& worker = *workers_[worker_idx];
+    std::lock_guard<std::mutex> lock(worker.mutex_);
+    worker.tasks_.push_back(stream);
+  }
+
+  wake_cv_.notify_one();
+}
+
+bool FilterServer::PopTask(const size_t& worker_idx, Stream** stream)
+{
+  bool found = false;
+
+  // Own queue first, in order of scheduling
+  {
+    Worker& worker = *workers_[worker_idx];
+    std::lock_guard<std::mutex> lock(worker.mutex_);
+    if (!worker.tasks_.empty())
+    {
+      *stream = worker.tasks_.front();
+      worker.tasks_.pop_front();
+      found = true;
+    }
+  }
+
+  // Steal the most recently scheduled task of another worker
+  for (size_t k = 1; !found && k < workers_.size(); k++)
+  {
+    Worker& victim = *workers_[(worker_idx + k) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex_);
+    if (!victim.tasks_.empty())
+    {
+      *stream = victim.tasks_.back();
+      victim.tasks_.pop_back();
+      found = true;
+      num_steals_++;
+    }
+  }
+
+  if (found)
+  {
+    std::lock_guard<std::mutex> lock(wake_mutex_);
+    num_queued_tasks_--;
+  }
+
+  return found;
+}
+
+void FilterServer::RunStream(Stream* stream, const size_t& worker_idx)
+{
+  std::vector<PendingMeasurement> batch;
+  {
+    std::lock_guard<std::mutex> lock(stream->mutex_);
+    const size_t batch_size = std::min(std::max<size_t>(max_batch_size_, 1), stream->queue_.size());
+
+    batch.reserve(batch_size);
+    for (size_t k = 0; k < batch_size; k++)
+    {
+      batch.push_back(std::move(stream->queue_.front()));
+      stream->queue_.pop_front();
+    }
+  }
+
+  std::vector<double> latency(batch.size());
+  std::vector<bool> accepted(batch.size());
+
+  for (size_t k = 0; k < batch.size(); k++)
+  {
+    PendingMeasurement& meas = batch[k];
+    accepted[k] = stream->core_logic_->ProcessMeasurement(meas.sensor_, meas.timestamp_, meas.data_);
+    latency[k] = std::chrono::duration<double>(Clock::now() - meas.submit_time_).count();
+  }
+
+  bool reschedule = false;
+  {
+    std::lock_guard<std::mutex> lock(stream->mutex_);
+    FilterStreamStats& stats = stream->stats_;
+
+    for (size_t k = 0; k < batch.size(); k++)
+    {
+      stats.num_processed_++;
+      stats.num_rejected_ += accepted[k] ? 0 : 1;
+      stats.latency_mean_ += (latency[k] - stats.latency_mean_) / static_cast<double>(stats.num_processed_);
+      stats.latency_max_ = std::max(stats.latency_max_, latency[k]);
+      stats.latency_last_ = latency[k];
+    }
+    stats.num_batches_++;
+    stats.backlog_ = stream->queue_.size();
+
+    // Measurements that arrived during the batch are processed in a new task to keep the workers fair
+    if (stream->queue_.empty())
+    {
+      stream->scheduled_ = false;
+    }
+    else
+    {
+      reschedule = true;
+    }
+  }
+
+  if (reschedule)
+  {
+    Schedule(stream, worker_idx);
+  }
+
+  std::lock_guard<std::mutex> lock(wake_mutex_);
+  num_pending_meas_ -= batch.size();
+  if (num_pending_meas_ == 0)
+  {
+    idle_cv_.notify_all();
+
+    // Workers of a stopped server exit once the last pending measurement was processed
+    if (stop_)
+    {
+      wake_cv_.notify_all();
+    }
+  }
+}
+
+void FilterServer::WorkerLoop(const size_t& worker_idx)
+{
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(wake_mutex_);
+      wake_cv_.wait(lock, [this] { return num_queued_tasks_ > 0 || (stop_ && num_pending_meas_ == 0); });
+
+      // Measurements that were accepted concurrently to Stop() may not be scheduled yet, the workers wait for them
+      if (stop_ && num_pending_meas_ == 0)
+      {
+        return;
+      }
+    }
+
+    Stream* stream = nullptr;
+    if (PopTask(worker_idx, &stream))
+    {
+      RunStream(stream, worker_idx);
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+}
+}  // namespace mars
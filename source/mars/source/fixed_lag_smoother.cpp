@@ -0,0 +1,284 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/fixed_lag_smoother.h>
+#include <mars/realtime_profile.h>
+#include <mars/type_definitions/core_type.h>
+#include <iostream>
+#include <vector>
+
+namespace mars
+{
+namespace
+{
+///
+/// \brief ErrorStateDifference Error state which corrects 'reference' to 'state', the inverse of ApplyCorrection
+///
+CoreStateVector ErrorStateDifference(const CoreStateType& state, const CoreStateType& reference)
+{
+  CoreStateVector result;
+  result.segment<3>(0) = state.p_wi_ - reference.p_wi_;
+  result.segment<3>(3) = state.v_wi_ - reference.v_wi_;
+
+  Eigen::Quaterniond dq = reference.q_wi_.conjugate() * state.q_wi_;
+  if (dq.w() < 0)
+  {
+    dq.coeffs() *= -1;
+  }
+  result.segment<3>(6) = 2 * dq.vec();
+
+  result.segment<3>(9) = state.b_w_ - reference.b_w_;
+  result.segment<3>(12) = state.b_a_ - reference.b_a_;
+  return result;
+}
+}  // namespace
+
+FixedLagSmoother::FixedLagSmoother(const double& lag, const size_t& queue_capacity)
+  : lag_(lag), input_queue_(queue_capacity)
+{
+  std::cout << "Created: FixedLagSmoother (Lag=" << lag_ << "s)" << std::endl;
+}
+
+FixedLagSmoother::~FixedLagSmoother()
+{
+  Stop();
+}
+
+StateObserver FixedLagSmoother::get_observer()
+{
+  return [this](const BufferEntryType& entry, const bool& is_correction) { Push(entry, is_correction); };
+}
+
+bool FixedLagSmoother::Push(const BufferEntryType& entry, const bool& is_correction)
+{
+  if (!entry.data_.HasCoreStates())
+  {
+    return false;
+  }
+
+  return input_queue_.Push(entry, is_correction);
+}
+
+bool FixedLagSmoother::Start()
+{
+  if (running_.load())
+  {
+    return false;
+  }
+
+  stop_.store(false);
+  running_.store(true);
+  thread_ = std::thread(&FixedLagSmoother::Loop, this);
+  return true;
+}
+
+void FixedLagSmoother::Stop()
+{
+  if (!running_.load())
+  {
+    return;
+  }
+
+  stop_.store(true);
+  if (thread_.joinable())
+  {
+    thread_.join();
+  }
+  running_.store(false);
+}
+
+bool FixedLagSmoother::IsRunning() const
+{
+  return running_.load();
+}
+
+int FixedLagSmoother::ProcessPending()
+{
+  StateEvent event;
+  while (input_queue_.Pop(&event))
+  {
+    AddToWindow(event.entry_, event.is_correction_);
+  }
+
+  if (window_.empty())
+  {
+    return 0;
+  }
+
+  // Entries which are at least 'lag_' older than the newest state are final
+  const Time publish_until = window_.back().timestamp_ - Time(lag_);
+  int num_publish = 0;
+  while (num_publish < static_cast<int>(window_.size()) && window_[num_publish].timestamp_ <= publish_until)
+  {
+    num_publish++;
+  }
+
+  if (num_publish == 0)
+  {
+    return 0;
+  }
+
+  return SmoothAndPublish(num_publish);
+}
+
+int FixedLagSmoother::Flush()
+{
+  ProcessPending();
+  return SmoothAndPublish(static_cast<int>(window_.size()));
+}
+
+uint64_t FixedLagSmoother::get_num_smoothed() const
+{
+  return num_smoothed_.load(std::memory_order_relaxed);
+}
+
+uint64_t FixedLagSmoother::get_num_dropped() const
+{
+  return input_queue_.get_num_dropped();
+}
+
+uint64_t FixedLagSmoother::get_num_late_corrections() const
+{
+  return num_late_corrections_.load(std::memory_order_relaxed);
+}
+
+void FixedLagSmoother::AddToWindow(const BufferEntryType& entry, const bool& is_correction)
+{
+  if (has_published_ && entry.timestamp_ <= last_published_)
+  {
+    if (is_correction)
+    {
+      num_late_corrections_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return;
+  }
+
+  // A reworked state replaces all states after it, and the states of the same sensor at the same time
+  size_t cut = window_.size();
+  while (cut > 0 && window_[cut - 1].timestamp_ > entry.timestamp_)
+  {
+    cut--;
+  }
+
+  for (size_t k = cut; k > 0 && window_[k - 1].timestamp_ == entry.timestamp_; k--)
+  {
+    if (window_[k - 1].sensor_handle_ == entry.sensor_handle_)
+    {
+      cut = k - 1;
+    }
+  }
+
+  window_.erase(window_.begin() + static_cast<long>(cut), window_.end());
+  window_.push_back(entry);
+}
+
+int FixedLagSmoother::SmoothAndPublish(const int& num_publish)
+{
+  const int n = static_cast<int>(window_.size());
+  if (n == 0 || num_publish <= 0)
+  {
+    return 0;
+  }
+
+  std::vector<CoreType, Eigen::aligned_allocator<CoreType>> smoothed(static_cast<size_t>(num_publish));
+
+  // Backward pass, starting with the newest (filtered) state
+  CoreType smoothed_next = *static_cast<const CoreType*>(window_[n - 1].data_.core_state_.get());
+  if (num_publish == n)
+  {
+    smoothed[n - 1] = smoothed_next;
+  }
+
+  for (int k = n - 2; k >= 0; k--)
+  {
+    const CoreType& current = *static_cast<const CoreType*>(window_[k].data_.core_state_.get());
+    const CoreType& next = *static_cast<const CoreType*>(window_[k + 1].data_.core_state_.get());
+
+    CoreType result;
+    if (IsPropagationEntry(window_[k + 1]))
+    {
+      // The next entry holds the prediction from the current entry
+      const CoreStateMatrix& P_pred = next.cov_;
+      const CoreStateMatrix& F = next.state_transition_;
+
+      // G = P * F^T * P_pred^-1
+      const CoreStateMatrix G = P_pred.ldlt().solve(F * current.cov_).transpose();
+
+      result.state_ =
+          CoreStateType::ApplyCorrection(current.state_, G * ErrorStateDifference(smoothed_next.state_, next.state_));
+      result.cov_ = current.cov_ + G * (smoothed_next.cov_ - P_pred) * G.transpose();
+      result.cov_ = 0.5 * (result.cov_ + result.cov_.transpose());
+    }
+    else
+    {
+      // The next entry is an update of the current state without a transition, the gain is the identity
+      result.state_ =
+          CoreStateType::ApplyCorrection(current.state_, ErrorStateDifference(smoothed_next.state_, current.state_));
+      result.cov_ = smoothed_next.cov_;
+    }
+    result.state_transition_ = current.state_transition_;
+
+    if (k < num_publish)
+    {
+      smoothed[k] = result;
+    }
+    smoothed_next = result;
+  }
+
+  for (int k = 0; k < num_publish; k++)
+  {
+    BufferEntryType smoothed_entry(window_.front());
+    smoothed_entry.data_.set_core_state(std::make_shared<CoreType>(smoothed[k]));
+
+    last_published_ = smoothed_entry.timestamp_;
+    has_published_ = true;
+    window_.pop_front();
+
+    if (callback_)
+    {
+      callback_(smoothed_entry);
+    }
+
+    if (output_queue_ != nullptr)
+    {
+      output_queue_->Push(smoothed_entry, false);
+    }
+  }
+
+  num_smoothed_.fetch_add(static_cast<uint64_t>(num_publish), std::memory_order_relaxed);
+  return num_publish;
+}
+
+bool FixedLagSmoother::IsPropagationEntry(const BufferEntryType& entry) const
+{
+  return entry.sensor_handle_ == propagation_sensor_ && entry.metadata_ != BufferMetadataType::init;
+}
+
+void FixedLagSmoother::Loop()
+{
+  if (cpu_ >= 0)
+  {
+    RealtimeProfile::PinCurrentThread(cpu_);
+  }
+
+  while (!stop_.load())
+  {
+    if (input_queue_.get_size() == 0)
+    {
+      std::this_thread::sleep_for(idle_period_);
+      continue;
+    }
+
+    ProcessPending();
+  }
+
+  ProcessPending();
+}
+}  // namespace mars
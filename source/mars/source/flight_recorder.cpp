@@ -0,0 +1,358 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <fcntl.h>
+#include <mars/flight_recorder.h>
+#include <mars/type_definitions/core_type.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace mars
+{
+FlightRecorder::FlightRecorder(std::string file_name, const uint32_t& num_slots)
+  : file_name_(std::move(file_name)), num_slots_(num_slots > 0 ? num_slots : 1)
+{
+  file_size_ = flight::get_file_size(num_slots_);
+}
+
+FlightRecorder::~FlightRecorder()
+{
+  Close();
+}
+
+uint32_t FlightRecorder::get_num_slots_for_duration(const double& duration, const double& propagation_rate,
+                                                    const double& update_rate)
+{
+  const double records_per_second = 2 * propagation_rate + 3 * update_rate;
+  return static_cast<uint32_t>(std::max(1.0, std::ceil(duration * records_per_second)));
+}
+
+int FlightRecorder::RegisterSensor(const std::shared_ptr<SensorAbsClass>& sensor, JournalEncoder encoder)
+{
+  const int existing_id = FindSensorId(sensor.get());
+  if (existing_id >= 0)
+  {
+    sensors_[static_cast<size_t>(existing_id)].encoder = std::move(encoder);
+    return existing_id;
+  }
+
+  if (static_cast<int>(sensors_.size()) >= flight::kMaxSensors)
+  {
+    std::cout << "FlightRecorder: Warning: Max number of sensors reached, [" << sensor->name_ << "] is not registered"
+              << std::endl;
+    return -1;
+  }
+
+  const int sensor_id = static_cast<int>(sensors_.size());
+  sensors_.push_back({ sensor.get(), std::move(encoder) });
+
+  if (IsOpen())
+  {
+    std::strncpy(header_->sensor_names[sensor_id], sensor->name_.c_str(), flight::kMaxSensorNameLength - 1);
+    header_->num_sensors = static_cast<uint32_t>(sensors_.size());
+  }
+
+  return sensor_id;
+}
+
+bool FlightRecorder::Open()
+{
+  if (IsOpen())
+  {
+    return true;
+  }
+
+  const int fd = open(file_name_.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+  if (fd < 0)
+  {
+    std::cout << "FlightRecorder: Warning: Could not open file " << file_name_ << std::endl;
+    return false;
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(file_size_)) != 0)
+  {
+    std::cout << "FlightRecorder: Warning: Could not resize file " << file_name_ << std::endl;
+    close(fd);
+    return false;
+  }
+
+  void* mapping = mmap(nullptr, file_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (mapping == MAP_FAILED)
+  {
+    std::cout << "FlightRecorder: Warning: Could not map file " << file_name_ << std::endl;
+    return false;
+  }
+
+  mapping_ = mapping;
+
+  // Touch all pages now, such that recording does not fault in new pages of the file
+  std::memset(mapping_, 0, file_size_);
+
+  header_ = static_cast<flight::FlightRecorderHeader*>(mapping_);
+  slots_ = reinterpret_cast<flight::FlightRecordSlot*>(static_cast<char*>(mapping_) +
+                                                        sizeof(flight::FlightRecorderHeader));
+
+  header_->version = flight::kFlightRecorderVersion;
+  header_->num_slots = num_slots_;
+  header_->slot_size = sizeof(flight::FlightRecordSlot);
+  header_->num_sensors = static_cast<uint32_t>(sensors_.size());
+  for (size_t k = 0; k < sensors_.size(); k++)
+  {
+    std::strncpy(header_->sensor_names[k], sensors_[k].sensor->name_.c_str(), flight::kMaxSensorNameLength - 1);
+  }
+  header_->write_count.store(0, std::memory_order_relaxed);
+  count_ = 0;
+
+  // The magic is written last, a file with a valid magic has a complete header
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = flight::kFlightRecorderMagic;
+
+  std::cout << "Created: FlightRecorder (" << file_name_ << ", Slots=" << num_slots_ << ")" << std::endl;
+  return true;
+}
+
+void FlightRecorder::Close()
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+
+  munmap(mapping_, file_size_);
+
+  mapping_ = nullptr;
+  header_ = nullptr;
+  slots_ = nullptr;
+}
+
+bool FlightRecorder::IsOpen() const
+{
+  return mapping_ != nullptr;
+}
+
+void FlightRecorder::RecordMeasurement(const SensorAbsClass* sensor, const Time& timestamp,
+                                       const BufferDataType& data)
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+
+  const int sensor_id = FindSensorId(sensor);
+  flight::FlightRecord* record = BeginRecord(timestamp.get_seconds(), sensor_id, flight::RecordType::measurement);
+
+  const JournalEncoder* encoder = sensor_id >= 0 ? &sensors_[static_cast<size_t>(sensor_id)].encoder : nullptr;
+  if (encoder != nullptr && *encoder)
+  {
+    const int num_values = (*encoder)(data.measurement_, record->values, flight::kMaxValues);
+    record->num_values = std::max(0, std::min(num_values, flight::kMaxValues));
+  }
+
+  EndRecord();
+}
+
+void FlightRecorder::RecordState(const BufferEntryType& entry, const bool& is_correction)
+{
+  if (!IsOpen() || !entry.data_.HasCoreStates())
+  {
+    return;
+  }
+
+  const CoreType* core = static_cast<const CoreType*>(entry.data_.core_state_.get());
+  flight::FlightRecord* record =
+      BeginRecord(entry.timestamp_.get_seconds(), FindSensorId(entry.sensor_handle_.get()), flight::RecordType::state);
+
+  record->flags = is_correction ? flight::kFlagCorrection : 0;
+
+  const CoreStateType& state = core->state_;
+  double* x = record->values;
+  Eigen::Map<Eigen::Vector3d>(x + 0) = state.p_wi_;
+  Eigen::Map<Eigen::Vector3d>(x + 3) = state.v_wi_;
+  x[6] = state.q_wi_.w();
+  Eigen::Map<Eigen::Vector3d>(x + 7) = state.q_wi_.vec();
+  Eigen::Map<Eigen::Vector3d>(x + 10) = state.b_w_;
+  Eigen::Map<Eigen::Vector3d>(x + 13) = state.b_a_;
+  Eigen::Map<Eigen::Vector3d>(x + 16) = state.w_m_;
+  Eigen::Map<Eigen::Vector3d>(x + 19) = state.a_m_;
+  Eigen::Map<CoreStateVector>(x + 22) = core->cov_.diagonal();
+  record->num_values = 22 + CoreStateType::size_error_;
+
+  EndRecord();
+}
+
+void FlightRecorder::RecordUpdate(const SensorAbsClass* sensor, const Time& timestamp, const Chi2* chi2,
+                                  const bool& nearest_cov_corrected, const bool& successful)
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+
+  flight::FlightRecord* record = BeginRecord(timestamp.get_seconds(), FindSensorId(sensor), flight::RecordType::update);
+
+  uint32_t flags = 0;
+  if (chi2 != nullptr && chi2->do_test_)
+  {
+    flags |= flight::kFlagChi2Tested;
+    flags |= chi2->passed_ ? flight::kFlagChi2Passed : 0;
+    record->chi2 = chi2->get_last_X2();
+    record->ucv = chi2->ucv_;
+  }
+  flags |= nearest_cov_corrected ? flight::kFlagNearestCovCorrected : 0;
+  flags |= successful ? flight::kFlagUpdateSuccessful : 0;
+  record->flags = flags;
+
+  EndRecord();
+}
+
+uint64_t FlightRecorder::get_write_count() const
+{
+  if (!IsOpen())
+  {
+    return 0;
+  }
+
+  return header_->write_count.load(std::memory_order_relaxed);
+}
+
+bool FlightRecorder::Load(const std::string& file_name, FlightRecording* recording)
+{
+  const int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cout << "FlightRecorder: Warning: Could not open file " << file_name << std::endl;
+    return false;
+  }
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || static_cast<size_t>(file_stat.st_size) < sizeof(flight::FlightRecorderHeader))
+  {
+    std::cout << "FlightRecorder: Warning: File " << file_name << " is too small" << std::endl;
+    close(fd);
+    return false;
+  }
+
+  const size_t file_size = static_cast<size_t>(file_stat.st_size);
+  void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (mapping == MAP_FAILED)
+  {
+    std::cout << "FlightRecorder: Warning: Could not map file " << file_name << std::endl;
+    return false;
+  }
+
+  const auto* header = static_cast<const flight::FlightRecorderHeader*>(mapping);
+  if (header->magic != flight::kFlightRecorderMagic || header->version != flight::kFlightRecorderVersion ||
+      header->slot_size != sizeof(flight::FlightRecordSlot) || file_size < flight::get_file_size(header->num_slots))
+  {
+    std::cout << "FlightRecorder: Warning: File " << file_name << " has an unknown layout" << std::endl;
+    munmap(mapping, file_size);
+    return false;
+  }
+
+  const auto* slots = reinterpret_cast<const flight::FlightRecordSlot*>(static_cast<const char*>(mapping) +
+                                                                         sizeof(flight::FlightRecorderHeader));
+
+  recording->sensor_names_.clear();
+  const uint32_t num_sensors = std::min(header->num_sensors, static_cast<uint32_t>(flight::kMaxSensors));
+  for (uint32_t k = 0; k < num_sensors; k++)
+  {
+    recording->sensor_names_.emplace_back(header->sensor_names[k],
+                                          strnlen(header->sensor_names[k], flight::kMaxSensorNameLength));
+  }
+
+  // Slots are collected by their sequence, the write count may lag behind the last complete record after a crash
+  std::vector<std::pair<uint64_t, uint32_t>> order;
+  order.reserve(header->num_slots);
+  recording->num_torn_ = 0;
+  for (uint32_t k = 0; k < header->num_slots; k++)
+  {
+    const uint64_t seq = slots[k].seq.load(std::memory_order_relaxed);
+    if (seq == 0)
+    {
+      continue;
+    }
+
+    if (seq % 2 == 1)
+    {
+      recording->num_torn_++;
+      continue;
+    }
+
+    order.emplace_back(seq, k);
+  }
+  std::sort(order.begin(), order.end());
+
+  recording->records_.clear();
+  recording->records_.reserve(order.size());
+  for (const auto& it : order)
+  {
+    recording->records_.push_back(slots[it.second].record);
+  }
+
+  recording->write_count_ = order.empty() ? 0 : order.back().first / 2;
+
+  munmap(mapping, file_size);
+  return true;
+}
+
+int FlightRecorder::FindSensorId(const SensorAbsClass* sensor) const
+{
+  for (size_t k = 0; k < sensors_.size(); k++)
+  {
+    if (sensors_[k].sensor == sensor)
+    {
+      return static_cast<int>(k);
+    }
+  }
+
+  return -1;
+}
+
+flight::FlightRecord* FlightRecorder::BeginRecord(const double& timestamp, const int& sensor_id,
+                                                  const flight::RecordType& type)
+{
+  count_++;
+  flight::FlightRecordSlot& slot = slots_[(count_ - 1) % num_slots_];
+
+  // Sequence lock, odd while writing
+  slot.seq.store(2 * count_ - 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  flight::FlightRecord& record = slot.record;
+  record.timestamp = timestamp;
+  record.wall_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  record.sensor_id = sensor_id;
+  record.type = static_cast<uint32_t>(type);
+  record.flags = 0;
+  record.num_values = 0;
+  record.chi2 = 0;
+  record.ucv = 0;
+
+  return &record;
+}
+
+void FlightRecorder::EndRecord()
+{
+  slots_[(count_ - 1) % num_slots_].seq.store(2 * count_, std::memory_order_release);
+  header_->write_count.store(count_, std::memory_order_release);
+}
+}  // namespace mars
@@ -0,0 +1,147 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/journal_replayer.h>
+#include <iostream>
+#include <utility>
+
+namespace mars
+{
+JournalReplayer::JournalReplayer(std::string file_name) : file_name_(std::move(file_name))
+{
+  values_.resize(journal::kMaxValues);
+  std::cout << "Created: JournalReplayer (" << file_name_ << ")" << std::endl;
+}
+
+bool JournalReplayer::Open()
+{
+  file_.open(file_name_, std::ios::in | std::ios::binary);
+  if (!file_.is_open())
+  {
+    std::cout << "JournalReplayer: Warning: Could not open file " << file_name_ << std::endl;
+    return false;
+  }
+
+  journal::JournalFileHeader header{};
+  file_.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!file_ || header.magic != journal::kJournalMagic || header.version != journal::kJournalVersion)
+  {
+    std::cout << "JournalReplayer: Warning: " << file_name_ << " is not a valid journal" << std::endl;
+    file_.close();
+    return false;
+  }
+
+  sensors_.clear();
+  for (uint32_t k = 0; k < header.num_sensors; k++)
+  {
+    uint32_t name_length = 0;
+    file_.read(reinterpret_cast<char*>(&name_length), sizeof(name_length));
+
+    std::string name(name_length, '\0');
+    file_.read(&name[0], name_length);
+    if (!file_)
+    {
+      std::cout << "JournalReplayer: Warning: Incomplete sensor table in " << file_name_ << std::endl;
+      file_.close();
+      return false;
+    }
+
+    JournaledSensor sensor;
+    sensor.name = name;
+    sensors_.push_back(sensor);
+  }
+
+  return true;
+}
+
+std::vector<std::string> JournalReplayer::get_sensor_names() const
+{
+  std::vector<std::string> names;
+  for (const auto& k : sensors_)
+  {
+    names.push_back(k.name);
+  }
+  return names;
+}
+
+bool JournalReplayer::RegisterSensor(const std::string& name, const std::shared_ptr<SensorAbsClass>& sensor,
+                                     JournalDecoder decoder)
+{
+  for (auto& k : sensors_)
+  {
+    if (k.name == name)
+    {
+      k.sensor = sensor;
+      k.decoder = std::move(decoder);
+      return true;
+    }
+  }
+
+  std::cout << "JournalReplayer: Warning: Sensor [" << name << "] is not part of the journal" << std::endl;
+  return false;
+}
+
+bool JournalReplayer::ReadNext(JournalEntry* entry)
+{
+  if (!file_.is_open())
+  {
+    return false;
+  }
+
+  journal::JournalRecordHeader header{};
+  file_.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!file_ || header.sensor_id >= sensors_.size() || header.num_values > journal::kMaxValues)
+  {
+    return false;
+  }
+
+  file_.read(reinterpret_cast<char*>(values_.data()),
+             static_cast<std::streamsize>(header.num_values * sizeof(double)));
+  if (!file_)
+  {
+    return false;
+  }
+
+  const JournaledSensor& sensor = sensors_[header.sensor_id];
+
+  entry->sensor_id = static_cast<int>(header.sensor_id);
+  entry->sensor_name = sensor.name;
+  entry->sensor = sensor.sensor;
+  entry->timestamp = header.timestamp;
+  entry->arrival_ns = header.arrival_ns;
+  entry->data = BufferDataType();
+
+  if (sensor.decoder)
+  {
+    entry->data = BufferDataType(sensor.decoder(values_.data(), static_cast<int>(header.num_values)));
+  }
+
+  return true;
+}
+
+int JournalReplayer::Replay(CoreLogic* core_logic)
+{
+  int num_replayed = 0;
+  JournalEntry entry;
+
+  while (ReadNext(&entry))
+  {
+    if (entry.sensor == nullptr || entry.data.measurement_ == nullptr)
+    {
+      continue;
+    }
+
+    core_logic->ProcessMeasurement(entry.sensor, entry.timestamp, entry.data, entry.arrival_ns);
+    num_replayed++;
+  }
+
+  return num_replayed;
+}
+}  // namespace mars
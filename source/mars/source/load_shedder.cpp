@@ -0,0 +1,223 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/load_shedder.h>
+#include <algorithm>
+#include <iostream>
+
+namespace mars
+{
+LoadShedder::LoadShedder()
+{
+  std::cout << "Created: LoadShedder" << std::endl;
+}
+
+void LoadShedder::set_policy(const std::shared_ptr<SensorAbsClass>& sensor, const LoadSheddingPolicy& policy)
+{
+  SensorEntry* entry = FindSensor(sensor.get());
+  if (entry == nullptr)
+  {
+    entry = AddSensor(sensor);
+  }
+  entry->policy = policy;
+}
+
+bool LoadShedder::Admit(const std::shared_ptr<SensorAbsClass>& sensor, const Time& timestamp,
+                        const BufferDataType& data, const int64_t& arrival_ns)
+{
+  AdvanceTime(timestamp);
+
+  SensorEntry* entry = FindSensor(sensor.get());
+  if (entry == nullptr)
+  {
+    entry = AddSensor(sensor);
+  }
+
+  const bool force_admit = entry->policy.max_skip_ > 0 && entry->num_consecutive_shed >= entry->policy.max_skip_;
+  if (entry->policy.priority_ <= 0 || force_admit || HasBudget(*entry))
+  {
+    entry->stats.num_admitted_++;
+    entry->num_consecutive_shed = 0;
+    return true;
+  }
+
+  entry->num_consecutive_shed++;
+
+  if (entry->policy.mode_ == ShedMode::defer && static_cast<int>(pending_.size()) < max_pending_)
+  {
+    pending_.emplace_back(timestamp, data, sensor);
+    pending_.back().arrival_ns_ = arrival_ns;
+    entry->stats.num_deferred_++;
+    return false;
+  }
+
+  entry->stats.num_decimated_++;
+  return false;
+}
+
+void LoadShedder::ReportCost(const std::shared_ptr<SensorAbsClass>& sensor, const Time& timestamp, const double& cost)
+{
+  AdvanceTime(timestamp);
+
+  SensorEntry* entry = FindSensor(sensor.get());
+  if (entry == nullptr)
+  {
+    entry = AddSensor(sensor);
+  }
+
+  LoadShedderStats& stats = entry->stats;
+  stats.cost_ema_ = stats.num_costs_ == 0 ? cost : cost_ema_alpha_ * cost + (1 - cost_ema_alpha_) * stats.cost_ema_;
+  stats.cost_max_ = std::max(stats.cost_max_, cost);
+  stats.num_costs_++;
+
+  tokens_ -= deterministic_ ? entry->policy.nominal_cost_ : cost;
+}
+
+void LoadShedder::ReportOverhead(const Time& timestamp, const double& cost)
+{
+  AdvanceTime(timestamp);
+
+  overhead_ += cost;
+  if (!deterministic_)
+  {
+    tokens_ -= cost;
+  }
+}
+
+bool LoadShedder::PopDeferred(const Time& now, BufferEntryType* entry)
+{
+  AdvanceTime(now);
+
+  // Drop expired measurements
+  for (auto it = pending_.begin(); it != pending_.end();)
+  {
+    SensorEntry* sensor_entry = FindSensor(it->sensor_handle_.get());
+    if ((now - it->timestamp_).get_seconds() > sensor_entry->policy.max_defer_age_)
+    {
+      sensor_entry->stats.num_expired_++;
+      it = pending_.erase(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+
+  if (pending_.empty())
+  {
+    return false;
+  }
+
+  SensorEntry* sensor_entry = FindSensor(pending_.front().sensor_handle_.get());
+  if (!HasBudget(*sensor_entry))
+  {
+    return false;
+  }
+
+  *entry = pending_.front();
+  pending_.pop_front();
+  sensor_entry->stats.num_deferred_processed_++;
+  return true;
+}
+
+bool LoadShedder::get_stats(const std::shared_ptr<SensorAbsClass>& sensor, LoadShedderStats* stats) const
+{
+  const SensorEntry* entry = FindSensor(sensor.get());
+  if (entry == nullptr)
+  {
+    return false;
+  }
+
+  *stats = entry->stats;
+  return true;
+}
+
+double LoadShedder::get_tokens() const
+{
+  return tokens_;
+}
+
+int LoadShedder::get_num_pending() const
+{
+  return static_cast<int>(pending_.size());
+}
+
+double LoadShedder::get_overhead() const
+{
+  return overhead_;
+}
+
+LoadShedder::SensorEntry* LoadShedder::FindSensor(const SensorAbsClass* sensor)
+{
+  for (auto& k : sensors_)
+  {
+    if (k.sensor.get() == sensor)
+    {
+      return &k;
+    }
+  }
+  return nullptr;
+}
+
+const LoadShedder::SensorEntry* LoadShedder::FindSensor(const SensorAbsClass* sensor) const
+{
+  for (const auto& k : sensors_)
+  {
+    if (k.sensor.get() == sensor)
+    {
+      return &k;
+    }
+  }
+  return nullptr;
+}
+
+LoadShedder::SensorEntry* LoadShedder::AddSensor(const std::shared_ptr<SensorAbsClass>& sensor)
+{
+  SensorEntry entry;
+  entry.sensor = sensor;
+  sensors_.push_back(entry);
+  return &sensors_.back();
+}
+
+void LoadShedder::AdvanceTime(const Time& timestamp)
+{
+  const double capacity = cpu_budget_ * burst_window_;
+
+  if (!has_time_)
+  {
+    // Start with a full bucket
+    tokens_ = capacity;
+    last_time_ = timestamp;
+    has_time_ = true;
+    return;
+  }
+
+  if (timestamp > last_time_)
+  {
+    tokens_ = std::min(capacity, tokens_ + cpu_budget_ * (timestamp - last_time_).get_seconds());
+    last_time_ = timestamp;
+  }
+}
+
+bool LoadShedder::HasBudget(const SensorEntry& entry) const
+{
+  const double reserve = std::max(0, entry.policy.priority_ - 1) * priority_reserve_;
+  return tokens_ >= ExpectedCost(entry) + reserve;
+}
+
+double LoadShedder::ExpectedCost(const SensorEntry& entry) const
+{
+  if (deterministic_ || entry.stats.num_costs_ == 0)
+  {
+    return entry.policy.nominal_cost_;
+  }
+  return entry.stats.cost_ema_;
+}
+}  // namespace mars
@@ -0,0 +1,436 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/mcap_reader.h>
+#include <mars/type_definitions/journal_record.h>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace mars
+{
+namespace
+{
+///
+/// \brief The RecordCursor struct reads the fields of a record with bounds checking
+///
+struct RecordCursor
+{
+  const uint8_t* data;
+  uint64_t size;
+  uint64_t pos{ 0 };
+  bool ok{ true };
+
+  RecordCursor(const uint8_t* data, const uint64_t& size) : data(data), size(size)
+  {
+  }
+
+  bool Has(const uint64_t& num_bytes)
+  {
+    ok = ok && num_bytes <= size - pos;
+    return ok;
+  }
+
+  uint64_t Int(const int& num_bytes)
+  {
+    if (!Has(num_bytes))
+    {
+      return 0;
+    }
+    const uint64_t value = mcap::ReadLE(data + pos, num_bytes);
+    pos += num_bytes;
+    return value;
+  }
+
+  std::string String()
+  {
+    const uint64_t length = Int(4);
+    if (!Has(length))
+    {
+      return std::string();
+    }
+    std::string value(reinterpret_cast<const char*>(data + pos), length);
+    pos += length;
+    return value;
+  }
+};
+}  // namespace
+
+McapReader::McapReader(std::string file_name) : file_name_(std::move(file_name))
+{
+  values_.resize(journal::kMaxValues);
+  std::cout << "Created: McapReader (" << file_name_ << ")" << std::endl;
+}
+
+bool McapReader::Open()
+{
+  file_.open(file_name_, std::ios::in | std::ios::binary);
+  if (!file_.is_open())
+  {
+    std::cout << "McapReader: Warning: Could not open file " << file_name_ << std::endl;
+    return false;
+  }
+
+  file_.seekg(0, std::ios::end);
+  file_size_ = static_cast<uint64_t>(file_.tellg());
+  file_.seekg(0);
+
+  uint8_t magic[mcap::kMagicSize];
+  file_.read(reinterpret_cast<char*>(magic), mcap::kMagicSize);
+
+  uint8_t opcode = 0;
+  if (!file_ || std::memcmp(magic, mcap::kMagic, mcap::kMagicSize) != 0 || !ReadRecord(&opcode, &content_) ||
+      opcode != mcap::kHeader)
+  {
+    std::cout << "McapReader: Warning: " << file_name_ << " is not a valid MCAP file" << std::endl;
+    file_.close();
+    return false;
+  }
+
+  end_of_data_ = false;
+  ReadSummary();
+  return true;
+}
+
+std::vector<std::string> McapReader::get_topics() const
+{
+  std::vector<std::string> topics;
+  for (const auto& k : channels_)
+  {
+    topics.push_back(k.second.topic);
+  }
+  return topics;
+}
+
+bool McapReader::RegisterTopic(const std::string& topic, const std::shared_ptr<SensorAbsClass>& sensor,
+                               JournalDecoder decoder)
+{
+  for (const auto& k : channels_)
+  {
+    if (k.second.topic == topic && k.second.message_encoding != mcap::kMessageEncoding)
+    {
+      std::cout << "McapReader: Warning: Topic " << topic << " has the message encoding '"
+                << k.second.message_encoding << "', only '" << mcap::kMessageEncoding << "' can be decoded"
+                << std::endl;
+      return false;
+    }
+  }
+
+  Topic& entry = topics_[topic];
+  entry.sensor = sensor;
+  entry.decoder = std::move(decoder);
+  return true;
+}
+
+bool McapReader::ReadNext(McapMessage* message)
+{
+  if (!ReadUntilReleasable())
+  {
+    return false;
+  }
+
+  const PendingMessage& pending = pending_.top();
+
+  message->channel_id = pending.channel_id;
+  message->topic.clear();
+  message->sensor = nullptr;
+  message->log_time_ns = pending.log_time;
+  message->timestamp = static_cast<double>(pending.log_time) * 1e-9;
+  message->data = BufferDataType();
+
+  const auto channel = channels_.find(pending.channel_id);
+  if (channel != channels_.end())
+  {
+    message->topic = channel->second.topic;
+
+    const auto topic = topics_.find(channel->second.topic);
+    const size_t num_values = pending.payload.size() / sizeof(double);
+    if (topic != topics_.end())
+    {
+      if (channel->second.message_encoding == mcap::kMessageEncoding &&
+          pending.payload.size() % sizeof(double) == 0 && num_values <= values_.size())
+      {
+        for (size_t k = 0; k < num_values; k++)
+        {
+          values_[k] = mcap::ReadDouble(pending.payload.data() + k * sizeof(double));
+        }
+
+        message->sensor = topic->second.sensor;
+        if (topic->second.decoder)
+        {
+          message->data = BufferDataType(topic->second.decoder(values_.data(), static_cast<int>(num_values)));
+        }
+      }
+      else
+      {
+        num_undecoded_messages_++;
+        if (reported_channels_.insert(pending.channel_id).second)
+        {
+          std::cout << "McapReader: Warning: Messages of topic " << channel->second.topic << " with encoding '"
+                    << channel->second.message_encoding << "' and " << pending.payload.size()
+                    << " byte payload can not be decoded" << std::endl;
+        }
+      }
+    }
+  }
+
+  pending_.pop();
+  return true;
+}
+
+int McapReader::Replay(CoreLogic* core_logic)
+{
+  int num_replayed = 0;
+  McapMessage message;
+
+  while (ReadNext(&message))
+  {
+    if (message.sensor == nullptr || message.data.measurement_ == nullptr)
+    {
+      continue;
+    }
+
+    core_logic->ProcessMeasurement(message.sensor, message.timestamp, message.data);
+    num_replayed++;
+  }
+
+  if (num_skipped_chunks_ > 0 || num_undecoded_messages_ > 0)
+  {
+    std::cout << "McapReader: Warning: Replay of " << file_name_ << " skipped " << num_skipped_chunks_
+              << " chunks and " << num_undecoded_messages_ << " messages of registered topics" << std::endl;
+  }
+
+  return num_replayed;
+}
+
+int McapReader::get_num_skipped_chunks() const
+{
+  return num_skipped_chunks_;
+}
+
+int McapReader::get_num_undecoded_messages() const
+{
+  return num_undecoded_messages_;
+}
+
+bool McapReader::ReadRecord(uint8_t* opcode, std::vector<uint8_t>* content)
+{
+  uint8_t prefix[mcap::kRecordPrefixSize];
+  file_.read(reinterpret_cast<char*>(prefix), mcap::kRecordPrefixSize);
+  if (!file_)
+  {
+    return false;
+  }
+
+  *opcode = prefix[0];
+  const uint64_t size = mcap::ReadLE(prefix + 1, 8);
+
+  // Guard against corrupted length fields before allocating
+  if (size > file_size_ - static_cast<uint64_t>(file_.tellg()))
+  {
+    return false;
+  }
+
+  content->resize(size);
+  file_.read(reinterpret_cast<char*>(content->data()), static_cast<std::streamsize>(size));
+  return static_cast<bool>(file_);
+}
+
+void McapReader::ReadSummary()
+{
+  constexpr int kFooterSize = 20;
+  const std::streampos data_start = file_.tellg();
+
+  const std::streamoff footer_start =
+      static_cast<std::streamoff>(file_size_) - mcap::kMagicSize - mcap::kRecordPrefixSize - kFooterSize;
+
+  uint8_t opcode = 0;
+  std::vector<uint8_t> record;
+  if (footer_start > data_start)
+  {
+    file_.seekg(footer_start);
+    if (ReadRecord(&opcode, &record) && opcode == mcap::kFooter && record.size() == kFooterSize)
+    {
+      const uint64_t summary_start = mcap::ReadLE(record.data(), 8);
+      if (summary_start != 0 && summary_start < static_cast<uint64_t>(footer_start))
+      {
+        file_.seekg(static_cast<std::streamoff>(summary_start));
+        while (file_.tellg() < footer_start && ReadRecord(&opcode, &record))
+        {
+          RecordCursor cursor(record.data(), record.size());
+          if (opcode == mcap::kChannel)
+          {
+            HandleRecord(opcode, record.data(), record.size());
+          }
+          else if (opcode == mcap::kChunkIndex)
+          {
+            const uint64_t start_time = cursor.Int(8);
+            cursor.Int(8);
+            const uint64_t offset = cursor.Int(8);
+            if (cursor.ok)
+            {
+              unread_chunks_.emplace(start_time, offset);
+              has_chunk_index_ = true;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  file_.clear();
+  file_.seekg(data_start);
+}
+
+void McapReader::HandleRecord(const uint8_t& opcode, const uint8_t* content, const uint64_t& size)
+{
+  RecordCursor cursor(content, size);
+
+  if (opcode == mcap::kChannel)
+  {
+    const uint16_t id = static_cast<uint16_t>(cursor.Int(2));
+    cursor.Int(2);
+    Channel channel;
+    channel.topic = cursor.String();
+    channel.message_encoding = cursor.String();
+    if (cursor.ok)
+    {
+      channels_[id] = channel;
+    }
+  }
+  else if (opcode == mcap::kMessage)
+  {
+    PendingMessage message;
+    message.channel_id = static_cast<uint16_t>(cursor.Int(2));
+    cursor.Int(4);
+    message.log_time = cursor.Int(8);
+    cursor.Int(8);
+    if (!cursor.ok)
+    {
+      return;
+    }
+
+    message.order = num_read_messages_++;
+    message.payload.assign(content + cursor.pos, content + size);
+    pending_.push(std::move(message));
+  }
+}
+
+void McapReader::HandleChunk(const uint64_t& offset, const std::vector<uint8_t>& content)
+{
+  RecordCursor cursor(content.data(), content.size());
+  const uint64_t start_time = cursor.Int(8);
+  cursor.Int(8);
+  cursor.Int(8);
+  const uint32_t crc = static_cast<uint32_t>(cursor.Int(4));
+  const std::string compression = cursor.String();
+  const uint64_t records_size = cursor.Int(8);
+  cursor.Has(records_size);
+
+  const auto index = std::find_if(unread_chunks_.begin(), unread_chunks_.end(),
+                                  [&offset](const std::pair<const uint64_t, uint64_t>& k) {
+                                    return k.second == offset;
+                                  });
+  if (index != unread_chunks_.end())
+  {
+    unread_chunks_.erase(index);
+  }
+  latest_start_time_ = std::max(latest_start_time_, start_time);
+
+  if (!cursor.ok)
+  {
+    std::cout << "McapReader: Warning: Malformed chunk at offset " << offset << std::endl;
+    num_skipped_chunks_++;
+    return;
+  }
+
+  if (!compression.empty())
+  {
+    if (reported_compressions_.insert(compression).second)
+    {
+      std::cout << "McapReader: Warning: Chunks with '" << compression
+                << "' compression are not supported and skipped, first at offset " << offset << std::endl;
+    }
+    num_skipped_chunks_++;
+    return;
+  }
+
+  const uint8_t* records = content.data() + cursor.pos;
+  if (crc != 0 && mcap::Crc32(records, records_size) != crc)
+  {
+    std::cout << "McapReader: Warning: CRC mismatch of the chunk at offset " << offset << std::endl;
+    num_skipped_chunks_++;
+    return;
+  }
+
+  RecordCursor record_cursor(records, records_size);
+  while (record_cursor.pos < records_size)
+  {
+    const uint8_t opcode = static_cast<uint8_t>(record_cursor.Int(1));
+    const uint64_t size = record_cursor.Int(8);
+    if (!record_cursor.Has(size))
+    {
+      break;
+    }
+
+    HandleRecord(opcode, records + record_cursor.pos, size);
+    record_cursor.pos += size;
+  }
+}
+
+bool McapReader::ReadUntilReleasable()
+{
+  uint8_t opcode = 0;
+
+  while (true)
+  {
+    if (!pending_.empty() && (end_of_data_ || pending_.top().log_time <= Watermark()))
+    {
+      return true;
+    }
+
+    if (end_of_data_ || !file_.is_open())
+    {
+      return false;
+    }
+
+    const uint64_t offset = static_cast<uint64_t>(file_.tellg());
+    if (!ReadRecord(&opcode, &content_) || opcode == mcap::kDataEnd || opcode == mcap::kFooter)
+    {
+      end_of_data_ = true;
+      continue;
+    }
+
+    if (opcode == mcap::kChunk)
+    {
+      HandleChunk(offset, content_);
+    }
+    else
+    {
+      HandleRecord(opcode, content_.data(), content_.size());
+      if (opcode == mcap::kMessage && content_.size() >= 14)
+      {
+        latest_start_time_ = std::max(latest_start_time_, mcap::ReadLE(content_.data() + 6, 8));
+      }
+    }
+  }
+}
+
+uint64_t McapReader::Watermark() const
+{
+  if (!has_chunk_index_)
+  {
+    return latest_start_time_;
+  }
+
+  return unread_chunks_.empty() ? UINT64_MAX : unread_chunks_.begin()->first;
+}
+}  // namespace mars
@@ -0,0 +1,266 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/mcap_writer.h>
+#include <mars/type_definitions/journal_record.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+namespace mars
+{
+McapWriter::McapWriter(std::string file_name, const uint64_t& chunk_size)
+  : file_name_(std::move(file_name)), chunk_size_(chunk_size)
+{
+  values_.resize(journal::kMaxValues);
+  std::cout << "Created: McapWriter (" << file_name_ << ")" << std::endl;
+}
+
+McapWriter::~McapWriter()
+{
+  Close();
+}
+
+bool McapWriter::Open()
+{
+  file_.open(file_name_, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file_.is_open())
+  {
+    std::cout << "McapWriter: Warning: Could not open file " << file_name_ << std::endl;
+    return false;
+  }
+
+  file_.write(reinterpret_cast<const char*>(mcap::kMagic), mcap::kMagicSize);
+
+  std::vector<uint8_t> header;
+  mcap::AppendString(&header, "");
+  mcap::AppendString(&header, mcap::kLibrary);
+  WriteRecord(mcap::kHeader, header);
+
+  return static_cast<bool>(file_);
+}
+
+void McapWriter::Close()
+{
+  if (!file_.is_open())
+  {
+    return;
+  }
+
+  FlushChunk();
+
+  std::vector<uint8_t> data_end;
+  mcap::AppendLE(&data_end, 0, 4);  // Data section CRC is not computed
+  WriteRecord(mcap::kDataEnd, data_end);
+
+  const uint64_t summary_start = static_cast<uint64_t>(file_.tellp());
+
+  for (const auto& k : schemas_)
+  {
+    WriteRecord(mcap::kSchema, SchemaRecord(k));
+  }
+
+  for (const auto& k : channels_)
+  {
+    WriteRecord(mcap::kChannel, ChannelRecord(k));
+  }
+
+  std::vector<uint8_t> statistics;
+  mcap::AppendLE(&statistics, num_messages_, 8);
+  mcap::AppendLE(&statistics, schemas_.size(), 2);
+  mcap::AppendLE(&statistics, channels_.size(), 4);
+  mcap::AppendLE(&statistics, 0, 4);  // Attachments
+  mcap::AppendLE(&statistics, 0, 4);  // Metadata
+  mcap::AppendLE(&statistics, chunk_indices_.size(), 4);
+  mcap::AppendLE(&statistics, num_messages_ > 0 ? message_start_time_ : 0, 8);
+  mcap::AppendLE(&statistics, message_end_time_, 8);
+  mcap::AppendLE(&statistics, channels_.size() * 10, 4);
+  for (const auto& k : channels_)
+  {
+    mcap::AppendLE(&statistics, k.id, 2);
+    mcap::AppendLE(&statistics, k.num_messages, 8);
+  }
+  WriteRecord(mcap::kStatistics, statistics);
+
+  for (const auto& k : chunk_indices_)
+  {
+    std::vector<uint8_t> chunk_index;
+    mcap::AppendLE(&chunk_index, k.message_start_time, 8);
+    mcap::AppendLE(&chunk_index, k.message_end_time, 8);
+    mcap::AppendLE(&chunk_index, k.offset, 8);
+    mcap::AppendLE(&chunk_index, k.length, 8);
+    mcap::AppendLE(&chunk_index, 0, 4);  // No message index records
+    mcap::AppendLE(&chunk_index, 0, 8);
+    mcap::AppendString(&chunk_index, "");
+    mcap::AppendLE(&chunk_index, k.uncompressed_size, 8);
+    mcap::AppendLE(&chunk_index, k.uncompressed_size, 8);
+    WriteRecord(mcap::kChunkIndex, chunk_index);
+  }
+
+  std::vector<uint8_t> footer;
+  mcap::AppendLE(&footer, summary_start, 8);
+  mcap::AppendLE(&footer, 0, 8);  // No summary offset section
+  mcap::AppendLE(&footer, 0, 4);  // Summary CRC is not computed
+  WriteRecord(mcap::kFooter, footer);
+
+  file_.write(reinterpret_cast<const char*>(mcap::kMagic), mcap::kMagicSize);
+  file_.close();
+}
+
+int McapWriter::AddChannel(const std::string& topic, const std::string& schema_name, JournalEncoder encoder)
+{
+  if (!file_.is_open())
+  {
+    std::cout << "McapWriter: Warning: Channel [" << topic << "] added before Open()" << std::endl;
+    return -1;
+  }
+
+  auto schema = std::find_if(schemas_.begin(), schemas_.end(),
+                             [&schema_name](const Schema& k) { return k.name == schema_name; });
+  if (schema == schemas_.end())
+  {
+    // Schema id 0 is reserved for channels without schema
+    schemas_.push_back({ static_cast<uint16_t>(schemas_.size() + 1), schema_name });
+    schema = schemas_.end() - 1;
+    WriteRecord(mcap::kSchema, SchemaRecord(*schema));
+  }
+
+  Channel channel;
+  channel.id = static_cast<uint16_t>(channels_.size());
+  channel.schema_id = schema->id;
+  channel.topic = topic;
+  channel.encoder = std::move(encoder);
+  channels_.push_back(channel);
+  WriteRecord(mcap::kChannel, ChannelRecord(channels_.back()));
+
+  return channel.id;
+}
+
+bool McapWriter::Write(const int& channel_id, const Time& timestamp, const std::shared_ptr<void>& data)
+{
+  if (!file_.is_open() || channel_id < 0 || channel_id >= static_cast<int>(channels_.size()) || data == nullptr ||
+      timestamp.get_seconds() < 0)
+  {
+    return false;
+  }
+
+  Channel& channel = channels_[channel_id];
+  const int num_values = channel.encoder(data, values_.data(), journal::kMaxValues);
+  if (num_values < 0)
+  {
+    return false;
+  }
+
+  const uint64_t log_time = static_cast<uint64_t>(std::llround(timestamp.get_seconds() * 1e9));
+
+  record_.clear();
+  mcap::AppendLE(&record_, channel.id, 2);
+  mcap::AppendLE(&record_, channel.sequence++, 4);
+  mcap::AppendLE(&record_, log_time, 8);
+  mcap::AppendLE(&record_, log_time, 8);
+  for (int k = 0; k < num_values; k++)
+  {
+    mcap::AppendDouble(&record_, values_[k]);
+  }
+
+  chunk_records_.push_back(mcap::kMessage);
+  mcap::AppendLE(&chunk_records_, record_.size(), 8);
+  chunk_records_.insert(chunk_records_.end(), record_.begin(), record_.end());
+
+  if (chunk_records_.size() == mcap::kRecordPrefixSize + record_.size())
+  {
+    chunk_start_time_ = log_time;
+    chunk_end_time_ = log_time;
+  }
+  chunk_start_time_ = std::min(chunk_start_time_, log_time);
+  chunk_end_time_ = std::max(chunk_end_time_, log_time);
+
+  message_start_time_ = std::min(message_start_time_, log_time);
+  message_end_time_ = std::max(message_end_time_, log_time);
+  channel.num_messages++;
+  num_messages_++;
+
+  if (chunk_records_.size() >= chunk_size_)
+  {
+    FlushChunk();
+  }
+
+  return true;
+}
+
+uint64_t McapWriter::get_num_messages() const
+{
+  return num_messages_;
+}
+
+uint64_t McapWriter::get_num_chunks() const
+{
+  return chunk_indices_.size();
+}
+
+void McapWriter::WriteRecord(const mcap::Opcode& opcode, const std::vector<uint8_t>& content)
+{
+  record_.clear();
+  record_.push_back(opcode);
+  mcap::AppendLE(&record_, content.size(), 8);
+  file_.write(reinterpret_cast<const char*>(record_.data()), static_cast<std::streamsize>(record_.size()));
+  file_.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+}
+
+void McapWriter::FlushChunk()
+{
+  if (chunk_records_.empty())
+  {
+    return;
+  }
+
+  std::vector<uint8_t> chunk;
+  mcap::AppendLE(&chunk, chunk_start_time_, 8);
+  mcap::AppendLE(&chunk, chunk_end_time_, 8);
+  mcap::AppendLE(&chunk, chunk_records_.size(), 8);
+  mcap::AppendLE(&chunk, mcap::Crc32(chunk_records_.data(), chunk_records_.size()), 4);
+  mcap::AppendString(&chunk, "");  // Uncompressed
+  mcap::AppendLE(&chunk, chunk_records_.size(), 8);
+  chunk.insert(chunk.end(), chunk_records_.begin(), chunk_records_.end());
+
+  ChunkIndex index;
+  index.message_start_time = chunk_start_time_;
+  index.message_end_time = chunk_end_time_;
+  index.offset = static_cast<uint64_t>(file_.tellp());
+  index.length = mcap::kRecordPrefixSize + chunk.size();
+  index.uncompressed_size = chunk_records_.size();
+  chunk_indices_.push_back(index);
+
+  WriteRecord(mcap::kChunk, chunk);
+  chunk_records_.clear();
+}
+
+std::vector<uint8_t> McapWriter::SchemaRecord(const Schema& schema)
+{
+  std::vector<uint8_t> content;
+  mcap::AppendLE(&content, schema.id, 2);
+  mcap::AppendString(&content, schema.name);
+  mcap::AppendString(&content, mcap::kMessageEncoding);
+  mcap::AppendLE(&content, 0, 4);  // The layout is defined by the codec, no schema data
+  return content;
+}
+
+std::vector<uint8_t> McapWriter::ChannelRecord(const Channel& channel)
+{
+  std::vector<uint8_t> content;
+  mcap::AppendLE(&content, channel.id, 2);
+  mcap::AppendLE(&content, channel.schema_id, 2);
+  mcap::AppendString(&content, channel.topic);
+  mcap::AppendString(&content, mcap::kMessageEncoding);
+  mcap::AppendLE(&content, 0, 4);  // No metadata
+  return content;
+}
+}  // namespace mars
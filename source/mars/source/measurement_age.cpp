@@ -0,0 +1,105 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/measurement_age.h>
+#include <mars/time.h>
+#include <algorithm>
+
+namespace mars
+{
+void MeasurementAgeTracker::Samples::Add(const double& value, const size_t& window)
+{
+  if (values_.size() < window)
+  {
+    values_.push_back(value);
+    return;
+  }
+
+  values_[next_] = value;
+  next_ = (next_ + 1) % window;
+}
+
+MeasurementAgeTracker::MeasurementAgeTracker(const size_t& window) : window_(std::max<size_t>(window, 1))
+{
+}
+
+void MeasurementAgeTracker::Observe(const BufferEntryType& state_entry, const bool& is_correction)
+{
+  Observe(state_entry, is_correction, Time::get_wall_time_ns());
+}
+
+void MeasurementAgeTracker::Observe(const BufferEntryType& state_entry, const bool& is_correction,
+                                    const int64_t& output_ns)
+{
+  if (state_entry.arrival_ns_ == 0 || state_entry.sensor_handle_ == nullptr)
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  SensorSamples& sensor = sensors_[state_entry.sensor_handle_];
+  const double latency = 1e-9 * static_cast<double>(output_ns - state_entry.arrival_ns_);
+
+  // Arrival times of one sensor increase, a newer arrival is the first state of the measurement
+  if (state_entry.arrival_ns_ > sensor.newest_arrival_ns_)
+  {
+    sensor.newest_arrival_ns_ = state_entry.arrival_ns_;
+    sensor.processing_.Add(latency, window_);
+  }
+  else if (is_correction)
+  {
+    sensor.rework_.Add(latency, window_);
+  }
+
+  if (is_correction)
+  {
+    return;
+  }
+
+  for (auto& k : sensors_)
+  {
+    k.second.age_.Add(1e-9 * static_cast<double>(output_ns - k.second.newest_arrival_ns_), window_);
+  }
+}
+
+MeasurementAgeStats MeasurementAgeTracker::get_stats(const std::shared_ptr<SensorAbsClass>& sensor,
+                                                     const double& deadline) const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  MeasurementAgeStats stats;
+
+  const auto it = sensors_.find(sensor);
+  if (it != sensors_.end())
+  {
+    stats.processing_ = PacedReplayer::ComputeStats(it->second.processing_.values_, deadline);
+    stats.age_ = PacedReplayer::ComputeStats(it->second.age_.values_, deadline);
+    stats.rework_ = PacedReplayer::ComputeStats(it->second.rework_.values_, deadline);
+  }
+
+  return stats;
+}
+
+std::vector<std::shared_ptr<SensorAbsClass>> MeasurementAgeTracker::get_sensors() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::shared_ptr<SensorAbsClass>> sensors;
+  for (const auto& k : sensors_)
+  {
+    sensors.push_back(k.first);
+  }
+  return sensors;
+}
+
+void MeasurementAgeTracker::Reset()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  sensors_.clear();
+}
+}  // namespace mars
@@ -0,0 +1,207 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/measurement_journal.h>
+#include <iostream>
+#include <utility>
+
+namespace mars
+{
+MeasurementJournal::MeasurementJournal(std::string file_name, const uint32_t& capacity)
+  : file_name_(std::move(file_name)), capacity_(capacity > 0 ? capacity : 1)
+{
+  ring_.resize(capacity_);
+  std::cout << "Created: MeasurementJournal (" << file_name_ << ", Slots=" << capacity_ << ")" << std::endl;
+}
+
+MeasurementJournal::~MeasurementJournal()
+{
+  Close();
+}
+
+int MeasurementJournal::RegisterSensor(const std::shared_ptr<SensorAbsClass>& sensor, JournalEncoder encoder)
+{
+  if (IsOpen())
+  {
+    std::cout << "MeasurementJournal: Warning: Sensors can not be registered while the journal is open" << std::endl;
+    return -1;
+  }
+
+  const int id = FindSensorId(sensor.get());
+  if (id >= 0)
+  {
+    sensors_[static_cast<size_t>(id)].encoder = std::move(encoder);
+    return id;
+  }
+
+  sensors_.push_back({ sensor, std::move(encoder) });
+  return static_cast<int>(sensors_.size()) - 1;
+}
+
+bool MeasurementJournal::Open()
+{
+  if (IsOpen())
+  {
+    return true;
+  }
+
+  file_.open(file_name_, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file_.is_open())
+  {
+    std::cout << "MeasurementJournal: Warning: Could not open file " << file_name_ << std::endl;
+    return false;
+  }
+
+  journal::JournalFileHeader header{};
+  header.magic = journal::kJournalMagic;
+  header.version = journal::kJournalVersion;
+  header.num_sensors = static_cast<uint32_t>(sensors_.size());
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  for (const auto& k : sensors_)
+  {
+    const uint32_t name_length = static_cast<uint32_t>(k.sensor->name_.size());
+    file_.write(reinterpret_cast<const char*>(&name_length), sizeof(name_length));
+    file_.write(k.sensor->name_.data(), name_length);
+  }
+  file_.flush();
+
+  head_ = 0;
+  tail_ = 0;
+  num_dropped_ = 0;
+  stop_ = false;
+  flush_thread_ = std::thread(&MeasurementJournal::FlushLoop, this);
+  is_open_ = true;
+
+  return true;
+}
+
+void MeasurementJournal::Close()
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+
+  is_open_ = false;
+  stop_ = true;
+  if (flush_thread_.joinable())
+  {
+    flush_thread_.join();
+  }
+
+  FlushPending();
+  file_.close();
+}
+
+bool MeasurementJournal::IsOpen() const
+{
+  return is_open_.load(std::memory_order_acquire);
+}
+
+bool MeasurementJournal::Record(const SensorAbsClass* sensor, const Time& timestamp, const BufferDataType& data,
+                                const int64_t& arrival_ns)
+{
+  if (!is_open_.load(std::memory_order_relaxed))
+  {
+    return false;
+  }
+
+  const int id = FindSensorId(sensor);
+  const uint64_t head = head_.load(std::memory_order_relaxed);
+
+  if (id < 0 || head - tail_.load(std::memory_order_acquire) >= capacity_)
+  {
+    num_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  journal::JournalRecord& record = ring_[head % capacity_];
+  const int num_values = sensors_[static_cast<size_t>(id)].encoder(data.measurement_, record.values,
+                                                                   journal::kMaxValues);
+  if (num_values < 0 || num_values > journal::kMaxValues)
+  {
+    num_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  record.header.sensor_id = static_cast<uint32_t>(id);
+  record.header.num_values = static_cast<uint32_t>(num_values);
+  record.header.timestamp = timestamp.get_seconds();
+  record.header.arrival_ns = arrival_ns;
+
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+uint64_t MeasurementJournal::get_num_recorded() const
+{
+  return head_.load(std::memory_order_acquire);
+}
+
+uint64_t MeasurementJournal::get_num_dropped() const
+{
+  return num_dropped_.load(std::memory_order_relaxed);
+}
+
+uint64_t MeasurementJournal::get_num_written() const
+{
+  return tail_.load(std::memory_order_acquire);
+}
+
+int MeasurementJournal::FindSensorId(const SensorAbsClass* sensor) const
+{
+  // Linear search, the number of sensors is small
+  for (size_t k = 0; k < sensors_.size(); k++)
+  {
+    if (sensors_[k].sensor.get() == sensor)
+    {
+      return static_cast<int>(k);
+    }
+  }
+  return -1;
+}
+
+uint64_t MeasurementJournal::FlushPending()
+{
+  const uint64_t head = head_.load(std::memory_order_acquire);
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+  const uint64_t num_pending = head - tail;
+
+  for (; tail < head; tail++)
+  {
+    const journal::JournalRecord& record = ring_[tail % capacity_];
+    file_.write(reinterpret_cast<const char*>(&record.header), sizeof(record.header));
+    file_.write(reinterpret_cast<const char*>(record.values),
+                static_cast<std::streamsize>(record.header.num_values * sizeof(double)));
+
+    // Release the slot to the filter thread
+    tail_.store(tail + 1, std::memory_order_release);
+  }
+
+  if (num_pending > 0)
+  {
+    file_.flush();
+  }
+
+  return num_pending;
+}
+
+void MeasurementJournal::FlushLoop()
+{
+  while (!stop_.load(std::memory_order_acquire))
+  {
+    if (FlushPending() == 0)
+    {
+      std::this_thread::sleep_for(flush_period_);
+    }
+  }
+}
+}  // namespace mars
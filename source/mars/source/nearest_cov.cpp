@@ -22,7 +22,27 @@ NearestCov::NearestCov(const Eigen::MatrixXd& covariance) : cov_mat_(covariance)
 
 Eigen::MatrixXd NearestCov::EigenCorrectionUsingCovariance(NearestCovMethod method)
 {
-  Eigen::EigenSolver<Eigen::MatrixXd> vd(cov_mat_);
+  Eigen::MatrixXd result;
+  EigenCorrectionUsingCovariance(cov_mat_, method, &result);
+  return result;
+}
+
+void NearestCov::EigenCorrectionUsingCovariance(const Eigen::MatrixXd& covariance, NearestCovMethod method,
+                                                Eigen::MatrixXd* corrected)
+{
+  assert(covariance.rows() == covariance.cols());
+  assert(corrected != &covariance);
+
+  // All eigenvalues of a positive definite matrix are positive
+  llt_.compute(covariance);
+  if (llt_.info() == Eigen::Success)
+  {
+    corrected_ = false;
+    *corrected = covariance;
+    return;
+  }
+
+  Eigen::EigenSolver<Eigen::MatrixXd> vd(covariance);
 
   Eigen::EigenSolver<Eigen::MatrixXd>::EigenvectorsType V(vd.eigenvectors());
   Eigen::EigenSolver<Eigen::MatrixXd>::EigenvalueType D(vd.eigenvalues());
@@ -45,9 +65,12 @@ Eigen::MatrixXd NearestCov::EigenCorrectionUsingCovariance(NearestCovMethod meth
     }
   }
 
+  corrected_ = !no_negative_eigenvalues && method != NearestCovMethod::none;
+
   if (no_negative_eigenvalues)
   {
-    return cov_mat_;
+    *corrected = covariance;
+    return;
   }
 
   Eigen::VectorXd D_corrected(D_real);
@@ -90,16 +113,15 @@ Eigen::MatrixXd NearestCov::EigenCorrectionUsingCovariance(NearestCovMethod meth
 
     case NearestCovMethod::none:
       // do not perform any changes
-      return cov_mat_;
-      break;
+      *corrected = covariance;
+      return;
 
     default:
       std::cout << "Warning: Unexpected method for nearest_cov" << std::endl;
       break;
   }
 
-  Eigen::MatrixXd result(V_real * D_corrected.asDiagonal() * V_real.inverse());
-  return result;
+  *corrected = V_real * D_corrected.asDiagonal() * V_real.inverse();
 }
 
 Eigen::MatrixXd NearestCov::EigenCorrectionUsingCorrelation(NearestCovMethod /*method*/)
@@ -0,0 +1,205 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/paced_replayer.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+
+namespace mars
+{
+PacedReplayer::PacedReplayer(std::vector<BufferEntryType> measurements, const uint64_t& seed)
+  : measurements_(std::move(measurements)), seed_(seed)
+{
+  std::cout << "Created: PacedReplayer (" << measurements_.size() << " measurements)" << std::endl;
+}
+
+void PacedReplayer::set_arrival_model(const std::shared_ptr<SensorAbsClass>& sensor, const ArrivalModel& model)
+{
+  arrival_models_[sensor] = model;
+}
+
+bool PacedReplayer::set_arrival_times(const std::vector<double>& arrival_times)
+{
+  if (arrival_times.size() != measurements_.size())
+  {
+    std::cout << "PacedReplayer: Warning: Expected " << measurements_.size() << " arrival times, got "
+              << arrival_times.size() << std::endl;
+    return false;
+  }
+
+  arrival_times_ = arrival_times;
+  return true;
+}
+
+PacedReplayResult PacedReplayer::Run(CoreLogic* core_logic)
+{
+  PacedReplayResult result;
+  const std::vector<Arrival> arrivals = get_arrivals();
+  if (arrivals.empty())
+  {
+    return result;
+  }
+
+  std::vector<double> processing;
+  std::vector<double> latency;
+  std::map<std::shared_ptr<SensorAbsClass>, std::vector<double>> sensor_latency;
+  processing.reserve(arrivals.size());
+  latency.reserve(arrivals.size());
+
+  const int num_reworks_start = core_logic->get_rework_stats().num_reworks_;
+  const double replay_start = arrivals.front().time;
+  const Clock::time_point wall_start = Clock::now();
+  Time newest(-1);
+
+  for (const auto& k : arrivals)
+  {
+    const BufferEntryType& measurement = measurements_[k.idx];
+
+    Clock::time_point scheduled = Clock::now();
+    if (speed_ > 0)
+    {
+      scheduled = wall_start + std::chrono::duration_cast<Clock::duration>(
+                                   std::chrono::duration<double>((k.time - replay_start) / speed_));
+      WaitUntil(scheduled);
+    }
+
+    if (measurement.timestamp_ < newest)
+    {
+      result.num_out_of_order_++;
+    }
+    newest = std::max(newest, measurement.timestamp_);
+
+    core_logic->ProcessMeasurement(measurement.sensor_handle_, measurement.timestamp_, measurement.data_);
+    const Clock::time_point done = Clock::now();
+
+    if (!core_logic->core_is_initialized_ && initializer_ &&
+        measurement.sensor_handle_ == core_logic->core_states_->propagation_sensor_)
+    {
+      initializer_(core_logic);
+    }
+
+    const double processing_latency = std::chrono::duration<double>(done - scheduled).count();
+    const double arrival_delay = k.time - measurement.timestamp_.get_seconds();
+    processing.push_back(processing_latency);
+    latency.push_back(arrival_delay + processing_latency);
+    sensor_latency[measurement.sensor_handle_].push_back(arrival_delay + processing_latency);
+    result.num_processed_++;
+  }
+
+  result.wall_time_ = std::chrono::duration<double>(Clock::now() - wall_start).count();
+  result.num_reworks_ = core_logic->get_rework_stats().num_reworks_ - num_reworks_start;
+  result.processing_ = ComputeStats(processing, deadline_);
+  result.latency_ = ComputeStats(latency, deadline_);
+  for (auto& k : sensor_latency)
+  {
+    result.sensor_latency_[k.first] = ComputeStats(std::move(k.second), deadline_);
+  }
+
+  return result;
+}
+
+LatencyStats PacedReplayer::ComputeStats(std::vector<double> samples, const double& deadline)
+{
+  LatencyStats stats;
+  if (samples.empty())
+  {
+    return stats;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  const size_t n = samples.size();
+  auto percentile = [&samples, &n](const double& p) {
+    const size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(n)));
+    return samples[std::min(std::max<size_t>(rank, 1), n) - 1];
+  };
+
+  double sum = 0;
+  for (const auto& k : samples)
+  {
+    sum += k;
+    if (k > deadline)
+    {
+      stats.num_deadline_misses_++;
+    }
+  }
+
+  stats.num_samples_ = static_cast<int>(n);
+  stats.mean_ = sum / static_cast<double>(n);
+  stats.p50_ = percentile(0.5);
+  stats.p90_ = percentile(0.9);
+  stats.p99_ = percentile(0.99);
+  stats.max_ = samples.back();
+  return stats;
+}
+
+std::vector<PacedReplayer::Arrival> PacedReplayer::get_arrivals() const
+{
+  std::vector<Arrival> arrivals;
+  arrivals.reserve(measurements_.size());
+
+  if (!arrival_times_.empty())
+  {
+    for (size_t k = 0; k < measurements_.size(); k++)
+    {
+      arrivals.push_back({ arrival_times_[k], k });
+    }
+  }
+  else
+  {
+    std::mt19937_64 generator(seed_);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    for (size_t k = 0; k < measurements_.size(); k++)
+    {
+      double arrival = measurements_[k].timestamp_.get_seconds();
+
+      const auto model = arrival_models_.find(measurements_[k].sensor_handle_);
+      if (model != arrival_models_.end())
+      {
+        arrival += model->second.delay_;
+        if (model->second.jitter_ > 0)
+        {
+          arrival += -model->second.jitter_ * std::log(1 - uniform(generator));
+        }
+      }
+
+      arrivals.push_back({ arrival, k });
+    }
+  }
+
+  // Measurements with the same arrival time keep their measurement order
+  std::stable_sort(arrivals.begin(), arrivals.end(), [this](const Arrival& a, const Arrival& b) {
+    if (a.time != b.time)
+    {
+      return a.time < b.time;
+    }
+    return measurements_[a.idx].timestamp_ < measurements_[b.idx].timestamp_;
+  });
+
+  return arrivals;
+}
+
+void PacedReplayer::WaitUntil(const Clock::time_point& time) const
+{
+  // Sleep for the coarse part, the wake up of the scheduler is not precise enough for the last part
+  const Clock::time_point sleep_until = time - spin_period_;
+  if (Clock::now() < sleep_until)
+  {
+    std::this_thread::sleep_until(sleep_until);
+  }
+
+  while (Clock::now() < time)
+  {
+  }
+}
+}  // namespace mars
@@ -0,0 +1,333 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/realtime_profile.h>
+#include <alloca.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace mars
+{
+bool RealtimeProfile::Apply(const RealtimeConfig& config, RealtimeState* previous)
+{
+  bool result = true;
+  RealtimeState state;
+
+  if (config.keep_heap_)
+  {
+    result &= KeepHeap();
+    state.heap_kept_ = true;
+  }
+
+  if (config.lock_memory_)
+  {
+    state.memory_locked_ = LockMemory();
+    result &= state.memory_locked_;
+  }
+
+  // Touch the reserves after locking, such that the pages are mapped and locked now and not in the filter loop
+  if (config.heap_reserve_bytes_ > 0)
+  {
+    result &= PrefaultHeap(config.heap_reserve_bytes_);
+  }
+
+  if (config.stack_reserve_bytes_ > 0)
+  {
+    PrefaultStack(config.stack_reserve_bytes_);
+  }
+
+  if (config.cpu_ >= 0)
+  {
+    state.cpus_ = get_current_thread_cpus();
+    result &= PinCurrentThread(config.cpu_);
+  }
+
+  if (config.fifo_priority_ > 0)
+  {
+    sched_param param{};
+    state.sched_changed_ = pthread_getschedparam(pthread_self(), &state.sched_policy_, &param) == 0;
+    state.sched_priority_ = param.sched_priority;
+    result &= SetFifoPriority(config.fifo_priority_);
+  }
+
+  if (previous != nullptr)
+  {
+    *previous = state;
+  }
+
+  return result;
+}
+
+bool RealtimeProfile::Restore(const RealtimeState& previous)
+{
+  bool result = true;
+
+  if (previous.sched_changed_)
+  {
+    sched_param param{};
+    param.sched_priority = previous.sched_priority_;
+    const int error = pthread_setschedparam(pthread_self(), previous.sched_policy_, &param);
+    if (error != 0)
+    {
+      std::cout << "Warning: [RealtimeProfile] Restoring the scheduling policy failed: " << std::strerror(error)
+                << std::endl;
+      result = false;
+    }
+  }
+
+  if (!previous.cpus_.empty())
+  {
+    result &= SetCurrentThreadCpus(previous.cpus_);
+  }
+
+  if (previous.memory_locked_)
+  {
+    result &= UnlockMemory();
+  }
+
+  if (previous.heap_kept_)
+  {
+    result &= ReleaseHeap();
+  }
+
+  return result;
+}
+
+size_t RealtimeProfile::EstimateHeapBytes(const int& max_buffer_size, const int& max_state_size)
+{
+  // Each entry holds a core state with covariance and state transition (~4 kB) and up to one sensor state with the
+  // full cross covariance. The factor two covers temporary copies during updates and reworks.
+  const size_t state_bytes = 8 * static_cast<size_t>(max_state_size) * static_cast<size_t>(max_state_size);
+  const size_t entry_bytes = 4096 + 2 * state_bytes;
+  return 2 * static_cast<size_t>(max_buffer_size) * entry_bytes + (1 << 20);
+}
+
+bool RealtimeProfile::LockMemory()
+{
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+  {
+    std::cout << "Warning: [RealtimeProfile] mlockall failed: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool RealtimeProfile::UnlockMemory()
+{
+  if (munlockall() != 0)
+  {
+    std::cout << "Warning: [RealtimeProfile] munlockall failed: " << std::strerror(errno) << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool RealtimeProfile::KeepHeap()
+{
+#ifdef __GLIBC__
+  // Freed memory is not returned to the system and large blocks are served from the heap instead of mmap
+  if (mallopt(M_TRIM_THRESHOLD, -1) == 1 && mallopt(M_MMAP_MAX, 0) == 1)
+  {
+    return true;
+  }
+#endif
+
+  std::cout << "Warning: [RealtimeProfile] Heap settings are not supported" << std::endl;
+  return false;
+}
+
+bool RealtimeProfile::ReleaseHeap()
+{
+#ifdef __GLIBC__
+  if (mallopt(M_TRIM_THRESHOLD, 128 * 1024) == 1 && mallopt(M_MMAP_MAX, 65536) == 1)
+  {
+    return true;
+  }
+#endif
+
+  std::cout << "Warning: [RealtimeProfile] Heap settings are not supported" << std::endl;
+  return false;
+}
+
+bool RealtimeProfile::PrefaultHeap(const size_t& bytes)
+{
+  volatile char* memory = static_cast<char*>(std::malloc(bytes));
+
+  if (memory == nullptr)
+  {
+    std::cout << "Warning: [RealtimeProfile] Heap reserve of " << bytes << " bytes could not be allocated"
+              << std::endl;
+    return false;
+  }
+
+  const long page_size = sysconf(_SC_PAGESIZE);
+  for (size_t k = 0; k < bytes; k += static_cast<size_t>(page_size))
+  {
+    memory[k] = 0;
+  }
+
+  // With KeepHeap, the memory stays mapped and is reused by the following allocations
+  std::free(const_cast<char*>(memory));
+  return true;
+}
+
+void RealtimeProfile::PrefaultStack(const size_t& bytes)
+{
+  volatile char* memory = static_cast<char*>(alloca(bytes));
+  const long page_size = sysconf(_SC_PAGESIZE);
+
+  for (size_t k = 0; k < bytes; k += static_cast<size_t>(page_size))
+  {
+    memory[k] = 0;
+  }
+}
+
+bool RealtimeProfile::PinCurrentThread(const int& cpu)
+{
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+
+  const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (error == 0)
+  {
+    return true;
+  }
+
+  std::cout << "Warning: [RealtimeProfile] Pinning to CPU " << cpu << " failed: " << std::strerror(error) << std::endl;
+#else
+  std::cout << "Warning: [RealtimeProfile] Thread pinning is not supported" << std::endl;
+#endif
+  return false;
+}
+
+std::vector<int> RealtimeProfile::get_current_thread_cpus()
+{
+  std::vector<int> cpus;
+
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0)
+  {
+    for (int k = 0; k < CPU_SETSIZE; k++)
+    {
+      if (CPU_ISSET(k, &cpu_set))
+      {
+        cpus.push_back(k);
+      }
+    }
+  }
+#endif
+
+  return cpus;
+}
+
+bool RealtimeProfile::SetCurrentThreadCpus(const std::vector<int>& cpus)
+{
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (const auto& k : cpus)
+  {
+    CPU_SET(k, &cpu_set);
+  }
+
+  const int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (error == 0)
+  {
+    return true;
+  }
+
+  std::cout << "Warning: [RealtimeProfile] Setting the CPU affinity failed: " << std::strerror(error) << std::endl;
+#else
+  std::cout << "Warning: [RealtimeProfile] Thread pinning is not supported" << std::endl;
+#endif
+  return false;
+}
+
+bool RealtimeProfile::SetFifoPriority(const int& priority)
+{
+  sched_param param{};
+  param.sched_priority = priority;
+
+  const int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+  if (error == 0)
+  {
+    return true;
+  }
+
+  std::cout << "Warning: [RealtimeProfile] SCHED_FIFO priority " << priority << " failed: " << std::strerror(error)
+            << std::endl;
+  return false;
+}
+
+RealtimeStats RealtimeProfile::get_thread_stats()
+{
+  RealtimeStats stats;
+  rusage usage{};
+
+#ifdef RUSAGE_THREAD
+  getrusage(RUSAGE_THREAD, &usage);
+#else
+  getrusage(RUSAGE_SELF, &usage);
+#endif
+
+  stats.minor_faults_ = usage.ru_minflt;
+  stats.major_faults_ = usage.ru_majflt;
+  stats.voluntary_switches_ = usage.ru_nvcsw;
+  stats.involuntary_switches_ = usage.ru_nivcsw;
+  return stats;
+}
+
+MemoryStats RealtimeProfile::get_memory_stats()
+{
+  MemoryStats stats;
+
+  // Second field of statm is the number of resident pages
+  std::ifstream statm("/proc/self/statm");
+  size_t size_pages = 0;
+  size_t rss_pages = 0;
+  if (statm >> size_pages >> rss_pages)
+  {
+    stats.rss_bytes_ = rss_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  const struct mallinfo2 info = mallinfo2();
+  stats.heap_in_use_bytes_ = info.uordblks + info.hblkhd;
+  stats.heap_free_bytes_ = info.fordblks;
+  stats.heap_mapped_bytes_ = info.hblkhd;
+#elif defined(__GLIBC__)
+  const struct mallinfo info = mallinfo();
+  stats.heap_in_use_bytes_ = static_cast<size_t>(static_cast<unsigned int>(info.uordblks)) +
+                             static_cast<size_t>(static_cast<unsigned int>(info.hblkhd));
+  stats.heap_free_bytes_ = static_cast<unsigned int>(info.fordblks);
+  stats.heap_mapped_bytes_ = static_cast<unsigned int>(info.hblkhd);
+#endif
+
+  return stats;
+}
+}  // namespace mars
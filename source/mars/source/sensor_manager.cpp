@@ -1,6 +1,343 @@
-#include "mars/SensorManager.hpp"
+// Copyright (C) 2024 Christian Brommer and Thomas Jantos, Control of Networked Systems, University of Klagenfurt,
+// Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
 
-SensorManager::SensorManager()
+#include <mars/sensor_manager.h>
+#include <algorithm>
+#include <iostream>
+
+namespace mars
+{
+SensorManager::SensorManager() : sensors_(std::make_shared<const SensorList>())
+{
+}
+
+SensorManager::SensorManager(const SensorManager& other) : SensorManager()
+{
+  *this = other;
+}
+
+SensorManager& SensorManager::operator=(const SensorManager& other)
+{
+  if (this == &other)
+  {
+    return *this;
+  }
+
+  std::vector<SensorChange> pending_changes;
+  {
+    std::lock_guard<std::mutex> lock(other.mutex_);
+    pending_changes = other.pending_changes_;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  cleanup_step_ = other.cleanup_step_;
+  sensor_list_ = other.sensor_list_;
+  std::atomic_store(&sensors_, other.get_sensor_list());
+  pending_changes_ = std::move(pending_changes);
+  num_pending_changes_ = static_cast<int>(pending_changes_.size());
+  retired_sensors_ = other.retired_sensors_;
+  cleanup_cursor_ = other.cleanup_cursor_;
+  cleanup_from_start_ = other.cleanup_from_start_;
+  return *this;
+}
+
+bool SensorManager::register_sensor(std::shared_ptr<SensorAbsClass> sensor)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const std::shared_ptr<const SensorList> current = std::atomic_load(&sensors_);
+  if (Contains(*current, sensor))
+  {
+    // Sensor is already registered
+    return false;
+  }
+
+  SensorList next(*current);
+  next.push_back(sensor);
+  PublishSensors(std::move(next));
+
+  std::cout << "Registered sensor [" << sensor->name_ << "] with Sensor Manager" << std::endl;
+  return true;
+}
+
+bool SensorManager::QueueRemoveSensor(std::shared_ptr<SensorAbsClass> sensor)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  const std::shared_ptr<const SensorList> current = std::atomic_load(&sensors_);
+  if (!Contains(*current, sensor))
+  {
+    // Sensor is not registered
+    return false;
+  }
+
+  SensorList next(*current);
+  next.erase(std::remove(next.begin(), next.end(), sensor), next.end());
+  PublishSensors(std::move(next));
+
+  QueueChange(sensor, false);
+  std::cout << "Removed sensor [" << sensor->name_ << "] from Sensor Manager" << std::endl;
+  return true;
+}
+
+bool SensorManager::remove_sensor(Buffer& buffer, std::shared_ptr<SensorAbsClass> sensor)
+{
+  if (!does_sensor_exist(sensor))
+  {
+    // Sensor is not registered
+    return false;
+  }
+
+  // Deactive the sensor
+  this->deactivate_sensor(buffer, sensor);
+
+  // Remove the sensor from the list
+  std::lock_guard<std::mutex> lock(mutex_);
+  SensorList next(*std::atomic_load(&sensors_));
+  next.erase(std::remove(next.begin(), next.end(), sensor), next.end());
+  PublishSensors(std::move(next));
+
+  std::cout << "Removed sensor [" << sensor->name_ << "] from Sensor Manager" << std::endl;
+  return true;
+}
+
+void SensorManager::list_sensors() const
+{
+  const std::shared_ptr<const SensorList> sensors = get_sensor_list();
+
+  std::cout << "Sensor Manager contains " << sensors->size() << " sensors" << std::endl;
+  for (const auto& sensor : *sensors)
+  {
+    std::cout << *sensor << std::endl;
+  }
+}
+
+bool SensorManager::does_sensor_exist(const std::shared_ptr<SensorAbsClass>& sensor) const
+{
+  return Contains(*get_sensor_list(), sensor);
+}
+
+bool SensorManager::QueueDeactivateSensor(std::shared_ptr<SensorAbsClass> sensor)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!Contains(*std::atomic_load(&sensors_), sensor))
+  {
+    // Sensor is not registered
+    return false;
+  }
+
+  QueueChange(sensor, false);
+  return true;
+}
+
+bool SensorManager::deactivate_sensor(Buffer& buffer, std::shared_ptr<SensorAbsClass> sensor)
+{
+  if (!does_sensor_exist(sensor))
+  {
+    // Sensor is not registered
+    return false;
+  }
+
+  // Reset the sensor
+  ResetSensor(sensor);
+
+  // Call buffer to clear all entries of the sensor
+  if (buffer.RemoveSensorFromBuffer(sensor))
+  {
+    std::cout << "Removed sensor [" << sensor->name_ << "] from buffer" << std::endl;
+  }
+  else
+  {
+    std::cout << "Could not remove sensor [" << sensor->name_ << "] from buffer as buffer is empty" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool SensorManager::activate_sensor(std::shared_ptr<SensorAbsClass> sensor)
 {
+  if (!does_sensor_exist(sensor))
+  {
+    // Sensor is not registered
+    return false;
+  }
 
+  sensor->do_update_ = true;
+  std::cout << "Activated sensor [" << sensor->name_ << "]" << std::endl;
+  return true;
+}
+
+bool SensorManager::activate_sensor(Buffer& buffer, std::shared_ptr<SensorAbsClass> sensor)
+{
+  if (!does_sensor_exist(sensor))
+  {
+    // Sensor is not registered
+    return false;
+  }
+
+  const auto retired = std::find(retired_sensors_.begin(), retired_sensors_.end(), sensor);
+  if (retired != retired_sensors_.end())
+  {
+    // Entries of the previous deactivation must not be mixed with the new measurements
+    buffer.RemoveSensorEntries({ sensor }, 0, buffer.get_length());
+    retired_sensors_.erase(retired);
+  }
+
+  return activate_sensor(sensor);
+}
+
+bool SensorManager::QueueActivateSensor(std::shared_ptr<SensorAbsClass> sensor)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (!Contains(*std::atomic_load(&sensors_), sensor))
+  {
+    // Sensor is not registered
+    return false;
+  }
+
+  QueueChange(sensor, true);
+  return true;
+}
+
+std::shared_ptr<const SensorManager::SensorList> SensorManager::get_sensor_list() const
+{
+  return std::atomic_load(&sensors_);
+}
+
+int SensorManager::ApplyPendingChanges(Buffer* buffer, const bool& can_remove_entries)
+{
+  if (num_pending_changes_.load(std::memory_order_acquire) == 0)
+  {
+    return 0;
+  }
+
+  std::vector<SensorChange> changes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    changes.swap(pending_changes_);
+    num_pending_changes_ = 0;
+  }
+
+  size_t num_applied = 0;
+  for (; num_applied < changes.size(); num_applied++)
+  {
+    const SensorChange& k = changes[num_applied];
+    const auto retired = std::find(retired_sensors_.begin(), retired_sensors_.end(), k.sensor_);
+
+    if (k.activate_)
+    {
+      if (retired != retired_sensors_.end())
+      {
+        if (!can_remove_entries)
+        {
+          // Changes are applied in order, the remaining ones wait for the removal
+          break;
+        }
+
+        // Entries of the previous deactivation must not be mixed with the new measurements
+        buffer->RemoveSensorEntries({ k.sensor_ }, 0, buffer->get_length());
+        retired_sensors_.erase(retired);
+      }
+
+      k.sensor_->do_update_ = true;
+      std::cout << "Activated sensor [" << k.sensor_->name_ << "]" << std::endl;
+    }
+    else
+    {
+      ResetSensor(k.sensor_);
+
+      if (retired == retired_sensors_.end())
+      {
+        retired_sensors_.push_back(k.sensor_);
+      }
+
+      // Earlier parts of the buffer were only scanned for the previously retired sensors
+      cleanup_from_start_ = true;
+    }
+  }
+
+  if (num_applied < changes.size())
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_changes_.insert(pending_changes_.begin(), changes.begin() + static_cast<long>(num_applied), changes.end());
+    num_pending_changes_.store(static_cast<int>(pending_changes_.size()), std::memory_order_release);
+  }
+
+  return static_cast<int>(num_applied);
+}
+
+int SensorManager::CollectGarbage(Buffer* buffer)
+{
+  if (retired_sensors_.empty())
+  {
+    return 0;
+  }
+
+  const int start_idx = cleanup_from_start_ ? 0 : buffer->LowerBoundIdx(cleanup_cursor_);
+  const int end_idx = std::min(start_idx + std::max(cleanup_step_, 1), buffer->get_length());
+  int num_removed = buffer->RemoveSensorEntries(retired_sensors_, start_idx, end_idx);
+
+  // The entries after the range moved by the number of removed entries
+  const int next_idx = end_idx - num_removed;
+  BufferEntryType next_entry;
+  if (buffer->get_entry_at_idx(next_idx, &next_entry))
+  {
+    if (cleanup_from_start_ || cleanup_cursor_ < next_entry.timestamp_)
+    {
+      cleanup_cursor_ = next_entry.timestamp_;
+      cleanup_from_start_ = false;
+      return num_removed;
+    }
+
+    // More than 'cleanup_step_' entries share the cursor timestamp, the cursor can not advance
+    num_removed += buffer->RemoveSensorEntries(retired_sensors_, next_idx, buffer->get_length());
+  }
+
+  for (const auto& k : retired_sensors_)
+  {
+    std::cout << "Removed sensor [" << k->name_ << "] from buffer" << std::endl;
+  }
+  retired_sensors_.clear();
+  cleanup_from_start_ = true;
+  return num_removed;
+}
+
+bool SensorManager::IsCleanupPending() const
+{
+  return num_pending_changes_.load(std::memory_order_acquire) > 0 || !retired_sensors_.empty();
+}
+
+void SensorManager::ResetSensor(const std::shared_ptr<SensorAbsClass>& sensor)
+{
+  sensor->do_update_ = false;
+  sensor->is_initialized_ = false;
+  sensor->ref_to_nav_given_ = false;
+}
+
+void SensorManager::QueueChange(const std::shared_ptr<SensorAbsClass>& sensor, const bool& activate)
+{
+  pending_changes_.push_back({ sensor, activate });
+  num_pending_changes_.store(static_cast<int>(pending_changes_.size()), std::memory_order_release);
+}
+
+void SensorManager::PublishSensors(SensorList sensors)
+{
+  sensor_list_ = sensors;
+  std::atomic_store(&sensors_, std::shared_ptr<const SensorList>(std::make_shared<SensorList>(std::move(sensors))));
+}
+
+bool SensorManager::Contains(const SensorList& list, const std::shared_ptr<SensorAbsClass>& sensor)
+{
+  return std::find(list.begin(), list.end(), sensor) != list.end();
 }
+}  // namespace mars
@@ -0,0 +1,223 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <fcntl.h>
+#include <mars/shm_state_publisher.h>
+#include <mars/type_definitions/core_type.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace mars
+{
+ShmStatePublisher::ShmStatePublisher(std::string name, const uint32_t& num_slots, const shm::CovMode& cov_mode)
+  : name_(std::move(name)), num_slots_(num_slots > 0 ? num_slots : 1), cov_mode_(cov_mode)
+{
+  segment_size_ = shm::get_segment_size(num_slots_);
+}
+
+ShmStatePublisher::~ShmStatePublisher()
+{
+  Close();
+}
+
+bool ShmStatePublisher::Open()
+{
+  if (IsOpen())
+  {
+    return true;
+  }
+
+  const int fd = shm_open(name_.c_str(), O_CREAT | O_RDWR, 0644);
+  if (fd < 0)
+  {
+    std::cout << "ShmStatePublisher: Warning: Could not open shared memory object " << name_ << std::endl;
+    return false;
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(segment_size_)) != 0)
+  {
+    std::cout << "ShmStatePublisher: Warning: Could not resize shared memory object " << name_ << std::endl;
+    close(fd);
+    return false;
+  }
+
+  void* segment = mmap(nullptr, segment_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (segment == MAP_FAILED)
+  {
+    std::cout << "ShmStatePublisher: Warning: Could not map shared memory object " << name_ << std::endl;
+    return false;
+  }
+
+  segment_ = segment;
+  std::memset(segment_, 0, segment_size_);
+
+  header_ = static_cast<shm::ShmStateHeader*>(segment_);
+  slots_ = reinterpret_cast<shm::ShmStateSlot*>(static_cast<char*>(segment_) + sizeof(shm::ShmStateHeader));
+
+  header_->version = shm::kShmStateLayoutVersion;
+  header_->num_slots = num_slots_;
+  header_->slot_size = sizeof(shm::ShmStateSlot);
+  header_->cov_mode = static_cast<uint32_t>(cov_mode_);
+  header_->write_count.store(0, std::memory_order_relaxed);
+
+  // The magic is written last, readers that find it can rely on the remaining header fields
+  std::atomic_thread_fence(std::memory_order_release);
+  header_->magic = shm::kShmStateMagic;
+
+  std::cout << "Created: ShmStatePublisher (" << name_ << ", Slots=" << num_slots_ << ")" << std::endl;
+  return true;
+}
+
+void ShmStatePublisher::Close()
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+
+  munmap(segment_, segment_size_);
+  shm_unlink(name_.c_str());
+
+  segment_ = nullptr;
+  header_ = nullptr;
+  slots_ = nullptr;
+}
+
+bool ShmStatePublisher::IsOpen() const
+{
+  return segment_ != nullptr;
+}
+
+int ShmStatePublisher::RegisterSensor(const std::shared_ptr<SensorAbsClass>& sensor, ShmSensorPacker packer)
+{
+  const int existing_id = FindSensorId(sensor.get());
+  if (existing_id >= 0)
+  {
+    sensors_[static_cast<size_t>(existing_id)].packer = std::move(packer);
+    return existing_id;
+  }
+
+  if (static_cast<int>(sensors_.size()) >= shm::kMaxSensors)
+  {
+    std::cout << "ShmStatePublisher: Warning: Max number of sensors reached, [" << sensor->name_
+              << "] is not published" << std::endl;
+    return -1;
+  }
+
+  const int sensor_id = static_cast<int>(sensors_.size());
+  sensors_.push_back({ sensor, std::move(packer) });
+
+  shm::ShmSensorBlock block;
+  std::memset(&block, 0, sizeof(block));
+  block.sensor_id = sensor_id;
+  std::strncpy(block.name, sensor->name_.c_str(), shm::kMaxSensorNameLength - 1);
+  sensor_blocks_.push_back(block);
+
+  return sensor_id;
+}
+
+bool ShmStatePublisher::Publish(const BufferEntryType& entry)
+{
+  if (!IsOpen() || !entry.data_.HasCoreStates())
+  {
+    return false;
+  }
+
+  // Keep the latest state of registered sensors
+  int source_id = FindSensorId(entry.sensor_handle_.get());
+  if (source_id >= 0 && entry.data_.HasSensorStates())
+  {
+    shm::ShmSensorBlock& block = sensor_blocks_[static_cast<size_t>(source_id)];
+    block.size = sensors_[static_cast<size_t>(source_id)].packer(entry.data_.sensor_state_, block.state,
+                                                                 block.cov_diag, shm::kMaxSensorStates);
+    block.timestamp = entry.timestamp_.get_seconds();
+  }
+
+  if (entry.sensor_handle_ == propagation_sensor_)
+  {
+    source_id = -1;
+  }
+
+  const CoreType* core = static_cast<const CoreType*>(entry.data_.core_state_.get());
+
+  const uint64_t count = header_->write_count.load(std::memory_order_relaxed) + 1;
+  shm::ShmStateSlot& slot = slots_[(count - 1) % num_slots_];
+
+  // Sequence lock, odd while writing
+  slot.seq.store(2 * count - 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  shm::ShmStatePayload& payload = slot.payload;
+  payload.timestamp = entry.timestamp_.get_seconds();
+  payload.source_sensor_id = source_id;
+  payload.cov_mode = static_cast<uint32_t>(cov_mode_);
+
+  const CoreStateType& state = core->state_;
+  double* x = payload.core_state;
+  Eigen::Map<Eigen::Vector3d>(x + 0) = state.p_wi_;
+  Eigen::Map<Eigen::Vector3d>(x + 3) = state.v_wi_;
+  x[6] = state.q_wi_.w();
+  Eigen::Map<Eigen::Vector3d>(x + 7) = state.q_wi_.vec();
+  Eigen::Map<Eigen::Vector3d>(x + 10) = state.b_w_;
+  Eigen::Map<Eigen::Vector3d>(x + 13) = state.b_a_;
+  Eigen::Map<Eigen::Vector3d>(x + 16) = state.w_m_;
+  Eigen::Map<Eigen::Vector3d>(x + 19) = state.a_m_;
+
+  if (cov_mode_ == shm::CovMode::full)
+  {
+    Eigen::Map<Eigen::Matrix<double, CoreStateType::size_error_, CoreStateType::size_error_, Eigen::RowMajor>>(
+        payload.core_cov) = core->cov_;
+  }
+  else
+  {
+    Eigen::Map<CoreStateVector>(payload.core_cov) = core->cov_.diagonal();
+  }
+
+  payload.num_sensors = static_cast<int32_t>(sensor_blocks_.size());
+  if (!sensor_blocks_.empty())
+  {
+    std::memcpy(payload.sensors, sensor_blocks_.data(), sensor_blocks_.size() * sizeof(shm::ShmSensorBlock));
+  }
+
+  // Release the slot and announce the new state
+  slot.seq.store(2 * count, std::memory_order_release);
+  header_->write_count.store(count, std::memory_order_release);
+
+  return true;
+}
+
+uint64_t ShmStatePublisher::get_write_count() const
+{
+  if (!IsOpen())
+  {
+    return 0;
+  }
+
+  return header_->write_count.load(std::memory_order_acquire);
+}
+
+int ShmStatePublisher::FindSensorId(const SensorAbsClass* sensor) const
+{
+  for (size_t k = 0; k < sensors_.size(); k++)
+  {
+    if (sensors_[k].sensor.get() == sensor)
+    {
+      return static_cast<int>(k);
+    }
+  }
+
+  return -1;
+}
+}  // namespace mars
@@ -0,0 +1,169 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <fcntl.h>
+#include <mars/shm_state_reader.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace mars
+{
+ShmStateReader::ShmStateReader(std::string name) : name_(std::move(name))
+{
+}
+
+ShmStateReader::~ShmStateReader()
+{
+  Close();
+}
+
+bool ShmStateReader::Open()
+{
+  if (IsOpen())
+  {
+    return true;
+  }
+
+  const int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  struct stat segment_stat;
+  if (fstat(fd, &segment_stat) != 0 || static_cast<size_t>(segment_stat.st_size) < sizeof(shm::ShmStateHeader))
+  {
+    close(fd);
+    return false;
+  }
+
+  const size_t segment_size = static_cast<size_t>(segment_stat.st_size);
+  void* segment = mmap(nullptr, segment_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (segment == MAP_FAILED)
+  {
+    return false;
+  }
+
+  const shm::ShmStateHeader* header = static_cast<const shm::ShmStateHeader*>(segment);
+
+  if (header->magic != shm::kShmStateMagic || header->version != shm::kShmStateLayoutVersion ||
+      header->slot_size != sizeof(shm::ShmStateSlot) || shm::get_segment_size(header->num_slots) > segment_size)
+  {
+    std::cout << "ShmStateReader: Warning: Segment " << name_ << " has an unknown layout" << std::endl;
+    munmap(segment, segment_size);
+    return false;
+  }
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+
+  segment_ = segment;
+  segment_size_ = segment_size;
+  header_ = header;
+  slots_ = reinterpret_cast<const shm::ShmStateSlot*>(static_cast<const char*>(segment_) +
+                                                      sizeof(shm::ShmStateHeader));
+  return true;
+}
+
+void ShmStateReader::Close()
+{
+  if (!IsOpen())
+  {
+    return;
+  }
+
+  munmap(segment_, segment_size_);
+  segment_ = nullptr;
+  header_ = nullptr;
+  slots_ = nullptr;
+}
+
+bool ShmStateReader::IsOpen() const
+{
+  return segment_ != nullptr;
+}
+
+uint64_t ShmStateReader::get_write_count() const
+{
+  if (!IsOpen())
+  {
+    return 0;
+  }
+
+  return header_->write_count.load(std::memory_order_acquire);
+}
+
+bool ShmStateReader::get_latest(shm::ShmStatePayload* payload, uint64_t* write_count) const
+{
+  // The publisher can overtake the reader, retry with the newest count in this case
+  for (int k = 0; k < max_retries_; k++)
+  {
+    const uint64_t count = get_write_count();
+
+    if (count == 0)
+    {
+      return false;
+    }
+
+    if (get_by_count(count, payload))
+    {
+      if (write_count != nullptr)
+      {
+        *write_count = count;
+      }
+      return true;
+    }
+  }
+
+  return false;
+}
+
+bool ShmStateReader::get_by_count(const uint64_t& count, shm::ShmStatePayload* payload) const
+{
+  if (!IsOpen() || count == 0)
+  {
+    return false;
+  }
+
+  const shm::ShmStateSlot& slot = slots_[(count - 1) % header_->num_slots];
+
+  for (int k = 0; k < max_retries_; k++)
+  {
+    const uint64_t seq_start = slot.seq.load(std::memory_order_acquire);
+
+    if (seq_start > 2 * count)
+    {
+      // Slot was overwritten by a newer state
+      return false;
+    }
+
+    if (seq_start != 2 * count)
+    {
+      // Slot is currently written
+      continue;
+    }
+
+    std::memcpy(payload, &slot.payload, sizeof(shm::ShmStatePayload));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (slot.seq.load(std::memory_order_relaxed) == seq_start)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+}  // namespace mars
@@ -0,0 +1,64 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/state_observer.h>
+#include <iostream>
+#include <utility>
+
+namespace mars
+{
+StateEventQueue::StateEventQueue(const size_t& capacity) : slots_(capacity + 1)
+{
+  std::cout << "Created: StateEventQueue (Capacity=" << capacity << ")" << std::endl;
+}
+
+bool StateEventQueue::Push(const BufferEntryType& entry, const bool& is_correction)
+{
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  const size_t next_tail = (tail + 1) % slots_.size();
+
+  if (next_tail == head_.load(std::memory_order_acquire))
+  {
+    num_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  slots_[tail].entry_ = entry;
+  slots_[tail].is_correction_ = is_correction;
+  tail_.store(next_tail, std::memory_order_release);
+  return true;
+}
+
+bool StateEventQueue::Pop(StateEvent* event)
+{
+  const size_t head = head_.load(std::memory_order_relaxed);
+
+  if (head == tail_.load(std::memory_order_acquire))
+  {
+    return false;
+  }
+
+  *event = std::move(slots_[head]);
+  head_.store((head + 1) % slots_.size(), std::memory_order_release);
+  return true;
+}
+
+size_t StateEventQueue::get_size() const
+{
+  const size_t head = head_.load(std::memory_order_acquire);
+  const size_t tail = tail_.load(std::memory_order_acquire);
+  return (tail + slots_.size() - head) % slots_.size();
+}
+
+uint64_t StateEventQueue::get_num_dropped() const
+{
+  return num_dropped_.load(std::memory_order_relaxed);
+}
+}  // namespace mars
@@ -0,0 +1,100 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/state_transition_tree.h>
+#include <algorithm>
+#include <cassert>
+
+namespace mars
+{
+void StateTransitionTree::Resize(const int& size)
+{
+  assert(size >= 0);
+
+  size_ = size;
+  nodes_.assign(2 * static_cast<size_t>(size), CoreStateMatrix::Identity());
+  dirty_first_ = -1;
+  dirty_last_ = -1;
+}
+
+int StateTransitionTree::size() const
+{
+  return size_;
+}
+
+void StateTransitionTree::SetLeaf(const int& idx, const CoreStateMatrix& transition)
+{
+  assert(idx >= 0 && idx < size_);
+
+  nodes_[size_ + idx] = transition;
+
+  if (dirty_first_ < 0)
+  {
+    dirty_first_ = idx;
+    dirty_last_ = idx;
+  }
+  else
+  {
+    dirty_first_ = std::min(dirty_first_, idx);
+    dirty_last_ = std::max(dirty_last_, idx);
+  }
+}
+
+CoreStateMatrix StateTransitionTree::Query(const int& first, const int& last)
+{
+  assert(first >= 0 && last < size_);
+
+  UpdateInnerNodes();
+
+  // Older nodes are collected from the left border, newer nodes from the right border
+  CoreStateMatrix result_older(CoreStateMatrix::Identity());
+  CoreStateMatrix result_newer(CoreStateMatrix::Identity());
+
+  for (int l = first + size_, r = last + size_ + 1; l < r; l >>= 1, r >>= 1)
+  {
+    if (l & 1)
+    {
+      result_older = nodes_[l++] * result_older;
+    }
+    if (r & 1)
+    {
+      result_newer = result_newer * nodes_[--r];
+    }
+  }
+
+  return result_newer * result_older;
+}
+
+void StateTransitionTree::UpdateInnerNodes()
+{
+  if (dirty_first_ < 0)
+  {
+    return;
+  }
+
+  // The parents of a contiguous range of nodes are contiguous as well
+  for (int l = (dirty_first_ + size_) >> 1, r = (dirty_last_ + size_) >> 1; l >= 1; l >>= 1, r >>= 1)
+  {
+    ComputeNodes(l, r);
+  }
+
+  dirty_first_ = -1;
+  dirty_last_ = -1;
+}
+
+void StateTransitionTree::ComputeNodes(const int& first, const int& last)
+{
+  for (int k = first; k <= last; k++)
+  {
+    // The right child holds the newer transitions
+    nodes_[k].noalias() = nodes_[2 * k + 1] * nodes_[2 * k];
+  }
+}
+}  // namespace mars
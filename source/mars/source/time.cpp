@@ -36,6 +36,12 @@ Time Time::get_time_now()
   return Time(sys_sec);
 }
 
+int64_t Time::get_wall_time_ns()
+{
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
 double Time::get_seconds() const
 {
   return seconds_;
@@ -35,6 +35,21 @@ Eigen::MatrixXd Utils::EnforceMatrixSymmetry(const Eigen::Ref<const Eigen::Matri
   return mat_out;
 }
 
+void Utils::EnforceMatrixSymmetry(Eigen::MatrixXd* mat)
+{
+  assert(mat->rows() == mat->cols());
+
+  for (int col = 0; col < mat->cols(); col++)
+  {
+    for (int row = col; row < mat->rows(); row++)
+    {
+      const double value = ((*mat)(row, col) + (*mat)(col, row)) / 2;
+      (*mat)(row, col) = value;
+      (*mat)(col, row) = value;
+    }
+  }
+}
+
 void Utils::TransformImu(const IMUMeasurementType& prev, const IMUMeasurementType& now, const double& dt,
                          const Eigen::Vector3d& p_ab, const Eigen::Quaterniond& q_ab, IMUMeasurementType& result)
 {
@@ -138,37 +153,6 @@ Eigen::Quaterniond Utils::ApplySmallAngleQuatCorr(const Eigen::Quaterniond& q_pr
   return (q_prior * QuatFromSmallAngle(correction)).normalized();
 }
 
-bool Utils::CheckCov(const Eigen::MatrixXd& cov_mat, const std::string& description, const bool& /*check_cond*/)
-{
-  bool result = true;
-  std::string info("[" + description + "]" + ": ");
-
-  bool is_symmetric = Eigen::MatrixXd::Zero(cov_mat.rows(), cov_mat.cols()).isApprox(cov_mat - cov_mat.transpose());
-  if (!is_symmetric)
-  {
-    std::cout << "Warning: " << info << "The covariance matrix is not symmetric" << std::endl;
-    result = false;
-  }
-
-  double det = cov_mat.determinant();
-  if (det <= 0)
-  {
-    std::cout << "Warning: " << info << "The determinant of the covariance matrix is not positive (" << det << ")"
-              << std::endl;
-    result = false;
-  }
-
-  double min_eigenvalue = Eigen::EigenSolver<Eigen::MatrixXd>(cov_mat).eigenvalues().real().minCoeff();
-  if (min_eigenvalue < 0)
-  {
-    std::cout << "Warning: " << info << "The covariance matrix is not positive semidefinite min: " << min_eigenvalue
-              << std::endl;
-    result = false;
-  }
-
-  return result;
-}
-
 Eigen::Vector3d Utils::RPYFromRotMat(const Eigen::Matrix3d& rot_mat)
 {
   // according to this post, mat.eulerAngles returns the correct angles
@@ -0,0 +1,199 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#ifndef SCENARIO_FILTER_FIXTURE_H
+#define SCENARIO_FILTER_FIXTURE_H
+
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/scenario_generator.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/sensors/position/position_sensor_class.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <Eigen/Dense>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mars_test
+{
+///
+/// \brief ScenarioSensor Sensor of the ScenarioGenerator without delay and dropouts
+///
+inline mars::ScenarioSensorConfig ScenarioSensor(const mars::ScenarioSensorType& type, const std::string& name,
+                                                 const double& rate, const double& noise_std = 0,
+                                                 const double& noise_std_secondary = 0)
+{
+  mars::ScenarioSensorConfig sensor;
+  sensor.type_ = type;
+  sensor.name_ = name;
+  sensor.rate_ = rate;
+  sensor.noise_std_ = noise_std;
+  sensor.noise_std_secondary_ = noise_std_secondary;
+  return sensor;
+}
+
+///
+/// \brief The ScenarioFilterConfig struct holds the filter settings which differ between the scenario tests
+///
+struct ScenarioFilterConfig
+{
+  Eigen::Vector3d imu_n_w_{ Eigen::Vector3d::Ones() * 1e-3 };   ///< Gyro noise std
+  Eigen::Vector3d imu_n_bw_{ Eigen::Vector3d::Ones() * 1e-4 };  ///< Gyro bias random walk std
+  Eigen::Vector3d imu_n_a_{ Eigen::Vector3d::Ones() * 1e-2 };   ///< Accelerometer noise std
+  Eigen::Vector3d imu_n_ba_{ Eigen::Vector3d::Ones() * 1e-3 };  ///< Accelerometer bias random walk std
+
+  Eigen::Vector3d p_cov_{ Eigen::Vector3d::Ones() * 0.01 };   ///< Initial position variance
+  Eigen::Vector3d v_cov_{ Eigen::Vector3d::Ones() * 4 };      ///< Initial velocity variance
+  Eigen::Vector3d q_cov_{ Eigen::Vector3d::Ones() * 0.01 };   ///< Initial orientation variance
+  Eigen::Vector3d bw_cov_{ Eigen::Vector3d::Ones() * 1e-4 };  ///< Initial gyro bias variance
+  Eigen::Vector3d ba_cov_{ Eigen::Vector3d::Ones() * 1e-2 };  ///< Initial accelerometer bias variance
+
+  double position_meas_std_{ 0.01 };      ///< Position std of the pose and position measurements [m]
+  double orientation_meas_std_{ 0.005 };  ///< Orientation std of the pose measurements [rad]
+  double calib_cov_{ 1e-8 };              ///< Initial variance of the sensor calibration states
+  bool chi2_test_{ false };               ///< Chi2 test of the update sensors, the scenarios have no outliers
+};
+
+///
+/// \brief ImuPoseTestConfig Settings of the IMU and pose unit tests
+///
+/// Noise free IMU, unit initial core covariance and an active chi2 test. The tests drive the filter with their own
+/// synthetic measurements instead of a ScenarioGenerator.
+///
+inline ScenarioFilterConfig ImuPoseTestConfig()
+{
+  ScenarioFilterConfig config;
+  config.imu_n_w_.setZero();
+  config.imu_n_bw_.setZero();
+  config.imu_n_a_.setZero();
+  config.imu_n_ba_.setZero();
+  config.p_cov_.setOnes();
+  config.v_cov_.setOnes();
+  config.q_cov_.setOnes();
+  config.bw_cov_.setOnes();
+  config.ba_cov_.setOnes();
+  config.position_meas_std_ = 0.02;
+  config.orientation_meas_std_ = 0.03;
+  config.calib_cov_ = 0.01;
+  config.chi2_test_ = true;
+  return config;
+}
+
+///
+/// \brief The ScenarioFilter class is the IMU driven filter for the measurements of a ScenarioGenerator
+///
+/// The core states use the IMU noise and the initial covariance of the config. Update sensors are added in the order
+/// they were added to the generator. They start at the identity calibration and use the navigation frame as constant
+/// reference. Tests without a generator add their sensors directly and start with StartAtOrigin.
+///
+class ScenarioFilter
+{
+public:
+  explicit ScenarioFilter(const ScenarioFilterConfig& config = ScenarioFilterConfig()) : config_(config)
+  {
+    imu_sensor_sptr_ = std::make_shared<mars::ImuSensorClass>("imu");
+    core_states_sptr_ = std::make_shared<mars::CoreState>();
+    core_states_sptr_->set_propagation_sensor(imu_sensor_sptr_);
+    core_states_sptr_->set_noise_std(config_.imu_n_w_, config_.imu_n_bw_, config_.imu_n_a_, config_.imu_n_ba_);
+    core_states_sptr_->set_initial_covariance(config_.p_cov_, config_.v_cov_, config_.q_cov_, config_.bw_cov_,
+                                              config_.ba_cov_);
+    sensors_.push_back(imu_sensor_sptr_);
+
+    core_logic_ = std::make_shared<mars::CoreLogic>(core_states_sptr_);
+    core_logic_->verbose_ = false;
+  }
+
+  std::shared_ptr<mars::PoseSensorClass> AddPoseSensor(const std::string& name)
+  {
+    std::shared_ptr<mars::PoseSensorClass> pose_sensor_sptr =
+        std::make_shared<mars::PoseSensorClass>(name, core_states_sptr_);
+    pose_sensor_sptr->const_ref_to_nav_ = true;
+    pose_sensor_sptr->chi2_.ActivateTest(config_.chi2_test_);
+    Eigen::Matrix<double, 6, 1> pose_meas_std;
+    pose_meas_std << Eigen::Vector3d::Ones() * config_.position_meas_std_,
+        Eigen::Vector3d::Ones() * config_.orientation_meas_std_;
+    pose_sensor_sptr->R_ = pose_meas_std.cwiseProduct(pose_meas_std);
+
+    mars::PoseSensorData pose_init_cal;
+    pose_init_cal.state_.p_ip_ = Eigen::Vector3d::Zero();
+    pose_init_cal.state_.q_ip_ = Eigen::Quaterniond::Identity();
+    pose_init_cal.sensor_cov_ = Eigen::Matrix<double, 6, 6>::Identity() * config_.calib_cov_;
+    pose_sensor_sptr->set_initial_calib(std::make_shared<mars::PoseSensorData>(pose_init_cal));
+
+    sensors_.push_back(pose_sensor_sptr);
+    pose_sensors_.push_back(pose_sensor_sptr);
+    return pose_sensor_sptr;
+  }
+
+  std::shared_ptr<mars::PositionSensorClass> AddPositionSensor(const std::string& name)
+  {
+    std::shared_ptr<mars::PositionSensorClass> position_sensor_sptr =
+        std::make_shared<mars::PositionSensorClass>(name, core_states_sptr_);
+    position_sensor_sptr->const_ref_to_nav_ = true;
+    position_sensor_sptr->chi2_.ActivateTest(config_.chi2_test_);
+    position_sensor_sptr->R_ = Eigen::Vector3d::Ones() * config_.position_meas_std_ * config_.position_meas_std_;
+
+    mars::PositionSensorData position_init_cal;
+    position_init_cal.state_.p_ip_ = Eigen::Vector3d::Zero();
+    position_init_cal.sensor_cov_ = Eigen::Matrix3d::Identity() * config_.calib_cov_;
+    position_sensor_sptr->set_initial_calib(std::make_shared<mars::PositionSensorData>(position_init_cal));
+
+    sensors_.push_back(position_sensor_sptr);
+    return position_sensor_sptr;
+  }
+
+  ///
+  /// \brief get_entries Measurements of the generator for the IMU and the added update sensors
+  ///
+  std::vector<mars::BufferEntryType> get_entries(const mars::ScenarioGenerator& generator,
+                                                 const bool& arrival_order = false) const
+  {
+    return generator.get_entries(sensors_, arrival_order);
+  }
+
+  ///
+  /// \brief Initialize Initializes the core at the true state of the generator at t = 0
+  ///
+  void Initialize(const mars::ScenarioGenerator& generator) const
+  {
+    const mars::CoreStateType initial = generator.get_true_state(0);
+    core_logic_->Initialize(initial.p_wi_, initial.q_wi_);
+  }
+
+  ///
+  /// \brief Start Processes the first entry, which must be an IMU measurement, and initializes the core
+  ///
+  void Start(const mars::ScenarioGenerator& generator, const mars::BufferEntryType& first) const
+  {
+    core_logic_->ProcessMeasurement(first.sensor_handle_, first.timestamp_, first.data_);
+    Initialize(generator);
+  }
+
+  ///
+  /// \brief StartAtOrigin Processes the IMU measurement 'imu_data' at t = 0 and initializes the core at the origin
+  ///
+  void StartAtOrigin(const mars::BufferDataType& imu_data) const
+  {
+    core_logic_->ProcessMeasurement(imu_sensor_sptr_, 0, imu_data);
+    core_logic_->Initialize(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+  }
+
+  ScenarioFilterConfig config_;
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr_;
+  std::shared_ptr<mars::CoreState> core_states_sptr_;
+  std::shared_ptr<mars::CoreLogic> core_logic_;
+  std::vector<std::shared_ptr<mars::SensorAbsClass>> sensors_;        ///< IMU and update sensors in the order of addition
+  std::vector<std::shared_ptr<mars::PoseSensorClass>> pose_sensors_;  ///< Pose sensors in the order of addition
+};
+}  // namespace mars_test
+
+#endif  // SCENARIO_FILTER_FIXTURE_H
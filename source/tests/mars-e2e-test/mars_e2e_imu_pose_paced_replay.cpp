@@ -0,0 +1,81 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/scenario_generator.h>
+#include <mars/paced_replayer.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <Eigen/Dense>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "../common/scenario_filter_fixture.h"
+
+///
+/// \brief mars_e2e_imu_pose_paced_replay Latency benchmark with a paced replay of a 200Hz IMU and delayed 30Hz pose
+///
+class mars_e2e_imu_pose_paced_replay : public testing::Test
+{
+public:
+  static void PrintStats(const std::string& name, const mars::LatencyStats& stats)
+  {
+    std::cout << name << ": n=" << stats.num_samples_ << " mean=" << 1e3 * stats.mean_ << "ms p50=" << 1e3 * stats.p50_
+              << "ms p90=" << 1e3 * stats.p90_ << "ms p99=" << 1e3 * stats.p99_ << "ms max=" << 1e3 * stats.max_
+              << "ms deadline misses=" << stats.num_deadline_misses_ << std::endl;
+  }
+};
+
+TEST_F(mars_e2e_imu_pose_paced_replay, LATENCY)
+{
+  mars::ScenarioConfig config;
+  config.duration_ = 20;
+  mars::ScenarioGenerator generator(config);
+
+  generator.AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 200, 0.05, 0.005));
+  generator.AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::pose, "pose", 30, 0.02, 0.01));
+  generator.Generate();
+
+  mars_test::ScenarioFilterConfig filter_config;
+  filter_config.imu_n_w_ = Eigen::Vector3d::Ones() * 0.005;
+  filter_config.imu_n_a_ = Eigen::Vector3d::Ones() * 0.05;
+  filter_config.position_meas_std_ = 0.02;
+  filter_config.orientation_meas_std_ = 0.01;
+  filter_config.calib_cov_ = 1e-6;
+  mars_test::ScenarioFilter filter(filter_config);
+  const std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = filter.imu_sensor_sptr_;
+  const std::shared_ptr<mars::PoseSensorClass> pose_sensor_sptr = filter.AddPoseSensor("pose");
+  mars::CoreLogic& core_logic = *filter.core_logic_;
+  core_logic.buffer_.set_max_buffer_size(800);
+
+  // Pose measurements of an external tracking system, delivered with 40ms delay and jitter
+  mars::PacedReplayer replayer(filter.get_entries(generator));
+  replayer.speed_ = 10;
+  replayer.deadline_ = 0.1;
+  replayer.set_arrival_model(pose_sensor_sptr, { 0.04, 0.01 });
+
+  const mars::CoreStateType initial = generator.get_true_state(0);
+  replayer.initializer_ = [&initial](mars::CoreLogic* core) { core->Initialize(initial.p_wi_, initial.q_wi_); };
+
+  const mars::PacedReplayResult result = replayer.Run(&core_logic);
+
+  std::cout << "Processed " << result.num_processed_ << " measurements in " << result.wall_time_ << "s, "
+            << result.num_out_of_order_ << " out of order, " << result.num_reworks_ << " reworks" << std::endl;
+  // The wall clock statistics depend on the host and its load, they are reported but not asserted
+  PrintStats("Processing", result.processing_);
+  PrintStats("Measurement to estimate", result.latency_);
+  PrintStats("IMU", result.sensor_latency_.at(imu_sensor_sptr));
+  PrintStats("Pose", result.sensor_latency_.at(pose_sensor_sptr));
+
+  EXPECT_EQ(result.num_processed_, 4001 + 601);
+  EXPECT_GT(result.num_reworks_, 0);
+}
@@ -0,0 +1,155 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_state_kernels.h>
+#include <mars/data_utils/read_sim_data.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <yaml-cpp/yaml.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <iostream>
+#include "../include_local/test_data_settings.h"
+
+///
+/// \brief mars_e2e_imu_prop_precision End to end test of the core state propagation with float, mixed and double
+/// precision
+///
+/// The propagation with the scalar templated kernels is compared to the double precision result and the drift of the
+/// reduced precision modes is reported.
+///
+class mars_e2e_imu_prop_precision : public testing::Test
+{
+public:
+  template <typename Kernels>
+  struct PropagationResult
+  {
+    typename Kernels::State state;
+    typename Kernels::Matrix cov;
+  };
+
+  template <typename Kernels>
+  static PropagationResult<Kernels> Propagate(const std::vector<mars::BufferEntryType>& measurement_data,
+                                              const double& t_end, const YAML::Node& config)
+  {
+    using AccScalar = typename Kernels::AccVector3::Scalar;
+    using StorageScalar = typename Kernels::Vector3::Scalar;
+
+    const typename Kernels::AccVector3 n_w(Eigen::Vector3d(config["imu_n_w"].as<std::vector<double>>().data())
+                                               .template cast<AccScalar>());
+    const typename Kernels::AccVector3 n_bw(Eigen::Vector3d(config["imu_n_bw"].as<std::vector<double>>().data())
+                                                .template cast<AccScalar>());
+    const typename Kernels::AccVector3 n_a(Eigen::Vector3d(config["imu_n_a"].as<std::vector<double>>().data())
+                                               .template cast<AccScalar>());
+    const typename Kernels::AccVector3 n_ba(Eigen::Vector3d(config["imu_n_ba"].as<std::vector<double>>().data())
+                                                .template cast<AccScalar>());
+    const typename Kernels::AccVector3 g(AccScalar(0), AccScalar(0), AccScalar(9.81));
+
+    PropagationResult<Kernels> result;
+    result.cov = Kernels::Matrix::Identity() * StorageScalar(0.1);
+
+    double t_last = 0;
+    bool initialized = false;
+
+    for (const auto& k : measurement_data)
+    {
+      const mars::IMUMeasurementType* meas = static_cast<const mars::IMUMeasurementType*>(k.data_.measurement_.get());
+      const typename Kernels::Vector3 w_m = meas->angular_velocity_.cast<StorageScalar>();
+      const typename Kernels::Vector3 a_m = meas->linear_acceleration_.cast<StorageScalar>();
+      const double t = k.timestamp_.get_seconds();
+
+      if (!initialized)
+      {
+        // Initialize with ground truth, same as the CoreLogic based end to end test
+        result.state.p_wi_ = typename Kernels::Vector3(0, 0, 5);
+        result.state.w_m_ = w_m;
+        result.state.a_m_ = a_m;
+        t_last = t;
+        initialized = true;
+        continue;
+      }
+
+      const AccScalar dt = static_cast<AccScalar>(t - t_last);
+      t_last = t;
+
+      result.cov = Kernels::PredictProcessCovariance(result.cov, result.state, w_m, a_m, dt, n_a, n_ba, n_w, n_bw);
+      result.state = Kernels::PropagateState(result.state, w_m, a_m, dt, g, false, false);
+
+      if (t >= t_end)
+      {
+        break;
+      }
+    }
+
+    return result;
+  }
+};
+
+TEST_F(mars_e2e_imu_prop_precision, END_2_END_IMU_PROPAGATION_PRECISION)
+{
+  std::string test_data_path = std::string(MARS_LIB_TEST_DATA_PATH);
+  YAML::Node config = YAML::LoadFile(test_data_path + "parameter.yaml");
+  std::string traj_file_name = config["traj_file_name"].as<std::string>();
+
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+  std::vector<mars::BufferEntryType> measurement_data;
+  mars::ReadSimData(&measurement_data, imu_sensor_sptr, test_data_path + traj_file_name);
+
+  const double t_end = 240;
+  const auto result_double = Propagate<mars::CoreStateKernelsDouble>(measurement_data, t_end, config);
+  const auto result_mixed = Propagate<mars::CoreStateKernelsMixed>(measurement_data, t_end, config);
+  const auto result_float = Propagate<mars::CoreStateKernelsFloat>(measurement_data, t_end, config);
+
+  // The double precision kernels reproduce the reference of the CoreLogic based end to end test
+  const mars::CoreStateType state_double = result_double.state.ToCoreState();
+  Eigen::Vector3d true_p_wi(-4078.496717743096, 1122.195944724751, 606.096041679294);
+  Eigen::Vector3d true_v_wi(-28.432412398458293, 6.316462668407424, 8.525302373674785);
+  EXPECT_TRUE(state_double.p_wi_.isApprox(true_p_wi, 1e-5));
+  EXPECT_TRUE(state_double.v_wi_.isApprox(true_v_wi, 1e-5));
+
+  const mars::CoreStateType state_mixed = result_mixed.state.ToCoreState();
+  const mars::CoreStateType state_float = result_float.state.ToCoreState();
+
+  const double p_drift_mixed = (state_mixed.p_wi_ - state_double.p_wi_).norm();
+  const double p_drift_float = (state_float.p_wi_ - state_double.p_wi_).norm();
+  const double v_drift_mixed = (state_mixed.v_wi_ - state_double.v_wi_).norm();
+  const double v_drift_float = (state_float.v_wi_ - state_double.v_wi_).norm();
+  const double q_drift_mixed = state_mixed.q_wi_.angularDistance(state_double.q_wi_) * (180 / M_PI);
+  const double q_drift_float = state_float.q_wi_.angularDistance(state_double.q_wi_) * (180 / M_PI);
+
+  const Eigen::MatrixXd cov_double = result_double.cov;
+  const double cov_drift_mixed = (result_mixed.cov.cast<double>() - cov_double).norm() / cov_double.norm();
+  const double cov_drift_float = (result_float.cov.cast<double>() - cov_double).norm() / cov_double.norm();
+
+  std::cout << "Distance traveled [m]: " << (state_double.p_wi_ - Eigen::Vector3d(0, 0, 5)).norm() << std::endl;
+  std::cout << "Drift vs. double after " << t_end << "s [mixed, float]:" << std::endl;
+  std::cout << "  p_wi [m]:        " << p_drift_mixed << ", " << p_drift_float << std::endl;
+  std::cout << "  v_wi [m/s]:      " << v_drift_mixed << ", " << v_drift_float << std::endl;
+  std::cout << "  q_wi [deg]:      " << q_drift_mixed << ", " << q_drift_float << std::endl;
+  std::cout << "  cov (rel. norm): " << cov_drift_mixed << ", " << cov_drift_float << std::endl;
+
+  // Regression bounds for the reduced precision modes, at least twice the drift observed with this dataset
+  // (mixed: 0.15m, 1.8e-3m/s, 1.5e-4deg, float: 0.83m, 1e-2m/s, 1.2e-3deg after 4.3km, Release build). In float mode
+  // all kernels including Q_d are evaluated in float.
+  EXPECT_LT(p_drift_mixed, 0.5);
+  EXPECT_LT(v_drift_mixed, 0.01);
+  EXPECT_LT(q_drift_mixed, 0.002);
+  EXPECT_LT(cov_drift_mixed, 2e-4);
+
+  EXPECT_LT(p_drift_float, 1.5);
+  EXPECT_LT(v_drift_float, 0.02);
+  EXPECT_LT(q_drift_float, 0.003);
+  EXPECT_LT(cov_drift_float, 1e-3);
+
+  // Accumulation in double precision must not be worse than full float precision
+  EXPECT_LE(p_drift_mixed, p_drift_float);
+}
@@ -0,0 +1,132 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/scenario_generator.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/position/position_sensor_class.h>
+#include <mars/time.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <Eigen/Dense>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+///
+/// \brief mars_e2e_scenario_scaling Processing time of synthesized scenarios over the number of update sensors and the
+/// out of order depth
+///
+class mars_e2e_scenario_scaling : public testing::Test
+{
+public:
+  struct RunResult
+  {
+    double duration;
+    int num_measurements;
+    int num_reworks;
+    double position_error;
+  };
+
+  ///
+  /// \brief Run Processes a scenario with 200Hz IMU and 'num_sensors' position sensors at 20Hz in arrival order
+  /// \param jitter Mean arrival delay of the position measurements [s]
+  ///
+  static RunResult Run(const int& num_sensors, const double& jitter)
+  {
+    mars::ScenarioConfig config;
+    config.duration_ = 10;
+    mars::ScenarioGenerator generator(config);
+
+    generator.AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 200, 0.01, 0.001));
+
+    // Only the processing load is of interest, the filter has no chi2 test
+    mars_test::ScenarioFilterConfig filter_config;
+    filter_config.position_meas_std_ = 0.02;
+    filter_config.calib_cov_ = 1e-6;
+    mars_test::ScenarioFilter filter(filter_config);
+    for (int k = 0; k < num_sensors; k++)
+    {
+      mars::ScenarioSensorConfig position =
+          mars_test::ScenarioSensor(mars::ScenarioSensorType::position, "position_" + std::to_string(k), 20, 0.02);
+      position.delay_jitter_ = jitter;
+      generator.AddSensor(position);
+      filter.AddPositionSensor(position.name_);
+    }
+    generator.Generate();
+
+    mars::CoreLogic& core_logic = *filter.core_logic_;
+    core_logic.buffer_.set_max_buffer_size(4000);
+
+    const std::vector<mars::BufferEntryType> entries = filter.get_entries(generator, true);
+
+    // The first IMU measurement arrives first, since the position measurements are delayed
+    filter.Start(generator, entries.front());
+
+    const double t_start = mars::Time::get_time_now().get_seconds();
+    for (size_t k = 1; k < entries.size(); k++)
+    {
+      core_logic.ProcessMeasurement(entries[k].sensor_handle_, entries[k].timestamp_, entries[k].data_);
+    }
+    const double t_end = mars::Time::get_time_now().get_seconds();
+
+    mars::BufferEntryType latest;
+    core_logic.buffer_.get_latest_state(&latest);
+    const mars::CoreStateType& estimate = static_cast<mars::CoreType*>(latest.data_.core_state_.get())->state_;
+    const mars::CoreStateType truth = generator.get_true_state(latest.timestamp_.get_seconds());
+
+    return { t_end - t_start, static_cast<int>(entries.size()),
+             static_cast<int>(core_logic.get_rework_stats().num_reworks_), (estimate.p_wi_ - truth.p_wi_).norm() };
+  }
+};
+
+TEST_F(mars_e2e_scenario_scaling, SENSOR_COUNT_AND_OOO_DEPTH)
+{
+  const std::vector<int> sensor_counts = { 1, 4, 8 };
+  const std::vector<double> jitters = { 0, 0.05, 0.2 };
+
+  std::vector<std::vector<RunResult>> results;
+  for (const auto& num_sensors : sensor_counts)
+  {
+    results.emplace_back();
+    for (const auto& jitter : jitters)
+    {
+      results.back().push_back(Run(num_sensors, jitter));
+    }
+  }
+
+  std::cout << "Sensors | Jitter [s] | Measurements | Reworks | Time [s] | Per measurement [us] | Position error [m]"
+            << std::endl;
+  for (size_t s = 0; s < sensor_counts.size(); s++)
+  {
+    for (size_t j = 0; j < jitters.size(); j++)
+    {
+      const RunResult& r = results[s][j];
+      std::cout << std::setw(7) << sensor_counts[s] << " | " << std::setw(10) << jitters[j] << " | " << std::setw(12)
+                << r.num_measurements << " | " << std::setw(7) << r.num_reworks << " | " << std::setw(8) << r.duration
+                << " | " << std::setw(20) << 1e6 * r.duration / r.num_measurements << " | " << r.position_error
+                << std::endl;
+
+      // Sanity bound, the filter is not tuned for the simultaneous updates of many sensors
+      EXPECT_LT(r.position_error, 0.2);
+      if (jitters[j] > 0)
+      {
+        EXPECT_GT(r.num_reworks, 0);
+      }
+      else
+      {
+        EXPECT_EQ(r.num_reworks, 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,146 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <mars/allocation_counter.h>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+// Counts the allocations of this executable with mars::AllocationCounter. With glibc, the C allocation functions are
+// interposed and forwarded to the glibc implementation. This covers operator new, Eigen and all other users of malloc.
+// Other C libraries fall back to replacing the global operator new, which misses direct calls to malloc.
+
+#ifdef __GLIBC__
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t num, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size)
+{
+  mars::AllocationCounter::Record();
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t num, size_t size)
+{
+  mars::AllocationCounter::Record();
+  return __libc_calloc(num, size);
+}
+
+void* realloc(void* ptr, size_t size)
+{
+  mars::AllocationCounter::Record();
+  return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size)
+{
+  mars::AllocationCounter::Record();
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size)
+{
+  mars::AllocationCounter::Record();
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size)
+{
+  mars::AllocationCounter::Record();
+  void* result = __libc_memalign(alignment, size);
+  if (result == nullptr)
+  {
+    return ENOMEM;
+  }
+  *ptr = result;
+  return 0;
+}
+
+void free(void* ptr)
+{
+  __libc_free(ptr);
+}
+}
+
+#else
+
+namespace
+{
+void* Allocate(std::size_t size)
+{
+  mars::AllocationCounter::Record();
+
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+  return Allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return Allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t& /*tag*/) noexcept
+{
+  mars::AllocationCounter::Record();
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& /*tag*/) noexcept
+{
+  mars::AllocationCounter::Record();
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t& /*tag*/) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t& /*tag*/) noexcept
+{
+  std::free(ptr);
+}
+
+#endif  // __GLIBC__
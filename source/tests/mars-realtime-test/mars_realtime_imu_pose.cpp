@@ -0,0 +1,277 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/allocation_counter.h>
+#include <mars/core_state.h>
+#include <mars/realtime_profile.h>
+#include <mars/data_utils/read_pose_data.h>
+#include <mars/data_utils/read_sim_data.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/type_definitions/buffer_entry_type.h>
+#include <yaml-cpp/yaml.h>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include "../include_local/test_data_settings.h"
+
+///
+/// \brief mars_realtime_imu_pose End to end test of the filter loop with the real-time profile
+///
+/// The profile changes the whole process, the test therefore runs in its own executable and restores the profile in
+/// TearDown. Allocations are counted through the malloc interposition of allocation_hook.cpp.
+///
+class mars_realtime_imu_pose : public testing::Test
+{
+public:
+  std::string test_data_path;
+  YAML::Node config;
+  std::string traj_file_name;
+  std::string pose_file_name;
+
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr;
+  std::shared_ptr<mars::CoreState> core_states_sptr;
+  mars::CoreLogic core_logic;
+
+  std::shared_ptr<mars::PoseSensorClass> pose_sensor_sptr;
+
+  std::vector<mars::BufferEntryType> measurement_data;
+
+  mars::RealtimeState previous_profile;
+
+  mars_realtime_imu_pose()
+  {
+    LoadInstancesAndParams();
+
+    measurement_data = LoadData();
+  }
+
+  void LoadInstancesAndParams()
+  {
+    test_data_path = std::string(MARS_LIB_TEST_DATA_PATH);
+
+    // get config
+    config = YAML::LoadFile(test_data_path + "parameter.yaml");
+
+    traj_file_name = config["traj_file_name"].as<std::string>();
+    std::cout << "Trajectory File: " << traj_file_name << std::endl;
+
+    pose_file_name = config["pose_file_name"].as<std::string>();
+    std::cout << "Pose File: " << pose_file_name << std::endl;
+
+    std::vector<double> imu_n_w;
+    std::vector<double> imu_n_bw;
+    std::vector<double> imu_n_a;
+    std::vector<double> imu_n_ba;
+
+    std::cout << "IMU Noise Parameter: " << std::endl;
+    read_yaml_vec_3(&imu_n_w, "imu_n_w", config);
+    read_yaml_vec_3(&imu_n_bw, "imu_n_bw", config);
+    read_yaml_vec_3(&imu_n_a, "imu_n_a", config);
+    read_yaml_vec_3(&imu_n_ba, "imu_n_ba", config);
+
+    // setup propagation sensor
+    imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+
+    // setup the core definition
+    core_states_sptr = std::make_shared<mars::CoreState>();
+    core_states_sptr.get()->set_propagation_sensor(imu_sensor_sptr);
+    core_states_sptr.get()->set_noise_std(Eigen::Vector3d(imu_n_w.data()), Eigen::Vector3d(imu_n_bw.data()),
+                                          Eigen::Vector3d(imu_n_a.data()), Eigen::Vector3d(imu_n_ba.data()));
+
+    core_logic = mars::CoreLogic(core_states_sptr);
+
+    // setup additional sensors
+    // Pose sensor
+    pose_sensor_sptr = std::make_shared<mars::PoseSensorClass>("Pose", core_states_sptr);
+    pose_sensor_sptr->const_ref_to_nav_ =
+        true;  // TODO is set here for now but will be managed by core logic in later versions
+
+    // Define measurement noise
+    Eigen::Matrix<double, 6, 1> pose_meas_std;
+    pose_meas_std << 0.02, 0.02, 0.02, 2 * (M_PI / 180), 2 * (M_PI / 180), 2 * (M_PI / 180);
+    pose_sensor_sptr->R_ = pose_meas_std.cwiseProduct(pose_meas_std);
+
+    // Define initial calibration and covariance
+    mars::PoseSensorData pose_init_cal;
+    pose_init_cal.state_.p_ip_ = Eigen::Vector3d::Zero();
+    pose_init_cal.state_.q_ip_ = Eigen::Quaterniond::Identity();
+
+    // The covariance should enclose the initialization with a 3 Sigma bound
+    Eigen::Matrix<double, 6, 1> std;
+    std << 0.1, 0.1, 0.1, (10 * M_PI / 180), (10 * M_PI / 180), (10 * M_PI / 180);
+    pose_init_cal.sensor_cov_ = std.cwiseProduct(std).asDiagonal();
+
+    pose_sensor_sptr->set_initial_calib(std::make_shared<mars::PoseSensorData>(pose_init_cal));
+  }
+
+  std::vector<mars::BufferEntryType> LoadData()
+  {
+    std::vector<mars::BufferEntryType> measurement_data;
+
+    std::vector<mars::BufferEntryType> measurement_data_imu;
+    mars::ReadSimData(&measurement_data_imu, imu_sensor_sptr, test_data_path + traj_file_name);
+
+    std::vector<mars::BufferEntryType> measurement_data_pose;
+    mars::ReadPoseData(&measurement_data_pose, pose_sensor_sptr, test_data_path + pose_file_name, 1e-13);
+
+    measurement_data.insert(measurement_data.end(), measurement_data_imu.begin(), measurement_data_imu.end());
+    measurement_data.insert(measurement_data.end(), measurement_data_pose.begin(), measurement_data_pose.end());
+
+    std::sort(measurement_data.begin(), measurement_data.end());
+
+    return measurement_data;
+  }
+
+  bool read_yaml_vec_3(std::vector<double>* value, const std::string& parameter, YAML::Node config)
+  {
+    if (config[parameter])
+    {
+      *value = config[parameter].as<std::vector<double>>();
+
+      std::cout << parameter << ": \t [";
+      for (auto const& i : *value)
+        std::cout << i << " ";
+
+      std::cout << " ]" << std::endl;
+      return true;
+    }
+    return false;
+  }
+
+  ///
+  /// \brief InitializeFilter Processes measurements individually until the core is initialized
+  /// \return Index of the first measurement after the initialization
+  ///
+  size_t InitializeFilter()
+  {
+    size_t k = 0;
+    for (; k < measurement_data.size() && !core_logic.core_is_initialized_; k++)
+    {
+      const mars::BufferEntryType& entry = measurement_data[k];
+      core_logic.ProcessMeasurement(entry.sensor_handle_, entry.timestamp_, entry.data_);
+
+      // Initialize the first time at which the propagation sensor occures
+      if (entry.sensor_handle_ == core_logic.core_states_->propagation_sensor_)
+      {
+        core_logic.Initialize(Eigen::Vector3d(0, 0, 5), Eigen::Quaterniond::Identity());
+      }
+    }
+    return k;
+  }
+
+  void TearDown() override
+  {
+    mars::RealtimeProfile::Restore(previous_profile);
+  }
+
+  void Reset()
+  {
+    core_logic.core_is_initialized_ = false;
+    core_logic.buffer_.ResetBufferData();
+    pose_sensor_sptr->is_initialized_ = false;
+  }
+};
+
+TEST_F(mars_realtime_imu_pose, REALTIME_JITTER)
+{
+  core_logic.verbose_ = false;
+
+  // Lock the memory of the process and touch the heap which is required for the buffer. Locking may fail without
+  // privileges (RLIMIT_MEMLOCK), the heap reserve is still mapped and kept.
+  mars::RealtimeConfig config;
+  config.heap_reserve_bytes_ = mars::RealtimeProfile::EstimateHeapBytes(core_logic.buffer_.get_max_buffer_size(), 21);
+  config.cpu_ = 0;
+  const bool profile_applied = mars::RealtimeProfile::Apply(config, &previous_profile);
+  std::cout << "Real-time profile applied: " << profile_applied << std::endl;
+
+  // Warm up until the buffer is full and the allocator reuses freed blocks
+  size_t k = InitializeFilter();
+  const size_t k_warm = std::min(measurement_data.size(), k + 4 * core_logic.buffer_.get_max_buffer_size());
+  for (; k < k_warm; k++)
+  {
+    core_logic.ProcessMeasurement(measurement_data[k].sensor_handle_, measurement_data[k].timestamp_,
+                                  measurement_data[k].data_);
+  }
+
+  // Cyclictest style measurement of the processing latency of each measurement
+  const size_t num_samples = std::min(measurement_data.size() - k, size_t(40000));
+  std::vector<double> latency_imu;
+  std::vector<double> latency_update;
+  std::vector<long> allocations_imu;
+  std::vector<long> allocations_update;
+  latency_imu.reserve(num_samples);
+  latency_update.reserve(num_samples);
+  allocations_imu.reserve(num_samples);
+  allocations_update.reserve(num_samples);
+
+  const mars::RealtimeStats stats_start = mars::RealtimeProfile::get_thread_stats();
+
+  for (const size_t k_end = k + num_samples; k < k_end; k++)
+  {
+    const mars::BufferEntryType& entry = measurement_data[k];
+    const bool is_imu = entry.sensor_handle_ == imu_sensor_sptr;
+
+    mars::AllocationCounter::Start();
+    const auto t_start = std::chrono::steady_clock::now();
+    core_logic.ProcessMeasurement(entry.sensor_handle_, entry.timestamp_, entry.data_);
+    const auto t_end = std::chrono::steady_clock::now();
+    const long num_allocations = mars::AllocationCounter::Stop();
+
+    const double latency = std::chrono::duration<double, std::micro>(t_end - t_start).count();
+    (is_imu ? latency_imu : latency_update).push_back(latency);
+    (is_imu ? allocations_imu : allocations_update).push_back(num_allocations);
+  }
+
+  const mars::RealtimeStats stats_end = mars::RealtimeProfile::get_thread_stats();
+
+  auto print_latency = [](const std::string& name, std::vector<double> latency, const std::vector<long>& allocations) {
+    std::sort(latency.begin(), latency.end());
+    auto percentile = [&latency](const double& p) { return latency[size_t(p * double(latency.size() - 1))]; };
+    std::cout << name << " samples: " << latency.size() << " latency [us] min: " << latency.front()
+              << " p50: " << percentile(0.5) << " p99: " << percentile(0.99) << " p99.9: " << percentile(0.999)
+              << " max: " << latency.back() << ", allocations per measurement min: "
+              << *std::min_element(allocations.begin(), allocations.end())
+              << " max: " << *std::max_element(allocations.begin(), allocations.end()) << std::endl;
+  };
+
+  ASSERT_FALSE(latency_imu.empty());
+  ASSERT_FALSE(latency_update.empty());
+  print_latency("IMU", latency_imu, allocations_imu);
+  print_latency("Pose", latency_update, allocations_update);
+
+  const long minor_faults = stats_end.minor_faults_ - stats_start.minor_faults_;
+  const long major_faults = stats_end.major_faults_ - stats_start.major_faults_;
+  const long voluntary_switches = stats_end.voluntary_switches_ - stats_start.voluntary_switches_;
+  std::cout << "Page faults minor: " << minor_faults << " major: " << major_faults
+            << ", voluntary context switches: " << voluntary_switches << std::endl;
+
+  // Minor faults and context switches depend on the system load and the kernel, they are reported only. Major faults
+  // require I/O, which is excluded once the memory is locked.
+  if (profile_applied)
+  {
+    EXPECT_EQ(major_faults, 0);
+  }
+
+  if (!mars::AllocationCounter::IsHooked())
+  {
+    std::cout << "Allocations are not counted, the allocation hook is not installed" << std::endl;
+    return;
+  }
+
+  // The buffer, the state pools and the update workspaces are sized during the warm up, neither the propagation nor
+  // the pose update allocates afterwards
+  EXPECT_EQ(*std::max_element(allocations_imu.begin(), allocations_imu.end()), 0);
+  EXPECT_EQ(*std::max_element(allocations_update.begin(), allocations_update.end()), 0);
+}
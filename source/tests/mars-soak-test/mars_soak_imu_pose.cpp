@@ -0,0 +1,218 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/scenario_generator.h>
+#include <mars/paced_replayer.h>
+#include <mars/realtime_profile.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+///
+/// \brief mars_soak_imu_pose Long-duration run of a 200Hz IMU and 20Hz pose filter
+///
+/// One lap of the synthetic scenario is generated and replayed repeatedly with timestamps shifted by the lap duration.
+/// The default trajectory frequencies are multiples of 0.01Hz, a lap of 100s therefore ends where it started. Memory
+/// usage and the processing latency are sampled for each window of simulated time. After the warm-up, in which the
+/// buffer fills up, the heap and the resident set must not grow and the median processing latency must not drift.
+///
+/// The run is configured with environment variables:
+/// - MARS_SOAK_DURATION: Simulated duration [s], default 3600
+/// - MARS_SOAK_WINDOW: Simulated duration of one sample window [s], default 60
+/// - MARS_SOAK_MAX_HEAP_GROWTH: Max growth of the heap in use after the warm-up [byte], default 1 MiB
+/// - MARS_SOAK_MAX_RSS_GROWTH: Max growth of the resident set after the warm-up [byte], default 16 MiB
+/// - MARS_SOAK_MAX_LATENCY_DRIFT: Max ratio of the median latency of the last and first third of the windows,
+///   default 2
+///
+class mars_soak_imu_pose : public testing::Test
+{
+public:
+  struct Window
+  {
+    double end_time_{ 0 };  ///< Simulated time [s]
+    mars::LatencyStats processing_;
+    mars::MemoryStats memory_;
+    int buffer_length_{ 0 };
+    double rms_position_{ 0 };  ///< [m]
+  };
+
+  static double get_setting(const char* name, const double& default_value)
+  {
+    const char* value = std::getenv(name);
+    return value != nullptr ? std::atof(value) : default_value;
+  }
+
+  static double median(std::vector<double> values)
+  {
+    std::sort(values.begin(), values.end());
+    return values.empty() ? 0 : values[values.size() / 2];
+  }
+
+  static void PrintWindow(const Window& window)
+  {
+    std::stringstream row;
+    row << std::fixed << std::setprecision(0) << std::setw(8) << window.end_time_ << std::setprecision(1)
+        << std::setw(10) << 1e6 * window.processing_.p50_ << std::setw(10) << 1e6 * window.processing_.p90_
+        << std::setw(10) << 1e6 * window.processing_.p99_ << std::setw(10) << 1e6 * window.processing_.max_
+        << std::setw(12) << window.memory_.rss_bytes_ / 1024 << std::setw(12)
+        << window.memory_.heap_in_use_bytes_ / 1024 << std::setw(12) << window.memory_.heap_free_bytes_ / 1024
+        << std::setw(8) << window.buffer_length_ << std::setprecision(4) << std::setw(10) << window.rms_position_;
+    std::cout << row.str() << std::endl;
+  }
+};
+
+TEST_F(mars_soak_imu_pose, MEMORY_AND_LATENCY)
+{
+  const double duration = get_setting("MARS_SOAK_DURATION", 3600);
+  const double window_duration = get_setting("MARS_SOAK_WINDOW", 60);
+  const double max_heap_growth = get_setting("MARS_SOAK_MAX_HEAP_GROWTH", 1 << 20);
+  const double max_rss_growth = get_setting("MARS_SOAK_MAX_RSS_GROWTH", 16 << 20);
+  const double max_latency_drift = get_setting("MARS_SOAK_MAX_LATENCY_DRIFT", 2);
+  const int num_warmup_windows = 2;
+
+  constexpr double kLapDuration = 100;
+  mars::ScenarioConfig config;
+  config.duration_ = kLapDuration;
+  mars::ScenarioGenerator generator(config);
+
+  generator.AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 200, 0.05, 0.005));
+  generator.AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::pose, "pose", 20, 0.02, 0.01));
+  generator.Generate();
+
+  mars_test::ScenarioFilterConfig filter_config;
+  filter_config.imu_n_w_ = Eigen::Vector3d::Ones() * 0.005;
+  filter_config.imu_n_a_ = Eigen::Vector3d::Ones() * 0.05;
+  filter_config.position_meas_std_ = 0.02;
+  filter_config.orientation_meas_std_ = 0.01;
+  filter_config.calib_cov_ = 1e-6;
+  mars_test::ScenarioFilter filter(filter_config);
+  const std::shared_ptr<mars::PoseSensorClass> pose_sensor_sptr = filter.AddPoseSensor("pose");
+  mars::CoreLogic& core_logic = *filter.core_logic_;
+
+  // The last sample of a lap coincides with the first sample of the next lap
+  std::vector<mars::BufferEntryType> lap = filter.get_entries(generator);
+  lap.erase(std::remove_if(lap.begin(), lap.end(),
+                           [](const mars::BufferEntryType& k) {
+                             return k.timestamp_.get_seconds() >= kLapDuration - 1e-9;
+                           }),
+            lap.end());
+  ASSERT_FALSE(lap.empty());
+
+  filter.Start(generator, lap.front());
+
+  std::vector<Window> windows;
+  std::vector<double> processing;
+  double sum_position = 0;
+  int num_pose = 0;
+  double window_end = window_duration;
+
+  std::cout << std::setw(8) << "t [s]" << std::setw(10) << "p50 [us]" << std::setw(10) << "p90 [us]" << std::setw(10)
+            << "p99 [us]" << std::setw(10) << "max [us]" << std::setw(12) << "rss [KiB]" << std::setw(12)
+            << "heap [KiB]" << std::setw(12) << "free [KiB]" << std::setw(8) << "buffer" << std::setw(10)
+            << "rms p [m]" << std::endl;
+
+  const int num_laps = static_cast<int>(std::ceil(duration / kLapDuration));
+  for (int l = 0; l < num_laps; l++)
+  {
+    const double offset = l * kLapDuration;
+    for (size_t k = (l == 0 ? 1 : 0); k < lap.size(); k++)
+    {
+      const double t = offset + lap[k].timestamp_.get_seconds();
+      if (t > duration)
+      {
+        break;
+      }
+
+      if (t >= window_end)
+      {
+        Window window;
+        window.end_time_ = window_end;
+        window.processing_ = mars::PacedReplayer::ComputeStats(processing, 1);
+        window.memory_ = mars::RealtimeProfile::get_memory_stats();
+        window.buffer_length_ = core_logic.buffer_.get_length();
+        window.rms_position_ = num_pose > 0 ? std::sqrt(sum_position / num_pose) : 0;
+        PrintWindow(window);
+        windows.push_back(window);
+
+        processing.clear();
+        sum_position = 0;
+        num_pose = 0;
+        window_end += window_duration;
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      core_logic.ProcessMeasurement(lap[k].sensor_handle_, t, lap[k].data_);
+      processing.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+      if (lap[k].sensor_handle_ == pose_sensor_sptr)
+      {
+        mars::BufferEntryType latest;
+        core_logic.buffer_.get_latest_state(&latest);
+        const mars::CoreType* core = static_cast<mars::CoreType*>(latest.data_.core_state_.get());
+        sum_position += (core->state_.p_wi_ - generator.get_true_state(lap[k].timestamp_.get_seconds()).p_wi_)
+                            .squaredNorm();
+        num_pose++;
+      }
+    }
+  }
+
+  ASSERT_GT(static_cast<int>(windows.size()), num_warmup_windows + 2)
+      << "MARS_SOAK_DURATION covers too few windows of MARS_SOAK_WINDOW";
+
+  const Window& reference = windows[num_warmup_windows];
+  const Window& last = windows.back();
+
+  // Memory: all allocations of the steady state are returned
+  const double heap_growth = static_cast<double>(last.memory_.heap_in_use_bytes_) -
+                             static_cast<double>(reference.memory_.heap_in_use_bytes_);
+  const double rss_growth =
+      static_cast<double>(last.memory_.rss_bytes_) - static_cast<double>(reference.memory_.rss_bytes_);
+  std::cout << "Heap growth: " << heap_growth / 1024 << "KiB, RSS growth: " << rss_growth / 1024 << "KiB"
+            << std::endl;
+  EXPECT_LE(heap_growth, max_heap_growth);
+  EXPECT_LE(rss_growth, max_rss_growth);
+
+  // Latency: median of the window medians, first versus last third of the steady state
+  const int num_steady = static_cast<int>(windows.size()) - num_warmup_windows;
+  const int num_third = std::max(1, num_steady / 3);
+  std::vector<double> first_p50;
+  std::vector<double> last_p50;
+  for (int k = 0; k < num_third; k++)
+  {
+    first_p50.push_back(windows[num_warmup_windows + k].processing_.p50_);
+    last_p50.push_back(windows[windows.size() - 1 - k].processing_.p50_);
+  }
+  const double latency_drift = median(last_p50) / median(first_p50);
+  std::cout << "Latency drift (p50): " << latency_drift << std::endl;
+  EXPECT_LE(latency_drift, max_latency_drift);
+
+  // The filter stays consistent and the buffer bounded, the latest entry of each sensor is kept beyond the max size
+  for (const auto& k : windows)
+  {
+    EXPECT_LE(k.buffer_length_, core_logic.buffer_.get_max_buffer_size() + 2);
+    EXPECT_LT(k.rms_position_, 0.1);
+  }
+  EXPECT_EQ(core_logic.buffer_prior_core_init_.get_length(), 1);
+}
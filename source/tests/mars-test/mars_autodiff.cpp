@@ -0,0 +1,198 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_state.h>
+#include <mars/general_functions/utils.h>
+#include <mars/general_functions/error_state_jacobian.h>
+#include <mars/general_functions/jet.h>
+#include <mars/sensors/pose/pose_measurement_model.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/type_definitions/buffer_data_type.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+class mars_autodiff_test : public testing::Test
+{
+public:
+  static mars::CoreStateType random_core_state()
+  {
+    mars::CoreStateType state;
+    state.p_wi_ = Eigen::Vector3d::Random();
+    state.v_wi_ = Eigen::Vector3d::Random();
+    state.q_wi_ = Eigen::Quaterniond(Eigen::Vector4d::Random()).normalized();
+    state.b_w_ = 0.1 * Eigen::Vector3d::Random();
+    state.b_a_ = 0.1 * Eigen::Vector3d::Random();
+    return state;
+  }
+
+  static mars::PoseSensorStateType random_sensor_state()
+  {
+    mars::PoseSensorStateType state;
+    state.p_ip_ = Eigen::Vector3d::Random();
+    state.q_ip_ = Eigen::Quaterniond(Eigen::Vector4d::Random()).normalized();
+    return state;
+  }
+};
+
+TEST_F(mars_autodiff_test, JET_DERIVATIVES)
+{
+  using Jet = mars::Jet<2>;
+
+  // f(x, y) = sin(x) * sqrt(y) / (x + y) + atan2(y, x)
+  auto f = [](const auto& x, const auto& y) {
+    using std::atan2;
+    using std::sin;
+    using std::sqrt;
+    return sin(x) * sqrt(y) / (x + y) + atan2(y, x);
+  };
+
+  const double x = 0.7;
+  const double y = 1.3;
+  const Jet result = f(Jet(x, 0), Jet(y, 1));
+
+  const double h = 1e-6;
+  const double dfdx = (f(x + h, y) - f(x - h, y)) / (2 * h);
+  const double dfdy = (f(x, y + h) - f(x, y - h)) / (2 * h);
+
+  EXPECT_DOUBLE_EQ(result.a, f(x, y));
+  EXPECT_NEAR(result.v(0), dfdx, 1e-8);
+  EXPECT_NEAR(result.v(1), dfdy, 1e-8);
+
+  // Eigen expressions with Jet scalars
+  Eigen::Matrix<Jet, 3, 1> vec(Jet(1, 0), Jet(2, 1), Jet(3));
+  const Jet norm = vec.norm();
+  EXPECT_DOUBLE_EQ(norm.a, std::sqrt(14.0));
+  EXPECT_DOUBLE_EQ(norm.v(0), 1 / std::sqrt(14.0));
+  EXPECT_DOUBLE_EQ(norm.v(1), 2 / std::sqrt(14.0));
+}
+
+TEST_F(mars_autodiff_test, POSE_JACOBIAN_MATCHES_HAND_WRITTEN)
+{
+  std::srand(42);
+
+  mars::CoreState core_states;
+  std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>(core_states);
+  mars::PoseSensorClass pose_sensor("Pose", core_states_sptr);
+
+  for (int k = 0; k < 100; k++)
+  {
+    const mars::CoreStateType core_state = random_core_state();
+    const mars::PoseSensorStateType sensor_state = random_sensor_state();
+
+    const Eigen::MatrixXd H_hand = pose_sensor.CalcJacobian(core_state, sensor_state);
+    const Eigen::MatrixXd H_auto = pose_sensor.CalcJacobianAutodiff(core_state, sensor_state);
+
+    ASSERT_EQ(H_hand.rows(), H_auto.rows());
+    ASSERT_EQ(H_hand.cols(), H_auto.cols());
+    EXPECT_TRUE(H_hand.isApprox(H_auto, 1e-12)) << "Hand:\n" << H_hand << "\nAutodiff:\n" << H_auto;
+  }
+
+  // The prediction of the model is the measurement function
+  const mars::CoreStateType core_state = random_core_state();
+  const mars::PoseSensorStateType sensor_state = random_sensor_state();
+
+  mars::PoseMeasurementJacobian::Measurement prediction;
+  mars::PoseMeasurementJacobian::Jacobian H;
+  mars::PoseMeasurementJacobian::Evaluate(core_state, sensor_state, &prediction, &H);
+
+  const Eigen::Vector3d p_est = core_state.p_wi_ + core_state.q_wi_.toRotationMatrix() * sensor_state.p_ip_;
+  EXPECT_TRUE(prediction.head<3>().isApprox(p_est, 1e-12));
+  EXPECT_TRUE(prediction.tail<3>().isZero(1e-12));
+}
+
+TEST_F(mars_autodiff_test, POSE_UPDATE_AUTODIFF)
+{
+  std::srand(7);
+
+  mars::CoreState core_states;
+  std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>(core_states);
+  mars::PoseSensorClass pose_sensor("Pose", core_states_sptr);
+  pose_sensor.chi2_.do_test_ = false;
+  pose_sensor.R_ = Eigen::Matrix<double, 6, 1>::Constant(0.01);
+
+  const mars::CoreStateType prior_core_state = random_core_state();
+
+  std::shared_ptr<mars::PoseSensorData> prior_sensor_data = std::make_shared<mars::PoseSensorData>();
+  prior_sensor_data->state_ = random_sensor_state();
+
+  const int size = mars::CoreStateType::size_error_ + prior_sensor_data->state_.cov_size_;
+  Eigen::MatrixXd prior_cov = 0.01 * Eigen::MatrixXd::Identity(size, size);
+
+  // Measurement close to the prediction
+  const mars::PoseSensorStateType& prior_sensor_state = prior_sensor_data->state_;
+  const Eigen::Vector3d position = prior_core_state.p_wi_ +
+                                   prior_core_state.q_wi_.toRotationMatrix() * prior_sensor_state.p_ip_ +
+                                   0.05 * Eigen::Vector3d::Random();
+  const Eigen::Quaterniond orientation = mars::Utils::ApplySmallAngleQuatCorr(
+      prior_core_state.q_wi_ * prior_sensor_state.q_ip_, 0.05 * Eigen::Vector3d::Random());
+  std::shared_ptr<mars::PoseMeasurementType> measurement =
+      std::make_shared<mars::PoseMeasurementType>(position, orientation);
+
+  mars::BufferDataType result_hand;
+  pose_sensor.use_autodiff_jacobian_ = false;
+  ASSERT_TRUE(pose_sensor.CalcUpdate(1, measurement, prior_core_state, prior_sensor_data, prior_cov, &result_hand));
+
+  mars::BufferDataType result_auto;
+  pose_sensor.use_autodiff_jacobian_ = true;
+  ASSERT_TRUE(pose_sensor.CalcUpdate(1, measurement, prior_core_state, prior_sensor_data, prior_cov, &result_auto));
+
+  const mars::CoreType core_hand = *static_cast<mars::CoreType*>(result_hand.core_state_.get());
+  const mars::CoreType core_auto = *static_cast<mars::CoreType*>(result_auto.core_state_.get());
+  EXPECT_TRUE(core_hand.state_.p_wi_.isApprox(core_auto.state_.p_wi_, 1e-10));
+  EXPECT_TRUE(core_hand.state_.q_wi_.coeffs().isApprox(core_auto.state_.q_wi_.coeffs(), 1e-10));
+  EXPECT_TRUE(core_hand.cov_.isApprox(core_auto.cov_, 1e-10));
+
+  const mars::PoseSensorData sensor_hand = *static_cast<mars::PoseSensorData*>(result_hand.sensor_state_.get());
+  const mars::PoseSensorData sensor_auto = *static_cast<mars::PoseSensorData*>(result_auto.sensor_state_.get());
+  EXPECT_TRUE(sensor_hand.state_.p_ip_.isApprox(sensor_auto.state_.p_ip_, 1e-10));
+  EXPECT_TRUE(sensor_hand.get_full_cov().isApprox(sensor_auto.get_full_cov(), 1e-10));
+}
+
+TEST_F(mars_autodiff_test, POSE_JACOBIAN_PERFORMANCE)
+{
+  std::srand(3);
+
+  mars::CoreState core_states;
+  std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>(core_states);
+  mars::PoseSensorClass pose_sensor("Pose", core_states_sptr);
+
+  const mars::CoreStateType core_state = random_core_state();
+  const mars::PoseSensorStateType sensor_state = random_sensor_state();
+  const int num_iterations = 2000;
+
+  double checksum_hand = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int k = 0; k < num_iterations; k++)
+  {
+    checksum_hand += pose_sensor.CalcJacobian(core_state, sensor_state)(0, 0);
+  }
+  const double time_hand = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+  double checksum_auto = 0;
+  start = std::chrono::high_resolution_clock::now();
+  for (int k = 0; k < num_iterations; k++)
+  {
+    mars::PoseMeasurementJacobian::Jacobian H;
+    mars::PoseMeasurementJacobian::Evaluate(core_state, sensor_state, nullptr, &H);
+    checksum_auto += H(0, 0);
+  }
+  const double time_auto = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+  std::cout << "Pose jacobian, hand written: " << time_hand / num_iterations * 1e6
+            << " us, autodiff: " << time_auto / num_iterations * 1e6 << " us" << std::endl;
+
+  EXPECT_DOUBLE_EQ(checksum_hand, checksum_auto);
+}
@@ -20,6 +20,7 @@
 #include <mars/time.h>
 #include <mars/type_definitions/buffer_entry_type.h>
 #include <Eigen/Dense>
+#include <vector>
 
 class mars_buffer_test : public testing::Test
 {
@@ -220,6 +221,47 @@ TEST_F(mars_buffer_test, STORAGE_MAX_ENTRY)
   ASSERT_EQ(t3_idx1.timestamp_, 11);
 }
 
+///
+/// \brief Ensure that one call removes all overflowing entries, also if they are adjacent
+///
+/// Previously, the entry after each removed entry was skipped, which removed every other entry instead of the oldest.
+///
+TEST_F(mars_buffer_test, REMOVE_OVERFLOW_ENTRIES_IN_ONE_CALL)
+{
+  const int max_buffer_size = 5;
+  mars::Buffer buffer(max_buffer_size);
+
+  std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>();
+  std::shared_ptr<mars::PoseSensorClass> pose_sensor_1_sptr =
+      std::make_shared<mars::PoseSensorClass>("Pose_1", core_states_sptr);
+  std::shared_ptr<mars::PoseSensorClass> pose_sensor_2_sptr =
+      std::make_shared<mars::PoseSensorClass>("Pose_2", core_states_sptr);
+
+  // The oldest entry is the only state of sensor 2 and is kept
+  buffer.AddEntrySorted(mars::BufferEntryType(mars::Time(0), data_with_state_, pose_sensor_2_sptr));
+  for (int k = 1; k < 12; k++)
+  {
+    buffer.AddEntrySorted(mars::BufferEntryType(mars::Time(k), data_with_state_, pose_sensor_1_sptr));
+  }
+  ASSERT_EQ(buffer.get_length(), 12);
+
+  buffer.RemoveOverflowEntrys();
+  ASSERT_EQ(buffer.get_length(), max_buffer_size);
+
+  std::vector<double> timestamps;
+  for (int k = 0; k < buffer.get_length(); k++)
+  {
+    mars::BufferEntryType entry;
+    buffer.get_entry_at_idx(k, &entry);
+    timestamps.push_back(entry.timestamp_.get_seconds());
+  }
+  EXPECT_THAT(timestamps, testing::ElementsAre(0, 8, 9, 10, 11));
+
+  // No overflow
+  EXPECT_EQ(buffer.RemoveOverflowEntrys(), -1);
+  EXPECT_EQ(buffer.get_length(), max_buffer_size);
+}
+
 TEST_F(mars_buffer_test, LATEST_ENTRY)
 {
   const int num_test_entrys = 10;
@@ -935,11 +977,120 @@ TEST_F(mars_buffer_test, REMOVE_SENSOR_FROM_BUFFER)
   EXPECT_TRUE(buffer.get_latest_sensor_handle_measurement(pose_sensor_2_sptr, &data_sink));
 }
 
+TEST_F(mars_buffer_test, REMOVE_SENSOR_ENTRIES_IN_RANGE)
+{
+  mars::Buffer buffer(100);
+
+  std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>();
+  std::shared_ptr<mars::PoseSensorClass> pose_sensor_1_sptr =
+      std::make_shared<mars::PoseSensorClass>("Pose_1", core_states_sptr);
+  std::shared_ptr<mars::PoseSensorClass> pose_sensor_2_sptr =
+      std::make_shared<mars::PoseSensorClass>("Pose_2", core_states_sptr);
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+
+  // Entries at t = 0..29, the sensors alternate
+  const std::vector<std::shared_ptr<mars::SensorAbsClass>> sensors = { imu_sensor_sptr, pose_sensor_1_sptr,
+                                                                       pose_sensor_2_sptr };
+  for (int k = 0; k < 30; k++)
+  {
+    buffer.AddEntrySorted(mars::BufferEntryType(mars::Time(k), data_with_state_, sensors[k % 3]));
+  }
+
+  EXPECT_EQ(buffer.LowerBoundIdx(mars::Time(-1)), 0);
+  EXPECT_EQ(buffer.LowerBoundIdx(mars::Time(10)), 10);
+  EXPECT_EQ(buffer.LowerBoundIdx(mars::Time(10.5)), 11);
+  EXPECT_EQ(buffer.LowerBoundIdx(mars::Time(30)), 30);
+
+  // Only the range [3, 12) is modified, it contains t = 4, 5, 7, 8, 10, 11 of the pose sensors
+  EXPECT_EQ(buffer.RemoveSensorEntries({ pose_sensor_1_sptr, pose_sensor_2_sptr }, 3, 12), 6);
+  EXPECT_EQ(buffer.get_length(), 24);
+  EXPECT_TRUE(buffer.IsSorted());
+
+  mars::BufferEntryType entry;
+  buffer.get_entry_at_idx(2, &entry);
+  EXPECT_EQ(entry.timestamp_, mars::Time(2));
+  buffer.get_entry_at_idx(3, &entry);
+  EXPECT_EQ(entry.timestamp_, mars::Time(3));
+  buffer.get_entry_at_idx(4, &entry);
+  EXPECT_EQ(entry.timestamp_, mars::Time(6));
+  buffer.get_entry_at_idx(6, &entry);
+  EXPECT_EQ(entry.timestamp_, mars::Time(12));
+  EXPECT_EQ(entry.sensor_handle_, imu_sensor_sptr);
+
+  // The search containers stay in sync with the entries
+  EXPECT_EQ(buffer.LowerBoundIdx(mars::Time(12)), 6);
+  EXPECT_TRUE(buffer.get_latest_sensor_handle_measurement(pose_sensor_1_sptr, &entry));
+  EXPECT_EQ(entry.timestamp_, mars::Time(28));
+
+  // Ranges exceeding the buffer are clipped
+  EXPECT_EQ(buffer.RemoveSensorEntries({ imu_sensor_sptr }, -5, 100), 10);
+  EXPECT_EQ(buffer.get_length(), 14);
+  EXPECT_EQ(buffer.RemoveSensorEntries({ imu_sensor_sptr }, 0, 100), 0);
+}
+
 ///
 /// \brief Tests if getting all measurements from a single sensor from buffer works.
 ///
 /// \author Martin Scheiber <martin.scheiber@ieee.org>
 ///
+///
+/// \brief Ensure that a rework segment contains the states a rework reads and is spliced back in place
+///
+TEST_F(mars_buffer_test, REWORK_SEGMENT)
+{
+  mars::Buffer buffer(100);
+
+  std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>();
+  std::shared_ptr<mars::PoseSensorClass> pose_sensor_1_sptr =
+      std::make_shared<mars::PoseSensorClass>("Pose_1", core_states_sptr);
+  std::shared_ptr<mars::PoseSensorClass> pose_sensor_2_sptr =
+      std::make_shared<mars::PoseSensorClass>("Pose_2", core_states_sptr);
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+
+  // IMU states at t = 0..29, pose 1 at t = 5.5 and 20.5, pose 2 at t = 10.5 and 25.5 (measurement only)
+  for (int k = 0; k < 30; k++)
+  {
+    buffer.AddEntrySorted(mars::BufferEntryType(k, data_with_state_, imu_sensor_sptr));
+  }
+  buffer.AddEntrySorted(mars::BufferEntryType(5.5, data_with_state_, pose_sensor_1_sptr));
+  buffer.AddEntrySorted(mars::BufferEntryType(20.5, data_with_state_, pose_sensor_1_sptr));
+  buffer.AddEntrySorted(mars::BufferEntryType(10.5, data_with_state_, pose_sensor_2_sptr));
+  buffer.AddEntrySorted(mars::BufferEntryType(25.5, data_no_state_, pose_sensor_2_sptr));
+
+  mars::BufferEntryType entry;
+  const int idx_21 = buffer.LowerBoundIdx(21);
+  const int idx_27 = buffer.LowerBoundIdx(27);
+
+  // Only IMU entries after the rework index, the segment starts at the latest state
+  EXPECT_EQ(buffer.get_rework_segment_start_idx(idx_27, imu_sensor_sptr), idx_27 - 1);
+
+  // Pose 2 is reworked, its latest state before the rework index is at t = 10.5
+  const int start_idx = buffer.get_rework_segment_start_idx(idx_21, imu_sensor_sptr);
+  buffer.get_entry_at_idx(start_idx, &entry);
+  EXPECT_EQ(entry.timestamp_, mars::Time(10.5));
+  EXPECT_EQ(buffer.get_rework_segment_start_idx(0, imu_sensor_sptr), 0);
+
+  mars::Buffer segment;
+  segment.CopyEntriesStartingAtIdx(buffer, start_idx);
+  EXPECT_EQ(segment.get_length(), buffer.get_length() - start_idx);
+  EXPECT_EQ(segment.get_max_buffer_size(), 100);
+
+  // Changes of the segment replace the entries of the buffer
+  segment.ClearStatesStartingAtIdx(idx_21 - start_idx);
+  segment.AddEntrySorted(mars::BufferEntryType(21.5, data_no_state_, pose_sensor_1_sptr));
+  const int length = buffer.get_length();
+  buffer.SpliceEntriesStartingAtIdx(start_idx, &segment);
+
+  EXPECT_TRUE(segment.IsEmpty());
+  EXPECT_EQ(buffer.get_length(), length + 1);
+  EXPECT_TRUE(buffer.IsSorted());
+  buffer.get_latest_state(&entry);
+  EXPECT_EQ(entry.timestamp_, mars::Time(20.5));
+  buffer.get_entry_at_idx(start_idx, &entry);
+  EXPECT_EQ(entry.timestamp_, mars::Time(10.5));
+  EXPECT_TRUE(entry.HasStates());
+}
+
 TEST_F(mars_buffer_test, GET_SENSOR_MEASUREMENTS)
 {
   // const int max_buffer_size = 20;
@@ -1389,3 +1540,104 @@ TEST_F(mars_buffer_test, OVERWRITE_ENTRY_AT_INDEX)
 {
   // TODO
 }
+
+///
+/// \brief Ensure that the search routines stay consistent with the buffer entries after random modifications
+///
+TEST_F(mars_buffer_test, SEARCH_AFTER_RANDOM_MODIFICATIONS)
+{
+  std::srand(11);
+
+  mars::Buffer buffer(60);
+  std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>();
+  std::vector<std::shared_ptr<mars::SensorAbsClass>> sensors = {
+    std::make_shared<mars::ImuSensorClass>("IMU"), std::make_shared<mars::PoseSensorClass>("Pose", core_states_sptr),
+    std::make_shared<mars::PositionSensorClass>("Position", core_states_sptr)
+  };
+
+  const std::vector<int> metadata = { mars::BufferMetadataType::none, mars::BufferMetadataType::init,
+                                      mars::BufferMetadataType::out_of_order, mars::BufferMetadataType::auto_add };
+
+  for (int k = 0; k < 2000; k++)
+  {
+    const int operation = std::rand() % 10;
+    const std::shared_ptr<mars::SensorAbsClass>& sensor = sensors[std::rand() % sensors.size()];
+    const mars::BufferDataType& data = (std::rand() % 2) ? data_with_state_ : data_no_state_;
+    const mars::BufferEntryType entry(0.01 * (std::rand() % 1000), data, sensor, metadata[std::rand() % 4]);
+
+    if (operation < 6)
+    {
+      buffer.AddEntrySorted(entry);
+      buffer.RemoveOverflowEntrys();
+    }
+    else if (operation == 6 && buffer.get_length() > 0)
+    {
+      // Overwrite with the same timestamp to keep the buffer sorted
+      const int idx = std::rand() % buffer.get_length();
+      mars::BufferEntryType current_entry;
+      buffer.get_entry_at_idx(idx, &current_entry);
+      buffer.OverwriteDataAtIndex(mars::BufferEntryType(current_entry.timestamp_, data, sensor, entry.metadata_), idx);
+    }
+    else if (operation == 7 && buffer.get_length() > 0)
+    {
+      buffer.ClearStatesStartingAtIdx(buffer.get_length() - 1 - std::rand() % 5);
+    }
+    else if (operation == 8 && std::rand() % 20 == 0)
+    {
+      buffer.RemoveSensorFromBuffer(sensor);
+    }
+
+    // Reference results of a linear search over all entries
+    std::vector<mars::BufferEntryType> entries(buffer.get_length());
+    for (int idx = 0; idx < buffer.get_length(); idx++)
+    {
+      buffer.get_entry_at_idx(idx, &entries[idx]);
+    }
+
+    int latest_state_idx = -1;
+    int latest_init_idx = -1;
+    int latest_sensor_state_idx = -1;
+    int oldest_core_state_idx = -1;
+    for (int idx = 0; idx < static_cast<int>(entries.size()); idx++)
+    {
+      if (entries[idx].HasStates())
+      {
+        latest_state_idx = idx;
+        latest_init_idx = entries[idx].metadata_ == mars::BufferMetadataType::init ? idx : latest_init_idx;
+        latest_sensor_state_idx = entries[idx].sensor_handle_ == sensor ? idx : latest_sensor_state_idx;
+        if (oldest_core_state_idx < 0 && entries[idx].IsValid())
+        {
+          oldest_core_state_idx = idx;
+        }
+      }
+    }
+
+    mars::BufferEntryType result;
+    int result_idx;
+    ASSERT_EQ(buffer.get_latest_state(&result), latest_state_idx >= 0);
+    if (latest_state_idx >= 0)
+    {
+      EXPECT_EQ(result.timestamp_, entries[latest_state_idx].timestamp_);
+      EXPECT_EQ(result.sensor_handle_, entries[latest_state_idx].sensor_handle_);
+    }
+
+    ASSERT_EQ(buffer.get_latest_init_state(&result), latest_init_idx >= 0);
+    ASSERT_EQ(buffer.get_oldest_core_state(&result), oldest_core_state_idx >= 0);
+    if (oldest_core_state_idx >= 0)
+    {
+      EXPECT_EQ(result.timestamp_, entries[oldest_core_state_idx].timestamp_);
+    }
+
+    ASSERT_EQ(buffer.get_latest_sensor_handle_state(sensor, &result, &result_idx), latest_sensor_state_idx >= 0);
+    EXPECT_EQ(result_idx, latest_sensor_state_idx);
+    EXPECT_EQ(buffer.CheckForLastSensorHandleWithState(sensor),
+              std::count_if(entries.begin(), entries.end(), [&sensor](const mars::BufferEntryType& e) {
+                return e.sensor_handle_ == sensor && e.HasStates();
+              }) == 1);
+
+    if (!entries.empty())
+    {
+      EXPECT_TRUE(buffer.IsSorted());
+    }
+  }
+}
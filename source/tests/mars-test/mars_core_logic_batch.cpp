@@ -0,0 +1,157 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_core_logic_batch_test : public testing::Test
+{
+public:
+  static mars_test::ScenarioFilter make_filter()
+  {
+    mars_test::ScenarioFilter setup(mars_test::ImuPoseTestConfig());
+    setup.AddPoseSensor("Pose");
+    setup.core_logic_->buffer_.set_max_buffer_size(2000);
+    setup.StartAtOrigin(imu_data());
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data()
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0, 0, 9.81), Eigen::Vector3d::Zero());
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  static mars::BufferDataType pose_data(const double& t)
+  {
+    const mars::PoseMeasurementType pose_meas(Eigen::Vector3d(0.1 * std::sin(t), 0.05 * std::cos(t), 0.02 * t),
+                                              Eigen::Quaterniond::Identity());
+    return mars::BufferDataType(std::make_shared<mars::PoseMeasurementType>(pose_meas));
+  }
+
+  ///
+  /// \brief measurements 100Hz IMU and 10Hz pose measurements for the IMU epochs 'k_start' to 'k_end'
+  ///
+  static std::vector<mars::BufferEntryType> measurements(const mars_test::ScenarioFilter& setup, const int& k_start,
+                                                         const int& k_end)
+  {
+    std::vector<mars::BufferEntryType> result;
+    for (int k = k_start; k <= k_end; k++)
+    {
+      const double t = 0.01 * k;
+      result.emplace_back(t, imu_data(), setup.imu_sensor_sptr_);
+
+      if (k % 10 == 0)
+      {
+        result.emplace_back(t, pose_data(t), setup.pose_sensors_[0]);
+      }
+    }
+    return result;
+  }
+
+  static mars::CoreType latest_core_state(const mars_test::ScenarioFilter& setup)
+  {
+    mars::BufferEntryType latest_entry;
+    setup.core_logic_->buffer_.get_latest_state(&latest_entry);
+    return *static_cast<mars::CoreType*>(latest_entry.data_.core_state_.get());
+  }
+};
+
+TEST_F(mars_core_logic_batch_test, BATCH_MATCHES_SINGLE)
+{
+  for (const int max_buffer_size : { 2000, 50 })
+  {
+    mars_test::ScenarioFilter single = make_filter();
+    mars_test::ScenarioFilter batch = make_filter();
+    single.core_logic_->buffer_.set_max_buffer_size(max_buffer_size);
+    batch.core_logic_->buffer_.set_max_buffer_size(max_buffer_size);
+
+    const std::vector<mars::BufferEntryType> data = measurements(single, 0, 500);
+    const std::vector<mars::BufferEntryType> batch_data = measurements(batch, 0, 500);
+
+    int num_single = 0;
+    for (const auto& entry : data)
+    {
+      num_single += single.core_logic_->ProcessMeasurement(entry.sensor_handle_, entry.timestamp_, entry.data_);
+    }
+
+    int num_callbacks = 0;
+    mars::Time latest_callback_time;
+    const int num_batch = batch.core_logic_->ProcessMeasurements(
+        batch_data, [&num_callbacks, &latest_callback_time](const mars::BufferEntryType& state_entry) {
+          EXPECT_TRUE(state_entry.HasStates());
+          EXPECT_GE(state_entry.timestamp_, latest_callback_time);
+          latest_callback_time = state_entry.timestamp_;
+          num_callbacks++;
+        });
+
+    EXPECT_EQ(num_batch, num_single);
+    EXPECT_EQ(num_callbacks, num_batch);
+    // ProcessMeasurement trims before adding the new entry, the batch trims after adding it
+    EXPECT_LE(batch.core_logic_->buffer_.get_length(), max_buffer_size);
+    EXPECT_LE(single.core_logic_->buffer_.get_length() - batch.core_logic_->buffer_.get_length(), 1);
+
+    const mars::CoreType single_state = latest_core_state(single);
+    const mars::CoreType batch_state = latest_core_state(batch);
+    EXPECT_TRUE(single_state.state_.p_wi_.isApprox(batch_state.state_.p_wi_, 1e-12));
+    EXPECT_TRUE(single_state.state_.v_wi_.isApprox(batch_state.state_.v_wi_, 1e-12));
+    EXPECT_TRUE(single_state.cov_.isApprox(batch_state.cov_, 1e-12));
+  }
+}
+
+TEST_F(mars_core_logic_batch_test, UNSORTED_BATCH_FALLS_BACK)
+{
+  mars_test::ScenarioFilter single = make_filter();
+  mars_test::ScenarioFilter batch = make_filter();
+
+  // Swap two pose measurements of the same sensor to generate an out of order measurement
+  std::vector<mars::BufferEntryType> data = measurements(single, 0, 200);
+  std::vector<mars::BufferEntryType> batch_data = measurements(batch, 0, 200);
+  auto swap_poses = [](std::vector<mars::BufferEntryType>* entries) {
+    std::vector<size_t> pose_idx;
+    for (size_t k = 0; k < entries->size(); k++)
+    {
+      if ((*entries)[k].timestamp_ > 0.5 && (*entries)[k].sensor_handle_ != (*entries)[0].sensor_handle_)
+      {
+        pose_idx.push_back(k);
+      }
+    }
+    std::swap((*entries)[pose_idx[0]], (*entries)[pose_idx[1]]);
+  };
+  swap_poses(&data);
+  swap_poses(&batch_data);
+
+  for (const auto& entry : data)
+  {
+    single.core_logic_->ProcessMeasurement(entry.sensor_handle_, entry.timestamp_, entry.data_);
+  }
+  batch.core_logic_->ProcessMeasurements(batch_data);
+
+  EXPECT_EQ(batch.core_logic_->get_rework_stats().num_reworks_, single.core_logic_->get_rework_stats().num_reworks_);
+  // The swapped pose and the 9 IMU measurements that follow the early pose are out of order
+  EXPECT_EQ(batch.core_logic_->get_rework_stats().num_reworks_, 10);
+
+  const mars::CoreType single_state = latest_core_state(single);
+  const mars::CoreType batch_state = latest_core_state(batch);
+  EXPECT_TRUE(single_state.state_.p_wi_.isApprox(batch_state.state_.p_wi_, 1e-12));
+  EXPECT_TRUE(single_state.cov_.isApprox(batch_state.cov_, 1e-12));
+}
@@ -0,0 +1,200 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/scenario_generator.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_core_logic_decimated_propagation_test : public testing::Test
+{
+public:
+  struct RunResult
+  {
+    double rms_position_{ 0 };  ///< [m]
+    double rms_attitude_{ 0 };  ///< [rad]
+    int num_propagations_{ 0 };
+    double time_{ 0 };  ///< Processing time [s]
+  };
+
+  ///
+  /// \brief generate Noise free 200Hz IMU and 10Hz pose measurements of a trajectory with fast rotations
+  ///
+  static mars::ScenarioGenerator generate()
+  {
+    mars::ScenarioConfig config;
+    config.duration_ = 30;
+    config.rpy_amplitude_ = Eigen::Vector3d(0.4, 0.3, 1.0);
+    config.rpy_frequency_ = Eigen::Vector3d(0.5, 0.4, 0.3);
+
+    mars::ScenarioGenerator generator(config);
+    generator.AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 200));
+    generator.AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::pose, "pose", 10));
+    generator.Generate();
+    return generator;
+  }
+
+  ///
+  /// \brief run Processes the scenario and compares the state of each pose update with the ground truth
+  ///
+  static RunResult run(const mars::ScenarioGenerator& generator, const int& decimation,
+                       const mars::StateTransitionType& transition, const bool& average)
+  {
+    mars_test::ScenarioFilter filter;
+    filter.core_states_sptr_->state_transition_type_ = transition;
+    const std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = filter.imu_sensor_sptr_;
+    const std::shared_ptr<mars::PoseSensorClass> pose_sensor_sptr = filter.AddPoseSensor("pose");
+
+    mars::CoreLogic& core_logic = *filter.core_logic_;
+    core_logic.buffer_.set_max_buffer_size(200);
+    core_logic.prop_decimation_ = decimation;
+    core_logic.prop_decimation_avg_ = average;
+
+    RunResult result;
+    core_logic.AddStateObserver([&result, &imu_sensor_sptr](const mars::BufferEntryType& entry, const bool&) {
+      result.num_propagations_ += entry.sensor_handle_ == imu_sensor_sptr ? 1 : 0;
+    });
+
+    const std::vector<mars::BufferEntryType> entries = filter.get_entries(generator);
+    filter.Start(generator, entries.front());
+
+    double sum_position = 0;
+    double sum_attitude = 0;
+    int num_samples = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t k = 1; k < entries.size(); k++)
+    {
+      core_logic.ProcessMeasurement(entries[k].sensor_handle_, entries[k].timestamp_, entries[k].data_);
+
+      // Skip the convergence of the first seconds
+      if (entries[k].sensor_handle_ != pose_sensor_sptr || entries[k].timestamp_.get_seconds() < 5)
+      {
+        continue;
+      }
+
+      mars::BufferEntryType latest;
+      core_logic.buffer_.get_latest_state(&latest);
+      const mars::CoreStateType& estimate = static_cast<mars::CoreType*>(latest.data_.core_state_.get())->state_;
+      const mars::CoreStateType truth = generator.get_true_state(latest.timestamp_.get_seconds());
+
+      sum_position += (estimate.p_wi_ - truth.p_wi_).squaredNorm();
+      sum_attitude += std::pow(estimate.q_wi_.angularDistance(truth.q_wi_), 2);
+      num_samples++;
+    }
+    result.time_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    result.rms_position_ = std::sqrt(sum_position / num_samples);
+    result.rms_attitude_ = std::sqrt(sum_attitude / num_samples);
+    return result;
+  }
+};
+
+TEST_F(mars_core_logic_decimated_propagation_test, ACCURACY_VERSUS_RATE)
+{
+  const mars::ScenarioGenerator generator = generate();
+
+  const RunResult full_rate = run(generator, 1, mars::StateTransitionType::small_angle_approx, false);
+
+  std::cout << std::setw(10) << "rate [Hz]" << std::setw(22) << "transition" << std::setw(9) << "input"
+            << std::setw(16) << "rms p [m]" << std::setw(16) << "rms att [rad]" << std::setw(14) << "propagations"
+            << std::setw(12) << "time [ms]" << std::endl;
+
+  for (const int& decimation : { 1, 2, 4, 10 })
+  {
+    for (const mars::StateTransitionType& transition :
+         { mars::StateTransitionType::small_angle_approx, mars::StateTransitionType::closed_form })
+    {
+      for (const bool& average : { false, true })
+      {
+        const RunResult result = run(generator, decimation, transition, average);
+
+        std::stringstream row;
+        row << std::setw(10) << 200 / decimation << std::setw(22)
+            << (transition == mars::StateTransitionType::closed_form ? "closed_form" : "small_angle_approx")
+            << std::setw(9) << (average ? "average" : "last") << std::scientific << std::setprecision(3)
+            << std::setw(16) << result.rms_position_ << std::setw(16) << result.rms_attitude_ << std::setw(14)
+            << result.num_propagations_ << std::fixed << std::setprecision(1) << std::setw(12) << 1e3 * result.time_;
+        std::cout << row.str() << std::endl;
+
+        // Propagation at 50 to 100Hz with the closed-form transition only has a bounded loss of accuracy
+        if (decimation <= 4 && transition == mars::StateTransitionType::closed_form)
+        {
+          EXPECT_LT(result.rms_position_, 2 * full_rate.rms_position_ + 0.005);
+          EXPECT_LT(result.rms_attitude_, 2 * full_rate.rms_attitude_ + 0.002);
+        }
+
+        // One propagation per decimated sample and one before each pose update
+        EXPECT_LE(result.num_propagations_, full_rate.num_propagations_ / decimation + 301);
+      }
+    }
+  }
+}
+
+TEST_F(mars_core_logic_decimated_propagation_test, FLUSH_BEFORE_UPDATE)
+{
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("imu");
+  std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>();
+  core_states_sptr->set_propagation_sensor(imu_sensor_sptr);
+  core_states_sptr->set_initial_covariance(Eigen::Vector3d::Ones(), Eigen::Vector3d::Ones(), Eigen::Vector3d::Ones(),
+                                           Eigen::Vector3d::Ones(), Eigen::Vector3d::Ones());
+
+  mars::CoreLogic core_logic(core_states_sptr);
+  core_logic.prop_decimation_ = 4;
+  core_logic.prop_decimation_avg_ = true;
+
+  const auto imu_data = [](const double& a_x) {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(a_x, 0, 9.81), Eigen::Vector3d::Zero());
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  };
+
+  core_logic.ProcessMeasurement(imu_sensor_sptr, 0, imu_data(0));
+  core_logic.Initialize(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+  ASSERT_EQ(core_logic.buffer_.get_length(), 1);
+
+  // Three accumulated measurements do not propagate, the fourth propagates with the line fit of all four
+  EXPECT_TRUE(core_logic.ProcessMeasurement(imu_sensor_sptr, 0.01, imu_data(1)));
+  EXPECT_TRUE(core_logic.ProcessMeasurement(imu_sensor_sptr, 0.02, imu_data(3)));
+  EXPECT_TRUE(core_logic.ProcessMeasurement(imu_sensor_sptr, 0.03, imu_data(1)));
+  EXPECT_EQ(core_logic.buffer_.get_length(), 1);
+
+  EXPECT_TRUE(core_logic.ProcessMeasurement(imu_sensor_sptr, 0.04, imu_data(3)));
+  ASSERT_EQ(core_logic.buffer_.get_length(), 2);
+
+  mars::BufferEntryType latest;
+  core_logic.buffer_.get_latest_state(&latest);
+  EXPECT_EQ(latest.timestamp_, mars::Time(0.04));
+  const mars::CoreType* core = static_cast<mars::CoreType*>(latest.data_.core_state_.get());
+  EXPECT_NEAR(core->state_.a_m_.x(), 2.6, 1e-9);
+
+  // An explicit flush propagates to the last accumulated measurement, two measurements are not averaged
+  core_logic.ProcessMeasurement(imu_sensor_sptr, 0.05, imu_data(1));
+  core_logic.ProcessMeasurement(imu_sensor_sptr, 0.06, imu_data(2));
+  EXPECT_TRUE(core_logic.FlushDecimatedPropagation());
+  EXPECT_FALSE(core_logic.FlushDecimatedPropagation());
+  ASSERT_EQ(core_logic.buffer_.get_length(), 3);
+
+  core_logic.buffer_.get_latest_state(&latest);
+  EXPECT_EQ(latest.timestamp_, mars::Time(0.06));
+  core = static_cast<mars::CoreType*>(latest.data_.core_state_.get());
+  EXPECT_DOUBLE_EQ(core->state_.a_m_.x(), 2);
+}
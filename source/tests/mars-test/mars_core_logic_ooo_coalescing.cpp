@@ -0,0 +1,177 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_core_logic_ooo_coalescing_test : public testing::Test
+{
+public:
+  static mars_test::ScenarioFilter make_filter()
+  {
+    mars_test::ScenarioFilter setup(mars_test::ImuPoseTestConfig());
+    setup.AddPoseSensor("Pose");
+    setup.core_logic_->buffer_.set_max_buffer_size(2000);
+    setup.StartAtOrigin(imu_data());
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data()
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0, 0, 9.81), Eigen::Vector3d::Zero());
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  static mars::BufferDataType pose_data(const double& t)
+  {
+    const mars::PoseMeasurementType pose_meas(Eigen::Vector3d(0.1 * std::sin(t), 0.05 * std::cos(t), 0.02 * t),
+                                              Eigen::Quaterniond::Identity());
+    return mars::BufferDataType(std::make_shared<mars::PoseMeasurementType>(pose_meas));
+  }
+
+  ///
+  /// \brief run_bursts Runs 100Hz IMU and 10Hz pose measurements, poses of 'burst_size' epochs are held back and
+  /// released back-to-back after the next pose epoch
+  ///
+  static void run_bursts(const mars_test::ScenarioFilter& setup, const int& burst_size, const bool& newest_first)
+  {
+    // The first pose measurement initializes the sensor, older measurements would be discarded
+    setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 0, pose_data(0));
+
+    std::vector<double> held_back;
+    for (int k = 1; k <= 300; k++)
+    {
+      const double t = 0.01 * k;
+      setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, t, imu_data());
+
+      if (k % 10 != 0)
+      {
+        continue;
+      }
+
+      if (static_cast<int>(held_back.size()) < burst_size)
+      {
+        held_back.push_back(t);
+        continue;
+      }
+
+      setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], t, pose_data(t));
+
+      if (newest_first)
+      {
+        std::reverse(held_back.begin(), held_back.end());
+      }
+      for (const auto& t_ooo : held_back)
+      {
+        setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], t_ooo, pose_data(t_ooo));
+      }
+      held_back.clear();
+    }
+    setup.core_logic_->FlushPendingRework();
+  }
+
+  static mars::CoreType latest_core_state(const mars_test::ScenarioFilter& setup)
+  {
+    mars::BufferEntryType latest_entry;
+    setup.core_logic_->buffer_.get_latest_state(&latest_entry);
+    return *static_cast<mars::CoreType*>(latest_entry.data_.core_state_.get());
+  }
+};
+
+TEST_F(mars_core_logic_ooo_coalescing_test, COALESCED_REWORK_MATCHES_SEQUENTIAL)
+{
+  for (const bool newest_first : { false, true })
+  {
+    mars_test::ScenarioFilter sequential = make_filter();
+    mars_test::ScenarioFilter coalesced = make_filter();
+    coalesced.core_logic_->coalesce_ooo_reworks_ = true;
+
+    run_bursts(sequential, 4, newest_first);
+    run_bursts(coalesced, 4, newest_first);
+
+    const mars::CoreType sequential_state = latest_core_state(sequential);
+    const mars::CoreType coalesced_state = latest_core_state(coalesced);
+
+    EXPECT_EQ(sequential.core_logic_->buffer_.get_length(), coalesced.core_logic_->buffer_.get_length());
+    EXPECT_TRUE(sequential_state.state_.p_wi_.isApprox(coalesced_state.state_.p_wi_, 1e-12));
+    EXPECT_TRUE(sequential_state.state_.v_wi_.isApprox(coalesced_state.state_.v_wi_, 1e-12));
+    EXPECT_TRUE(sequential_state.state_.q_wi_.coeffs().isApprox(coalesced_state.state_.q_wi_.coeffs(), 1e-12));
+    EXPECT_TRUE(sequential_state.cov_.isApprox(coalesced_state.cov_, 1e-12));
+
+    // 6 bursts with 4 out of order measurements each
+    const mars::ReworkStats& sequential_stats = sequential.core_logic_->get_rework_stats();
+    const mars::ReworkStats& coalesced_stats = coalesced.core_logic_->get_rework_stats();
+    EXPECT_EQ(sequential_stats.num_ooo_measurements_, 24);
+    EXPECT_EQ(coalesced_stats.num_ooo_measurements_, 24);
+    EXPECT_EQ(sequential_stats.num_reworks_, 24);
+    EXPECT_EQ(coalesced_stats.num_reworks_, 6);
+    EXPECT_LT(4 * coalesced_stats.num_reworked_entries_, 3 * sequential_stats.num_reworked_entries_);
+  }
+}
+
+TEST_F(mars_core_logic_ooo_coalescing_test, FLUSH_AND_MAX_COALESCED)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+  setup.core_logic_->coalesce_ooo_reworks_ = true;
+  setup.core_logic_->max_coalesced_ooo_ = 3;
+
+  for (int k = 1; k <= 100; k++)
+  {
+    setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 0.01 * k, imu_data());
+  }
+
+  // Without pending measurements, there is nothing to flush
+  EXPECT_FALSE(setup.core_logic_->FlushPendingRework());
+
+  // The third measurement of the burst reaches the limit and triggers the rework
+  for (int k = 1; k <= 5; k++)
+  {
+    ASSERT_TRUE(setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 0.1 * k, pose_data(0.1 * k)));
+  }
+  EXPECT_EQ(setup.core_logic_->get_rework_stats().num_reworks_, 1);
+
+  // The remaining two are reworked on request
+  EXPECT_TRUE(setup.core_logic_->FlushPendingRework());
+  EXPECT_FALSE(setup.core_logic_->FlushPendingRework());
+  EXPECT_EQ(setup.core_logic_->get_rework_stats().num_reworks_, 2);
+
+  // Or before the next in order measurement
+  ASSERT_TRUE(setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 0.55, pose_data(0.55)));
+  EXPECT_EQ(setup.core_logic_->get_rework_stats().num_reworks_, 2);
+  setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 1.01, imu_data());
+  EXPECT_EQ(setup.core_logic_->get_rework_stats().num_reworks_, 3);
+  EXPECT_FALSE(setup.core_logic_->FlushPendingRework());
+
+  // All pose measurements have a state
+  int num_pose_states = 0;
+  for (int k = 0; k < setup.core_logic_->buffer_.get_length(); k++)
+  {
+    mars::BufferEntryType entry;
+    setup.core_logic_->buffer_.get_entry_at_idx(k, &entry);
+    if (entry.sensor_handle_ == setup.pose_sensors_[0])
+    {
+      EXPECT_TRUE(entry.HasStates());
+      num_pose_states++;
+    }
+  }
+  EXPECT_EQ(num_pose_states, 6);
+}
@@ -0,0 +1,224 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_core_logic_speculative_rework_test : public testing::Test
+{
+public:
+  static mars_test::ScenarioFilter make_filter()
+  {
+    mars_test::ScenarioFilter setup(mars_test::ImuPoseTestConfig());
+    setup.AddPoseSensor("Pose");
+    setup.core_logic_->buffer_.set_max_buffer_size(2000);
+    setup.StartAtOrigin(imu_data(0));
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data(const double& t)
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0.2 * std::sin(t), 0.1 * std::cos(t), 9.81),
+                                            Eigen::Vector3d(0.01, -0.02, 0.05 * std::sin(t)));
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  static mars::BufferDataType pose_data(const double& t)
+  {
+    const mars::PoseMeasurementType pose_meas(Eigen::Vector3d(0.1 * std::sin(t), 0.05 * std::cos(t), 0.02 * t),
+                                              Eigen::Quaterniond::Identity());
+    return mars::BufferDataType(std::make_shared<mars::PoseMeasurementType>(pose_meas));
+  }
+
+  ///
+  /// \brief run_delayed Runs 200Hz IMU and 10Hz pose measurements, the pose at 'delayed_time' arrives 'delay' seconds
+  /// late
+  /// \return Processing time [s] of the ProcessMeasurement call with the delayed pose
+  ///
+  static double run_delayed(const mars_test::ScenarioFilter& setup, const double& delayed_time, const double& delay)
+  {
+    setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 0, pose_data(0));
+
+    double delayed_tick = 0;
+    bool delayed_processed = false;
+    for (int k = 1; k <= 800; k++)
+    {
+      const double t = 0.005 * k;
+      setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, t, imu_data(t));
+
+      if (k % 20 == 0 && std::abs(t - delayed_time) > 1e-9)
+      {
+        setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], t, pose_data(t));
+      }
+
+      if (!delayed_processed && t >= delayed_time + delay)
+      {
+        const auto start = std::chrono::steady_clock::now();
+        setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], delayed_time, pose_data(delayed_time));
+        delayed_tick = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        delayed_processed = true;
+      }
+    }
+
+    while (setup.core_logic_->FinishSpeculativeRework())
+    {
+    }
+    return delayed_tick;
+  }
+
+  static mars::CoreType latest_core_state(const mars_test::ScenarioFilter& setup)
+  {
+    mars::BufferEntryType latest_entry;
+    setup.core_logic_->buffer_.get_latest_state(&latest_entry);
+    return *static_cast<mars::CoreType*>(latest_entry.data_.core_state_.get());
+  }
+};
+
+TEST_F(mars_core_logic_speculative_rework_test, SPECULATIVE_REWORK_MATCHES_SYNCHRONOUS)
+{
+  mars_test::ScenarioFilter synchronous = make_filter();
+  mars_test::ScenarioFilter speculative = make_filter();
+  speculative.core_logic_->speculative_rework_ = true;
+  speculative.core_logic_->speculative_min_entries_ = 100;
+
+  int num_corrections = 0;
+  speculative.core_logic_->AddStateObserver(
+      [&num_corrections](const mars::BufferEntryType&, const bool& is_correction) {
+        num_corrections += is_correction ? 1 : 0;
+      });
+
+  const double synchronous_tick = run_delayed(synchronous, 1.0, 1.5);
+
+  // The worker instance is created during the run without the creation banner
+  testing::internal::CaptureStdout();
+  const double speculative_tick = run_delayed(speculative, 1.0, 1.5);
+  EXPECT_EQ(testing::internal::GetCapturedStdout().find("Created: CoreLogic"), std::string::npos);
+
+  EXPECT_FALSE(speculative.core_logic_->IsSpeculativeReworkRunning());
+  EXPECT_FALSE(speculative.core_logic_->FinishSpeculativeRework());
+
+  const mars::CoreType synchronous_state = latest_core_state(synchronous);
+  const mars::CoreType speculative_state = latest_core_state(speculative);
+
+  EXPECT_EQ(synchronous.core_logic_->buffer_.get_length(), speculative.core_logic_->buffer_.get_length());
+  EXPECT_TRUE(synchronous.core_logic_->buffer_.IsSorted());
+  EXPECT_TRUE(speculative.core_logic_->buffer_.IsSorted());
+  EXPECT_TRUE(synchronous_state.state_.p_wi_.isApprox(speculative_state.state_.p_wi_, 1e-9));
+  EXPECT_TRUE(synchronous_state.state_.v_wi_.isApprox(speculative_state.state_.v_wi_, 1e-9));
+  EXPECT_TRUE(synchronous_state.state_.q_wi_.coeffs().isApprox(speculative_state.state_.q_wi_.coeffs(), 1e-9));
+  EXPECT_TRUE(synchronous_state.cov_.isApprox(speculative_state.cov_, 1e-9));
+
+  // All pose measurements have a state, including the ones deferred during the rework
+  int num_pose_states = 0;
+  for (int k = 0; k < speculative.core_logic_->buffer_.get_length(); k++)
+  {
+    mars::BufferEntryType entry;
+    speculative.core_logic_->buffer_.get_entry_at_idx(k, &entry);
+    if (entry.sensor_handle_ == speculative.pose_sensors_[0])
+    {
+      EXPECT_TRUE(entry.HasStates());
+      num_pose_states++;
+    }
+  }
+  EXPECT_EQ(num_pose_states, 41);
+
+  // The delay of 1.5s covers 300 IMU entries, all of them are reported as corrections
+  const mars::ReworkStats& stats = speculative.core_logic_->get_rework_stats();
+  EXPECT_GE(stats.num_speculative_reworks_, 1);
+  EXPECT_GE(stats.num_reworked_entries_, 300);
+  EXPECT_GE(num_corrections, 300);
+
+  // The filter thread only copies the reworked segment instead of reworking it. The times depend on the machine load,
+  // they are reported only.
+  std::cout << "Processing of the delayed measurement, synchronous: " << 1e6 * synchronous_tick
+            << "us, speculative: " << 1e6 * speculative_tick << "us, ratio: " << speculative_tick / synchronous_tick
+            << ", repropagated entries: " << stats.num_repropagated_entries_ << std::endl;
+}
+
+TEST_F(mars_core_logic_speculative_rework_test, SHORT_REWORK_IS_SYNCHRONOUS)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+  setup.core_logic_->speculative_rework_ = true;
+  setup.core_logic_->speculative_min_entries_ = 1000;
+
+  run_delayed(setup, 1.0, 0.5);
+
+  const mars::ReworkStats& stats = setup.core_logic_->get_rework_stats();
+  EXPECT_EQ(stats.num_reworks_, 1);
+  EXPECT_EQ(stats.num_speculative_reworks_, 0);
+  EXPECT_EQ(stats.num_repropagated_entries_, 0);
+  EXPECT_FALSE(setup.core_logic_->IsSpeculativeReworkRunning());
+}
+
+TEST_F(mars_core_logic_speculative_rework_test, LOAD_SHEDDER_COSTS)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+  setup.core_logic_->speculative_rework_ = true;
+  setup.core_logic_->load_shedder_ = std::make_shared<mars::LoadShedder>();
+  const std::shared_ptr<mars::LoadShedder>& shedder = setup.core_logic_->load_shedder_;
+
+  setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 0, pose_data(0));
+  for (int k = 1; k <= 400; k++)
+  {
+    const double t = 0.005 * k;
+    setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, t, imu_data(t));
+    if (k % 20 == 0 && k != 200)
+    {
+      setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], t, pose_data(t));
+    }
+  }
+
+  // The delayed pose starts the rework of 200 entries on the worker thread
+  setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 1.0, pose_data(1.0));
+  ASSERT_TRUE(setup.core_logic_->IsSpeculativeReworkRunning());
+
+  mars::LoadShedderStats pose_stats;
+  ASSERT_TRUE(shedder->get_stats(setup.pose_sensors_[0], &pose_stats));
+  const int num_pose_costs = pose_stats.num_costs_;
+
+  // A pose which arrives during the rework is deferred and reports no cost, unless the worker finished before
+  setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 2.0, pose_data(2.0));
+  const bool pose_deferred = setup.core_logic_->IsSpeculativeReworkRunning();
+  ASSERT_TRUE(shedder->get_stats(setup.pose_sensors_[0], &pose_stats));
+  EXPECT_EQ(pose_stats.num_costs_, pose_deferred ? num_pose_costs : num_pose_costs + 1);
+
+  // The splice is triggered by the next measurement and is reported as overhead, not as the cost of the measurement
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  mars::LoadShedderStats imu_stats;
+  ASSERT_TRUE(shedder->get_stats(setup.imu_sensor_sptr_, &imu_stats));
+  const double imu_cost_max = imu_stats.cost_max_;
+
+  setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 2.005, imu_data(2.005));
+  EXPECT_FALSE(setup.core_logic_->IsSpeculativeReworkRunning());
+  EXPECT_GT(shedder->get_overhead(), 0);
+
+  ASSERT_TRUE(shedder->get_stats(setup.pose_sensors_[0], &pose_stats));
+  EXPECT_EQ(pose_stats.num_costs_, pose_deferred ? num_pose_costs : num_pose_costs + 1);
+
+  // The cost of the IMU measurement which triggered the splice only covers the propagation
+  ASSERT_TRUE(shedder->get_stats(setup.imu_sensor_sptr_, &imu_stats));
+  std::cout << "IMU cost max before the splice: " << 1e6 * imu_cost_max << "us, after: " << 1e6 * imu_stats.cost_max_
+            << "us, splice overhead: " << 1e6 * shedder->get_overhead() << "us" << std::endl;
+}
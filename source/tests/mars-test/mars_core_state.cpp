@@ -14,10 +14,65 @@
 #include <mars/type_definitions/core_state_type.h>
 #include <mars/type_definitions/core_type.h>
 #include <Eigen/Dense>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 class mars_core_state_test : public testing::Test
 {
 public:
+  static mars::CoreType random_core(mars::CoreState& core_state)
+  {
+    mars::CoreType core;
+    core.state_.p_wi_ = Eigen::Vector3d::Random();
+    core.state_.v_wi_ = Eigen::Vector3d::Random();
+    core.state_.q_wi_ = Eigen::Quaterniond(Eigen::Vector4d::Random()).normalized();
+    core.state_.b_w_ = 0.01 * Eigen::Vector3d::Random();
+    core.state_.b_a_ = 0.1 * Eigen::Vector3d::Random();
+    core.state_.w_m_ = Eigen::Vector3d(0.1, -0.2, 0.3);
+    core.state_.a_m_ = Eigen::Vector3d(0.2, 0.1, 9.81);
+
+    const mars::CoreStateMatrix A = mars::CoreStateMatrix::Random();
+    core.cov_ = A * A.transpose() * 1e-3 + core_state.InitializeCovariance();
+    return core;
+  }
+
+  ///
+  /// \brief Reference propagation with separate state, F_d, Q_d and a dense covariance product
+  ///
+  static mars::CoreType reference_propagation(mars::CoreState& core_state, const mars::CoreType& prior,
+                                              const mars::IMUMeasurementType& meas, const double& dt)
+  {
+    const Eigen::Vector3d w_est = meas.angular_velocity_ - prior.state_.b_w_;
+    const Eigen::Vector3d a_est = meas.linear_acceleration_ - prior.state_.b_a_;
+
+    const mars::CoreStateMatrix F_d = core_state.GenerateFdSmallAngleApprox(prior.state_.q_wi_, a_est, w_est, dt);
+    const mars::CoreStateMatrix Q_d = core_state.CalcQSmallAngleApprox(
+        dt, prior.state_.q_wi_, meas.linear_acceleration_, core_state.n_a_, prior.state_.b_a_, core_state.n_ba_,
+        meas.angular_velocity_, core_state.n_w_, prior.state_.b_w_, core_state.n_bw_);
+
+    const mars::CoreStateMatrix P = F_d * prior.cov_ * F_d.transpose() + Q_d;
+
+    mars::CoreType result;
+    result.cov_ = (P + P.transpose()) / 2;
+    result.state_transition_ = F_d;
+    result.state_ = core_state.PropagateState(prior.state_, meas, dt);
+    return result;
+  }
+
+  static uint64_t cycles()
+  {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+#endif
+  }
 };
 
 TEST_F(mars_core_state_test, CTOR_CORE_TYPE)
@@ -187,3 +242,191 @@ TEST_F(mars_core_state_test, Q_TEST)
 
   EXPECT_TRUE(test_return.isApprox(expected_result));
 }
+
+TEST_F(mars_core_state_test, FD_CLOSED_FORM)
+{
+  const Eigen::Quaterniond q_wi = Eigen::Quaterniond(0.9, 0.1, -0.3, 0.2).normalized();
+  const Eigen::Vector3d a_est(0.4, -0.3, 9.7);
+  const Eigen::Vector3d w_dir = Eigen::Vector3d(0.3, -0.5, 0.8).normalized();
+
+  // Rotation angles below, at and above the switch from the series to the closed form
+  for (const double& theta : { 1e-4, 0.1, 0.2499, 0.2501, 0.6, 1.5 })
+  {
+    const double dt = 0.2;
+    const Eigen::Vector3d w_est = w_dir * theta / dt;
+
+    const mars::CoreStateMatrix F_closed = mars::CoreState::GenerateFdClosedForm(q_wi, a_est, w_est, dt);
+    const mars::CoreStateMatrix F_taylor = mars::CoreState::GenerateFdTaylor(q_wi, a_est, w_est, dt, 30);
+    const mars::CoreStateMatrix F_small = mars::CoreState::GenerateFdSmallAngleApprox(q_wi, a_est, w_est, dt);
+
+    EXPECT_LT((F_closed - F_taylor).cwiseAbs().maxCoeff(), 1e-12) << "theta: " << theta;
+
+    // The small angle approximation truncates the series after the second power of [w_est]x
+    const double small_angle_error = (F_small - F_taylor).cwiseAbs().maxCoeff();
+    if (theta > 0.5)
+    {
+      EXPECT_GT(small_angle_error, 1e-3) << "theta: " << theta;
+    }
+    else if (theta < 1e-3)
+    {
+      EXPECT_LT(small_angle_error, 1e-12) << "theta: " << theta;
+    }
+  }
+}
+
+TEST_F(mars_core_state_test, Q_CLOSED_FORM)
+{
+  const Eigen::Quaterniond q_wi = Eigen::Quaterniond(0.9, 0.1, -0.3, 0.2).normalized();
+  const Eigen::Vector3d a_m(0.4, -0.3, 9.7);
+  const Eigen::Vector3d w_m(0.3, -0.5, 0.8);
+  const Eigen::Vector3d b_a(0.01, 0.02, -0.01);
+  const Eigen::Vector3d b_w(0.001, -0.002, 0.003);
+  const Eigen::Vector3d n_a(0.013, 0.012, 0.011);
+  const Eigen::Vector3d n_ba(0.0013, 0.0012, 0.0011);
+  const Eigen::Vector3d n_w(0.0013, 0.0012, 0.0011);
+  const Eigen::Vector3d n_bw(0.00013, 0.00012, 0.00011);
+
+  // The noise of the accelerometer and the bias random walks matches the small angle approximation
+  const double dt = 0.005;
+  const Eigen::Vector3d zero(Eigen::Vector3d::Zero());
+  const mars::CoreStateMatrix Q_closed_acc =
+      mars::CoreState::CalcQClosedForm(dt, q_wi, a_m, n_a, b_a, n_ba, w_m, zero, b_w, n_bw);
+  const mars::CoreStateMatrix Q_small_acc =
+      mars::CoreState::CalcQSmallAngleApprox(dt, q_wi, a_m, n_a, b_a, n_ba, w_m, zero, b_w, n_bw);
+  EXPECT_TRUE(Q_closed_acc.isApprox(Q_small_acc, 1e-6));
+
+  // Reference integral of F_d(t) * G * Q_c * G^T * F_d(t)^T with the midpoint rule
+  const Eigen::Vector3d w_fast = w_m * 5;
+  const double dt_large = 0.2;
+  const Eigen::Matrix3d R = q_wi.toRotationMatrix();
+
+  mars::CoreStateMatrix G_Qc_GT(mars::CoreStateMatrix::Zero());
+  G_Qc_GT.block<3, 3>(3, 3) = R * n_a.cwiseProduct(n_a).asDiagonal() * R.transpose();
+  G_Qc_GT.block<3, 3>(6, 6) = n_w.cwiseProduct(n_w).asDiagonal();
+  G_Qc_GT.block<3, 3>(9, 9) = n_bw.cwiseProduct(n_bw).asDiagonal();
+  G_Qc_GT.block<3, 3>(12, 12) = n_ba.cwiseProduct(n_ba).asDiagonal();
+
+  const int steps = 2000;
+  mars::CoreStateMatrix Q_reference(mars::CoreStateMatrix::Zero());
+  for (int k = 0; k < steps; k++)
+  {
+    const double t = (k + 0.5) * dt_large / steps;
+    const mars::CoreStateMatrix F_t = mars::CoreState::GenerateFdTaylor(q_wi, a_m - b_a, w_fast - b_w, t, 20);
+    Q_reference += F_t * G_Qc_GT * F_t.transpose() * (dt_large / steps);
+  }
+
+  const mars::CoreStateMatrix Q_closed =
+      mars::CoreState::CalcQClosedForm(dt_large, q_wi, a_m, n_a, b_a, n_ba, w_fast, n_w, b_w, n_bw);
+  EXPECT_TRUE(Q_closed.isApprox(Q_reference, 1e-6));
+  EXPECT_TRUE(Q_closed.isApprox(Q_closed.transpose()));
+
+  // Positive semi-definite for large steps
+  const mars::CoreStateMatrix Q_large =
+      mars::CoreState::CalcQClosedForm(0.1, q_wi, a_m * 2, n_a, b_a, n_ba, w_m * 10, n_w, b_w, n_bw);
+  Eigen::SelfAdjointEigenSolver<mars::CoreStateMatrix> eigen_solver(Q_large);
+  EXPECT_GT(eigen_solver.eigenvalues().minCoeff(), -1e-15);
+}
+
+TEST_F(mars_core_state_test, FUSED_PROPAGATION_CLOSED_FORM)
+{
+  mars::CoreState core_state;
+  core_state.set_noise_std(Eigen::Vector3d(0.013, 0.013, 0.013), Eigen::Vector3d(0.0013, 0.0013, 0.0013),
+                           Eigen::Vector3d(0.083, 0.083, 0.083), Eigen::Vector3d(0.0083, 0.0083, 0.0083));
+  core_state.state_transition_type_ = mars::StateTransitionType::closed_form;
+
+  const mars::CoreType prior = random_core(core_state);
+  const mars::IMUMeasurementType meas(Eigen::Vector3d(0.3, -0.2, 9.7), Eigen::Vector3d(2.0, -1.5, 3.0));
+  const double dt = 0.05;
+
+  const mars::CoreType fused = core_state.PropagateStateAndCovariance(prior, meas, dt);
+  const mars::CoreType wrapper = core_state.PredictProcessCovariance(prior, meas, dt);
+
+  const Eigen::Vector3d a_est = meas.linear_acceleration_ - prior.state_.b_a_;
+  const Eigen::Vector3d w_est = meas.angular_velocity_ - prior.state_.b_w_;
+  const mars::CoreStateMatrix F_d = mars::CoreState::GenerateFdClosedForm(prior.state_.q_wi_, a_est, w_est, dt);
+  const mars::CoreStateMatrix Q_d = mars::CoreState::CalcQClosedForm(
+      dt, prior.state_.q_wi_, meas.linear_acceleration_, core_state.n_a_, prior.state_.b_a_, core_state.n_ba_,
+      meas.angular_velocity_, core_state.n_w_, prior.state_.b_w_, core_state.n_bw_);
+  const mars::CoreStateMatrix P_reference = F_d * prior.cov_ * F_d.transpose() + Q_d;
+
+  EXPECT_TRUE(fused.state_transition_.isApprox(F_d));
+  EXPECT_TRUE(fused.cov_.isApprox(P_reference, 1e-12));
+  EXPECT_TRUE(wrapper.cov_.isApprox(fused.cov_, 1e-12));
+}
+
+TEST_F(mars_core_state_test, FUSED_PROPAGATION)
+{
+  std::srand(11);
+
+  mars::CoreState core_state;
+  core_state.set_noise_std(Eigen::Vector3d(0.013, 0.013, 0.013), Eigen::Vector3d(0.0013, 0.0013, 0.0013),
+                           Eigen::Vector3d(0.083, 0.083, 0.083), Eigen::Vector3d(0.0083, 0.0083, 0.0083));
+
+  for (int k = 0; k < 50; k++)
+  {
+    const mars::CoreType prior = random_core(core_state);
+    const Eigen::Vector3d a_m = Eigen::Vector3d(0, 0, 9.81) + Eigen::Vector3d::Random();
+    const mars::IMUMeasurementType meas(a_m, Eigen::Vector3d::Random());
+    const double dt = 0.005 * (1 + k % 4);
+
+    const mars::CoreType reference = reference_propagation(core_state, prior, meas, dt);
+    const mars::CoreType fused = core_state.PropagateStateAndCovariance(prior, meas, dt);
+    const mars::CoreType wrapper = core_state.PredictProcessCovariance(prior, meas, dt);
+
+    EXPECT_TRUE(fused.cov_.isApprox(reference.cov_, 1e-12));
+    EXPECT_TRUE(fused.state_transition_.isApprox(reference.state_transition_, 1e-14));
+    EXPECT_TRUE(fused.state_.p_wi_.isApprox(reference.state_.p_wi_, 1e-14));
+    EXPECT_TRUE(fused.state_.v_wi_.isApprox(reference.state_.v_wi_, 1e-14));
+    EXPECT_TRUE(fused.state_.q_wi_.coeffs().isApprox(reference.state_.q_wi_.coeffs(), 1e-14));
+    EXPECT_TRUE(fused.cov_.isApprox(fused.cov_.transpose(), 0));
+
+    EXPECT_TRUE(wrapper.cov_.isApprox(fused.cov_, 1e-14));
+    EXPECT_TRUE(wrapper.state_transition_.isApprox(fused.state_transition_, 0));
+  }
+}
+
+TEST_F(mars_core_state_test, FUSED_PROPAGATION_PERFORMANCE)
+{
+  std::srand(12);
+
+  mars::CoreState core_state;
+  core_state.set_noise_std(Eigen::Vector3d(0.013, 0.013, 0.013), Eigen::Vector3d(0.0013, 0.0013, 0.0013),
+                           Eigen::Vector3d(0.083, 0.083, 0.083), Eigen::Vector3d(0.0083, 0.0083, 0.0083));
+
+  const int num_repetitions = 20;
+  const int num_steps = 250;
+  const double dt = 0.005;
+  const mars::IMUMeasurementType meas(Eigen::Vector3d(0.2, 0.1, 9.81), Eigen::Vector3d(0.1, -0.2, 0.3));
+  const mars::CoreType initial = random_core(core_state);
+
+  // Minimum over interleaved repetitions to suppress scheduling noise
+  double cycles_reference = std::numeric_limits<double>::max();
+  double cycles_fused = std::numeric_limits<double>::max();
+  mars::CoreType reference;
+  mars::CoreType fused;
+
+  for (int r = 0; r < num_repetitions; r++)
+  {
+    reference = initial;
+    uint64_t start = cycles();
+    for (int k = 0; k < num_steps; k++)
+    {
+      reference = reference_propagation(core_state, reference, meas, dt);
+    }
+    cycles_reference = std::min(cycles_reference, static_cast<double>(cycles() - start) / num_steps);
+
+    fused = initial;
+    start = cycles();
+    for (int k = 0; k < num_steps; k++)
+    {
+      fused = core_state.PropagateStateAndCovariance(fused, meas, dt);
+    }
+    cycles_fused = std::min(cycles_fused, static_cast<double>(cycles() - start) / num_steps);
+  }
+
+  std::cout << "Propagation step, separate: " << cycles_reference << " cycles, fused: " << cycles_fused << " cycles"
+            << std::endl;
+
+  EXPECT_TRUE(fused.cov_.isApprox(reference.cov_, 1e-8));
+  EXPECT_TRUE(fused.state_.p_wi_.isApprox(reference.state_.p_wi_, 1e-8));
+}
@@ -0,0 +1,233 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_state.h>
+#include <mars/core_state_batch.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+class mars_core_state_batch_test : public testing::Test
+{
+public:
+  static std::shared_ptr<mars::CoreState> make_core_states()
+  {
+    std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>();
+    core_states_sptr->set_noise_std(Eigen::Vector3d::Constant(0.013), Eigen::Vector3d::Constant(0.0013),
+                                    Eigen::Vector3d::Constant(0.083), Eigen::Vector3d::Constant(0.0083));
+    return core_states_sptr;
+  }
+
+  static mars::CoreType random_core(const int& seed)
+  {
+    std::srand(seed);
+
+    mars::CoreType core;
+    core.state_.p_wi_ = Eigen::Vector3d::Random() * 10;
+    core.state_.v_wi_ = Eigen::Vector3d::Random();
+    core.state_.q_wi_ = Eigen::Quaterniond(Eigen::Vector4d::Random()).normalized();
+    core.state_.b_w_ = Eigen::Vector3d::Random() * 0.01;
+    core.state_.b_a_ = Eigen::Vector3d::Random() * 0.1;
+    core.state_.w_m_ = Eigen::Vector3d::Random();
+    core.state_.a_m_ = Eigen::Vector3d(0, 0, 9.81) + Eigen::Vector3d::Random();
+
+    const mars::CoreStateMatrix L = mars::CoreStateMatrix::Random() * 0.1;
+    core.cov_ = L * L.transpose() + mars::CoreStateMatrix::Identity() * 0.01;
+    return core;
+  }
+
+  static mars::IMUMeasurementType imu_meas(const int& k)
+  {
+    return mars::IMUMeasurementType(Eigen::Vector3d(0.1 * std::sin(0.1 * k), 0.2, 9.81 + 0.5 * std::cos(0.05 * k)),
+                                    Eigen::Vector3d(0.3 * std::sin(0.02 * k), -0.1, 0.2 * std::cos(0.1 * k)));
+  }
+};
+
+TEST_F(mars_core_state_batch_test, SET_GET)
+{
+  std::shared_ptr<mars::CoreState> core_states_sptr = make_core_states();
+  mars::CoreStateBatch batch(core_states_sptr, 3);
+  ASSERT_EQ(batch.size(), 3);
+
+  const mars::CoreType core = random_core(1);
+  batch.set_core(1, core);
+
+  const mars::CoreType result = batch.get_core(1);
+  EXPECT_EQ(result.state_.p_wi_, core.state_.p_wi_);
+  EXPECT_EQ(result.state_.v_wi_, core.state_.v_wi_);
+  EXPECT_EQ(result.state_.q_wi_.coeffs(), core.state_.q_wi_.coeffs());
+  EXPECT_EQ(result.state_.b_w_, core.state_.b_w_);
+  EXPECT_EQ(result.state_.b_a_, core.state_.b_a_);
+  EXPECT_EQ(result.state_.w_m_, core.state_.w_m_);
+  EXPECT_EQ(result.state_.a_m_, core.state_.a_m_);
+  EXPECT_EQ(result.cov_, core.cov_);
+
+  // Other instances are untouched
+  EXPECT_EQ(batch.get_core(0).state_.q_wi_.coeffs(), Eigen::Quaterniond::Identity().coeffs());
+}
+
+TEST_F(mars_core_state_batch_test, PROPAGATION_MATCHES_CORE_STATE)
+{
+  const int num_instances = 9;
+  const int num_steps = 100;
+  const double dt = 0.005;
+
+  std::shared_ptr<mars::CoreState> core_states_sptr = make_core_states();
+  mars::CoreStateBatch batch(core_states_sptr, num_instances);
+
+  std::vector<mars::CoreType> reference(num_instances);
+  for (int n = 0; n < num_instances; n++)
+  {
+    reference[n] = random_core(n + 10);
+    batch.set_core(n, reference[n]);
+  }
+
+  for (int k = 0; k < num_steps; k++)
+  {
+    const mars::IMUMeasurementType meas = imu_meas(k);
+    batch.Propagate(meas, dt);
+
+    for (int n = 0; n < num_instances; n++)
+    {
+      mars::CoreType propagated = core_states_sptr->PredictProcessCovariance(reference[n], meas, dt);
+      propagated.state_ = core_states_sptr->PropagateState(reference[n].state_, meas, dt);
+      reference[n] = propagated;
+    }
+  }
+
+  for (int n = 0; n < num_instances; n++)
+  {
+    const mars::CoreType result = batch.get_core(n);
+    EXPECT_TRUE(result.state_.p_wi_.isApprox(reference[n].state_.p_wi_, 1e-12));
+    EXPECT_TRUE(result.state_.v_wi_.isApprox(reference[n].state_.v_wi_, 1e-12));
+    EXPECT_TRUE(result.state_.q_wi_.coeffs().isApprox(reference[n].state_.q_wi_.coeffs(), 1e-12));
+    EXPECT_EQ(result.state_.b_w_, reference[n].state_.b_w_);
+    EXPECT_EQ(result.state_.w_m_, reference[n].state_.w_m_);
+    EXPECT_TRUE(result.cov_.isApprox(reference[n].cov_, 1e-10));
+    EXPECT_TRUE(result.state_transition_.isApprox(reference[n].state_transition_, 1e-12));
+    EXPECT_EQ(result.cov_, result.cov_.transpose());
+  }
+}
+
+TEST_F(mars_core_state_batch_test, CLOSED_FORM_MATCHES_CORE_STATE)
+{
+  // One full tile and a remainder, the long steps use the closed-form coefficients beyond the Taylor series
+  const int num_instances = 17;
+  const int num_steps = 20;
+
+  std::shared_ptr<mars::CoreState> core_states_sptr = make_core_states();
+  core_states_sptr->state_transition_type_ = mars::StateTransitionType::closed_form;
+  mars::CoreStateBatch batch(core_states_sptr, num_instances);
+
+  std::vector<mars::CoreType> reference(num_instances);
+  for (int n = 0; n < num_instances; n++)
+  {
+    reference[n] = random_core(n + 30);
+    batch.set_core(n, reference[n]);
+  }
+
+  for (int k = 0; k < num_steps; k++)
+  {
+    const double dt = (k % 2 == 0) ? 0.005 : 2.0;
+    const mars::IMUMeasurementType meas = imu_meas(k);
+    batch.Propagate(meas, dt);
+
+    for (int n = 0; n < num_instances; n++)
+    {
+      mars::CoreType propagated = core_states_sptr->PredictProcessCovariance(reference[n], meas, dt);
+      propagated.state_ = core_states_sptr->PropagateState(reference[n].state_, meas, dt);
+      reference[n] = propagated;
+    }
+  }
+
+  for (int n = 0; n < num_instances; n++)
+  {
+    const mars::CoreType result = batch.get_core(n);
+    EXPECT_TRUE(result.state_.p_wi_.isApprox(reference[n].state_.p_wi_, 1e-12));
+    EXPECT_TRUE(result.state_.q_wi_.coeffs().isApprox(reference[n].state_.q_wi_.coeffs(), 1e-12));
+    EXPECT_TRUE(result.cov_.isApprox(reference[n].cov_, 1e-10));
+    EXPECT_TRUE(result.state_transition_.isApprox(reference[n].state_transition_, 1e-12));
+    EXPECT_EQ(result.cov_, result.cov_.transpose());
+  }
+
+  // The small angle approximation differs for the long steps, a batch ignoring the transition type would not match
+  const mars::CoreType small_angle = make_core_states()->PredictProcessCovariance(reference[0], imu_meas(0), 2.0);
+  const mars::CoreType closed_form = core_states_sptr->PredictProcessCovariance(reference[0], imu_meas(0), 2.0);
+  EXPECT_FALSE(closed_form.state_transition_.isApprox(small_angle.state_transition_, 1e-9));
+}
+
+TEST_F(mars_core_state_batch_test, FIXED_BIAS)
+{
+  std::shared_ptr<mars::CoreState> core_states_sptr = make_core_states();
+  core_states_sptr->set_fixed_acc_bias(true);
+  core_states_sptr->set_fixed_gyro_bias(true);
+
+  mars::CoreStateBatch batch(core_states_sptr, 2);
+  mars::CoreType reference = random_core(3);
+  batch.set_all(reference);
+
+  const mars::IMUMeasurementType meas = imu_meas(1);
+  batch.PropagateState(meas, 0.01);
+  reference.state_ = core_states_sptr->PropagateState(reference.state_, meas, 0.01);
+
+  const mars::CoreType result = batch.get_core(1);
+  EXPECT_TRUE(result.state_.b_w_.isZero());
+  EXPECT_TRUE(result.state_.b_a_.isZero());
+  EXPECT_TRUE(result.state_.p_wi_.isApprox(reference.state_.p_wi_, 1e-12));
+  EXPECT_TRUE(result.state_.q_wi_.coeffs().isApprox(reference.state_.q_wi_.coeffs(), 1e-12));
+}
+
+TEST_F(mars_core_state_batch_test, ENSEMBLE_PERFORMANCE)
+{
+  const int num_instances = 256;
+  const int num_steps = 20;
+  const double dt = 0.005;
+
+  std::shared_ptr<mars::CoreState> core_states_sptr = make_core_states();
+  mars::CoreStateBatch batch(core_states_sptr, num_instances);
+  std::vector<mars::CoreType> reference(num_instances);
+  for (int n = 0; n < num_instances; n++)
+  {
+    reference[n] = random_core(n);
+    batch.set_core(n, reference[n]);
+  }
+
+  using Clock = std::chrono::steady_clock;
+
+  const Clock::time_point batch_start = Clock::now();
+  for (int k = 0; k < num_steps; k++)
+  {
+    batch.Propagate(imu_meas(k), dt);
+  }
+  const double batch_time = std::chrono::duration<double>(Clock::now() - batch_start).count();
+
+  const Clock::time_point single_start = Clock::now();
+  for (int k = 0; k < num_steps; k++)
+  {
+    const mars::IMUMeasurementType meas = imu_meas(k);
+    for (int n = 0; n < num_instances; n++)
+    {
+      mars::CoreType propagated = core_states_sptr->PredictProcessCovariance(reference[n], meas, dt);
+      propagated.state_ = core_states_sptr->PropagateState(reference[n].state_, meas, dt);
+      reference[n] = propagated;
+    }
+  }
+  const double single_time = std::chrono::duration<double>(Clock::now() - single_start).count();
+
+  const double steps = static_cast<double>(num_steps * num_instances);
+  std::cout << "Propagation per instance and step [us]: batch=" << batch_time / steps * 1e6
+            << " single=" << single_time / steps * 1e6 << std::endl;
+
+  EXPECT_TRUE(batch.get_core(num_instances - 1).cov_.isApprox(reference[num_instances - 1].cov_, 1e-10));
+}
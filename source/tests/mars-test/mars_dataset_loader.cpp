@@ -0,0 +1,246 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/data_utils/dataset_loader.h>
+#include <mars/data_utils/filesystem.h>
+#include <mars/data_utils/read_baro_data.h>
+#include <mars/data_utils/read_gps_w_vel_data.h>
+#include <mars/data_utils/read_imu_data.h>
+#include <mars/data_utils/read_mag_data.h>
+#include <mars/data_utils/read_pose_data.h>
+#include <mars/data_utils/scenario_generator.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class mars_dataset_loader_test : public testing::Test
+{
+public:
+  static mars::StreamReader make_reader(const std::shared_ptr<mars::SensorAbsClass>& sensor,
+                                        const std::vector<double>& timestamps)
+  {
+    return [sensor, timestamps](std::vector<mars::BufferEntryType>* data) {
+      for (const auto& t : timestamps)
+      {
+        data->emplace_back(t, mars::BufferDataType(), sensor);
+      }
+    };
+  }
+
+  static std::vector<double> timestamps(const double& t_start, const double& dt, const int& num)
+  {
+    std::vector<double> result;
+    for (int k = 0; k < num; k++)
+    {
+      result.push_back(t_start + k * dt);
+    }
+    return result;
+  }
+
+  static std::string tmp_path(const std::string& name)
+  {
+    return "/tmp/mars_dataset_loader_" + name + "_" + std::to_string(getpid());
+  }
+};
+
+TEST_F(mars_dataset_loader_test, MERGE_ORDER)
+{
+  std::shared_ptr<mars::ImuSensorClass> imu = std::make_shared<mars::ImuSensorClass>("IMU");
+  std::shared_ptr<mars::ImuSensorClass> pose = std::make_shared<mars::ImuSensorClass>("Pose");
+  std::shared_ptr<mars::ImuSensorClass> baro = std::make_shared<mars::ImuSensorClass>("Baro");
+
+  mars::DatasetLoader loader(2);
+  EXPECT_EQ(loader.AddStream("IMU", make_reader(imu, timestamps(0, 0.01, 101))), 0);
+  EXPECT_EQ(loader.AddStream("Pose", make_reader(pose, timestamps(0.05, 0.1, 10))), 1);
+  EXPECT_EQ(loader.AddStream("Baro", make_reader(baro, { 0.5, 0.2, 0.35, 0.2 })), 2);
+  EXPECT_EQ(loader.AddStream("Empty", make_reader(baro, {})), 3);
+  EXPECT_TRUE(loader.Load());
+  EXPECT_GE(loader.get_load_time(), 0);
+
+  // Unsorted streams are sorted, the others are kept as read
+  ASSERT_EQ(loader.get_stream_info().size(), 4);
+  EXPECT_TRUE(loader.get_stream_info()[0].error_.empty());
+  EXPECT_TRUE(loader.get_stream_info()[0].was_sorted_);
+  EXPECT_FALSE(loader.get_stream_info()[2].was_sorted_);
+  EXPECT_EQ(loader.get_stream_info()[2].num_entries_, 4);
+  EXPECT_EQ(loader.get_stream(2).front().timestamp_, mars::Time(0.2));
+  EXPECT_EQ(loader.get_num_entries(), 115);
+  EXPECT_EQ(loader.get_start_time(), mars::Time(0));
+
+  // The merge matches the stable sort of the concatenated streams, ties are ordered by the stream index
+  std::vector<mars::BufferEntryType> expected;
+  for (int k = 0; k < 4; k++)
+  {
+    expected.insert(expected.end(), loader.get_stream(k).begin(), loader.get_stream(k).end());
+  }
+  std::stable_sort(expected.begin(), expected.end());
+
+  mars::DatasetMerger merger = loader.get_merger();
+  EXPECT_EQ(merger.get_num_remaining(), 115);
+
+  mars::BufferEntryType entry;
+  for (const auto& k : expected)
+  {
+    ASSERT_TRUE(merger.Next(&entry));
+    EXPECT_EQ(entry.timestamp_, k.timestamp_);
+    EXPECT_EQ(entry.sensor_handle_, k.sensor_handle_);
+  }
+  EXPECT_FALSE(merger.Next(&entry));
+  EXPECT_EQ(merger.get_num_remaining(), 0);
+
+  // Time range
+  mars::DatasetMerger range = loader.get_merger(0.195, 0.355);
+  EXPECT_EQ(range.get_num_remaining(), 16 + 2 + 3);
+
+  std::vector<double> range_timestamps;
+  while (range.Next(&entry))
+  {
+    range_timestamps.push_back(entry.timestamp_.get_seconds());
+  }
+  ASSERT_EQ(range_timestamps.size(), 21);
+  EXPECT_NEAR(range_timestamps.front(), 0.2, 1e-9);
+  EXPECT_NEAR(range_timestamps.back(), 0.35, 1e-9);
+  EXPECT_TRUE(std::is_sorted(range_timestamps.begin(), range_timestamps.end()));
+}
+
+TEST_F(mars_dataset_loader_test, LOAD_FAILURE)
+{
+  std::shared_ptr<mars::ImuSensorClass> imu = std::make_shared<mars::ImuSensorClass>("IMU");
+  std::shared_ptr<mars::ImuSensorClass> pose = std::make_shared<mars::ImuSensorClass>("Pose");
+
+  // A missing file must not terminate the process from a worker, the other streams are still loaded
+  mars::DatasetLoader loader(2);
+  loader.AddStream("IMU", make_reader(imu, timestamps(0, 0.01, 101)));
+  loader.AddStream("Pose", [&pose](std::vector<mars::BufferEntryType>* data) {
+    mars::ReadPoseData(data, pose, tmp_path("missing") + ".csv");
+  });
+  EXPECT_FALSE(loader.Load());
+
+  ASSERT_EQ(loader.get_stream_info().size(), 2);
+  EXPECT_TRUE(loader.get_stream_info()[0].error_.empty());
+  EXPECT_EQ(loader.get_stream_info()[0].num_entries_, 101);
+  EXPECT_FALSE(loader.get_stream_info()[1].error_.empty());
+  EXPECT_EQ(loader.get_stream_info()[1].num_entries_, 0);
+  EXPECT_EQ(loader.get_num_entries(), 101);
+
+  // PrintInfo restores the format of std::cout
+  const std::ios::fmtflags flags = std::cout.flags();
+  const std::streamsize precision = std::cout.precision();
+  loader.PrintInfo();
+  EXPECT_EQ(std::cout.flags(), flags);
+  EXPECT_EQ(std::cout.precision(), precision);
+}
+
+TEST_F(mars_dataset_loader_test, LOAD_TIME)
+{
+  mars::ScenarioConfig config;
+  config.duration_ = 60;
+  mars::ScenarioGenerator generator(config);
+
+  // Sensor setup of the INSANE dataset example
+  const std::vector<std::pair<mars::ScenarioSensorType, std::string>> sensors = {
+    { mars::ScenarioSensorType::imu, "imu" },         { mars::ScenarioSensorType::gps_w_vel, "gps1" },
+    { mars::ScenarioSensorType::gps_w_vel, "gps2" },  { mars::ScenarioSensorType::gps_w_vel, "gps3" },
+    { mars::ScenarioSensorType::mag, "mag1" },        { mars::ScenarioSensorType::mag, "mag2" },
+    { mars::ScenarioSensorType::pose, "pose1" },      { mars::ScenarioSensorType::pose, "pose2" },
+    { mars::ScenarioSensorType::pressure, "baro1" },
+  };
+
+  std::vector<std::shared_ptr<mars::SensorAbsClass>> handles;
+  for (const auto& k : sensors)
+  {
+    mars::ScenarioSensorConfig sensor;
+    sensor.type_ = k.first;
+    sensor.name_ = k.second;
+    sensor.rate_ = k.first == mars::ScenarioSensorType::imu ? 400 : 20;
+    generator.AddSensor(sensor);
+    handles.push_back(std::make_shared<mars::ImuSensorClass>(k.second));
+  }
+  generator.Generate();
+
+  const std::string directory = tmp_path("csv");
+  ASSERT_TRUE(mars::filesystem::MakeDir(directory));
+  ASSERT_TRUE(generator.WriteCsv(directory));
+
+  const auto read = [&](const size_t& idx, std::vector<mars::BufferEntryType>* data) {
+    const std::string file = directory + "/" + sensors[idx].second + ".csv";
+    switch (sensors[idx].first)
+    {
+      case mars::ScenarioSensorType::imu:
+        mars::ReadImuData(data, handles[idx], file);
+        break;
+      case mars::ScenarioSensorType::gps_w_vel:
+        mars::ReadGpsWithVelData(data, handles[idx], file);
+        break;
+      case mars::ScenarioSensorType::mag:
+        mars::ReadMagData(data, handles[idx], file);
+        break;
+      case mars::ScenarioSensorType::pose:
+        mars::ReadPoseData(data, handles[idx], file);
+        break;
+      default:
+        mars::ReadBarometerData(data, handles[idx], file);
+        break;
+    }
+  };
+
+  // Current approach: sequential reads, concatenation and sort of all measurements
+  auto start = std::chrono::steady_clock::now();
+  std::vector<mars::BufferEntryType> measurement_data;
+  for (size_t k = 0; k < sensors.size(); k++)
+  {
+    std::vector<mars::BufferEntryType> data;
+    read(k, &data);
+    measurement_data.insert(measurement_data.end(), data.begin(), data.end());
+  }
+  std::sort(measurement_data.begin(), measurement_data.end());
+  const double sequential_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // Parallel reads and lazy merge of the sensor streams
+  start = std::chrono::steady_clock::now();
+  mars::DatasetLoader loader;
+  for (size_t k = 0; k < sensors.size(); k++)
+  {
+    loader.AddStream(sensors[k].second, [&read, k](std::vector<mars::BufferEntryType>* data) { read(k, data); });
+  }
+  loader.Load();
+
+  mars::DatasetMerger merger = loader.get_merger();
+  ASSERT_EQ(merger.get_num_remaining(), measurement_data.size());
+
+  mars::BufferEntryType entry;
+  size_t num_entries = 0;
+  while (merger.Next(&entry))
+  {
+    ASSERT_EQ(entry.timestamp_, measurement_data[num_entries].timestamp_);
+    num_entries++;
+  }
+  const double parallel_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  loader.PrintInfo();
+  std::cout << "Load of " << num_entries << " measurements, sequential and sort: " << sequential_time
+            << "s, parallel and merge: " << parallel_time << "s" << std::endl;
+  EXPECT_EQ(num_entries, measurement_data.size());
+
+  for (const auto& k : sensors)
+  {
+    std::remove((directory + "/" + k.second + ".csv").c_str());
+  }
+  std::remove((directory + "/traj.csv").c_str());
+  rmdir(directory.c_str());
+}
@@ -28,3 +28,36 @@ TEST_F(mars_Ekf_test, CTOR_EKF)
   test.CalculateCorrection();
   test.CalculateCovUpdate();
 }
+
+TEST_F(mars_Ekf_test, REUSED_EKF)
+{
+  // Random full rank update of a symmetric positive definite covariance
+  const Eigen::MatrixXd H = Eigen::MatrixXd::Random(3, 6);
+  const Eigen::MatrixXd R = Eigen::MatrixXd::Identity(3, 3) * 0.1;
+  const Eigen::MatrixXd A = Eigen::MatrixXd::Random(6, 6);
+  const Eigen::MatrixXd P = A * A.transpose() + Eigen::MatrixXd::Identity(6, 6);
+  mars::Chi2 chi2_value;
+  mars::Chi2 chi2_reused;
+  chi2_value.set_dof(3);
+  chi2_reused.set_dof(3);
+
+  mars::Ekf reused;
+  Eigen::MatrixXd correction;
+  Eigen::MatrixXd cov;
+  for (int k = 0; k < 3; k++)
+  {
+    const Eigen::MatrixXd res = Eigen::MatrixXd::Random(3, 1);
+
+    mars::Ekf ekf(H, R, res, P);
+    const Eigen::MatrixXd correction_value = ekf.CalculateCorrection(&chi2_value);
+    const Eigen::MatrixXd cov_value = ekf.CalculateCovUpdate();
+
+    reused.set_inputs(H, R, res, P);
+    reused.CalculateCorrection(&chi2_reused, &correction);
+    reused.CalculateCovUpdate(&cov);
+
+    EXPECT_TRUE(correction.isApprox(correction_value));
+    EXPECT_TRUE(cov.isApprox(cov_value));
+    EXPECT_EQ(chi2_reused.passed_, chi2_value.passed_);
+  }
+}
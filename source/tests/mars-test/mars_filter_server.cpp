@@ -0,0 +1,181 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/filter_server.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class mars_filter_server_test : public testing::Test
+{
+public:
+  struct StreamSetup
+  {
+    std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr;
+    std::shared_ptr<mars::CoreLogic> core_logic;
+  };
+
+  static StreamSetup make_stream()
+  {
+    StreamSetup setup;
+    std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>();
+    setup.imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+    core_states_sptr->set_propagation_sensor(setup.imu_sensor_sptr);
+    core_states_sptr->set_initial_covariance(Eigen::Vector3d::Ones(), Eigen::Vector3d::Ones(),
+                                             Eigen::Vector3d::Ones(), Eigen::Vector3d::Ones(),
+                                             Eigen::Vector3d::Ones());
+
+    setup.core_logic = std::make_shared<mars::CoreLogic>(core_states_sptr);
+
+    // The first measurement is required to initialize the filter
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0, 0, 9.81), Eigen::Vector3d::Zero());
+    setup.core_logic->ProcessMeasurement(setup.imu_sensor_sptr, 0,
+                                         mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas)));
+    setup.core_logic->Initialize(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data(const int& stream_idx, const int& k)
+  {
+    const double s = 0.01 * stream_idx;
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(s, -s, 9.81 + 0.001 * k), Eigen::Vector3d(0, s, 0.1));
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  static mars::CoreStateType latest_core_state(const std::shared_ptr<mars::CoreLogic>& core_logic)
+  {
+    mars::BufferEntryType latest_entry;
+    core_logic->buffer_.get_latest_state(&latest_entry);
+    return static_cast<mars::CoreType*>(latest_entry.data_.core_state_.get())->state_;
+  }
+};
+
+TEST_F(mars_filter_server_test, ADD_STREAM_SUBMIT)
+{
+  mars::FilterServer server(2);
+  ASSERT_EQ(server.get_num_threads(), 2);
+
+  StreamSetup setup = make_stream();
+  ASSERT_TRUE(server.AddStream(3, setup.core_logic));
+  ASSERT_FALSE(server.AddStream(3, setup.core_logic));
+  ASSERT_FALSE(server.AddStream(4, nullptr));
+
+  ASSERT_EQ(server.get_core_logic(3), setup.core_logic);
+  ASSERT_EQ(server.get_core_logic(4), nullptr);
+
+  // Unknown streams are rejected
+  ASSERT_FALSE(server.Submit(4, setup.imu_sensor_sptr, 0.01, imu_data(0, 1)));
+  ASSERT_TRUE(server.Submit(3, setup.imu_sensor_sptr, 0.01, imu_data(0, 1)));
+
+  server.WaitIdle();
+
+  mars::FilterStreamStats stats;
+  ASSERT_FALSE(server.get_stream_stats(4, &stats));
+  ASSERT_TRUE(server.get_stream_stats(3, &stats));
+  EXPECT_EQ(stats.backlog_, 0);
+  EXPECT_EQ(stats.num_processed_, 1);
+  EXPECT_EQ(stats.num_rejected_, 0);
+  EXPECT_GE(stats.latency_max_, stats.latency_last_);
+
+  // No measurements are accepted once the server is stopped
+  server.Stop();
+  ASSERT_FALSE(server.Submit(3, setup.imu_sensor_sptr, 0.02, imu_data(0, 2)));
+}
+
+TEST_F(mars_filter_server_test, MULTI_STREAM_MATCHES_SEQUENTIAL)
+{
+  const int num_streams = 12;
+  const int num_meas = 200;
+
+  mars::FilterServer server(4);
+  server.max_batch_size_ = 16;
+
+  std::vector<StreamSetup> server_streams;
+  std::vector<StreamSetup> reference_streams;
+
+  for (int s = 0; s < num_streams; s++)
+  {
+    server_streams.push_back(make_stream());
+    reference_streams.push_back(make_stream());
+    ASSERT_TRUE(server.AddStream(s, server_streams.back().core_logic));
+  }
+
+  // Interleave the streams as they would arrive from multiple vehicles
+  for (int k = 1; k <= num_meas; k++)
+  {
+    for (int s = 0; s < num_streams; s++)
+    {
+      ASSERT_TRUE(server.Submit(s, server_streams[s].imu_sensor_sptr, 0.01 * k, imu_data(s, k)));
+      reference_streams[s].core_logic->ProcessMeasurement(reference_streams[s].imu_sensor_sptr, 0.01 * k,
+                                                          imu_data(s, k));
+    }
+  }
+
+  server.WaitIdle();
+
+  for (int s = 0; s < num_streams; s++)
+  {
+    mars::FilterStreamStats stats;
+    ASSERT_TRUE(server.get_stream_stats(s, &stats));
+    EXPECT_EQ(stats.backlog_, 0);
+    EXPECT_EQ(stats.num_processed_, num_meas);
+    EXPECT_EQ(stats.num_rejected_, 0);
+    EXPECT_GE(stats.num_batches_, 1);
+    EXPECT_LE(stats.num_batches_, num_meas);
+
+    // Per stream processing order is preserved, the result is identical to the sequential filter
+    const mars::CoreStateType server_state = latest_core_state(server_streams[s].core_logic);
+    const mars::CoreStateType reference_state = latest_core_state(reference_streams[s].core_logic);
+    EXPECT_EQ(server_state.p_wi_, reference_state.p_wi_);
+    EXPECT_EQ(server_state.v_wi_, reference_state.v_wi_);
+    EXPECT_EQ(server_state.q_wi_.coeffs(), reference_state.q_wi_.coeffs());
+  }
+}
+
+TEST_F(mars_filter_server_test, SUBMIT_CONCURRENT_TO_STOP)
+{
+  // Measurements which are accepted while the server stops are processed before Stop() returns
+  for (int run = 0; run < 20; run++)
+  {
+    mars::FilterServer server(2);
+    StreamSetup setup = make_stream();
+    ASSERT_TRUE(server.AddStream(0, setup.core_logic));
+
+    std::atomic<uint64_t> num_accepted{ 0 };
+    std::thread producer([&server, &setup, &num_accepted]() {
+      for (int k = 1; server.Submit(0, setup.imu_sensor_sptr, 0.01 * k, imu_data(0, k)); k++)
+      {
+        num_accepted++;
+      }
+    });
+
+    std::this_thread::sleep_for(std::chrono::microseconds(50 * run));
+    server.Stop();
+    producer.join();
+
+    mars::FilterStreamStats stats;
+    ASSERT_TRUE(server.get_stream_stats(0, &stats));
+    EXPECT_EQ(stats.num_processed_, num_accepted.load());
+    EXPECT_EQ(stats.backlog_, 0);
+
+    // Nothing is pending after the stop
+    server.WaitIdle();
+  }
+}
@@ -0,0 +1,219 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/fixed_lag_smoother.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_fixed_lag_smoother_test : public testing::Test
+{
+public:
+  static mars_test::ScenarioFilter make_filter()
+  {
+    mars_test::ScenarioFilterConfig config = mars_test::ImuPoseTestConfig();
+    config.p_cov_.setConstant(0.1);
+    config.v_cov_.setConstant(0.1);
+    config.q_cov_.setConstant(0.1);
+    config.bw_cov_.setConstant(0.01);
+    config.ba_cov_.setConstant(0.01);
+    config.position_meas_std_ = 0.05;
+    config.orientation_meas_std_ = 0.02;
+    config.calib_cov_ = 1e-6;
+    config.chi2_test_ = false;
+
+    mars_test::ScenarioFilter setup(config);
+    setup.AddPoseSensor("Pose");
+    setup.core_logic_->buffer_.set_max_buffer_size(5000);
+    setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 0, imu_data());
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data()
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0, 0, 9.81), Eigen::Vector3d::Zero());
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  ///
+  /// \brief pose_data Noisy position measurement of a static platform at the origin
+  ///
+  static mars::BufferDataType pose_data(std::mt19937* generator)
+  {
+    std::normal_distribution<double> noise(0, 0.05);
+    const Eigen::Vector3d p(noise(*generator), noise(*generator), noise(*generator));
+    const mars::PoseMeasurementType pose_meas(p, Eigen::Quaterniond::Identity());
+    return mars::BufferDataType(std::make_shared<mars::PoseMeasurementType>(pose_meas));
+  }
+
+  ///
+  /// \brief run_filter Runs 'num_imu' epochs of 100Hz IMU and 10Hz pose measurements after the initialization
+  ///
+  static void run_filter(const mars_test::ScenarioFilter& setup, const int& num_imu)
+  {
+    std::mt19937 generator(42);
+    setup.core_logic_->Initialize(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+
+    for (int k = 1; k <= num_imu; k++)
+    {
+      const double t = 0.01 * k;
+      setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, t, imu_data());
+
+      if (k % 10 == 0)
+      {
+        setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], t, pose_data(&generator));
+      }
+    }
+  }
+
+  static const mars::CoreType& core(const mars::BufferEntryType& entry)
+  {
+    return *static_cast<const mars::CoreType*>(entry.data_.core_state_.get());
+  }
+};
+
+TEST_F(mars_fixed_lag_smoother_test, SMOOTHING_REDUCES_ERROR)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+
+  mars::FixedLagSmoother smoother(0.5);
+  smoother.propagation_sensor_ = setup.imu_sensor_sptr_;
+
+  std::vector<mars::BufferEntryType> smoothed;
+  smoother.callback_ = [&smoothed](const mars::BufferEntryType& entry) { smoothed.push_back(entry); };
+
+  std::vector<mars::BufferEntryType> filtered;
+  setup.core_logic_->AddStateObserver([&filtered](const mars::BufferEntryType& entry, const bool&) {
+    filtered.push_back(entry);
+  });
+  setup.core_logic_->AddStateObserver(smoother.get_observer());
+
+  run_filter(setup, 1000);
+
+  // The lag keeps the newest half second in the window
+  smoother.ProcessPending();
+  ASSERT_GT(smoother.get_num_smoothed(), 0);
+  ASSERT_LT(smoother.get_num_smoothed(), filtered.size());
+  ASSERT_LE(smoothed.back().timestamp_.get_seconds(), 10.0 - 0.5 + 1e-9);
+
+  smoother.Flush();
+  ASSERT_EQ(smoothed.size(), filtered.size());
+  ASSERT_EQ(smoother.get_num_dropped(), 0);
+
+  // Compare the position errors w.r.t. the static ground truth after the convergence, the newest state is not smoothed
+  double filtered_error = 0;
+  double smoothed_error = 0;
+  int num_compared = 0;
+  for (size_t k = 0; k < smoothed.size() - 1; k++)
+  {
+    ASSERT_EQ(smoothed[k].timestamp_, filtered[k].timestamp_);
+    ASSERT_EQ(smoothed[k].sensor_handle_, filtered[k].sensor_handle_);
+
+    const mars::CoreStateMatrix& P_f = core(filtered[k]).cov_;
+    const mars::CoreStateMatrix& P_s = core(smoothed[k]).cov_;
+    ASSERT_LE(P_s.trace(), P_f.trace() * (1 + 1e-9));
+
+    if (filtered[k].timestamp_.get_seconds() > 2.0)
+    {
+      filtered_error += core(filtered[k]).state_.p_wi_.squaredNorm();
+      smoothed_error += core(smoothed[k]).state_.p_wi_.squaredNorm();
+      num_compared++;
+    }
+  }
+
+  ASSERT_GT(num_compared, 0);
+  ASSERT_LT(smoothed_error, 0.8 * filtered_error);
+}
+
+TEST_F(mars_fixed_lag_smoother_test, BACKGROUND_THREAD)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+
+  mars::FixedLagSmoother smoother(0.2);
+  smoother.propagation_sensor_ = setup.imu_sensor_sptr_;
+  smoother.output_queue_ = std::make_shared<mars::StateEventQueue>(2000);
+  setup.core_logic_->AddStateObserver(smoother.get_observer());
+
+  ASSERT_TRUE(smoother.Start());
+  ASSERT_FALSE(smoother.Start());
+  run_filter(setup, 1000);
+  smoother.Stop();
+  ASSERT_FALSE(smoother.IsRunning());
+
+  smoother.Flush();
+
+  // One smoothed state for each of the 1001 IMU and 100 pose states
+  ASSERT_EQ(smoother.get_num_smoothed(), 1101);
+  ASSERT_EQ(smoother.output_queue_->get_size(), 1101);
+
+  mars::StateEvent event;
+  mars::Time previous(-1);
+  while (smoother.output_queue_->Pop(&event))
+  {
+    ASSERT_TRUE(event.entry_.data_.HasCoreStates());
+    ASSERT_GE(event.entry_.timestamp_, previous);
+    previous = event.entry_.timestamp_;
+  }
+}
+
+TEST_F(mars_fixed_lag_smoother_test, REWORK_REPLACES_STATES)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+
+  mars::FixedLagSmoother smoother(100);
+  smoother.propagation_sensor_ = setup.imu_sensor_sptr_;
+
+  std::vector<mars::BufferEntryType> smoothed;
+  smoother.callback_ = [&smoothed](const mars::BufferEntryType& entry) { smoothed.push_back(entry); };
+  setup.core_logic_->AddStateObserver(smoother.get_observer());
+
+  run_filter(setup, 300);
+
+  // Out of order pose measurement between two IMU epochs
+  std::mt19937 generator(7);
+  setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 2.505, pose_data(&generator));
+  ASSERT_EQ(setup.core_logic_->get_rework_stats().num_reworks_, 1);
+
+  smoother.Flush();
+  ASSERT_EQ(smoother.get_num_late_corrections(), 0);
+
+  // The smoothed sequence matches the reworked buffer entry by entry
+  std::vector<mars::BufferEntryType> states;
+  for (int k = 0; k < setup.core_logic_->buffer_.get_length(); k++)
+  {
+    mars::BufferEntryType entry;
+    setup.core_logic_->buffer_.get_entry_at_idx(k, &entry);
+    if (entry.data_.HasCoreStates())
+    {
+      states.push_back(entry);
+    }
+  }
+
+  ASSERT_EQ(smoothed.size(), states.size());
+  for (size_t k = 0; k < states.size(); k++)
+  {
+    ASSERT_EQ(smoothed[k].timestamp_, states[k].timestamp_);
+    ASSERT_EQ(smoothed[k].sensor_handle_, states[k].sensor_handle_);
+  }
+
+  // The newest state is published as filtered
+  ASSERT_TRUE(core(smoothed.back()).state_.p_wi_.isApprox(core(states.back()).state_.p_wi_));
+}
@@ -0,0 +1,221 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/journal_codecs.h>
+#include <mars/flight_recorder.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_flight_recorder_test : public testing::Test
+{
+public:
+  static std::string file_name(const std::string& test_name)
+  {
+    return "/tmp/mars_flight_recorder_" + test_name + "_" + std::to_string(getpid()) + ".bin";
+  }
+
+  static mars_test::ScenarioFilter make_filter()
+  {
+    mars_test::ScenarioFilter setup(mars_test::ImuPoseTestConfig());
+    setup.AddPoseSensor("Pose");
+    setup.core_logic_->buffer_.set_max_buffer_size(200);
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data()
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0, 0, 9.81), Eigen::Vector3d::Zero());
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  static mars::BufferDataType pose_data(const double& t)
+  {
+    const mars::PoseMeasurementType pose_meas(Eigen::Vector3d(0.1 * std::sin(t), 0.05 * std::cos(t), 0.02 * t),
+                                              Eigen::Quaterniond::Identity());
+    return mars::BufferDataType(std::make_shared<mars::PoseMeasurementType>(pose_meas));
+  }
+
+  ///
+  /// \brief run_filter Runs 'num_imu' epochs of 100Hz IMU and 10Hz pose measurements
+  ///
+  static void run_filter(const mars_test::ScenarioFilter& setup, const int& num_imu)
+  {
+    setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 0, imu_data());
+    setup.core_logic_->Initialize(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+
+    for (int k = 1; k <= num_imu; k++)
+    {
+      const double t = 0.01 * k;
+      setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, t, imu_data());
+
+      if (k % 10 == 0)
+      {
+        setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], t, pose_data(t));
+      }
+    }
+  }
+};
+
+TEST_F(mars_flight_recorder_test, SLOTS_FOR_DURATION)
+{
+  // 2 records per IMU step and 3 records per pose update
+  ASSERT_EQ(mars::FlightRecorder::get_num_slots_for_duration(5, 200, 20), 5 * (2 * 200 + 3 * 20));
+  ASSERT_EQ(mars::FlightRecorder::get_num_slots_for_duration(0, 200, 20), 1);
+}
+
+TEST_F(mars_flight_recorder_test, RECORD_LOAD)
+{
+  const std::string name = file_name("record_load");
+  mars_test::ScenarioFilter setup = make_filter();
+
+  mars::FlightRecording recording;
+  ASSERT_FALSE(mars::FlightRecorder::Load(name, &recording));
+
+  std::shared_ptr<mars::FlightRecorder> recorder = std::make_shared<mars::FlightRecorder>(name, 1000);
+  ASSERT_EQ(recorder->RegisterSensor(setup.imu_sensor_sptr_,
+                                     mars::MakeJournalEncoder<mars::IMUMeasurementType>()),
+            0);
+  ASSERT_TRUE(recorder->Open());
+  ASSERT_EQ(recorder->RegisterSensor(setup.pose_sensors_[0],
+                                     mars::MakeJournalEncoder<mars::PoseMeasurementType>()),
+            1);
+  setup.core_logic_->flight_recorder_ = recorder;
+
+  run_filter(setup, 100);
+
+  // 101 IMU measurements and states, 10 pose measurements and states, 9 update decisions (the first pose
+  // measurement initializes the sensor)
+  ASSERT_EQ(recorder->get_write_count(), 231);
+  recorder->Close();
+
+  ASSERT_TRUE(mars::FlightRecorder::Load(name, &recording));
+  ASSERT_EQ(recording.sensor_names_.size(), 2);
+  ASSERT_EQ(recording.sensor_names_[0], "imu");
+  ASSERT_EQ(recording.sensor_names_[1], "Pose");
+  ASSERT_EQ(recording.write_count_, 231);
+  ASSERT_EQ(recording.records_.size(), 231);
+  ASSERT_EQ(recording.num_torn_, 0);
+
+  int num_updates = 0;
+  for (const auto& record : recording.records_)
+  {
+    if (record.type == static_cast<uint32_t>(mars::flight::RecordType::update))
+    {
+      num_updates++;
+      ASSERT_EQ(record.sensor_id, 1);
+      ASSERT_TRUE(record.flags & mars::flight::kFlagChi2Tested);
+      ASSERT_TRUE(record.flags & mars::flight::kFlagUpdateSuccessful);
+      ASSERT_GT(record.ucv, 0);
+    }
+    else if (record.type == static_cast<uint32_t>(mars::flight::RecordType::state))
+    {
+      ASSERT_EQ(record.num_values, 22 + mars::CoreStateType::size_error_);
+      ASSERT_NEAR(Eigen::Map<const Eigen::Vector4d>(record.values + 6).norm(), 1, 1e-9);  // q_wi
+      ASSERT_GT(record.values[22], 0);  // Covariance diagonal
+    }
+    else if (record.sensor_id == 0)
+    {
+      ASSERT_EQ(record.num_values, 6);  // [a_m w_m]
+      ASSERT_DOUBLE_EQ(record.values[2], 9.81);
+    }
+  }
+  ASSERT_EQ(num_updates, 9);
+
+  // Records are ordered
+  for (size_t k = 1; k < recording.records_.size(); k++)
+  {
+    ASSERT_LE(recording.records_[k - 1].wall_ns, recording.records_[k].wall_ns);
+  }
+
+  std::remove(name.c_str());
+}
+
+TEST_F(mars_flight_recorder_test, RING_WRAP)
+{
+  const std::string name = file_name("ring_wrap");
+  mars::FlightRecorder recorder(name, 16);
+  ASSERT_TRUE(recorder.Open());
+
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+  for (int k = 0; k < 100; k++)
+  {
+    recorder.RecordMeasurement(imu_sensor_sptr.get(), k, imu_data());
+  }
+
+  mars::FlightRecording recording;
+  ASSERT_TRUE(mars::FlightRecorder::Load(name, &recording));
+  ASSERT_EQ(recording.write_count_, 100);
+  ASSERT_EQ(recording.records_.size(), 16);
+  ASSERT_EQ(recording.records_.front().timestamp, 84);
+  ASSERT_EQ(recording.records_.back().timestamp, 99);
+  ASSERT_EQ(recording.records_.front().sensor_id, -1);
+
+  std::remove(name.c_str());
+}
+
+TEST_F(mars_flight_recorder_test, SURVIVES_CRASH)
+{
+  const std::string name = file_name("survives_crash");
+
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+
+  if (pid == 0)
+  {
+    // Child: record without closing the recorder and crash
+    mars_test::ScenarioFilter setup = make_filter();
+    std::shared_ptr<mars::FlightRecorder> recorder = std::make_shared<mars::FlightRecorder>(name, 64);
+    recorder->RegisterSensor(setup.imu_sensor_sptr_);
+    recorder->RegisterSensor(setup.pose_sensors_[0]);
+    if (!recorder->Open())
+    {
+      _exit(1);
+    }
+    setup.core_logic_->flight_recorder_ = recorder;
+
+    run_filter(setup, 300);
+    std::raise(SIGKILL);
+  }
+
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFSIGNALED(status));
+
+  mars::FlightRecording recording;
+  ASSERT_TRUE(mars::FlightRecorder::Load(name, &recording));
+  ASSERT_EQ(recording.sensor_names_.size(), 2);
+  ASSERT_EQ(recording.records_.size(), 64);
+  ASSERT_EQ(recording.num_torn_, 0);
+
+  // 301 IMU measurements and states, 30 pose measurements and states, 29 update decisions
+  ASSERT_EQ(recording.write_count_, 2 * 301 + 3 * 30 - 1);
+
+  // The last record is the corrected state of the final pose update at t=3s
+  const mars::flight::FlightRecord& last = recording.records_.back();
+  ASSERT_EQ(last.type, static_cast<uint32_t>(mars::flight::RecordType::state));
+  ASSERT_EQ(last.sensor_id, 1);
+  ASSERT_NEAR(last.timestamp, 3.0, 1e-9);
+
+  std::remove(name.c_str());
+}
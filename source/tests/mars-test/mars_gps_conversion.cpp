@@ -39,6 +39,27 @@ TEST_F(mars_gps_test, CTOR_GPS)
   std::cout << coordinates_3 << std::endl;
 }
 
+TEST_F(mars_gps_test, ENU_TO_GPS)
+{
+  mars::GpsCoordinates reference(46.614798, 14.2628073, 18);
+  mars::GpsConversion gps_conversion(reference);
+
+  const Eigen::Matrix<double, 3, 1> enus[] = { Eigen::Vector3d::Zero(), Eigen::Vector3d(-102.48, -179.19, 0.99),
+                                               Eigen::Vector3d(3312.08, 1072.19, -1.95),
+                                               Eigen::Vector3d(-2691.54, 367.66, 250.0) };
+
+  for (const auto& enu : enus)
+  {
+    const mars::GpsCoordinates coordinates = gps_conversion.get_gps(enu);
+    EXPECT_LT((gps_conversion.get_enu(coordinates) - enu).norm(), 1e-6);
+  }
+
+  const mars::GpsCoordinates coordinates = gps_conversion.get_gps(Eigen::Vector3d::Zero());
+  EXPECT_NEAR(coordinates.latitude_, reference.latitude_, 1e-9);
+  EXPECT_NEAR(coordinates.longitude_, reference.longitude_, 1e-9);
+  EXPECT_NEAR(coordinates.altitude_, reference.altitude_, 1e-6);
+}
+
 TEST_F(mars_gps_test, COORDINATE_ADDITION)
 {
   mars::GpsCoordinates coord1(1, 2, 3);
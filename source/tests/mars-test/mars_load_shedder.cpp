@@ -0,0 +1,316 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/load_shedder.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <Eigen/Dense>
+#include <memory>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_load_shedder_test : public testing::Test
+{
+public:
+  static std::shared_ptr<mars::SensorAbsClass> make_sensor(const std::string& name)
+  {
+    std::shared_ptr<mars::SensorAbsClass> sensor = std::make_shared<mars::ImuSensorClass>(name);
+    return sensor;
+  }
+
+  static mars::LoadSheddingPolicy make_policy(const int& priority, const double& nominal_cost,
+                                              const mars::ShedMode& mode = mars::ShedMode::decimate)
+  {
+    mars::LoadSheddingPolicy policy;
+    policy.priority_ = priority;
+    policy.nominal_cost_ = nominal_cost;
+    policy.mode_ = mode;
+    return policy;
+  }
+
+  ///
+  /// \brief run_decimation Runs 10s of 100Hz IMU and update measurements, returns the admission decisions
+  ///
+  static std::vector<bool> run_decimation(mars::LoadShedder* shedder,
+                                          const std::shared_ptr<mars::SensorAbsClass>& imu,
+                                          const std::shared_ptr<mars::SensorAbsClass>& update_sensor,
+                                          const double& measured_cost)
+  {
+    std::vector<bool> decisions;
+    for (int k = 0; k < 1000; k++)
+    {
+      const mars::Time t(0.01 * k);
+      EXPECT_TRUE(shedder->Admit(imu, t, mars::BufferDataType()));
+      shedder->ReportCost(imu, t, measured_cost);
+
+      const bool admitted = shedder->Admit(update_sensor, t, mars::BufferDataType());
+      if (admitted)
+      {
+        shedder->ReportCost(update_sensor, t, measured_cost * (1 + k % 7));
+      }
+      decisions.push_back(admitted);
+    }
+    return decisions;
+  }
+
+  static mars_test::ScenarioFilter make_filter()
+  {
+    mars_test::ScenarioFilter setup(mars_test::ImuPoseTestConfig());
+    setup.AddPoseSensor("Pose");
+    setup.StartAtOrigin(imu_data());
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data()
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0, 0, 9.81), Eigen::Vector3d::Zero());
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  static mars::BufferDataType pose_data()
+  {
+    const mars::PoseMeasurementType pose_meas(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+    return mars::BufferDataType(std::make_shared<mars::PoseMeasurementType>(pose_meas));
+  }
+};
+
+TEST_F(mars_load_shedder_test, SENSORS_WITHOUT_POLICY_ARE_NEVER_SHED)
+{
+  mars::LoadShedder shedder;
+  shedder.cpu_budget_ = 0.1;
+  std::shared_ptr<mars::SensorAbsClass> sensor = make_sensor("Sensor");
+
+  mars::LoadShedderStats stats;
+  ASSERT_FALSE(shedder.get_stats(sensor, &stats));
+
+  for (int k = 0; k < 100; k++)
+  {
+    ASSERT_TRUE(shedder.Admit(sensor, 0.01 * k, mars::BufferDataType()));
+    shedder.ReportCost(sensor, 0.01 * k, 0.1);
+  }
+
+  ASSERT_TRUE(shedder.get_stats(sensor, &stats));
+  EXPECT_EQ(stats.num_admitted_, 100);
+  EXPECT_EQ(stats.num_costs_, 100);
+  EXPECT_DOUBLE_EQ(stats.cost_ema_, 0.1);
+  EXPECT_DOUBLE_EQ(stats.cost_max_, 0.1);
+  EXPECT_LT(shedder.get_tokens(), 0);
+}
+
+TEST_F(mars_load_shedder_test, OVERHEAD)
+{
+  mars::LoadShedder shedder;
+  std::shared_ptr<mars::SensorAbsClass> sensor = make_sensor("Sensor");
+  shedder.ReportCost(sensor, 0, 0.001);
+  const double tokens = shedder.get_tokens();
+
+  // The overhead uses up the budget without changing the cost of a sensor
+  shedder.ReportOverhead(0, 0.05);
+  EXPECT_DOUBLE_EQ(shedder.get_tokens(), tokens - 0.05);
+  EXPECT_DOUBLE_EQ(shedder.get_overhead(), 0.05);
+
+  mars::LoadShedderStats stats;
+  ASSERT_TRUE(shedder.get_stats(sensor, &stats));
+  EXPECT_EQ(stats.num_costs_, 1);
+  EXPECT_DOUBLE_EQ(stats.cost_ema_, 0.001);
+  EXPECT_DOUBLE_EQ(stats.cost_max_, 0.001);
+
+  // The deterministic mode ignores measured times
+  shedder.deterministic_ = true;
+  shedder.ReportOverhead(0, 0.05);
+  EXPECT_DOUBLE_EQ(shedder.get_tokens(), tokens - 0.05);
+  EXPECT_DOUBLE_EQ(shedder.get_overhead(), 0.1);
+}
+
+TEST_F(mars_load_shedder_test, DETERMINISTIC_DECIMATION)
+{
+  std::shared_ptr<mars::SensorAbsClass> imu = make_sensor("IMU");
+  std::shared_ptr<mars::SensorAbsClass> mag = make_sensor("Mag_2");
+
+  // Demand: 100Hz * (1ms + 10ms) = 1.1 CPU seconds per second, budget: 0.5
+  auto make_shedder = [&]() {
+    std::shared_ptr<mars::LoadShedder> shedder = std::make_shared<mars::LoadShedder>();
+    shedder->cpu_budget_ = 0.5;
+    shedder->deterministic_ = true;
+    shedder->set_policy(imu, make_policy(0, 0.001));
+    shedder->set_policy(mag, make_policy(1, 0.01));
+    return shedder;
+  };
+
+  std::shared_ptr<mars::LoadShedder> shedder_a = make_shedder();
+  std::shared_ptr<mars::LoadShedder> shedder_b = make_shedder();
+
+  // Different measured costs, e.g. from different machines, do not change the decisions
+  const std::vector<bool> decisions_a = run_decimation(shedder_a.get(), imu, mag, 0.001);
+  const std::vector<bool> decisions_b = run_decimation(shedder_b.get(), imu, mag, 0.05);
+  EXPECT_EQ(decisions_a, decisions_b);
+
+  mars::LoadShedderStats imu_stats;
+  mars::LoadShedderStats mag_stats;
+  ASSERT_TRUE(shedder_a->get_stats(imu, &imu_stats));
+  ASSERT_TRUE(shedder_a->get_stats(mag, &mag_stats));
+
+  EXPECT_EQ(imu_stats.num_admitted_, 1000);
+  EXPECT_EQ(imu_stats.num_decimated_, 0);
+  EXPECT_EQ(mag_stats.num_admitted_ + mag_stats.num_decimated_, 1000);
+
+  // (0.5 - 0.1) CPU seconds per second remain for 100Hz * 10ms
+  EXPECT_NEAR(mag_stats.num_admitted_, 400, 10);
+  EXPECT_GT(mag_stats.cost_max_, mag_stats.cost_ema_);
+}
+
+TEST_F(mars_load_shedder_test, PRIORITIES)
+{
+  std::shared_ptr<mars::SensorAbsClass> gps_1 = make_sensor("GPS_1");
+  std::shared_ptr<mars::SensorAbsClass> gps_2 = make_sensor("GPS_2");
+
+  mars::LoadShedder shedder;
+  shedder.cpu_budget_ = 0.5;
+  shedder.priority_reserve_ = 0.005;
+  shedder.deterministic_ = true;
+  shedder.set_policy(gps_1, make_policy(1, 0.004));
+  shedder.set_policy(gps_2, make_policy(3, 0.004));
+
+  for (int k = 0; k < 1000; k++)
+  {
+    const mars::Time t(0.01 * k);
+    for (const auto& sensor : { gps_2, gps_1 })
+    {
+      if (shedder.Admit(sensor, t, mars::BufferDataType()))
+      {
+        shedder.ReportCost(sensor, t, 0.004);
+      }
+    }
+  }
+
+  mars::LoadShedderStats stats_1;
+  mars::LoadShedderStats stats_2;
+  shedder.get_stats(gps_1, &stats_1);
+  shedder.get_stats(gps_2, &stats_2);
+
+  // The budget is exhausted, the lower priority sensor is shed first
+  EXPECT_GT(stats_1.num_admitted_, 2 * stats_2.num_admitted_);
+  EXPECT_GT(stats_2.num_decimated_, 0);
+}
+
+TEST_F(mars_load_shedder_test, MAX_SKIP)
+{
+  std::shared_ptr<mars::SensorAbsClass> sensor = make_sensor("Mag");
+
+  mars::LoadShedder shedder;
+  shedder.cpu_budget_ = 0.1;
+  shedder.deterministic_ = true;
+  mars::LoadSheddingPolicy policy = make_policy(1, 0.05);
+  policy.max_skip_ = 4;
+  shedder.set_policy(sensor, policy);
+
+  int num_consecutive_shed = 0;
+  for (int k = 0; k < 200; k++)
+  {
+    if (shedder.Admit(sensor, 0.01 * k, mars::BufferDataType()))
+    {
+      shedder.ReportCost(sensor, 0.01 * k, 0.05);
+      num_consecutive_shed = 0;
+    }
+    else
+    {
+      num_consecutive_shed++;
+    }
+    ASSERT_LE(num_consecutive_shed, 4);
+  }
+}
+
+TEST_F(mars_load_shedder_test, DEFER_AND_EXPIRE)
+{
+  std::shared_ptr<mars::SensorAbsClass> sensor = make_sensor("Vision");
+
+  mars::LoadShedder shedder;
+  shedder.cpu_budget_ = 1.0;
+  shedder.burst_window_ = 0.1;
+  shedder.deterministic_ = true;
+  mars::LoadSheddingPolicy policy = make_policy(1, 0.03, mars::ShedMode::defer);
+  policy.max_defer_age_ = 0.05;
+  shedder.set_policy(sensor, policy);
+
+  // Burst of 10 measurements at the same time, the bucket holds 0.1s of budget for three of them
+  for (int k = 0; k < 10; k++)
+  {
+    if (shedder.Admit(sensor, 1.0, mars::BufferDataType()))
+    {
+      shedder.ReportCost(sensor, 1.0, 0.03);
+    }
+  }
+
+  mars::LoadShedderStats stats;
+  shedder.get_stats(sensor, &stats);
+  EXPECT_EQ(stats.num_admitted_, 3);
+  EXPECT_EQ(stats.num_deferred_, 7);
+  EXPECT_EQ(shedder.get_num_pending(), 7);
+
+  // 30ms later the budget allows one deferred measurement
+  mars::BufferEntryType entry;
+  ASSERT_TRUE(shedder.PopDeferred(1.03, &entry));
+  EXPECT_EQ(entry.timestamp_, mars::Time(1.0));
+  EXPECT_EQ(entry.sensor_handle_, sensor);
+  shedder.ReportCost(sensor, 1.03, 0.03);
+  EXPECT_FALSE(shedder.PopDeferred(1.03, &entry));
+
+  // The remaining measurements expire
+  EXPECT_FALSE(shedder.PopDeferred(1.06, &entry));
+  EXPECT_EQ(shedder.get_num_pending(), 0);
+
+  shedder.get_stats(sensor, &stats);
+  EXPECT_EQ(stats.num_deferred_processed_, 1);
+  EXPECT_EQ(stats.num_expired_, 6);
+}
+
+TEST_F(mars_load_shedder_test, CORE_LOGIC_NEVER_DROPS_PROPAGATION)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+
+  std::shared_ptr<mars::LoadShedder> shedder = std::make_shared<mars::LoadShedder>();
+  shedder->cpu_budget_ = 0.5;
+  shedder->deterministic_ = true;
+  shedder->set_policy(setup.imu_sensor_sptr_, make_policy(0, 0.001));
+  shedder->set_policy(setup.pose_sensors_[0], make_policy(1, 0.02));
+  setup.core_logic_->load_shedder_ = shedder;
+  setup.core_logic_->buffer_.set_max_buffer_size(2000);
+
+  int num_pose_processed = 0;
+  for (int k = 1; k <= 500; k++)
+  {
+    ASSERT_TRUE(setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 0.01 * k, imu_data()));
+    if (setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 0.01 * k, pose_data()))
+    {
+      num_pose_processed++;
+    }
+  }
+
+  mars::LoadShedderStats imu_stats;
+  mars::LoadShedderStats pose_stats;
+  ASSERT_TRUE(shedder->get_stats(setup.imu_sensor_sptr_, &imu_stats));
+  ASSERT_TRUE(shedder->get_stats(setup.pose_sensors_[0], &pose_stats));
+
+  // All propagation steps are processed, their cost is accounted
+  EXPECT_EQ(imu_stats.num_costs_, 500);
+  EXPECT_EQ(pose_stats.num_admitted_, num_pose_processed);
+  EXPECT_EQ(pose_stats.num_admitted_ + pose_stats.num_decimated_, 500);
+
+  // (0.5 - 0.1) CPU seconds per second remain for 100Hz * 20ms
+  EXPECT_NEAR(pose_stats.num_admitted_, 100, 5);
+
+  // One entry per processed measurement, plus the initial propagation entry
+  EXPECT_EQ(setup.core_logic_->buffer_.get_length(), 1 + 500 + num_pose_processed);
+}
@@ -0,0 +1,373 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/journal_codecs.h>
+#include <mars/data_utils/scenario_generator.h>
+#include <mars/mcap_reader.h>
+#include <mars/mcap_writer.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/type_definitions/core_type.h>
+#include <mars/type_definitions/mcap_record.h>
+#include <Eigen/Dense>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_mcap_test : public testing::Test
+{
+public:
+  static mars_test::ScenarioFilter make_filter()
+  {
+    mars_test::ScenarioFilter setup(mars_test::ImuPoseTestConfig());
+    setup.AddPoseSensor("pose");
+    return setup;
+  }
+
+  ///
+  /// \brief generate 200Hz IMU and 20Hz pose measurements in measurement time order
+  ///
+  static std::vector<mars::BufferEntryType> generate(const mars_test::ScenarioFilter& setup)
+  {
+    mars::ScenarioConfig config;
+    config.duration_ = 5;
+
+    mars::ScenarioGenerator generator(config);
+
+    mars::ScenarioSensorConfig imu;
+    imu.type_ = mars::ScenarioSensorType::imu;
+    imu.name_ = "imu";
+    imu.rate_ = 200;
+    generator.AddSensor(imu);
+
+    mars::ScenarioSensorConfig pose;
+    pose.type_ = mars::ScenarioSensorType::pose;
+    pose.name_ = "pose";
+    pose.rate_ = 20;
+    generator.AddSensor(pose);
+
+    generator.Generate();
+    return setup.get_entries(generator);
+  }
+
+  static mars::CoreType latest_core_state(const mars_test::ScenarioFilter& setup)
+  {
+    mars::BufferEntryType latest_entry;
+    setup.core_logic_->buffer_.get_latest_state(&latest_entry);
+    return *static_cast<mars::CoreType*>(latest_entry.data_.core_state_.get());
+  }
+
+  static void append_record(std::vector<uint8_t>* file, const mars::mcap::Opcode& opcode,
+                            const std::vector<uint8_t>& content)
+  {
+    file->push_back(opcode);
+    mars::mcap::AppendLE(file, content.size(), 8);
+    file->insert(file->end(), content.begin(), content.end());
+  }
+
+  static std::vector<uint8_t> message_record(const uint16_t& channel_id, const uint64_t& log_time, const double& value)
+  {
+    std::vector<uint8_t> content;
+    mars::mcap::AppendLE(&content, channel_id, 2);
+    mars::mcap::AppendLE(&content, 0, 4);
+    mars::mcap::AppendLE(&content, log_time, 8);
+    mars::mcap::AppendLE(&content, log_time, 8);
+    mars::mcap::AppendDouble(&content, value);
+    return content;
+  }
+
+  static std::string mcap_file(const std::string& name)
+  {
+    return "/tmp/mars_mcap_test_" + name + ".mcap";
+  }
+};
+
+TEST_F(mars_mcap_test, CRC32)
+{
+  const std::string check = "123456789";
+  EXPECT_EQ(mars::mcap::Crc32(reinterpret_cast<const uint8_t*>(check.data()), check.size()), 0xCBF43926u);
+
+  // Continued computation
+  const uint32_t first = mars::mcap::Crc32(reinterpret_cast<const uint8_t*>(check.data()), 4);
+  EXPECT_EQ(mars::mcap::Crc32(reinterpret_cast<const uint8_t*>(check.data()) + 4, 5, first), 0xCBF43926u);
+}
+
+TEST_F(mars_mcap_test, OVERLAPPING_CHUNKS_IN_TIME_ORDER)
+{
+  const std::string file_name = mcap_file("overlap");
+  const mars_test::ScenarioFilter setup = make_filter();
+  const std::vector<mars::BufferEntryType> entries = generate(setup);
+
+  // All IMU messages are written before the pose messages, the chunks of both topics overlap in time
+  mars::McapWriter writer(file_name, 2048);
+  ASSERT_EQ(writer.AddChannel("/imu", "IMUMeasurementType", mars::MakeJournalEncoder<mars::IMUMeasurementType>()), -1);
+  ASSERT_TRUE(writer.Open());
+  const int imu_channel =
+      writer.AddChannel("/imu", "IMUMeasurementType", mars::MakeJournalEncoder<mars::IMUMeasurementType>());
+  const int pose_channel =
+      writer.AddChannel("/pose", "PoseMeasurementType", mars::MakeJournalEncoder<mars::PoseMeasurementType>());
+  ASSERT_EQ(imu_channel, 0);
+  ASSERT_EQ(pose_channel, 1);
+
+  int num_imu = 0;
+  for (const auto& k : entries)
+  {
+    if (k.sensor_handle_ == setup.imu_sensor_sptr_)
+    {
+      ASSERT_TRUE(writer.Write(imu_channel, k.timestamp_, k.data_.measurement_));
+      num_imu++;
+    }
+  }
+  for (const auto& k : entries)
+  {
+    if (k.sensor_handle_ == setup.pose_sensors_[0])
+    {
+      ASSERT_TRUE(writer.Write(pose_channel, k.timestamp_, k.data_.measurement_));
+    }
+  }
+  EXPECT_FALSE(writer.Write(5, 0, entries.front().data_.measurement_));
+  writer.Close();
+
+  EXPECT_EQ(writer.get_num_messages(), entries.size());
+  EXPECT_GT(writer.get_num_chunks(), 10u);
+
+  mars::McapReader reader(file_name);
+  ASSERT_TRUE(reader.Open());
+  EXPECT_EQ(reader.get_topics(), std::vector<std::string>({ "/imu", "/pose" }));
+  reader.RegisterTopic("/imu", setup.imu_sensor_sptr_, mars::MakeJournalDecoder<mars::IMUMeasurementType>());
+
+  // Unregistered topics are read without payload
+  mars::McapMessage message;
+  size_t num_messages = 0;
+  int num_read_imu = 0;
+  double previous_time = -1;
+  while (reader.ReadNext(&message))
+  {
+    EXPECT_GE(message.timestamp, previous_time);
+    previous_time = message.timestamp;
+
+    if (message.topic == "/imu")
+    {
+      ASSERT_EQ(message.sensor, setup.imu_sensor_sptr_);
+      ASSERT_NE(message.data.measurement_, nullptr);
+      num_read_imu++;
+    }
+    else
+    {
+      EXPECT_EQ(message.topic, "/pose");
+      EXPECT_EQ(message.sensor, nullptr);
+      EXPECT_EQ(message.data.measurement_, nullptr);
+    }
+    num_messages++;
+  }
+
+  EXPECT_EQ(num_messages, entries.size());
+  EXPECT_EQ(num_read_imu, num_imu);
+  EXPECT_EQ(reader.get_num_skipped_chunks(), 0);
+
+  // Payloads are restored exactly
+  mars::McapReader payload_reader(file_name);
+  ASSERT_TRUE(payload_reader.Open());
+  payload_reader.RegisterTopic("/imu", setup.imu_sensor_sptr_, mars::MakeJournalDecoder<mars::IMUMeasurementType>());
+  ASSERT_TRUE(payload_reader.ReadNext(&message));
+  EXPECT_EQ(message.log_time_ns, 0u);
+  EXPECT_TRUE(*static_cast<mars::IMUMeasurementType*>(message.data.measurement_.get()) ==
+              *static_cast<mars::IMUMeasurementType*>(entries.front().data_.measurement_.get()));
+
+  std::remove(file_name.c_str());
+}
+
+TEST_F(mars_mcap_test, REPLAY_AND_STATE_OUTPUT)
+{
+  const std::string input_file = mcap_file("input");
+  const std::string output_file = mcap_file("output");
+
+  // Reference with direct processing
+  const mars_test::ScenarioFilter direct = make_filter();
+  const std::vector<mars::BufferEntryType> entries = generate(direct);
+  {
+    mars::McapWriter writer(input_file, 4096);
+    ASSERT_TRUE(writer.Open());
+    const int imu_channel =
+        writer.AddChannel("/imu", "IMUMeasurementType", mars::MakeJournalEncoder<mars::IMUMeasurementType>());
+    const int pose_channel =
+        writer.AddChannel("/pose", "PoseMeasurementType", mars::MakeJournalEncoder<mars::PoseMeasurementType>());
+
+    for (const auto& k : entries)
+    {
+      const int channel = k.sensor_handle_ == direct.imu_sensor_sptr_ ? imu_channel : pose_channel;
+      ASSERT_TRUE(writer.Write(channel, k.timestamp_, k.data_.measurement_));
+    }
+  }
+
+  direct.core_logic_->ProcessMeasurement(entries.front().sensor_handle_, entries.front().timestamp_,
+                                        entries.front().data_);
+  direct.core_logic_->Initialize(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+  for (size_t k = 1; k < entries.size(); k++)
+  {
+    direct.core_logic_->ProcessMeasurement(entries[k].sensor_handle_, entries[k].timestamp_, entries[k].data_);
+  }
+
+  // Replay from the file, the filter outputs are written to a second file
+  const mars_test::ScenarioFilter replayed = make_filter();
+  mars::McapReader reader(input_file);
+  ASSERT_TRUE(reader.Open());
+  reader.RegisterTopic("/imu", replayed.imu_sensor_sptr_, mars::MakeJournalDecoder<mars::IMUMeasurementType>());
+  reader.RegisterTopic("/pose", replayed.pose_sensors_[0], mars::MakeJournalDecoder<mars::PoseMeasurementType>());
+
+  mars::McapWriter output(output_file);
+  ASSERT_TRUE(output.Open());
+  const int state_channel = output.AddChannel("/mars/core_state", "CoreType", mars::MakeCoreStateEncoder());
+  replayed.core_logic_->AddStateObserver([&output, &state_channel](const mars::BufferEntryType& entry, const bool&) {
+    output.Write(state_channel, entry.timestamp_, entry.data_.core_state_);
+  });
+
+  mars::McapMessage first;
+  ASSERT_TRUE(reader.ReadNext(&first));
+  replayed.core_logic_->ProcessMeasurement(first.sensor, first.timestamp, first.data);
+  replayed.core_logic_->Initialize(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+  EXPECT_EQ(reader.Replay(replayed.core_logic_.get()), static_cast<int>(entries.size()) - 1);
+  output.Close();
+
+  const mars::CoreType direct_state = latest_core_state(direct);
+  const mars::CoreType replayed_state = latest_core_state(replayed);
+  EXPECT_TRUE(direct_state.state_.p_wi_.isApprox(replayed_state.state_.p_wi_, 1e-6));
+  EXPECT_TRUE(direct_state.state_.v_wi_.isApprox(replayed_state.state_.v_wi_, 1e-6));
+  EXPECT_TRUE(direct_state.state_.q_wi_.coeffs().isApprox(replayed_state.state_.q_wi_.coeffs(), 1e-6));
+  EXPECT_TRUE(direct_state.cov_.isApprox(replayed_state.cov_, 1e-6));
+
+  // The last output is the latest state of the filter
+  mars::McapReader state_reader(output_file);
+  ASSERT_TRUE(state_reader.Open());
+  state_reader.RegisterTopic("/mars/core_state", nullptr, mars::MakeCoreStateDecoder());
+
+  mars::McapMessage message;
+  mars::McapMessage last;
+  uint64_t num_states = 0;
+  while (state_reader.ReadNext(&message))
+  {
+    last = message;
+    num_states++;
+  }
+  EXPECT_EQ(num_states, output.get_num_messages());
+  ASSERT_NE(last.data.measurement_, nullptr);
+
+  const mars::CoreType& written = *static_cast<mars::CoreType*>(last.data.measurement_.get());
+  EXPECT_EQ(written.state_.p_wi_, replayed_state.state_.p_wi_);
+  EXPECT_EQ(written.state_.q_wi_.coeffs(), replayed_state.state_.q_wi_.coeffs());
+  EXPECT_EQ(written.cov_.diagonal(), replayed_state.cov_.diagonal());
+
+  std::remove(input_file.c_str());
+  std::remove(output_file.c_str());
+}
+
+TEST_F(mars_mcap_test, UNCHUNKED_AND_SKIPPED_CHUNKS)
+{
+  const std::string file_name = mcap_file("crafted");
+
+  // File without summary section: unchunked messages, a compressed chunk, a chunk with a CRC mismatch and a channel
+  // with an unsupported message encoding
+  std::vector<uint8_t> file(mars::mcap::kMagic, mars::mcap::kMagic + mars::mcap::kMagicSize);
+
+  std::vector<uint8_t> header;
+  mars::mcap::AppendString(&header, "");
+  mars::mcap::AppendString(&header, "test");
+  append_record(&file, mars::mcap::kHeader, header);
+
+  std::vector<uint8_t> channel;
+  mars::mcap::AppendLE(&channel, 3, 2);
+  mars::mcap::AppendLE(&channel, 0, 2);
+  mars::mcap::AppendString(&channel, "/empty");
+  mars::mcap::AppendString(&channel, mars::mcap::kMessageEncoding);
+  mars::mcap::AppendLE(&channel, 0, 4);
+  append_record(&file, mars::mcap::kChannel, channel);
+
+  std::vector<uint8_t> cdr_channel;
+  mars::mcap::AppendLE(&cdr_channel, 4, 2);
+  mars::mcap::AppendLE(&cdr_channel, 0, 2);
+  mars::mcap::AppendString(&cdr_channel, "/cdr");
+  mars::mcap::AppendString(&cdr_channel, "cdr");
+  mars::mcap::AppendLE(&cdr_channel, 0, 4);
+  append_record(&file, mars::mcap::kChannel, cdr_channel);
+
+  append_record(&file, mars::mcap::kMessage, message_record(3, 1000, 1.0));
+  append_record(&file, mars::mcap::kMessage, message_record(4, 1500, 1.5));
+  append_record(&file, mars::mcap::kMessage, message_record(3, 2000, 2.0));
+
+  for (const std::string& compression : { std::string("lz4"), std::string() })
+  {
+    std::vector<uint8_t> records;
+    append_record(&records, mars::mcap::kMessage, message_record(3, 2500, 99.0));
+
+    std::vector<uint8_t> chunk;
+    mars::mcap::AppendLE(&chunk, 2500, 8);
+    mars::mcap::AppendLE(&chunk, 2500, 8);
+    mars::mcap::AppendLE(&chunk, records.size(), 8);
+    mars::mcap::AppendLE(&chunk, mars::mcap::Crc32(records.data(), records.size()) + 1, 4);
+    mars::mcap::AppendString(&chunk, compression);
+    mars::mcap::AppendLE(&chunk, records.size(), 8);
+    chunk.insert(chunk.end(), records.begin(), records.end());
+    append_record(&file, mars::mcap::kChunk, chunk);
+  }
+
+  append_record(&file, mars::mcap::kMessage, message_record(3, 3000, 3.0));
+  append_record(&file, mars::mcap::kDataEnd, std::vector<uint8_t>(4, 0));
+
+  std::vector<uint8_t> footer(20, 0);
+  append_record(&file, mars::mcap::kFooter, footer);
+  file.insert(file.end(), mars::mcap::kMagic, mars::mcap::kMagic + mars::mcap::kMagicSize);
+
+  std::ofstream(file_name, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+
+  std::shared_ptr<mars::ImuSensorClass> sensor = std::make_shared<mars::ImuSensorClass>("empty");
+  mars::McapReader reader(file_name);
+  ASSERT_TRUE(reader.Open());
+  ASSERT_TRUE(reader.RegisterTopic("/empty", sensor, mars::MakeJournalDecoder<mars::EmptyMeasurementType>()));
+
+  // The channel is not known yet without summary section, its messages are counted as undecoded
+  ASSERT_TRUE(reader.RegisterTopic("/cdr", sensor, mars::MakeJournalDecoder<mars::EmptyMeasurementType>()));
+
+  mars::McapMessage message;
+  std::vector<double> values;
+  while (reader.ReadNext(&message))
+  {
+    if (message.channel_id == 4)
+    {
+      EXPECT_EQ(message.topic, "/cdr");
+      EXPECT_EQ(message.sensor, nullptr);
+      EXPECT_EQ(message.data.measurement_, nullptr);
+      continue;
+    }
+
+    EXPECT_EQ(message.channel_id, 3);
+    EXPECT_EQ(message.sensor, sensor);
+    values.push_back(static_cast<mars::EmptyMeasurementType*>(message.data.measurement_.get())->value_);
+  }
+
+  EXPECT_EQ(values, std::vector<double>({ 1.0, 2.0, 3.0 }));
+  EXPECT_EQ(reader.get_num_skipped_chunks(), 2);
+  EXPECT_EQ(reader.get_num_undecoded_messages(), 1);
+
+  // Known channels with an unsupported encoding are rejected
+  EXPECT_FALSE(reader.RegisterTopic("/cdr", sensor, mars::MakeJournalDecoder<mars::EmptyMeasurementType>()));
+
+  // Files without magic are rejected
+  file[1] = 'X';
+  std::ofstream(file_name, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+  mars::McapReader invalid_reader(file_name);
+  EXPECT_FALSE(invalid_reader.Open());
+
+  std::remove(file_name.c_str());
+}
@@ -0,0 +1,167 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/measurement_age.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/time.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_measurement_age_test : public testing::Test
+{
+public:
+  static mars_test::ScenarioFilter make_filter()
+  {
+    mars_test::ScenarioFilter setup(mars_test::ImuPoseTestConfig());
+    setup.AddPoseSensor("Pose");
+    setup.core_logic_->buffer_.set_max_buffer_size(2000);
+    setup.core_logic_->verbose_out_of_order_ = false;
+    setup.StartAtOrigin(imu_data());
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data()
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0, 0, 9.81), Eigen::Vector3d::Zero());
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  static mars::BufferDataType pose_data(const double& t)
+  {
+    const mars::PoseMeasurementType pose_meas(Eigen::Vector3d(0.1 * std::sin(t), 0.05 * std::cos(t), 0.02 * t),
+                                              Eigen::Quaterniond::Identity());
+    return mars::BufferDataType(std::make_shared<mars::PoseMeasurementType>(pose_meas));
+  }
+};
+
+TEST_F(mars_measurement_age_test, ARRIVAL_TIME_IN_BUFFER)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+
+  // Without arrival time, the time of the call is used
+  const int64_t before = mars::Time::get_wall_time_ns();
+  setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 0.01, imu_data());
+  const int64_t after = mars::Time::get_wall_time_ns();
+
+  mars::BufferEntryType entry;
+  setup.core_logic_->buffer_.get_latest_sensor_handle_measurement(setup.imu_sensor_sptr_, &entry);
+  EXPECT_GE(entry.arrival_ns_, before);
+  EXPECT_LE(entry.arrival_ns_, after);
+
+  // Given arrival times are kept, also by out of order measurements and batches
+  setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 0.02, imu_data(), 1000);
+  setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 0.015, pose_data(0.015), 2000);
+
+  std::vector<mars::BufferEntryType> batch;
+  batch.emplace_back(0.03, imu_data(), setup.imu_sensor_sptr_);
+  batch.back().arrival_ns_ = 3000;
+  setup.core_logic_->ProcessMeasurements(batch);
+
+  std::vector<int64_t> arrivals;
+  for (int k = 0; k < setup.core_logic_->buffer_.get_length(); k++)
+  {
+    setup.core_logic_->buffer_.get_entry_at_idx(k, &entry);
+    if (entry.timestamp_ >= mars::Time(0.015))
+    {
+      arrivals.push_back(entry.arrival_ns_);
+    }
+  }
+  EXPECT_THAT(arrivals, testing::ElementsAre(2000, 1000, 3000));
+}
+
+TEST_F(mars_measurement_age_test, PER_SENSOR_DISTRIBUTIONS)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+
+  // Simulated wall clock, the states are produced 0.2ms after the arrival of a measurement
+  const int64_t base_ns = mars::Time::get_wall_time_ns() + 1000000000;
+  const int64_t processing_ns = 200000;
+  int64_t output_ns = 0;
+
+  mars::MeasurementAgeTracker tracker;
+  setup.core_logic_->AddStateObserver([&](const mars::BufferEntryType& state_entry, const bool& is_correction) {
+    tracker.Observe(state_entry, is_correction, output_ns);
+  });
+
+  // IMU at 100Hz arrives 1ms after the measurement, pose at 10Hz arrives 50ms late and out of order
+  for (int k = 1; k <= 200; k++)
+  {
+    const int64_t imu_arrival = base_ns + k * 10000000 + 1000000;
+    output_ns = imu_arrival + processing_ns;
+    setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 0.01 * k, imu_data(), imu_arrival);
+
+    if (k > 10 && k % 10 == 5)
+    {
+      const double t_pose = 0.01 * (k - 5);
+      const int64_t pose_arrival = imu_arrival + 100000;
+      output_ns = pose_arrival + processing_ns;
+      setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], t_pose, pose_data(t_pose), pose_arrival);
+    }
+  }
+
+  EXPECT_EQ(tracker.get_sensors().size(), 2);
+
+  const mars::MeasurementAgeStats imu = tracker.get_stats(setup.imu_sensor_sptr_);
+  const mars::MeasurementAgeStats pose = tracker.get_stats(setup.pose_sensors_[0]);
+
+  // Each measurement produces its first state after the processing time, the late pose measurement by the rework
+  EXPECT_EQ(imu.processing_.num_samples_, 200);
+  EXPECT_NEAR(imu.processing_.max_, 2e-4, 1e-9);
+  EXPECT_EQ(pose.processing_.num_samples_, 19);
+  EXPECT_NEAR(pose.processing_.max_, 2e-4, 1e-9);
+
+  // The IMU states after a pose measurement are corrected up to 50ms after their arrival
+  EXPECT_GT(imu.rework_.num_samples_, 19 * 4);
+  EXPECT_LE(imu.rework_.max_, 0.0503 + 1e-9);
+  EXPECT_GT(imu.rework_.p50_, 0.01);
+  EXPECT_EQ(pose.rework_.num_samples_, 0);
+
+  // The published estimate contains IMU information which is 0.2ms old and pose information up to 100.1ms old
+  EXPECT_NEAR(imu.age_.max_, 2e-4, 1e-9);
+  EXPECT_GT(pose.age_.max_, 0.09);
+  EXPECT_LE(pose.age_.max_, 0.1001 + 1e-9);
+  EXPECT_GT(pose.age_.num_deadline_misses_, 0);
+
+  tracker.Reset();
+  EXPECT_TRUE(tracker.get_sensors().empty());
+  EXPECT_EQ(tracker.get_stats(setup.imu_sensor_sptr_).processing_.num_samples_, 0);
+}
+
+TEST_F(mars_measurement_age_test, SAMPLE_WINDOW)
+{
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+  mars::MeasurementAgeTracker tracker(10);
+
+  mars::BufferEntryType entry(0, imu_data(), imu_sensor_sptr);
+  for (int k = 1; k <= 100; k++)
+  {
+    entry.arrival_ns_ = k * 1000000;
+    tracker.Observe(entry, false, entry.arrival_ns_ + k * 1000);
+  }
+
+  // Only the latest samples are kept, entries without arrival time are ignored
+  entry.arrival_ns_ = 0;
+  tracker.Observe(entry, false, 1);
+
+  const mars::MeasurementAgeStats stats = tracker.get_stats(imu_sensor_sptr);
+  EXPECT_EQ(stats.processing_.num_samples_, 10);
+  EXPECT_NEAR(stats.processing_.max_, 100e-6, 1e-12);
+  EXPECT_NEAR(stats.processing_.mean_, 95.5e-6, 1e-12);
+}
@@ -0,0 +1,285 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/journal_codecs.h>
+#include <mars/journal_replayer.h>
+#include <mars/measurement_journal.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/time.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_measurement_journal_test : public testing::Test
+{
+public:
+  static mars_test::ScenarioFilter make_filter()
+  {
+    mars_test::ScenarioFilterConfig config = mars_test::ImuPoseTestConfig();
+    config.imu_n_w_.setConstant(0.013);
+    config.imu_n_bw_.setConstant(0.0013);
+    config.imu_n_a_.setConstant(0.083);
+    config.imu_n_ba_.setConstant(0.0083);
+
+    mars_test::ScenarioFilter setup(config);
+    setup.AddPoseSensor("Pose");
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data(const int& k)
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0.1 * std::sin(0.01 * k), 0.05, 9.81),
+                                            Eigen::Vector3d(0.01, -0.02, 0.1 * std::cos(0.02 * k)));
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  static mars::BufferDataType pose_data(const int& k)
+  {
+    const Eigen::Quaterniond orientation(Eigen::AngleAxisd(0.001 * k, Eigen::Vector3d::UnitZ()));
+    const mars::PoseMeasurementType pose_meas(Eigen::Vector3d(0.001 * k, 0.002 * k, 0.01), orientation);
+    return mars::BufferDataType(std::make_shared<mars::PoseMeasurementType>(pose_meas));
+  }
+
+  static std::string journal_file(const std::string& name)
+  {
+    return "/tmp/mars_journal_test_" + name + ".bin";
+  }
+};
+
+TEST_F(mars_measurement_journal_test, CODEC_ROUND_TRIP)
+{
+  double values[mars::journal::kMaxValues];
+
+  // IMU
+  const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(1.0 / 3, 2, 3), Eigen::Vector3d(4, 5, M_PI));
+  const int imu_size =
+      mars::MakeJournalEncoder<mars::IMUMeasurementType>()(std::make_shared<mars::IMUMeasurementType>(imu_meas), values,
+                                                           mars::journal::kMaxValues);
+  ASSERT_EQ(imu_size, 6);
+  const auto imu_result = std::static_pointer_cast<mars::IMUMeasurementType>(
+      mars::MakeJournalDecoder<mars::IMUMeasurementType>()(values, imu_size));
+  EXPECT_TRUE(*imu_result == imu_meas);
+
+  // Pose with dynamic measurement noise
+  std::shared_ptr<mars::PoseMeasurementType> pose_meas = std::make_shared<mars::PoseMeasurementType>(
+      Eigen::Vector3d(1, 2, 3), Eigen::Quaterniond(Eigen::Vector4d::Random()).normalized());
+  pose_meas->set_meas_noise(Eigen::MatrixXd::Random(6, 6));
+  pose_meas->has_meas_noise = true;
+
+  const int pose_size =
+      mars::MakeJournalEncoder<mars::PoseMeasurementType>()(pose_meas, values, mars::journal::kMaxValues);
+  ASSERT_EQ(pose_size, 7 + 2 + 36);
+  const auto pose_result = std::static_pointer_cast<mars::PoseMeasurementType>(
+      mars::MakeJournalDecoder<mars::PoseMeasurementType>()(values, pose_size));
+  EXPECT_EQ(pose_result->position_, pose_meas->position_);
+  EXPECT_EQ(pose_result->orientation_.coeffs(), pose_meas->orientation_.coeffs());
+  EXPECT_TRUE(pose_result->has_meas_noise);
+  EXPECT_EQ(pose_result->meas_noise_, pose_meas->meas_noise_);
+
+  // Noise which does not fit into the payload is rejected
+  EXPECT_EQ(mars::MakeJournalEncoder<mars::PoseMeasurementType>()(pose_meas, values, 20), -1);
+
+  // Pressure, including the type
+  std::shared_ptr<mars::PressureMeasurementType> pressure_meas =
+      std::make_shared<mars::PressureMeasurementType>(101325.5, 293.1, mars::Pressure::Type::LIQUID);
+  const int pressure_size =
+      mars::MakeJournalEncoder<mars::PressureMeasurementType>()(pressure_meas, values, mars::journal::kMaxValues);
+  const auto pressure_result = std::static_pointer_cast<mars::PressureMeasurementType>(
+      mars::MakeJournalDecoder<mars::PressureMeasurementType>()(values, pressure_size));
+  EXPECT_EQ(pressure_result->pressure_.data_, pressure_meas->pressure_.data_);
+  EXPECT_EQ(pressure_result->pressure_.temperature_K_, pressure_meas->pressure_.temperature_K_);
+  EXPECT_TRUE(pressure_result->pressure_.type_ == mars::Pressure::Type::LIQUID);
+
+  // GPS
+  std::shared_ptr<mars::GpsMeasurementType> gps_meas = std::make_shared<mars::GpsMeasurementType>(46.6, 14.26, 500.1);
+  const int gps_size =
+      mars::MakeJournalEncoder<mars::GpsMeasurementType>()(gps_meas, values, mars::journal::kMaxValues);
+  const auto gps_result = std::static_pointer_cast<mars::GpsMeasurementType>(
+      mars::MakeJournalDecoder<mars::GpsMeasurementType>()(values, gps_size));
+  EXPECT_EQ(gps_result->coordinates_.latitude_, 46.6);
+  EXPECT_EQ(gps_result->coordinates_.longitude_, 14.26);
+  EXPECT_EQ(gps_result->coordinates_.altitude_, 500.1);
+
+  // Invalid payloads are rejected
+  EXPECT_EQ(mars::MakeJournalDecoder<mars::IMUMeasurementType>()(values, 5), nullptr);
+}
+
+TEST_F(mars_measurement_journal_test, RECORD_REPLAY_EXACT)
+{
+  const std::string file_name = journal_file("replay");
+
+  mars_test::ScenarioFilter recorded = make_filter();
+  std::shared_ptr<mars::MeasurementJournal> journal = std::make_shared<mars::MeasurementJournal>(file_name, 1024);
+  ASSERT_EQ(journal->RegisterSensor(recorded.imu_sensor_sptr_, mars::MakeJournalEncoder<mars::IMUMeasurementType>()),
+            0);
+  ASSERT_EQ(journal->RegisterSensor(recorded.pose_sensors_[0], mars::MakeJournalEncoder<mars::PoseMeasurementType>()),
+            1);
+  ASSERT_TRUE(journal->Open());
+  ASSERT_EQ(journal->RegisterSensor(recorded.pose_sensors_[0], mars::MakeJournalEncoder<mars::PoseMeasurementType>()),
+            -1);
+  recorded.core_logic_->journal_ = journal;
+
+  // Measurements prior to the initialization, in order, and out of order
+  recorded.core_logic_->ProcessMeasurement(recorded.imu_sensor_sptr_, 0, imu_data(0));
+  recorded.core_logic_->Initialize(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+
+  const int num_imu = 500;
+  int num_calls = 1;
+  for (int k = 1; k <= num_imu; k++)
+  {
+    recorded.core_logic_->ProcessMeasurement(recorded.imu_sensor_sptr_, 0.01 * k, imu_data(k));
+    num_calls++;
+
+    // Pose measurements arrive with a delay of up to three IMU measurements
+    if (k % 10 == 3)
+    {
+      recorded.core_logic_->ProcessMeasurement(recorded.pose_sensors_[0], 0.01 * (k - 3), pose_data(k - 3));
+      num_calls++;
+    }
+  }
+
+  journal->Close();
+  EXPECT_EQ(journal->get_num_recorded(), static_cast<uint64_t>(num_calls));
+  EXPECT_EQ(journal->get_num_written(), static_cast<uint64_t>(num_calls));
+  EXPECT_EQ(journal->get_num_dropped(), 0u);
+
+  // Replay with a new filter instance
+  mars_test::ScenarioFilter replayed = make_filter();
+  mars::JournalReplayer replayer(file_name);
+  ASSERT_TRUE(replayer.Open());
+  ASSERT_EQ(replayer.get_sensor_names(), std::vector<std::string>({ "imu", "Pose" }));
+  ASSERT_TRUE(replayer.RegisterSensor("imu", replayed.imu_sensor_sptr_,
+                                      mars::MakeJournalDecoder<mars::IMUMeasurementType>()));
+  ASSERT_TRUE(replayer.RegisterSensor("Pose", replayed.pose_sensors_[0],
+                                      mars::MakeJournalDecoder<mars::PoseMeasurementType>()));
+  ASSERT_FALSE(replayer.RegisterSensor("GPS", replayed.pose_sensors_[0],
+                                       mars::MakeJournalDecoder<mars::PoseMeasurementType>()));
+
+  // The first call initializes the filter, the remaining calls are reproduced in order
+  mars::JournalEntry first_entry;
+  ASSERT_TRUE(replayer.ReadNext(&first_entry));
+  EXPECT_EQ(first_entry.sensor, replayed.imu_sensor_sptr_);
+  EXPECT_EQ(first_entry.timestamp, 0);
+  EXPECT_GT(first_entry.arrival_ns, 0);
+  replayed.core_logic_->ProcessMeasurement(first_entry.sensor, first_entry.timestamp, first_entry.data,
+                                           first_entry.arrival_ns);
+  replayed.core_logic_->Initialize(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+
+  EXPECT_EQ(replayer.Replay(replayed.core_logic_.get()), num_calls - 1);
+
+  // Bit exact reproduction of the whole buffer, including the arrival times
+  ASSERT_EQ(replayed.core_logic_->buffer_.get_length(), recorded.core_logic_->buffer_.get_length());
+  for (int k = 0; k < recorded.core_logic_->buffer_.get_length(); k++)
+  {
+    mars::BufferEntryType recorded_entry;
+    mars::BufferEntryType replayed_entry;
+    recorded.core_logic_->buffer_.get_entry_at_idx(k, &recorded_entry);
+    replayed.core_logic_->buffer_.get_entry_at_idx(k, &replayed_entry);
+
+    ASSERT_EQ(replayed_entry.timestamp_, recorded_entry.timestamp_);
+    ASSERT_EQ(replayed_entry.metadata_, recorded_entry.metadata_);
+    ASSERT_EQ(replayed_entry.arrival_ns_, recorded_entry.arrival_ns_);
+
+    const mars::CoreType* recorded_core = static_cast<mars::CoreType*>(recorded_entry.data_.core_state_.get());
+    const mars::CoreType* replayed_core = static_cast<mars::CoreType*>(replayed_entry.data_.core_state_.get());
+    ASSERT_EQ(recorded_core == nullptr, replayed_core == nullptr);
+    if (recorded_core != nullptr)
+    {
+      EXPECT_EQ(replayed_core->state_.p_wi_, recorded_core->state_.p_wi_);
+      EXPECT_EQ(replayed_core->state_.q_wi_.coeffs(), recorded_core->state_.q_wi_.coeffs());
+      EXPECT_EQ(replayed_core->cov_, recorded_core->cov_);
+    }
+  }
+
+  std::remove(file_name.c_str());
+}
+
+TEST_F(mars_measurement_journal_test, DROPPED_RECORDS)
+{
+  const std::string file_name = journal_file("dropped");
+
+  mars_test::ScenarioFilter setup = make_filter();
+  mars::MeasurementJournal journal(file_name, 4);
+  journal.RegisterSensor(setup.imu_sensor_sptr_, mars::MakeJournalEncoder<mars::IMUMeasurementType>());
+
+  // Nothing is recorded while the journal is closed
+  EXPECT_FALSE(journal.Record(setup.imu_sensor_sptr_.get(), 0, imu_data(0), mars::Time::get_wall_time_ns()));
+  ASSERT_TRUE(journal.Open());
+
+  // Unknown sensors are counted as dropped
+  EXPECT_FALSE(journal.Record(setup.pose_sensors_[0].get(), 0, pose_data(0), mars::Time::get_wall_time_ns()));
+  EXPECT_EQ(journal.get_num_dropped(), 1u);
+
+  // The filter thread is never blocked, records are dropped if the ring is full
+  const int num_records = 1000;
+  for (int k = 0; k < num_records; k++)
+  {
+    journal.Record(setup.imu_sensor_sptr_.get(), 0.01 * k, imu_data(k), mars::Time::get_wall_time_ns());
+  }
+  journal.Close();
+
+  EXPECT_EQ(journal.get_num_recorded() + journal.get_num_dropped(), static_cast<uint64_t>(num_records + 1));
+  EXPECT_EQ(journal.get_num_written(), journal.get_num_recorded());
+
+  // The journal only contains the recorded calls
+  mars::JournalReplayer replayer(file_name);
+  ASSERT_TRUE(replayer.Open());
+  mars::JournalEntry entry;
+  uint64_t num_entries = 0;
+  double last_timestamp = -1;
+  while (replayer.ReadNext(&entry))
+  {
+    EXPECT_GT(entry.timestamp, last_timestamp);
+    EXPECT_EQ(entry.data.measurement_, nullptr);  // No decoder registered
+    last_timestamp = entry.timestamp;
+    num_entries++;
+  }
+  EXPECT_EQ(num_entries, journal.get_num_recorded());
+
+  std::remove(file_name.c_str());
+}
+
+TEST_F(mars_measurement_journal_test, RECORD_OVERHEAD)
+{
+  const std::string file_name = journal_file("overhead");
+  const int num_records = 100000;
+
+  mars_test::ScenarioFilter setup = make_filter();
+  mars::MeasurementJournal journal(file_name, num_records);
+  journal.RegisterSensor(setup.pose_sensors_[0], mars::MakeJournalEncoder<mars::PoseMeasurementType>());
+  journal.RegisterSensor(setup.imu_sensor_sptr_, mars::MakeJournalEncoder<mars::IMUMeasurementType>());
+  ASSERT_TRUE(journal.Open());
+
+  const mars::BufferDataType data = imu_data(1);
+  const auto start = std::chrono::steady_clock::now();
+  for (int k = 0; k < num_records; k++)
+  {
+    journal.Record(setup.imu_sensor_sptr_.get(), 0.01 * k, data, mars::Time::get_wall_time_ns());
+  }
+  const double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  journal.Close();
+
+  const double ns_per_record = duration / num_records * 1e9;
+  std::cout << "Journal overhead per measurement [ns]: " << ns_per_record << std::endl;
+
+  EXPECT_EQ(journal.get_num_dropped(), 0u);
+  EXPECT_EQ(journal.get_num_written(), static_cast<uint64_t>(num_records));
+  EXPECT_LT(ns_per_record, 2000);
+
+  std::remove(file_name.c_str());
+}
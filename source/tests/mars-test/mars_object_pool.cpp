@@ -0,0 +1,96 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/object_pool.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <memory>
+#include <vector>
+
+class mars_object_pool_test : public testing::Test
+{
+public:
+};
+
+TEST_F(mars_object_pool_test, RECYCLE)
+{
+  mars::ObjectPool<mars::CoreType> pool;
+  pool.Reserve(4);
+  EXPECT_EQ(pool.get_capacity(), 4);
+  EXPECT_EQ(pool.get_num_free(), 4);
+
+  mars::CoreType value;
+  value.cov_ = mars::CoreStateMatrix::Identity();
+
+  const mars::CoreType* address;
+  {
+    std::shared_ptr<mars::CoreType> object = pool.Make(value);
+    address = object.get();
+    EXPECT_EQ(pool.get_num_free(), 3);
+    EXPECT_EQ(object->cov_, value.cov_);
+  }
+
+  // The released object is handed out again
+  EXPECT_EQ(pool.get_num_free(), 4);
+  std::shared_ptr<mars::CoreType> object = pool.Make(value);
+  EXPECT_EQ(object.get(), address);
+
+  // Reserve only grows the pool
+  pool.Reserve(2);
+  EXPECT_EQ(pool.get_capacity(), 4);
+}
+
+TEST_F(mars_object_pool_test, GROW)
+{
+  mars::ObjectPool<mars::CoreType> pool;
+  pool.Reserve(20);
+
+  // Grows beyond the reserved capacity, each object is handed out once
+  std::vector<std::shared_ptr<mars::CoreType>> objects;
+  for (int k = 0; k < 100; k++)
+  {
+    mars::CoreType value;
+    value.cov_ = mars::CoreStateMatrix::Identity() * k;
+    objects.push_back(pool.Make(value));
+  }
+
+  EXPECT_GE(pool.get_capacity(), 100);
+  EXPECT_EQ(pool.get_num_free(), pool.get_capacity() - 100);
+  for (int k = 0; k < 100; k++)
+  {
+    EXPECT_EQ(objects[k]->cov_(0, 0), k);
+  }
+
+  objects.clear();
+  EXPECT_EQ(pool.get_num_free(), pool.get_capacity());
+}
+
+TEST_F(mars_object_pool_test, SHARED_STORAGE)
+{
+  std::shared_ptr<mars::PoseSensorData> object;
+  {
+    mars::ObjectPool<mars::PoseSensorData> pool;
+    mars::ObjectPool<mars::PoseSensorData> pool_copy(pool);
+    pool.Reserve(2);
+    EXPECT_EQ(pool_copy.get_capacity(), 2);
+
+    // Acquire keeps the members of the recycled object
+    object = pool_copy.Acquire();
+    object->sensor_cov_.setIdentity();
+  }
+
+  // Objects outlive the pool
+  EXPECT_EQ(object->sensor_cov_, Eigen::MatrixXd::Identity(6, 6));
+  std::shared_ptr<void> sensor_state(object);
+  object.reset();
+  sensor_state.reset();
+}
@@ -0,0 +1,159 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/scenario_generator.h>
+#include <mars/paced_replayer.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <Eigen/Dense>
+#include <memory>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_paced_replayer_test : public testing::Test
+{
+public:
+  mars_paced_replayer_test()
+  {
+    mars::ScenarioConfig config;
+    config.duration_ = 2;
+    generator_ = std::make_shared<mars::ScenarioGenerator>(config);
+
+    mars::ScenarioSensorConfig pose = mars_test::ScenarioSensor(mars::ScenarioSensorType::pose, "pose", 20);
+    pose.delay_ = 0.05;
+    pose.delay_jitter_ = 0.02;
+    generator_->AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 200));
+    generator_->AddSensor(pose);
+    generator_->Generate();
+
+    pose_sensor_sptr_ = filter_.AddPoseSensor("pose");
+    core_states_sptr_ = filter_.core_states_sptr_;
+    core_logic_ = filter_.core_logic_;
+    core_logic_->buffer_.set_max_buffer_size(1000);
+  }
+
+  std::vector<mars::BufferEntryType> measurements() const
+  {
+    return filter_.get_entries(*generator_);
+  }
+
+  std::function<void(mars::CoreLogic*)> initializer() const
+  {
+    const mars::CoreStateType initial = generator_->get_true_state(0);
+    return [initial](mars::CoreLogic* core_logic) { core_logic->Initialize(initial.p_wi_, initial.q_wi_); };
+  }
+
+  mars_test::ScenarioFilter filter_;
+  std::shared_ptr<mars::ScenarioGenerator> generator_;
+  std::shared_ptr<mars::CoreState> core_states_sptr_;
+  std::shared_ptr<mars::PoseSensorClass> pose_sensor_sptr_;
+  std::shared_ptr<mars::CoreLogic> core_logic_;
+};
+
+TEST_F(mars_paced_replayer_test, COMPUTE_STATS)
+{
+  std::vector<double> samples;
+  for (int k = 100; k >= 1; k--)
+  {
+    samples.push_back(k * 1e-3);
+  }
+
+  const mars::LatencyStats stats = mars::PacedReplayer::ComputeStats(samples, 0.095);
+  ASSERT_EQ(stats.num_samples_, 100);
+  ASSERT_EQ(stats.num_deadline_misses_, 5);
+  ASSERT_DOUBLE_EQ(stats.mean_, 0.0505);
+  ASSERT_DOUBLE_EQ(stats.p50_, 0.05);
+  ASSERT_DOUBLE_EQ(stats.p90_, 0.09);
+  ASSERT_DOUBLE_EQ(stats.p99_, 0.099);
+  ASSERT_DOUBLE_EQ(stats.max_, 0.1);
+
+  const mars::LatencyStats empty = mars::PacedReplayer::ComputeStats({}, 0.1);
+  ASSERT_EQ(empty.num_samples_, 0);
+}
+
+TEST_F(mars_paced_replayer_test, UNPACED_IN_ORDER)
+{
+  mars::PacedReplayer replayer(measurements());
+  replayer.speed_ = 0;
+  replayer.initializer_ = initializer();
+
+  const mars::PacedReplayResult result = replayer.Run(core_logic_.get());
+  ASSERT_EQ(result.num_processed_, 401 + 41);
+  ASSERT_EQ(result.num_out_of_order_, 0);
+  ASSERT_EQ(result.num_reworks_, 0);
+  ASSERT_TRUE(core_logic_->core_is_initialized_);
+
+  // Without arrival delay, the latency is the processing time
+  ASSERT_EQ(result.latency_.num_samples_, result.num_processed_);
+  ASSERT_DOUBLE_EQ(result.latency_.max_, result.processing_.max_);
+  ASSERT_EQ(result.sensor_latency_.size(), 2);
+  ASSERT_EQ(result.sensor_latency_.at(pose_sensor_sptr_).num_samples_, 41);
+}
+
+TEST_F(mars_paced_replayer_test, ARRIVAL_MODEL)
+{
+  mars::PacedReplayer replayer(measurements(), 3);
+  replayer.speed_ = 10;
+  replayer.deadline_ = 0.06;
+  replayer.initializer_ = initializer();
+  replayer.set_arrival_model(pose_sensor_sptr_, { 0.05, 0.02 });
+
+  const mars::PacedReplayResult result = replayer.Run(core_logic_.get());
+  ASSERT_EQ(result.num_processed_, 401 + 41);
+
+  // Paced to a tenth of the scenario duration
+  ASSERT_GE(result.wall_time_, 0.2);
+
+  // The delayed pose measurements arrive after newer IMU measurements and are reworked, except the last one
+  ASSERT_EQ(result.num_out_of_order_, 40);
+  ASSERT_GT(result.num_reworks_, 0);
+
+  const mars::LatencyStats& pose = result.sensor_latency_.at(pose_sensor_sptr_);
+  ASSERT_EQ(pose.num_samples_, 41);
+  ASSERT_GE(pose.p50_, 0.05);
+  ASSERT_LE(pose.p50_, pose.p90_);
+  ASSERT_LE(pose.p90_, pose.p99_);
+  ASSERT_LE(pose.p99_, pose.max_);
+  ASSERT_GT(pose.num_deadline_misses_, 0);
+  ASSERT_LT(pose.num_deadline_misses_, 41);
+
+  ASSERT_LE(result.processing_.p50_, result.latency_.p50_);
+  ASSERT_GE(result.latency_.num_deadline_misses_, pose.num_deadline_misses_);
+
+  // The same seed reproduces the same arrival order
+  mars::PacedReplayer replayer_b(measurements(), 3);
+  replayer_b.speed_ = 0;
+  replayer_b.initializer_ = initializer();
+  replayer_b.set_arrival_model(pose_sensor_sptr_, { 0.05, 0.02 });
+  core_logic_ = std::make_shared<mars::CoreLogic>(core_states_sptr_);
+  core_logic_->verbose_ = false;
+  pose_sensor_sptr_->is_initialized_ = false;
+  const mars::PacedReplayResult result_b = replayer_b.Run(core_logic_.get());
+  ASSERT_EQ(result_b.num_reworks_, result.num_reworks_);
+  ASSERT_EQ(result_b.num_out_of_order_, result.num_out_of_order_);
+}
+
+TEST_F(mars_paced_replayer_test, GENERATED_ARRIVAL_TIMES)
+{
+  // Arrival times of the scenario generator in measurement order
+  mars::PacedReplayer replayer(measurements());
+  ASSERT_FALSE(replayer.set_arrival_times({ 0, 1 }));
+  ASSERT_TRUE(replayer.set_arrival_times(generator_->get_arrival_times(false)));
+  replayer.speed_ = 0;
+  replayer.initializer_ = initializer();
+
+  const mars::PacedReplayResult result = replayer.Run(core_logic_.get());
+  ASSERT_EQ(result.num_processed_, 401 + 41);
+  ASSERT_EQ(result.num_out_of_order_, 40);
+  ASSERT_GE(result.sensor_latency_.at(pose_sensor_sptr_).p50_, 0.05);
+}
@@ -0,0 +1,120 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/realtime_profile.h>
+#include <sched.h>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+class mars_realtime_profile_test : public testing::Test
+{
+};
+
+TEST_F(mars_realtime_profile_test, HEAP_ESTIMATE)
+{
+  const size_t small_buffer = mars::RealtimeProfile::EstimateHeapBytes(300, 21);
+  const size_t large_buffer = mars::RealtimeProfile::EstimateHeapBytes(3000, 21);
+  const size_t large_state = mars::RealtimeProfile::EstimateHeapBytes(300, 60);
+
+  // At least one core state with covariance and state transition per entry
+  EXPECT_GE(small_buffer, size_t(300 * 2 * 15 * 15 * 8));
+  EXPECT_GT(large_buffer, small_buffer);
+  EXPECT_GT(large_state, small_buffer);
+}
+
+TEST_F(mars_realtime_profile_test, PREFAULTED_HEAP)
+{
+  const size_t reserve = 16 << 20;
+  ASSERT_TRUE(mars::RealtimeProfile::KeepHeap());
+  ASSERT_TRUE(mars::RealtimeProfile::PrefaultHeap(reserve));
+  mars::RealtimeProfile::PrefaultStack(256 << 10);
+
+  // Allocations within the reserve reuse the mapped pages
+  const mars::RealtimeStats stats_start = mars::RealtimeProfile::get_thread_stats();
+  for (int k = 0; k < 100; k++)
+  {
+    char* memory = static_cast<char*>(std::malloc(reserve / 4));
+    ASSERT_NE(memory, nullptr);
+    std::memset(memory, k, reserve / 4);
+    std::free(memory);
+  }
+  const mars::RealtimeStats stats_end = mars::RealtimeProfile::get_thread_stats();
+
+  EXPECT_EQ(stats_end.major_faults_, stats_start.major_faults_);
+  EXPECT_EQ(stats_end.minor_faults_, stats_start.minor_faults_);
+
+  EXPECT_TRUE(mars::RealtimeProfile::ReleaseHeap());
+}
+
+TEST_F(mars_realtime_profile_test, PIN_THREAD)
+{
+  bool pinned = false;
+  int cpu = -1;
+
+  std::thread worker([&pinned, &cpu]() {
+    pinned = mars::RealtimeProfile::PinCurrentThread(0);
+    cpu = sched_getcpu();
+  });
+  worker.join();
+
+  // The CPU can be unavailable in restricted environments
+  if (pinned)
+  {
+    EXPECT_EQ(cpu, 0);
+  }
+
+  // Invalid settings are reported, but do not stop the remaining steps
+  mars::RealtimeConfig config;
+  config.lock_memory_ = false;
+  config.heap_reserve_bytes_ = 1 << 20;
+  config.cpu_ = -1;
+  config.fifo_priority_ = 0;
+  mars::RealtimeState previous;
+  EXPECT_TRUE(mars::RealtimeProfile::Apply(config, &previous));
+  EXPECT_TRUE(mars::RealtimeProfile::Restore(previous));
+}
+
+TEST_F(mars_realtime_profile_test, RESTORE)
+{
+  std::vector<int> cpus_before;
+  std::vector<int> cpus_applied;
+  std::vector<int> cpus_restored;
+  mars::RealtimeState previous;
+  bool restored = false;
+
+  std::thread worker([&]() {
+    cpus_before = mars::RealtimeProfile::get_current_thread_cpus();
+
+    mars::RealtimeConfig config;
+    config.lock_memory_ = false;
+    config.heap_reserve_bytes_ = 1 << 20;
+    config.stack_reserve_bytes_ = 0;
+    config.cpu_ = cpus_before.empty() ? 0 : cpus_before.front();
+    mars::RealtimeProfile::Apply(config, &previous);
+    cpus_applied = mars::RealtimeProfile::get_current_thread_cpus();
+
+    restored = mars::RealtimeProfile::Restore(previous);
+    cpus_restored = mars::RealtimeProfile::get_current_thread_cpus();
+  });
+  worker.join();
+
+  // Only the changed settings are recorded
+  EXPECT_TRUE(previous.heap_kept_);
+  EXPECT_FALSE(previous.memory_locked_);
+  EXPECT_FALSE(previous.sched_changed_);
+  EXPECT_EQ(previous.cpus_, cpus_before);
+
+  EXPECT_TRUE(restored);
+  EXPECT_LE(cpus_applied.size(), size_t(1));
+  EXPECT_EQ(cpus_restored, cpus_before);
+}
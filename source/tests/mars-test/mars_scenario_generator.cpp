@@ -0,0 +1,391 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/filesystem.h>
+#include <mars/data_utils/journal_codecs.h>
+#include <mars/data_utils/read_baro_data.h>
+#include <mars/data_utils/read_gps_w_vel_data.h>
+#include <mars/data_utils/read_imu_data.h>
+#include <mars/data_utils/read_mag_data.h>
+#include <mars/data_utils/read_pose_data.h>
+#include <mars/data_utils/read_sim_data.h>
+#include <mars/data_utils/scenario_generator.h>
+#include <mars/journal_replayer.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/sensors/pressure/pressure_conversion.h>
+#include <unistd.h>
+#include <Eigen/Dense>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+using mars_test::ScenarioSensor;
+
+class mars_scenario_generator_test : public testing::Test
+{
+public:
+  static std::string tmp_path(const std::string& name)
+  {
+    return "/tmp/mars_scenario_generator_" + name + "_" + std::to_string(getpid());
+  }
+};
+
+TEST_F(mars_scenario_generator_test, DETERMINISM)
+{
+  mars::ScenarioConfig config;
+  config.duration_ = 5;
+
+  mars::ScenarioSensorConfig pose = ScenarioSensor(mars::ScenarioSensorType::pose, "pose", 20);
+  pose.noise_std_ = 0.1;
+  pose.noise_std_secondary_ = 0.01;
+  pose.dropout_probability_ = 0.2;
+  pose.delay_jitter_ = 0.05;
+
+  mars::ScenarioGenerator generator_a(config);
+  generator_a.AddSensor(pose);
+  generator_a.Generate();
+
+  // An additional sensor does not change the samples of the other sensors
+  mars::ScenarioGenerator generator_b(config);
+  generator_b.AddSensor(pose);
+  generator_b.AddSensor(ScenarioSensor(mars::ScenarioSensorType::mag, "mag", 50));
+  generator_b.Generate();
+
+  const std::vector<mars::ScenarioSample>& samples_a = generator_a.get_samples(0);
+  const std::vector<mars::ScenarioSample>& samples_b = generator_b.get_samples(0);
+  ASSERT_EQ(samples_a.size(), samples_b.size());
+  for (size_t k = 0; k < samples_a.size(); k++)
+  {
+    ASSERT_EQ(samples_a[k].timestamp_, samples_b[k].timestamp_);
+    ASSERT_EQ(samples_a[k].arrival_, samples_b[k].arrival_);
+    ASSERT_EQ(samples_a[k].values_, samples_b[k].values_);
+  }
+
+  // A different seed changes the noise
+  config.seed_ = 2;
+  mars::ScenarioGenerator generator_c(config);
+  generator_c.AddSensor(pose);
+  generator_c.Generate();
+  ASSERT_NE(generator_c.get_samples(0).front().values_, samples_a.front().values_);
+}
+
+TEST_F(mars_scenario_generator_test, RATES_DROPOUTS_DELAYS)
+{
+  mars::ScenarioConfig config;
+  config.duration_ = 20;
+  mars::ScenarioGenerator generator(config);
+
+  generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 100));
+
+  mars::ScenarioSensorConfig position = ScenarioSensor(mars::ScenarioSensorType::position, "position", 50);
+  position.dropout_probability_ = 0.25;
+  position.delay_ = 0.02;
+  position.delay_jitter_ = 0.05;
+  generator.AddSensor(position);
+  generator.Generate();
+
+  const std::vector<mars::ScenarioSample>& imu = generator.get_samples(0);
+  ASSERT_EQ(imu.size(), 2001);
+  ASSERT_DOUBLE_EQ(imu.back().timestamp_, 20);
+  ASSERT_EQ(imu.back().arrival_, imu.back().timestamp_);
+
+  // 1001 expected samples of which a quarter is dropped
+  const std::vector<mars::ScenarioSample>& samples = generator.get_samples(1);
+  ASSERT_GT(samples.size(), 650);
+  ASSERT_LT(samples.size(), 850);
+
+  double mean_delay = 0;
+  for (const auto& k : samples)
+  {
+    ASSERT_GE(k.arrival_ - k.timestamp_, 0.02 - 1e-12);
+    mean_delay += k.arrival_ - k.timestamp_;
+  }
+  mean_delay /= static_cast<double>(samples.size());
+  ASSERT_NEAR(mean_delay, 0.07, 0.01);
+
+  // Arrival order is sorted by arrival time and contains out of order measurements
+  std::vector<std::shared_ptr<mars::SensorAbsClass>> handles = { std::make_shared<mars::ImuSensorClass>("imu"),
+                                                                  std::make_shared<mars::ImuSensorClass>("pos") };
+  const std::vector<mars::BufferEntryType> entries = generator.get_entries(handles, true);
+  const std::vector<double> arrival = generator.get_arrival_times(true);
+  ASSERT_EQ(entries.size(), imu.size() + samples.size());
+  ASSERT_EQ(arrival.size(), entries.size());
+
+  int num_out_of_order = 0;
+  mars::Time newest(0);
+  for (size_t k = 1; k < entries.size(); k++)
+  {
+    ASSERT_LE(arrival[k - 1], arrival[k]);
+    if (entries[k].timestamp_ < newest)
+    {
+      num_out_of_order++;
+    }
+    newest = std::max(newest, entries[k].timestamp_);
+  }
+  ASSERT_EQ(num_out_of_order, static_cast<int>(samples.size()));
+
+  // Measurement order is sorted by the timestamp
+  const std::vector<mars::BufferEntryType> ordered = generator.get_entries(handles, false);
+  for (size_t k = 1; k < ordered.size(); k++)
+  {
+    ASSERT_LE(ordered[k - 1].timestamp_, ordered[k].timestamp_);
+  }
+
+  // Wrong number of sensor handles
+  handles.pop_back();
+  ASSERT_TRUE(generator.get_entries(handles, true).empty());
+}
+
+TEST_F(mars_scenario_generator_test, MEASUREMENT_MODELS)
+{
+  mars::ScenarioConfig config;
+  config.duration_ = 10;
+  mars::ScenarioGenerator generator(config);
+
+  const int imu_idx = generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 100));
+  const int gps_idx = generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::gps_w_vel, "gps", 10));
+  const int baro_idx = generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::pressure, "baro", 10));
+  const int mag_idx = generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::mag, "mag", 10));
+  const int bodyvel_idx = generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::bodyvel, "bodyvel", 10));
+  const int attitude_idx = generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::attitude, "attitude", 10));
+  generator.Generate();
+
+  // The IMU measurements are consistent with the trajectory (central differences)
+  const double dt = 1e-4;
+  for (const auto& k : generator.get_samples(imu_idx))
+  {
+    const double t = k.timestamp_ + 0.5;
+    const mars::CoreStateType before = generator.get_true_state(t - dt);
+    const mars::CoreStateType state = generator.get_true_state(t);
+    const mars::CoreStateType after = generator.get_true_state(t + dt);
+
+    const Eigen::Vector3d a_w = (after.v_wi_ - before.v_wi_) / (2 * dt);
+    const Eigen::Vector3d a_m = state.q_wi_.conjugate() * (a_w + Eigen::Vector3d(0, 0, 9.81)) + state.b_a_;
+    ASSERT_LT((a_m - state.a_m_).norm(), 1e-6);
+
+    const Eigen::Quaterniond dq = before.q_wi_.conjugate() * after.q_wi_;
+    const Eigen::Vector3d w_i = 2 * dq.vec() / (2 * dt);
+    ASSERT_LT((w_i + state.b_w_ - state.w_m_).norm(), 1e-6);
+
+    const Eigen::Vector3d p_dot = (after.p_wi_ - before.p_wi_) / (2 * dt);
+    ASSERT_LT((p_dot - state.v_wi_).norm(), 1e-6);
+
+    if (k.timestamp_ > 9)
+    {
+      break;
+    }
+  }
+
+  mars::GpsConversion gps_conversion(config.gps_reference_);
+  mars::PressureConversion pressure_conversion;
+  pressure_conversion.set_pressure_reference(
+      mars::Pressure(config.pressure_reference_, config.temperature_, mars::Pressure::Type::GAS));
+
+  for (size_t k = 0; k < generator.get_samples(gps_idx).size(); k++)
+  {
+    const double t = generator.get_samples(gps_idx)[k].timestamp_;
+    const mars::CoreStateType state = generator.get_true_state(t);
+    const Eigen::Matrix3d R_iw = state.q_wi_.toRotationMatrix().transpose();
+
+    const std::vector<double>& gps = generator.get_samples(gps_idx)[k].values_;
+    const Eigen::Vector3d enu = gps_conversion.get_enu(mars::GpsCoordinates(gps[0], gps[1], gps[2]));
+    ASSERT_LT((enu - state.p_wi_).norm(), 1e-6);
+    ASSERT_TRUE(Eigen::Vector3d(gps[3], gps[4], gps[5]).isApprox(state.v_wi_));
+
+    const std::vector<double>& baro = generator.get_samples(baro_idx)[k].values_;
+    const double height =
+        pressure_conversion.get_height(mars::Pressure(baro[0], config.temperature_, mars::Pressure::Type::GAS))(0);
+    ASSERT_NEAR(height, state.p_wi_.z(), 1e-6);
+
+    const std::vector<double>& mag = generator.get_samples(mag_idx)[k].values_;
+    ASSERT_TRUE(Eigen::Vector3d(mag.data()).isApprox(R_iw * config.mag_w_));
+
+    const std::vector<double>& bodyvel = generator.get_samples(bodyvel_idx)[k].values_;
+    ASSERT_TRUE(Eigen::Vector3d(bodyvel.data()).isApprox(R_iw * state.v_wi_));
+
+    const std::vector<double>& attitude = generator.get_samples(attitude_idx)[k].values_;
+    ASSERT_NEAR(std::abs(Eigen::Vector4d(attitude[1], attitude[2], attitude[3], attitude[0])
+                             .dot(state.q_wi_.coeffs())),
+                1, 1e-12);
+  }
+}
+
+TEST_F(mars_scenario_generator_test, FILTER_TRACKS_TRUTH)
+{
+  mars::ScenarioConfig config;
+  config.duration_ = 20;
+  mars::ScenarioGenerator generator(config);
+  generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 200));
+  generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::pose, "pose", 20));
+  generator.Generate();
+
+  mars_test::ScenarioFilter filter;
+  filter.AddPoseSensor("pose");
+  filter.core_logic_->buffer_.set_max_buffer_size(200);
+
+  const std::vector<mars::BufferEntryType> entries = filter.get_entries(generator);
+  filter.Start(generator, entries.front());
+
+  mars::CoreLogic& core_logic = *filter.core_logic_;
+  for (size_t k = 1; k < entries.size(); k++)
+  {
+    core_logic.ProcessMeasurement(entries[k].sensor_handle_, entries[k].timestamp_, entries[k].data_);
+  }
+
+  mars::BufferEntryType latest;
+  ASSERT_TRUE(core_logic.buffer_.get_latest_state(&latest));
+  const mars::CoreStateType& estimate = static_cast<mars::CoreType*>(latest.data_.core_state_.get())->state_;
+  const mars::CoreStateType truth = generator.get_true_state(latest.timestamp_.get_seconds());
+
+  EXPECT_LT((estimate.p_wi_ - truth.p_wi_).norm(), 0.01);
+  EXPECT_LT((estimate.v_wi_ - truth.v_wi_).norm(), 0.05);
+  EXPECT_LT(estimate.q_wi_.angularDistance(truth.q_wi_), 0.01);
+}
+
+TEST_F(mars_scenario_generator_test, CSV_ROUND_TRIP)
+{
+  mars::ScenarioConfig config;
+  config.duration_ = 2;
+  mars::ScenarioGenerator generator(config);
+
+  mars::ScenarioSensorConfig imu = ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 100);
+  imu.noise_std_ = 0.1;
+  imu.noise_std_secondary_ = 0.01;
+  mars::ScenarioSensorConfig pose = ScenarioSensor(mars::ScenarioSensorType::pose, "pose", 10);
+  pose.noise_std_ = 0.1;
+  pose.noise_std_secondary_ = 0.01;
+  generator.AddSensor(imu);
+  generator.AddSensor(pose);
+  generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::gps_w_vel, "gps", 5));
+  generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::pressure, "baro", 5));
+  generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::mag, "mag", 5));
+  generator.Generate();
+
+  const std::string directory = tmp_path("csv");
+  ASSERT_TRUE(mars::filesystem::MakeDir(directory));
+  ASSERT_TRUE(generator.WriteCsv(directory));
+  ASSERT_FALSE(generator.WriteCsv(directory + "/missing"));
+
+  std::vector<std::shared_ptr<mars::SensorAbsClass>> handles;
+  for (const auto& k : generator.get_sensors())
+  {
+    handles.push_back(std::make_shared<mars::ImuSensorClass>(k.name_));
+  }
+
+  std::vector<mars::BufferEntryType> read;
+  std::vector<mars::BufferEntryType> data;
+  mars::ReadImuData(&data, handles[0], directory + "/imu.csv");
+  read.insert(read.end(), data.begin(), data.end());
+  mars::ReadPoseData(&data, handles[1], directory + "/pose.csv");
+  read.insert(read.end(), data.begin(), data.end());
+  mars::ReadGpsWithVelData(&data, handles[2], directory + "/gps.csv");
+  read.insert(read.end(), data.begin(), data.end());
+  mars::ReadBarometerData(&data, handles[3], directory + "/baro.csv");
+  read.insert(read.end(), data.begin(), data.end());
+  mars::ReadMagData(&data, handles[4], directory + "/mag.csv");
+  read.insert(read.end(), data.begin(), data.end());
+  std::stable_sort(read.begin(), read.end());
+
+  // The readers restore the generated measurements
+  const std::vector<mars::BufferEntryType> generated = generator.get_entries(handles, false);
+  ASSERT_EQ(read.size(), generated.size());
+
+  const mars::JournalEncoder encoders[] = { mars::MakeJournalEncoder<mars::IMUMeasurementType>(),
+                                            mars::MakeJournalEncoder<mars::PoseMeasurementType>(),
+                                            mars::MakeJournalEncoder<mars::GpsVelMeasurementType>(),
+                                            mars::MakeJournalEncoder<mars::PressureMeasurementType>(),
+                                            mars::MakeJournalEncoder<mars::MagMeasurementType>() };
+  for (size_t k = 0; k < read.size(); k++)
+  {
+    ASSERT_EQ(read[k].timestamp_, generated[k].timestamp_);
+    ASSERT_EQ(read[k].sensor_handle_, generated[k].sensor_handle_);
+
+    const size_t sensor_idx = static_cast<size_t>(
+        std::find(handles.begin(), handles.end(), read[k].sensor_handle_) - handles.begin());
+    double read_values[8];
+    double generated_values[8];
+    const int num_values = encoders[sensor_idx](read[k].data_.measurement_, read_values, 8);
+    ASSERT_EQ(encoders[sensor_idx](generated[k].data_.measurement_, generated_values, 8), num_values);
+    for (int i = 0; i < num_values; i++)
+    {
+      ASSERT_NEAR(read_values[i], generated_values[i], 1e-12 * std::max(1.0, std::abs(generated_values[i])));
+    }
+  }
+
+  // Ground truth in the format of the simulation data
+  std::vector<mars::BufferEntryType> truth;
+  mars::ReadSimData(&truth, handles[0], directory + "/traj.csv");
+  ASSERT_EQ(truth.size(), 401);
+  const mars::CoreStateType state = generator.get_true_state(1);
+  const mars::IMUMeasurementType& imu_truth =
+      *static_cast<mars::IMUMeasurementType*>(truth[200].data_.measurement_.get());
+  ASSERT_TRUE(imu_truth.linear_acceleration_.isApprox(state.a_m_));
+  ASSERT_TRUE(imu_truth.angular_velocity_.isApprox(state.w_m_));
+
+  for (const auto& k : { "traj", "imu", "pose", "gps", "baro", "mag" })
+  {
+    std::remove((directory + "/" + k + ".csv").c_str());
+  }
+  rmdir(directory.c_str());
+}
+
+TEST_F(mars_scenario_generator_test, JOURNAL)
+{
+  mars::ScenarioConfig config;
+  config.duration_ = 2;
+  mars::ScenarioGenerator generator(config);
+
+  generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 100));
+  mars::ScenarioSensorConfig vision = ScenarioSensor(mars::ScenarioSensorType::vision, "vision", 30);
+  vision.delay_ = 0.05;
+  vision.delay_jitter_ = 0.01;
+  generator.AddSensor(vision);
+  generator.AddSensor(ScenarioSensor(mars::ScenarioSensorType::velocity, "velocity", 10));
+  generator.Generate();
+
+  const std::string file_name = tmp_path("journal") + ".bin";
+  ASSERT_TRUE(generator.WriteJournal(file_name));
+
+  std::vector<std::shared_ptr<mars::SensorAbsClass>> handles = { std::make_shared<mars::ImuSensorClass>("imu"),
+                                                                  std::make_shared<mars::ImuSensorClass>("vision"),
+                                                                  std::make_shared<mars::ImuSensorClass>("vel") };
+
+  mars::JournalReplayer replayer(file_name);
+  ASSERT_TRUE(replayer.Open());
+  ASSERT_EQ(replayer.get_sensor_names(), std::vector<std::string>({ "imu", "vision", "velocity" }));
+  ASSERT_TRUE(replayer.RegisterSensor("imu", handles[0], mars::MakeJournalDecoder<mars::IMUMeasurementType>()));
+  ASSERT_TRUE(replayer.RegisterSensor("vision", handles[1], mars::MakeJournalDecoder<mars::VisionMeasurementType>()));
+  ASSERT_TRUE(
+      replayer.RegisterSensor("velocity", handles[2], mars::MakeJournalDecoder<mars::VelocityMeasurementType>()));
+
+  // Records are in arrival order and carry the synthesized arrival times
+  const std::vector<mars::BufferEntryType> entries = generator.get_entries(handles, true);
+  const std::vector<double> arrival = generator.get_arrival_times(true);
+
+  mars::JournalEntry entry;
+  size_t num_entries = 0;
+  while (replayer.ReadNext(&entry))
+  {
+    ASSERT_LT(num_entries, entries.size());
+    ASSERT_EQ(entry.sensor, entries[num_entries].sensor_handle_);
+    ASSERT_EQ(entry.timestamp, entries[num_entries].timestamp_.get_seconds());
+    ASSERT_NEAR(entry.arrival_ns * 1e-9, arrival[num_entries], 1e-9);
+    num_entries++;
+  }
+  ASSERT_EQ(num_entries, entries.size());
+
+  std::remove(file_name.c_str());
+}
@@ -0,0 +1,453 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/data_utils/scenario_generator.h>
+#include <mars/paced_replayer.h>
+#include <mars/sensor_manager.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/sensors/position/position_sensor_class.h>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_sensor_manager_test : public testing::Test
+{
+public:
+  mars_sensor_manager_test()
+  {
+    mars::ScenarioConfig config;
+    config.duration_ = 4;
+    mars::ScenarioGenerator generator(config);
+    generator.AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::imu, "imu", 200));
+    generator.AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::pose, "pose", 20));
+    generator.AddSensor(mars_test::ScenarioSensor(mars::ScenarioSensorType::position, "position", 50));
+    generator.Generate();
+
+    imu_sensor_sptr_ = filter_.imu_sensor_sptr_;
+    core_states_sptr_ = filter_.core_states_sptr_;
+    pose_sensor_sptr_ = filter_.AddPoseSensor("pose");
+    position_sensor_sptr_ = filter_.AddPositionSensor("position");
+
+    entries_ = filter_.get_entries(generator);
+    initial_ = generator.get_true_state(0);
+
+    core_logic_ = filter_.core_logic_;
+    core_logic_->buffer_.set_max_buffer_size(2000);
+    core_logic_->sensor_manager_.register_sensor(imu_sensor_sptr_);
+    core_logic_->sensor_manager_.register_sensor(pose_sensor_sptr_);
+    core_logic_->sensor_manager_.register_sensor(position_sensor_sptr_);
+  }
+
+  ///
+  /// \brief Process Processes the entries [first, last) and initializes the core after the first IMU measurement
+  ///
+  void Process(const size_t& first, const size_t& last)
+  {
+    for (size_t k = first; k < last && k < entries_.size(); k++)
+    {
+      core_logic_->ProcessMeasurement(entries_[k].sensor_handle_, entries_[k].timestamp_, entries_[k].data_);
+      if (!core_logic_->core_is_initialized_)
+      {
+        core_logic_->Initialize(initial_.p_wi_, initial_.q_wi_);
+      }
+    }
+  }
+
+  int CountEntries(const std::shared_ptr<mars::SensorAbsClass>& sensor) const
+  {
+    int num_entries = 0;
+    for (int k = 0; k < core_logic_->buffer_.get_length(); k++)
+    {
+      mars::BufferEntryType entry;
+      core_logic_->buffer_.get_entry_at_idx(k, &entry);
+      num_entries += entry.sensor_handle_ == sensor ? 1 : 0;
+    }
+    return num_entries;
+  }
+
+  std::vector<mars::BufferEntryType> entries_;
+  mars_test::ScenarioFilter filter_;
+  mars::CoreStateType initial_;
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr_;
+  std::shared_ptr<mars::CoreState> core_states_sptr_;
+  std::shared_ptr<mars::PoseSensorClass> pose_sensor_sptr_;
+  std::shared_ptr<mars::PositionSensorClass> position_sensor_sptr_;
+  std::shared_ptr<mars::CoreLogic> core_logic_;
+};
+
+TEST_F(mars_sensor_manager_test, REGISTRY_SNAPSHOT)
+{
+  mars::SensorManager manager;
+  ASSERT_TRUE(manager.register_sensor(imu_sensor_sptr_));
+  ASSERT_TRUE(manager.register_sensor(pose_sensor_sptr_));
+  ASSERT_FALSE(manager.register_sensor(pose_sensor_sptr_));
+  ASSERT_TRUE(manager.does_sensor_exist(pose_sensor_sptr_));
+  ASSERT_FALSE(manager.does_sensor_exist(position_sensor_sptr_));
+
+  // A snapshot is not altered by later changes
+  const std::shared_ptr<const mars::SensorManager::SensorList> snapshot = manager.get_sensor_list();
+  ASSERT_TRUE(manager.QueueRemoveSensor(pose_sensor_sptr_));
+  ASSERT_FALSE(manager.QueueRemoveSensor(pose_sensor_sptr_));
+  ASSERT_EQ(snapshot->size(), 2);
+  ASSERT_EQ(manager.get_sensor_list()->size(), 1);
+  ASSERT_FALSE(manager.does_sensor_exist(pose_sensor_sptr_));
+
+  // The removal is only queued, the sensor is reset by the filter thread
+  ASSERT_TRUE(pose_sensor_sptr_->do_update_);
+  ASSERT_TRUE(manager.IsCleanupPending());
+  ASSERT_FALSE(manager.QueueActivateSensor(pose_sensor_sptr_));
+  ASSERT_FALSE(manager.QueueDeactivateSensor(position_sensor_sptr_));
+
+  mars::Buffer buffer;
+  ASSERT_EQ(manager.ApplyPendingChanges(&buffer), 1);
+  ASSERT_EQ(manager.ApplyPendingChanges(&buffer), 0);
+  ASSERT_FALSE(pose_sensor_sptr_->do_update_);
+  ASSERT_FALSE(pose_sensor_sptr_->is_initialized_);
+
+  // The cleanup of an empty buffer finishes with the first step
+  ASSERT_EQ(manager.CollectGarbage(&buffer), 0);
+  ASSERT_FALSE(manager.IsCleanupPending());
+
+  // Copies share the registered sensors
+  mars::SensorManager copy(manager);
+  ASSERT_TRUE(copy.does_sensor_exist(imu_sensor_sptr_));
+  ASSERT_EQ(copy.get_sensor_list(), manager.get_sensor_list());
+}
+
+TEST_F(mars_sensor_manager_test, SYNCHRONOUS_CHANGES)
+{
+  mars::SensorManager manager;
+  ASSERT_TRUE(manager.register_sensor(imu_sensor_sptr_));
+  ASSERT_TRUE(manager.register_sensor(pose_sensor_sptr_));
+  ASSERT_EQ(manager.sensor_list_.size(), 2);
+
+  // The changes without queue take effect immediately, also without a filter
+  pose_sensor_sptr_->do_update_ = false;
+  ASSERT_TRUE(manager.activate_sensor(pose_sensor_sptr_));
+  ASSERT_TRUE(pose_sensor_sptr_->do_update_);
+  ASSERT_FALSE(manager.activate_sensor(position_sensor_sptr_));
+  ASSERT_FALSE(manager.IsCleanupPending());
+
+  mars::Buffer buffer;
+  buffer.set_max_buffer_size(100);
+  for (int k = 0; k < 10; k++)
+  {
+    buffer.AddEntrySorted(mars::BufferEntryType(0.1 * k, mars::BufferDataType(), pose_sensor_sptr_));
+  }
+
+  // The overload with a buffer removes the entries which are left by a queued deactivation
+  ASSERT_TRUE(manager.QueueDeactivateSensor(pose_sensor_sptr_));
+  ASSERT_EQ(manager.ApplyPendingChanges(&buffer), 1);
+  ASSERT_FALSE(pose_sensor_sptr_->do_update_);
+  ASSERT_EQ(buffer.get_length(), 10);
+  ASSERT_TRUE(manager.activate_sensor(buffer, pose_sensor_sptr_));
+  ASSERT_TRUE(pose_sensor_sptr_->do_update_);
+  ASSERT_EQ(buffer.get_length(), 0);
+  ASSERT_FALSE(manager.IsCleanupPending());
+
+  ASSERT_TRUE(manager.remove_sensor(buffer, pose_sensor_sptr_));
+  ASSERT_FALSE(pose_sensor_sptr_->do_update_);
+  ASSERT_EQ(manager.sensor_list_.size(), 1);
+  ASSERT_EQ(manager.sensor_list_, *manager.get_sensor_list());
+}
+
+TEST_F(mars_sensor_manager_test, LAZY_REMOVAL)
+{
+  core_logic_->sensor_manager_.cleanup_step_ = 50;
+  Process(0, entries_.size() / 2);
+
+  const int num_pose_entries = CountEntries(pose_sensor_sptr_);
+  const int num_position_entries = CountEntries(position_sensor_sptr_);
+  ASSERT_GT(num_pose_entries, 30);
+  ASSERT_TRUE(pose_sensor_sptr_->is_initialized_);
+
+  // The removal returns without touching the sensor or the buffer
+  ASSERT_TRUE(core_logic_->sensor_manager_.QueueRemoveSensor(pose_sensor_sptr_));
+  ASSERT_TRUE(pose_sensor_sptr_->do_update_);
+  ASSERT_EQ(CountEntries(pose_sensor_sptr_), num_pose_entries);
+
+  // The next measurement applies the removal, the buffer is cleaned in steps
+  const mars::BufferEntryType& next = entries_[entries_.size() / 2];
+  core_logic_->ProcessMeasurement(next.sensor_handle_, next.timestamp_, next.data_);
+  ASSERT_FALSE(pose_sensor_sptr_->do_update_);
+  ASSERT_TRUE(core_logic_->sensor_manager_.IsCleanupPending());
+  ASSERT_GT(CountEntries(pose_sensor_sptr_), 0);
+  ASSERT_LT(CountEntries(pose_sensor_sptr_), num_pose_entries);
+
+  // Measurements of the removed sensor are rejected
+  for (size_t k = entries_.size() / 2 + 1; k < entries_.size(); k++)
+  {
+    const bool result =
+        core_logic_->ProcessMeasurement(entries_[k].sensor_handle_, entries_[k].timestamp_, entries_[k].data_);
+    if (entries_[k].sensor_handle_ == pose_sensor_sptr_)
+    {
+      ASSERT_FALSE(result);
+    }
+  }
+
+  ASSERT_FALSE(core_logic_->sensor_manager_.IsCleanupPending());
+  ASSERT_EQ(CountEntries(pose_sensor_sptr_), 0);
+  ASSERT_GT(CountEntries(position_sensor_sptr_), num_position_entries);
+  ASSERT_TRUE(core_logic_->buffer_.IsSorted());
+
+  // A new activation starts with a new initialization of the sensor
+  ASSERT_FALSE(core_logic_->sensor_manager_.QueueActivateSensor(pose_sensor_sptr_));
+  ASSERT_TRUE(core_logic_->sensor_manager_.register_sensor(pose_sensor_sptr_));
+  ASSERT_TRUE(core_logic_->sensor_manager_.QueueActivateSensor(pose_sensor_sptr_));
+  auto last_imu = std::find_if(entries_.rbegin(), entries_.rend(), [this](const mars::BufferEntryType& entry) {
+    return entry.sensor_handle_ == imu_sensor_sptr_;
+  });
+  core_logic_->ProcessMeasurement(imu_sensor_sptr_, entries_.back().timestamp_ + mars::Time(0.005), last_imu->data_);
+  ASSERT_TRUE(pose_sensor_sptr_->do_update_);
+  ASSERT_FALSE(pose_sensor_sptr_->is_initialized_);
+}
+
+TEST_F(mars_sensor_manager_test, DEACTIVATE_DURING_CLEANUP)
+{
+  core_logic_->sensor_manager_.cleanup_step_ = 20;
+  Process(0, entries_.size() / 2);
+
+  // A second deactivation restarts the scan at the oldest entry
+  core_logic_->sensor_manager_.QueueDeactivateSensor(pose_sensor_sptr_);
+  Process(entries_.size() / 2, entries_.size() / 2 + 10);
+  ASSERT_TRUE(core_logic_->sensor_manager_.IsCleanupPending());
+  core_logic_->sensor_manager_.QueueDeactivateSensor(position_sensor_sptr_);
+
+  // Reactivating the pose sensor removes its remaining entries at once
+  core_logic_->sensor_manager_.QueueActivateSensor(pose_sensor_sptr_);
+  Process(entries_.size() / 2 + 10, entries_.size() / 2 + 11);
+  ASSERT_TRUE(pose_sensor_sptr_->do_update_);
+  ASSERT_FALSE(position_sensor_sptr_->do_update_);
+  ASSERT_EQ(CountEntries(pose_sensor_sptr_), 0);
+
+  Process(entries_.size() / 2 + 11, entries_.size());
+  ASSERT_FALSE(core_logic_->sensor_manager_.IsCleanupPending());
+  ASSERT_EQ(CountEntries(position_sensor_sptr_), 0);
+  ASSERT_GT(CountEntries(pose_sensor_sptr_), 0);
+
+  // The synchronous variant removes the entries immediately
+  ASSERT_TRUE(core_logic_->sensor_manager_.remove_sensor(core_logic_->buffer_, pose_sensor_sptr_));
+  ASSERT_EQ(CountEntries(pose_sensor_sptr_), 0);
+  ASSERT_FALSE(pose_sensor_sptr_->do_update_);
+  ASSERT_FALSE(core_logic_->sensor_manager_.does_sensor_exist(pose_sensor_sptr_));
+}
+
+TEST_F(mars_sensor_manager_test, ACTIVATE_DURING_COALESCED_REWORK)
+{
+  core_logic_->coalesce_ooo_reworks_ = true;
+  core_logic_->sensor_manager_.cleanup_step_ = 10;
+  const size_t half = entries_.size() / 2;
+
+  // Two position measurements are held back and arrive out of order
+  std::vector<size_t> late;
+  for (size_t k = half - 40; k < half && late.size() < 2; k++)
+  {
+    if (entries_[k].sensor_handle_ == position_sensor_sptr_)
+    {
+      late.push_back(k);
+    }
+  }
+  ASSERT_EQ(late.size(), 2);
+
+  for (size_t k = 0; k < half; k++)
+  {
+    if (std::find(late.begin(), late.end(), k) == late.end())
+    {
+      Process(k, k + 1);
+    }
+  }
+
+  // The pose entries of the deactivation are still in the buffer when the first late measurement opens a rework
+  core_logic_->sensor_manager_.QueueDeactivateSensor(pose_sensor_sptr_);
+  Process(half, half + 2);
+  Process(late[0], late[0] + 1);
+  const int num_pose_entries = CountEntries(pose_sensor_sptr_);
+  ASSERT_GT(num_pose_entries, 0);
+
+  // The activation would remove entries in front of the pending rework index, it waits for the rework
+  core_logic_->sensor_manager_.QueueActivateSensor(pose_sensor_sptr_);
+  Process(late[1], late[1] + 1);
+  ASSERT_FALSE(pose_sensor_sptr_->do_update_);
+  ASSERT_EQ(CountEntries(pose_sensor_sptr_), num_pose_entries);
+
+  // The next in order measurement performs the rework and then applies the activation
+  const mars::Time activation_time = entries_[half + 2].timestamp_;
+  Process(half + 2, half + 3);
+  ASSERT_TRUE(pose_sensor_sptr_->do_update_);
+  ASSERT_EQ(core_logic_->get_rework_stats().num_reworks_, 1);
+
+  int num_old_pose_entries = 0;
+  int num_late_with_states = 0;
+  for (int k = 0; k < core_logic_->buffer_.get_length(); k++)
+  {
+    mars::BufferEntryType entry;
+    core_logic_->buffer_.get_entry_at_idx(k, &entry);
+    num_old_pose_entries += entry.sensor_handle_ == pose_sensor_sptr_ && entry.timestamp_ < activation_time;
+
+    for (const auto& j : late)
+    {
+      if (entry.sensor_handle_ == position_sensor_sptr_ && entry.timestamp_ == entries_[j].timestamp_)
+      {
+        num_late_with_states += entry.HasStates();
+      }
+    }
+  }
+  ASSERT_EQ(num_old_pose_entries, 0);
+  ASSERT_EQ(num_late_with_states, 2);
+  ASSERT_TRUE(core_logic_->buffer_.IsSorted());
+
+  Process(half + 3, entries_.size());
+  ASSERT_FALSE(core_logic_->sensor_manager_.IsCleanupPending());
+  ASSERT_GT(CountEntries(pose_sensor_sptr_), 0);
+}
+
+TEST_F(mars_sensor_manager_test, CONCURRENT_REMOVAL_TICK_JITTER)
+{
+  core_logic_->buffer_.set_max_buffer_size(4000);
+  std::atomic<size_t> num_ticks(0);
+  std::atomic<bool> removed(false);
+
+  // Hot swap of the pose sensor from another thread while the filter is running
+  std::thread remover([this, &num_ticks, &removed]() {
+    while (num_ticks.load() < entries_.size() / 2)
+    {
+      std::this_thread::yield();
+    }
+    core_logic_->sensor_manager_.QueueRemoveSensor(pose_sensor_sptr_);
+    removed = true;
+  });
+
+  std::vector<double> ticks_before;
+  std::vector<double> ticks_after;
+  for (size_t k = 0; k < entries_.size(); k++)
+  {
+    const bool was_removed = removed.load();
+    const auto start = std::chrono::steady_clock::now();
+    core_logic_->ProcessMeasurement(entries_[k].sensor_handle_, entries_[k].timestamp_, entries_[k].data_);
+    const double tick = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!core_logic_->core_is_initialized_)
+    {
+      core_logic_->Initialize(initial_.p_wi_, initial_.q_wi_);
+    }
+
+    (was_removed ? ticks_after : ticks_before).push_back(tick);
+    num_ticks++;
+  }
+  remover.join();
+
+  // The remaining steps of the cleanup
+  while (core_logic_->sensor_manager_.IsCleanupPending())
+  {
+    core_logic_->sensor_manager_.CollectGarbage(&core_logic_->buffer_);
+  }
+
+  const mars::LatencyStats before = mars::PacedReplayer::ComputeStats(ticks_before, 1e-3);
+  const mars::LatencyStats after = mars::PacedReplayer::ComputeStats(ticks_after, 1e-3);
+  std::cout << "Filter tick before removal: p50=" << 1e6 * before.p50_ << "us max=" << 1e6 * before.max_
+            << "us, during and after removal: p50=" << 1e6 * after.p50_ << "us max=" << 1e6 * after.max_ << "us"
+            << std::endl;
+
+  ASSERT_GT(after.num_samples_, 0);
+  ASSERT_FALSE(pose_sensor_sptr_->do_update_);
+  ASSERT_EQ(CountEntries(pose_sensor_sptr_), 0);
+  ASSERT_FALSE(core_logic_->sensor_manager_.does_sensor_exist(pose_sensor_sptr_));
+  ASSERT_TRUE(core_logic_->buffer_.IsSorted());
+}
+
+TEST_F(mars_sensor_manager_test, REGISTRY_CHURN_TICK_LATENCY)
+{
+  // Sensor without measurements which is added and removed by another thread
+  std::shared_ptr<mars::PositionSensorClass> churn_sensor_sptr =
+      std::make_shared<mars::PositionSensorClass>("churn", core_states_sptr_);
+
+  // Replaces the filter, resets the sensors and registers them
+  const auto reset = [this]() {
+    core_logic_ = std::make_shared<mars::CoreLogic>(core_states_sptr_);
+    core_logic_->verbose_ = false;
+    core_logic_->buffer_.set_max_buffer_size(2000);
+    core_logic_->sensor_manager_.register_sensor(imu_sensor_sptr_);
+    core_logic_->sensor_manager_.register_sensor(pose_sensor_sptr_);
+    core_logic_->sensor_manager_.register_sensor(position_sensor_sptr_);
+    pose_sensor_sptr_->is_initialized_ = false;
+    position_sensor_sptr_->is_initialized_ = false;
+  };
+
+  // Processes all entries and returns the duration of each filter step
+  const auto run = [this](std::vector<double>* ticks) {
+    for (size_t k = 0; k < entries_.size(); k++)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      core_logic_->ProcessMeasurement(entries_[k].sensor_handle_, entries_[k].timestamp_, entries_[k].data_);
+      ticks->push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+      if (!core_logic_->core_is_initialized_)
+      {
+        core_logic_->Initialize(initial_.p_wi_, initial_.q_wi_);
+      }
+    }
+  };
+
+  // Runs with and without churn are interleaved such that a change of the system load affects both
+  const int num_runs = 5;
+  std::vector<double> ticks_quiet;
+  std::vector<double> ticks_churn;
+  std::atomic<int> num_changes(0);
+
+  for (int k = 0; k < num_runs; k++)
+  {
+    reset();
+    run(&ticks_quiet);
+
+    reset();
+    std::shared_ptr<mars::CoreLogic> filter = core_logic_;
+    std::atomic<bool> done(false);
+
+    // The writer sleeps between the changes, on a single core a busy writer would compete for the CPU
+    std::thread writer([filter, &churn_sensor_sptr, &done, &num_changes]() {
+      while (!done.load())
+      {
+        filter->sensor_manager_.register_sensor(churn_sensor_sptr);
+        filter->sensor_manager_.QueueRemoveSensor(churn_sensor_sptr);
+        num_changes++;
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+    });
+
+    run(&ticks_churn);
+    done = true;
+    writer.join();
+  }
+
+  const mars::LatencyStats quiet = mars::PacedReplayer::ComputeStats(ticks_quiet, 1e-3);
+  const mars::LatencyStats churn = mars::PacedReplayer::ComputeStats(ticks_churn, 1e-3);
+  std::cout << "Filter tick without churn: p50=" << 1e6 * quiet.p50_ << "us p99=" << 1e6 * quiet.p99_
+            << "us max=" << 1e6 * quiet.max_ << "us, with " << num_changes.load()
+            << " registry changes: p50=" << 1e6 * churn.p50_ << "us p99=" << 1e6 * churn.p99_
+            << "us max=" << 1e6 * churn.max_ << "us" << std::endl;
+
+  ASSERT_GT(num_changes.load(), 0);
+  ASSERT_EQ(churn.num_samples_, quiet.num_samples_);
+
+  // Readers of the registry do not lock, the changes must not delay the filter steps. The margin covers the CPU time
+  // of the writer and the scheduling noise of a shared machine.
+  EXPECT_LT(churn.p50_, 1.5 * quiet.p50_ + 10e-6);
+  EXPECT_LT(churn.p99_, 2 * quiet.p99_ + 50e-6);
+}
@@ -0,0 +1,321 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/shm_state_publisher.h>
+#include <mars/shm_state_reader.h>
+#include <mars/type_definitions/core_type.h>
+#include <unistd.h>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class mars_shm_state_publisher_test : public testing::Test
+{
+public:
+  static std::string segment_name(const std::string& test_name)
+  {
+    return "/mars_shm_test_" + test_name + "_" + std::to_string(getpid());
+  }
+
+  static mars::BufferEntryType core_entry(const double& timestamp, const double& p_x,
+                                          const std::shared_ptr<mars::SensorAbsClass>& sensor)
+  {
+    mars::CoreType core;
+    core.state_.p_wi_ = Eigen::Vector3d(p_x, 2, 3);
+    core.state_.q_wi_ = Eigen::Quaterniond(Eigen::AngleAxisd(0.3, Eigen::Vector3d::UnitZ()));
+    core.cov_ = mars::CoreStateMatrix::Identity() * p_x;
+
+    mars::BufferDataType data;
+    data.set_core_state(std::make_shared<mars::CoreType>(core));
+
+    return mars::BufferEntryType(timestamp, data, sensor);
+  }
+};
+
+TEST_F(mars_shm_state_publisher_test, OPEN_CLOSE)
+{
+  const std::string name = segment_name("open_close");
+
+  mars::ShmStateReader reader(name);
+  ASSERT_FALSE(reader.Open());
+
+  mars::ShmStatePublisher publisher(name, 4);
+  ASSERT_TRUE(publisher.Open());
+  ASSERT_TRUE(reader.Open());
+  ASSERT_EQ(reader.get_write_count(), 0);
+
+  mars::shm::ShmStatePayload payload;
+  ASSERT_FALSE(reader.get_latest(&payload));
+
+  reader.Close();
+  publisher.Close();
+  ASSERT_FALSE(reader.Open());
+}
+
+TEST_F(mars_shm_state_publisher_test, PUBLISH_READ)
+{
+  const std::string name = segment_name("publish_read");
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+
+  mars::ShmStatePublisher publisher(name, 4, mars::shm::CovMode::full);
+  publisher.propagation_sensor_ = imu_sensor_sptr;
+  ASSERT_TRUE(publisher.Open());
+
+  // Entries without core states are not published
+  mars::BufferEntryType empty_entry(1, mars::BufferDataType(), imu_sensor_sptr);
+  ASSERT_FALSE(publisher.Publish(empty_entry));
+
+  const mars::BufferEntryType entry = core_entry(1.5, 7, imu_sensor_sptr);
+  ASSERT_TRUE(publisher.Publish(entry));
+  ASSERT_EQ(publisher.get_write_count(), 1);
+
+  mars::ShmStateReader reader(name);
+  ASSERT_TRUE(reader.Open());
+
+  mars::shm::ShmStatePayload payload;
+  uint64_t write_count = 0;
+  ASSERT_TRUE(reader.get_latest(&payload, &write_count));
+  ASSERT_EQ(write_count, 1);
+
+  const mars::CoreType* core = static_cast<const mars::CoreType*>(entry.data_.core_state_.get());
+  EXPECT_DOUBLE_EQ(payload.timestamp, 1.5);
+  EXPECT_EQ(payload.source_sensor_id, -1);
+  EXPECT_EQ(payload.cov_mode, static_cast<uint32_t>(mars::shm::CovMode::full));
+  EXPECT_EQ(Eigen::Map<const Eigen::Vector3d>(payload.core_state), core->state_.p_wi_);
+  EXPECT_DOUBLE_EQ(payload.core_state[6], core->state_.q_wi_.w());
+  EXPECT_EQ(Eigen::Map<const Eigen::Vector3d>(payload.core_state + 7), core->state_.q_wi_.vec());
+
+  Eigen::Map<const Eigen::Matrix<double, mars::CoreStateType::size_error_, mars::CoreStateType::size_error_,
+                                 Eigen::RowMajor>>
+      cov(payload.core_cov);
+  EXPECT_EQ(cov, core->cov_);
+  EXPECT_EQ(payload.num_sensors, 0);
+}
+
+TEST_F(mars_shm_state_publisher_test, RING_OVERWRITE)
+{
+  const std::string name = segment_name("ring_overwrite");
+  const uint32_t num_slots = 4;
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+
+  mars::ShmStatePublisher publisher(name, num_slots);
+  ASSERT_TRUE(publisher.Open());
+
+  mars::ShmStateReader reader(name);
+  ASSERT_TRUE(reader.Open());
+
+  const int num_states = 10;
+  for (int k = 1; k <= num_states; k++)
+  {
+    ASSERT_TRUE(publisher.Publish(core_entry(k, k, imu_sensor_sptr)));
+  }
+
+  ASSERT_EQ(reader.get_write_count(), num_states);
+
+  mars::shm::ShmStatePayload payload;
+
+  // Overwritten states are reported as unavailable
+  for (int k = 1; k <= num_states - static_cast<int>(num_slots); k++)
+  {
+    ASSERT_FALSE(reader.get_by_count(k, &payload));
+  }
+
+  // Remaining states are available with the diagonal covariance
+  for (int k = num_states - num_slots + 1; k <= num_states; k++)
+  {
+    ASSERT_TRUE(reader.get_by_count(k, &payload));
+    EXPECT_DOUBLE_EQ(payload.timestamp, k);
+    EXPECT_DOUBLE_EQ(payload.core_state[0], k);
+    EXPECT_EQ(Eigen::Map<const mars::CoreStateVector>(payload.core_cov), mars::CoreStateVector::Ones() * k);
+  }
+
+  // States that were not published yet
+  ASSERT_FALSE(reader.get_by_count(num_states + 1, &payload));
+}
+
+TEST_F(mars_shm_state_publisher_test, SENSOR_BLOCKS)
+{
+  const std::string name = segment_name("sensor_blocks");
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+  std::shared_ptr<mars::ImuSensorClass> other_sensor_sptr = std::make_shared<mars::ImuSensorClass>("Other");
+
+  mars::ShmStatePublisher publisher(name);
+  ASSERT_TRUE(publisher.Open());
+
+  const int sensor_id =
+      publisher.RegisterSensor(other_sensor_sptr, [](const std::shared_ptr<void>& sensor_state, double* state,
+                                                     double* cov_diag, int /*max_size*/) {
+        const double value = *static_cast<const double*>(sensor_state.get());
+        state[0] = value;
+        state[1] = 2 * value;
+        cov_diag[0] = 0.1;
+        cov_diag[1] = 0.2;
+        return 2;
+      });
+  ASSERT_EQ(sensor_id, 0);
+
+  mars::BufferEntryType entry = core_entry(2, 1, other_sensor_sptr);
+  entry.data_.set_sensor_state(std::make_shared<double>(4.0));
+  ASSERT_TRUE(publisher.Publish(entry));
+
+  // The latest sensor state is kept for states of other sensors
+  ASSERT_TRUE(publisher.Publish(core_entry(3, 1, imu_sensor_sptr)));
+
+  mars::ShmStateReader reader(name);
+  ASSERT_TRUE(reader.Open());
+
+  mars::shm::ShmStatePayload payload;
+  ASSERT_TRUE(reader.get_latest(&payload));
+  ASSERT_EQ(payload.num_sensors, 1);
+  EXPECT_EQ(payload.source_sensor_id, -1);
+  EXPECT_STREQ(payload.sensors[0].name, "Other");
+  EXPECT_EQ(payload.sensors[0].size, 2);
+  EXPECT_DOUBLE_EQ(payload.sensors[0].timestamp, 2);
+  EXPECT_DOUBLE_EQ(payload.sensors[0].state[0], 4);
+  EXPECT_DOUBLE_EQ(payload.sensors[0].state[1], 8);
+  EXPECT_DOUBLE_EQ(payload.sensors[0].cov_diag[1], 0.2);
+}
+
+TEST_F(mars_shm_state_publisher_test, CORE_LOGIC_PUBLISH)
+{
+  const std::string name = segment_name("core_logic");
+
+  std::shared_ptr<mars::CoreState> core_states_sptr = std::make_shared<mars::CoreState>();
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+  core_states_sptr->set_propagation_sensor(imu_sensor_sptr);
+  core_states_sptr->set_initial_covariance(Eigen::Vector3d::Ones(), Eigen::Vector3d::Ones(), Eigen::Vector3d::Ones(),
+                                           Eigen::Vector3d::Ones(), Eigen::Vector3d::Ones());
+
+  mars::CoreLogic core_logic(core_states_sptr);
+  core_logic.state_publisher_ = std::make_shared<mars::ShmStatePublisher>(name, 8);
+  core_logic.state_publisher_->propagation_sensor_ = imu_sensor_sptr;
+  ASSERT_TRUE(core_logic.state_publisher_->Open());
+
+  mars::ShmStateReader reader(name);
+  ASSERT_TRUE(reader.Open());
+
+  const int num_meas = 20;
+  for (int k = 0; k < num_meas; k++)
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0, 0, 9.81), Eigen::Vector3d(0, 0, 0.1));
+    core_logic.ProcessMeasurement(imu_sensor_sptr, 0.01 * k,
+                                  mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas)));
+
+    if (!core_logic.core_is_initialized_)
+    {
+      ASSERT_TRUE(core_logic.Initialize(Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity()));
+    }
+  }
+
+  // Initialization plus one state per propagation
+  ASSERT_EQ(reader.get_write_count(), num_meas);
+
+  mars::BufferEntryType latest_entry;
+  ASSERT_TRUE(core_logic.buffer_.get_latest_state(&latest_entry));
+  const mars::CoreType* latest_core = static_cast<const mars::CoreType*>(latest_entry.data_.core_state_.get());
+
+  mars::shm::ShmStatePayload payload;
+  ASSERT_TRUE(reader.get_latest(&payload));
+  EXPECT_DOUBLE_EQ(payload.timestamp, latest_entry.timestamp_.get_seconds());
+  EXPECT_EQ(Eigen::Map<const Eigen::Vector3d>(payload.core_state + 3), latest_core->state_.v_wi_);
+}
+
+TEST_F(mars_shm_state_publisher_test, LATENCY)
+{
+  const std::string name = segment_name("latency");
+  const int num_states = 2000;
+  std::shared_ptr<mars::ImuSensorClass> imu_sensor_sptr = std::make_shared<mars::ImuSensorClass>("IMU");
+
+  mars::ShmStatePublisher publisher(name, 16);
+  ASSERT_TRUE(publisher.Open());
+
+  mars::ShmStateReader reader(name);
+  ASSERT_TRUE(reader.Open());
+
+  using Clock = std::chrono::steady_clock;
+  std::vector<Clock::time_point> publish_time(num_states + 1);
+  std::vector<Clock::time_point> read_time(num_states + 1);
+  std::atomic<bool> reader_ready{ false };
+  std::atomic<uint64_t> last_read_count{ 0 };
+  int num_inconsistent = 0;
+
+  // The reader spins on the write count and records the time at which each state was copied
+  std::thread reader_thread([&]() {
+    mars::shm::ShmStatePayload payload;
+    uint64_t last_count = 0;
+    reader_ready = true;
+
+    while (last_count < static_cast<uint64_t>(num_states))
+    {
+      uint64_t count = 0;
+      if (!reader.get_latest(&payload, &count) || count == last_count)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+
+      read_time[count] = Clock::now();
+      if (payload.core_state[0] != static_cast<double>(count))
+      {
+        num_inconsistent++;
+      }
+      last_count = count;
+      last_read_count = count;
+    }
+  });
+
+  while (!reader_ready)
+  {
+  }
+
+  for (int k = 1; k <= num_states; k++)
+  {
+    const mars::BufferEntryType entry = core_entry(k, k, imu_sensor_sptr);
+    publish_time[k] = Clock::now();
+    publisher.Publish(entry);
+
+    // Give the reader the chance to pick up each state
+    const Clock::time_point wait_start = Clock::now();
+    while (last_read_count < static_cast<uint64_t>(k) && Clock::now() - wait_start < std::chrono::milliseconds(1))
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  reader_thread.join();
+
+  ASSERT_EQ(num_inconsistent, 0);
+
+  std::vector<double> latency_us;
+  for (int k = 1; k <= num_states; k++)
+  {
+    if (read_time[k] != Clock::time_point())
+    {
+      latency_us.push_back(std::chrono::duration<double, std::micro>(read_time[k] - publish_time[k]).count());
+    }
+  }
+
+  ASSERT_FALSE(latency_us.empty());
+  std::sort(latency_us.begin(), latency_us.end());
+
+  std::cout << "Shm state latency [us]: received=" << latency_us.size() << "/" << num_states
+            << " median=" << latency_us[latency_us.size() / 2]
+            << " p99=" << latency_us[static_cast<size_t>(0.99 * (latency_us.size() - 1))] << std::endl;
+}
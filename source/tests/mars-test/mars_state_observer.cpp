@@ -0,0 +1,186 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/state_observer.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_state_observer_test : public testing::Test
+{
+public:
+  static mars_test::ScenarioFilter make_filter()
+  {
+    mars_test::ScenarioFilter setup(mars_test::ImuPoseTestConfig());
+    setup.AddPoseSensor("Pose");
+    setup.core_logic_->buffer_.set_max_buffer_size(2000);
+    setup.StartAtOrigin(imu_data());
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data()
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0, 0, 9.81), Eigen::Vector3d::Zero());
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  static mars::BufferDataType pose_data(const double& t)
+  {
+    const mars::PoseMeasurementType pose_meas(Eigen::Vector3d(0.1 * std::sin(t), 0.05 * std::cos(t), 0.02 * t),
+                                              Eigen::Quaterniond::Identity());
+    return mars::BufferDataType(std::make_shared<mars::PoseMeasurementType>(pose_meas));
+  }
+
+};
+
+TEST_F(mars_state_observer_test, IN_ORDER_STATES)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+
+  int num_states = 0;
+  int num_corrections = 0;
+  int num_pose_states = 0;
+  const int id = setup.core_logic_->AddStateObserver(
+      [&](const mars::BufferEntryType& state_entry, const bool& is_correction) {
+        EXPECT_TRUE(state_entry.HasStates());
+        num_states++;
+        num_corrections += is_correction;
+        num_pose_states += (state_entry.sensor_handle_ == setup.pose_sensors_[0]);
+      });
+
+  setup.core_logic_->state_queue_ = std::make_shared<mars::StateEventQueue>(512);
+
+  for (int k = 1; k <= 200; k++)
+  {
+    setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 0.01 * k, imu_data());
+    if (k % 10 == 0)
+    {
+      setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 0.01 * k, pose_data(0.01 * k));
+    }
+  }
+
+  EXPECT_EQ(num_states, 220);
+  EXPECT_EQ(num_pose_states, 20);
+  EXPECT_EQ(num_corrections, 0);
+  EXPECT_EQ(setup.core_logic_->state_queue_->get_size(), 220);
+
+  // The queue delivers the same states in the same order
+  mars::BufferEntryType latest_state;
+  setup.core_logic_->buffer_.get_latest_state(&latest_state);
+  mars::StateEvent event;
+  mars::StateEvent last_event;
+  while (setup.core_logic_->state_queue_->Pop(&event))
+  {
+    EXPECT_FALSE(event.is_correction_);
+    last_event = event;
+  }
+  EXPECT_EQ(last_event.entry_.timestamp_, latest_state.timestamp_);
+  EXPECT_EQ(last_event.entry_.data_.core_state_, latest_state.data_.core_state_);
+
+  // Removed observers are not called anymore
+  EXPECT_TRUE(setup.core_logic_->RemoveStateObserver(id));
+  EXPECT_FALSE(setup.core_logic_->RemoveStateObserver(id));
+  setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 2.01, imu_data());
+  EXPECT_EQ(num_states, 220);
+}
+
+TEST_F(mars_state_observer_test, REWORK_CORRECTIONS)
+{
+  mars_test::ScenarioFilter setup = make_filter();
+  setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 0, pose_data(0));
+
+  // Latest delivered state of each buffer entry, keyed by timestamp and sensor
+  std::map<std::pair<double, const mars::SensorAbsClass*>, std::shared_ptr<void>> delivered;
+  int num_corrections = 0;
+  setup.core_logic_->AddStateObserver([&](const mars::BufferEntryType& state_entry, const bool& is_correction) {
+    delivered[{ state_entry.timestamp_.get_seconds(), state_entry.sensor_handle_.get() }] =
+        state_entry.data_.core_state_;
+    num_corrections += is_correction;
+  });
+
+  for (int k = 1; k <= 100; k++)
+  {
+    setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, 0.01 * k, imu_data());
+  }
+
+  // Out of order pose measurement, the 50 following IMU states and the pose state are corrections
+  setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[0], 0.505, pose_data(0.505));
+  EXPECT_EQ(num_corrections, 51);
+
+  // The consumer holds the same states as the buffer without scanning it
+  for (int k = 0; k < setup.core_logic_->buffer_.get_length(); k++)
+  {
+    mars::BufferEntryType entry;
+    setup.core_logic_->buffer_.get_entry_at_idx(k, &entry);
+    if (!entry.HasStates() || entry.timestamp_ == 0)
+    {
+      continue;
+    }
+
+    const auto it = delivered.find({ entry.timestamp_.get_seconds(), entry.sensor_handle_.get() });
+    ASSERT_NE(it, delivered.end());
+    EXPECT_EQ(it->second, entry.data_.core_state_);
+  }
+}
+
+TEST_F(mars_state_observer_test, QUEUE_SPSC)
+{
+  const int num_events = 20000;
+  mars::StateEventQueue queue(64);
+
+  std::vector<double> received;
+  std::thread consumer([&queue, &received]() {
+    mars::StateEvent event;
+    while (static_cast<int>(received.size()) < num_events)
+    {
+      if (queue.Pop(&event))
+      {
+        received.push_back(event.entry_.timestamp_.get_seconds());
+      }
+    }
+  });
+
+  for (int k = 0; k < num_events; k++)
+  {
+    const mars::BufferEntryType entry(k, mars::BufferDataType(), nullptr);
+    while (!queue.Push(entry, false))
+    {
+      std::this_thread::yield();
+    }
+  }
+  consumer.join();
+
+  ASSERT_EQ(static_cast<int>(received.size()), num_events);
+  for (int k = 0; k < num_events; k++)
+  {
+    EXPECT_EQ(received[k], k);
+  }
+
+  // Events are dropped if the queue is full
+  const uint64_t num_dropped = queue.get_num_dropped();
+  for (int k = 0; k < 70; k++)
+  {
+    queue.Push(mars::BufferEntryType(k, mars::BufferDataType(), nullptr), false);
+  }
+  EXPECT_EQ(queue.get_size(), 64);
+  EXPECT_EQ(queue.get_num_dropped() - num_dropped, 6);
+}
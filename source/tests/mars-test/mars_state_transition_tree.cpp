@@ -0,0 +1,257 @@
+// Copyright (C) 2024 Christian Brommer, Control of Networked Systems, University of Klagenfurt, Austria.
+//
+// All rights reserved.
+//
+// This software is licensed under the terms of the BSD-2-Clause-License with
+// no commercial use allowed, the full terms of which are made available
+// in the LICENSE file. No license in patents is granted.
+//
+// You can contact the author at <christian.brommer@ieee.org>
+
+#include <gmock/gmock.h>
+#include <mars/core_logic.h>
+#include <mars/core_state.h>
+#include <mars/sensors/imu/imu_measurement_type.h>
+#include <mars/sensors/imu/imu_sensor_class.h>
+#include <mars/sensors/pose/pose_measurement_type.h>
+#include <mars/sensors/pose/pose_sensor_class.h>
+#include <mars/state_transition_tree.h>
+#include <mars/time.h>
+#include <mars/type_definitions/core_type.h>
+#include <Eigen/Dense>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../common/scenario_filter_fixture.h"
+
+class mars_state_transition_tree_test : public testing::Test
+{
+public:
+  using TransitionVector = std::vector<mars::CoreStateMatrix, Eigen::aligned_allocator<mars::CoreStateMatrix>>;
+
+  static TransitionVector random_transitions(const int& size)
+  {
+    std::srand(42);
+    TransitionVector transitions;
+    for (int k = 0; k < size; k++)
+    {
+      transitions.push_back(mars::CoreStateMatrix::Identity() + 0.05 * mars::CoreStateMatrix::Random());
+    }
+    return transitions;
+  }
+
+  static mars::CoreStateMatrix sequential_product(const TransitionVector& transitions, const int& first,
+                                                  const int& last)
+  {
+    mars::CoreStateMatrix result(mars::CoreStateMatrix::Identity());
+    for (int k = first; k <= last; k++)
+    {
+      result = transitions[k] * result;
+    }
+    return result;
+  }
+
+  static mars_test::ScenarioFilter make_filter(const int& num_pose_sensors)
+  {
+    mars_test::ScenarioFilter setup(mars_test::ImuPoseTestConfig());
+    for (int k = 0; k < num_pose_sensors; k++)
+    {
+      setup.AddPoseSensor("Pose_" + std::to_string(k));
+    }
+    setup.core_logic_->buffer_.set_max_buffer_size(2000);
+    setup.StartAtOrigin(imu_data());
+    return setup;
+  }
+
+  static mars::BufferDataType imu_data()
+  {
+    const mars::IMUMeasurementType imu_meas(Eigen::Vector3d(0, 0, 9.81), Eigen::Vector3d(0.01, 0, 0));
+    return mars::BufferDataType(std::make_shared<mars::IMUMeasurementType>(imu_meas));
+  }
+
+  static mars::BufferDataType pose_data(const double& t)
+  {
+    const mars::PoseMeasurementType pose_meas(Eigen::Vector3d(0.1 * std::sin(t), 0.05 * std::cos(t), 0.02 * t),
+                                              Eigen::Quaterniond::Identity());
+    return mars::BufferDataType(std::make_shared<mars::PoseMeasurementType>(pose_meas));
+  }
+
+  ///
+  /// \brief run_slow_delayed Runs 200Hz IMU measurements and 1Hz pose measurements of each pose sensor, which arrive
+  /// with a delay of 'delay' seconds, returns the processing time [s]
+  ///
+  static double run_slow_delayed(const mars_test::ScenarioFilter& setup, const double& duration, const double& delay)
+  {
+    // Initialize the pose sensors in order
+    for (const auto& pose_sensor : setup.pose_sensors_)
+    {
+      setup.core_logic_->ProcessMeasurement(pose_sensor, 0, pose_data(0));
+    }
+
+    const int num_pose_sensors = static_cast<int>(setup.pose_sensors_.size());
+    const int num_steps = static_cast<int>(duration * 200);
+    const int delay_steps = static_cast<int>(delay * 200);
+
+    const double t_start = mars::Time::get_time_now().get_seconds();
+    for (int k = 1; k <= num_steps; k++)
+    {
+      const double t = 0.005 * k;
+      setup.core_logic_->ProcessMeasurement(setup.imu_sensor_sptr_, t, imu_data());
+
+      // Pose sensor 'j' measures every 200 steps with an offset of 200 / num_pose_sensors * j steps
+      for (int j = 0; j < num_pose_sensors; j++)
+      {
+        const int meas_step = k - delay_steps;
+        if (meas_step > 0 && (meas_step - 200 / num_pose_sensors * j) % 200 == 0)
+        {
+          const double t_meas = 0.005 * meas_step;
+          setup.core_logic_->ProcessMeasurement(setup.pose_sensors_[j], t_meas, pose_data(t_meas));
+        }
+      }
+    }
+    return mars::Time::get_time_now().get_seconds() - t_start;
+  }
+
+  static mars::CoreType latest_core_state(const mars_test::ScenarioFilter& setup)
+  {
+    mars::BufferEntryType latest_entry;
+    setup.core_logic_->buffer_.get_latest_state(&latest_entry);
+    return *static_cast<mars::CoreType*>(latest_entry.data_.core_state_.get());
+  }
+};
+
+TEST_F(mars_state_transition_tree_test, QUERY_MATCHES_SEQUENTIAL_PRODUCT)
+{
+  // Non power of two size
+  const int size = 37;
+  const TransitionVector transitions = random_transitions(size);
+
+  mars::StateTransitionTree tree;
+  tree.Resize(size);
+  EXPECT_EQ(tree.size(), size);
+  EXPECT_TRUE(tree.Query(0, size - 1).isIdentity());
+
+  for (int k = 0; k < size; k++)
+  {
+    tree.SetLeaf(k, transitions[k]);
+  }
+
+  for (int first = 0; first < size; first++)
+  {
+    for (int last = first; last < size; last++)
+    {
+      ASSERT_TRUE(tree.Query(first, last).isApprox(sequential_product(transitions, first, last), 1e-12))
+          << "Range [" << first << ", " << last << "]";
+    }
+  }
+
+  EXPECT_TRUE(tree.Query(5, 4).isIdentity());
+}
+
+TEST_F(mars_state_transition_tree_test, LAZY_LEAF_UPDATES)
+{
+  const int size = 100;
+  TransitionVector transitions = random_transitions(size);
+
+  mars::StateTransitionTree tree;
+  tree.Resize(size);
+  for (int k = 0; k < size; k++)
+  {
+    tree.SetLeaf(k, transitions[k]);
+  }
+  EXPECT_TRUE(tree.Query(3, 97).isApprox(sequential_product(transitions, 3, 97), 1e-12));
+
+  // Overwrite a few leaves, the inner nodes are updated by the next query
+  for (const int k : { 10, 11, 50, 98 })
+  {
+    transitions[k] = mars::CoreStateMatrix::Identity() - 0.02 * transitions[k];
+    tree.SetLeaf(k, transitions[k]);
+  }
+  EXPECT_TRUE(tree.Query(0, size - 1).isApprox(sequential_product(transitions, 0, size - 1), 1e-12));
+  EXPECT_TRUE(tree.Query(11, 50).isApprox(sequential_product(transitions, 11, 50), 1e-12));
+
+  // Resize resets all leaves
+  tree.Resize(10);
+  EXPECT_TRUE(tree.Query(0, 9).isIdentity());
+}
+
+TEST_F(mars_state_transition_tree_test, QUERY_PERFORMANCE)
+{
+  // Blocks of up to 2000 transitions, e.g. 10s of 200Hz IMU measurements for a slow or strongly delayed sensor
+  const int size = 2000;
+  const int num_queries = 200;
+  const TransitionVector transitions = random_transitions(size);
+
+  std::vector<std::pair<int, int>> ranges;
+  for (int k = 0; k < num_queries; k++)
+  {
+    const int first = std::rand() % size;
+    ranges.emplace_back(first, first + std::rand() % (size - first));
+  }
+
+  mars::StateTransitionTree tree;
+  double t_start = mars::Time::get_time_now().get_seconds();
+  tree.Resize(size);
+  for (int k = 0; k < size; k++)
+  {
+    tree.SetLeaf(k, transitions[k]);
+  }
+  mars::CoreStateMatrix tree_sum(mars::CoreStateMatrix::Zero());
+  for (const auto& range : ranges)
+  {
+    tree_sum += tree.Query(range.first, range.second);
+  }
+  const double time_tree = mars::Time::get_time_now().get_seconds() - t_start;
+
+  t_start = mars::Time::get_time_now().get_seconds();
+  mars::CoreStateMatrix sequential_sum(mars::CoreStateMatrix::Zero());
+  for (const auto& range : ranges)
+  {
+    sequential_sum += sequential_product(transitions, range.first, range.second);
+  }
+  const double time_sequential = mars::Time::get_time_now().get_seconds() - t_start;
+
+  std::cout << num_queries << " blocks of " << size << " transitions, sequential [s]: " << time_sequential
+            << " tree incl. build [s]: " << time_tree << std::endl;
+
+  EXPECT_TRUE(tree_sum.isApprox(sequential_sum, 1e-9));
+  EXPECT_LT(time_tree, time_sequential);
+}
+
+TEST_F(mars_state_transition_tree_test, CORE_LOGIC_REWORK_SLOW_DELAYED_SENSORS)
+{
+  // Three 1Hz pose sensors, delayed by 2s, each measurement triggers a rework over 400 IMU entries and the
+  // state transition block of each update spans 200 entries
+  const int num_pose_sensors = 3;
+  const double duration = 10;
+  const double delay = 2;
+
+  mars_test::ScenarioFilter sequential = make_filter(num_pose_sensors);
+  mars_test::ScenarioFilter tree = make_filter(num_pose_sensors);
+  tree.core_logic_->use_transition_tree_ = true;
+
+  const double time_sequential = run_slow_delayed(sequential, duration, delay);
+  const double time_tree = run_slow_delayed(tree, duration, delay);
+
+  const mars::ReworkStats& stats_sequential = sequential.core_logic_->get_rework_stats();
+  const mars::ReworkStats& stats_tree = tree.core_logic_->get_rework_stats();
+
+  std::cout << "Sequential transition blocks: reworks: " << stats_sequential.num_reworks_
+            << " rework time [s]: " << stats_sequential.rework_time_ << " total time [s]: " << time_sequential
+            << std::endl;
+  std::cout << "Transition tree: reworks: " << stats_tree.num_reworks_
+            << " rework time [s]: " << stats_tree.rework_time_ << " total time [s]: " << time_tree << std::endl;
+
+  EXPECT_EQ(stats_sequential.num_reworks_, stats_tree.num_reworks_);
+  EXPECT_GT(stats_tree.num_reworks_, 0);
+
+  const mars::CoreType state_sequential = latest_core_state(sequential);
+  const mars::CoreType state_tree = latest_core_state(tree);
+
+  EXPECT_TRUE(state_sequential.state_.p_wi_.isApprox(state_tree.state_.p_wi_, 1e-9));
+  EXPECT_TRUE(state_sequential.state_.v_wi_.isApprox(state_tree.state_.v_wi_, 1e-9));
+  EXPECT_TRUE(state_sequential.state_.q_wi_.coeffs().isApprox(state_tree.state_.q_wi_.coeffs(), 1e-9));
+  EXPECT_TRUE(state_sequential.cov_.isApprox(state_tree.cov_, 1e-9));
+}